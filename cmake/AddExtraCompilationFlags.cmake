@@ -127,6 +127,10 @@ if(CMAKE_COMPILER_IS_GNUCXX)
   elseif(X86 OR X86_64)
     add_extra_compiler_option(-mno-ssse3)
   endif()
+
+  if(ENABLE_AVX)
+    add_extra_compiler_option(-mavx)
+  endif()
 endif()
 
 if(UNIX)
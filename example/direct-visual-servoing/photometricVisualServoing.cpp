@@ -361,7 +361,7 @@ main(int argc, const char ** argv)
     sId.buildFrom(Id) ;
 
     // Matrice d'interaction, Hessien, erreur,...
-    vpMatrix Lsd;   // matrice d'interaction a la position desiree
+    vpColVector LsdtError; // produit de la transposee de la matrice d'interaction a la position desiree et de l'erreur
     vpMatrix Hsd;  // hessien a la position desiree
     vpMatrix H ; // Hessien utilise pour le levenberg-Marquartd
     vpColVector error ; // Erreur I-I*
@@ -369,11 +369,10 @@ main(int argc, const char ** argv)
     // Compute the interaction matrix
     // link the variation of image intensity to camera motion
 
-    // here it is computed at the desired position
-    sId.interaction(Lsd) ;
-
-    // Compute the Hessian H = L^TL
-    Hsd = Lsd.AtA() ;
+    // here it is computed at the desired position, once for all the iterations
+    // Compute the Hessian H = L^TL without building the interaction matrix
+    sI.error(sId, error) ;
+    sId.normalEquations(error, Hsd, LsdtError) ;
 
     // Compute the Hessian diagonal for the Levenberg-Marquartd
     // optimization process
@@ -448,8 +447,9 @@ main(int argc, const char ** argv)
         {
           H = ((mu * diagHsd) + Hsd).inverseByLU();
         }
-        //	compute the control law
-        e = H * Lsd.t() *error ;
+        //	compute the control law, Hsd being computed once at the desired position
+        sId.normalEquations(error, LsdtError) ;
+        e = H * LsdtError ;
 
         v = - lambda*e;
       }
@@ -62,7 +62,7 @@
 #include <visp3/io/vpParseArgv.h>
 #include <visp3/mbt/vpMbEdgeTracker.h>
 
-#define GETOPTARGS  "x:m:i:n:de:chtfColwvp"
+#define GETOPTARGS  "x:m:i:n:de:chtfColwvpT:"
 
 void usage(const char *name, const char *badparam)
 {
@@ -72,7 +72,8 @@ Example of tracking based on the 3D model.\n\
 SYNOPSIS\n\
   %s [-i <test image path>] [-x <config file>]\n\
   [-m <model name>] [-n <initialisation file base name>] [-e <last frame index>]\n\
-  [-t] [-c] [-d] [-h] [-f] [-C] [-o] [-w] [-l] [-v] [-p]\n",
+  [-t] [-c] [-d] [-h] [-f] [-C] [-o] [-w] [-l] [-v] [-p]\n\
+  [-T <number of threads>]\n",
   name );
 
   fprintf(stdout, "\n\
@@ -138,6 +139,11 @@ OPTIONS:                                               \n\
 \n\
   -p\n\
      Compute gradient projection error.\n\
+\n\
+  -T <number of threads>\n\
+     Number of threads used to track the moving edges of the\n\
+     model primitives. The mean time spent in the main steps\n\
+     of the tracking is printed at the end.\n\
 \n\
   -h \n\
      Print the help.\n\n");
@@ -150,7 +156,7 @@ OPTIONS:                                               \n\
 bool getOptions(int argc, const char **argv, std::string &ipath, std::string &configFile, std::string &modelFile,
                 std::string &initFile, long &lastFrame, bool &displayFeatures, bool &click_allowed, bool &display,
                 bool& cao3DModel, bool& trackCylinder, bool &useOgre, bool &showOgreConfigDialog,
-                bool &useScanline, bool &computeCovariance, bool &projectionError)
+                bool &useScanline, bool &computeCovariance, bool &projectionError, unsigned int &nbThreads)
 {
   const char *optarg_;
   int   c;
@@ -172,6 +178,7 @@ bool getOptions(int argc, const char **argv, std::string &ipath, std::string &co
     case 'w': showOgreConfigDialog  = true; break;
     case 'v': computeCovariance  = true; break;
     case 'p': projectionError  = true; break;
+    case 'T': nbThreads = (unsigned int)atoi(optarg_); break;
     case 'h': usage(argv[0], NULL); return false; break;
 
     default:
@@ -215,6 +222,7 @@ main(int argc, const char ** argv)
     bool useScanline = false;
     bool computeCovariance = false;
     bool projectionError = false;
+    unsigned int nbThreads = 1;
     bool quit = false;
 
     // Get the visp-images-data package path or VISP_INPUT_IMAGE_PATH environment variable value
@@ -228,7 +236,7 @@ main(int argc, const char ** argv)
     // Read the command line options
     if (!getOptions(argc, argv, opt_ipath, opt_configFile, opt_modelFile, opt_initFile, opt_lastFrame, displayFeatures,
                     opt_click_allowed, opt_display, cao3DModel, trackCylinder, useOgre, showOgreConfigDialog,
-                    useScanline, computeCovariance, projectionError)) {
+                    useScanline, computeCovariance, projectionError, nbThreads)) {
       return (-1);
     }
 
@@ -393,6 +401,7 @@ main(int argc, const char ** argv)
 
     // Tells if the tracker has to compute the projection error
     tracker.setProjectionErrorComputation(projectionError);
+    tracker.setNbMovingEdgeThreads(nbThreads);
 
     // Retrieve the camera parameters from the tracker
     tracker.getCameraParameters(cam);
@@ -434,6 +443,8 @@ main(int argc, const char ** argv)
     if (opt_display)
       vpDisplay::flush(I);
 
+    double meanTrackMovingEdgeTime = 0, meanComputeVVSTime = 0, meanUpdateMovingEdgeTime = 0;
+    unsigned int nbTrackedFrames = 0;
     while (!reader.end())
     {
       // acquire a new image
@@ -478,6 +489,7 @@ main(int argc, const char ** argv)
         tracker.setScanLineVisibilityTest(useScanline);
         tracker.setCovarianceComputation(computeCovariance);
         tracker.setProjectionErrorComputation(projectionError);
+        tracker.setNbMovingEdgeThreads(nbThreads);
         tracker.initFromPose(I, cMo);
       }
 
@@ -502,6 +514,14 @@ main(int argc, const char ** argv)
       if (reader.getFrameIndex() - reader.getFirstFrameIndex() < 40 || reader.getFrameIndex() - reader.getFirstFrameIndex() >= 50) {
         tracker.track(I);
         tracker.getPose(cMo);
+
+        double trackMovingEdgeTime, computeVVSTime, updateMovingEdgeTime;
+        tracker.getTrackingTimes(trackMovingEdgeTime, computeVVSTime, updateMovingEdgeTime);
+        meanTrackMovingEdgeTime += trackMovingEdgeTime;
+        meanComputeVVSTime += computeVVSTime;
+        meanUpdateMovingEdgeTime += updateMovingEdgeTime;
+        nbTrackedFrames++;
+
         if (opt_display) {
           // display the 3D model
           tracker.display(I, cMo, cam, vpColor::darkRed);
@@ -531,6 +551,13 @@ main(int argc, const char ** argv)
 
     std::cout << "Reached last frame: " << reader.getFrameIndex() << std::endl;
 
+    if (nbTrackedFrames) {
+      std::cout << "Mean tracking times with " << tracker.getNbMovingEdgeThreads() << " thread(s): "
+                << "track moving edges " << meanTrackMovingEdgeTime / nbTrackedFrames << " ms, "
+                << "pose estimation " << meanComputeVVSTime / nbTrackedFrames << " ms, "
+                << "update moving edges " << meanUpdateMovingEdgeTime / nbTrackedFrames << " ms" << std::endl;
+    }
+
     if (opt_click_allowed && !quit) {
       vpDisplay::getClick(I);
     }
@@ -49,6 +49,41 @@
 #include <visp3/core/vpConfig.h>
 #include <visp3/core/vpException.h>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  In-object storage of a fixed-size R x C array, used by the containers
+  derived from vpArray2D that have a known size (vpHomogeneousMatrix,
+  vpRotationMatrix, vpTranslationVector...) to avoid heap allocations.
+*/
+template<class Type, unsigned int R, unsigned int C>
+struct vpArray2DStorage
+{
+  Type data[R*C];
+  Type *rowPtrs[R];
+};
+
+/*
+  Base class holding the storage of a fixed-size container. It has to be
+  listed before vpArray2D in the base classes of the container, so that the
+  storage exists when vpArray2D is built on top of it (base-from-member
+  idiom):
+
+  class vpTranslationVector : private vpArray2DStorageHolder<double, 3, 1>, public vpArray2D<double>
+
+  Since the row pointers are specific to each object, the container has to
+  define its copy constructor and copy operator so that the storage is never
+  copied member-wise.
+*/
+template<class Type, unsigned int R, unsigned int C>
+class vpArray2DStorageHolder
+{
+protected:
+  vpArray2DStorageHolder() {}
+
+  vpArray2DStorage<Type, R, C> m_storage;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   \class vpArray2D
   \ingroup group_core_matrices
@@ -78,6 +113,8 @@ protected:
   Type **rowPtrs;
   //! Current array size (rowNum * colNum)
   unsigned int dsize;
+  //! False when data and rowPtrs point to the in-object storage of a fixed-size container
+  bool isDataOwner;
 
 public:
   //! Address of the first element of the data array
@@ -89,13 +126,13 @@ public:
   Number of columns and rows are set to zero.
   */
   vpArray2D<Type>()
-    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), isDataOwner(true), data(NULL)
   {}
   /*!
   Copy constructor of a 2D array.
   */
   vpArray2D<Type>(const vpArray2D<Type> & A)
-    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), isDataOwner(true), data(NULL)
   {
     resize(A.rowNum, A.colNum);
     memcpy(data, A.data, rowNum*colNum*sizeof(Type));
@@ -107,7 +144,7 @@ public:
   \param c : Array number of columns.
   */
   vpArray2D<Type>(unsigned int r, unsigned int c)
-    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), isDataOwner(true), data(NULL)
   {
     resize(r, c);
   }
@@ -119,7 +156,7 @@ public:
   \param val : Each element of the array is set to \e val.
   */
   vpArray2D<Type>(unsigned int r, unsigned int c, Type val)
-    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), isDataOwner(true), data(NULL)
   {
     resize(r, c);
     *this = val;
@@ -130,12 +167,14 @@ public:
   virtual ~vpArray2D<Type>()
   {
     if (data != NULL ) {
-      free(data);
+      if (isDataOwner)
+        free(data);
       data=NULL;
     }
 
     if (rowPtrs!=NULL) {
-      free(rowPtrs);
+      if (isDataOwner)
+        free(rowPtrs);
       rowPtrs=NULL ;
     }
     rowNum = colNum = dsize = 0;
@@ -180,6 +219,22 @@ public:
       }
     }
     else {
+      if (! isDataOwner) {
+        // Leave the in-object storage of a fixed-size container for the heap
+        Type *heapData = NULL;
+        if (0 != this->dsize) {
+          heapData = (Type*)malloc(this->dsize*sizeof(Type));
+          if (NULL == heapData) {
+            throw(vpException(vpException::memoryAllocationError,
+              "Memory allocation error when allocating 2D array data")) ;
+          }
+          memcpy(heapData, this->data, this->dsize*sizeof(Type));
+        }
+        this->data = heapData;
+        this->rowPtrs = NULL;
+        isDataOwner = true;
+      }
+
       const bool recopyNeeded = (ncols != this ->colNum);
       Type * copyTmp = NULL;
       unsigned int rowTmp = 0, colTmp=0;
@@ -295,6 +350,39 @@ public:
   }
   //@}
 
+protected:
+  /*!
+  Constructor used by the fixed-size containers to build a 2D array initialized
+  with 0 on top of their in-object \e storage, without any heap allocation.
+  If the array is later resized, its content moves to the heap.
+
+  \param r : Array number of rows.
+  \param c : Array number of columns. If \e r is greater than \e R or r*c
+  greater than R*C, the array is directly allocated on the heap.
+  \param storage : Storage that has to live as long as the array, held by a
+  vpArray2DStorageHolder base class of the container.
+  */
+  template<unsigned int R, unsigned int C>
+  vpArray2D<Type>(unsigned int r, unsigned int c, vpArray2DStorage<Type, R, C> &storage)
+    : rowNum(r), colNum(c), rowPtrs(storage.rowPtrs), dsize(r*c), isDataOwner(false), data(storage.data)
+  {
+    if (r > R || dsize > R*C) {
+      data = (Type*)malloc(dsize*sizeof(Type));
+      rowPtrs = (Type**)malloc(r*sizeof(Type*));
+      isDataOwner = true;
+      if (NULL == data || NULL == rowPtrs) {
+        free(data);
+        free(rowPtrs);
+        throw(vpException(vpException::memoryAllocationError,
+          "Memory allocation error when allocating 2D array data")) ;
+      }
+    }
+    for (unsigned int i=0; i<rowNum; i++)
+      rowPtrs[i] = data + i*colNum;
+    memset(data, 0, dsize*sizeof(Type));
+  }
+
+public:
   //---------------------------------
   // Inherited array I/O  Static Public Member Functions
   //---------------------------------
@@ -0,0 +1,171 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Background acquisition of the images of a frame grabber.
+ *
+ *****************************************************************************/
+
+#ifndef vpAsyncFrameGrabber_h
+#define vpAsyncFrameGrabber_h
+
+/*!
+  \file vpAsyncFrameGrabber.h
+  \brief Background acquisition of the images of a frame grabber.
+*/
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpFrameGrabber.h>
+
+/*!
+  \class vpAsyncFrameGrabber
+
+  \ingroup group_core_threading
+
+  \brief Acquire the images of a frame grabber in a background thread.
+
+  The frame grabber given to the constructor (vpV4l2Grabber,
+  vp1394TwoGrabber, vpVideoReader, ...) is opened by open(). A capture
+  thread then calls its acquire() method in a loop and stores the images in
+  a ring of slots, with their capture time and index. acquire() only copies
+  a ready image into the user image, so that the capture, the colour
+  conversion done by the grabber and the processing of the previous image
+  overlap.
+
+  The acquisition mode tells which image acquire() returns:
+  - vpAsyncFrameGrabber::LATEST_FRAME: the newest image. The images captured
+    since the previous call and not acquired are dropped. This is the mode
+    to use with a camera in a control loop.
+  - vpAsyncFrameGrabber::NEXT_FRAME: the oldest image not acquired yet. When
+    all the slots are full, the oldest image is dropped.
+  - vpAsyncFrameGrabber::EVERY_FRAME: the oldest image not acquired yet.
+    When all the slots are full, the capture waits, so that no image is
+    dropped. This is the mode to use with a video file or an image sequence.
+
+  acquire() only waits when no new image is ready. acquire(I, false) never
+  waits and returns false in that case. The capture stops when end() of the
+  grabber returns true or when its acquire() throws an exception; the
+  exception is thrown again by acquire() once the images already captured
+  are acquired.
+
+  The grabber must not be used directly between open() and close().
+
+  \code
+#include <visp3/core/vpAsyncFrameGrabber.h>
+#include <visp3/io/vpVideoReader.h>
+
+int main()
+{
+  vpImage<unsigned char> I;
+  vpVideoReader reader;
+  reader.setFileName("./image/image%04d.pgm");
+
+  vpAsyncFrameGrabber g(reader, 4, vpAsyncFrameGrabber::EVERY_FRAME);
+  g.open(I); // Open the reader and start the capture thread
+  while (! g.end()) {
+    g.acquire(I); // Copy the next image read in the background
+    // Process I while the next images are read
+  }
+  g.close();
+}
+  \endcode
+
+  \note Without thread support, the images are acquired by acquire() in the
+  calling thread.
+*/
+class VISP_EXPORT vpAsyncFrameGrabber : public vpFrameGrabber
+{
+public:
+  /*! Image returned by acquire(). */
+  typedef enum {
+    LATEST_FRAME, /*!< Newest image, the older ones are dropped. */
+    NEXT_FRAME,   /*!< Oldest image, the oldest is dropped when the slots are full. */
+    EVERY_FRAME   /*!< Oldest image, the capture waits when the slots are full. */
+  } vpAcquisitionMode;
+
+  explicit vpAsyncFrameGrabber(vpFrameGrabber &grabber, const unsigned int nbSlots=3,
+                               const vpAcquisitionMode mode=LATEST_FRAME);
+  virtual ~vpAsyncFrameGrabber();
+
+  void open(vpImage<unsigned char> &I);
+  void open(vpImage<vpRGBa> &I);
+
+  void acquire(vpImage<unsigned char> &I);
+  void acquire(vpImage<vpRGBa> &I);
+  bool acquire(vpImage<unsigned char> &I, const bool blocking);
+  bool acquire(vpImage<vpRGBa> &I, const bool blocking);
+
+  void close();
+  bool end();
+
+  /*!
+    Return the acquisition mode.
+    \sa setAcquisitionMode()
+  */
+  inline vpAcquisitionMode getAcquisitionMode() const { return m_mode; }
+  /*!
+    Return the index, in capture order starting from 0, of the last image
+    returned by acquire(). The difference between two consecutive indexes
+    minus one is the number of images dropped in between.
+  */
+  inline unsigned int getFrameIndex() const { return m_frameIndex; }
+  unsigned int getNbCapturedFrames();
+  unsigned int getNbDroppedFrames();
+  unsigned int getNbReadyFrames();
+  /*!
+    Return the number of slots of the ring of images.
+  */
+  inline unsigned int getNbSlots() const { return m_nbSlots; }
+  /*!
+    Return the time in ms, as given by vpTime::measureTimeMs(), at which
+    the last image returned by acquire() was captured.
+  */
+  inline double getTimestamp() const { return m_timestamp; }
+
+  void setAcquisitionMode(const vpAcquisitionMode mode);
+
+private:
+  vpAsyncFrameGrabber(const vpAsyncFrameGrabber &);
+  vpAsyncFrameGrabber &operator=(const vpAsyncFrameGrabber &);
+
+  template<class Type> void openImpl(vpImage<Type> &I, const bool rgba);
+  template<class Type> bool acquireImpl(vpImage<Type> &I, const bool blocking);
+
+  class vpCapture;
+
+  vpFrameGrabber &m_grabber;
+  unsigned int m_nbSlots;
+  vpAcquisitionMode m_mode;
+  //! Capture thread and ring of images, allocated by open()
+  vpCapture *m_capture;
+  unsigned int m_frameIndex;
+  double m_timestamp;
+};
+
+#endif
@@ -0,0 +1,200 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Condition variable.
+ *
+ *****************************************************************************/
+
+#ifndef vpCondition_h
+#define vpCondition_h
+
+/*!
+  \file vpCondition.h
+  \brief Condition variable and the mutex it waits on.
+*/
+
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+
+#if defined(VISP_HAVE_PTHREAD)
+#  include <pthread.h>
+#elif defined(_WIN32)
+// Include WinSock2.h before windows.h to ensure that winsock.h is not included by windows.h
+// since winsock.h and winsock2.h are incompatible
+#  include <WinSock2.h>
+#  include <windows.h>
+#endif
+
+/*!
+  \class vpConditionMutex
+  \ingroup group_core_threading
+
+  Mutex that a vpCondition can wait on. Unlike vpMutex, it is a critical
+  section under Windows, which is what condition variables need there.
+
+  \sa vpCondition
+*/
+class vpConditionMutex
+{
+public:
+  vpConditionMutex() {
+#if defined(VISP_HAVE_PTHREAD)
+    pthread_mutex_init(&m_mutex, NULL);
+#elif defined(WINRT_8_1)
+    InitializeCriticalSectionEx(&m_mutex, 0, 0);
+#else
+    InitializeCriticalSection(&m_mutex);
+#endif
+  }
+
+  ~vpConditionMutex() {
+#if defined(VISP_HAVE_PTHREAD)
+    pthread_mutex_destroy(&m_mutex);
+#else
+    DeleteCriticalSection(&m_mutex);
+#endif
+  }
+
+  //! Lock the mutex, waiting if another thread owns it.
+  void lock() {
+#if defined(VISP_HAVE_PTHREAD)
+    pthread_mutex_lock(&m_mutex);
+#else
+    EnterCriticalSection(&m_mutex);
+#endif
+  }
+
+  //! Unlock the mutex.
+  void unlock() {
+#if defined(VISP_HAVE_PTHREAD)
+    pthread_mutex_unlock(&m_mutex);
+#else
+    LeaveCriticalSection(&m_mutex);
+#endif
+  }
+
+private:
+  vpConditionMutex(const vpConditionMutex &);
+  vpConditionMutex &operator=(const vpConditionMutex &);
+
+  friend class vpCondition;
+
+#if defined(VISP_HAVE_PTHREAD)
+  pthread_mutex_t m_mutex;
+#else
+  CRITICAL_SECTION m_mutex;
+#endif
+};
+
+/*!
+  \class vpCondition
+  \ingroup group_core_threading
+
+  Condition variable, used to wait for a change of data protected by a
+  vpConditionMutex without polling. It implements native pthread
+  functionalities if available, or native Windows condition variables.
+
+  \code
+#include <visp3/core/vpCondition.h>
+
+vpConditionMutex mutex;
+vpCondition ready;
+bool isReady = false;
+
+void consumer()
+{
+  mutex.lock();
+  while (! isReady) // Always check the data again after wait()
+    ready.wait(mutex);
+  mutex.unlock();
+}
+
+void producer()
+{
+  mutex.lock();
+  isReady = true;
+  ready.notifyAll();
+  mutex.unlock();
+}
+  \endcode
+*/
+class vpCondition
+{
+public:
+  vpCondition() {
+#if defined(VISP_HAVE_PTHREAD)
+    pthread_cond_init(&m_cond, NULL);
+#else
+    InitializeConditionVariable(&m_cond);
+#endif
+  }
+
+  ~vpCondition() {
+#if defined(VISP_HAVE_PTHREAD)
+    pthread_cond_destroy(&m_cond);
+#endif
+  }
+
+  /*!
+    Release \e mutex, locked by the calling thread, wait until notifyAll()
+    is called by another thread, then lock \e mutex again. The wait may
+    also end spuriously.
+  */
+  void wait(vpConditionMutex &mutex) {
+#if defined(VISP_HAVE_PTHREAD)
+    pthread_cond_wait(&m_cond, &mutex.m_mutex);
+#else
+    SleepConditionVariableCS(&m_cond, &mutex.m_mutex, INFINITE);
+#endif
+  }
+
+  //! Wake up all the threads waiting on the condition.
+  void notifyAll() {
+#if defined(VISP_HAVE_PTHREAD)
+    pthread_cond_broadcast(&m_cond);
+#else
+    WakeAllConditionVariable(&m_cond);
+#endif
+  }
+
+private:
+  vpCondition(const vpCondition &);
+  vpCondition &operator=(const vpCondition &);
+
+#if defined(VISP_HAVE_PTHREAD)
+  pthread_cond_t m_cond;
+#else
+  CONDITION_VARIABLE m_cond;
+#endif
+};
+
+#endif
+#endif
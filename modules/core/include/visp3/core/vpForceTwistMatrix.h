@@ -99,7 +99,7 @@ int main()
 }
   \endcode
 */
-class VISP_EXPORT vpForceTwistMatrix : public vpArray2D<double>
+class VISP_EXPORT vpForceTwistMatrix : private vpArray2DStorageHolder<double, 6, 6>, public vpArray2D<double>
 {
  public:
   // basic constructor
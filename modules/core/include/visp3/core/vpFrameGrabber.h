@@ -133,6 +133,13 @@ public:
     the memory used by a specific frame grabber
   */
   virtual void close() =0 ;
+
+  /*!
+    Return true when there is no more image to acquire, for example at the
+    end of a video file. Live cameras always return false.
+    \sa vpAsyncFrameGrabber
+  */
+  virtual bool end() { return false; }
 } ;
 
 #endif
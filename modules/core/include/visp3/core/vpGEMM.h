@@ -134,157 +134,50 @@ inline void GEMMsize<7>(const vpArray2D<double> & A,const vpArray2D<double> & B,
   Bcols= B.getRows();
 }
 
-template<unsigned int>
-inline void GEMM1(const unsigned int &/*Arows*/,const unsigned int &/*Brows*/, const unsigned int &/*Bcols*/, const vpArray2D<double> & /*A*/, const vpArray2D<double> & /*B*/, const double & /*alpha*/,vpArray2D<double> &/*D*/){}
-
-template<>
-inline void GEMM1<0>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A, const vpArray2D<double> & B, const double & alpha,vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[n][c]*alpha;
-      D[r][c]=sum;
-    }
-}
-
-template<>
-inline void GEMM1<1>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A, const vpArray2D<double> & B, const double & alpha,vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[n][c]*alpha;
-      D[r][c]=sum;
-    }
-}
-
-template<>
-inline void GEMM1<2>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha,vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[c][n]*alpha;
-      D[r][c]=sum;
-    }
-}
-
-template<>
-inline void GEMM1<3>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha,vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[c][n]*alpha;
-      D[r][c]=sum;
-    }
-}
-
-template<unsigned int>
-inline void GEMM2(const unsigned int &/*Arows*/,const unsigned int &/*Brows*/, const unsigned int &/*Bcols*/, const vpArray2D<double> & /*A*/,const vpArray2D<double> & /*B*/, const double & /*alpha*/, const vpArray2D<double> & /*C*/ , const double &/*beta*/, vpArray2D<double> &/*D*/)
-{}
-
-template<>
-inline void GEMM2<0>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[n][c]*alpha;
-      D[r][c]=sum+C[r][c]*beta;
-    }
-}
+VISP_EXPORT void vpGEMMKernel(unsigned int M, unsigned int N, unsigned int K, double alpha,
+                              const double *A, unsigned int rsA, unsigned int csA,
+                              const double *B, unsigned int rsB, unsigned int csB,
+                              double *C, unsigned int ldc);
+VISP_EXPORT void vpSYRKKernel(unsigned int N, unsigned int K, double alpha,
+                              const double *A, unsigned int rsA, unsigned int csA,
+                              double *C, unsigned int ldc);
 
-template<>
-inline void GEMM2<1>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
+template<unsigned int T>
+inline void GEMMkernel(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A, const vpArray2D<double> & B, const double & alpha,vpArray2D<double> &D)
 {
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[n][c]*alpha;
-      D[r][c]=sum+C[r][c]*beta;
-    }
-}
+  unsigned int rsA = (T & VP_GEMM_A_T) ? 1 : A.getCols();
+  unsigned int csA = (T & VP_GEMM_A_T) ? A.getCols() : 1;
+  unsigned int rsB = (T & VP_GEMM_B_T) ? 1 : B.getCols();
+  unsigned int csB = (T & VP_GEMM_B_T) ? B.getCols() : 1;
 
-template<>
-inline void GEMM2<2>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[c][n]*alpha;
-      D[r][c]=sum+C[r][c]*beta;
-    }
+  vpGEMMKernel(Arows, Bcols, Brows, alpha, A.data, rsA, csA, B.data, rsB, csB, D.data, D.getCols());
 }
 
-template<>
-inline void GEMM2<3>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
+template<unsigned int T>
+inline void GEMM1(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A, const vpArray2D<double> & B, const double & alpha,vpArray2D<double> &D)
 {
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[c][n]*alpha;
-      D[r][c]=sum+C[r][c]*beta;
-    }
-}
-
+  for(unsigned int i=0;i<D.size();i++)
+    D.data[i]=0;
 
-template<>
-inline void GEMM2<4>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[n][c]*alpha;
-      D[r][c]=sum+C[c][r]*beta;
-    }
+  GEMMkernel<T>(Arows,Brows,Bcols,A,B,alpha,D);
 }
 
-template<>
-inline void GEMM2<5>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
+template<unsigned int T>
+inline void GEMM2(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
 {
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[n][c]*alpha;
-      D[r][c]=sum+C[c][r]*beta;
-    }
-
-}
+  // D is initialized with beta*op(C) before accumulating alpha*op(A)*op(B)
+  vpArray2D<double> Ccopy;
+  const vpArray2D<double> *pC = &C;
+  if ((T & VP_GEMM_C_T) && (&C == &D)) {
+    Ccopy = C;
+    pC = &Ccopy;
+  }
 
-template<>
-inline void GEMM2<6>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
   for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[c][n]*alpha;
-      D[r][c]=sum+C[c][r]*beta;
-    }
-}
+    for(unsigned int c=0;c<Bcols;c++)
+      D[r][c]=beta*((T & VP_GEMM_C_T) ? (*pC)[c][r] : (*pC)[r][c]);
 
-template<>
-inline void GEMM2<7>(const unsigned int &Arows, const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[c][n]*alpha;
-      D[r][c]=sum+C[c][r]*beta;
-    }
+  GEMMkernel<T>(Arows,Brows,Bcols,A,B,alpha,D);
 }
 
 template<unsigned int T>
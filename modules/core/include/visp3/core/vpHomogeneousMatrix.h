@@ -90,7 +90,7 @@ class vpPoint;
   \f$ ^a{\bf t}_b \f$ is a translation vector.
 
 */
-class VISP_EXPORT vpHomogeneousMatrix : public vpArray2D<double>
+class VISP_EXPORT vpHomogeneousMatrix : private vpArray2DStorageHolder<double, 4, 4>, public vpArray2D<double>
 {
  public:
   vpHomogeneousMatrix();
@@ -193,7 +193,6 @@ class VISP_EXPORT vpHomogeneousMatrix : public vpArray2D<double>
   vp_deprecated void setIdentity();
   //@}
 #endif
-
 } ;
 
 #endif
@@ -50,9 +50,7 @@
 #include <visp3/core/vpImageException.h>
 #include <visp3/core/vpImagePoint.h>
 #include <visp3/core/vpRGBa.h>
-#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
-#  include <visp3/core/vpThread.h>
-#endif
+#include <visp3/core/vpThreadPool.h>
 
 #include <fstream>
 #include <iostream>
@@ -234,6 +232,8 @@ public:
   void init(unsigned int height, unsigned int width, Type value);
   //! init from an image stored as a continuous array in memory
   void init(Type * const array, const unsigned int height, const unsigned int width, const bool copyData=false);
+  //! init from an external array in memory that is not freed by the image
+  void initNonOwning(Type * const array, const unsigned int height, const unsigned int width);
   void insert(const vpImage<Type> &src, const vpImagePoint topLeft);
 
   //------------------------------------------------------------------
@@ -339,6 +339,7 @@ private:
   unsigned int width;   ///! number of columns
   unsigned int height;  ///! number of rows
   Type **row;           ///! points the row pointer array
+  bool hasOwnership;    ///! false if the bitmap is an external array given to initNonOwning()
 };
 
 template<class Type>
@@ -467,28 +468,19 @@ inline std::ostream& operator<<(std::ostream &s, const vpImage<double> &I) {
 }
 
 
-#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
 namespace {
   struct ImageLut_Param_t {
-    unsigned int m_start_index;
-    unsigned int m_end_index;
-
-    unsigned char m_lut[256];
+    const unsigned char *m_lut;
     unsigned char *m_bitmap;
 
-    ImageLut_Param_t() : m_start_index(0), m_end_index(0), m_lut(), m_bitmap(NULL) {
-    }
-
-    ImageLut_Param_t(const unsigned int start_index, const unsigned int end_index,
-        unsigned char *bitmap) :
-      m_start_index(start_index), m_end_index(end_index), m_lut(), m_bitmap(bitmap) {
+    ImageLut_Param_t(const unsigned char *lut, unsigned char *bitmap) :
+      m_lut(lut), m_bitmap(bitmap) {
     }
   };
 
-  vpThread::Return performLutThread(vpThread::Args args) {
+  void performLutRange(unsigned int start_index, unsigned int end_index, void *args) {
     ImageLut_Param_t *imageLut_param = ( (ImageLut_Param_t *) args );
-    unsigned int start_index = imageLut_param->m_start_index;
-    unsigned int end_index = imageLut_param->m_end_index;
+    const unsigned char *lut = imageLut_param->m_lut;
 
     unsigned char *bitmap = imageLut_param->m_bitmap;
 
@@ -496,69 +488,53 @@ namespace {
     unsigned char *ptrEnd = bitmap + end_index;
     unsigned char *ptrCurrent = ptrStart;
 
-
-//    while(ptrCurrent != ptrEnd) {
-//      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-//      ++ptrCurrent;
-//    }
-
     if(end_index - start_index >= 8) {
       //Unroll loop version
       for(; ptrCurrent <= ptrEnd - 8;) {
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
+        *ptrCurrent = lut[*ptrCurrent];
         ++ptrCurrent;
 
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
+        *ptrCurrent = lut[*ptrCurrent];
         ++ptrCurrent;
 
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
+        *ptrCurrent = lut[*ptrCurrent];
         ++ptrCurrent;
 
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
+        *ptrCurrent = lut[*ptrCurrent];
         ++ptrCurrent;
 
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
+        *ptrCurrent = lut[*ptrCurrent];
         ++ptrCurrent;
 
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
+        *ptrCurrent = lut[*ptrCurrent];
         ++ptrCurrent;
 
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
+        *ptrCurrent = lut[*ptrCurrent];
         ++ptrCurrent;
 
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
+        *ptrCurrent = lut[*ptrCurrent];
         ++ptrCurrent;
       }
     }
 
     for(; ptrCurrent != ptrEnd; ++ptrCurrent) {
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
+      *ptrCurrent = lut[*ptrCurrent];
     }
-
-    return 0;
   }
 
 
   struct ImageLutRGBa_Param_t {
-    unsigned int m_start_index;
-    unsigned int m_end_index;
-
-    vpRGBa m_lut[256];
+    const vpRGBa *m_lut;
     unsigned char *m_bitmap;
 
-    ImageLutRGBa_Param_t() : m_start_index(0), m_end_index(0), m_lut(), m_bitmap(NULL) {
-    }
-
-    ImageLutRGBa_Param_t(const unsigned int start_index, const unsigned int end_index,
-        unsigned char *bitmap) :
-      m_start_index(start_index), m_end_index(end_index), m_lut(), m_bitmap(bitmap) {
+    ImageLutRGBa_Param_t(const vpRGBa *lut, unsigned char *bitmap) :
+      m_lut(lut), m_bitmap(bitmap) {
     }
   };
 
-  vpThread::Return performLutRGBaThread(vpThread::Args args) {
+  void performLutRGBaRange(unsigned int start_index, unsigned int end_index, void *args) {
     ImageLutRGBa_Param_t *imageLut_param = ( (ImageLutRGBa_Param_t *) args );
-    unsigned int start_index = imageLut_param->m_start_index;
-    unsigned int end_index = imageLut_param->m_end_index;
+    const vpRGBa *lut = imageLut_param->m_lut;
 
     unsigned char *bitmap = imageLut_param->m_bitmap;
 
@@ -570,44 +546,41 @@ namespace {
     if(end_index - start_index >= 4*2) {
       //Unroll loop version
       for(; ptrCurrent <= ptrEnd - 4*2;) {
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].R;
+        *ptrCurrent = lut[*ptrCurrent].R;
         ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].G;
+        *ptrCurrent = lut[*ptrCurrent].G;
         ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].B;
+        *ptrCurrent = lut[*ptrCurrent].B;
         ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].A;
+        *ptrCurrent = lut[*ptrCurrent].A;
         ptrCurrent++;
 
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].R;
+        *ptrCurrent = lut[*ptrCurrent].R;
         ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].G;
+        *ptrCurrent = lut[*ptrCurrent].G;
         ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].B;
+        *ptrCurrent = lut[*ptrCurrent].B;
         ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].A;
+        *ptrCurrent = lut[*ptrCurrent].A;
         ptrCurrent++;
       }
     }
 
     while(ptrCurrent != ptrEnd) {
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].R;
+      *ptrCurrent = lut[*ptrCurrent].R;
       ptrCurrent++;
 
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].G;
+      *ptrCurrent = lut[*ptrCurrent].G;
       ptrCurrent++;
 
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].B;
+      *ptrCurrent = lut[*ptrCurrent].B;
       ptrCurrent++;
 
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].A;
+      *ptrCurrent = lut[*ptrCurrent].A;
       ptrCurrent++;
     }
-
-    return 0;
   }
 }
-#endif
 
 
 /*!
@@ -663,14 +636,16 @@ vpImage<Type>::init(unsigned int h, unsigned int w)
     }
   }
 
-  if ((h != this->height) || (w != this->width))
+  if ((h != this->height) || (w != this->width) || !hasOwnership)
   {
     if (bitmap != NULL) {
       vpDEBUG_TRACE(10,"Destruction bitmap[]");
-      delete [] bitmap;
+      if (hasOwnership)
+        delete [] bitmap;
       bitmap = NULL;
     }
   }
+  hasOwnership = true;
 
   this->width = w;
   this->height = h;
@@ -706,8 +681,11 @@ vpImage<Type>::init(unsigned int h, unsigned int w)
   \param h : Image height.
   \param w : Image width.
   \param copyData : If false (by default) only the memory address is copied, otherwise the data are copied.
+  When false, the image takes the ownership of the array, that has to be allocated with new[], and frees it.
 
   \exception vpException::memoryAllocationError
+
+  \sa initNonOwning()
 */
 template<class Type>
 void
@@ -720,13 +698,15 @@ vpImage<Type>::init(Type * const array, const unsigned int h, const unsigned int
     }
   }
 
-  //Delete bitmap if copyData==false, otherwise only if the dimension differs
-  if ( (copyData && ((h != this->height) || (w != this->width))) || !copyData ) {
+  //Delete bitmap if copyData==false, otherwise only if the dimension differs or if the bitmap is not owned
+  if ( (copyData && ((h != this->height) || (w != this->width) || !hasOwnership)) || !copyData ) {
     if (bitmap != NULL) {
-      delete [] bitmap;
+      if (hasOwnership)
+        delete [] bitmap;
       bitmap = NULL;
     }
   }
+  hasOwnership = true;
 
   this->width = w;
   this->height = h;
@@ -759,6 +739,30 @@ vpImage<Type>::init(Type * const array, const unsigned int h, const unsigned int
   }
 }
 
+/*!
+  \brief Image initialization
+
+  Init from image data stored as a continuous array in memory owned by the
+  caller. Only the memory address is copied. The array is not freed by the
+  image and must stay valid while the image uses it. A later resize() or copy
+  allocates a new bitmap owned by the image.
+
+  \param array : Image data stored as a continuous array in memory
+  \param h : Image height.
+  \param w : Image width.
+
+  \exception vpException::memoryAllocationError
+
+  \sa init(Type * const, const unsigned int, const unsigned int, const bool)
+*/
+template<class Type>
+void
+vpImage<Type>::initNonOwning(Type * const array, const unsigned int h, const unsigned int w)
+{
+  init(array, h, w, false);
+  hasOwnership = false;
+}
+
 /*!
   \brief Constructor
 
@@ -779,7 +783,7 @@ vpImage<Type>::init(Type * const array, const unsigned int h, const unsigned int
 */
 template<class Type>
 vpImage<Type>::vpImage(unsigned int h, unsigned int w)
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), hasOwnership(true)
 {
   init(h,w,0);
 }
@@ -803,7 +807,7 @@ vpImage<Type>::vpImage(unsigned int h, unsigned int w)
 */
 template<class Type>
 vpImage<Type>::vpImage (unsigned int h, unsigned int w, Type value)
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), hasOwnership(true)
 {
   init(h,w,value);
 }
@@ -817,6 +821,7 @@ vpImage<Type>::vpImage (unsigned int h, unsigned int w, Type value)
   \param h : Image height.
   \param w : Image width.
   \param copyData : If false (by default) only the memory address is copied, otherwise the data are copied.
+  When false, the image takes the ownership of the array, that has to be allocated with new[], and frees it.
 
   \return MEMORY_FAULT if memory allocation is impossible, else OK
 
@@ -824,7 +829,7 @@ vpImage<Type>::vpImage (unsigned int h, unsigned int w, Type value)
 */
 template<class Type>
 vpImage<Type>::vpImage (Type * const array, const unsigned int h, const unsigned int w, const bool copyData)
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), hasOwnership(true)
 {
   init(array, h, w, copyData);
 }
@@ -840,7 +845,7 @@ vpImage<Type>::vpImage (Type * const array, const unsigned int h, const unsigned
 */
 template<class Type>
 vpImage<Type>::vpImage()
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), hasOwnership(true)
 {
 }
 
@@ -915,9 +920,11 @@ vpImage<Type>::destroy()
   {
   //  vpERROR_TRACE("Deallocate bitmap memory %p",bitmap);
 //    vpDEBUG_TRACE(20,"Deallocate bitmap memory %p",bitmap);
-    delete [] bitmap;
+    if (hasOwnership)
+      delete [] bitmap;
     bitmap = NULL;
   }
+  hasOwnership = true;
 
 
   if (row!=NULL)
@@ -949,7 +956,7 @@ vpImage<Type>::~vpImage()
 */
 template<class Type>
 vpImage<Type>::vpImage(const vpImage<Type>& I)
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), hasOwnership(true)
 {
   resize(I.getHeight(),I.getWidth());
   memcpy(bitmap, I.bitmap, I.npixels*sizeof(Type));
@@ -1014,9 +1021,11 @@ vpImage<Type> & vpImage<Type>::operator=(const vpImage<Type> &I)
 {
     /* we first have to set the initial values of the image because resize function calls init function that test the actual size of the image */
   if(bitmap != NULL){
-    delete[] bitmap;
+    if (hasOwnership)
+      delete[] bitmap;
     bitmap = NULL;
   }
+  hasOwnership = true;
 
   if(row != NULL){
     delete[] row;
@@ -1778,80 +1787,19 @@ void vpImage<Type>::performLut(const Type (&)[256], const unsigned int)
   Modify the intensities of a grayscale image using the look-up table passed in parameter.
 
   \param lut : Look-up table (unsigned char array of size=256) which maps each intensity to his new value.
-  \param nbThreads : Number of threads to use for the computation.
+  \param nbThreads : Number of threads to use for the computation. The threads
+  are taken from vpThreadPool and limited by vpThreadPool::getNbThreads().
 */
 template<>
 inline void vpImage<unsigned char>::performLut(const unsigned char (&lut)[256], const unsigned int nbThreads) {
-  unsigned int size = getWidth()*getHeight();
-  unsigned char *ptrStart = (unsigned char*) bitmap;
-  unsigned char *ptrEnd = ptrStart + size;
-  unsigned char *ptrCurrent = ptrStart;
+  ImageLut_Param_t imageLut_param(lut, bitmap);
 
-
-  bool use_single_thread = (nbThreads == 0 || nbThreads == 1);
-#if !defined(VISP_HAVE_PTHREAD) && !defined(_WIN32)
-  use_single_thread = true;
-#endif
-
-  if(!use_single_thread && getSize() <= nbThreads) {
-    use_single_thread = true;
-  }
-
-
-  if(use_single_thread) {
+  if(nbThreads <= 1) {
     //Single thread
-
-    while(ptrCurrent != ptrEnd) {
-      *ptrCurrent = lut[*ptrCurrent];
-      ++ptrCurrent;
-    }
+    performLutRange(0, getSize(), &imageLut_param);
   } else {
-#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
-    //Multi-threads
-
-    std::vector<vpThread *> threadpool;
-    std::vector<ImageLut_Param_t *> imageLutParams;
-
-    ImageLut_Param_t *imageLut_param = NULL;
-    vpThread *imageLut_thread = NULL;
-
-    unsigned int image_size = getSize();
-    unsigned int step = image_size / nbThreads;
-    unsigned int last_step = image_size - step * (nbThreads-1);
-
-    for(unsigned int index = 0; index < nbThreads; index++) {
-      unsigned int start_index = index*step;
-      unsigned int end_index = (index+1)*step;
-
-      if(index == nbThreads-1) {
-        end_index = start_index+last_step;
-      }
-
-      imageLut_param = new ImageLut_Param_t(start_index, end_index, bitmap);
-      memcpy(imageLut_param->m_lut, lut, 256*sizeof(unsigned char));
-
-      imageLutParams.push_back(imageLut_param);
-
-      // Start the threads
-      imageLut_thread = new vpThread((vpThread::Fn) performLutThread, (vpThread::Args) imageLut_param);
-      threadpool.push_back(imageLut_thread);
-    }
-
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      // Wait until thread ends up
-      threadpool[cpt]->join();
-    }
-
-
-    //Delete
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      delete threadpool[cpt];
-    }
-
-    for(size_t cpt = 0; cpt < imageLutParams.size(); cpt++) {
-      delete imageLutParams[cpt];
-    }
-#endif
+    //Multi-threads, blocks of pixels shared by the threads of vpThreadPool
+    vpThreadPool::parallel_for(0, getSize(), performLutRange, &imageLut_param, nbThreads, 4096);
   }
 }
 
@@ -1859,87 +1807,19 @@ inline void vpImage<unsigned char>::performLut(const unsigned char (&lut)[256],
   Modify the intensities of a color image using the look-up table passed in parameter.
 
   \param lut : Look-up table (vpRGBa array of size=256) which maps each intensity to his new value.
-  \param nbThreads : Number of threads to use for the computation.
+  \param nbThreads : Number of threads to use for the computation. The threads
+  are taken from vpThreadPool and limited by vpThreadPool::getNbThreads().
 */
 template<>
 inline void vpImage<vpRGBa>::performLut(const vpRGBa (&lut)[256], const unsigned int nbThreads) {
-  unsigned int size = getWidth()*getHeight();
-  unsigned char *ptrStart = (unsigned char*) bitmap;
-  unsigned char *ptrEnd = ptrStart + size*4;
-  unsigned char *ptrCurrent = ptrStart;
-
-
-  bool use_single_thread = (nbThreads == 0 || nbThreads == 1);
-#if !defined(VISP_HAVE_PTHREAD) && !defined(_WIN32)
-  use_single_thread = true;
-#endif
-
-  if(!use_single_thread && getSize() <= nbThreads) {
-    use_single_thread = true;
-  }
+  ImageLutRGBa_Param_t imageLut_param(lut, (unsigned char *) bitmap);
 
-
-  if(use_single_thread) {
+  if(nbThreads <= 1) {
     //Single thread
-    while(ptrCurrent != ptrEnd) {
-      *ptrCurrent = lut[*ptrCurrent].R;
-      ++ptrCurrent;
-
-      *ptrCurrent = lut[*ptrCurrent].G;
-      ++ptrCurrent;
-
-      *ptrCurrent = lut[*ptrCurrent].B;
-      ++ptrCurrent;
-
-      *ptrCurrent = lut[*ptrCurrent].A;
-      ++ptrCurrent;
-    }
+    performLutRGBaRange(0, getSize(), &imageLut_param);
   } else {
-#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
-    //Multi-threads
-    std::vector<vpThread *> threadpool;
-    std::vector<ImageLutRGBa_Param_t *> imageLutParams;
-
-    ImageLutRGBa_Param_t *imageLut_param = NULL;
-    vpThread *imageLut_thread = NULL;
-
-    unsigned int image_size = getSize();
-    unsigned int step = image_size / nbThreads;
-    unsigned int last_step = image_size - step * (nbThreads-1);
-
-    for(unsigned int index = 0; index < nbThreads; index++) {
-      unsigned int start_index = index*step;
-      unsigned int end_index = (index+1)*step;
-
-      if(index == nbThreads-1) {
-        end_index = start_index+last_step;
-      }
-
-      imageLut_param = new ImageLutRGBa_Param_t(start_index, end_index, (unsigned char *) bitmap);
-      memcpy(imageLut_param->m_lut, lut, 256*sizeof(vpRGBa));
-
-      imageLutParams.push_back(imageLut_param);
-
-      // Start the threads
-      imageLut_thread = new vpThread((vpThread::Fn) performLutRGBaThread, (vpThread::Args) imageLut_param);
-      threadpool.push_back(imageLut_thread);
-    }
-
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      // Wait until thread ends up
-      threadpool[cpt]->join();
-    }
-
-
-    //Delete
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      delete threadpool[cpt];
-    }
-
-    for(size_t cpt = 0; cpt < imageLutParams.size(); cpt++) {
-      delete imageLutParams[cpt];
-    }
-#endif
+    //Multi-threads, blocks of pixels shared by the threads of vpThreadPool
+    vpThreadPool::parallel_for(0, getSize(), performLutRGBaRange, &imageLut_param, nbThreads, 1024);
   }
 }
 
@@ -104,7 +104,7 @@ public:
   static void createDepthHistogram(const vpImage<uint16_t> &src_depth, vpImage<vpRGBa> &dest_rgba);
   static void createDepthHistogram(const vpImage<uint16_t> &src_depth, vpImage<unsigned char> &dest_depth);
   static void convert(const vpImage<unsigned char> &src, vpImage<vpRGBa> & dest) ;
-  static void convert(const vpImage<vpRGBa> &src, vpImage<unsigned char> & dest) ;
+  static void convert(const vpImage<vpRGBa> &src, vpImage<unsigned char> & dest, const unsigned int nThreads=1) ;
 
   static void convert(const vpImage<float> &src, vpImage<unsigned char> &dest);
   static void convert(const vpImage<unsigned char> &src, vpImage<float> &dest);
@@ -211,7 +211,7 @@ public:
       b = (unsigned char) db;
     }
   static void YUYVToRGBa(unsigned char* yuyv, unsigned char* rgba,
-      unsigned int width, unsigned int height);
+      unsigned int width, unsigned int height, const unsigned int nThreads=1);
   static void YUYVToRGB(unsigned char* yuyv, unsigned char* rgb,
       unsigned int width, unsigned int height);
   static void YUYVToGrey(unsigned char* yuyv, unsigned char* grey,
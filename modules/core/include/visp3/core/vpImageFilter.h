@@ -182,8 +182,12 @@ public:
                         const vpColVector& kernelH,
                         const vpColVector& kernelV);
 
-  static void filter(const vpImage<unsigned char> &I, vpImage<double>& GI, const double *filter,unsigned  int size);
-  static void filter(const vpImage<double> &I, vpImage<double>& GI, const double *filter,unsigned  int size);
+  static void filter(const vpImage<unsigned char> &I, vpImage<double>& GI, const double *filter,unsigned  int size,
+                     const unsigned int nThreads=1);
+  static void filter(const vpImage<double> &I, vpImage<double>& GI, const double *filter,unsigned  int size,
+                     const unsigned int nThreads=1);
+  static void filter(const vpImage<unsigned char> &I, vpImage<float>& GI, const double *filter,unsigned  int size,
+                     const unsigned int nThreads=1);
 
   static inline unsigned char filterGaussXPyramidal(const vpImage<unsigned char> &I, unsigned int i, unsigned int j)
   {
@@ -194,8 +198,14 @@ public:
     return (unsigned char)((1.*I[i-2][j]+4.*I[i-1][j]+6.*I[i][j]+4.*I[i+1][j]+1.*I[i+2][j])/16.);
   }
 
-  static void filterX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size);
-  static void filterX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size);
+  static void filterX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size,
+                      const unsigned int nThreads=1);
+  static void filterX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size,
+                      const unsigned int nThreads=1);
+  static void filterX(const vpImage<unsigned char> &I, vpImage<float>& dIx, const double *filter,unsigned  int size,
+                      const unsigned int nThreads=1);
+  static void filterX(const vpImage<float> &I, vpImage<float>& dIx, const double *filter,unsigned  int size,
+                      const unsigned int nThreads=1);
 
   static inline double filterX(const vpImage<unsigned char> &I,
                                unsigned int r, unsigned int c,
@@ -300,8 +310,14 @@ public:
     return result+filter[0]*I[r][c];
   }
 
-  static void filterY(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size);
-  static void filterY(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size);
+  static void filterY(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size,
+                      const unsigned int nThreads=1);
+  static void filterY(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size,
+                      const unsigned int nThreads=1);
+  static void filterY(const vpImage<unsigned char> &I, vpImage<float>& dIx, const double *filter,unsigned  int size,
+                      const unsigned int nThreads=1);
+  static void filterY(const vpImage<float> &I, vpImage<float>& dIx, const double *filter,unsigned  int size,
+                      const unsigned int nThreads=1);
   static inline double filterY(const vpImage<unsigned char> &I,
                                unsigned int r, unsigned int c,
                                const double *filter,unsigned  int size)
@@ -396,8 +412,12 @@ public:
     return result+filter[0]*I[r][c];
   }
 
-  static void gaussianBlur(const vpImage<unsigned char> &I, vpImage<double>& GI, unsigned int size=7, double sigma=0., bool normalize=true);
-  static void gaussianBlur(const vpImage<double> &I, vpImage<double>& GI, unsigned int size=7, double sigma=0., bool normalize=true);
+  static void gaussianBlur(const vpImage<unsigned char> &I, vpImage<double>& GI, unsigned int size=7, double sigma=0., bool normalize=true,
+                           const unsigned int nThreads=1);
+  static void gaussianBlur(const vpImage<double> &I, vpImage<double>& GI, unsigned int size=7, double sigma=0., bool normalize=true,
+                           const unsigned int nThreads=1);
+  static void gaussianBlur(const vpImage<unsigned char> &I, vpImage<float>& GI, unsigned int size=7, double sigma=0., bool normalize=true,
+                           const unsigned int nThreads=1);
   /*!
    Apply a 5x5 Gaussian filter to an image pixel.
 
@@ -431,17 +451,33 @@ public:
 
   //fonction renvoyant le gradient en X de l'image I pour traitement pyramidal => dimension /2
   static void getGradX(const vpImage<unsigned char> &I, vpImage<double>& dIx);
-  static void getGradX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter, unsigned int size);
-  static void getGradX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter, unsigned int size);
+  static void getGradX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter, unsigned int size,
+                       const unsigned int nThreads=1);
+  static void getGradX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter, unsigned int size,
+                       const unsigned int nThreads=1);
+  static void getGradX(const vpImage<unsigned char> &I, vpImage<float>& dIx, const double *filter, unsigned int size,
+                       const unsigned int nThreads=1);
+  static void getGradX(const vpImage<float> &I, vpImage<float>& dIx, const double *filter, unsigned int size,
+                       const unsigned int nThreads=1);
   static void getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *gaussianKernel,
-                              const double *gaussianDerivativeKernel, unsigned  int size);
+                              const double *gaussianDerivativeKernel, unsigned  int size, const unsigned int nThreads=1);
+  static void getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<float>& dIx, const double *gaussianKernel,
+                              const double *gaussianDerivativeKernel, unsigned  int size, const unsigned int nThreads=1);
 
   //fonction renvoyant le gradient en Y de l'image I
   static void getGradY(const vpImage<unsigned char> &I, vpImage<double>& dIy);
-  static void getGradY(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *filter, unsigned int size);
-  static void getGradY(const vpImage<double> &I, vpImage<double>& dIy, const double *filter, unsigned int size);
+  static void getGradY(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *filter, unsigned int size,
+                       const unsigned int nThreads=1);
+  static void getGradY(const vpImage<double> &I, vpImage<double>& dIy, const double *filter, unsigned int size,
+                       const unsigned int nThreads=1);
+  static void getGradY(const vpImage<unsigned char> &I, vpImage<float>& dIy, const double *filter, unsigned int size,
+                       const unsigned int nThreads=1);
+  static void getGradY(const vpImage<float> &I, vpImage<float>& dIy, const double *filter, unsigned int size,
+                       const unsigned int nThreads=1);
   static void getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *gaussianKernel,
-                              const double *gaussianDerivativeKernel,unsigned  int size);
+                              const double *gaussianDerivativeKernel,unsigned  int size, const unsigned int nThreads=1);
+  static void getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<float>& dIy, const double *gaussianKernel,
+                              const double *gaussianDerivativeKernel,unsigned  int size, const unsigned int nThreads=1);
 };
 
 
@@ -0,0 +1,141 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Image pyramid with buffers kept across frames.
+ *
+ *****************************************************************************/
+
+#ifndef vpImagePyramid_H
+#define vpImagePyramid_H
+
+/*!
+  \file vpImagePyramid.h
+  \brief Image pyramid whose levels are reused from one frame to the next.
+*/
+
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+
+/*!
+  \class vpImagePyramid
+
+  \ingroup group_core_image
+
+  \brief Pyramid of grey level images built in place from one frame to the
+  next.
+
+  Level 0 is the image given to build(); it is not copied, so it must stay
+  alive and unchanged as long as the pyramid is used. Level \f$ l \f$ has
+  the size of level \f$ l-1 \f$ divided by two, and is obtained either:
+  - with vpImagePyramid::GAUSSIAN_FILTER, by filtering the previous level
+    with the separable [1 4 6 4 1]/16 kernel of
+    vpImageFilter::getGaussXPyramidal() and
+    vpImageFilter::getGaussYPyramidal();
+  - with vpImagePyramid::SUBSAMPLING, by keeping one pixel out of two along
+    each direction, as done by the model-based edge tracker.
+
+  The images of the levels 1 and above are owned by the pyramid and are only
+  reallocated when the size of the input image changes. Once built, the
+  pyramid can be shared read-only between several trackers working on the
+  same frame (see vpMbEdgeTracker::track(const vpImagePyramid &) and
+  vpTemplateTracker::track(const vpImagePyramid &)), so that the downsampling
+  is done only once.
+
+  \code
+#include <visp3/core/vpImagePyramid.h>
+
+int main()
+{
+  vpImage<unsigned char> I(480, 640);
+  vpImagePyramid pyramid(3);
+
+  for (int frame = 0; frame < 100; frame++) {
+    // acquire I
+    pyramid.build(I);
+    const vpImage<unsigned char> &I2 = pyramid[2]; // 120 x 160 image
+  }
+}
+  \endcode
+*/
+class VISP_EXPORT vpImagePyramid
+{
+public:
+  /*! \enum vpImagePyramidFilterType
+    Method used to compute a level from the previous one.
+  */
+  typedef enum {
+    GAUSSIAN_FILTER, /*!< Filter with the [1 4 6 4 1]/16 kernel before keeping one pixel out of two. */
+    SUBSAMPLING      /*!< Keep one pixel out of two without filtering. */
+  } vpImagePyramidFilterType;
+
+  explicit vpImagePyramid(unsigned int nbLevels=1, const vpImagePyramidFilterType &type=GAUSSIAN_FILTER);
+
+  void build(const vpImage<unsigned char> &I);
+
+  /*!
+    Return the method used to compute the levels.
+  */
+  inline vpImagePyramidFilterType getFilterType() const { return m_filterType; }
+  const vpImage<unsigned char> &getLevel(unsigned int level) const;
+  /*!
+    Return the number of levels, including level 0.
+  */
+  inline unsigned int getNbLevels() const { return m_nbLevels; }
+  /*!
+    Return true when build() was called since the last change of the number
+    of levels or of the filter type.
+  */
+  inline bool isBuilt() const { return m_I0 != NULL; }
+
+  void setFilterType(const vpImagePyramidFilterType &type);
+  void setNbLevels(unsigned int nbLevels);
+
+  /*!
+    Return the image of the given level.
+    \sa getLevel()
+  */
+  inline const vpImage<unsigned char> &operator[](unsigned int level) const { return getLevel(level); }
+
+private:
+  //! Number of levels, including level 0
+  unsigned int m_nbLevels;
+  //! Method used to compute the levels
+  vpImagePyramidFilterType m_filterType;
+  //! Image of level 0, not owned
+  const vpImage<unsigned char> *m_I0;
+  //! Images of the levels 1 to m_nbLevels-1
+  std::vector< vpImage<unsigned char> > m_levels;
+  //! Intermediate image of the separable filter
+  vpImage<unsigned char> m_buffer;
+};
+
+#endif
@@ -48,15 +48,11 @@
 */
 
 #include <visp3/core/vpImage.h>
-
-#ifdef VISP_HAVE_PTHREAD
-#  include <pthread.h>
-#endif
-
 #include <visp3/core/vpImageException.h>
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpRect.h>
 #include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpThreadPool.h>
 
 #include <fstream>
 #include <iostream>
@@ -477,52 +473,31 @@ inline void vpImageTools::binarise(vpImage<unsigned char> &I,
   }
 }
 
-#ifdef VISP_HAVE_PTHREAD
-
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 template<class Type>
 class vpUndistortInternalType
 {
 public:
-  Type *src;
+  const Type *src;
   Type *dst;
   unsigned int width;
   unsigned int height;
   vpCameraParameters cam;
-  unsigned int nthreads;
-  unsigned int threadid;
 public:
   vpUndistortInternalType()
-    : src(NULL), dst(NULL), width(0), height(0), cam(), nthreads(0), threadid(0)
+    : src(NULL), dst(NULL), width(0), height(0), cam()
   {};
 
-  vpUndistortInternalType(const vpUndistortInternalType<Type> &u) {
-    *this = u;
-  };
-  vpUndistortInternalType &operator=(const vpUndistortInternalType<Type> &u) {
-    src = u.src;
-    dst = u.dst;
-    width = u.width;
-    height = u.height;
-    cam = u.cam;
-    nthreads = u.nthreads;
-    threadid = u.threadid;
-
-    return *this;
-  }
-
-  static void *vpUndistort_threaded(void *arg);
+  static void undistortRows(unsigned int begin, unsigned int end, void *arg);
 };
 
 
 template<class Type>
-void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
+void vpUndistortInternalType<Type>::undistortRows(unsigned int begin, unsigned int end, void *arg)
 {
   vpUndistortInternalType<Type> *undistortSharedData = (vpUndistortInternalType<Type>*)arg;
-  int offset   = (int)undistortSharedData->threadid;
   int width    = (int)undistortSharedData->width;
   int height   = (int)undistortSharedData->height;
-  int nthreads = (int)undistortSharedData->nthreads;
 
   double u0 = undistortSharedData->cam.get_u0();
   double v0 = undistortSharedData->cam.get_v0();
@@ -536,10 +511,10 @@ void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
   double kud_px2 = kud * invpx * invpx;
   double kud_py2 = kud * invpy * invpy;
 
-  Type *dst = undistortSharedData->dst+(height/nthreads*offset)*width;
-  Type *src = undistortSharedData->src;
+  Type *dst = undistortSharedData->dst+begin*(unsigned int)width;
+  const Type *src = undistortSharedData->src;
 
-  for (double v = height/nthreads*offset;v < height/nthreads*(offset+1) ; v++) {
+  for (double v = begin; v < end; v++) {
     double  deltav  = v - v0;
     //double fr1 = 1.0 + kd * (vpMath::sqr(deltav * invpy));
     double fr1 = 1.0 + kud_py2 * deltav * deltav;
@@ -579,12 +554,8 @@ void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
       dst++;
     }
   }
-
-  pthread_exit((void*) 0);
-  return NULL;
 }
 #endif // DOXYGEN_SHOULD_SKIP_THIS
-#endif // VISP_HAVE_PTHREAD
 
 /*!
   Undistort an image
@@ -604,76 +575,23 @@ void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
   \warning This function is time consuming :
     - On "Rhea"(Intel Core 2 Extreme X6800 2.93GHz, 2Go RAM)
       or "Charon"(Intel Xeon 3 GHz, 2Go RAM) : ~8 ms for a 640x480 image.
+    When several images of the same size are undistorted, prefer
+    vpUndistortMap that precomputes the remap table once.
+
+  The rows are shared between the threads of vpThreadPool.
+
+  \sa vpUndistortMap
 */
 template<class Type>
 void vpImageTools::undistort(const vpImage<Type> &I,
                              const vpCameraParameters &cam,
                              vpImage<Type> &undistI)
 {
-#ifdef VISP_HAVE_PTHREAD
-  //
-  // Optimized version using pthreads
-  //
-  unsigned int width = I.getWidth();
-  unsigned int height = I.getHeight();
-
-  undistI.resize(height, width);
-
-  double kud = cam.get_kud();
-
-  //if (kud == 0) {
-  if (std::fabs(kud) <= std::numeric_limits<double>::epsilon()) {
-    // There is no need to undistort the image
-    undistI = I;
-    return;
-  }
-
-  unsigned int nthreads = 2;
-  pthread_attr_t attr;
-  pthread_t *callThd = new pthread_t [nthreads];
-  pthread_attr_init(&attr);
-  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-
-  vpUndistortInternalType<Type> *undistortSharedData;
-  undistortSharedData = new vpUndistortInternalType<Type> [nthreads];
-
-  for(unsigned int i=0;i<nthreads;i++) {
-    // Each thread works on a different set of data.
-    //    vpTRACE("create thread %d", i);
-    undistortSharedData[i].src      = I.bitmap;
-    undistortSharedData[i].dst      = undistI.bitmap;
-    undistortSharedData[i].width    = I.getWidth();
-    undistortSharedData[i].height   = I.getHeight();
-    undistortSharedData[i].cam      = cam;
-    undistortSharedData[i].nthreads = nthreads;
-    undistortSharedData[i].threadid = i;
-    pthread_create( &callThd[i], &attr,
-                    &vpUndistortInternalType<Type>::vpUndistort_threaded,
-                    &undistortSharedData[i]);
-  }
-  pthread_attr_destroy(&attr);
-  /* Wait on the other threads */
-
-  for(unsigned int i=0;i<nthreads;i++) {
-    //  vpTRACE("join thread %d", i);
-    pthread_join( callThd[i], NULL);
-  }
-
-  delete [] callThd;
-  delete [] undistortSharedData;
-#else // VISP_HAVE_PTHREAD
-  //
-  // optimized version without pthreads
-  //
   unsigned int width = I.getWidth();
   unsigned int height = I.getHeight();
 
   undistI.resize(height, width);
 
-  double u0 = cam.get_u0();
-  double v0 = cam.get_v0();
-  double px = cam.get_px();
-  double py = cam.get_py();
   double kud = cam.get_kud();
 
   //if (kud == 0) {
@@ -683,90 +601,14 @@ void vpImageTools::undistort(const vpImage<Type> &I,
     return;
   }
 
-  double invpx = 1.0/px;
-  double invpy = 1.0/py;
-
-  double kud_px2 = kud * invpx * invpx;
-  double kud_py2 = kud * invpy * invpy;
-
-  Type *dst = undistI.bitmap;
-  for (double v = 0;v < height ; v++) {
-    double  deltav  = v - v0;
-    //double fr1 = 1.0 + kd * (vpMath::sqr(deltav * invpy));
-    double fr1 = 1.0 + kud_py2 * deltav * deltav;
-
-    for (double u = 0 ; u < width ; u++) {
-      //computation of u,v : corresponding pixel coordinates in I.
-      double  deltau  = u - u0;
-      //double fr2 = fr1 + kd * (vpMath::sqr(deltau * invpx));
-      double fr2 = fr1 + kud_px2 * deltau * deltau;
-
-      double u_double = deltau * fr2 + u0;
-      double v_double = deltav * fr2 + v0;
-
-      //printf("[%g][%g] %g %g : ", u, v, u_double, v_double );
-
-      //computation of the bilinear interpolation
-
-      //declarations
-      int u_round  = (int) (u_double);
-      int v_round  = (int) (v_double);
-      if (u_round < 0.f) u_round = -1;
-      if (v_round < 0.f) v_round = -1;
-      double  du_double  = (u_double) - (double) u_round;
-      double  dv_double  = (v_double) - (double) v_round;
-      Type  v01;
-      Type  v23;
-      if ( (0 <= u_round) && (0 <= v_round) &&
-           (u_round < (((int)width) - 1)) && (v_round < (((int)height) - 1)) ) {
-        //process interpolation
-        const Type* _mp = &I[(unsigned int)v_round][(unsigned int)u_round];
-        v01 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-        _mp += width;
-        v23 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-        *dst = (Type)(v01 + ((v23 - v01) * dv_double));
-        //printf("R %d G %d B %d\n", dst->R, dst->G, dst->B);
-      }
-      else {
-        *dst = 0;
-      }
-      dst++;
-    }
-  }
-#endif // VISP_HAVE_PTHREAD
-
-
-
-
-#if 0
-  // non optimized version
-  int width = I.getWidth();
-  int height = I.getHeight();
+  vpUndistortInternalType<Type> undistortSharedData;
+  undistortSharedData.src    = I.bitmap;
+  undistortSharedData.dst    = undistI.bitmap;
+  undistortSharedData.width  = width;
+  undistortSharedData.height = height;
+  undistortSharedData.cam    = cam;
 
-  undistI.resize(height,width);
-
-  double u0 = cam.get_u0();
-  double v0 = cam.get_v0();
-  double px = cam.get_px();
-  double py = cam.get_py();
-  double kd = cam.get_kud();
-
-  if (kd == 0) {
-    // There is no need to undistort the image
-    undistI = I;
-    return;
-  }
-
-  for(int v = 0 ; v < height; v++){
-    for(int u = 0; u < height; u++){
-      double r2 = vpMath::sqr(((double)u - u0)/px) +
-                  vpMath::sqr(((double)v-v0)/py);
-      double u_double = ((double)u - u0)*(1.0+kd*r2) + u0;
-      double v_double = ((double)v - v0)*(1.0+kd*r2) + v0;
-      undistI[v][u] = I.getPixelBI((float)u_double,(float)v_double);
-    }
-  }
-#endif
+  vpThreadPool::parallel_for(0, height, &vpUndistortInternalType<Type>::undistortRows, &undistortSharedData, 0, 8);
 }
 
 /*!
@@ -0,0 +1,188 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Organized point cloud stored in contiguous arrays.
+ *
+ *****************************************************************************/
+
+#ifndef vpPointCloud_H
+#define vpPointCloud_H
+
+/*!
+  \file vpPointCloud.h
+  \brief Organized point cloud stored as contiguous arrays of coordinates.
+*/
+
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpRGBa.h>
+
+/*!
+  \class vpPointCloud
+
+  \ingroup group_core_image
+
+  \brief Point cloud organized as the depth map it comes from, stored as
+  separate contiguous arrays of X, Y and Z coordinates, with an optional
+  color and a validity flag per point.
+
+  A point cloud given as a <tt>std::vector<vpColVector></tt> needs one heap
+  allocated vector per point. vpPointCloud stores the coordinates of the
+  points of an image of size height x width in three arrays of floats, the
+  point of pixel \f$(i,j)\f$ having the index \f$ i \times width + j \f$.
+  The arrays are kept from one acquisition to the other, so that filling the
+  cloud of a new frame of the same size doesn't allocate any memory.
+
+  buildFrom() deprojects a depth map with the perspective model of the
+  camera, without distortion:
+  \f[ Z = d \times scale, \quad X = \frac{u - u_0}{p_x} Z, \quad Y = \frac{v - v_0}{p_y} Z \f]
+  where \f$ d \f$ is the depth of pixel \f$(u,v)\f$. Points whose depth
+  is not in \f$ ]0, Z_{max}] \f$ are invalid: their coordinates are set to
+  the value given by setInvalidValue(). The rows are processed with SSE2
+  when available and shared between the threads of vpThreadPool (see
+  setNbThreads()).
+
+  \code
+#include <visp3/core/vpPointCloud.h>
+
+int main()
+{
+  vpCameraParameters cam(600, 600, 320, 240);
+  vpImage<uint16_t> depth(480, 640);
+  vpPointCloud cloud;
+
+  for (int frame = 0; frame < 100; frame++) {
+    // acquire the depth map in millimeters
+    cloud.buildFrom(depth, cam, 0.001f, 5.f);
+    for (unsigned int i = 0; i < cloud.getHeight(); i++)
+      for (unsigned int j = 0; j < cloud.getWidth(); j++)
+        if (cloud.isValid(i, j))
+          std::cout << cloud.getZ()[cloud.getIndex(i, j)] << std::endl;
+  }
+}
+  \endcode
+
+  The RGB-D grabbers (vpRealSense, vpKinect) fill a vpPointCloud in place.
+*/
+class VISP_EXPORT vpPointCloud
+{
+public:
+  vpPointCloud();
+  vpPointCloud(unsigned int height, unsigned int width, bool withColor=false);
+
+  void buildFrom(const vpImage<uint16_t> &depth, const vpCameraParameters &cam, float depthScale, float maxZ=-1.f);
+  void buildFrom(const vpImage<float> &depth, const vpCameraParameters &cam, float maxZ=-1.f);
+
+  void clear();
+  void convert(std::vector<vpColVector> &pointcloud) const;
+
+  //! Return the colors of the points, NULL without color (see hasColor()).
+  inline vpRGBa *getColor() { return m_color.empty() ? NULL : &m_color[0]; }
+  //! Return the colors of the points, NULL without color (see hasColor()).
+  inline const vpRGBa *getColor() const { return m_color.empty() ? NULL : &m_color[0]; }
+  //! Return the number of rows of the cloud.
+  inline unsigned int getHeight() const { return m_height; }
+  //! Return the index in the arrays of the point of pixel (i, j).
+  inline unsigned int getIndex(unsigned int i, unsigned int j) const { return i * m_width + j; }
+  //! Return the value of the coordinates of the invalid points.
+  inline float getInvalidValue() const { return m_invalidValue; }
+  unsigned int getNbValid() const;
+  //! Return the number of threads used by buildFrom(), 0 meaning vpThreadPool::getNbThreads().
+  inline unsigned int getNbThreads() const { return m_nbThreads; }
+  //! Return the number of points of the cloud, valid or not.
+  inline unsigned int getSize() const { return m_height * m_width; }
+  //! Return the validity flags (0 or 1) of the points.
+  inline unsigned char *getValidity() { return m_valid.empty() ? NULL : &m_valid[0]; }
+  //! Return the validity flags (0 or 1) of the points.
+  inline const unsigned char *getValidity() const { return m_valid.empty() ? NULL : &m_valid[0]; }
+  //! Return the number of columns of the cloud.
+  inline unsigned int getWidth() const { return m_width; }
+  //! Return the X coordinates of the points.
+  inline float *getX() { return m_X.empty() ? NULL : &m_X[0]; }
+  //! Return the X coordinates of the points.
+  inline const float *getX() const { return m_X.empty() ? NULL : &m_X[0]; }
+  //! Return the Y coordinates of the points.
+  inline float *getY() { return m_Y.empty() ? NULL : &m_Y[0]; }
+  //! Return the Y coordinates of the points.
+  inline const float *getY() const { return m_Y.empty() ? NULL : &m_Y[0]; }
+  //! Return the Z coordinates of the points.
+  inline float *getZ() { return m_Z.empty() ? NULL : &m_Z[0]; }
+  //! Return the Z coordinates of the points.
+  inline const float *getZ() const { return m_Z.empty() ? NULL : &m_Z[0]; }
+
+  //! Return true if the cloud has a color per point.
+  inline bool hasColor() const { return m_withColor; }
+  //! Return true if the point of pixel (i, j) has a valid depth.
+  inline bool isValid(unsigned int i, unsigned int j) const { return m_valid[i * m_width + j] != 0; }
+
+  void resize(unsigned int height, unsigned int width, bool withColor=false);
+
+  void setColor(const vpImage<vpRGBa> &color);
+  /*!
+    Set the value given to the coordinates of the invalid points by
+    buildFrom(), 0 by default. The Point Cloud Library uses NAN.
+  */
+  inline void setInvalidValue(float value) { m_invalidValue = value; }
+  void setNbThreads(unsigned int nbThreads);
+
+private:
+  void deproject(const void *depth, bool isFloat, const vpCameraParameters &cam, float depthScale, float maxZ);
+
+  //! Number of rows
+  unsigned int m_height;
+  //! Number of columns
+  unsigned int m_width;
+  //! True if a color is stored per point
+  bool m_withColor;
+  //! Coordinates of the invalid points
+  float m_invalidValue;
+  //! Number of threads used by buildFrom()
+  unsigned int m_nbThreads;
+  //! X coordinates
+  std::vector<float> m_X;
+  //! Y coordinates
+  std::vector<float> m_Y;
+  //! Z coordinates
+  std::vector<float> m_Z;
+  //! Validity of the points (0 or 1)
+  std::vector<unsigned char> m_valid;
+  //! Colors of the points, empty without color
+  std::vector<vpRGBa> m_color;
+  //! (u - u0) / px for each column, kept between the calls of buildFrom()
+  std::vector<float> m_xFactor;
+  //! (v - v0) / py for each row, kept between the calls of buildFrom()
+  std::vector<float> m_yFactor;
+};
+
+#endif
@@ -61,6 +61,10 @@
   class documentation for more details about the frame) are used \f$ (0,0) \f$,
  \f$ (1,0) \f$ and \f$ (0,1) \f$.
 
+  To mark all the pixels inside a polygon, fill() is much faster than
+  calling isInside() on each pixel of the bounding box: the edges are
+  intersected once per image row and the pixels are set span by span.
+
   The code bellow shows how to manipulate a polygon.
 \code
 #include <iostream>
@@ -133,6 +137,10 @@ class VISP_EXPORT vpPolygon
     
     bool isInside(const vpImagePoint &iP, const PointInPolygonMethod &method=PnPolyRayCasting) const;
 
+    void fill(vpImage<unsigned char> &I, const unsigned char value, const unsigned int border=0) const;
+    void fill(unsigned char *bitmap, const unsigned int height, const unsigned int width, const unsigned int step,
+              const unsigned char value, const unsigned int border=0) const;
+
     void display(const vpImage<unsigned char>& I, const vpColor& color, unsigned int thickness=1) const;
     
     /*!
@@ -185,6 +193,7 @@ class VISP_EXPORT vpPolygon
   private:
     bool testIntersectionSegments(const vpImagePoint& ip1, const vpImagePoint& ip2, const vpImagePoint& ip3, const vpImagePoint& ip4) const;
     void precalcValuesPnPoly();
+    void getRowSpans(const double v, const int u_min, const int u_max, std::vector<double> &crossings, std::vector<int> &spans) const;
 
     std::vector<double> m_PnPolyConstants;
     std::vector<double> m_PnPolyMultiples;
@@ -90,11 +90,13 @@ class vpRowVector;
   see vpThetaUVector documentation.
 
 */
-class VISP_EXPORT vpPoseVector : public vpArray2D<double>
+class VISP_EXPORT vpPoseVector : private vpArray2DStorageHolder<double, 6, 1>, public vpArray2D<double>
 {
 public:
   // constructor
   vpPoseVector() ;
+  // copy constructor
+  vpPoseVector(const vpPoseVector &p) ;
   // constructor from 3 angles (in radian)
   vpPoseVector(const double tx, const double ty, const double tz,
                const double tux, const double tuy, const double tuz) ;
@@ -179,6 +181,8 @@ public:
   */
   inline const double &operator [](unsigned int i) const { return *(data+i);  }
 
+  vpPoseVector &operator=(const vpPoseVector &p);
+
   // Print  a vector [T thetaU] thetaU in degree
   void print() const;
   int print(std::ostream& s, unsigned int length, char const* intro=0) const;
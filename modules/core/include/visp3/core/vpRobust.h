@@ -49,6 +49,7 @@
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpMath.h>
 
+#include <vector>
 
 /*!
   \class vpRobust
@@ -56,6 +57,13 @@
   \brief Contains an M-Estimator and various influence function.
 
   Supported methods: M-estimation, Tukey, Cauchy and Huber
+
+  The median and the median absolute deviation of the residues are selected
+  in place in buffers kept from one call to the other, and the weights are
+  computed with SSE2 instructions when available. The residues of several
+  independent blocks, for example the residues of each kind of feature of a
+  model-based tracker, can be weighted in one call with their own scale
+  estimate by the MEstimator() method that takes the sizes of the blocks.
 */
 class VISP_EXPORT vpRobust
 {
@@ -111,6 +119,12 @@ public:
 		 const vpColVector& all_residues,
 		 vpColVector &weights);
 
+  void MEstimator(const vpRobustEstimatorType method,
+                  const vpColVector &residues,
+                  const std::vector<unsigned int> &blockSizes,
+                  const std::vector<double> &noiseThresholds,
+                  vpColVector &weights);
+
   vpRobust & operator=(const vpRobust &other);
 #ifdef VISP_HAVE_CPP11_COMPATIBILITY
   vpRobust & operator=(const vpRobust &&other);
@@ -141,6 +155,10 @@ public:
 //   double median(const vpColVector &x, vpColVector &weights);
 
  private:
+  void computeWeights(const vpRobustEstimatorType method, const double *residues, const unsigned int n_data,
+                      const double noiseThreshold, double *weights);
+  void reserve(unsigned int n_data);
+
   //!Compute normalized median
   double computeNormalizedMedian(vpColVector &all_normres,
 				 const vpColVector &residues,
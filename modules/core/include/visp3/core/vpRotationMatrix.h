@@ -67,7 +67,7 @@
   The vpRotationMatrix class is derived from vpArray2D<double>.
 
 */
-class VISP_EXPORT vpRotationMatrix : public vpArray2D<double>
+class VISP_EXPORT vpRotationMatrix : private vpArray2DStorageHolder<double, 3, 3>, public vpArray2D<double>
 {
 public:
   vpRotationMatrix();
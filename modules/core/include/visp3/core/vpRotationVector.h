@@ -91,7 +91,7 @@ int main()
 
 */
 
-class VISP_EXPORT vpRotationVector : public vpArray2D<double>
+class VISP_EXPORT vpRotationVector : private vpArray2DStorageHolder<double, 4, 1>, public vpArray2D<double>
 {  
 public:
   //! Constructor that constructs a 0-size rotation vector.
@@ -101,15 +101,17 @@ public:
 
   //! Constructor that constructs a vector of size n and initialize all values to zero.
   vpRotationVector(const unsigned int n)
-    : vpArray2D<double>(n, 1)
+    : vpArray2D<double>(n, 1, m_storage)
   {}
 
   /*!
     Copy operator.
   */
   vpRotationVector(const vpRotationVector &v)
-    : vpArray2D<double>(v)
-  {}
+    : vpArray2D<double>(v.size(), 1, m_storage)
+  {
+    *this = v;
+  }
 
   /*!
     Destructor.
@@ -0,0 +1,142 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Process-wide pool of worker threads.
+ *
+ *****************************************************************************/
+
+#ifndef vpThreadPool_h
+#define vpThreadPool_h
+
+/*!
+  \file vpThreadPool.h
+  \brief Process-wide pool of worker threads and parallel loop over a range.
+*/
+
+#include <visp3/core/vpConfig.h>
+
+/*!
+  \class vpThreadPool
+
+  \ingroup group_core_threading
+
+  \brief Process-wide pool of worker threads used to run loops in parallel.
+
+  The worker threads are created with vpThread the first time they are
+  needed and then wait for work until the end of the process, so that a
+  parallel loop does not pay for the creation of threads at each call.
+
+  parallel_for() splits a range of indices, typically image rows, into one
+  sub-range per participating thread. The calling thread always takes part
+  in the computation. A thread that is done with its own sub-range steals
+  half of the largest remaining sub-range of another thread (work stealing),
+  so that the load stays balanced when the cost of the indices varies.
+
+  The total number of threads, including the calling thread, is limited by
+  setNbThreads(), which by default is the number of cores of the machine.
+  Several loops started at the same time from different threads (e.g.
+  several trackers) share the same workers instead of each starting its own
+  threads. A loop started from a worker thread is supported.
+
+  When the platform has no thread support, the loop is run by the calling
+  thread.
+
+  \code
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpThreadPool.h>
+
+namespace {
+  struct Invert {
+    vpImage<unsigned char> *I;
+    void operator()(unsigned int begin, unsigned int end) const {
+      for (unsigned int i = begin; i < end; i++)
+        for (unsigned int j = 0; j < I->getWidth(); j++)
+          (*I)[i][j] = 255 - (*I)[i][j];
+    }
+  };
+}
+
+int main()
+{
+  vpImage<unsigned char> I(480, 640, 0);
+  Invert invert;
+  invert.I = &I;
+  vpThreadPool::parallel_for(0, I.getHeight(), invert); // Use all the cores
+  vpThreadPool::parallel_for(0, I.getHeight(), invert, 2); // Use two threads
+}
+  \endcode
+
+  \warning An exception thrown by the loop body in a worker thread is
+  forwarded to the calling thread as a vpException once the loop is over.
+*/
+class VISP_EXPORT vpThreadPool
+{
+public:
+  /*!
+    Loop body of parallel_for(): process the indices of [\e begin, \e end)
+    with the user data \e args.
+  */
+  typedef void (*RangeFn)(unsigned int begin, unsigned int end, void *args);
+
+  static unsigned int getHardwareConcurrency();
+  static unsigned int getNbThreads();
+  static void setNbThreads(const unsigned int nbThreads);
+
+  static void parallel_for(const unsigned int begin, const unsigned int end, RangeFn fn, void *args,
+                           const unsigned int nbThreads=0, const unsigned int grainSize=1);
+
+  /*!
+    Run in parallel a functor over the range [\e begin, \e end).
+
+    \param begin, end : Range of indices.
+    \param body : Object with a
+    <tt>void operator()(unsigned int begin, unsigned int end) const</tt>
+    method that processes a sub-range. It is called concurrently from
+    several threads on disjoint sub-ranges.
+    \param nbThreads : Maximum number of threads, including the calling
+    thread. 0 means getNbThreads(), 1 runs the loop in the calling thread.
+    \param grainSize : Minimum number of indices processed at once.
+  */
+  template<class Body>
+  static void parallel_for(const unsigned int begin, const unsigned int end, const Body &body,
+                           const unsigned int nbThreads=0, const unsigned int grainSize=1)
+  {
+    parallel_for(begin, end, &callBody<Body>, (void *) &body, nbThreads, grainSize);
+  }
+
+private:
+  template<class Body>
+  static void callBody(unsigned int begin, unsigned int end, void *args)
+  {
+    (*static_cast<const Body *>(args))(begin, end);
+  }
+};
+
+#endif
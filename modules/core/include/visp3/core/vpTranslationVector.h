@@ -90,7 +90,7 @@ int main()
 }
   \endcode
 */
-class VISP_EXPORT vpTranslationVector : public vpArray2D<double>
+class VISP_EXPORT vpTranslationVector : private vpArray2DStorageHolder<double, 3, 1>, public vpArray2D<double>
 {
 public:
 
@@ -98,7 +98,7 @@ public:
       Default constructor.
       The translation vector is initialized to zero.
     */
-  vpTranslationVector() : vpArray2D<double>(3, 1) {};
+  vpTranslationVector() : vpArray2D<double>(3, 1, m_storage) {};
   vpTranslationVector(const double tx, const double ty, const double tz) ;
   vpTranslationVector(const vpTranslationVector &tv);
   vpTranslationVector(const vpHomogeneousMatrix &M);
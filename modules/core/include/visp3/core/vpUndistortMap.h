@@ -0,0 +1,150 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Precomputed undistortion remap table.
+ *
+ *****************************************************************************/
+
+#ifndef vpUndistortMap_H
+#define vpUndistortMap_H
+
+/*!
+  \file vpUndistortMap.h
+  \brief Precomputed remap table to undistort (or distort) images.
+*/
+
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpRGBa.h>
+
+/*!
+  \class vpUndistortMap
+
+  \ingroup group_core_image
+
+  \brief Remap table that undistorts (or distorts) images acquired by a
+  camera with radial distortion.
+
+  vpImageTools::undistort() evaluates the distortion model and the bilinear
+  weights for each pixel of each image. vpUndistortMap does this work once
+  in init(): for each pixel of the output image it stores the offset of the
+  top-left source pixel and the four bilinear weights in fixed point. remap()
+  then only gathers and blends the source pixels, using SSE2 when available
+  and optionally sharing the rows between several threads of vpThreadPool.
+
+  Two directions are supported:
+  - vpUndistortMap::UNDISTORT builds an undistorted image from an image
+    acquired by the camera, using the \f$k_{ud}\f$ parameter like
+    vpImageTools::undistort();
+  - vpUndistortMap::DISTORT builds the image that the camera would acquire
+    from an undistorted image, using the \f$k_{du}\f$ parameter.
+
+  Output pixels whose source lies outside the input image are set to 0.
+
+  \code
+#include <visp3/core/vpUndistortMap.h>
+
+int main()
+{
+  vpCameraParameters cam;
+  cam.initPersProjWithDistortion(600, 600, 640, 512, -0.2, 0.2);
+
+  vpUndistortMap map(cam, 1280, 1024);
+  map.setNbThreads(2);
+
+  vpImage<unsigned char> I(1024, 1280), Iundist;
+  for (int frame = 0; frame < 100; frame++) {
+    // acquire I
+    map.remap(I, Iundist);
+  }
+}
+  \endcode
+*/
+class VISP_EXPORT vpUndistortMap
+{
+public:
+  /*! \enum vpMapDirectionType
+    Direction of the remap table.
+  */
+  typedef enum {
+    UNDISTORT, /*!< Remove the distortion from an image acquired by the camera (uses \f$k_{ud}\f$). */
+    DISTORT    /*!< Add the camera distortion to an undistorted image (uses \f$k_{du}\f$). */
+  } vpMapDirectionType;
+
+  vpUndistortMap();
+  vpUndistortMap(const vpCameraParameters &cam, unsigned int width, unsigned int height,
+                 const vpMapDirectionType &direction=UNDISTORT);
+
+  /*!
+    Return the direction of the remap table.
+  */
+  inline vpMapDirectionType getDirection() const { return m_direction; }
+  /*!
+    Return the height of the images the table was built for.
+  */
+  inline unsigned int getHeight() const { return m_height; }
+  /*!
+    Return the number of threads used by remap().
+  */
+  inline unsigned int getNbThreads() const { return m_nbThreads; }
+  /*!
+    Return the width of the images the table was built for.
+  */
+  inline unsigned int getWidth() const { return m_width; }
+
+  void init(const vpCameraParameters &cam, unsigned int width, unsigned int height,
+            const vpMapDirectionType &direction=UNDISTORT);
+
+  void remap(const vpImage<unsigned char> &I, vpImage<unsigned char> &Iremap) const;
+  void remap(const vpImage<vpRGBa> &I, vpImage<vpRGBa> &Iremap) const;
+
+  void setNbThreads(unsigned int nbThreads);
+
+private:
+  //! Image width
+  unsigned int m_width;
+  //! Image height
+  unsigned int m_height;
+  //! Direction of the table
+  vpMapDirectionType m_direction;
+  //! True when the camera has no distortion: remap() is a copy
+  bool m_identity;
+  //! Number of threads used by remap()
+  unsigned int m_nbThreads;
+  //! Offset in the source image of the top-left neighbour of each output pixel
+  std::vector<int> m_offset;
+  //! Bilinear weights (top-left, top-right, bottom-left, bottom-right) of each output pixel, in Q14 fixed point
+  std::vector<short> m_weights;
+};
+
+#endif
@@ -102,7 +102,7 @@ int main()
 }
   \endcode
 */
-class VISP_EXPORT vpVelocityTwistMatrix : public vpArray2D<double>
+class VISP_EXPORT vpVelocityTwistMatrix : private vpArray2DStorageHolder<double, 6, 6>, public vpArray2D<double>
 {
   friend class vpMatrix;
 
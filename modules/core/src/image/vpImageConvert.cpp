@@ -45,6 +45,8 @@
 
 #include <sstream>
 #include <map>
+#include <string.h>
+#include <vector>
 
 // image
 #include <visp3/core/vpImageConvert.h>
@@ -63,6 +65,8 @@
 #  endif
 #endif
 
+#include <visp3/core/vpThreadPool.h>
+
 
 bool vpImageConvert::YCbCrLUTcomputed = false;
 int vpImageConvert::vpCrr[256];
@@ -70,6 +74,177 @@ int vpImageConvert::vpCgb[256];
 int vpImageConvert::vpCgr[256];
 int vpImageConvert::vpCbb[256];
 
+#define vpSAT(c) \
+  if (c & (~255)) { if (c < 0) c = 0; else c = 255; }
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  inline unsigned char saturateToUChar(int v)
+  {
+    return (v < 0) ? 0u : ((v > 255) ? 255u : (unsigned char) v);
+  }
+
+#if VISP_HAVE_SSE2
+  // Interleave 16 red, green and blue values with the default alpha value
+  // and store the 16 resulting RGBa pixels
+  inline void storeRGBa(unsigned char *rgba, const __m128i &r, const __m128i &g, const __m128i &b)
+  {
+    const __m128i a = _mm_set1_epi8((char) vpRGBa::alpha_default);
+    const __m128i rg_lo = _mm_unpacklo_epi8(r, g);
+    const __m128i rg_hi = _mm_unpackhi_epi8(r, g);
+    const __m128i ba_lo = _mm_unpacklo_epi8(b, a);
+    const __m128i ba_hi = _mm_unpackhi_epi8(b, a);
+
+    _mm_storeu_si128((__m128i *) rgba,        _mm_unpacklo_epi16(rg_lo, ba_lo));
+    _mm_storeu_si128((__m128i *) (rgba + 16), _mm_unpackhi_epi16(rg_lo, ba_lo));
+    _mm_storeu_si128((__m128i *) (rgba + 32), _mm_unpacklo_epi16(rg_hi, ba_hi));
+    _mm_storeu_si128((__m128i *) (rgba + 48), _mm_unpackhi_epi16(rg_hi, ba_hi));
+  }
+
+  // Duplicate the low 16 bits of each 32-bit lane in the high 16 bits
+  inline __m128i duplicateLow16(const __m128i &x)
+  {
+    return _mm_or_si128(_mm_and_si128(x, _mm_set1_epi32(0xFFFF)), _mm_slli_epi32(x, 16));
+  }
+
+  // Compute the red, green and blue 16-bit values of 8 YUYV pixels with the
+  // integer formulas of YUYVToRGBa()
+  inline void YUYVToRGB16(const unsigned char *yuyv, __m128i &r, __m128i &g, __m128i &b)
+  {
+    const __m128i data = _mm_loadu_si128((const __m128i *) yuyv);
+    const __m128i y = _mm_and_si128(data, _mm_set1_epi16(0x00FF));
+    // u0 v0 u1 v1 ... minus 128
+    const __m128i uv = _mm_sub_epi16(_mm_srli_epi16(data, 8), _mm_set1_epi16(128));
+
+    // Sign extended u and v of each macro pixel, duplicated for its two pixels
+    const __m128i u = duplicateLow16(_mm_srai_epi32(_mm_slli_epi32(uv, 16), 16));
+    const __m128i v = duplicateLow16(_mm_srai_epi32(uv, 16));
+
+    // (u*454)>>8 = u + (u*198)>>8 and (v*359)>>8 = v + (v*103)>>8 without 16-bit overflow
+    const __m128i cb = _mm_add_epi16(u, _mm_srai_epi16(_mm_mullo_epi16(u, _mm_set1_epi16(198)), 8));
+    const __m128i cr = _mm_add_epi16(v, _mm_srai_epi16(_mm_mullo_epi16(v, _mm_set1_epi16(103)), 8));
+    // (u*88 + v*183)>>8 computed on 32 bits
+    const __m128i cg = duplicateLow16(_mm_srai_epi32(_mm_madd_epi16(uv, _mm_set1_epi32((183 << 16) | 88)), 8));
+
+    r = _mm_add_epi16(y, cr);
+    g = _mm_sub_epi16(y, cg);
+    b = _mm_add_epi16(y, cb);
+  }
+
+  // Compute trunc(x*k) for 8 signed 16-bit values in [-128, 127] where
+  // k_q16 = ceil(k*65536) is exact for this range
+  inline __m128i mulTrunc(const __m128i &x, const __m128i &k_q16)
+  {
+    const __m128i sign = _mm_srai_epi16(x, 15);
+    const __m128i abs_x = _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+    return _mm_sub_epi16(_mm_xor_si128(_mm_mulhi_epu16(abs_x, k_q16), sign), sign);
+  }
+#endif
+
+  // Convert the rows [0, height[ of a YUYV image; each row contains
+  // width/2 macro pixels
+  void YUYVToRGBaRows(const unsigned char *s, unsigned char *d, unsigned int width, unsigned int height)
+  {
+    const unsigned int nbMacroPixels = width >> 1;
+    int r, g, b, cr, cg, cb, y1, y2;
+
+    for (unsigned int h = 0; h < height; h++) {
+      unsigned int c = 0;
+#if VISP_HAVE_SSE2
+      for (; c + 8 <= nbMacroPixels; c += 8) {
+        __m128i r0, g0, b0, r1, g1, b1;
+        YUYVToRGB16(s, r0, g0, b0);
+        YUYVToRGB16(s + 16, r1, g1, b1);
+        storeRGBa(d, _mm_packus_epi16(r0, r1), _mm_packus_epi16(g0, g1), _mm_packus_epi16(b0, b1));
+        s += 32;
+        d += 64;
+      }
+#endif
+      for (; c < nbMacroPixels; c++) {
+        y1 = *s++;
+        cb = ((*s - 128) * 454) >> 8;
+        cg = (*s++ - 128) * 88;
+        y2 = *s++;
+        cr = ((*s - 128) * 359) >> 8;
+        cg = (cg + (*s++ - 128) * 183) >> 8;
+
+        r = y1 + cr;
+        b = y1 + cb;
+        g = y1 - cg;
+        vpSAT(r);
+        vpSAT(g);
+        vpSAT(b);
+
+        *d++ = static_cast<unsigned char>(r);
+        *d++ = static_cast<unsigned char>(g);
+        *d++ = static_cast<unsigned char>(b);
+        *d++ = vpRGBa::alpha_default;
+
+        r = y2 + cr;
+        b = y2 + cb;
+        g = y2 - cg;
+        vpSAT(r);
+        vpSAT(g);
+        vpSAT(b);
+
+        *d++ = static_cast<unsigned char>(r);
+        *d++ = static_cast<unsigned char>(g);
+        *d++ = static_cast<unsigned char>(b);
+        *d++ = vpRGBa::alpha_default;
+      }
+    }
+  }
+
+  void RGBaToGreyRows(const unsigned char *rgba, unsigned char *grey, unsigned int width, unsigned int height)
+  {
+    vpImageConvert::RGBaToGrey(const_cast<unsigned char *>(rgba), grey, width*height);
+  }
+
+  typedef void (*vpConvertRowsFunction)(const unsigned char *src, unsigned char *dst,
+                                        unsigned int width, unsigned int height);
+
+  struct vpConvertRows_Param_t {
+    vpConvertRowsFunction m_function;
+    const unsigned char *m_src;
+    unsigned int m_src_row_size;
+    unsigned char *m_dst;
+    unsigned int m_dst_row_size;
+    unsigned int m_width;
+
+    vpConvertRows_Param_t() : m_function(NULL), m_src(NULL), m_src_row_size(0), m_dst(NULL), m_dst_row_size(0),
+      m_width(0) {
+    }
+  };
+
+  // Convert the rows [begin, end)
+  void convertRowRange(unsigned int begin, unsigned int end, void *args) {
+    const vpConvertRows_Param_t *param = static_cast<const vpConvertRows_Param_t *>(args);
+    param->m_function(param->m_src + (size_t) begin * param->m_src_row_size,
+                      param->m_dst + (size_t) begin * param->m_dst_row_size, param->m_width, end - begin);
+  }
+
+  /*
+    Convert the image, the rows being shared between the threads of
+    vpThreadPool. src_row_size and dst_row_size are the number of bytes of a
+    row.
+  */
+  void convertRows(vpConvertRowsFunction function, const unsigned char *src, unsigned int src_row_size,
+                   unsigned char *dst, unsigned int dst_row_size, unsigned int width, unsigned int height,
+                   unsigned int nbThreads)
+  {
+    vpConvertRows_Param_t param;
+    param.m_function = function;
+    param.m_src = src;
+    param.m_src_row_size = src_row_size;
+    param.m_dst = dst;
+    param.m_dst_row_size = dst_row_size;
+    param.m_width = width;
+
+    vpThreadPool::parallel_for(0, height, convertRowRange, &param, (nbThreads < 1) ? 1 : nbThreads, 8);
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 
 /*!
   Convert a vpImage\<unsigned char\> to a vpImage\<vpRGBa\>.
@@ -86,16 +261,22 @@ vpImageConvert::convert(const vpImage<unsigned char> &src, vpImage<vpRGBa> & des
 }
 
 /*!
-  Convert a vpImage\<unsigned char\> to a vpImage\<vpRGBa\>
+  Convert a vpImage\<vpRGBa\> to a vpImage\<unsigned char\>
   \param src : source image
   \param dest : destination image
+  \param nThreads : Number of threads used to convert the rows of the image.
+  The threads are taken from vpThreadPool and limited by
+  vpThreadPool::getNbThreads().
+
+  \sa RGBaToGrey()
 */
 void
-vpImageConvert::convert(const vpImage<vpRGBa> &src, vpImage<unsigned char> & dest)
+vpImageConvert::convert(const vpImage<vpRGBa> &src, vpImage<unsigned char> & dest, const unsigned int nThreads)
 {
   dest.resize(src.getHeight(), src.getWidth()) ;
 
-  RGBaToGrey((unsigned char *)src.bitmap, dest.bitmap, src.getHeight() * src.getWidth());
+  convertRows(RGBaToGreyRows, (const unsigned char *)src.bitmap, 4*src.getWidth(), dest.bitmap, src.getWidth(),
+              src.getWidth(), src.getHeight(), nThreads);
 }
 
 
@@ -1210,63 +1391,29 @@ void vpImageConvert::convert(const yarp::sig::ImageOf< yarp::sig::PixelRgb > *sr
 
 #endif
 
-#define vpSAT(c) \
-  if (c & (~255)) { if (c < 0) c = 0; else c = 255; }
 /*!
   Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...) to RGB32.
   Destination rgba memory area has to be allocated before.
 
   The alpha component of the converted image is set to vpRGBa::alpha_default.
 
+  The conversion uses SSE2 when available and gives the same result as the
+  scalar integer implementation.
+
+  \param yuyv : Image to convert.
+  \param rgba : Converted image.
+  \param width, height : Image size.
+  \param nThreads : Number of threads used to convert the rows of the image.
+  The threads are taken from vpThreadPool and limited by
+  vpThreadPool::getNbThreads().
+
   \sa YUV422ToRGBa()
 */
 void vpImageConvert::YUYVToRGBa(unsigned char* yuyv, unsigned char* rgba,
-                                unsigned int width, unsigned int height)
+                                unsigned int width, unsigned int height, const unsigned int nThreads)
 {
-  unsigned char *s;
-  unsigned char *d;
-  int w, h;
-  int r, g, b, cr, cg, cb, y1, y2;
-
-  h = (int)height;
-  w = (int)width;
-  s = yuyv;
-  d = rgba;
-  while (h--) {
-    int c = w >> 1;
-    while (c--) {
-      y1 = *s++;
-      cb = ((*s - 128) * 454) >> 8;
-      cg = (*s++ - 128) * 88;
-      y2 = *s++;
-      cr = ((*s - 128) * 359) >> 8;
-      cg = (cg + (*s++ - 128) * 183) >> 8;
-
-      r = y1 + cr;
-      b = y1 + cb;
-      g = y1 - cg;
-      vpSAT(r);
-      vpSAT(g);
-      vpSAT(b);
-
-      *d++ = static_cast<unsigned char>(r);
-      *d++ = static_cast<unsigned char>(g);
-      *d++ = static_cast<unsigned char>(b);
-      *d++ = vpRGBa::alpha_default;
-
-      r = y2 + cr;
-      b = y2 + cb;
-      g = y2 - cg;
-      vpSAT(r);
-      vpSAT(g);
-      vpSAT(b);
-
-      *d++ = static_cast<unsigned char>(r);
-      *d++ = static_cast<unsigned char>(g);
-      *d++ = static_cast<unsigned char>(b);
-      *d++ = vpRGBa::alpha_default;
-    }
-  }
+  const unsigned int nbMacroPixels = width >> 1;
+  convertRows(YUYVToRGBaRows, yuyv, 4*nbMacroPixels, rgba, 8*nbMacroPixels, width, height, nThreads);
 }
 
 /*!
@@ -1333,6 +1480,16 @@ void vpImageConvert::YUYVToGrey(unsigned char* yuyv, unsigned char* grey, unsign
 {
   unsigned int i=0,j=0;
 
+#if VISP_HAVE_SSE2
+  // Keep the even bytes of 16 pixels
+  const __m128i mask = _mm_set1_epi16(0x00FF);
+  for ( ; i+16 <= size; i += 16, j += 32) {
+    const __m128i data1 = _mm_loadu_si128((const __m128i *) (yuyv+j));
+    const __m128i data2 = _mm_loadu_si128((const __m128i *) (yuyv+j+16));
+    _mm_storeu_si128((__m128i *) (grey+i), _mm_packus_epi16(_mm_and_si128(data1, mask), _mm_and_si128(data2, mask)));
+  }
+#endif
+
   while( j < size*2)
   {
     grey[i++] = yuyv[j];
@@ -1657,6 +1814,15 @@ void vpImageConvert::YUV422ToGrey(unsigned char* yuv, unsigned char* grey, unsig
 {
   unsigned int i=0,j=0;
 
+#if VISP_HAVE_SSE2
+  // Keep the odd bytes of 16 pixels
+  for ( ; i+16 <= size; i += 16, j += 32) {
+    const __m128i data1 = _mm_loadu_si128((const __m128i *) (yuv+j));
+    const __m128i data2 = _mm_loadu_si128((const __m128i *) (yuv+j+16));
+    _mm_storeu_si128((__m128i *) (grey+i), _mm_packus_epi16(_mm_srli_epi16(data1, 8), _mm_srli_epi16(data2, 8)));
+  }
+#endif
+
   while( j < size*2)
   {
     grey[i++] = yuv[j+1];
@@ -1802,6 +1968,74 @@ void vpImageConvert::YUV420ToRGBa(unsigned char* yuv, unsigned char* rgba,
   unsigned int size = width*height;
   unsigned char* iU = yuv + size;
   unsigned char* iV = yuv + 5*size/4;
+
+#if VISP_HAVE_SSE2
+  if (width % 2 == 0) {
+    // U and V are computed exactly with the fixed point values of 0.354 and
+    // 0.707, and 8 chroma samples are applied to 16x2 pixels at once
+    const __m128i k_u = _mm_set1_epi16(23200); // ceil(0.354*65536)
+    const __m128i k_v = _mm_set1_epi16((short) 46334); // ceil(0.707*65536)
+    const __m128i c128 = _mm_set1_epi16(128);
+    const __m128i zero = _mm_setzero_si128();
+    const unsigned int w2 = width/2;
+
+    for (unsigned int i = 0; i < height/2; i++) {
+      const unsigned char *y_row[2] = { yuv + 2*i*width, yuv + (2*i+1)*width };
+      unsigned char *d_row[2] = { rgba + 8*i*width, rgba + (8*i+4)*width };
+
+      unsigned int j = 0;
+      for ( ; j+8 <= w2; j += 8) {
+        const __m128i u = mulTrunc(_mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) iU), zero), c128), k_u);
+        const __m128i v = mulTrunc(_mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) iV), zero), c128), k_v);
+        iU += 8;
+        iV += 8;
+
+        const __m128i u5 = _mm_add_epi16(u, _mm_slli_epi16(u, 2));
+        const __m128i v2 = _mm_add_epi16(v, v);
+        const __m128i uv = _mm_sub_epi16(zero, _mm_add_epi16(u, v));
+        const __m128i u5_lo = _mm_unpacklo_epi16(u5, u5), u5_hi = _mm_unpackhi_epi16(u5, u5);
+        const __m128i v2_lo = _mm_unpacklo_epi16(v2, v2), v2_hi = _mm_unpackhi_epi16(v2, v2);
+        const __m128i uv_lo = _mm_unpacklo_epi16(uv, uv), uv_hi = _mm_unpackhi_epi16(uv, uv);
+
+        for (unsigned int k = 0; k < 2; k++) {
+          const __m128i y = _mm_loadu_si128((const __m128i *) (y_row[k] + 2*j));
+          const __m128i y_lo = _mm_unpacklo_epi8(y, zero), y_hi = _mm_unpackhi_epi8(y, zero);
+          storeRGBa(d_row[k] + 8*j,
+                    _mm_packus_epi16(_mm_add_epi16(y_lo, v2_lo), _mm_add_epi16(y_hi, v2_hi)),
+                    _mm_packus_epi16(_mm_add_epi16(y_lo, uv_lo), _mm_add_epi16(y_hi, uv_hi)),
+                    _mm_packus_epi16(_mm_add_epi16(y_lo, u5_lo), _mm_add_epi16(y_hi, u5_hi)));
+        }
+      }
+
+      for ( ; j < w2; j++) {
+        U   = (int)((*iU++ - 128) * 0.354);
+        U5  = 5*U;
+        V   = (int)((*iV++ - 128) * 0.707);
+        V2  = 2*V;
+        UV  = - U - V;
+        for (unsigned int k = 0; k < 2; k++) {
+          for (unsigned int l = 0; l < 2; l++) {
+            Y0 = y_row[k][2*j+l];
+            R = Y0 + V2;
+            if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+            G = Y0 + UV;
+            if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+            B = Y0 + U5;
+            if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+
+            unsigned char *d = d_row[k] + 4*(2*j+l);
+            d[0] = (unsigned char)R;
+            d[1] = (unsigned char)G;
+            d[2] = (unsigned char)B;
+            d[3] = vpRGBa::alpha_default;
+          }
+        }
+      }
+    }
+    return;
+  }
+#endif
+
   for(unsigned int i = 0; i<height/2; i++)
   {
     for(unsigned int j = 0; j < width/2 ; j++)
@@ -1991,10 +2225,8 @@ void vpImageConvert::YUV420ToRGB(unsigned char* yuv,
 */
 void vpImageConvert::YUV420ToGrey(unsigned char* yuv, unsigned char* grey, unsigned int size)
 {
-  for(unsigned int i=0 ; i < size ; i++)
-  {
-    *grey++ = *yuv++;
-  }
+  // The Y plane is the grey image
+  memcpy(grey, yuv, size*sizeof(unsigned char));
 }
 /*!
 
@@ -3122,6 +3354,55 @@ void vpImageConvert::RGBaToGrey(unsigned char* rgba, unsigned char* grey, unsign
     }
   }
 
+  for(; i < size; i++) {
+    *grey = (unsigned char) (0.2126 * (*rgba)
+                             + 0.7152 * (*(rgba + 1))
+                             + 0.0722 * (*(rgba + 2)) );
+
+    rgba += 4;
+    ++grey;
+  }
+#elif VISP_HAVE_SSE2
+  // Same fixed point computation as the SSSE3 implementation, the R, G and B
+  // components being extracted with shifts and masks
+  unsigned int i = 0;
+
+  if(size >= 16) {
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    const __m128i coeff_R = _mm_set1_epi16(13933);
+    const __m128i coeff_G = _mm_set1_epi16((short int) 46871);
+    const __m128i coeff_B = _mm_set1_epi16(4732);
+
+    for(; i <= size - 16; i+=16) {
+      __m128i grays[2];
+      for (unsigned int k = 0; k < 2; k++) {
+        // Process 2*4 color pixels
+        const __m128i data1 = _mm_loadu_si128((const __m128i*) rgba);
+        const __m128i data2 = _mm_loadu_si128((const __m128i*) (rgba + 16));
+
+        const __m128i red = _mm_slli_epi16(_mm_packs_epi32(_mm_and_si128(data1, mask),
+                                                           _mm_and_si128(data2, mask)), 8);
+        const __m128i green = _mm_slli_epi16(_mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(data1, 8), mask),
+                                                             _mm_and_si128(_mm_srli_epi32(data2, 8), mask)), 8);
+        const __m128i blue = _mm_slli_epi16(_mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(data1, 16), mask),
+                                                            _mm_and_si128(_mm_srli_epi32(data2, 16), mask)), 8);
+
+        grays[k] = _mm_srli_epi16(
+              _mm_adds_epu16(
+                _mm_mulhi_epu16(red, coeff_R),
+                _mm_adds_epu16(
+                  _mm_mulhi_epu16(green, coeff_G),
+                  _mm_mulhi_epu16(blue,  coeff_B)
+                  )), 8);
+
+        rgba += 32;
+      }
+
+      _mm_storeu_si128( (__m128i*) grey, _mm_packus_epi16(grays[0], grays[1]) );
+      grey += 16;
+    }
+  }
+
   for(; i < size; i++) {
     *grey = (unsigned char) (0.2126 * (*rgba)
                              + 0.7152 * (*(rgba + 1))
@@ -3719,38 +4000,21 @@ void vpImageConvert::computeYCbCrLUT()
 */
 void vpImageConvert::YCbCrToRGB(unsigned char *ycbcr, unsigned char *rgb, unsigned int size)
 {
-  unsigned char *cbv;
-  unsigned char *crv;
-  unsigned char *pt_ycbcr = ycbcr;
-  unsigned char *pt_rgb = rgb;
-  cbv = pt_ycbcr + 1;
-  crv = pt_ycbcr + 3;
-
   vpImageConvert::computeYCbCrLUT();
 
-  int col = 0;
-
-  while (size--) {
-    int val_r, val_g, val_b;
-    if (!(col++ % 2)) {
-      cbv = pt_ycbcr + 1;
-      crv = pt_ycbcr + 3;
+  // The chroma contributions are shared by the two pixels of a macro pixel
+  for (unsigned int i = 0; i < size; i += 2) {
+    const int c_r = vpImageConvert::vpCrr[ycbcr[3]];
+    const int c_g = vpImageConvert::vpCgb[ycbcr[1]] + vpImageConvert::vpCgr[ycbcr[3]];
+    const int c_b = vpImageConvert::vpCbb[ycbcr[1]];
+
+    for (unsigned int k = 0; k < 2 && i+k < size; k++) {
+      const int y = ycbcr[2*k];
+      *rgb++ = saturateToUChar(y + c_r); // Red component.
+      *rgb++ = saturateToUChar(y + c_g); // Green component.
+      *rgb++ = saturateToUChar(y + c_b); // Blue component.
     }
-
-    val_r = *pt_ycbcr + vpImageConvert::vpCrr[*crv];
-    val_g = *pt_ycbcr + vpImageConvert::vpCgb[*cbv] + vpImageConvert::vpCgr[*crv];
-    val_b = *pt_ycbcr + vpImageConvert::vpCbb[*cbv];
-
-    vpDEBUG_TRACE(5, "[%d] R: %d G: %d B: %d\n", size, val_r, val_g, val_b);
-
-    *pt_rgb++ = (val_r < 0) ? 0u :
-                              ((val_r > 255) ? 255u : (unsigned char)val_r); // Red component.
-    *pt_rgb++ = (val_g < 0) ? 0u :
-                              ((val_g > 255) ? 255u : (unsigned char)val_g); // Green component.
-    *pt_rgb++ = (val_b < 0) ? 0u :
-                              ((val_b > 255) ? 255u : (unsigned char)val_b); // Blue component.
-
-    pt_ycbcr += 2;
+    ycbcr += 4;
   }
 }
 
@@ -3779,39 +4043,22 @@ void vpImageConvert::YCbCrToRGB(unsigned char *ycbcr, unsigned char *rgb, unsign
 */
 void vpImageConvert::YCbCrToRGBa(unsigned char *ycbcr, unsigned char *rgba, unsigned int size)
 {
-  unsigned char *cbv;
-  unsigned char *crv;
-  unsigned char *pt_ycbcr = ycbcr;
-  unsigned char *pt_rgba = rgba;
-  cbv = pt_ycbcr + 1;
-  crv = pt_ycbcr + 3;
-
   vpImageConvert::computeYCbCrLUT();
 
-  int col = 0;
-
-  while (size--) {
-    int val_r, val_g, val_b;
-    if (!(col++ % 2)) {
-      cbv = pt_ycbcr + 1;
-      crv = pt_ycbcr + 3;
+  // The chroma contributions are shared by the two pixels of a macro pixel
+  for (unsigned int i = 0; i < size; i += 2) {
+    const int c_r = vpImageConvert::vpCrr[ycbcr[3]];
+    const int c_g = vpImageConvert::vpCgb[ycbcr[1]] + vpImageConvert::vpCgr[ycbcr[3]];
+    const int c_b = vpImageConvert::vpCbb[ycbcr[1]];
+
+    for (unsigned int k = 0; k < 2 && i+k < size; k++) {
+      const int y = ycbcr[2*k];
+      *rgba++ = saturateToUChar(y + c_r); // Red component.
+      *rgba++ = saturateToUChar(y + c_g); // Green component.
+      *rgba++ = saturateToUChar(y + c_b); // Blue component.
+      *rgba++ = vpRGBa::alpha_default;
     }
-
-    val_r = *pt_ycbcr + vpImageConvert::vpCrr[*crv];
-    val_g = *pt_ycbcr + vpImageConvert::vpCgb[*cbv] + vpImageConvert::vpCgr[*crv];
-    val_b = *pt_ycbcr + vpImageConvert::vpCbb[*cbv];
-
-    vpDEBUG_TRACE(5, "[%d] R: %d G: %d B: %d\n", size, val_r, val_g, val_b);
-
-    *pt_rgba++ = (val_r < 0) ? 0u :
-                               ((val_r > 255) ? 255u : (unsigned char)val_r); // Red component.
-    *pt_rgba++ = (val_g < 0) ? 0u :
-                               ((val_g > 255) ? 255u : (unsigned char)val_g); // Green component.
-    *pt_rgba++ = (val_b < 0) ? 0u :
-                               ((val_b > 255) ? 255u : (unsigned char)val_b); // Blue component.
-    *pt_rgba++ = vpRGBa::alpha_default;
-
-    pt_ycbcr += 2;
+    ycbcr += 4;
   }
 }
 
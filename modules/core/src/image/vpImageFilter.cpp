@@ -45,6 +45,278 @@
 #  include <cv.h>
 #endif
 
+#include <string.h>
+#include <vector>
+
+#include <visp3/core/vpThreadPool.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  /*
+    Index of the pixel read by the filters for the position x of a row (or
+    column) of n pixels. It reproduces the mirroring of
+    vpImageFilter::filterXLeftBorder() and vpImageFilter::filterXRightBorder()
+    and stays inside the image even when the kernel is larger than it.
+  */
+  int mirrorIndex(int x, int n)
+  {
+    while (x < 0 || x >= n) {
+      if (x < 0)
+        x = -x;
+      else
+        x = 2*n - x - 1;
+    }
+    return x;
+  }
+
+  /*
+    Apply a symmetric (filter[0] + filter[i] * (a_i + b_i)) or antisymmetric
+    (filter[i] * (a_i - b_i)) kernel of half size half to n consecutive
+    pixels. taps[half + i] and taps[half - i] point to the n pixels at
+    distance +i and -i of the destination pixels. The operations are done in
+    the same order as in the per-pixel helpers of vpImageFilter so that the
+    double results are identical.
+  */
+  template<bool derivative, typename S, typename T>
+  void filterScalar(const S * const *taps, T *dst, unsigned int begin, unsigned int n,
+                    const T *filter, unsigned int half)
+  {
+    for (unsigned int j = begin; j < n; j++) {
+      T result = 0;
+      if (derivative) {
+        for (unsigned int i = 1; i <= half; i++)
+          result += filter[i] * ((T)taps[half+i][j] - (T)taps[half-i][j]);
+      }
+      else {
+        for (unsigned int i = 1; i <= half; i++)
+          result += filter[i] * ((T)taps[half+i][j] + (T)taps[half-i][j]);
+        result += filter[0] * (T)taps[half][j];
+      }
+      dst[j] = result;
+    }
+  }
+
+#if VISP_HAVE_SSE2
+  // Load 4 consecutive pixels
+  inline void load4(const double *p, __m128d &lo, __m128d &hi)
+  {
+    lo = _mm_loadu_pd(p);
+    hi = _mm_loadu_pd(p + 2);
+  }
+
+  inline __m128i load4Epi32(const unsigned char *p)
+  {
+    int v;
+    memcpy(&v, p, sizeof(int));
+    const __m128i zero = _mm_setzero_si128();
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(v), zero), zero);
+  }
+
+  inline void load4(const unsigned char *p, __m128d &lo, __m128d &hi)
+  {
+    __m128i v = load4Epi32(p);
+    lo = _mm_cvtepi32_pd(v);
+    hi = _mm_cvtepi32_pd(_mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  }
+
+  inline __m128 load4(const float *p) { return _mm_loadu_ps(p); }
+  inline __m128 load4(const unsigned char *p) { return _mm_cvtepi32_ps(load4Epi32(p)); }
+
+  template<bool derivative, typename S>
+  void filterSimd(const S * const *taps, double *dst, unsigned int n, const double *filter, unsigned int half)
+  {
+    unsigned int j = 0;
+    for (; j + 4 <= n; j += 4) {
+      __m128d result_lo = _mm_setzero_pd(), result_hi = _mm_setzero_pd();
+      __m128d a_lo, a_hi, b_lo, b_hi;
+      for (unsigned int i = 1; i <= half; i++) {
+        load4(taps[half+i] + j, a_lo, a_hi);
+        load4(taps[half-i] + j, b_lo, b_hi);
+        const __m128d f = _mm_set1_pd(filter[i]);
+        if (derivative) {
+          result_lo = _mm_add_pd(result_lo, _mm_mul_pd(f, _mm_sub_pd(a_lo, b_lo)));
+          result_hi = _mm_add_pd(result_hi, _mm_mul_pd(f, _mm_sub_pd(a_hi, b_hi)));
+        }
+        else {
+          result_lo = _mm_add_pd(result_lo, _mm_mul_pd(f, _mm_add_pd(a_lo, b_lo)));
+          result_hi = _mm_add_pd(result_hi, _mm_mul_pd(f, _mm_add_pd(a_hi, b_hi)));
+        }
+      }
+      if (!derivative) {
+        const __m128d f = _mm_set1_pd(filter[0]);
+        load4(taps[half] + j, a_lo, a_hi);
+        result_lo = _mm_add_pd(result_lo, _mm_mul_pd(f, a_lo));
+        result_hi = _mm_add_pd(result_hi, _mm_mul_pd(f, a_hi));
+      }
+      _mm_storeu_pd(dst + j, result_lo);
+      _mm_storeu_pd(dst + j + 2, result_hi);
+    }
+    filterScalar<derivative>(taps, dst, j, n, filter, half);
+  }
+
+  template<bool derivative, typename S>
+  void filterSimd(const S * const *taps, float *dst, unsigned int n, const float *filter, unsigned int half)
+  {
+    unsigned int j = 0;
+    for (; j + 4 <= n; j += 4) {
+      __m128 result = _mm_setzero_ps();
+      for (unsigned int i = 1; i <= half; i++) {
+        __m128 a = load4(taps[half+i] + j);
+        __m128 b = load4(taps[half-i] + j);
+        __m128 s = derivative ? _mm_sub_ps(a, b) : _mm_add_ps(a, b);
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(filter[i]), s));
+      }
+      if (!derivative)
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(filter[0]), load4(taps[half] + j)));
+      _mm_storeu_ps(dst + j, result);
+    }
+    filterScalar<derivative>(taps, dst, j, n, filter, half);
+  }
+#else
+  template<bool derivative, typename S, typename T>
+  void filterSimd(const S * const *taps, T *dst, unsigned int n, const T *filter, unsigned int half)
+  {
+    filterScalar<derivative>(taps, dst, 0, n, filter, half);
+  }
+#endif
+
+  /*
+    One pass of a separable filter, along the rows (horizontal) or along the
+    columns (vertical) of the image.
+    - Smoothing passes handle the borders by mirroring: a horizontal pass
+      copies each row in a buffer padded with the mirrored pixels, a vertical
+      pass points to the mirrored rows.
+    - Derivative passes set the border pixels, not fully covered by the
+      kernel, to zero.
+  */
+  template<typename S, typename T>
+  struct vpFilterPass_t {
+    const vpImage<S> *m_I;
+    vpImage<T> *m_If;
+    const T *m_filter;
+    unsigned int m_half;
+    bool m_vertical;
+    bool m_derivative;
+  };
+
+  template<typename S, typename T>
+  void filterRows(unsigned int rowBegin, unsigned int rowEnd, void *data)
+  {
+    const vpFilterPass_t<S, T> &pass = *static_cast<const vpFilterPass_t<S, T> *>(data);
+    const vpImage<S> &I = *pass.m_I;
+    vpImage<T> &If = *pass.m_If;
+    const unsigned int half = pass.m_half;
+    const int width = (int)I.getWidth();
+    const int height = (int)I.getHeight();
+
+    std::vector<const S *> taps(2*half + 1);
+
+    if (pass.m_derivative) {
+      const int border = (int)half;
+      const bool empty = pass.m_vertical ? (height <= 2*border) : (width <= 2*border);
+      for (unsigned int r = rowBegin; r < rowEnd; r++) {
+        T *dst = If[r];
+        if (empty || (pass.m_vertical && ((int)r < border || (int)r >= height - border))) {
+          for (int j = 0; j < width; j++)
+            dst[j] = 0;
+          continue;
+        }
+
+        if (pass.m_vertical) {
+          for (unsigned int k = 0; k <= 2*half; k++)
+            taps[k] = I[r - half + k];
+          filterSimd<true>(&taps[0], dst, (unsigned int)width, pass.m_filter, half);
+        }
+        else {
+          for (unsigned int k = 0; k <= 2*half; k++)
+            taps[k] = I[r] + k;
+          for (int j = 0; j < border; j++) {
+            dst[j] = 0;
+            dst[width - 1 - j] = 0;
+          }
+          filterSimd<true>(&taps[0], dst + border, (unsigned int)(width - 2*border), pass.m_filter, half);
+        }
+      }
+    }
+    else if (pass.m_vertical) {
+      for (unsigned int r = rowBegin; r < rowEnd; r++) {
+        for (unsigned int k = 0; k <= 2*half; k++)
+          taps[k] = I[mirrorIndex((int)r + (int)k - (int)half, height)];
+        filterSimd<false>(&taps[0], If[r], (unsigned int)width, pass.m_filter, half);
+      }
+    }
+    else {
+      // Rows are converted to the output precision once, with the mirrored
+      // pixels on each side
+      std::vector<T> padded(width + 2*half);
+      std::vector<const T *> paddedTaps(2*half + 1);
+      for (unsigned int k = 0; k <= 2*half; k++)
+        paddedTaps[k] = &padded[0] + k;
+
+      for (unsigned int r = rowBegin; r < rowEnd; r++) {
+        const S *src = I[r];
+        for (int j = 0; j < (int)half; j++) {
+          padded[j] = (T)src[mirrorIndex(j - (int)half, width)];
+          padded[half + width + j] = (T)src[mirrorIndex(width + j, width)];
+        }
+        for (int j = 0; j < width; j++)
+          padded[half + j] = (T)src[j];
+        filterSimd<false>(&paddedTaps[0], If[r], (unsigned int)width, pass.m_filter, half);
+      }
+    }
+  }
+
+  /*
+    Run a pass on all the rows of the output image, the rows being shared
+    between the threads of vpThreadPool.
+  */
+  template<typename S, typename T>
+  void runPass(const vpFilterPass_t<S, T> &pass, unsigned int nbThreads)
+  {
+    const unsigned int height = pass.m_I->getHeight();
+    pass.m_If->resize(height, pass.m_I->getWidth());
+    if (height == 0 || pass.m_I->getWidth() == 0)
+      return;
+
+    vpThreadPool::parallel_for(0, height, filterRows<S, T>, (void *) &pass, (nbThreads < 1) ? 1 : nbThreads, 8);
+  }
+
+  /*
+    Kernel coefficients in the precision of the output image.
+  */
+  template<typename T>
+  class vpFilterKernel
+  {
+  public:
+    vpFilterKernel(const double *filter, unsigned int size) : m_coefs(filter, filter + (size+1)/2) {}
+    const T *data() const { return &m_coefs[0]; }
+
+  private:
+    std::vector<T> m_coefs;
+  };
+
+  template<typename S, typename T>
+  void filterPass(const vpImage<S> &I, vpImage<T> &If, const double *filter, unsigned int size,
+                  bool vertical, bool derivative, unsigned int nbThreads)
+  {
+    vpFilterKernel<T> kernel(filter, size);
+    vpFilterPass_t<S, T> pass;
+    pass.m_I = &I;
+    pass.m_If = &If;
+    pass.m_filter = kernel.data();
+    pass.m_half = (size-1)/2;
+    pass.m_vertical = vertical;
+    pass.m_derivative = derivative;
+    runPass(pass, nbThreads);
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 
 /*!
   Apply a filter to an image.
@@ -329,117 +601,136 @@ vpImageFilter:: canny(const vpImage<unsigned char>& Isrc,
 
 /*!
   Apply a separable filter.
+  \param I : Image to filter.
+  \param GI : Filtered image.
+  \param filter : Symmetric kernel of (size+1)/2 coefficients, as returned by vpImageFilter::getGaussianKernel().
+  \param size : Filter size. This value should be odd.
+  \param nThreads : Number of threads of vpThreadPool sharing the rows of the image.
  */
-void vpImageFilter::filter(const vpImage<unsigned char> &I, vpImage<double>& GI, const double *filter,unsigned  int size)
+void vpImageFilter::filter(const vpImage<unsigned char> &I, vpImage<double>& GI, const double *filter,unsigned  int size,
+                           const unsigned int nThreads)
 {
   vpImage<double> GIx ;
-  filterX(I, GIx,filter,size);
-  filterY(GIx, GI,filter,size);
-  GIx.destroy();
+  filterX(I, GIx,filter,size,nThreads);
+  filterY(GIx, GI,filter,size,nThreads);
 }
 
 /*!
   Apply a separable filter.
+  \param I : Image to filter.
+  \param GI : Filtered image.
+  \param filter : Symmetric kernel of (size+1)/2 coefficients, as returned by vpImageFilter::getGaussianKernel().
+  \param size : Filter size. This value should be odd.
+  \param nThreads : Number of threads of vpThreadPool sharing the rows of the image.
  */
-void vpImageFilter::filter(const vpImage<double> &I, vpImage<double>& GI, const double *filter,unsigned  int size)
+void vpImageFilter::filter(const vpImage<double> &I, vpImage<double>& GI, const double *filter,unsigned  int size,
+                           const unsigned int nThreads)
 {
   vpImage<double> GIx ;
-  filterX(I, GIx,filter,size);
-  filterY(GIx, GI,filter,size);
-  GIx.destroy();
+  filterX(I, GIx,filter,size,nThreads);
+  filterY(GIx, GI,filter,size,nThreads);
 }
 
-void vpImageFilter::filterX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size)
+/*!
+  Apply a separable filter, computed in single precision.
+  \param I : Image to filter.
+  \param GI : Filtered image.
+  \param filter : Symmetric kernel of (size+1)/2 coefficients, as returned by vpImageFilter::getGaussianKernel().
+  \param size : Filter size. This value should be odd.
+  \param nThreads : Number of threads of vpThreadPool sharing the rows of the image.
+ */
+void vpImageFilter::filter(const vpImage<unsigned char> &I, vpImage<float>& GI, const double *filter,unsigned  int size,
+                           const unsigned int nThreads)
 {
-  dIx.resize(I.getHeight(),I.getWidth()) ;
-  for (unsigned int i=0 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < (size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterXLeftBorder(I,i,j,filter,size);
-      //dIx[i][j]=0;
-    }
-    for (unsigned int j=(size-1)/2 ; j < I.getWidth()-(size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterX(I,i,j,filter,size);
-    }
-    for (unsigned int j=I.getWidth()-(size-1)/2 ; j < I.getWidth() ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterXRightBorder(I,i,j,filter,size);
-      //dIx[i][j]=0;
-    }
-  }
+  vpImage<float> GIx ;
+  filterX(I, GIx,filter,size,nThreads);
+  filterY(GIx, GI,filter,size,nThreads);
 }
-void vpImageFilter::filterX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size)
+
+/*!
+  Apply a symmetric filter along the rows of an image. The border pixels are
+  obtained by mirroring the image, as done by
+  vpImageFilter::filterXLeftBorder() and vpImageFilter::filterXRightBorder().
+  \param I : Image to filter.
+  \param dIx : Filtered image.
+  \param filter : Symmetric kernel of (size+1)/2 coefficients, as returned by vpImageFilter::getGaussianKernel().
+  \param size : Filter size. This value should be odd.
+  \param nThreads : Number of threads of vpThreadPool sharing the rows of the image.
+ */
+void vpImageFilter::filterX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size,
+                            const unsigned int nThreads)
 {
-  dIx.resize(I.getHeight(),I.getWidth()) ;
-  for (unsigned int i=0 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < (size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterXLeftBorder(I,i,j,filter,size);
-      //dIx[i][j]=0;
-    }
-    for (unsigned int j=(size-1)/2 ; j < I.getWidth()-(size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterX(I,i,j,filter,size);
-    }
-    for (unsigned int j=I.getWidth()-(size-1)/2 ; j < I.getWidth() ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterXRightBorder(I,i,j,filter,size);
-      //dIx[i][j]=0;
-    }
-  }
+  filterPass(I, dIx, filter, size, false, false, nThreads);
 }
-void vpImageFilter::filterY(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *filter,unsigned  int size)
+
+/*!
+  \overload
+ */
+void vpImageFilter::filterX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size,
+                            const unsigned int nThreads)
 {
-  dIy.resize(I.getHeight(),I.getWidth()) ;
-  for (unsigned int i=0 ; i < (size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterYTopBorder(I,i,j,filter,size);
-    }
-  }
-  for (unsigned int i=(size-1)/2 ; i < I.getHeight()-(size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterY(I,i,j,filter,size);
-    }
-  }
-  for (unsigned int i=I.getHeight()-(size-1)/2 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterYBottomBorder(I,i,j,filter,size);
-    }
-  }
+  filterPass(I, dIx, filter, size, false, false, nThreads);
 }
-void vpImageFilter::filterY(const vpImage<double> &I, vpImage<double>& dIy, const double *filter,unsigned  int size)
+
+/*!
+  \overload
+ */
+void vpImageFilter::filterX(const vpImage<unsigned char> &I, vpImage<float>& dIx, const double *filter,unsigned  int size,
+                            const unsigned int nThreads)
 {
-  dIy.resize(I.getHeight(),I.getWidth()) ;
-  for (unsigned int i=0 ; i < (size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterYTopBorder(I,i,j,filter,size);
-    }
-  }
-  for (unsigned int i=(size-1)/2 ; i < I.getHeight()-(size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterY(I,i,j,filter,size);
-    }
-  }
-  for (unsigned int i=I.getHeight()-(size-1)/2 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterYBottomBorder(I,i,j,filter,size);
-    }
-  }
+  filterPass(I, dIx, filter, size, false, false, nThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::filterX(const vpImage<float> &I, vpImage<float>& dIx, const double *filter,unsigned  int size,
+                            const unsigned int nThreads)
+{
+  filterPass(I, dIx, filter, size, false, false, nThreads);
+}
+
+/*!
+  Apply a symmetric filter along the columns of an image. The border pixels
+  are obtained by mirroring the image, as done by
+  vpImageFilter::filterYTopBorder() and vpImageFilter::filterYBottomBorder().
+  \param I : Image to filter.
+  \param dIy : Filtered image.
+  \param filter : Symmetric kernel of (size+1)/2 coefficients, as returned by vpImageFilter::getGaussianKernel().
+  \param size : Filter size. This value should be odd.
+  \param nThreads : Number of threads of vpThreadPool sharing the rows of the image.
+ */
+void vpImageFilter::filterY(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *filter,unsigned  int size,
+                            const unsigned int nThreads)
+{
+  filterPass(I, dIy, filter, size, true, false, nThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::filterY(const vpImage<double> &I, vpImage<double>& dIy, const double *filter,unsigned  int size,
+                            const unsigned int nThreads)
+{
+  filterPass(I, dIy, filter, size, true, false, nThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::filterY(const vpImage<unsigned char> &I, vpImage<float>& dIy, const double *filter,unsigned  int size,
+                            const unsigned int nThreads)
+{
+  filterPass(I, dIy, filter, size, true, false, nThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::filterY(const vpImage<float> &I, vpImage<float>& dIy, const double *filter,unsigned  int size,
+                            const unsigned int nThreads)
+{
+  filterPass(I, dIy, filter, size, true, false, nThreads);
 }
 
 /*!
@@ -449,17 +740,15 @@ void vpImageFilter::filterY(const vpImage<double> &I, vpImage<double>& dIy, cons
   \param size : Filter size. This value should be odd.
   \param sigma : Gaussian standard deviation. If it is equal to zero or negative, it is computed from filter size as sigma = (size-1)/6.
   \param normalize : Flag indicating whether to normalize the filter coefficients or not.
+  \param nThreads : Number of threads of vpThreadPool sharing the rows of the image.
 
  */
-void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<double>& GI, unsigned int size, double sigma, bool normalize)
+void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<double>& GI, unsigned int size, double sigma, bool normalize,
+                                 const unsigned int nThreads)
 {
-  double *fg=new double[(size+1)/2] ;
-  vpImageFilter::getGaussianKernel(fg, size, sigma, normalize) ;
-  vpImage<double> GIx ;
-  vpImageFilter::filterX(I, GIx,fg,size);
-  vpImageFilter::filterY(GIx, GI,fg,size);
-  GIx.destroy();
-  delete[] fg;
+  std::vector<double> fg((size+1)/2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, normalize) ;
+  vpImageFilter::filter(I, GI, &fg[0], size, nThreads);
 }
 
 /*!
@@ -469,17 +758,33 @@ void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<double
   \param size : Filter size. This value should be odd.
   \param sigma : Gaussian standard deviation. If it is equal to zero or negative, it is computed from filter size as sigma = (size-1)/6.
   \param normalize : Flag indicating whether to normalize the filter coefficients or not.
+  \param nThreads : Number of threads of vpThreadPool sharing the rows of the image.
 
  */
-void vpImageFilter::gaussianBlur(const vpImage<double> &I, vpImage<double>& GI, unsigned int size, double sigma, bool normalize)
+void vpImageFilter::gaussianBlur(const vpImage<double> &I, vpImage<double>& GI, unsigned int size, double sigma, bool normalize,
+                                 const unsigned int nThreads)
 {
-  double *fg=new double[(size+1)/2] ;
-  vpImageFilter::getGaussianKernel(fg, size, sigma, normalize) ;
-  vpImage<double> GIx ;
-  vpImageFilter::filterX(I, GIx,fg,size);
-  vpImageFilter::filterY(GIx, GI,fg,size);
-  GIx.destroy();
-  delete[] fg;
+  std::vector<double> fg((size+1)/2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, normalize) ;
+  vpImageFilter::filter(I, GI, &fg[0], size, nThreads);
+}
+
+/*!
+  Apply a Gaussian blur to an image, computed in single precision.
+  \param I : Input image.
+  \param GI : Filtered image.
+  \param size : Filter size. This value should be odd.
+  \param sigma : Gaussian standard deviation. If it is equal to zero or negative, it is computed from filter size as sigma = (size-1)/6.
+  \param normalize : Flag indicating whether to normalize the filter coefficients or not.
+  \param nThreads : Number of threads of vpThreadPool sharing the rows of the image.
+
+ */
+void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<float>& GI, unsigned int size, double sigma, bool normalize,
+                                 const unsigned int nThreads)
+{
+  std::vector<double> fg((size+1)/2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, normalize) ;
+  vpImageFilter::filter(I, GI, &fg[0], size, nThreads);
 }
 
 /*!
@@ -612,101 +917,88 @@ void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<double>& d
   }
 }
 
-void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size)
+/*!
+  Compute the gradient along X with an antisymmetric kernel. The pixels
+  closer than (size-1)/2 to the left or right border are set to zero.
+  \param I : Input image.
+  \param dIx : Gradient along X.
+  \param filter : Derivative kernel of (size+1)/2 coefficients, as returned by vpImageFilter::getGaussianDerivativeKernel().
+  \param size : Filter size. This value should be odd.
+  \param nThreads : Number of threads of vpThreadPool sharing the rows of the image.
+ */
+void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size,
+                             const unsigned int nThreads)
 {
-  dIx.resize(I.getHeight(),I.getWidth()) ;
-  //#pragma omp parallel for
-  for (unsigned int i=0 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < (size-1)/2 ; j++)
-    {
-      dIx[i][j]=0;
-    }
-    for (unsigned int j=(size-1)/2 ; j < I.getWidth()-(size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::derivativeFilterX(I,i,j,filter,size);
-    }
-    for (unsigned int j=I.getWidth()-(size-1)/2 ; j < I.getWidth() ; j++)
-    {
-      dIx[i][j]=0;
-    }
-  }
+  filterPass(I, dIx, filter, size, false, true, nThreads);
 }
-void vpImageFilter::getGradX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size)
+
+/*!
+  \overload
+ */
+void vpImageFilter::getGradX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size,
+                             const unsigned int nThreads)
 {
-  dIx.resize(I.getHeight(),I.getWidth()) ;
-  //dIx=0;
-  for (unsigned int i=0 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < (size-1)/2 ; j++)
-    {
-      dIx[i][j]=0;
-    }
-    for (unsigned int j=(size-1)/2 ; j < I.getWidth()-(size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::derivativeFilterX(I,i,j,filter,size);
-    }
-    for (unsigned int j=I.getWidth()-(size-1)/2 ; j < I.getWidth() ; j++)
-    {
-      dIx[i][j]=0;
-    }
-  }
+  filterPass(I, dIx, filter, size, false, true, nThreads);
 }
 
-void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *filter,unsigned  int size)
+/*!
+  \overload
+ */
+void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<float>& dIx, const double *filter,unsigned  int size,
+                             const unsigned int nThreads)
 {
-  dIy.resize(I.getHeight(),I.getWidth()) ;
-  //#pragma omp parallel for
-  for (unsigned int i=0 ; i < (size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=0;
-    }
-  }
-  //#pragma omp parallel for
-  for (unsigned int i=(size-1)/2 ; i < I.getHeight()-(size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::derivativeFilterY(I,i,j,filter,size);
-    }
-  }
-  //#pragma omp parallel for
-  for (unsigned int i=I.getHeight()-(size-1)/2 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=0;
-    }
-  }
+  filterPass(I, dIx, filter, size, false, true, nThreads);
 }
 
-void vpImageFilter::getGradY(const vpImage<double> &I, vpImage<double>& dIy, const double *filter,unsigned  int size)
+/*!
+  \overload
+ */
+void vpImageFilter::getGradX(const vpImage<float> &I, vpImage<float>& dIx, const double *filter,unsigned  int size,
+                             const unsigned int nThreads)
 {
-  dIy.resize(I.getHeight(),I.getWidth()) ;
-  //dIy=0;
-  for (unsigned int i=0 ; i < (size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=0;
-    }
-  }
-  for (unsigned int i=(size-1)/2 ; i < I.getHeight()-(size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::derivativeFilterY(I,i,j,filter,size);
-    }
-  }
-  for (unsigned int i=I.getHeight()-(size-1)/2 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=0;
-    }
-  }
+  filterPass(I, dIx, filter, size, false, true, nThreads);
+}
+
+/*!
+  Compute the gradient along Y with an antisymmetric kernel. The pixels
+  closer than (size-1)/2 to the top or bottom border are set to zero.
+  \param I : Input image.
+  \param dIy : Gradient along Y.
+  \param filter : Derivative kernel of (size+1)/2 coefficients, as returned by vpImageFilter::getGaussianDerivativeKernel().
+  \param size : Filter size. This value should be odd.
+  \param nThreads : Number of threads of vpThreadPool sharing the rows of the image.
+ */
+void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *filter,unsigned  int size,
+                             const unsigned int nThreads)
+{
+  filterPass(I, dIy, filter, size, true, true, nThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::getGradY(const vpImage<double> &I, vpImage<double>& dIy, const double *filter,unsigned  int size,
+                             const unsigned int nThreads)
+{
+  filterPass(I, dIy, filter, size, true, true, nThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<float>& dIy, const double *filter,unsigned  int size,
+                             const unsigned int nThreads)
+{
+  filterPass(I, dIy, filter, size, true, true, nThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::getGradY(const vpImage<float> &I, vpImage<float>& dIy, const double *filter,unsigned  int size,
+                             const unsigned int nThreads)
+{
+  filterPass(I, dIy, filter, size, true, true, nThreads);
 }
 
 /*!
@@ -716,12 +1008,32 @@ void vpImageFilter::getGradY(const vpImage<double> &I, vpImage<double>& dIy, con
    \param gaussianKernel : Gaussian kernel which values should be computed using vpImageFilter::getGaussianKernel().
    \param gaussianDerivativeKernel : Gaussian derivative kernel which values should be computed using vpImageFilter::getGaussianDerivativeKernel().
    \param size : Size of the Gaussian and Gaussian derivative kernels.
+   \param nThreads : Number of threads of vpThreadPool sharing the rows of the image.
  */
-void vpImageFilter::getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *gaussianKernel, const double *gaussianDerivativeKernel, unsigned  int size)
+void vpImageFilter::getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *gaussianKernel,
+                                    const double *gaussianDerivativeKernel, unsigned  int size, const unsigned int nThreads)
 {
   vpImage<double> GIy;
-  vpImageFilter::filterY(I,  GIy, gaussianKernel, size);
-  vpImageFilter::getGradX(GIy, dIx, gaussianDerivativeKernel, size);
+  vpImageFilter::filterY(I,  GIy, gaussianKernel, size, nThreads);
+  vpImageFilter::getGradX(GIy, dIx, gaussianDerivativeKernel, size, nThreads);
+}
+
+/*!
+   Compute in single precision the gradient along X after applying a
+   gaussian filter along Y.
+   \param I : Input image
+   \param dIx : Gradient along X.
+   \param gaussianKernel : Gaussian kernel which values should be computed using vpImageFilter::getGaussianKernel().
+   \param gaussianDerivativeKernel : Gaussian derivative kernel which values should be computed using vpImageFilter::getGaussianDerivativeKernel().
+   \param size : Size of the Gaussian and Gaussian derivative kernels.
+   \param nThreads : Number of threads of vpThreadPool sharing the rows of the image.
+ */
+void vpImageFilter::getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<float>& dIx, const double *gaussianKernel,
+                                    const double *gaussianDerivativeKernel, unsigned  int size, const unsigned int nThreads)
+{
+  vpImage<float> GIy;
+  vpImageFilter::filterY(I,  GIy, gaussianKernel, size, nThreads);
+  vpImageFilter::getGradX(GIy, dIx, gaussianDerivativeKernel, size, nThreads);
 }
 
 /*!
@@ -731,12 +1043,32 @@ void vpImageFilter::getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<dou
    \param gaussianKernel : Gaussian kernel which values should be computed using vpImageFilter::getGaussianKernel().
    \param gaussianDerivativeKernel : Gaussian derivative kernel which values should be computed using vpImageFilter::getGaussianDerivativeKernel().
    \param size : Size of the Gaussian and Gaussian derivative kernels.
+   \param nThreads : Number of threads of vpThreadPool sharing the rows of the image.
  */
-void vpImageFilter::getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *gaussianKernel, const double *gaussianDerivativeKernel,unsigned  int size)
+void vpImageFilter::getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *gaussianKernel,
+                                    const double *gaussianDerivativeKernel,unsigned  int size, const unsigned int nThreads)
 {
   vpImage<double> GIx;
-  vpImageFilter::filterX(I,  GIx, gaussianKernel, size);
-  vpImageFilter::getGradY(GIx, dIy, gaussianDerivativeKernel, size);
+  vpImageFilter::filterX(I,  GIx, gaussianKernel, size, nThreads);
+  vpImageFilter::getGradY(GIx, dIy, gaussianDerivativeKernel, size, nThreads);
+}
+
+/*!
+   Compute in single precision the gradient along Y after applying a
+   gaussian filter along X.
+   \param I : Input image
+   \param dIy : Gradient along Y.
+   \param gaussianKernel : Gaussian kernel which values should be computed using vpImageFilter::getGaussianKernel().
+   \param gaussianDerivativeKernel : Gaussian derivative kernel which values should be computed using vpImageFilter::getGaussianDerivativeKernel().
+   \param size : Size of the Gaussian and Gaussian derivative kernels.
+   \param nThreads : Number of threads of vpThreadPool sharing the rows of the image.
+ */
+void vpImageFilter::getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<float>& dIy, const double *gaussianKernel,
+                                    const double *gaussianDerivativeKernel,unsigned  int size, const unsigned int nThreads)
+{
+  vpImage<float> GIx;
+  vpImageFilter::filterX(I,  GIx, gaussianKernel, size, nThreads);
+  vpImageFilter::getGradY(GIx, dIy, gaussianDerivativeKernel, size, nThreads);
 }
 
 //operation pour pyramide gaussienne
@@ -772,64 +1104,127 @@ void vpImageFilter::getGaussPyramidal(const vpImage<unsigned char> &I, vpImage<u
 #endif
 }
 
+/*!
+  Filter the image along the columns with the [1 4 6 4 1]/16 kernel and keep
+  one column out of two. The first and last columns of \e GI are copied from
+  \e I without filtering.
+
+  The filter is computed with integer arithmetic (using SSE2 when available)
+  and gives the same result as vpImageFilter::filterGaussXPyramidal().
+
+  \param I : Input image.
+  \param GI : Filtered image of size I.getHeight() x I.getWidth()/2. When \e GI
+  already has the right size, its buffer is reused.
+*/
 void vpImageFilter::getGaussXPyramidal(const vpImage<unsigned char> &I, vpImage<unsigned char>& GI)
 {
-#if 0
-  GI.resize(I.getHeight(),(int)((I.getWidth()+1.)/2.)) ;
-  for (unsigned int i=0 ; i < I.getHeight() ; i++)
-  {
-    GI[i][0]=I[i][0];
-    for (unsigned int j=1 ; j < ((I.getWidth()+1.)/2.)-1 ; j++)
-    {
-      GI[i][j]=vpImageFilter::filterGaussXPyramidal(I,i,2*j);
-    }
-    GI[i][(int)((I.getWidth()+1.)/2.)-1]=I[i][2*((int)((I.getWidth()+1.)/2.)-1)];
-  }
-#else
-  unsigned int w = I.getWidth()/2;
+  const unsigned int w = I.getWidth()/2;
 
   GI.resize(I.getHeight(), w) ;
+  if (w == 0)
+    return;
+
+#if VISP_HAVE_SSE2
+  const __m128i mask = _mm_set1_epi16(0x00FF);
+  const __m128i zero = _mm_setzero_si128();
+#endif
+
   for (unsigned int i=0 ; i < I.getHeight() ; i++)
   {
-    GI[i][0]=I[i][0];
-    for (unsigned int j=1 ; j < w-1 ; j++)
-    {
-      GI[i][j]=vpImageFilter::filterGaussXPyramidal(I,i,2*j);
+    const unsigned char *src = I[i];
+    unsigned char *dst = GI[i];
+
+    dst[0] = src[0];
+    unsigned int j = 1;
+#if VISP_HAVE_SSE2
+    // 8 output pixels are computed from the 20 input pixels starting at 2*j-2.
+    // The even and odd input pixels are split in the 16-bit lanes.
+    for ( ; j+8 <= w-1 && 2*j+18 <= I.getWidth(); j += 8) {
+      const unsigned char *p = src + 2*j - 2;
+      const __m128i a = _mm_loadu_si128((const __m128i *) p);
+      const __m128i b = _mm_loadu_si128((const __m128i *) (p+2));
+      const __m128i c = _mm_loadu_si128((const __m128i *) (p+4));
+
+      const __m128i b_even = _mm_and_si128(b, mask);
+      __m128i sum = _mm_add_epi16(_mm_and_si128(a, mask), _mm_and_si128(c, mask));
+      sum = _mm_add_epi16(sum, _mm_slli_epi16(_mm_add_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)), 2));
+      sum = _mm_add_epi16(sum, _mm_add_epi16(_mm_slli_epi16(b_even, 2), _mm_slli_epi16(b_even, 1)));
+
+      _mm_storel_epi64((__m128i *) (dst+j), _mm_packus_epi16(_mm_srli_epi16(sum, 4), zero));
     }
-    GI[i][w-1]=I[i][2*w-1];
-  }
-
 #endif
+    for ( ; j+1 < w ; j++) {
+      const unsigned char *p = src + 2*j;
+      dst[j] = (unsigned char) ((p[-2] + 4*(p[-1] + p[1]) + 6*p[0] + p[2]) >> 4);
+    }
+    dst[w-1] = src[2*w-1];
+  }
 }
+
+/*!
+  Filter the image along the rows with the [1 4 6 4 1]/16 kernel and keep
+  one row out of two. The first and last rows of \e GI are copied from \e I
+  without filtering.
+
+  The filter is computed with integer arithmetic (using SSE2 when available)
+  and gives the same result as vpImageFilter::filterGaussYPyramidal().
+
+  \param I : Input image.
+  \param GI : Filtered image of size I.getHeight()/2 x I.getWidth(). When \e GI
+  already has the right size, its buffer is reused.
+*/
 void vpImageFilter::getGaussYPyramidal(const vpImage<unsigned char> &I, vpImage<unsigned char>& GI)
 {
+  const unsigned int h = I.getHeight()/2;
+  const unsigned int width = I.getWidth();
 
-#ifdef ORIG
-  GI.resize((int)((I.getHeight()+1.)/2.),I.getWidth()) ;
-  for (unsigned int j=0 ; j < I.getWidth() ; j++)
-  {
-    GI[0][j]=I[0][j];
-    for (unsigned int i=1 ; i < ((I.getHeight()+1.)/2.)-1 ; i++)
-    {
-      GI[i][j]=vpImageFilter::filterGaussYPyramidal(I,2*i,j);
-    }
-    GI[(int)((I.getHeight()+1.)/2.)-1][j]=I[2*((int)((I.getHeight()+1.)/2.)-1)][j];
-  }
+  GI.resize(h, width) ;
+  if (h == 0 || width == 0)
+    return;
 
-#else
-  unsigned int h = I.getHeight()/2;
+  memcpy(GI[0], I[0], width*sizeof(unsigned char));
+
+#if VISP_HAVE_SSE2
+  const __m128i zero = _mm_setzero_si128();
+#endif
 
-  GI.resize(h, I.getWidth()) ;
-  for (unsigned int j=0 ; j < I.getWidth() ; j++)
+  for (unsigned int i=1 ; i+1 < h ; i++)
   {
-    GI[0][j]=I[0][j];
-    for (unsigned int i=1 ; i < h-1 ; i++)
-    {
-         GI[i][j]=vpImageFilter::filterGaussYPyramidal(I,2*i,j);
+    const unsigned char *r0 = I[2*i-2];
+    const unsigned char *r1 = I[2*i-1];
+    const unsigned char *r2 = I[2*i];
+    const unsigned char *r3 = I[2*i+1];
+    const unsigned char *r4 = I[2*i+2];
+    unsigned char *dst = GI[i];
+
+    unsigned int j = 0;
+#if VISP_HAVE_SSE2
+    for ( ; j+16 <= width; j += 16) {
+      const __m128i v0 = _mm_loadu_si128((const __m128i *) (r0+j));
+      const __m128i v1 = _mm_loadu_si128((const __m128i *) (r1+j));
+      const __m128i v2 = _mm_loadu_si128((const __m128i *) (r2+j));
+      const __m128i v3 = _mm_loadu_si128((const __m128i *) (r3+j));
+      const __m128i v4 = _mm_loadu_si128((const __m128i *) (r4+j));
+
+      __m128i c2 = _mm_unpacklo_epi8(v2, zero);
+      __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(v0, zero), _mm_unpacklo_epi8(v4, zero));
+      lo = _mm_add_epi16(lo, _mm_slli_epi16(_mm_add_epi16(_mm_unpacklo_epi8(v1, zero), _mm_unpacklo_epi8(v3, zero)), 2));
+      lo = _mm_add_epi16(lo, _mm_add_epi16(_mm_slli_epi16(c2, 2), _mm_slli_epi16(c2, 1)));
+
+      c2 = _mm_unpackhi_epi8(v2, zero);
+      __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(v0, zero), _mm_unpackhi_epi8(v4, zero));
+      hi = _mm_add_epi16(hi, _mm_slli_epi16(_mm_add_epi16(_mm_unpackhi_epi8(v1, zero), _mm_unpackhi_epi8(v3, zero)), 2));
+      hi = _mm_add_epi16(hi, _mm_add_epi16(_mm_slli_epi16(c2, 2), _mm_slli_epi16(c2, 1)));
+
+      _mm_storeu_si128((__m128i *) (dst+j), _mm_packus_epi16(_mm_srli_epi16(lo, 4), _mm_srli_epi16(hi, 4)));
     }
-    GI[h-1][j]=I[2*h-1][j];
-  }
 #endif
+    for ( ; j < width; j++) {
+      dst[j] = (unsigned char) ((r0[j] + 4*(r1[j] + r3[j]) + 6*r2[j] + r4[j]) >> 4);
+    }
+  }
+
+  memcpy(GI[h-1], I[2*h-1], width*sizeof(unsigned char));
 }
 
 
@@ -0,0 +1,145 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Image pyramid with buffers kept across frames.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpImagePyramid.cpp
+  \brief Image pyramid whose levels are reused from one frame to the next.
+*/
+
+#include <visp3/core/vpImagePyramid.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpImageFilter.h>
+
+/*!
+  Create a pyramid. No image is allocated before the first call to build().
+
+  \param nbLevels : Number of levels, including level 0. A value of 0 is
+  considered as 1.
+  \param type : Method used to compute a level from the previous one.
+*/
+vpImagePyramid::vpImagePyramid(unsigned int nbLevels, const vpImagePyramidFilterType &type)
+  : m_nbLevels(nbLevels > 0 ? nbLevels : 1), m_filterType(type), m_I0(NULL), m_levels(), m_buffer()
+{
+  m_levels.resize(m_nbLevels-1);
+}
+
+/*!
+  Build all the levels of the pyramid from a new image. The images of the
+  levels 1 and above are only reallocated when their size changes.
+
+  \param I : Image of level 0. It is not copied and must outlive the use of
+  the pyramid.
+*/
+void vpImagePyramid::build(const vpImage<unsigned char> &I)
+{
+  m_I0 = &I;
+
+  const vpImage<unsigned char> *prev = &I;
+  for (unsigned int l = 0; l < m_levels.size(); l++) {
+    vpImage<unsigned char> &level = m_levels[l];
+
+    if (m_filterType == GAUSSIAN_FILTER) {
+      vpImageFilter::getGaussXPyramidal(*prev, m_buffer);
+      vpImageFilter::getGaussYPyramidal(m_buffer, level);
+    }
+    else {
+      level.resize(prev->getHeight()/2, prev->getWidth()/2);
+      for (unsigned int i = 0; i < level.getHeight(); i++) {
+        const unsigned char *src = (*prev)[2*i];
+        unsigned char *dst = level[i];
+        for (unsigned int j = 0; j < level.getWidth(); j++) {
+          dst[j] = src[2*j];
+        }
+      }
+    }
+
+    prev = &level;
+  }
+}
+
+/*!
+  Return the image of a level.
+
+  \param level : Level index, from 0 (the image given to build()) to
+  getNbLevels()-1.
+
+  \exception vpException::notInitialized : If build() was not called.
+  \exception vpException::dimensionError : If \e level is out of range.
+*/
+const vpImage<unsigned char> &vpImagePyramid::getLevel(unsigned int level) const
+{
+  if (m_I0 == NULL) {
+    throw(vpException(vpException::notInitialized,
+                      "The image pyramid is not built"));
+  }
+  if (level >= m_nbLevels) {
+    throw(vpException(vpException::dimensionError,
+                      "Level %u is out of the pyramid of %u levels", level, m_nbLevels));
+  }
+
+  return (level == 0) ? *m_I0 : m_levels[level-1];
+}
+
+/*!
+  Set the method used to compute a level from the previous one. The pyramid
+  has to be built again.
+
+  \param type : New filter type.
+*/
+void vpImagePyramid::setFilterType(const vpImagePyramidFilterType &type)
+{
+  if (type != m_filterType) {
+    m_filterType = type;
+    m_I0 = NULL;
+  }
+}
+
+/*!
+  Set the number of levels. When it changes, the pyramid has to be built
+  again.
+
+  \param nbLevels : Number of levels, including level 0. A value of 0 is
+  considered as 1.
+*/
+void vpImagePyramid::setNbLevels(unsigned int nbLevels)
+{
+  if (nbLevels == 0)
+    nbLevels = 1;
+
+  if (nbLevels != m_nbLevels) {
+    m_nbLevels = nbLevels;
+    m_levels.resize(m_nbLevels-1);
+    m_I0 = NULL;
+  }
+}
@@ -0,0 +1,299 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Organized point cloud stored in contiguous arrays.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <limits>
+
+#include <visp3/core/vpPointCloud.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpThreadPool.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Deprojection of the rows [begin, end) of a depth map
+  struct vpPointCloudDeprojection {
+    const uint16_t *depth16;
+    const float *depthf;
+    unsigned int width;
+    const float *xFactor, *yFactor;
+    float scale, maxZ, invalid;
+    float *X, *Y, *Z;
+    unsigned char *valid;
+
+    void operator()(unsigned int begin, unsigned int end) const {
+      for (unsigned int i = begin; i < end; i++) {
+        const float yf = yFactor[i];
+        unsigned int k = i * width;
+        unsigned int j = 0;
+
+#if VISP_HAVE_SSE2
+        const __m128 v_scale = _mm_set1_ps(scale), v_maxZ = _mm_set1_ps(maxZ);
+        const __m128 v_invalid = _mm_set1_ps(invalid), v_yf = _mm_set1_ps(yf);
+        const __m128 v_zero = _mm_setzero_ps();
+        const __m128i zero = _mm_setzero_si128();
+        for (; j + 4 <= width; j += 4, k += 4) {
+          __m128 z;
+          if (depthf != NULL) {
+            z = _mm_mul_ps(_mm_loadu_ps(depthf + k), v_scale);
+          }
+          else {
+            __m128i d = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *) (depth16 + k)), zero);
+            z = _mm_mul_ps(_mm_cvtepi32_ps(d), v_scale);
+          }
+          const __m128 mask = _mm_and_ps(_mm_cmpgt_ps(z, v_zero), _mm_cmple_ps(z, v_maxZ));
+          const __m128 x = _mm_mul_ps(z, _mm_loadu_ps(xFactor + j));
+          const __m128 y = _mm_mul_ps(z, v_yf);
+          const __m128 inv = _mm_andnot_ps(mask, v_invalid);
+          _mm_storeu_ps(X + k, _mm_or_ps(_mm_and_ps(mask, x), inv));
+          _mm_storeu_ps(Y + k, _mm_or_ps(_mm_and_ps(mask, y), inv));
+          _mm_storeu_ps(Z + k, _mm_or_ps(_mm_and_ps(mask, z), inv));
+
+          const int m = _mm_movemask_ps(mask);
+          valid[k] = (unsigned char) (m & 1);
+          valid[k+1] = (unsigned char) ((m >> 1) & 1);
+          valid[k+2] = (unsigned char) ((m >> 2) & 1);
+          valid[k+3] = (unsigned char) ((m >> 3) & 1);
+        }
+#endif
+
+        for (; j < width; j++, k++) {
+          const float z = (depthf != NULL) ? depthf[k] * scale : depth16[k] * scale;
+          if (z > 0 && z <= maxZ) {
+            X[k] = z * xFactor[j];
+            Y[k] = z * yf;
+            Z[k] = z;
+            valid[k] = 1;
+          }
+          else {
+            X[k] = Y[k] = Z[k] = invalid;
+            valid[k] = 0;
+          }
+        }
+      }
+    }
+  };
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor. The cloud is empty.
+*/
+vpPointCloud::vpPointCloud()
+  : m_height(0), m_width(0), m_withColor(false), m_invalidValue(0.f), m_nbThreads(0), m_X(), m_Y(), m_Z(), m_valid(),
+    m_color(), m_xFactor(), m_yFactor()
+{
+}
+
+/*!
+  Build a cloud of \e height x \e width invalid points.
+
+  \sa resize()
+*/
+vpPointCloud::vpPointCloud(unsigned int height, unsigned int width, bool withColor)
+  : m_height(0), m_width(0), m_withColor(false), m_invalidValue(0.f), m_nbThreads(0), m_X(), m_Y(), m_Z(), m_valid(),
+    m_color(), m_xFactor(), m_yFactor()
+{
+  resize(height, width, withColor);
+}
+
+/*!
+  Deproject a depth map given as integers, e.g. the depth stream of a
+  RealSense or Kinect camera, with the intrinsic parameters of the depth
+  camera. The cloud is resized to the size of \e depth; the memory is only
+  reallocated if it grows. A color set by setColor() for the previous frame
+  is kept, so that setColor() can be called after each buildFrom().
+
+  \param depth : Depth map.
+  \param cam : Intrinsic parameters of the depth camera. The distortion is
+  not taken into account.
+  \param depthScale : Factor that converts the depth values in meters, e.g.
+  0.001 for depths in millimeters.
+  \param maxZ : Points farther than \e maxZ meters are invalid. A value
+  lower or equal to 0 means no limit.
+*/
+void vpPointCloud::buildFrom(const vpImage<uint16_t> &depth, const vpCameraParameters &cam, float depthScale,
+                             float maxZ)
+{
+  resize(depth.getHeight(), depth.getWidth(), m_withColor);
+  deproject(depth.bitmap, false, cam, depthScale, maxZ);
+}
+
+/*!
+  Deproject a metric depth map, e.g. the one given by
+  vpKinect::getDepthMap(), with the intrinsic parameters of the depth camera.
+  Negative or NAN depths are invalid.
+
+  \param depth : Depth map in meters.
+  \param cam : Intrinsic parameters of the depth camera. The distortion is
+  not taken into account.
+  \param maxZ : Points farther than \e maxZ meters are invalid. A value
+  lower or equal to 0 means no limit.
+
+  \sa buildFrom(const vpImage<uint16_t> &, const vpCameraParameters &, float, float)
+*/
+void vpPointCloud::buildFrom(const vpImage<float> &depth, const vpCameraParameters &cam, float maxZ)
+{
+  resize(depth.getHeight(), depth.getWidth(), m_withColor);
+  deproject(depth.bitmap, true, cam, 1.f, maxZ);
+}
+
+/*!
+  Remove all the points. The memory is kept for the next frames.
+*/
+void vpPointCloud::clear()
+{
+  resize(0, 0, false);
+}
+
+/*!
+  Convert the cloud into the format used by
+  vpRealSense::acquire(std::vector<vpColVector> &): a 4-dimension vector
+  \f$(X, Y, Z, 1)\f$ per point, in the order of the pixels. The vectors of
+  \e pointcloud that already have 4 elements are reused.
+*/
+void vpPointCloud::convert(std::vector<vpColVector> &pointcloud) const
+{
+  const unsigned int size = getSize();
+  pointcloud.resize(size);
+  for (unsigned int k = 0; k < size; k++) {
+    vpColVector &p = pointcloud[k];
+    if (p.getRows() != 4)
+      p.resize(4, false);
+    p[0] = m_X[k];
+    p[1] = m_Y[k];
+    p[2] = m_Z[k];
+    p[3] = 1;
+  }
+}
+
+/*!
+  Return the number of valid points.
+*/
+unsigned int vpPointCloud::getNbValid() const
+{
+  unsigned int nb = 0;
+  for (size_t k = 0; k < m_valid.size(); k++)
+    nb += m_valid[k];
+  return nb;
+}
+
+/*!
+  Resize the cloud. The memory is only reallocated when the number of
+  points grows beyond the largest size the cloud ever had. The content of
+  the points is not initialized.
+
+  \param height, width : Size of the organized cloud.
+  \param withColor : True to store a color per point.
+*/
+void vpPointCloud::resize(unsigned int height, unsigned int width, bool withColor)
+{
+  m_height = height;
+  m_width = width;
+  m_withColor = withColor;
+
+  const size_t size = (size_t) height * width;
+  m_X.resize(size);
+  m_Y.resize(size);
+  m_Z.resize(size);
+  m_valid.resize(size);
+  if (withColor)
+    m_color.resize(size);
+  else
+    m_color.clear();
+}
+
+/*!
+  Set the color of the points from an image aligned with the depth map, e.g.
+  the color stream of a RealSense camera aligned to the depth stream.
+
+  \exception vpException::dimensionError : If the size of \e color is not
+  the size of the cloud.
+*/
+void vpPointCloud::setColor(const vpImage<vpRGBa> &color)
+{
+  if (color.getHeight() != m_height || color.getWidth() != m_width) {
+    throw(vpException(vpException::dimensionError, "Cannot set the color of a (%dx%d) point cloud with a (%dx%d) image",
+                      m_width, m_height, color.getWidth(), color.getHeight()));
+  }
+
+  m_withColor = true;
+  m_color.resize(getSize());
+  std::copy(color.bitmap, color.bitmap + getSize(), m_color.begin());
+}
+
+/*!
+  Set the number of threads used by buildFrom(). The rows are shared between
+  the threads of vpThreadPool.
+
+  \param nbThreads : Number of threads, 0 meaning
+  vpThreadPool::getNbThreads(), 1 to process the rows in the calling thread.
+*/
+void vpPointCloud::setNbThreads(unsigned int nbThreads)
+{
+  m_nbThreads = nbThreads;
+}
+
+void vpPointCloud::deproject(const void *depth, bool isFloat, const vpCameraParameters &cam, float depthScale,
+                             float maxZ)
+{
+  if (getSize() == 0)
+    return;
+
+  m_xFactor.resize(m_width);
+  m_yFactor.resize(m_height);
+  for (unsigned int j = 0; j < m_width; j++)
+    m_xFactor[j] = (float) ((j - cam.get_u0()) * cam.get_px_inverse());
+  for (unsigned int i = 0; i < m_height; i++)
+    m_yFactor[i] = (float) ((i - cam.get_v0()) * cam.get_py_inverse());
+
+  vpPointCloudDeprojection deprojection;
+  deprojection.depth16 = isFloat ? NULL : static_cast<const uint16_t *>(depth);
+  deprojection.depthf = isFloat ? static_cast<const float *>(depth) : NULL;
+  deprojection.width = m_width;
+  deprojection.xFactor = &m_xFactor[0];
+  deprojection.yFactor = &m_yFactor[0];
+  deprojection.scale = depthScale;
+  deprojection.maxZ = (maxZ > 0) ? maxZ : std::numeric_limits<float>::max();
+  deprojection.invalid = m_invalidValue;
+  deprojection.X = &m_X[0];
+  deprojection.Y = &m_Y[0];
+  deprojection.Z = &m_Z[0];
+  deprojection.valid = &m_valid[0];
+  vpThreadPool::parallel_for(0, m_height, deprojection, m_nbThreads, 16);
+}
@@ -0,0 +1,356 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Precomputed undistortion remap table.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpUndistortMap.cpp
+  \brief Precomputed remap table to undistort (or distort) images.
+*/
+
+#include <math.h>
+#include <string.h>
+#include <limits>
+
+#include <visp3/core/vpUndistortMap.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpThreadPool.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Bilinear weights are stored in Q14 so that a weighted pixel fits in a 16-bit madd
+  const int vpUndistortMap_WEIGHT_BITS = 14;
+  const int vpUndistortMap_WEIGHT_ONE = 1 << vpUndistortMap_WEIGHT_BITS;
+  const int vpUndistortMap_ROUND = 1 << (vpUndistortMap_WEIGHT_BITS - 1);
+
+  void remapGrey(const int *offset, const short *weights, const unsigned char *src, unsigned int width,
+                 unsigned char *dst, unsigned int start_index, unsigned int end_index)
+  {
+    unsigned int i = start_index;
+
+#if VISP_HAVE_SSE2
+    const __m128i round = _mm_set1_epi32(vpUndistortMap_ROUND);
+    if (end_index - start_index >= 4) {
+      for (; i <= end_index - 4; i += 4) {
+        const unsigned char *p0 = src + offset[i];
+        const unsigned char *p1 = src + offset[i+1];
+        const unsigned char *p2 = src + offset[i+2];
+        const unsigned char *p3 = src + offset[i+3];
+
+        // Neighbours of pixels 0 and 2 in the first register, 1 and 3 in the second one
+        __m128i n02 = _mm_setr_epi16(p0[0], p0[1], p0[width], p0[width+1], p2[0], p2[1], p2[width], p2[width+1]);
+        __m128i n13 = _mm_setr_epi16(p1[0], p1[1], p1[width], p1[width+1], p3[0], p3[1], p3[width], p3[width+1]);
+        __m128i w01 = _mm_loadu_si128((const __m128i *) (weights + 4*i));
+        __m128i w23 = _mm_loadu_si128((const __m128i *) (weights + 4*i + 8));
+        __m128i w02 = _mm_unpacklo_epi64(w01, w23);
+        __m128i w13 = _mm_unpackhi_epi64(w01, w23);
+
+        // Partial sums [a0, a1, c0, c1] and [b0, b1, d0, d1]
+        __m128i s02 = _mm_madd_epi16(n02, w02);
+        __m128i s13 = _mm_madd_epi16(n13, w13);
+        __m128i lo = _mm_unpacklo_epi32(s02, s13); // a0 b0 a1 b1
+        __m128i hi = _mm_unpackhi_epi32(s02, s13); // c0 d0 c1 d1
+        __m128i sum = _mm_add_epi32(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi)); // a b c d
+
+        sum = _mm_srai_epi32(_mm_add_epi32(sum, round), vpUndistortMap_WEIGHT_BITS);
+        sum = _mm_packs_epi32(sum, sum);
+        sum = _mm_packus_epi16(sum, sum);
+        int res = _mm_cvtsi128_si32(sum);
+        memcpy(dst + i, &res, 4);
+      }
+    }
+#endif
+
+    for (; i < end_index; i++) {
+      const unsigned char *p = src + offset[i];
+      const short *w = weights + 4*i;
+      dst[i] = (unsigned char) ((p[0]*w[0] + p[1]*w[1] + p[width]*w[2] + p[width+1]*w[3] + vpUndistortMap_ROUND)
+          >> vpUndistortMap_WEIGHT_BITS);
+    }
+  }
+
+  void remapRGBa(const int *offset, const short *weights, const unsigned char *src, unsigned int width,
+                 unsigned char *dst, unsigned int start_index, unsigned int end_index)
+  {
+    unsigned int i = start_index;
+    const unsigned int stride = 4*width;
+
+#if VISP_HAVE_SSE2
+    const __m128i round = _mm_set1_epi32(vpUndistortMap_ROUND);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i < end_index; i++) {
+      const unsigned char *p = src + 4*offset[i];
+      __m128i w = _mm_loadl_epi64((const __m128i *) (weights + 4*i));
+      __m128i w_top = _mm_shuffle_epi32(w, 0x00);
+      __m128i w_bottom = _mm_shuffle_epi32(w, 0x55);
+
+      // Interleave the channels of the two neighbours: R0 R1 G0 G1 B0 B1 A0 A1
+      __m128i top = _mm_loadl_epi64((const __m128i *) p);
+      top = _mm_unpacklo_epi8(_mm_unpacklo_epi8(top, _mm_srli_si128(top, 4)), zero);
+      __m128i bottom = _mm_loadl_epi64((const __m128i *) (p + stride));
+      bottom = _mm_unpacklo_epi8(_mm_unpacklo_epi8(bottom, _mm_srli_si128(bottom, 4)), zero);
+
+      __m128i sum = _mm_add_epi32(_mm_madd_epi16(top, w_top), _mm_madd_epi16(bottom, w_bottom));
+      sum = _mm_srai_epi32(_mm_add_epi32(sum, round), vpUndistortMap_WEIGHT_BITS);
+      sum = _mm_packs_epi32(sum, sum);
+      sum = _mm_packus_epi16(sum, sum);
+      int res = _mm_cvtsi128_si32(sum);
+      memcpy(dst + 4*i, &res, 4);
+    }
+#endif
+
+    for (; i < end_index; i++) {
+      const unsigned char *p = src + 4*offset[i];
+      const short *w = weights + 4*i;
+      for (unsigned int c = 0; c < 4; c++) {
+        dst[4*i + c] = (unsigned char) ((p[c]*w[0] + p[4+c]*w[1] + p[stride+c]*w[2] + p[stride+4+c]*w[3]
+                                        + vpUndistortMap_ROUND) >> vpUndistortMap_WEIGHT_BITS);
+      }
+    }
+  }
+
+  struct vpUndistortMap_Param_t {
+    const int *m_offset;
+    const short *m_weights;
+    const unsigned char *m_src;
+    unsigned char *m_dst;
+    unsigned int m_width;
+    bool m_rgba;
+
+    vpUndistortMap_Param_t() : m_offset(NULL), m_weights(NULL), m_src(NULL), m_dst(NULL), m_width(0),
+      m_rgba(false) {
+    }
+  };
+
+  // Remap the rows [begin, end)
+  void remapRows(unsigned int begin, unsigned int end, void *args)
+  {
+    const vpUndistortMap_Param_t &param = *static_cast<const vpUndistortMap_Param_t *>(args);
+    if (param.m_rgba)
+      remapRGBa(param.m_offset, param.m_weights, param.m_src, param.m_width, param.m_dst,
+                begin * param.m_width, end * param.m_width);
+    else
+      remapGrey(param.m_offset, param.m_weights, param.m_src, param.m_width, param.m_dst,
+                begin * param.m_width, end * param.m_width);
+  }
+
+  /*
+    Remap the image, the rows being shared between the threads of
+    vpThreadPool.
+  */
+  void remapImage(const int *offset, const short *weights, const unsigned char *src, unsigned char *dst,
+                  unsigned int width, unsigned int height, unsigned int nbThreads, bool rgba)
+  {
+    vpUndistortMap_Param_t param;
+    param.m_offset = offset;
+    param.m_weights = weights;
+    param.m_src = src;
+    param.m_dst = dst;
+    param.m_width = width;
+    param.m_rgba = rgba;
+
+    vpThreadPool::parallel_for(0, height, remapRows, &param, nbThreads, 8);
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor. The table is empty until init() is called.
+*/
+vpUndistortMap::vpUndistortMap()
+  : m_width(0), m_height(0), m_direction(UNDISTORT), m_identity(true), m_nbThreads(1), m_offset(), m_weights()
+{
+}
+
+/*!
+  Build a remap table for images of size \e width x \e height acquired by a
+  camera with parameters \e cam.
+
+  \sa init()
+*/
+vpUndistortMap::vpUndistortMap(const vpCameraParameters &cam, unsigned int width, unsigned int height,
+                               const vpMapDirectionType &direction)
+  : m_width(0), m_height(0), m_direction(UNDISTORT), m_identity(true), m_nbThreads(1), m_offset(), m_weights()
+{
+  init(cam, width, height, direction);
+}
+
+/*!
+  Build the remap table. For each pixel \f$(u,v)\f$ of the output image, the
+  location of the source pixel is
+  \f[ u_s = u_0 + (u - u_0)(1 + k \, r^2), \quad v_s = v_0 + (v - v_0)(1 + k \, r^2) \f]
+  with \f$ r^2 = ((u - u_0)/p_x)^2 + ((v - v_0)/p_y)^2 \f$ and \f$ k \f$ either
+  \f$ k_{ud} \f$ or \f$ k_{du} \f$ depending on \e direction. The offset of the
+  top-left neighbour and the four bilinear weights of each output pixel are
+  stored.
+
+  \param cam : Camera parameters. When the projection model has no distortion
+  remap() simply copies the input image.
+  \param width, height : Size of the images to remap.
+  \param direction : vpUndistortMap::UNDISTORT to remove the distortion,
+  vpUndistortMap::DISTORT to add it.
+*/
+void vpUndistortMap::init(const vpCameraParameters &cam, unsigned int width, unsigned int height,
+                          const vpMapDirectionType &direction)
+{
+  m_width = width;
+  m_height = height;
+  m_direction = direction;
+
+  double k = (direction == UNDISTORT) ? cam.get_kud() : cam.get_kdu();
+  m_identity = (cam.get_projModel() == vpCameraParameters::perspectiveProjWithoutDistortion)
+      || (std::fabs(k) <= std::numeric_limits<double>::epsilon());
+
+  if (m_identity || width < 2 || height < 2) {
+    m_offset.clear();
+    m_weights.clear();
+    return;
+  }
+
+  double u0 = cam.get_u0();
+  double v0 = cam.get_v0();
+  double k_px2 = k / (cam.get_px() * cam.get_px());
+  double k_py2 = k / (cam.get_py() * cam.get_py());
+
+  m_offset.resize(width * height);
+  m_weights.resize(4 * width * height);
+
+  unsigned int index = 0;
+  for (unsigned int v = 0; v < height; v++) {
+    double deltav = v - v0;
+    double fr1 = 1.0 + k_py2 * deltav * deltav;
+
+    for (unsigned int u = 0; u < width; u++, index++) {
+      double deltau = u - u0;
+      double fr2 = fr1 + k_px2 * deltau * deltau;
+
+      double u_src = deltau * fr2 + u0;
+      double v_src = deltav * fr2 + v0;
+
+      int u_round = (int) floor(u_src);
+      int v_round = (int) floor(v_src);
+      short *w = &m_weights[4*index];
+
+      if ( (0 <= u_round) && (0 <= v_round) &&
+           (u_round < ((int)width - 1)) && (v_round < ((int)height - 1)) ) {
+        double du = u_src - u_round;
+        double dv = v_src - v_round;
+        int w01 = vpMath::round(du * (1 - dv) * vpUndistortMap_WEIGHT_ONE);
+        int w10 = vpMath::round((1 - du) * dv * vpUndistortMap_WEIGHT_ONE);
+        int w11 = vpMath::round(du * dv * vpUndistortMap_WEIGHT_ONE);
+        m_offset[index] = v_round * (int)width + u_round;
+        // The weights sum exactly to one so that uniform areas are preserved
+        w[0] = (short) (vpUndistortMap_WEIGHT_ONE - w01 - w10 - w11);
+        w[1] = (short) w01;
+        w[2] = (short) w10;
+        w[3] = (short) w11;
+      }
+      else {
+        // Null weights on a valid location produce a black pixel without any test in remap()
+        m_offset[index] = 0;
+        w[0] = w[1] = w[2] = w[3] = 0;
+      }
+    }
+  }
+}
+
+/*!
+  Remap a grey level image.
+
+  \param I : Input image. Its size should be the one given to init().
+  \param Iremap : Output image, resized if needed.
+
+  \exception vpException::dimensionError : If the size of \e I doesn't match
+  the size of the table.
+*/
+void vpUndistortMap::remap(const vpImage<unsigned char> &I, vpImage<unsigned char> &Iremap) const
+{
+  if (I.getWidth() != m_width || I.getHeight() != m_height) {
+    throw(vpException(vpException::dimensionError,
+                      "Cannot remap a (%dx%d) image with a (%dx%d) undistortion table",
+                      I.getWidth(), I.getHeight(), m_width, m_height));
+  }
+
+  if (m_identity || m_offset.empty()) {
+    Iremap = I;
+    return;
+  }
+
+  Iremap.resize(m_height, m_width);
+  remapImage(&m_offset[0], &m_weights[0], I.bitmap, Iremap.bitmap, m_width, m_height, m_nbThreads, false);
+}
+
+/*!
+  Remap a color image. All the channels, including alpha, are interpolated.
+
+  \param I : Input image. Its size should be the one given to init().
+  \param Iremap : Output image, resized if needed.
+
+  \exception vpException::dimensionError : If the size of \e I doesn't match
+  the size of the table.
+*/
+void vpUndistortMap::remap(const vpImage<vpRGBa> &I, vpImage<vpRGBa> &Iremap) const
+{
+  if (I.getWidth() != m_width || I.getHeight() != m_height) {
+    throw(vpException(vpException::dimensionError,
+                      "Cannot remap a (%dx%d) image with a (%dx%d) undistortion table",
+                      I.getWidth(), I.getHeight(), m_width, m_height));
+  }
+
+  if (m_identity || m_offset.empty()) {
+    Iremap = I;
+    return;
+  }
+
+  Iremap.resize(m_height, m_width);
+  remapImage(&m_offset[0], &m_weights[0], (const unsigned char *) I.bitmap, (unsigned char *) Iremap.bitmap,
+             m_width, m_height, m_nbThreads, true);
+}
+
+/*!
+  Set the number of threads used by remap(). The rows are shared between
+  threads of vpThreadPool, whose number is also limited by
+  vpThreadPool::getNbThreads(). Without thread support, the value is
+  ignored.
+
+  \param nbThreads : Number of threads, at least 1.
+*/
+void vpUndistortMap::setNbThreads(unsigned int nbThreads)
+{
+  m_nbThreads = (nbThreads < 1) ? 1 : nbThreads;
+}
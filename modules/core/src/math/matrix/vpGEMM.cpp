@@ -0,0 +1,358 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Cache-blocked matrix multiplication kernel.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpGEMM.cpp
+  \brief Cache-blocked, register-tiled kernel used by vpMatrix products and vpGEMM().
+*/
+
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include <visp3/core/vpGEMM.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+#if defined __AVX__
+#  include <immintrin.h>
+#  define VISP_HAVE_AVX 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Register tile computed by the micro-kernel (MR rows by NR columns).
+  const unsigned int vpGEMM_MR = 4;
+  const unsigned int vpGEMM_NR = 4;
+  // Cache blocks: a MC x KC panel of A lives in L2, a KC x NR sliver of B in L1.
+  const unsigned int vpGEMM_MC = 128;
+  const unsigned int vpGEMM_KC = 256;
+  const unsigned int vpGEMM_NC = 1024;
+  // Below this size in any dimension, packing costs more than it saves.
+  const unsigned int vpGEMM_SMALL_SIZE = 16;
+
+  /*
+    Copy a mc x kc block of op(A) in row slivers of vpGEMM_MR rows. Inside a
+    sliver, the vpGEMM_MR values of a given column are contiguous. Slivers
+    are padded with zeros.
+  */
+  void packA(unsigned int mc, unsigned int kc, const double *A, unsigned int rsA, unsigned int csA, double *buf)
+  {
+    for (unsigned int i0 = 0; i0 < mc; i0 += vpGEMM_MR) {
+      unsigned int ib = std::min(vpGEMM_MR, mc - i0);
+      const double *a = A + i0*rsA;
+      for (unsigned int k = 0; k < kc; k++) {
+        unsigned int i = 0;
+        for (; i < ib; i++)
+          *buf++ = a[i*rsA + k*csA];
+        for (; i < vpGEMM_MR; i++)
+          *buf++ = 0.;
+      }
+    }
+  }
+
+  /*
+    Copy a kc x nc block of op(B) in column slivers of vpGEMM_NR columns.
+    Inside a sliver, the vpGEMM_NR values of a given row are contiguous.
+    Slivers are padded with zeros.
+  */
+  void packB(unsigned int kc, unsigned int nc, const double *B, unsigned int rsB, unsigned int csB, double *buf)
+  {
+    for (unsigned int j0 = 0; j0 < nc; j0 += vpGEMM_NR) {
+      unsigned int jb = std::min(vpGEMM_NR, nc - j0);
+      const double *b = B + j0*csB;
+      for (unsigned int k = 0; k < kc; k++) {
+        unsigned int j = 0;
+        for (; j < jb; j++)
+          *buf++ = b[k*rsB + j*csB];
+        for (; j < vpGEMM_NR; j++)
+          *buf++ = 0.;
+      }
+    }
+  }
+
+  /*
+    Compute the vpGEMM_MR x vpGEMM_NR product of a packed A sliver by a
+    packed B sliver over kc and store it row-major in ab.
+  */
+  void microKernel(unsigned int kc, const double *a, const double *b, double *ab)
+  {
+#if VISP_HAVE_AVX
+    __m256d c0 = _mm256_setzero_pd();
+    __m256d c1 = _mm256_setzero_pd();
+    __m256d c2 = _mm256_setzero_pd();
+    __m256d c3 = _mm256_setzero_pd();
+    for (unsigned int k = 0; k < kc; k++) {
+      __m256d bk = _mm256_loadu_pd(b);
+      c0 = _mm256_add_pd(c0, _mm256_mul_pd(_mm256_broadcast_sd(a    ), bk));
+      c1 = _mm256_add_pd(c1, _mm256_mul_pd(_mm256_broadcast_sd(a + 1), bk));
+      c2 = _mm256_add_pd(c2, _mm256_mul_pd(_mm256_broadcast_sd(a + 2), bk));
+      c3 = _mm256_add_pd(c3, _mm256_mul_pd(_mm256_broadcast_sd(a + 3), bk));
+      a += vpGEMM_MR;
+      b += vpGEMM_NR;
+    }
+    _mm256_storeu_pd(ab     , c0);
+    _mm256_storeu_pd(ab +  4, c1);
+    _mm256_storeu_pd(ab +  8, c2);
+    _mm256_storeu_pd(ab + 12, c3);
+#elif VISP_HAVE_SSE2
+    __m128d c00 = _mm_setzero_pd(), c01 = _mm_setzero_pd();
+    __m128d c10 = _mm_setzero_pd(), c11 = _mm_setzero_pd();
+    __m128d c20 = _mm_setzero_pd(), c21 = _mm_setzero_pd();
+    __m128d c30 = _mm_setzero_pd(), c31 = _mm_setzero_pd();
+    for (unsigned int k = 0; k < kc; k++) {
+      __m128d b0 = _mm_loadu_pd(b);
+      __m128d b1 = _mm_loadu_pd(b + 2);
+      __m128d ai = _mm_load1_pd(a);
+      c00 = _mm_add_pd(c00, _mm_mul_pd(ai, b0));
+      c01 = _mm_add_pd(c01, _mm_mul_pd(ai, b1));
+      ai = _mm_load1_pd(a + 1);
+      c10 = _mm_add_pd(c10, _mm_mul_pd(ai, b0));
+      c11 = _mm_add_pd(c11, _mm_mul_pd(ai, b1));
+      ai = _mm_load1_pd(a + 2);
+      c20 = _mm_add_pd(c20, _mm_mul_pd(ai, b0));
+      c21 = _mm_add_pd(c21, _mm_mul_pd(ai, b1));
+      ai = _mm_load1_pd(a + 3);
+      c30 = _mm_add_pd(c30, _mm_mul_pd(ai, b0));
+      c31 = _mm_add_pd(c31, _mm_mul_pd(ai, b1));
+      a += vpGEMM_MR;
+      b += vpGEMM_NR;
+    }
+    _mm_storeu_pd(ab     , c00); _mm_storeu_pd(ab +  2, c01);
+    _mm_storeu_pd(ab +  4, c10); _mm_storeu_pd(ab +  6, c11);
+    _mm_storeu_pd(ab +  8, c20); _mm_storeu_pd(ab + 10, c21);
+    _mm_storeu_pd(ab + 12, c30); _mm_storeu_pd(ab + 14, c31);
+#else
+    for (unsigned int i = 0; i < vpGEMM_MR*vpGEMM_NR; i++)
+      ab[i] = 0.;
+    for (unsigned int k = 0; k < kc; k++) {
+      for (unsigned int i = 0; i < vpGEMM_MR; i++) {
+        double ai = a[i];
+        for (unsigned int j = 0; j < vpGEMM_NR; j++)
+          ab[i*vpGEMM_NR + j] += ai * b[j];
+      }
+      a += vpGEMM_MR;
+      b += vpGEMM_NR;
+    }
+#endif
+  }
+
+  /*
+    Compute a R x S tile of C directly from unpacked operands. R and S being
+    known at compile time, the accumulators are kept in registers.
+  */
+  template<unsigned int R, unsigned int S>
+  void smallTile(unsigned int K, double alpha,
+                 const double *A, unsigned int rsA, unsigned int csA,
+                 const double *B, unsigned int rsB, unsigned int csB,
+                 double *C, unsigned int ldc)
+  {
+    double acc[R][S];
+    for (unsigned int r = 0; r < R; r++)
+      for (unsigned int s = 0; s < S; s++)
+        acc[r][s] = 0.;
+
+    for (unsigned int k = 0; k < K; k++, A += csA, B += rsB) {
+      double a[R], b[S];
+      for (unsigned int r = 0; r < R; r++)
+        a[r] = A[r*rsA];
+      for (unsigned int s = 0; s < S; s++)
+        b[s] = B[s*csB];
+      for (unsigned int r = 0; r < R; r++)
+        for (unsigned int s = 0; s < S; s++)
+          acc[r][s] += a[r] * b[s];
+    }
+
+    for (unsigned int r = 0; r < R; r++)
+      for (unsigned int s = 0; s < S; s++)
+        C[r*ldc + s] += alpha * acc[r][s];
+  }
+
+  typedef void (*vpGEMMTileFunction)(unsigned int, double, const double *, unsigned int, unsigned int,
+                                     const double *, unsigned int, unsigned int, double *, unsigned int);
+
+  /*
+    Unpacked product used when one of the dimensions is too small for the
+    packing to pay off (typically the N x 6 Jacobians). When \e upper is
+    true, tiles lying strictly below the diagonal of C are not computed.
+  */
+  void smallGEMM(unsigned int M, unsigned int N, unsigned int K, double alpha,
+                 const double *A, unsigned int rsA, unsigned int csA,
+                 const double *B, unsigned int rsB, unsigned int csB,
+                 double *C, unsigned int ldc, bool upper)
+  {
+    static const vpGEMMTileFunction tiles[vpGEMM_MR][vpGEMM_NR] = {
+      { smallTile<1,1>, smallTile<1,2>, smallTile<1,3>, smallTile<1,4> },
+      { smallTile<2,1>, smallTile<2,2>, smallTile<2,3>, smallTile<2,4> },
+      { smallTile<3,1>, smallTile<3,2>, smallTile<3,3>, smallTile<3,4> },
+      { smallTile<4,1>, smallTile<4,2>, smallTile<4,3>, smallTile<4,4> }
+    };
+
+    for (unsigned int i = 0; i < M; i += vpGEMM_MR) {
+      unsigned int mr = std::min(vpGEMM_MR, M - i);
+      for (unsigned int j = 0; j < N; j += vpGEMM_NR) {
+        unsigned int nr = std::min(vpGEMM_NR, N - j);
+        if (upper && j + nr <= i)
+          continue;
+        tiles[mr-1][nr-1](K, alpha, A + i*rsA, rsA, csA, B + j*csB, rsB, csB, C + i*ldc + j, ldc);
+      }
+    }
+  }
+
+  /*
+    Packed product used for large matrices. When \e upper is true, tiles
+    lying strictly below the diagonal of C are not computed.
+  */
+  void blockedGEMM(unsigned int M, unsigned int N, unsigned int K, double alpha,
+                   const double *A, unsigned int rsA, unsigned int csA,
+                   const double *B, unsigned int rsB, unsigned int csB,
+                   double *C, unsigned int ldc, bool upper)
+  {
+    unsigned int mcMax = std::min(M, vpGEMM_MC);
+    unsigned int ncMax = std::min(N, vpGEMM_NC);
+    unsigned int kcMax = std::min(K, vpGEMM_KC);
+    std::vector<double> bufA(((mcMax + vpGEMM_MR - 1) / vpGEMM_MR) * vpGEMM_MR * kcMax);
+    std::vector<double> bufB(((ncMax + vpGEMM_NR - 1) / vpGEMM_NR) * vpGEMM_NR * kcMax);
+    double ab[vpGEMM_MR*vpGEMM_NR];
+
+    for (unsigned int jc = 0; jc < N; jc += vpGEMM_NC) {
+      unsigned int nc = std::min(vpGEMM_NC, N - jc);
+      for (unsigned int pc = 0; pc < K; pc += vpGEMM_KC) {
+        unsigned int kc = std::min(vpGEMM_KC, K - pc);
+        packB(kc, nc, B + pc*rsB + jc*csB, rsB, csB, &bufB[0]);
+
+        for (unsigned int ic = 0; ic < M; ic += vpGEMM_MC) {
+          unsigned int mc = std::min(vpGEMM_MC, M - ic);
+          packA(mc, kc, A + ic*rsA + pc*csA, rsA, csA, &bufA[0]);
+
+          for (unsigned int jr = 0; jr < nc; jr += vpGEMM_NR) {
+            unsigned int nr = std::min(vpGEMM_NR, nc - jr);
+            const double *b = &bufB[0] + jr*kc;
+            for (unsigned int ir = 0; ir < mc; ir += vpGEMM_MR) {
+              unsigned int mr = std::min(vpGEMM_MR, mc - ir);
+              if (upper && jc + jr + nr <= ic + ir)
+                continue;
+              microKernel(kc, &bufA[0] + ir*kc, b, ab);
+
+              double *c = C + (ic + ir)*ldc + jc + jr;
+              for (unsigned int i = 0; i < mr; i++, c += ldc)
+                for (unsigned int j = 0; j < nr; j++)
+                  c[j] += alpha * ab[i*vpGEMM_NR + j];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  void dispatchGEMM(unsigned int M, unsigned int N, unsigned int K, double alpha,
+                    const double *A, unsigned int rsA, unsigned int csA,
+                    const double *B, unsigned int rsB, unsigned int csB,
+                    double *C, unsigned int ldc, bool upper)
+  {
+    if (M == 0 || N == 0 || K == 0)
+      return;
+
+    if (M < vpGEMM_SMALL_SIZE || N < vpGEMM_SMALL_SIZE || K < vpGEMM_SMALL_SIZE)
+      smallGEMM(M, N, K, alpha, A, rsA, csA, B, rsB, csB, C, ldc, upper);
+    else
+      blockedGEMM(M, N, K, alpha, A, rsA, csA, B, rsB, csB, C, ldc, upper);
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Low level kernel behind vpMatrix products and vpGEMM(). It computes
+  \f$ C = C + \alpha \; op(A) \; op(B) \f$ where \f$ op(A) \f$ is a M-by-K
+  matrix, \f$ op(B) \f$ a K-by-N matrix and \f$ C \f$ a M-by-N row-major
+  matrix.
+
+  Operands are described by a pointer on their first element and two strides:
+  element \f$(i,k)\f$ of \f$ op(A) \f$ is located at \e A[i*rsA + k*csA].
+  A row-major matrix A is thus given with \e rsA = cols and \e csA = 1, while
+  its transpose is obtained with \e rsA = 1 and \e csA = cols.
+
+  Large products are split in cache blocks; the blocks of op(A) and op(B) are
+  packed in contiguous slivers that are multiplied by a register-tiled SSE2
+  (or AVX when enabled at compile time) micro-kernel. Products with a
+  dimension smaller than 16 skip the packing and are computed by register
+  tiles directly on the operands.
+
+  \param M, N, K : Sizes of the product.
+  \param alpha : Scale factor applied to the product.
+  \param A, rsA, csA : First operand and its row and column strides.
+  \param B, rsB, csB : Second operand and its row and column strides.
+  \param C : Result, accumulated in place. It should not overlap A or B.
+  \param ldc : Row stride of C.
+
+  \relates vpArray2D
+*/
+void vpGEMMKernel(unsigned int M, unsigned int N, unsigned int K, double alpha,
+                  const double *A, unsigned int rsA, unsigned int csA,
+                  const double *B, unsigned int rsB, unsigned int csB,
+                  double *C, unsigned int ldc)
+{
+  dispatchGEMM(M, N, K, alpha, A, rsA, csA, B, rsB, csB, C, ldc, false);
+}
+
+/*!
+  Symmetric rank-k update behind vpMatrix::AtA() and vpMatrix::AAt(). It
+  computes \f$ C = C + \alpha \; op(A) \; op(A)^T \f$ where \f$ op(A) \f$
+  is a N-by-K matrix described as in vpGEMMKernel(), and \f$ C \f$ a N-by-N
+  row-major symmetric matrix.
+
+  Only the tiles of the upper triangle are computed, the lower triangle is
+  then copied from the upper one.
+
+  \param N, K : Sizes of op(A).
+  \param alpha : Scale factor applied to the product.
+  \param A, rsA, csA : Operand and its row and column strides.
+  \param C : Result, accumulated in place. It should be symmetric and should
+  not overlap A.
+  \param ldc : Row stride of C.
+
+  \relates vpArray2D
+*/
+void vpSYRKKernel(unsigned int N, unsigned int K, double alpha,
+                  const double *A, unsigned int rsA, unsigned int csA,
+                  double *C, unsigned int ldc)
+{
+  dispatchGEMM(N, N, K, alpha, A, rsA, csA, A, csA, rsA, C, ldc, true);
+
+  for (unsigned int i = 1; i < N; i++)
+    for (unsigned int j = 0; j < i; j++)
+      C[i*ldc + j] = C[j*ldc + i];
+}
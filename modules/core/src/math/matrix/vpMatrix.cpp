@@ -56,12 +56,18 @@
 
 #include <visp3/core/vpConfig.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
 #ifdef VISP_HAVE_GSL
 #  include <gsl/gsl_linalg.h>
 #endif
 
 #include <visp3/core/vpMatrix.h>
 #include <visp3/core/vpMath.h>
+#include <visp3/core/vpGEMM.h>
 #include <visp3/core/vpTranslationVector.h>
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpException.h>
@@ -427,22 +433,9 @@ void vpMatrix::AAt(vpMatrix &B) const
 {
   if ((B.rowNum != rowNum) || (B.colNum != rowNum)) B.resize(rowNum,rowNum);
 
-  // compute A*A^T
-  for(unsigned int i=0;i<rowNum;i++){
-    for(unsigned int j=i;j<rowNum;j++){
-      double *pi = rowPtrs[i];// row i
-      double *pj = rowPtrs[j];// row j
-
-      // sum (row i .* row j)
-      double ssum=0;
-      for(unsigned int k=0; k < colNum ;k++)
-        ssum += *(pi++)* *(pj++);
-
-      B[i][j]=ssum; //upper triangle
-      if(i!=j)
-        B[j][i]=ssum; //lower triangle
-    }
-  }
+  // compute A*A^T, only the upper triangle is computed and then mirrored
+  B = 0.0;
+  vpSYRKKernel(rowNum, colNum, 1.0, data, colNum, 1, B.data, rowNum);
 }
 
 /*!
@@ -460,33 +453,9 @@ void vpMatrix::AtA(vpMatrix &B) const
 {
   if ((B.rowNum != colNum) || (B.colNum != colNum)) B.resize(colNum,colNum);
 
-  unsigned int i,j,k;
-  double s;
-  double *ptr;
-  for (i=0;i<colNum;i++)
-  {
-    double *Bi = B[i] ;
-    for (j=0;j<i;j++)
-    {
-      ptr=data;
-      s = 0 ;
-      for (k=0;k<rowNum;k++)
-      {
-        s +=(*(ptr+i)) * (*(ptr+j));
-        ptr+=colNum;
-      }
-      *Bi++ = s ;
-      B[j][i] = s;
-    }
-    ptr=data;
-    s = 0 ;
-    for (k=0;k<rowNum;k++)
-    {
-      s +=(*(ptr+i)) * (*(ptr+i));
-      ptr+=colNum;
-    }
-    *Bi = s;
-  }
+  // compute A^T*A, only the upper triangle is computed and then mirrored
+  B = 0.0;
+  vpSYRKKernel(colNum, rowNum, 1.0, data, 1, colNum, B.data, colNum);
 }
 
 
@@ -720,12 +689,28 @@ void vpMatrix::multMatrixVector(const vpMatrix &A, const vpColVector &v, vpColVe
 
   if (A.rowNum != w.rowNum) w.resize(A.rowNum);
 
-  w = 0.0;
-  for (unsigned int j=0;j<A.colNum;j++) {
-    double vj = v[j] ; // optimization em 5/12/2006
-    for (unsigned int i=0;i<A.rowNum;i++) {
-      w[i]+=A.rowPtrs[i][j] * vj;
+  // Walk A row by row to keep memory accesses contiguous
+  for (unsigned int i=0;i<A.rowNum;i++) {
+    const double *ai = A.rowPtrs[i];
+    unsigned int j = 0;
+    double s = 0.0;
+
+#if VISP_HAVE_SSE2
+    if (A.colNum >= 4) {
+      __m128d v_sum0 = _mm_setzero_pd(), v_sum1 = _mm_setzero_pd();
+      for (; j <= A.colNum - 4; j+=4) {
+        v_sum0 = _mm_add_pd(v_sum0, _mm_mul_pd(_mm_loadu_pd(ai + j), _mm_loadu_pd(v.data + j)));
+        v_sum1 = _mm_add_pd(v_sum1, _mm_mul_pd(_mm_loadu_pd(ai + j + 2), _mm_loadu_pd(v.data + j + 2)));
+      }
+      double res[2];
+      _mm_storeu_pd(res, _mm_add_pd(v_sum0, v_sum1));
+      s = res[0] + res[1];
     }
+#endif
+
+    for (; j<A.colNum;j++)
+      s += ai[j] * v.data[j];
+    w[i] = s;
   }
 }
 
@@ -752,22 +737,8 @@ void vpMatrix::mult2Matrices(const vpMatrix &A, const vpMatrix &B, vpMatrix &C)
                       A.getRows(), A.getCols(), B.getRows(), B.getCols()));
   }
 
-  // 5/12/06 some "very" simple optimization to avoid indexation
-  unsigned int BcolNum = B.colNum;
-  unsigned int BrowNum = B.rowNum;
-  unsigned int i,j,k;
-  double **BrowPtrs = B.rowPtrs;
-  for (i=0;i<A.rowNum;i++)
-  {
-    double *rowptri = A.rowPtrs[i];
-    double *ci = C[i];
-    for (j=0;j<BcolNum;j++)
-    {
-      double s = 0;
-      for (k=0;k<BrowNum;k++) s += rowptri[k] * BrowPtrs[k][j];
-      ci[j] = s;
-    }
-  }
+  C = 0.0;
+  vpGEMMKernel(A.rowNum, B.colNum, A.colNum, 1.0, A.data, A.colNum, 1, B.data, B.colNum, 1, C.data, C.colNum);
 }
 
 /*!
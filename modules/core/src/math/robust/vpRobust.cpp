@@ -53,11 +53,142 @@
 #include <stdlib.h>
 #include <cmath>    // std::fabs
 #include <limits>   // numeric_limits
+#include <algorithm> // std::nth_element
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
 
 #define vpITMAX 100
 #define vpEPS 3.0e-7
 #define vpCST 1
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Select in place the value of rank ceil(n/2)-1, as select() does
+  double selectMedian(double *data, const unsigned int n)
+  {
+    if (n == 0)
+      return 0;
+
+    unsigned int ind_med = (unsigned int)(ceil(n/2.0))-1;
+    std::nth_element(data, data + ind_med, data + n);
+    return data[ind_med];
+  }
+
+  // Absolute deviation of the residues from their median
+  void absoluteDeviation(const double *x, const double med, double *normres, const unsigned int n)
+  {
+    unsigned int i = 0;
+#if VISP_HAVE_SSE2
+    const __m128d v_med = _mm_set1_pd(med);
+    const __m128d v_sign = _mm_set1_pd(-0.0);
+    for (; i + 2 <= n; i += 2) {
+      _mm_storeu_pd(normres + i, _mm_andnot_pd(v_sign, _mm_sub_pd(_mm_loadu_pd(x + i), v_med)));
+    }
+#endif
+    for (; i < n; i++) {
+      normres[i] = fabs(x[i] - med);
+    }
+  }
+
+  // The following weight functions are computed with the same operations with and
+  // without SSE2, so that both give the same weights
+  void weightsTukey(const double sig, const double *x, double *weights, const unsigned int n)
+  {
+    const double cst_const = vpCST*4.6851;
+    const double eps = std::numeric_limits<double>::epsilon();
+
+    if (std::fabs(sig) <= eps) {
+      for (unsigned int i = 0; i < n; i++) {
+        weights[i] = (std::fabs(weights[i]) > eps) ? 1 : 0;
+      }
+      return;
+    }
+
+    unsigned int i = 0;
+#if VISP_HAVE_SSE2
+    const __m128d v_sig = _mm_set1_pd(sig);
+    const __m128d v_cst = _mm_set1_pd(cst_const);
+    const __m128d v_one = _mm_set1_pd(1.0);
+    const __m128d v_eps = _mm_set1_pd(eps);
+    const __m128d v_sign = _mm_set1_pd(-0.0);
+    for (; i + 2 <= n; i += 2) {
+      __m128d v_xi_sig = _mm_div_pd(_mm_loadu_pd(x + i), v_sig);
+      __m128d v_inlier = _mm_and_pd(_mm_cmple_pd(_mm_andnot_pd(v_sign, v_xi_sig), v_cst),
+                                    _mm_cmpgt_pd(_mm_andnot_pd(v_sign, _mm_loadu_pd(weights + i)), v_eps));
+      __m128d v_ratio = _mm_div_pd(v_xi_sig, v_cst);
+      __m128d v_w = _mm_sub_pd(v_one, _mm_mul_pd(v_ratio, v_ratio));
+      _mm_storeu_pd(weights + i, _mm_and_pd(v_inlier, _mm_mul_pd(v_w, v_w)));
+    }
+#endif
+    for (; i < n; i++) {
+      double xi_sig = x[i]/sig;
+
+      if ((std::fabs(xi_sig)<=(cst_const)) && std::fabs(weights[i]) > eps) {
+        weights[i] = vpMath::sqr(1-vpMath::sqr(xi_sig/cst_const));
+      }
+      else {
+        //Outlier - could resize list of points tracked here?
+        weights[i] = 0;
+      }
+    }
+  }
+
+  void weightsHuber(const double sig, const double *x, double *weights, const unsigned int n)
+  {
+    const double c = 1.2107; //1.345;
+    const double eps = std::numeric_limits<double>::epsilon();
+
+    unsigned int i = 0;
+#if VISP_HAVE_SSE2
+    const __m128d v_sig = _mm_set1_pd(sig);
+    const __m128d v_c = _mm_set1_pd(c);
+    const __m128d v_one = _mm_set1_pd(1.0);
+    const __m128d v_eps = _mm_set1_pd(eps);
+    const __m128d v_sign = _mm_set1_pd(-0.0);
+    for (; i + 2 <= n; i += 2) {
+      __m128d v_abs = _mm_andnot_pd(v_sign, _mm_div_pd(_mm_loadu_pd(x + i), v_sig));
+      __m128d v_w = _mm_loadu_pd(weights + i);
+      __m128d v_inlier = _mm_cmple_pd(v_abs, v_c);
+      __m128d v_huber = _mm_or_pd(_mm_and_pd(v_inlier, v_one), _mm_andnot_pd(v_inlier, _mm_div_pd(v_c, v_abs)));
+      // Keep the null weights of the rejected residues
+      __m128d v_kept = _mm_cmpgt_pd(_mm_andnot_pd(v_sign, v_w), v_eps);
+      _mm_storeu_pd(weights + i, _mm_or_pd(_mm_and_pd(v_kept, v_huber), _mm_andnot_pd(v_kept, v_w)));
+    }
+#endif
+    for (; i < n; i++) {
+      if (std::fabs(weights[i]) > eps) {
+        double xi_sig = x[i]/sig;
+        if (fabs(xi_sig)<=c)
+          weights[i] = 1;
+        else
+          weights[i] = c/fabs(xi_sig);
+      }
+    }
+  }
+
+  void weightsCauchy(const double sig, const double *x, double *weights, const unsigned int n)
+  {
+    const double const_sig = 2.3849*sig;
+
+    unsigned int i = 0;
+#if VISP_HAVE_SSE2
+    const __m128d v_const_sig = _mm_set1_pd(const_sig);
+    const __m128d v_one = _mm_set1_pd(1.0);
+    for (; i + 2 <= n; i += 2) {
+      __m128d v_ratio = _mm_div_pd(_mm_loadu_pd(x + i), v_const_sig);
+      _mm_storeu_pd(weights + i, _mm_div_pd(v_one, _mm_add_pd(v_one, _mm_mul_pd(v_ratio, v_ratio))));
+    }
+#endif
+    for (; i < n; i++) {
+      weights[i] = 1/(1+vpMath::sqr(x[i]/(const_sig)));
+    }
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 
 // ===================================================================
 /*!
@@ -142,6 +273,14 @@ void vpRobust::resize(unsigned int n_data){
   
 }
 
+// Grow the containers without shrinking them, so that they are reused from one call to the other
+void vpRobust::reserve(unsigned int n_data)
+{
+  if (n_data > size) {
+    resize(n_data);
+  }
+}
+
 // ===================================================================
 /*!
 
@@ -183,74 +322,109 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
 		     const vpColVector &residues,
 		     vpColVector &weights)
 {
+  unsigned int n_data = residues.getRows();
+  reserve(n_data);
 
-  double med=0;	// median
-  double normmedian=0; 	// Normalized median
-  double sigma=0;// Standard Deviation
+  computeWeights(method, residues.data, n_data, NoiseThreshold, weights.data);
+}
 
-  // resize vector only if the size of residue vector has changed
-  unsigned int n_data = residues.getRows();
-  resize(n_data); 
-  
-  sorted_residues = residues;
-  
-  unsigned int ind_med = (unsigned int)(ceil(n_data/2.0))-1;
+/*!
+  Compute the weights of several blocks of residues in one call. Each block
+  gets its own scale estimate, as if MEstimator(const vpRobustEstimatorType, const vpColVector &, vpColVector &)
+  was called for each block with a vpRobust of its own, but the containers
+  are shared by the blocks.
 
-  // Calculate median
-  med = select(sorted_residues, 0, (int)n_data-1, (int)ind_med/*(int)n_data/2*/);
-   //residualMedian = med ;
+  \param method : Type of M-Estimator.
 
-  // Normalize residues
-  for(unsigned int i=0; i<n_data; i++)
-  {
-    normres[i] = (fabs(residues[i]- med));
-    sorted_normres[i] = (fabs(sorted_residues[i]- med));
+  \param residues : Residues of all the blocks, the residues of a block
+  following the residues of the previous one.
 
+  \param blockSizes : Number of residues of each block. Their sum must be the
+  size of \e residues.
+
+  \param noiseThresholds : Minimal scale estimate of each block, see
+  setThreshold(). If empty, the threshold set with setThreshold() is used for
+  all the blocks.
+
+  \param weights : Weights of the residues of all the blocks, with the same
+  size as \e residues. As for the other methods, a null weight on input is
+  kept null by the Tukey and Huber functions.
+*/
+void vpRobust::MEstimator(const vpRobustEstimatorType method,
+                          const vpColVector &residues,
+                          const std::vector<unsigned int> &blockSizes,
+                          const std::vector<double> &noiseThresholds,
+                          vpColVector &weights)
+{
+  if (! noiseThresholds.empty() && noiseThresholds.size() != blockSizes.size()) {
+    throw(vpException(vpException::dimensionError,
+                      "Cannot weight %d blocks of residues with %d noise thresholds",
+                      (int)blockSizes.size(), (int)noiseThresholds.size()));
+  }
+
+  unsigned int n_data = 0, max_block = 0;
+  for (size_t i = 0; i < blockSizes.size(); i++) {
+    n_data += blockSizes[i];
+    max_block = std::max(max_block, blockSizes[i]);
+  }
+  if (n_data != residues.getRows() || weights.getRows() != residues.getRows()) {
+    throw(vpException(vpException::dimensionError,
+                      "Cannot weight %d residues in blocks of %d residues with %d weights",
+                      residues.getRows(), n_data, weights.getRows()));
+  }
+
+  reserve(max_block);
+
+  unsigned int offset = 0;
+  for (size_t i = 0; i < blockSizes.size(); i++) {
+    computeWeights(method, residues.data + offset, blockSizes[i],
+                   noiseThresholds.empty() ? NoiseThreshold : noiseThresholds[i], weights.data + offset);
+    offset += blockSizes[i];
   }
+}
+
+// Compute the weights of n_data residues, the containers having at least n_data elements
+void vpRobust::computeWeights(const vpRobustEstimatorType method, const double *residues, const unsigned int n_data,
+                              const double noiseThreshold, double *weights)
+{
+  if (n_data == 0)
+    return;
+
+  // Calculate median
+  memcpy(sorted_residues.data, residues, n_data*sizeof(double));
+  double med = selectMedian(sorted_residues.data, n_data);
+
+  // Normalize residues
+  absoluteDeviation(residues, med, normres.data, n_data);
 
   // Calculate MAD
-  normmedian = select(sorted_normres, 0, (int)n_data-1, (int)ind_med/*(int)n_data/2*/);
-  //normalizedResidualMedian = normmedian ;
+  memcpy(sorted_normres.data, normres.data, n_data*sizeof(double));
+  double normmedian = selectMedian(sorted_normres.data, n_data);
   // 1.48 keeps scale estimate consistent for a normal probability dist.
-  sigma = 1.4826*normmedian; // median Absolute Deviation
+  double sigma = 1.4826*normmedian; // median Absolute Deviation
 
   // Set a minimum threshold for sigma
   // (when sigma reaches the level of noise in the image)
-  if(sigma < NoiseThreshold)
+  if(sigma < noiseThreshold)
   {
-    sigma= NoiseThreshold;
+    sigma= noiseThreshold;
   }
 
   switch (method)
   {
   case TUKEY :
-    {
-      psiTukey(sigma, normres,weights);
-
-      vpCDEBUG(2) << "Tukey's function computed" << std::endl;
-      break ;
-
-    }
+    weightsTukey(sigma, normres.data, weights, n_data);
+    break ;
   case CAUCHY :
-    {
-      psiCauchy(sigma, normres,weights);
-      break ;
-    }
-    /*  case MCLURE :
-    {
-      psiMcLure(sigma, normres);
-      break ;
-      }*/
+    weightsCauchy(sigma, normres.data, weights, n_data);
+    break ;
   case HUBER :
-    {
-      psiHuber(sigma, normres,weights);
-      break ;
-    }
+    weightsHuber(sigma, normres.data, weights, n_data);
+    break ;
   }
 }
 
 
-
 void vpRobust::MEstimator(const vpRobustEstimatorType method,
 		     const vpColVector &residues,
 		     const vpColVector& all_residues,
@@ -262,7 +436,9 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
   double sigma=0;// Standard Deviation
 
   unsigned int n_all_data = all_residues.getRows();
-  vpColVector all_normres(n_all_data); 
+  // normres is used as the normalized all_residues vector, and grows with it
+  reserve(std::max(n_all_data, residues.getRows()));
+  vpColVector &all_normres = normres;
 
   // compute median with the residues vector, return all_normres which are the normalized all_residues vector.
   normmedian = computeNormalizedMedian(all_normres,residues,all_residues,weights);
@@ -279,11 +455,12 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
   }
 
 
+  // all_normres may be larger than all_residues
   switch (method)
   {
   case TUKEY :
     {
-      psiTukey(sigma, all_normres,weights);
+      weightsTukey(sigma, all_normres.data, weights.data, n_all_data);
 
       vpCDEBUG(2) << "Tukey's function computed" << std::endl;
       break ;
@@ -291,7 +468,7 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
     }
   case CAUCHY :
     {
-      psiCauchy(sigma, all_normres,weights);
+      weightsCauchy(sigma, all_normres.data, weights.data, n_all_data);
       break ;
     }
     /*  case MCLURE :
@@ -301,7 +478,7 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
       }*/
   case HUBER :
     {
-      psiHuber(sigma, all_normres,weights);
+      weightsHuber(sigma, all_normres.data, weights.data, n_all_data);
       break ;
     }
 
@@ -322,60 +499,36 @@ double vpRobust::computeNormalizedMedian(vpColVector &all_normres,
 
   unsigned int n_all_data = all_residues.getRows();
   unsigned int n_data = residues.getRows();
-  
-  // resize vector only if the size of residue vector has changed
-  resize(n_data);
-    
-  sorted_residues = residues;
-  vpColVector no_null_weight_residues;
-  no_null_weight_residues.resize(n_data);
-  
-  //all_normres.resize(n_all_data); // Normalized Residue
-  //vpColVector sorted_normres(n_data); // Normalized Residue
-  //vpColVector sorted_residues = residues;
-  //vpColVector sorted_residues;
-  
 
+  // grow the vectors only if the size of residue vector has increased
+  reserve(n_data);
+
+  // Be careful to not use the rejected residues for the
+  // calculation.
   unsigned int index =0;
   for(unsigned int j=0;j<n_data;j++)
   {
     //if(weights[j]!=0)
     if(std::fabs(weights[j]) > std::numeric_limits<double>::epsilon())
     {
-      no_null_weight_residues[index]=residues[j];
+      sorted_residues[index]=residues[j];
       index++;
     }
   }
-  sorted_residues.resize(index);
-  memcpy(sorted_residues.data,no_null_weight_residues.data,index*sizeof(double));
   n_data=index;
 
   vpCDEBUG(2) << "vpRobust MEstimator reached. No. data = " << n_data
 	      << std::endl;
 
   // Calculate Median
-  // Be careful to not use the rejected residues for the
-  // calculation.
-  
-  unsigned int ind_med = (unsigned int)(ceil(n_data/2.0))-1;
-  med = select(sorted_residues, 0, (int)n_data-1, (int)ind_med/*(int)n_data/2*/);
+  med = selectMedian(sorted_residues.data, n_data);
 
-  unsigned int i;
   // Normalize residues
-  for(i=0; i<n_all_data; i++)
-  {
-    all_normres[i] = (fabs(all_residues[i]- med));
-  }
+  absoluteDeviation(all_residues.data, med, all_normres.data, n_all_data);
+  absoluteDeviation(sorted_residues.data, med, sorted_normres.data, n_data);
 
-  for(i=0; i<n_data; i++)
-  {
-    sorted_normres[i] = (fabs(sorted_residues[i]- med));
-  }
   // MAD calculated only on first iteration
-
-  //normmedian = Median(normres, weights);
-  //normmedian = Median(normres);
-  normmedian = select(sorted_normres, 0, (int)n_data-1, (int)ind_med/*(int)n_data/2*/);
+  normmedian = selectMedian(sorted_normres.data, n_data);
 
   return normmedian;
 }
@@ -672,33 +825,7 @@ vpRobust::simult_chi_huber(double x)
 
 void vpRobust::psiTukey(double sig, vpColVector &x, vpColVector & weights)
 {
-
-  unsigned int n_data = x.getRows();
-  double cst_const = vpCST*4.6851;
-
-  for(unsigned int i=0; i<n_data; i++)
-  {
-    //if(sig==0 && weights[i]!=0)
-    if(std::fabs(sig) <= std::numeric_limits<double>::epsilon() && std::fabs(weights[i]) > std::numeric_limits<double>::epsilon())
-    {
-      weights[i]=1;
-      continue;
-    }
-
-    double xi_sig = x[i]/sig;
-
-    //if((fabs(xi_sig)<=(cst_const)) && weights[i]!=0)
-    if((std::fabs(xi_sig)<=(cst_const)) && std::fabs(weights[i]) > std::numeric_limits<double>::epsilon())
-    {
-      weights[i] = vpMath::sqr(1-vpMath::sqr(xi_sig/cst_const));
-      //w[i] = vpMath::sqr(1-vpMath::sqr(x[i]/sig/4.7));
-    }
-    else
-    {
-      //Outlier - could resize list of points tracked here?
-      weights[i] = 0;
-    }
-  }
+  weightsTukey(sig, x.data, weights.data, x.getRows());
 }
 
 /*!
@@ -710,21 +837,7 @@ void vpRobust::psiTukey(double sig, vpColVector &x, vpColVector & weights)
 */
 void vpRobust::psiHuber(double sig, vpColVector &x, vpColVector &weights)
 {
-  double c = 1.2107; //1.345;
-  unsigned int n_data = x.getRows();
-
-  for(unsigned int i=0; i<n_data; i++)
-  {
-    //if(weights[i]!=0)
-    if(std::fabs(weights[i]) > std::numeric_limits<double>::epsilon())
-    {
-      double xi_sig = x[i]/sig;
-      if(fabs(xi_sig)<=c)
-	weights[i] = 1;
-      else
-	weights[i] = c/fabs(xi_sig);
-    }
-  }
+  weightsHuber(sig, x.data, weights.data, x.getRows());
 }
 
 /*!
@@ -737,27 +850,7 @@ void vpRobust::psiHuber(double sig, vpColVector &x, vpColVector &weights)
 
 void vpRobust::psiCauchy(double sig, vpColVector &x, vpColVector &weights)
 {
-  unsigned int n_data = x.getRows();
-  double const_sig = 2.3849*sig;
-
-  //Calculate Cauchy's equation
-  for(unsigned int i=0; i<n_data; i++)
-  {
-    weights[i] = 1/(1+vpMath::sqr(x[i]/(const_sig)));
-
-    // If one coordinate is an outlier the other is too!
-    // w[i] < 0.01 is a threshold to be set
-    /*if(w[i] < 0.01)
-      {
-      if(i%2 == 0)
-      {
-      w[i+1] = w[i];
-      i++;
-      }
-      else
-      w[i-1] = w[i];
-      }*/
-  }
+  weightsCauchy(sig, x.data, weights.data, x.getRows());
 }
 
 
@@ -86,7 +86,10 @@ vpExponentialMap::direct(const vpColVector &v, const double &delta_t)
   vpRotationMatrix rd ;
   vpTranslationVector dt ;
 
-  vpColVector v_dt = v * delta_t;
+  // Plain array rather than a vpColVector to avoid any heap allocation
+  double v_dt[6];
+  for (unsigned int i=0; i<6; i++)
+    v_dt[i] = v[i] * delta_t;
 
   u[0] = v_dt[3];
   u[1] = v_dt[4];
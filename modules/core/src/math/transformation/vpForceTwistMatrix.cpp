@@ -91,7 +91,7 @@ vpForceTwistMatrix::eye()
   Initialize a force/torque twist transformation matrix to identity.
 */
 vpForceTwistMatrix::vpForceTwistMatrix()
-  : vpArray2D<double>(6,6)
+  : vpArray2D<double>(6, 6, m_storage)
 {
   eye() ;
 }
@@ -104,7 +104,7 @@ vpForceTwistMatrix::vpForceTwistMatrix()
   \param F : Force/torque twist matrix used as initializer.
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpForceTwistMatrix &F)
-  : vpArray2D<double>(6,6)
+  : vpArray2D<double>(6, 6, m_storage)
 {
   *this = F ;
 }
@@ -134,7 +134,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpForceTwistMatrix &F)
 
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpHomogeneousMatrix &M)
-  : vpArray2D<double>(6,6)
+  : vpArray2D<double>(6, 6, m_storage)
 {
   buildFrom(M);
 }
@@ -151,7 +151,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpHomogeneousMatrix &M)
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t,
                                        const vpThetaUVector &thetau)
-  : vpArray2D<double>(6,6)
+  : vpArray2D<double>(6, 6, m_storage)
 {
   buildFrom(t, thetau) ;
 }
@@ -168,7 +168,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t,
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t,
                                        const vpRotationMatrix &R)
-  : vpArray2D<double>(6,6)
+  : vpArray2D<double>(6, 6, m_storage)
 {
   buildFrom(t, R) ;
 }
@@ -184,7 +184,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t,
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const double tx, const double ty, const double tz,
                                        const double tux, const double tuy, const double tuz)
-  : vpArray2D<double>(6,6)
+  : vpArray2D<double>(6, 6, m_storage)
 {
   vpTranslationVector T(tx,ty,tz) ;
   vpThetaUVector tu(tux,tuy,tuz) ;
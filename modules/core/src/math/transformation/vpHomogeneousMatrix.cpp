@@ -54,7 +54,7 @@
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
                                          const vpQuaternionVector &q)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(4, 4, m_storage)
 {
   buildFrom(t,q);
   (*this)[3][3] = 1.;
@@ -64,7 +64,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
   Default constructor that initialize an homogeneous matrix as identity.
 */
 vpHomogeneousMatrix::vpHomogeneousMatrix()
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(4, 4, m_storage)
 {
   eye() ;
 }
@@ -73,7 +73,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix()
   Copy constructor that initialize an homogeneous matrix from another homogeneous matrix.
 */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpHomogeneousMatrix &M)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(4, 4, m_storage)
 {
   *this = M;
 }
@@ -83,7 +83,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpHomogeneousMatrix &M)
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
                                          const vpThetaUVector &tu)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(4, 4, m_storage)
 {
   buildFrom(t, tu);
   (*this)[3][3] = 1.;
@@ -94,7 +94,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
                                          const vpRotationMatrix &R)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(4, 4, m_storage)
 {
   insert(R);
   insert(t);
@@ -105,7 +105,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
   Construct an homogeneous matrix from a pose vector.
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpPoseVector &p)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(4, 4, m_storage)
 {
   buildFrom(p[0], p[1], p[2], p[3], p[4], p[5]) ;
   (*this)[3][3] = 1.;
@@ -150,7 +150,7 @@ M:
   \endcode
   */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<float> &v)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(4, 4, m_storage)
 {
   buildFrom(v) ;
   (*this)[3][3] = 1.;
@@ -195,7 +195,7 @@ M:
   \endcode
   */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<double> &v)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(4, 4, m_storage)
 {
   buildFrom(v) ;
   (*this)[3][3] = 1.;
@@ -211,7 +211,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const double tx,
                                          const double tux,
                                          const double tuy,
                                          const double tuz)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(4, 4, m_storage)
 {
   buildFrom(tx, ty, tz, tux, tuy, tuz);
   (*this)[3][3] = 1.;
@@ -422,21 +422,18 @@ vpHomogeneousMatrix::operator*(const vpHomogeneousMatrix &M) const
 {
   vpHomogeneousMatrix p;
 
-  vpRotationMatrix R1, R2, R ;
-  vpTranslationVector T1, T2 , T;
-
-  extract(T1) ;
-  M.extract(T2) ;
-
-  extract (R1) ;
-  M.extract (R2) ;
-
-  R = R1*R2 ;
-
-  T = R1*T2 + T1 ;
-
-  p.insert(T) ;
-  p.insert(R) ;
+  const double *A = data;
+  const double *B = M.data;
+  double *C = p.data;
+
+  // Unrolled [R1 t1] [R2 t2] = [R1 R2, R1 t2 + t1], the last row of p being
+  // already set to [0 0 0 1]
+  for (unsigned int i=0; i<12; i+=4) {
+    C[i  ] = A[i]*B[0] + A[i+1]*B[4] + A[i+2]*B[8];
+    C[i+1] = A[i]*B[1] + A[i+1]*B[5] + A[i+2]*B[9];
+    C[i+2] = A[i]*B[2] + A[i+1]*B[6] + A[i+2]*B[10];
+    C[i+3] = (A[i]*B[3] + A[i+1]*B[7] + A[i+2]*B[11]) + A[i+3];
+  }
 
   return p;
 }
@@ -674,14 +671,16 @@ vpHomogeneousMatrix::inverse() const
 {
   vpHomogeneousMatrix Mi ;
 
-  vpRotationMatrix R ;      extract(R) ;
-  vpTranslationVector T ;   extract(T) ;
-
-  vpTranslationVector RtT ; RtT = -(R.t()*T) ;
+  const double *A = data;
+  double *C = Mi.data;
 
-
-  Mi.insert(R.t()) ;
-  Mi.insert(RtT) ;
+  // Unrolled [R^T, -R^T t], the last row of Mi being already set to [0 0 0 1]
+  for (unsigned int i=0; i<3; i++) {
+    C[4*i  ] = A[i];
+    C[4*i+1] = A[i+4];
+    C[4*i+2] = A[i+8];
+    C[4*i+3] = -(A[i]*A[3] + A[i+4]*A[7] + A[i+8]*A[11]);
+  }
 
   return Mi ;
 }
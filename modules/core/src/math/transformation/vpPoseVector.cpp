@@ -65,9 +65,32 @@
 
 */
 vpPoseVector::vpPoseVector()
-  : vpArray2D<double>(6, 1)
+  : vpArray2D<double>(6, 1, m_storage)
 {}
 
+/*!
+  Copy constructor.
+
+  \param p : Pose vector to copy.
+*/
+vpPoseVector::vpPoseVector(const vpPoseVector &p)
+  : vpArray2D<double>(6, 1, m_storage)
+{
+  *this = p;
+}
+
+/*!
+  Copy operator.
+
+  \param p : Pose vector to copy.
+*/
+vpPoseVector &
+vpPoseVector::operator=(const vpPoseVector &p)
+{
+  vpArray2D<double>::operator=(p);
+  return *this;
+}
+
 /*!  
 
   Construct a 6 dimension pose vector \f$ [\bf{t}, \theta
@@ -89,7 +112,7 @@ vpPoseVector::vpPoseVector(const double tx,
                            const double tux,
                            const double tuy,
                            const double tuz)
-  : vpArray2D<double>(6, 1)
+  : vpArray2D<double>(6, 1, m_storage)
 {
   (*this)[0] = tx;
   (*this)[1] = ty;
@@ -112,7 +135,7 @@ vpPoseVector::vpPoseVector(const double tx,
 */
 vpPoseVector::vpPoseVector(const vpTranslationVector& tv,
                            const vpThetaUVector& tu)
-  : vpArray2D<double>(6, 1)
+  : vpArray2D<double>(6, 1, m_storage)
 {
   buildFrom(tv, tu) ;
 }
@@ -131,7 +154,7 @@ vpPoseVector::vpPoseVector(const vpTranslationVector& tv,
 */
 vpPoseVector::vpPoseVector(const vpTranslationVector& tv,
                            const vpRotationMatrix& R)
-  : vpArray2D<double>(6, 1)
+  : vpArray2D<double>(6, 1, m_storage)
 {
   buildFrom(tv, R) ;
 }
@@ -147,7 +170,7 @@ vpPoseVector::vpPoseVector(const vpTranslationVector& tv,
 
 */
 vpPoseVector::vpPoseVector(const vpHomogeneousMatrix& M)
-  : vpArray2D<double>(6, 1)
+  : vpArray2D<double>(6, 1, m_storage)
 {
   buildFrom(M) ;
 }
@@ -89,7 +89,7 @@ vpVelocityTwistMatrix::eye()
   Initialize a velocity twist transformation matrix as identity.
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix()
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(6, 6, m_storage)
 {
   eye() ;
 }
@@ -100,7 +100,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix()
   \param V : Velocity twist matrix used as initializer.
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpVelocityTwistMatrix &V)
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(6, 6, m_storage)
 {
   *this = V;
 }
@@ -116,7 +116,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpVelocityTwistMatrix &V)
 
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpHomogeneousMatrix &M)
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(6, 6, m_storage)
 {
   buildFrom(M);
 }
@@ -133,7 +133,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpHomogeneousMatrix &M)
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t,
                                              const vpThetaUVector &thetau)
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(6, 6, m_storage)
 {
   buildFrom(t, thetau) ;
 }
@@ -150,7 +150,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t,
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t,
                                              const vpRotationMatrix &R)
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(6, 6, m_storage)
 {
   buildFrom(t,R) ;
 }
@@ -171,7 +171,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const double tx,
 					     const double tux,
 					     const double tuy,
                const double tuz)
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(6, 6, m_storage)
 {
   vpTranslationVector T(tx,ty,tz) ;
   vpThetaUVector tu(tux,tuy,tuz) ;
@@ -44,6 +44,9 @@
 #include <visp3/core/vpDisplay.h>
 #include <visp3/core/vpMeterPixelConversion.h>
 #include <visp3/core/vpUniRand.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <set>
 #include <limits>
 /*!
@@ -387,6 +390,152 @@ vpPolygon::precalcValuesPnPoly() {
   }
 }
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Keep the columns u of the spans a such that u+shift is in one of the spans b.
+  // Spans are stored as consecutive first and last columns, in increasing order.
+  void intersectSpans(const std::vector<int> &a, const std::vector<int> &b, const int shift, std::vector<int> &out)
+  {
+    out.clear();
+    size_t p = 0, q = 0;
+    while (p < a.size() && q < b.size()) {
+      int first = std::max(a[p], b[q] - shift);
+      int last = std::min(a[p+1], b[q+1] - shift);
+      if (first <= last) {
+        out.push_back(first);
+        out.push_back(last);
+      }
+      if (a[p+1] < b[q+1] - shift)
+        p += 2;
+      else
+        q += 2;
+    }
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Compute the columns of the row \e v that are inside the polygon. The rule
+  is the one of the ray casting isInside() test: a point is inside when an
+  odd number of edges cross the row strictly on its left.
+
+  \param v : Row coordinate.
+  \param u_min, u_max : Range of the columns to consider.
+  \param crossings : Buffer used to sort the edge crossings.
+  \param spans : First and last columns of the inside spans, in increasing
+  order.
+*/
+void
+vpPolygon::getRowSpans(const double v, const int u_min, const int u_max, std::vector<double> &crossings, std::vector<int> &spans) const
+{
+  crossings.clear();
+  spans.clear();
+  for (size_t i = 0, j = _corners.size()-1; i < _corners.size(); i++) {
+    if ((_corners[i].get_v() < v && _corners[j].get_v() >= v) || (_corners[j].get_v() < v && _corners[i].get_v() >= v)) {
+      crossings.push_back(v*m_PnPolyMultiples[i] + m_PnPolyConstants[i]);
+    }
+
+    j = i;
+  }
+  std::sort(crossings.begin(), crossings.end());
+
+  // u is inside when crossings[k] < u <= crossings[k+1] with k even
+  for (size_t k = 0; k+1 < crossings.size(); k += 2) {
+    double first = std::max(std::floor(crossings[k]) + 1., (double) u_min);
+    double last = std::min(std::floor(crossings[k+1]), (double) u_max);
+    if (first <= last) {
+      spans.push_back((int) first);
+      spans.push_back((int) last);
+    }
+  }
+}
+
+/*!
+  Set to \e value all the pixels of an image that are inside the polygon.
+
+  The image is scanned row by row: the polygon edges are intersected with
+  each row and the pixels between two crossings are set at once, so that the
+  cost is proportional to the number of rows times the number of corners plus
+  the number of pixels set, instead of one point in polygon test per pixel.
+  The pixels that are set are exactly those for which isInside() with the
+  vpPolygon::PnPolyRayCasting method returns true.
+
+  \param I : Image to update. The pixels outside the polygon are not
+  modified.
+  \param value : Value given to the pixels inside the polygon.
+  \param border : When not null, a pixel \f$ (i,j) \f$ is only set if the
+  four points \f$ (i \pm border, j \pm border) \f$ are also inside the
+  polygon. It erodes the polygon to avoid the pixels close to its edges.
+*/
+void
+vpPolygon::fill(vpImage<unsigned char> &I, const unsigned char value, const unsigned int border) const
+{
+  fill(I.bitmap, I.getHeight(), I.getWidth(), I.getWidth(), value, border);
+}
+
+/*!
+  Set to \e value all the pixels of a raw 8-bit image that are inside the
+  polygon. See fill(vpImage<unsigned char> &, const unsigned char, const unsigned int) const.
+
+  \param bitmap : Address of the first pixel of the image.
+  \param height, width : Size of the image.
+  \param step : Number of bytes between two consecutive rows.
+  \param value : Value given to the pixels inside the polygon.
+  \param border : Erosion of the polygon in pixels.
+*/
+void
+vpPolygon::fill(unsigned char *bitmap, const unsigned int height, const unsigned int width, const unsigned int step,
+                const unsigned char value, const unsigned int border) const
+{
+  if (_corners.size() < 3 || bitmap == NULL || height == 0 || width == 0)
+    return;
+
+  // A row v crosses the polygon only if v_min < v <= v_max
+  double v_min = _corners[0].get_v(), v_max = _corners[0].get_v();
+  for (size_t i = 1; i < _corners.size(); i++) {
+    v_min = std::min(v_min, _corners[i].get_v());
+    v_max = std::max(v_max, _corners[i].get_v());
+  }
+  double first_row = std::max(std::floor(v_min) + 1., 0.);
+  double last_row = std::min(std::floor(v_max), (double) (height-1));
+  if (first_row > last_row)
+    return;
+
+  // Columns shifted by the border are needed outside of the image
+  const int shift = (int) border;
+  const int u_min = -shift;
+  const int u_max = (int) width - 1 + shift;
+  const double border_d = (double) border;
+
+  std::vector<double> crossings;
+  std::vector<int> spans, spans_up, spans_down, spans_tmp;
+  crossings.reserve(_corners.size());
+
+  for (unsigned int i = (unsigned int) first_row; i <= (unsigned int) last_row; i++) {
+    double i_d = (double) i;
+    getRowSpans(i_d, u_min, u_max, crossings, spans);
+
+    if (border != 0 && !spans.empty()) {
+      getRowSpans(i_d - border_d, u_min, u_max, crossings, spans_up);
+      getRowSpans(i_d + border_d, u_min, u_max, crossings, spans_down);
+
+      intersectSpans(spans, spans_up, shift, spans_tmp);
+      intersectSpans(spans_tmp, spans_up, -shift, spans);
+      intersectSpans(spans, spans_down, shift, spans_tmp);
+      intersectSpans(spans_tmp, spans_down, -shift, spans);
+    }
+
+    unsigned char *row = bitmap + (size_t) i * step;
+    for (size_t k = 0; k < spans.size(); k += 2) {
+      int first = std::max(spans[k], 0);
+      int last = std::min(spans[k+1], (int) width - 1);
+      if (first <= last) {
+        memset(row + first, value, (size_t) (last - first + 1));
+      }
+    }
+  }
+}
+
 /*!
   Update the \c _area attribute of the polygon using the corners.
 
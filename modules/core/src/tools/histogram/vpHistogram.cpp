@@ -50,87 +50,78 @@
 #include <visp3/core/vpDisplay.h>
 
 
-#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
-#include <visp3/core/vpThread.h>
+#include <visp3/core/vpThreadPool.h>
+
+#include <vector>
 
 namespace {
   struct Histogram_Param_t {
-    unsigned int m_start_index;
-    unsigned int m_end_index;
+    unsigned int m_nbBlocks;
+    unsigned int m_size;
 
-    unsigned int m_lut[256];
-    unsigned int *m_histogram;
+    const unsigned int *m_lut;
+    //! One histogram of m_size bins per block of pixels
+    std::vector<unsigned int> m_histograms;
     const vpImage<unsigned char> *m_I;
 
-    Histogram_Param_t() : m_start_index(0), m_end_index(0), m_lut(), m_histogram(NULL), m_I(NULL) {
-    }
-
-    Histogram_Param_t(const unsigned int start_index, const unsigned int end_index,
+    Histogram_Param_t(const unsigned int nbBlocks, const unsigned int size, const unsigned int *lut,
         const vpImage<unsigned char> * const I) :
-      m_start_index(start_index), m_end_index(end_index), m_lut(), m_histogram(NULL), m_I(I) {
-    }
-
-    ~Histogram_Param_t() {
-      if(m_histogram != NULL) {
-        delete []m_histogram;
-      }
+      m_nbBlocks(nbBlocks), m_size(size), m_lut(lut), m_histograms(nbBlocks*size, 0), m_I(I) {
     }
   };
 
-  vpThread::Return computeHistogramThread(vpThread::Args args) {
-    Histogram_Param_t *histogram_param = static_cast<Histogram_Param_t *>(args);
-    unsigned int start_index = histogram_param->m_start_index;
-    unsigned int end_index = histogram_param->m_end_index;
-
-    const vpImage<unsigned char> *I = histogram_param->m_I;
+  void computeHistogramBlock(const unsigned int *lut, const unsigned char *ptrStart, const unsigned char *ptrEnd,
+                             unsigned int *histogram) {
+    const unsigned char *ptrCurrent = ptrStart;
 
-    unsigned char *ptrStart = (unsigned char*) (I->bitmap) + start_index;
-    unsigned char *ptrEnd = (unsigned char*) (I->bitmap) + end_index;
-    unsigned char *ptrCurrent = ptrStart;
-
-
-//    while(ptrCurrent != ptrEnd) {
-//      histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-//      ++ptrCurrent;
-//    }
-
-    if(end_index - start_index >= 8) {
+    if(ptrEnd - ptrStart >= 8) {
       //Unroll loop version
       for(; ptrCurrent <= ptrEnd - 8;) {
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
+        histogram[ lut[ *ptrCurrent ] ] ++;
         ++ptrCurrent;
 
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
+        histogram[ lut[ *ptrCurrent ] ] ++;
         ++ptrCurrent;
 
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
+        histogram[ lut[ *ptrCurrent ] ] ++;
         ++ptrCurrent;
 
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
+        histogram[ lut[ *ptrCurrent ] ] ++;
         ++ptrCurrent;
 
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
+        histogram[ lut[ *ptrCurrent ] ] ++;
         ++ptrCurrent;
 
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
+        histogram[ lut[ *ptrCurrent ] ] ++;
         ++ptrCurrent;
 
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
+        histogram[ lut[ *ptrCurrent ] ] ++;
         ++ptrCurrent;
 
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
+        histogram[ lut[ *ptrCurrent ] ] ++;
         ++ptrCurrent;
       }
     }
 
     for(; ptrCurrent != ptrEnd; ++ptrCurrent) {
-      histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
+      histogram[ lut[ *ptrCurrent ] ] ++;
     }
+  }
 
-    return 0;
+  // Histograms of the blocks [begin, end), each block being a part of the image
+  void computeHistogramBlocks(unsigned int begin, unsigned int end, void *args) {
+    Histogram_Param_t *histogram_param = static_cast<Histogram_Param_t *>(args);
+    const unsigned int image_size = histogram_param->m_I->getSize();
+    const unsigned char *bitmap = histogram_param->m_I->bitmap;
+
+    for (unsigned int block = begin; block < end; block++) {
+      unsigned int start_index = (unsigned int) ((double) image_size * block / histogram_param->m_nbBlocks);
+      unsigned int end_index = (unsigned int) ((double) image_size * (block+1) / histogram_param->m_nbBlocks);
+      computeHistogramBlock(histogram_param->m_lut, bitmap + start_index, bitmap + end_index,
+                            &histogram_param->m_histograms[block * histogram_param->m_size]);
+    }
   }
 }
-#endif
 
 bool compare_vpHistogramPeak (vpHistogramPeak first, vpHistogramPeak second);
 
@@ -238,7 +229,8 @@ vpHistogram::init(unsigned size_)
 
   \param I : Gray level image.
   \param nbins : Number of bins to compute the histogram.
-  \param nbThreads : Number of threads to use for the computation.
+  \param nbThreads : Number of threads to use for the computation. The threads
+  are taken from vpThreadPool and limited by vpThreadPool::getNbThreads().
 */
 void vpHistogram::calculate(const vpImage<unsigned char> &I, const unsigned int nbins, const unsigned int nbThreads)
 {
@@ -258,12 +250,7 @@ void vpHistogram::calculate(const vpImage<unsigned char> &I, const unsigned int
   memset(histogram, 0, size * sizeof(unsigned int));
 
 
-  bool use_single_thread;
-#if !defined(VISP_HAVE_PTHREAD) && !defined(_WIN32)
-  use_single_thread = true;
-#else
-  use_single_thread = (nbThreads == 0 || nbThreads == 1);
-#endif
+  bool use_single_thread = (nbThreads == 0 || nbThreads == 1);
 
   if(!use_single_thread && I.getSize() <= nbThreads) {
     use_single_thread = true;
@@ -288,60 +275,20 @@ void vpHistogram::calculate(const vpImage<unsigned char> &I, const unsigned int
       ++ptrCurrent;
     }
   } else {
-#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
-    //Multi-threads
-
-    std::vector<vpThread *> threadpool;
-    std::vector<Histogram_Param_t *> histogramParams;
-
-    unsigned int image_size = I.getSize();
-    unsigned int step = image_size / nbThreads;
-    unsigned int last_step = image_size - step * (nbThreads-1);
-
-    for(unsigned int index = 0; index < nbThreads; index++) {
-      unsigned int start_index = index*step;
-      unsigned int end_index = (index+1)*step;
-
-      if(index == nbThreads-1) {
-        end_index = start_index+last_step;
-      }
-
-      Histogram_Param_t *histogram_param = new Histogram_Param_t(start_index, end_index, &I);
-      histogram_param->m_histogram = new unsigned int[size];
-      memset(histogram_param->m_histogram, 0, size * sizeof(unsigned int));
-      memcpy(histogram_param->m_lut, lut, 256*sizeof(unsigned int));
-
-      histogramParams.push_back(histogram_param);
-
-      // Start the threads
-      vpThread *histogram_thread = new vpThread((vpThread::Fn) computeHistogramThread, (vpThread::Args) histogram_param);
-      threadpool.push_back(histogram_thread);
-    }
-
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      // Wait until thread ends up
-      threadpool[cpt]->join();
-    }
+    //Multi-threads: one histogram per block of pixels, the blocks being
+    //shared between the threads of vpThreadPool
+    Histogram_Param_t histogram_param(nbThreads, size, lut, &I);
+    vpThreadPool::parallel_for(0, nbThreads, computeHistogramBlocks, &histogram_param, nbThreads);
 
     for(unsigned int cpt1 = 0; cpt1 < size; cpt1++) {
       unsigned int sum = 0;
 
-      for(size_t cpt2 = 0; cpt2 < histogramParams.size(); cpt2++) {
-        sum += histogramParams[cpt2]->m_histogram[cpt1];
+      for(unsigned int cpt2 = 0; cpt2 < nbThreads; cpt2++) {
+        sum += histogram_param.m_histograms[cpt2*size + cpt1];
       }
 
       histogram[cpt1] = sum;
     }
-
-    //Delete
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      delete threadpool[cpt];
-    }
-
-    for(size_t cpt = 0; cpt < histogramParams.size(); cpt++) {
-      delete histogramParams[cpt];
-    }
-#endif
   }
 }
 
@@ -0,0 +1,555 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Background acquisition of the images of a frame grabber.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpAsyncFrameGrabber.cpp
+  \brief Background acquisition of the images of a frame grabber.
+*/
+
+#include <visp3/core/vpAsyncFrameGrabber.h>
+#include <visp3/core/vpFrameGrabberException.h>
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpTime.h>
+
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+#  define VISP_HAVE_ASYNC_GRABBER 1
+#  include <visp3/core/vpThread.h>
+#  include <visp3/core/vpCondition.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  template<class Type>
+  void copyFrame(const vpImage<Type> &src, vpImage<Type> &dst)
+  {
+    // resize() keeps the memory of dst when the size is the same
+    dst.resize(src.getHeight(), src.getWidth());
+    std::copy(src.bitmap, src.bitmap + src.getSize(), dst.bitmap);
+  }
+
+  void copyFrame(const vpImage<unsigned char> &src, vpImage<vpRGBa> &dst)
+  {
+    vpImageConvert::convert(src, dst);
+  }
+
+  void copyFrame(const vpImage<vpRGBa> &src, vpImage<unsigned char> &dst)
+  {
+    vpImageConvert::convert(src, dst);
+  }
+}
+
+class vpAsyncFrameGrabber::vpCapture
+{
+public:
+  vpCapture(vpFrameGrabber &grabber, unsigned int nbSlots, vpAcquisitionMode mode, bool rgba)
+    : m_grabber(grabber), m_mode(mode), m_rgba(rgba), m_greySlots(), m_colorSlots(),
+      m_timestamps(nbSlots, 0.), m_indexes(nbSlots, 0), m_free(), m_ready(),
+      m_nbCaptured(0), m_nbDropped(0), m_running(true), m_stop(false),
+      m_failed(false), m_errorCode(vpException::fatalError), m_errorMessage()
+#if defined(VISP_HAVE_ASYNC_GRABBER)
+    , m_mutex(), m_frameReady(), m_slotFree(), m_thread(NULL)
+#endif
+  {
+    if (m_rgba)
+      m_colorSlots.resize(nbSlots);
+    else
+      m_greySlots.resize(nbSlots);
+
+    for (unsigned int k = 0; k < nbSlots; k++) {
+      if (m_rgba)
+        m_colorSlots[k].resize(grabber.getHeight(), grabber.getWidth());
+      else
+        m_greySlots[k].resize(grabber.getHeight(), grabber.getWidth());
+      m_free.push_back(k);
+    }
+  }
+
+  ~vpCapture()
+  {
+#if defined(VISP_HAVE_ASYNC_GRABBER)
+    if (m_thread != NULL) {
+      m_mutex.lock();
+      m_stop = true;
+      m_slotFree.notifyAll();
+      m_mutex.unlock();
+
+      m_thread->join();
+      delete m_thread;
+    }
+#endif
+  }
+
+#if defined(VISP_HAVE_ASYNC_GRABBER)
+  void start()
+  {
+    m_thread = new vpThread((vpThread::Fn) captureThread, (vpThread::Args) this);
+  }
+
+  static vpThread::Return captureThread(vpThread::Args args)
+  {
+    ((vpCapture *) args)->run();
+    return 0;
+  }
+
+  // Capture loop run by the capture thread
+  void run()
+  {
+    m_mutex.lock();
+    while (!m_stop) {
+      // Take a free slot, or the oldest image not acquired when they are all
+      // full unless no image may be dropped
+      if (m_free.empty()) {
+        if (m_mode == EVERY_FRAME || m_ready.empty()) {
+          m_slotFree.wait(m_mutex);
+          continue;
+        }
+        m_free.push_back(m_ready.front());
+        m_ready.pop_front();
+        m_nbDropped++;
+      }
+      unsigned int slot = m_free.back();
+      m_free.pop_back();
+      bool rgba = m_rgba;
+      m_mutex.unlock();
+
+      bool end = false;
+      int errorCode = vpException::fatalError;
+      std::string errorMessage;
+      bool failed = false;
+      try {
+        end = m_grabber.end();
+        if (!end) {
+          if (rgba)
+            m_grabber.acquire(m_colorSlots[slot]);
+          else
+            m_grabber.acquire(m_greySlots[slot]);
+        }
+      }
+      catch(vpException &e) {
+        failed = true;
+        errorCode = e.getCode();
+        errorMessage = e.getStringMessage();
+      }
+      catch(...) {
+        failed = true;
+        errorMessage = "Unknown exception in the capture thread";
+      }
+      double timestamp = vpTime::measureTimeMs();
+
+      m_mutex.lock();
+      if (end || failed) {
+        m_free.push_back(slot);
+        m_failed = failed;
+        m_errorCode = errorCode;
+        m_errorMessage = errorMessage;
+        break;
+      }
+
+      m_timestamps[slot] = timestamp;
+      m_indexes[slot] = m_nbCaptured++;
+      if (m_mode == LATEST_FRAME) {
+        m_nbDropped += (unsigned int) m_ready.size();
+        m_free.insert(m_free.end(), m_ready.begin(), m_ready.end());
+        m_ready.clear();
+      }
+      m_ready.push_back(slot);
+      m_frameReady.notifyAll();
+    }
+    m_running = false;
+    m_frameReady.notifyAll();
+    m_mutex.unlock();
+  }
+#endif
+
+  vpFrameGrabber &m_grabber;
+  vpAcquisitionMode m_mode;
+  //! true when the grabber acquires color images
+  bool m_rgba;
+  std::vector<vpImage<unsigned char> > m_greySlots;
+  std::vector<vpImage<vpRGBa> > m_colorSlots;
+  std::vector<double> m_timestamps;
+  std::vector<unsigned int> m_indexes;
+  //! Slots that the capture thread can fill
+  std::vector<unsigned int> m_free;
+  //! Slots with an image not acquired yet, in capture order
+  std::deque<unsigned int> m_ready;
+  unsigned int m_nbCaptured;
+  unsigned int m_nbDropped;
+  bool m_running;
+  bool m_stop;
+  bool m_failed;
+  int m_errorCode;
+  std::string m_errorMessage;
+
+#if defined(VISP_HAVE_ASYNC_GRABBER)
+  vpConditionMutex m_mutex;
+  //! Signaled when an image is ready or the capture stops
+  vpCondition m_frameReady;
+  //! Signaled when a slot becomes free or the capture has to stop
+  vpCondition m_slotFree;
+  vpThread *m_thread;
+#endif
+
+private:
+  vpCapture(const vpCapture &);
+  vpCapture &operator=(const vpCapture &);
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Create a background acquisition for a frame grabber. The capture starts
+  with open().
+
+  \param grabber : Frame grabber whose images are acquired. It has to be
+  configured (device, image size, file name...) before open() is called and
+  must live longer than this object.
+  \param nbSlots : Number of images of the ring, at least 2.
+  \param mode : Image returned by acquire().
+*/
+vpAsyncFrameGrabber::vpAsyncFrameGrabber(vpFrameGrabber &grabber, const unsigned int nbSlots,
+                                         const vpAcquisitionMode mode)
+  : vpFrameGrabber(), m_grabber(grabber), m_nbSlots(nbSlots), m_mode(mode), m_capture(NULL),
+    m_frameIndex(0), m_timestamp(0.)
+{
+  if (nbSlots < 2) {
+    throw(vpFrameGrabberException(vpFrameGrabberException::settingError,
+                                  "The background acquisition needs at least 2 slots, not %u", nbSlots));
+  }
+}
+
+/*!
+  Stop the capture thread. The frame grabber is not closed, see close().
+*/
+vpAsyncFrameGrabber::~vpAsyncFrameGrabber()
+{
+  if (m_capture != NULL) {
+    delete m_capture;
+    m_capture = NULL;
+  }
+}
+
+/*!
+  Open the frame grabber in the calling thread and start the capture of
+  grey level images.
+
+  \param I : Image passed to the open() method of the frame grabber.
+*/
+void vpAsyncFrameGrabber::open(vpImage<unsigned char> &I)
+{
+  openImpl(I, false);
+}
+
+/*!
+  Open the frame grabber in the calling thread and start the capture of
+  color images.
+
+  \param I : Image passed to the open() method of the frame grabber.
+*/
+void vpAsyncFrameGrabber::open(vpImage<vpRGBa> &I)
+{
+  openImpl(I, true);
+}
+
+template<class Type>
+void vpAsyncFrameGrabber::openImpl(vpImage<Type> &I, const bool rgba)
+{
+  if (m_capture != NULL) {
+    throw(vpFrameGrabberException(vpFrameGrabberException::initializationError,
+                                  "The background acquisition is already open"));
+  }
+
+  m_grabber.open(I);
+  width = m_grabber.getWidth();
+  height = m_grabber.getHeight();
+
+  m_capture = new vpCapture(m_grabber, m_nbSlots, m_mode, rgba);
+#if defined(VISP_HAVE_ASYNC_GRABBER)
+  m_capture->start();
+#endif
+  m_frameIndex = 0;
+  m_timestamp = 0.;
+  init = true;
+}
+
+/*!
+  Copy in \e I the image given by the acquisition mode. Wait until an image
+  is ready if none was captured since the previous call.
+
+  \exception vpFrameGrabberException::otherError : There is no more image to
+  acquire, see end().
+  \exception vpException : The exception thrown by the acquire() method of
+  the frame grabber.
+*/
+void vpAsyncFrameGrabber::acquire(vpImage<unsigned char> &I)
+{
+  if (!acquireImpl(I, true)) {
+    throw(vpFrameGrabberException(vpFrameGrabberException::otherError, "No more image to acquire"));
+  }
+}
+
+/*!
+  Copy in \e I the image given by the acquisition mode. Wait until an image
+  is ready if none was captured since the previous call. When the capture
+  is done in grey level, the image is converted.
+
+  \exception vpFrameGrabberException::otherError : There is no more image to
+  acquire, see end().
+  \exception vpException : The exception thrown by the acquire() method of
+  the frame grabber.
+*/
+void vpAsyncFrameGrabber::acquire(vpImage<vpRGBa> &I)
+{
+  if (!acquireImpl(I, true)) {
+    throw(vpFrameGrabberException(vpFrameGrabberException::otherError, "No more image to acquire"));
+  }
+}
+
+/*!
+  Copy in \e I the image given by the acquisition mode.
+
+  \param I : Acquired image. Not modified when false is returned.
+  \param blocking : When true, wait until an image is ready. When false,
+  return immediately if no image was captured since the previous call.
+
+  \return true if an image was acquired, false if no image is ready or if
+  there is no more image to acquire.
+
+  \exception vpException : The exception thrown by the acquire() method of
+  the frame grabber, once all the images captured before were acquired.
+*/
+bool vpAsyncFrameGrabber::acquire(vpImage<unsigned char> &I, const bool blocking)
+{
+  return acquireImpl(I, blocking);
+}
+
+/*!
+  Copy in \e I the image given by the acquisition mode. When the capture is
+  done in grey level, the image is converted.
+
+  \param I : Acquired image. Not modified when false is returned.
+  \param blocking : When true, wait until an image is ready. When false,
+  return immediately if no image was captured since the previous call.
+
+  \return true if an image was acquired, false if no image is ready or if
+  there is no more image to acquire.
+
+  \exception vpException : The exception thrown by the acquire() method of
+  the frame grabber, once all the images captured before were acquired.
+*/
+bool vpAsyncFrameGrabber::acquire(vpImage<vpRGBa> &I, const bool blocking)
+{
+  return acquireImpl(I, blocking);
+}
+
+template<class Type>
+bool vpAsyncFrameGrabber::acquireImpl(vpImage<Type> &I, const bool blocking)
+{
+  if (m_capture == NULL) {
+    open(I);
+  }
+
+#if defined(VISP_HAVE_ASYNC_GRABBER)
+  vpCapture &capture = *m_capture;
+
+  capture.m_mutex.lock();
+  while (capture.m_ready.empty()) {
+    if (!capture.m_running) {
+      capture.m_mutex.unlock();
+      if (capture.m_failed) {
+        throw(vpException(capture.m_errorCode, capture.m_errorMessage));
+      }
+      return false;
+    }
+    if (!blocking) {
+      capture.m_mutex.unlock();
+      return false;
+    }
+    capture.m_frameReady.wait(capture.m_mutex);
+  }
+
+  // After a change of mode, keep only the newest image
+  while (capture.m_mode == LATEST_FRAME && capture.m_ready.size() > 1) {
+    capture.m_free.push_back(capture.m_ready.front());
+    capture.m_ready.pop_front();
+    capture.m_nbDropped++;
+  }
+
+  // The slot is neither free nor ready while it is copied
+  unsigned int slot = capture.m_ready.front();
+  capture.m_ready.pop_front();
+  m_timestamp = capture.m_timestamps[slot];
+  m_frameIndex = capture.m_indexes[slot];
+  capture.m_mutex.unlock();
+
+  if (capture.m_rgba)
+    copyFrame(capture.m_colorSlots[slot], I);
+  else
+    copyFrame(capture.m_greySlots[slot], I);
+
+  capture.m_mutex.lock();
+  capture.m_free.push_back(slot);
+  capture.m_slotFree.notifyAll();
+  capture.m_mutex.unlock();
+#else
+  (void) blocking;
+  if (m_grabber.end()) {
+    return false;
+  }
+  m_grabber.acquire(I);
+  m_timestamp = vpTime::measureTimeMs();
+  m_frameIndex = m_capture->m_nbCaptured++;
+#endif
+
+  return true;
+}
+
+/*!
+  Stop the capture thread, discard the images not acquired and close the
+  frame grabber. The background acquisition can then be opened again.
+*/
+void vpAsyncFrameGrabber::close()
+{
+  if (m_capture != NULL) {
+    delete m_capture;
+    m_capture = NULL;
+  }
+  m_grabber.close();
+  init = false;
+}
+
+/*!
+  Return true when the capture is over, either because end() of the frame
+  grabber returned true or because its acquire() method threw an exception,
+  and all the images captured were acquired.
+*/
+bool vpAsyncFrameGrabber::end()
+{
+  if (m_capture == NULL) {
+    return m_grabber.end();
+  }
+
+#if defined(VISP_HAVE_ASYNC_GRABBER)
+  m_capture->m_mutex.lock();
+  bool end = !m_capture->m_running && m_capture->m_ready.empty();
+  m_capture->m_mutex.unlock();
+  return end;
+#else
+  return m_grabber.end();
+#endif
+}
+
+/*!
+  Return the number of images captured since open().
+*/
+unsigned int vpAsyncFrameGrabber::getNbCapturedFrames()
+{
+  if (m_capture == NULL) {
+    return 0;
+  }
+
+#if defined(VISP_HAVE_ASYNC_GRABBER)
+  m_capture->m_mutex.lock();
+  unsigned int nbCaptured = m_capture->m_nbCaptured;
+  m_capture->m_mutex.unlock();
+  return nbCaptured;
+#else
+  return m_capture->m_nbCaptured;
+#endif
+}
+
+/*!
+  Return the number of images captured since open() and dropped without
+  being acquired.
+*/
+unsigned int vpAsyncFrameGrabber::getNbDroppedFrames()
+{
+  if (m_capture == NULL) {
+    return 0;
+  }
+
+#if defined(VISP_HAVE_ASYNC_GRABBER)
+  m_capture->m_mutex.lock();
+  unsigned int nbDropped = m_capture->m_nbDropped;
+  m_capture->m_mutex.unlock();
+  return nbDropped;
+#else
+  return m_capture->m_nbDropped;
+#endif
+}
+
+/*!
+  Return the number of images captured and not acquired yet. With the
+  vpAsyncFrameGrabber::LATEST_FRAME mode, it is at most 1.
+*/
+unsigned int vpAsyncFrameGrabber::getNbReadyFrames()
+{
+  if (m_capture == NULL) {
+    return 0;
+  }
+
+#if defined(VISP_HAVE_ASYNC_GRABBER)
+  m_capture->m_mutex.lock();
+  unsigned int nbReady = (unsigned int) m_capture->m_ready.size();
+  m_capture->m_mutex.unlock();
+  return nbReady;
+#else
+  return 0;
+#endif
+}
+
+/*!
+  Set the acquisition mode. It can be changed while the capture is running.
+  \sa getAcquisitionMode()
+*/
+void vpAsyncFrameGrabber::setAcquisitionMode(const vpAcquisitionMode mode)
+{
+  m_mode = mode;
+  if (m_capture == NULL) {
+    return;
+  }
+
+#if defined(VISP_HAVE_ASYNC_GRABBER)
+  m_capture->m_mutex.lock();
+  m_capture->m_mode = mode;
+  m_capture->m_slotFree.notifyAll();
+  m_capture->m_mutex.unlock();
+#else
+  m_capture->m_mode = mode;
+#endif
+}
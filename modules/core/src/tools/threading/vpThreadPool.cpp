@@ -0,0 +1,408 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Process-wide pool of worker threads.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpThreadPool.cpp
+  \brief Process-wide pool of worker threads and parallel loop over a range.
+*/
+
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpException.h>
+
+#include <algorithm>
+#include <list>
+#include <string>
+#include <vector>
+
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+#  define VISP_HAVE_THREAD_POOL 1
+#  include <visp3/core/vpMutex.h>
+#  include <visp3/core/vpThread.h>
+#  include <visp3/core/vpCondition.h>
+#endif
+
+#if defined(_WIN32)
+// Include WinSock2.h before windows.h to ensure that winsock.h is not included by windows.h
+// since winsock.h and winsock2.h are incompatible
+#  include <WinSock2.h>
+#  include <windows.h>
+#else
+#  include <unistd.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+#if defined(VISP_HAVE_THREAD_POOL)
+  // Indices [m_begin, m_end) left to a participant of a loop
+  struct vpLoopRange
+  {
+    vpLoopRange() : m_mutex(), m_begin(0), m_end(0) {}
+
+    vpMutex m_mutex;
+    unsigned int m_begin;
+    unsigned int m_end;
+  };
+
+  struct vpLoop
+  {
+    vpLoop(vpThreadPool::RangeFn fn, void *args, unsigned int grain, unsigned int nbRanges)
+      : m_fn(fn), m_args(args), m_grain(grain), m_ranges(nbRanges), m_nbJoined(0), m_nbRunning(0),
+        m_errorMutex(), m_failed(false), m_errorCode(vpException::fatalError), m_errorMessage()
+    {
+      for (unsigned int k = 0; k < nbRanges; k++)
+        m_ranges[k] = new vpLoopRange;
+    }
+
+    ~vpLoop()
+    {
+      for (size_t k = 0; k < m_ranges.size(); k++)
+        delete m_ranges[k];
+    }
+
+    void setError(int code, const std::string &message)
+    {
+      vpMutex::vpScopedLock lock(m_errorMutex);
+      if (!m_failed) {
+        m_failed = true;
+        m_errorCode = code;
+        m_errorMessage = message;
+      }
+    }
+
+    vpThreadPool::RangeFn m_fn;
+    void *m_args;
+    unsigned int m_grain;
+    std::vector<vpLoopRange *> m_ranges;
+    //! Number of threads that took a range, protected by the pool lock
+    unsigned int m_nbJoined;
+    //! Number of workers still running the loop, protected by the pool lock
+    unsigned int m_nbRunning;
+
+    vpMutex m_errorMutex;
+    bool m_failed;
+    int m_errorCode;
+    std::string m_errorMessage;
+
+  private:
+    vpLoop(const vpLoop &);
+    vpLoop &operator=(const vpLoop &);
+  };
+
+  // Process the range of the participant self, then steal work from the
+  // others until all the ranges are empty.
+  void runLoop(vpLoop &loop, unsigned int self)
+  {
+    vpLoopRange &own = *loop.m_ranges[self];
+    const unsigned int nbRanges = (unsigned int) loop.m_ranges.size();
+
+    for (;;) {
+      for (;;) {
+        own.m_mutex.lock();
+        unsigned int begin = own.m_begin;
+        unsigned int end = own.m_end;
+        if (begin >= end) {
+          own.m_mutex.unlock();
+          break;
+        }
+        // Keep most of the range available to the thieves
+        unsigned int block = std::max((end - begin) / 4, loop.m_grain);
+        if (end - begin > block)
+          end = begin + block;
+        own.m_begin = end;
+        own.m_mutex.unlock();
+
+        try {
+          loop.m_fn(begin, end, loop.m_args);
+        }
+        catch(vpException &e) {
+          loop.setError(e.getCode(), e.getStringMessage());
+        }
+        catch(...) {
+          loop.setError(vpException::fatalError, "Unknown exception in a parallel loop");
+        }
+      }
+
+      // Look for the largest range left
+      unsigned int victim = nbRanges, largest = 0;
+      for (unsigned int k = 0; k < nbRanges; k++) {
+        if (k == self)
+          continue;
+        vpLoopRange &range = *loop.m_ranges[k];
+        range.m_mutex.lock();
+        unsigned int size = range.m_end > range.m_begin ? range.m_end - range.m_begin : 0;
+        range.m_mutex.unlock();
+        if (size > largest) {
+          largest = size;
+          victim = k;
+        }
+      }
+      if (victim == nbRanges)
+        return;
+
+      // Steal its second half
+      vpLoopRange &range = *loop.m_ranges[victim];
+      range.m_mutex.lock();
+      unsigned int size = range.m_end > range.m_begin ? range.m_end - range.m_begin : 0;
+      unsigned int stolen = (size > loop.m_grain) ? std::max(size - size / 2, loop.m_grain) : size;
+      unsigned int end = range.m_end;
+      range.m_end -= stolen;
+      range.m_mutex.unlock();
+
+      own.m_mutex.lock();
+      own.m_begin = end - stolen;
+      own.m_end = end;
+      own.m_mutex.unlock();
+    }
+  }
+
+  class vpPool
+  {
+  public:
+    vpPool() : m_lock(), m_work(), m_done(), m_loops(), m_workers(), m_nbThreads(vpThreadPool::getHardwareConcurrency()), m_stop(false) {}
+
+    ~vpPool()
+    {
+      m_lock.lock();
+      m_stop = true;
+      m_work.notifyAll();
+      m_lock.unlock();
+
+      for (size_t k = 0; k < m_workers.size(); k++) {
+        m_workers[k]->join();
+        delete m_workers[k];
+      }
+    }
+
+    unsigned int getNbThreads()
+    {
+      m_lock.lock();
+      unsigned int nbThreads = m_nbThreads;
+      m_lock.unlock();
+      return nbThreads;
+    }
+
+    void setNbThreads(unsigned int nbThreads)
+    {
+      m_lock.lock();
+      m_nbThreads = nbThreads;
+      m_lock.unlock();
+    }
+
+    void run(vpLoop &loop)
+    {
+      const unsigned int nbWorkers = (unsigned int) loop.m_ranges.size() - 1;
+
+      m_lock.lock();
+      while (m_workers.size() < nbWorkers)
+        m_workers.push_back(new vpThread((vpThread::Fn) workerThread, (vpThread::Args) this));
+      loop.m_nbJoined = 1;
+      m_loops.push_back(&loop);
+      m_work.notifyAll();
+      m_lock.unlock();
+
+      // The calling thread takes the first range
+      runLoop(loop, 0);
+
+      m_lock.lock();
+      if (loop.m_nbJoined < loop.m_ranges.size())
+        m_loops.remove(&loop);
+      while (loop.m_nbRunning > 0)
+        m_done.wait(m_lock);
+      m_lock.unlock();
+    }
+
+  private:
+    vpPool(const vpPool &);
+    vpPool &operator=(const vpPool &);
+
+    static vpThread::Return workerThread(vpThread::Args args)
+    {
+      vpPool *pool = (vpPool *) args;
+
+      pool->m_lock.lock();
+      while (!pool->m_stop) {
+        if (pool->m_loops.empty()) {
+          pool->m_work.wait(pool->m_lock);
+          continue;
+        }
+
+        vpLoop *loop = pool->m_loops.front();
+        unsigned int self = loop->m_nbJoined++;
+        if (loop->m_nbJoined == loop->m_ranges.size())
+          pool->m_loops.pop_front();
+        loop->m_nbRunning++;
+        pool->m_lock.unlock();
+
+        runLoop(*loop, self);
+
+        pool->m_lock.lock();
+        loop->m_nbRunning--;
+        if (loop->m_nbRunning == 0)
+          pool->m_done.notifyAll();
+      }
+      pool->m_lock.unlock();
+
+      return 0;
+    }
+
+    vpConditionMutex m_lock;
+    //! Signaled when a loop is added or the pool is stopped
+    vpCondition m_work;
+    //! Signaled when the last worker of a loop is done
+    vpCondition m_done;
+    //! Loops that still accept workers
+    std::list<vpLoop *> m_loops;
+    std::vector<vpThread *> m_workers;
+    unsigned int m_nbThreads;
+    bool m_stop;
+  };
+
+  vpPool g_pool;
+#else
+  unsigned int g_nbThreads = 1;
+#endif
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Return the number of cores of the machine, or 1 if it can not be
+  determined.
+*/
+unsigned int vpThreadPool::getHardwareConcurrency()
+{
+  long nbCores = 1;
+#if defined(_WIN32)
+  SYSTEM_INFO info;
+#  if defined(WINRT)
+  GetNativeSystemInfo(&info);
+#  else
+  GetSystemInfo(&info);
+#  endif
+  nbCores = (long) info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+  nbCores = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  return nbCores > 0 ? (unsigned int) nbCores : 1;
+}
+
+/*!
+  Return the maximum number of threads, including the calling thread, used
+  by a parallel loop.
+
+  \sa setNbThreads()
+*/
+unsigned int vpThreadPool::getNbThreads()
+{
+#if defined(VISP_HAVE_THREAD_POOL)
+  return g_pool.getNbThreads();
+#else
+  return g_nbThreads;
+#endif
+}
+
+/*!
+  Set the maximum number of threads, including the calling thread, used by
+  a parallel loop. This limit applies to every parallel loop of the process,
+  including the ones of the ViSP functions that have a \e nbThreads
+  parameter.
+
+  \param nbThreads : Maximum number of threads. 0 sets the number of cores
+  of the machine, which is the default value. 1 disables the parallel
+  loops.
+*/
+void vpThreadPool::setNbThreads(const unsigned int nbThreads)
+{
+  unsigned int n = (nbThreads == 0) ? getHardwareConcurrency() : nbThreads;
+#if defined(VISP_HAVE_THREAD_POOL)
+  g_pool.setNbThreads(n);
+#else
+  g_nbThreads = n;
+#endif
+}
+
+/*!
+  Call \e fn on sub-ranges of [\e begin, \e end) from several threads and
+  return when the whole range is processed.
+
+  The range is first split into one sub-range per thread. The calling thread
+  processes the first one. Each thread processes its own sub-range by blocks
+  of a quarter of what is left, but at least \e grainSize indices, and then
+  steals half of the largest sub-range left.
+
+  \param begin, end : Range of indices.
+  \param fn : Loop body. It is called concurrently on disjoint sub-ranges.
+  \param args : User data passed to \e fn.
+  \param nbThreads : Maximum number of threads, including the calling
+  thread. 0 means getNbThreads(). A larger value is limited to
+  getNbThreads(), and 1 runs the loop in the calling thread.
+  \param grainSize : Minimum number of indices processed by a call to \e fn.
+  The number of threads is limited so that each one has at least
+  \e grainSize indices to process.
+
+  \exception vpException : The first exception thrown by \e fn, once all the
+  threads are done.
+*/
+void vpThreadPool::parallel_for(const unsigned int begin, const unsigned int end, RangeFn fn, void *args,
+                                const unsigned int nbThreads, const unsigned int grainSize)
+{
+  if (end <= begin)
+    return;
+
+  const unsigned int grain = std::max(grainSize, 1u);
+  const unsigned int nbIndices = end - begin;
+  unsigned int n = getNbThreads();
+  if (nbThreads != 0)
+    n = std::min(n, nbThreads);
+  n = std::min(n, nbIndices / grain + (nbIndices % grain != 0 ? 1 : 0));
+
+  if (n <= 1) {
+    fn(begin, end, args);
+    return;
+  }
+
+#if defined(VISP_HAVE_THREAD_POOL)
+  vpLoop loop(fn, args, grain, n);
+  for (unsigned int k = 0; k < n; k++) {
+    loop.m_ranges[k]->m_begin = begin + (unsigned int) ((double) nbIndices * k / n);
+    loop.m_ranges[k]->m_end = begin + (unsigned int) ((double) nbIndices * (k+1) / n);
+  }
+
+  g_pool.run(loop);
+
+  if (loop.m_failed)
+    throw(vpException(loop.m_errorCode, loop.m_errorMessage));
+#else
+  fn(begin, end, args);
+#endif
+}
@@ -0,0 +1,176 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test vpImagePyramid.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImagePyramid.cpp
+
+  \brief Check that vpImagePyramid levels match the reference pyramidal
+  filters, that the level buffers are reused from one build to the next,
+  and measure the time spent to build a pyramid.
+*/
+
+#include <visp3/core/vpImagePyramid.h>
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpTime.h>
+
+#include <stdlib.h>
+#include <iostream>
+
+namespace {
+  void fillRandom(vpImage<unsigned char> &I) {
+    for (unsigned int i = 0; i < I.getSize(); i++)
+      I.bitmap[i] = (unsigned char) (rand() % 256);
+  }
+
+  // Reference implementation using the per-pixel filters of vpImageFilter
+  void pyrDownReference(const vpImage<unsigned char> &I, vpImage<unsigned char> &GI) {
+    unsigned int w = I.getWidth()/2, h = I.getHeight()/2;
+    vpImage<unsigned char> GIx(I.getHeight(), w);
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      GIx[i][0] = I[i][0];
+      for (unsigned int j = 1; j+1 < w; j++)
+        GIx[i][j] = vpImageFilter::filterGaussXPyramidal(I, i, 2*j);
+      GIx[i][w-1] = I[i][2*w-1];
+    }
+
+    GI.resize(h, w);
+    for (unsigned int j = 0; j < w; j++) {
+      GI[0][j] = GIx[0][j];
+      for (unsigned int i = 1; i+1 < h; i++)
+        GI[i][j] = vpImageFilter::filterGaussYPyramidal(GIx, 2*i, j);
+      GI[h-1][j] = GIx[2*h-1][j];
+    }
+  }
+}
+
+int main()
+{
+  try {
+    const unsigned int sizes[][2] = { {480, 640}, {37, 53}, {16, 18}, {5, 7} };
+
+    // Levels against the reference filters
+    for (unsigned int s = 0; s < sizeof(sizes)/sizeof(sizes[0]); s++) {
+      vpImage<unsigned char> I(sizes[s][0], sizes[s][1]);
+      fillRandom(I);
+
+      vpImagePyramid pyramid(3);
+      pyramid.build(I);
+      vpImagePyramid subsampled(3, vpImagePyramid::SUBSAMPLING);
+      subsampled.build(I);
+
+      vpImage<unsigned char> ref = I;
+      for (unsigned int l = 1; l < pyramid.getNbLevels(); l++) {
+        vpImage<unsigned char> prev = ref;
+        pyrDownReference(prev, ref);
+        if (!(ref == pyramid[l])) {
+          std::cerr << "Problem with level " << l << " of the Gaussian pyramid of a "
+                    << I.getHeight() << "x" << I.getWidth() << " image" << std::endl;
+          return EXIT_FAILURE;
+        }
+
+        unsigned int scale = 1u << l;
+        const vpImage<unsigned char> &Il = subsampled[l];
+        if (Il.getHeight() != I.getHeight()/scale || Il.getWidth() != I.getWidth()/scale) {
+          std::cerr << "Problem with the size of level " << l << " of the subsampled pyramid" << std::endl;
+          return EXIT_FAILURE;
+        }
+        for (unsigned int i = 0; i < Il.getHeight(); i++) {
+          for (unsigned int j = 0; j < Il.getWidth(); j++) {
+            if (Il[i][j] != I[i*scale][j*scale]) {
+              std::cerr << "Problem with level " << l << " of the subsampled pyramid" << std::endl;
+              return EXIT_FAILURE;
+            }
+          }
+        }
+      }
+
+      if (&pyramid[0] != &I) {
+        std::cerr << "Level 0 should be the input image" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Level buffers are kept from one build to the next
+    vpImage<unsigned char> I(480, 640);
+    fillRandom(I);
+    vpImagePyramid pyramid(4);
+    pyramid.build(I);
+    const unsigned char *bitmap = pyramid[3].bitmap;
+    fillRandom(I);
+    pyramid.build(I);
+    if (pyramid[3].bitmap != bitmap) {
+      std::cerr << "Pyramid levels should not be reallocated" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    bool exception = false;
+    try {
+      pyramid.getLevel(4);
+    }
+    catch(const vpException &) {
+      exception = true;
+    }
+    if (!exception) {
+      std::cerr << "An exception should be thrown for an out of range level" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Time to build the pyramid
+    const unsigned int nbIter = 200;
+    double t_ref = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++) {
+      vpImage<unsigned char> *levels = new vpImage<unsigned char>[4];
+      levels[0] = I;
+      for (unsigned int l = 1; l < 4; l++)
+        vpImageFilter::getGaussPyramidal(levels[l-1], levels[l]);
+      delete [] levels;
+    }
+    t_ref = vpTime::measureTimeMs() - t_ref;
+
+    double t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      pyramid.build(I);
+    t = vpTime::measureTimeMs() - t;
+
+    std::cout << "4 levels pyramid of a 640x480 image (" << nbIter << " iterations): "
+              << t << " ms ; with getGaussPyramidal(): " << t_ref << " ms" << std::endl;
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,330 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Read PNM and raw images with vpMappedImageReader.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMappedImageReader.cpp
+
+  \brief Read PGM, PPM and raw image sequences with vpMappedImageReader and
+  vpDiskGrabber, with and without copy, and compare them with the images
+  read by vpImageIo.
+*/
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpDiskGrabber.h>
+#include <visp3/io/vpImageIo.h>
+#include <visp3/io/vpMappedImageReader.h>
+#include <visp3/io/vpParseArgv.h>
+
+#include <fstream>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdo:h"
+
+namespace {
+  void usage(const char *name, const char *badparam, const std::string &opath, const std::string &user)
+  {
+    fprintf(stdout, "\n\
+Test the memory-mapped reader of PNM and raw images.\n\
+\n\
+SYNOPSIS\n\
+  %s [-o <output image path>] [-h]\n", name);
+
+    fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -o <output image path>                               %s\n\
+     Set image output path.\n\
+     From this directory, creates the \"%s\"\n\
+     subdirectory depending on the username, where \n\
+     the image sequences are written and removed.\n\
+\n\
+  -h\n\
+     Print the help.\n\n",
+            opath.c_str(), user.c_str());
+
+    if (badparam)
+      fprintf(stdout, "\nERROR: Bad parameter [%s]\n", badparam);
+  }
+
+  bool getOptions(int argc, const char **argv, std::string &opath, const std::string &user)
+  {
+    const char *optarg_;
+    int	c;
+    while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+      switch (c) {
+      case 'o': opath = optarg_; break;
+      case 'h': usage(argv[0], NULL, opath, user); return false; break;
+
+      case 'c':
+      case 'd':
+        break;
+
+      default:
+        usage(argv[0], optarg_, opath, user); return false; break;
+      }
+    }
+
+    if ((c == 1) || (c == -1)) {
+      // standalone param or error
+      usage(argv[0], NULL, opath, user);
+      std::cerr << "ERROR: " << std::endl;
+      std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  // Image whose content depends on its number
+  void createImage(vpImage<vpRGBa> &I, unsigned int n)
+  {
+    I.resize(120, 160);
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        I[i][j] = vpRGBa((unsigned char) ((i + j + 7 * n) % 256), (unsigned char) ((2 * i + n) % 256),
+                         (unsigned char) ((3 * j + n) % 256), vpRGBa::alpha_default);
+  }
+
+  std::string imageName(const std::string &generic, unsigned int n)
+  {
+    char name[FILENAME_MAX];
+    sprintf(name, generic.c_str(), n);
+    return name;
+  }
+
+  // Compare the images of a sequence read by vpMappedImageReader and by vpImageIo
+  template<class Type>
+  bool checkSequence(vpMappedImageReader &reader, const std::string &generic, unsigned int nbImages, bool copyData)
+  {
+    vpImage<Type> I, R;
+    for (unsigned int n = 0; n < nbImages; n++) {
+      std::string name = imageName(generic, n);
+      reader.open(name);
+      reader.prefetch(imageName(generic, n + 1));
+      reader.read(I, copyData);
+      vpImageIo::read(R, name);
+      if (I != R) {
+        std::cerr << "Wrong image " << name << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+int main(int argc, const char **argv)
+{
+  try {
+    std::string opt_opath;
+    std::string opath;
+    std::string username;
+
+    // Set the default output path
+#if defined(_WIN32)
+    opt_opath = "C:/temp";
+#else
+    opt_opath = "/tmp";
+#endif
+
+    // Get the user login name
+    vpIoTools::getUserName(username);
+
+    // Read the command line options
+    if (getOptions(argc, argv, opt_opath, username) == false) {
+      return EXIT_FAILURE;
+    }
+
+    // Append to the output path string, the login name of the user
+    opath = vpIoTools::createFilePath(opt_opath, username);
+    opath = vpIoTools::createFilePath(opath, "testMappedImageReader");
+
+    // Test if the output path exist. If no try to create it
+    if (vpIoTools::checkDirectory(opath) == false) {
+      vpIoTools::makeDirectory(opath);
+    }
+
+    const unsigned int nbImages = 10;
+    std::string pgm = vpIoTools::createFilePath(opath, "image%04d.pgm");
+    std::string ppm = vpIoTools::createFilePath(opath, "image%04d.ppm");
+    std::string raw = vpIoTools::createFilePath(opath, "image%04d.raw");
+    const unsigned int rawOffset = 16;
+
+    vpImage<vpRGBa> C;
+    vpImage<unsigned char> G;
+    for (unsigned int n = 0; n < nbImages; n++) {
+      createImage(C, n);
+      vpImageConvert::convert(C, G);
+      vpImageIo::write(G, imageName(pgm, n));
+      vpImageIo::write(C, imageName(ppm, n));
+
+      std::ofstream fd(imageName(raw, n).c_str(), std::ios::binary);
+      std::vector<char> header(rawOffset, 0);
+      fd.write(&header[0], rawOffset);
+      fd.write((const char *)C.bitmap, C.getSize() * sizeof(vpRGBa));
+    }
+
+    // The header of the images of a sequence is decoded once
+    vpMappedImageReader reader;
+    if (! checkSequence<unsigned char>(reader, pgm, nbImages, false)
+        || ! checkSequence<unsigned char>(reader, pgm, nbImages, true)) {
+      return EXIT_FAILURE;
+    }
+    if (reader.getNbDecodedHeaders() != 1) {
+      std::cerr << "The PGM header is decoded " << reader.getNbDecodedHeaders() << " times" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (! checkSequence<vpRGBa>(reader, ppm, nbImages, false) || ! checkSequence<unsigned char>(reader, ppm, nbImages,
+                                                                                                true)) {
+      return EXIT_FAILURE;
+    }
+    if (reader.getNbDecodedHeaders() != 2) {
+      std::cerr << "The PPM header is decoded " << reader.getNbDecodedHeaders() - 1 << " times" << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << "Files mapped in memory: " << (reader.isMapped() ? "yes" : "no") << std::endl;
+
+    // Without copy, the image points on the mapped file, that is never modified
+    vpImage<unsigned char> I, R;
+    reader.open(imageName(pgm, 0));
+    reader.read(I, false);
+    if (I.bitmap != reader.getPayload()) {
+      std::cerr << "The PGM image is copied" << std::endl;
+      return EXIT_FAILURE;
+    }
+    I = 0;
+    reader.close();
+    vpImageIo::read(R, imageName(pgm, 0));
+    createImage(C, 0);
+    vpImageConvert::convert(C, G);
+    if (R != G) {
+      std::cerr << "The PGM file is modified through the image" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // An array given to init() without copy belongs to the image, that frees it,
+    // while an array given to initNonOwning() is left to the caller
+    unsigned char external[6] = { 1, 2, 3, 4, 5, 6 };
+    {
+      vpImage<unsigned char> owner(new unsigned char[6], 2, 3, false), user;
+      user.initNonOwning(external, 2, 3);
+      if (user.bitmap != external || user[1][2] != 6) {
+        std::cerr << "The external array is copied" << std::endl;
+        return EXIT_FAILURE;
+      }
+      user.resize(4, 5);
+      user = 0;
+      owner = user;
+    }
+    if (external[0] != 1 || external[5] != 6) {
+      std::cerr << "The external array is modified" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Raw RGBa images are read without copy too
+    reader.setRawFormat(120, 160, 4, rawOffset);
+    vpImage<vpRGBa> Ic;
+    for (unsigned int n = 0; n < nbImages; n++) {
+      reader.open(imageName(raw, n));
+      reader.read(Ic, false);
+      createImage(C, n);
+      if (Ic != C || (unsigned char *)Ic.bitmap != reader.getPayload()) {
+        std::cerr << "Wrong raw image " << n << std::endl;
+        return EXIT_FAILURE;
+      }
+      reader.read(I, true);
+      vpImageConvert::convert(C, G);
+      if (I != G) {
+        std::cerr << "Wrong raw image " << n << " converted in grey" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // A truncated file is detected
+    reader.setRawFormat(121, 160, 4, rawOffset);
+    try {
+      reader.open(imageName(raw, 0));
+      std::cerr << "The truncated raw file is not detected" << std::endl;
+      return EXIT_FAILURE;
+    }
+    catch(vpException &e) {
+      std::cout << "Catch the truncated raw file: " << e.getStringMessage() << std::endl;
+    }
+    reader.setPNMFormat();
+
+    // Replay the PGM sequence with vpDiskGrabber
+    vpDiskGrabber g(pgm.c_str());
+    g.setZeroCopy(true);
+    g.setImageNumber(0);
+    g.open(I);
+    double t = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nbImages; n++) {
+      g.acquire(I);
+      createImage(C, n);
+      vpImageConvert::convert(C, G);
+      if (I != G) {
+        std::cerr << "Wrong image " << n << " read by vpDiskGrabber" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    t = vpTime::measureTimeMs() - t;
+    std::cout << "vpDiskGrabber::acquire() without copy: " << t / nbImages << " ms" << std::endl;
+    g.close();
+
+    // The image keeps its bitmap once resized
+    I.resize(10, 10, 1);
+    if (I[9][9] != 1) {
+      std::cerr << "Problem with the resized image" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    for (unsigned int n = 0; n < nbImages; n++) {
+      vpIoTools::remove(imageName(pgm, n));
+      vpIoTools::remove(imageName(ppm, n));
+      vpIoTools::remove(imageName(raw, n));
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
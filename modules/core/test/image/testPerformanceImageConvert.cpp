@@ -0,0 +1,335 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark the colour conversions of vpImageConvert.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceImageConvert.cpp
+
+  \brief Check the colour conversions used by the frame grabbers against
+  reference scalar implementations and report their throughput in
+  megapixels per second.
+*/
+
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdn:t:h"
+
+namespace {
+  void usage(const char *name, const char *badparam, unsigned int nbIter, unsigned int nbThreads)
+  {
+    fprintf(stdout, "\n\
+Benchmark the colour conversions of vpImageConvert on 640x480 images.\n\
+\n\
+SYNOPSIS\n\
+  %s [-n <iterations>] [-t <threads>] [-c] [-d] [-h]\n", name);
+
+    fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -n <iterations>                                      %u\n\
+     Number of conversions of each type.\n\
+\n\
+  -t <threads>                                         %u\n\
+     Number of threads used by the conversions that support\n\
+     row band multithreading.\n\
+\n\
+  -c\n\
+     Disable the mouse click. Useless in this test.\n\
+\n\
+  -d\n\
+     Disable the image display. Useless in this test.\n\
+\n\
+  -h\n\
+     Print the help.\n\n", nbIter, nbThreads);
+
+    if (badparam)
+      fprintf(stdout, "\nERROR: Bad parameter [%s]\n", badparam);
+  }
+
+  bool getOptions(int argc, const char **argv, unsigned int &nbIter, unsigned int &nbThreads)
+  {
+    const char *optarg_;
+    int c;
+    while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+      switch (c) {
+      case 'n': nbIter = (unsigned int) atoi(optarg_); break;
+      case 't': nbThreads = (unsigned int) atoi(optarg_); break;
+      case 'c': break;
+      case 'd': break;
+      case 'h': usage(argv[0], NULL, nbIter, nbThreads); return false; break;
+
+      default:
+        usage(argv[0], optarg_, nbIter, nbThreads);
+        return false; break;
+      }
+    }
+
+    if ((c == 1) || (c == -1)) {
+      // standalone param or error
+      usage(argv[0], NULL, nbIter, nbThreads);
+      std::cerr << "ERROR: " << std::endl;
+      std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  void fillRandom(std::vector<unsigned char> &buffer) {
+    for (size_t i = 0; i < buffer.size(); i++)
+      buffer[i] = (unsigned char) (rand() % 256);
+  }
+
+  unsigned char saturate(int v) {
+    return (unsigned char) (v < 0 ? 0 : (v > 255 ? 255 : v));
+  }
+
+  // Reference implementations
+  void YUYVToRGBaReference(const unsigned char *yuyv, unsigned char *rgba, unsigned int width, unsigned int height) {
+    for (unsigned int i = 0; i < width*height/2; i++) {
+      const unsigned char *s = yuyv + 4*i;
+      int cb = ((s[1] - 128) * 454) >> 8;
+      int cg = ((s[1] - 128) * 88 + (s[3] - 128) * 183) >> 8;
+      int cr = ((s[3] - 128) * 359) >> 8;
+      for (unsigned int k = 0; k < 2; k++) {
+        int y = s[2*k];
+        unsigned char *d = rgba + 8*i + 4*k;
+        d[0] = saturate(y + cr);
+        d[1] = saturate(y - cg);
+        d[2] = saturate(y + cb);
+        d[3] = vpRGBa::alpha_default;
+      }
+    }
+  }
+
+  void YUV420ToRGBaReference(const unsigned char *yuv, unsigned char *rgba, unsigned int width, unsigned int height) {
+    const unsigned char *iU = yuv + width*height;
+    const unsigned char *iV = yuv + 5*width*height/4;
+    for (unsigned int i = 0; i < height; i++) {
+      for (unsigned int j = 0; j < width; j++) {
+        int U = (int)((iU[(i/2)*(width/2) + j/2] - 128) * 0.354);
+        int V = (int)((iV[(i/2)*(width/2) + j/2] - 128) * 0.707);
+        int Y = yuv[i*width + j];
+        unsigned char *d = rgba + 4*(i*width + j);
+        d[0] = saturate(Y + 2*V);
+        d[1] = saturate(Y - U - V);
+        d[2] = saturate(Y + 5*U);
+        d[3] = vpRGBa::alpha_default;
+      }
+    }
+  }
+
+  void YCbCrToRGBReference(const unsigned char *ycbcr, unsigned char *rgb, unsigned int size) {
+    for (unsigned int i = 0; i < size; i++) {
+      const unsigned char *m = ycbcr + 4*(i/2);
+      int y = ycbcr[2*i];
+      int cr = m[3] - 128, cb = m[1] - 128;
+      rgb[3*i]   = saturate(y + (((int) (364.6610 * cr)) >> 8));
+      rgb[3*i+1] = saturate(y + (((int) (-89.8779 * cb)) >> 8) + (((int) (-185.8154 * cr)) >> 8));
+      rgb[3*i+2] = saturate(y + (((int) (460.5724 * cb)) >> 8));
+    }
+  }
+
+  bool check(const std::string &name, const std::vector<unsigned char> &result,
+             const std::vector<unsigned char> &reference, int tolerance) {
+    for (size_t i = 0; i < reference.size(); i++) {
+      if (std::abs((int) result[i] - (int) reference[i]) > tolerance) {
+        std::cerr << "Problem with " << name << " at byte " << i << ": " << (int) result[i]
+                  << " instead of " << (int) reference[i] << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void printThroughput(const std::string &name, double t, unsigned int nbIter, unsigned int size) {
+    std::cout << name << ": " << t / nbIter << " ms, " << (double) size * nbIter / (t * 1000.) << " MP/s" << std::endl;
+  }
+}
+
+int main(int argc, const char **argv)
+{
+  try {
+    unsigned int nbIter = 50;
+    unsigned int nbThreads = 2;
+    if (getOptions(argc, argv, nbIter, nbThreads) == false) {
+      return EXIT_FAILURE;
+    }
+
+    const unsigned int width = 640, height = 480, size = width*height;
+
+    // Small sizes exercise the scalar tails of the vectorized loops
+    const unsigned int sizes[][2] = { {width, height}, {38, 6} };
+    for (unsigned int s = 0; s < sizeof(sizes)/sizeof(sizes[0]); s++) {
+      unsigned int w = sizes[s][0], h = sizes[s][1];
+      std::vector<unsigned char> yuyv(2*w*h), yuv420(3*w*h/2), rgba(4*w*h), rgb(3*w*h), grey(w*h);
+      std::vector<unsigned char> rgba_ref(4*w*h), rgb_ref(3*w*h), grey_ref(w*h);
+      fillRandom(yuyv);
+      fillRandom(yuv420);
+
+      vpImageConvert::YUYVToRGBa(&yuyv[0], &rgba[0], w, h);
+      YUYVToRGBaReference(&yuyv[0], &rgba_ref[0], w, h);
+      if (!check("YUYVToRGBa()", rgba, rgba_ref, 0))
+        return EXIT_FAILURE;
+
+      vpImageConvert::YUYVToRGBa(&yuyv[0], &rgba[0], w, h, 3);
+      if (!check("YUYVToRGBa() with 3 threads", rgba, rgba_ref, 0))
+        return EXIT_FAILURE;
+
+      vpImageConvert::YUYVToGrey(&yuyv[0], &grey[0], w*h);
+      for (unsigned int i = 0; i < w*h; i++)
+        grey_ref[i] = yuyv[2*i];
+      if (!check("YUYVToGrey()", grey, grey_ref, 0))
+        return EXIT_FAILURE;
+
+      vpImageConvert::YUV422ToGrey(&yuyv[0], &grey[0], w*h);
+      for (unsigned int i = 0; i < w*h; i++)
+        grey_ref[i] = yuyv[2*i+1];
+      if (!check("YUV422ToGrey()", grey, grey_ref, 0))
+        return EXIT_FAILURE;
+
+      vpImageConvert::YUV420ToRGBa(&yuv420[0], &rgba[0], w, h);
+      YUV420ToRGBaReference(&yuv420[0], &rgba_ref[0], w, h);
+      if (!check("YUV420ToRGBa()", rgba, rgba_ref, 0))
+        return EXIT_FAILURE;
+
+      vpImageConvert::YCbCrToRGB(&yuyv[0], &rgb[0], w*h);
+      YCbCrToRGBReference(&yuyv[0], &rgb_ref[0], w*h);
+      if (!check("YCbCrToRGB()", rgb, rgb_ref, 0))
+        return EXIT_FAILURE;
+
+      vpImage<vpRGBa> Ic(h, w);
+      for (unsigned int i = 0; i < w*h; i++)
+        Ic.bitmap[i] = vpRGBa(yuyv[2*i], yuyv[2*i+1], yuv420[i]);
+      for (unsigned int i = 0; i < w*h; i++)
+        grey_ref[i] = (unsigned char) (0.2126 * Ic.bitmap[i].R + 0.7152 * Ic.bitmap[i].G + 0.0722 * Ic.bitmap[i].B);
+      for (unsigned int t = 1; t <= 3; t += 2) {
+        vpImage<unsigned char> I;
+        vpImageConvert::convert(Ic, I, t);
+        std::vector<unsigned char> result(I.bitmap, I.bitmap + I.getSize());
+        if (!check("convert(vpImage<vpRGBa>, vpImage<unsigned char>)", result, grey_ref, 1))
+          return EXIT_FAILURE;
+      }
+    }
+
+    // Throughput
+    std::vector<unsigned char> yuyv(2*size), yuv420(3*size/2), rgba(4*size), rgb(3*size), grey(size);
+    fillRandom(yuyv);
+    fillRandom(yuv420);
+    fillRandom(rgb);
+    vpImage<vpRGBa> Ic(height, width);
+    for (unsigned int i = 0; i < size; i++)
+      Ic.bitmap[i] = vpRGBa(rgb[3*i], rgb[3*i+1], rgb[3*i+2]);
+    vpImage<unsigned char> I;
+
+    double t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      YUYVToRGBaReference(&yuyv[0], &rgba[0], width, height);
+    printThroughput("YUYVToRGBa() reference", vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      vpImageConvert::YUYVToRGBa(&yuyv[0], &rgba[0], width, height);
+    printThroughput("YUYVToRGBa()", vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      vpImageConvert::YUYVToRGBa(&yuyv[0], &rgba[0], width, height, nbThreads);
+    std::stringstream ss;
+    ss << "YUYVToRGBa() with " << nbThreads << " threads";
+    printThroughput(ss.str(), vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      vpImageConvert::YUYVToGrey(&yuyv[0], &grey[0], size);
+    printThroughput("YUYVToGrey()", vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      vpImageConvert::YUV422ToGrey(&yuyv[0], &grey[0], size);
+    printThroughput("YUV422ToGrey()", vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      YUV420ToRGBaReference(&yuv420[0], &rgba[0], width, height);
+    printThroughput("YUV420ToRGBa() reference", vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      vpImageConvert::YUV420ToRGBa(&yuv420[0], &rgba[0], width, height);
+    printThroughput("YUV420ToRGBa()", vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      vpImageConvert::YCbCrToRGB(&yuyv[0], &rgb[0], size);
+    printThroughput("YCbCrToRGB()", vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      vpImageConvert::RGBToGrey(&rgb[0], &grey[0], size);
+    printThroughput("RGBToGrey()", vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      vpImageConvert::BGRToGrey(&rgb[0], &grey[0], width, height);
+    printThroughput("BGRToGrey()", vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      vpImageConvert::convert(Ic, I);
+    printThroughput("convert(vpImage<vpRGBa>, vpImage<unsigned char>)", vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      vpImageConvert::convert(Ic, I, nbThreads);
+    ss.str("");
+    ss << "convert(vpImage<vpRGBa>, vpImage<unsigned char>) with " << nbThreads << " threads";
+    printThroughput(ss.str(), vpTime::measureTimeMs() - t, nbIter, size);
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,351 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the separable filters of vpImageFilter and their performances.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceImageFilter.cpp
+
+  \brief Check the separable filters, Gaussian blur and gradients of
+  vpImageFilter against the per-pixel helpers of the class, in double and
+  single precision and with several threads, and report their throughput in
+  megapixels per second.
+*/
+
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdn:t:h"
+
+namespace {
+  void usage(const char *name, const char *badparam, unsigned int nbIter, unsigned int nbThreads)
+  {
+    fprintf(stdout, "\n\
+Benchmark the separable filters of vpImageFilter on 640x480 images.\n\
+\n\
+SYNOPSIS\n\
+  %s [-n <iterations>] [-t <threads>] [-c] [-d] [-h]\n", name);
+
+    fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -n <iterations>                                      %u\n\
+     Number of filterings of each type.\n\
+\n\
+  -t <threads>                                         %u\n\
+     Number of threads used to filter the row bands.\n\
+\n\
+  -c\n\
+     Disable the mouse click. Useless in this test.\n\
+\n\
+  -d\n\
+     Disable the image display. Useless in this test.\n\
+\n\
+  -h\n\
+     Print the help.\n\n", nbIter, nbThreads);
+
+    if (badparam)
+      fprintf(stdout, "\nERROR: Bad parameter [%s]\n", badparam);
+  }
+
+  bool getOptions(int argc, const char **argv, unsigned int &nbIter, unsigned int &nbThreads)
+  {
+    const char *optarg_;
+    int c;
+    while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+      switch (c) {
+      case 'n': nbIter = (unsigned int) atoi(optarg_); break;
+      case 't': nbThreads = (unsigned int) atoi(optarg_); break;
+      case 'c': break;
+      case 'd': break;
+      case 'h': usage(argv[0], NULL, nbIter, nbThreads); return false; break;
+
+      default:
+        usage(argv[0], optarg_, nbIter, nbThreads);
+        return false; break;
+      }
+    }
+
+    if ((c == 1) || (c == -1)) {
+      // standalone param or error
+      usage(argv[0], NULL, nbIter, nbThreads);
+      std::cerr << "ERROR: " << std::endl;
+      std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  // Reference implementations, pixel by pixel with the border helpers
+  template<class T>
+  void filterXReference(const vpImage<T> &I, vpImage<double> &dIx, const double *filter, unsigned int size) {
+    dIx.resize(I.getHeight(), I.getWidth());
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < (size-1)/2; j++)
+        dIx[i][j] = vpImageFilter::filterXLeftBorder(I, i, j, filter, size);
+      for (unsigned int j = (size-1)/2; j < I.getWidth()-(size-1)/2; j++)
+        dIx[i][j] = vpImageFilter::filterX(I, i, j, filter, size);
+      for (unsigned int j = I.getWidth()-(size-1)/2; j < I.getWidth(); j++)
+        dIx[i][j] = vpImageFilter::filterXRightBorder(I, i, j, filter, size);
+    }
+  }
+
+  template<class T>
+  void filterYReference(const vpImage<T> &I, vpImage<double> &dIy, const double *filter, unsigned int size) {
+    dIy.resize(I.getHeight(), I.getWidth());
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        if (i < (size-1)/2)
+          dIy[i][j] = vpImageFilter::filterYTopBorder(I, i, j, filter, size);
+        else if (i < I.getHeight()-(size-1)/2)
+          dIy[i][j] = vpImageFilter::filterY(I, i, j, filter, size);
+        else
+          dIy[i][j] = vpImageFilter::filterYBottomBorder(I, i, j, filter, size);
+      }
+    }
+  }
+
+  template<class T>
+  void getGradXReference(const vpImage<T> &I, vpImage<double> &dIx, const double *filter, unsigned int size) {
+    dIx.resize(I.getHeight(), I.getWidth(), 0);
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = (size-1)/2; j < I.getWidth()-(size-1)/2; j++)
+        dIx[i][j] = vpImageFilter::derivativeFilterX(I, i, j, filter, size);
+  }
+
+  template<class T>
+  void getGradYReference(const vpImage<T> &I, vpImage<double> &dIy, const double *filter, unsigned int size) {
+    dIy.resize(I.getHeight(), I.getWidth(), 0);
+    for (unsigned int i = (size-1)/2; i < I.getHeight()-(size-1)/2; i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        dIy[i][j] = vpImageFilter::derivativeFilterY(I, i, j, filter, size);
+  }
+
+  template<class T>
+  bool check(const std::string &name, const vpImage<T> &result, const vpImage<double> &reference, double tolerance) {
+    if (result.getHeight() != reference.getHeight() || result.getWidth() != reference.getWidth()) {
+      std::cerr << "Problem with " << name << ": bad image size" << std::endl;
+      return false;
+    }
+    for (unsigned int i = 0; i < reference.getSize(); i++) {
+      if (std::fabs(result.bitmap[i] - reference.bitmap[i]) > tolerance) {
+        std::cerr << "Problem with " << name << " at pixel " << i << ": " << result.bitmap[i]
+                  << " instead of " << reference.bitmap[i] << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void printThroughput(const std::string &name, double t, unsigned int nbIter, unsigned int size) {
+    std::cout << name << ": " << t / nbIter << " ms, " << (double) size * nbIter / (t * 1000.) << " MP/s" << std::endl;
+  }
+}
+
+int main(int argc, const char **argv)
+{
+  try {
+    unsigned int nbIter = 20;
+    unsigned int nbThreads = 2;
+    if (getOptions(argc, argv, nbIter, nbThreads) == false) {
+      return EXIT_FAILURE;
+    }
+
+    const unsigned int width = 640, height = 480, size = width*height;
+
+    // Small sizes exercise the scalar tails of the vectorized loops
+    const unsigned int sizes[][2] = { {width, height}, {37, 23}, {9, 10} };
+    for (unsigned int s = 0; s < sizeof(sizes)/sizeof(sizes[0]); s++) {
+      vpImage<unsigned char> I(sizes[s][1], sizes[s][0]);
+      vpImage<double> Id(I.getHeight(), I.getWidth());
+      vpImage<float> If(I.getHeight(), I.getWidth());
+      for (unsigned int i = 0; i < I.getSize(); i++) {
+        I.bitmap[i] = (unsigned char) (rand() % 256);
+        Id.bitmap[i] = I.bitmap[i] + (double) rand() / RAND_MAX;
+        If.bitmap[i] = I.bitmap[i];
+      }
+
+      for (unsigned int kernelSize = 3; kernelSize <= 9; kernelSize += 2) {
+        std::vector<double> fg((kernelSize+1)/2), fgd((kernelSize+1)/2);
+        vpImageFilter::getGaussianKernel(&fg[0], kernelSize);
+        vpImageFilter::getGaussianDerivativeKernel(&fgd[0], kernelSize);
+
+        vpImage<double> ref, ref2, tmp, result;
+        vpImage<float> result_f;
+        for (unsigned int t = 1; t <= 3; t += 2) {
+          // Double precision results are identical to the per-pixel helpers
+          filterXReference(I, ref, &fg[0], kernelSize);
+          vpImageFilter::filterX(I, result, &fg[0], kernelSize, t);
+          if (!check("filterX(vpImage<unsigned char>)", result, ref, 0))
+            return EXIT_FAILURE;
+          vpImageFilter::filterX(I, result_f, &fg[0], kernelSize, t);
+          if (!check("filterX(vpImage<unsigned char>, vpImage<float>)", result_f, ref, 1e-3))
+            return EXIT_FAILURE;
+
+          filterXReference(Id, ref, &fg[0], kernelSize);
+          vpImageFilter::filterX(Id, result, &fg[0], kernelSize, t);
+          if (!check("filterX(vpImage<double>)", result, ref, 0))
+            return EXIT_FAILURE;
+
+          filterYReference(I, ref, &fg[0], kernelSize);
+          vpImageFilter::filterY(I, result, &fg[0], kernelSize, t);
+          if (!check("filterY(vpImage<unsigned char>)", result, ref, 0))
+            return EXIT_FAILURE;
+          vpImageFilter::filterY(If, result_f, &fg[0], kernelSize, t);
+          if (!check("filterY(vpImage<float>)", result_f, ref, 1e-3))
+            return EXIT_FAILURE;
+
+          filterYReference(Id, ref, &fg[0], kernelSize);
+          vpImageFilter::filterY(Id, result, &fg[0], kernelSize, t);
+          if (!check("filterY(vpImage<double>)", result, ref, 0))
+            return EXIT_FAILURE;
+
+          filterXReference(I, tmp, &fg[0], kernelSize);
+          filterYReference(tmp, ref, &fg[0], kernelSize);
+          vpImageFilter::gaussianBlur(I, result, kernelSize, 0., true, t);
+          if (!check("gaussianBlur()", result, ref, 0))
+            return EXIT_FAILURE;
+          vpImageFilter::gaussianBlur(I, result_f, kernelSize, 0., true, t);
+          if (!check("gaussianBlur() in single precision", result_f, ref, 1e-3))
+            return EXIT_FAILURE;
+
+          getGradXReference(I, ref, &fgd[0], kernelSize);
+          vpImageFilter::getGradX(I, result, &fgd[0], kernelSize, t);
+          if (!check("getGradX(vpImage<unsigned char>)", result, ref, 0))
+            return EXIT_FAILURE;
+          vpImageFilter::getGradX(I, result_f, &fgd[0], kernelSize, t);
+          if (!check("getGradX(vpImage<unsigned char>, vpImage<float>)", result_f, ref, 1e-3))
+            return EXIT_FAILURE;
+
+          getGradYReference(Id, ref, &fgd[0], kernelSize);
+          vpImageFilter::getGradY(Id, result, &fgd[0], kernelSize, t);
+          if (!check("getGradY(vpImage<double>)", result, ref, 0))
+            return EXIT_FAILURE;
+          vpImageFilter::getGradY(If, result_f, &fgd[0], kernelSize, t);
+          getGradYReference(If, ref, &fgd[0], kernelSize);
+          if (!check("getGradY(vpImage<float>)", result_f, ref, 1e-3))
+            return EXIT_FAILURE;
+
+          filterYReference(I, tmp, &fg[0], kernelSize);
+          getGradXReference(tmp, ref, &fgd[0], kernelSize);
+          vpImageFilter::getGradXGauss2D(I, result, &fg[0], &fgd[0], kernelSize, t);
+          if (!check("getGradXGauss2D()", result, ref, 0))
+            return EXIT_FAILURE;
+          vpImageFilter::getGradXGauss2D(I, result_f, &fg[0], &fgd[0], kernelSize, t);
+          if (!check("getGradXGauss2D() in single precision", result_f, ref, 1e-3))
+            return EXIT_FAILURE;
+
+          filterXReference(I, tmp, &fg[0], kernelSize);
+          getGradYReference(tmp, ref2, &fgd[0], kernelSize);
+          vpImageFilter::getGradYGauss2D(I, result, &fg[0], &fgd[0], kernelSize, t);
+          if (!check("getGradYGauss2D()", result, ref2, 0))
+            return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // Throughput
+    vpImage<unsigned char> I(height, width);
+    for (unsigned int i = 0; i < size; i++)
+      I.bitmap[i] = (unsigned char) (rand() % 256);
+    const unsigned int kernelSize = 7;
+    std::vector<double> fg((kernelSize+1)/2), fgd((kernelSize+1)/2);
+    vpImageFilter::getGaussianKernel(&fg[0], kernelSize);
+    vpImageFilter::getGaussianDerivativeKernel(&fgd[0], kernelSize);
+    vpImage<double> tmp, G;
+    vpImage<float> G_f;
+
+    double t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++) {
+      filterXReference(I, tmp, &fg[0], kernelSize);
+      filterYReference(tmp, G, &fg[0], kernelSize);
+    }
+    printThroughput("gaussianBlur() reference", vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      vpImageFilter::gaussianBlur(I, G, kernelSize);
+    printThroughput("gaussianBlur()", vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      vpImageFilter::gaussianBlur(I, G_f, kernelSize);
+    printThroughput("gaussianBlur() in single precision", vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      vpImageFilter::gaussianBlur(I, G_f, kernelSize, 0., true, nbThreads);
+    std::stringstream ss;
+    ss << "gaussianBlur() in single precision with " << nbThreads << " threads";
+    printThroughput(ss.str(), vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++) {
+      filterYReference(I, tmp, &fg[0], kernelSize);
+      getGradXReference(tmp, G, &fgd[0], kernelSize);
+    }
+    printThroughput("getGradXGauss2D() reference", vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      vpImageFilter::getGradXGauss2D(I, G, &fg[0], &fgd[0], kernelSize);
+    printThroughput("getGradXGauss2D()", vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      vpImageFilter::getGradXGauss2D(I, G_f, &fg[0], &fgd[0], kernelSize);
+    printThroughput("getGradXGauss2D() in single precision", vpTime::measureTimeMs() - t, nbIter, size);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      vpImageFilter::getGradXGauss2D(I, G_f, &fg[0], &fgd[0], kernelSize, nbThreads);
+    ss.str("");
+    ss << "getGradXGauss2D() in single precision with " << nbThreads << " threads";
+    printThroughput(ss.str(), vpTime::measureTimeMs() - t, nbIter, size);
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
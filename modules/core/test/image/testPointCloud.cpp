@@ -0,0 +1,316 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the deprojection of a depth map into a vpPointCloud.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPointCloud.cpp
+
+  \brief Check the points of a vpPointCloud built from integer and metric
+  depth maps against a straightforward deprojection, with several threads,
+  and compare the time with a point cloud stored as a vector of vpColVector.
+*/
+
+#include <visp3/core/vpPointCloud.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+
+#include <stdlib.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdh"
+
+namespace {
+  void usage(const char *name, const char *badparam)
+  {
+    fprintf(stdout, "\n\
+Compare the points of a vpPointCloud with a reference deprojection.\n\
+\n\
+SYNOPSIS\n\
+  %s [-c] [-d] [-h]\n", name);
+
+    fprintf(stdout, "\n\
+OPTIONS:\n\
+  -c\n\
+     Disable the mouse click. Useless in this test.\n\
+\n\
+  -d\n\
+     Disable the image display. Useless in this test.\n\
+\n\
+  -h\n\
+     Print the help.\n\n");
+
+    if (badparam)
+      fprintf(stdout, "\nERROR: Bad parameter [%s]\n", badparam);
+  }
+
+  bool getOptions(int argc, const char **argv)
+  {
+    const char *optarg_;
+    int c;
+    while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+      switch (c) {
+      case 'c': break;
+      case 'd': break;
+      case 'h': usage(argv[0], NULL); return false; break;
+
+      default:
+        usage(argv[0], optarg_);
+        return false; break;
+      }
+    }
+
+    if ((c == 1) || (c == -1)) {
+      // standalone param or error
+      usage(argv[0], NULL);
+      std::cerr << "ERROR: " << std::endl;
+      std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  // Depth map in millimeters with holes (0) and far points
+  void getDepthMap(unsigned int height, unsigned int width, vpImage<uint16_t> &depth) {
+    depth.resize(height, width);
+    for (unsigned int i = 0; i < depth.getSize(); i++) {
+      depth.bitmap[i] = (rand() % 10 == 0) ? 0 : (uint16_t) (300 + rand() % 9000);
+    }
+  }
+
+  // Straightforward deprojection of the point of pixel (i, j)
+  void deproject(const vpCameraParameters &cam, unsigned int i, unsigned int j, double Z, double &X, double &Y) {
+    X = (j - cam.get_u0()) / cam.get_px() * Z;
+    Y = (i - cam.get_v0()) / cam.get_py() * Z;
+  }
+
+  bool isEqual(float a, float b) {
+    if (vpMath::isNaN(a) || vpMath::isNaN(b))
+      return vpMath::isNaN(a) && vpMath::isNaN(b);
+    return std::fabs(a - b) <= 1e-5f * std::max(1.f, std::fabs(b));
+  }
+
+  // Compare the cloud with the reference, the depth being d * scale
+  template<typename Type>
+  bool checkCloud(const vpPointCloud &cloud, const vpImage<Type> &depth, const vpCameraParameters &cam, float scale,
+                  float maxZ) {
+    if (cloud.getHeight() != depth.getHeight() || cloud.getWidth() != depth.getWidth()) {
+      std::cerr << "Bad size of the point cloud" << std::endl;
+      return false;
+    }
+
+    unsigned int nbValid = 0;
+    for (unsigned int i = 0; i < depth.getHeight(); i++) {
+      for (unsigned int j = 0; j < depth.getWidth(); j++) {
+        const unsigned int k = cloud.getIndex(i, j);
+        const float Z = depth[i][j] * scale;
+        const bool valid = Z > 0 && (maxZ <= 0 || Z <= maxZ);
+        float X_ref = cloud.getInvalidValue(), Y_ref = cloud.getInvalidValue(), Z_ref = cloud.getInvalidValue();
+        if (valid) {
+          double X, Y;
+          deproject(cam, i, j, Z, X, Y);
+          X_ref = (float) X;
+          Y_ref = (float) Y;
+          Z_ref = Z;
+          nbValid++;
+        }
+
+        if (cloud.isValid(i, j) != valid || !isEqual(cloud.getX()[k], X_ref) || !isEqual(cloud.getY()[k], Y_ref)
+            || !isEqual(cloud.getZ()[k], Z_ref)) {
+          std::cerr << "Bad point (" << i << ", " << j << "): " << cloud.getX()[k] << " " << cloud.getY()[k] << " "
+                    << cloud.getZ()[k] << " (" << cloud.isValid(i, j) << ") instead of " << X_ref << " " << Y_ref
+                    << " " << Z_ref << " (" << valid << ")" << std::endl;
+          return false;
+        }
+      }
+    }
+
+    if (cloud.getNbValid() != nbValid) {
+      std::cerr << "Bad number of valid points: " << cloud.getNbValid() << " instead of " << nbValid << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  // Former deprojection of vpRealSense into a vector of vpColVector
+  void deproject(const vpImage<uint16_t> &depth, const vpCameraParameters &cam, float scale, float maxZ,
+                 std::vector<vpColVector> &pointcloud) {
+    pointcloud.resize(depth.getSize());
+    for (unsigned int i = 0; i < depth.getHeight(); i++) {
+      for (unsigned int j = 0; j < depth.getWidth(); j++) {
+        double Z = depth[i][j] * scale, X = 0, Y = 0;
+        if (Z > maxZ)
+          Z = 0;
+        deproject(cam, i, j, Z, X, Y);
+        vpColVector p(4);
+        p[0] = X;
+        p[1] = Y;
+        p[2] = Z;
+        p[3] = 1;
+        pointcloud[i*depth.getWidth() + j] = p;
+      }
+    }
+  }
+}
+
+int main(int argc, const char **argv)
+{
+  try {
+    if (!getOptions(argc, argv))
+      return EXIT_FAILURE;
+
+    srand(0);
+    vpCameraParameters cam(600.0, 590.0, 321.3, 238.7);
+    vpPointCloud cloud;
+
+    // Odd widths to check the pixels that are not processed with SSE2
+    const unsigned int sizes[4][2] = { {480, 640}, {7, 13}, {1, 3}, {31, 1} };
+    const unsigned int nbThreads[3] = { 1, 2, 4 };
+    for (unsigned int s = 0; s < 4; s++) {
+      vpImage<uint16_t> depth;
+      getDepthMap(sizes[s][0], sizes[s][1], depth);
+
+      vpImage<float> depth_float(depth.getHeight(), depth.getWidth());
+      for (unsigned int i = 0; i < depth.getSize(); i++) {
+        depth_float.bitmap[i] = (depth.bitmap[i] == 0) ? -1.f : depth.bitmap[i] * 0.001f;
+      }
+      depth_float.bitmap[0] = std::numeric_limits<float>::quiet_NaN();
+
+      for (unsigned int t = 0; t < 3; t++) {
+        cloud.setNbThreads(nbThreads[t]);
+
+        cloud.setInvalidValue(0);
+        cloud.buildFrom(depth, cam, 0.001f);
+        if (!checkCloud(cloud, depth, cam, 0.001f, -1.f))
+          return EXIT_FAILURE;
+
+        cloud.setInvalidValue(std::numeric_limits<float>::quiet_NaN());
+        cloud.buildFrom(depth, cam, 0.001f, 5.f);
+        if (!checkCloud(cloud, depth, cam, 0.001f, 5.f))
+          return EXIT_FAILURE;
+
+        cloud.setInvalidValue(-1);
+        cloud.buildFrom(depth_float, cam, 4.f);
+        if (!checkCloud(cloud, depth_float, cam, 1.f, 4.f))
+          return EXIT_FAILURE;
+      }
+      std::cout << "Point cloud of size " << depth.getHeight() << "x" << depth.getWidth() << " is ok" << std::endl;
+    }
+
+    // Color and conversion into a vector of vpColVector
+    cloud.setInvalidValue(0);
+    vpImage<uint16_t> depth;
+    getDepthMap(5, 6, depth);
+    cloud.buildFrom(depth, cam, 0.001f);
+    if (cloud.hasColor()) {
+      std::cerr << "The cloud should not have a color" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    try {
+      cloud.setColor(vpImage<vpRGBa>(6, 5));
+      std::cerr << "setColor() should throw with an image of a bad size" << std::endl;
+      return EXIT_FAILURE;
+    }
+    catch(const vpException &) {
+    }
+
+    vpImage<vpRGBa> color(5, 6, vpRGBa(10, 20, 30, 40));
+    cloud.setColor(color);
+    cloud.buildFrom(depth, cam, 0.001f);
+    if (!cloud.hasColor() || cloud.getColor()[29] != vpRGBa(10, 20, 30, 40)) {
+      std::cerr << "Bad color of the cloud" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::vector<vpColVector> pointcloud;
+    cloud.convert(pointcloud);
+    if (pointcloud.size() != cloud.getSize()) {
+      std::cerr << "Bad size of the converted cloud" << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (unsigned int k = 0; k < cloud.getSize(); k++) {
+      if (pointcloud[k].getRows() != 4 || pointcloud[k][2] != cloud.getZ()[k] || pointcloud[k][3] != 1) {
+        std::cerr << "Bad converted point " << k << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    cloud.clear();
+    if (cloud.getSize() != 0 || cloud.hasColor() || cloud.getNbValid() != 0) {
+      std::cerr << "The cloud should be empty" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Time compared with a vector of vpColVector
+    getDepthMap(480, 640, depth);
+    const int nbIter = 20;
+    double t = vpTime::measureTimeMs();
+    for (int iter = 0; iter < nbIter; iter++) {
+      deproject(depth, cam, 0.001f, 8.f, pointcloud);
+    }
+    double t_ref = vpTime::measureTimeMs() - t;
+
+    cloud.setNbThreads(1);
+    t = vpTime::measureTimeMs();
+    for (int iter = 0; iter < nbIter; iter++) {
+      cloud.buildFrom(depth, cam, 0.001f, 8.f);
+    }
+    double t_cloud = vpTime::measureTimeMs() - t;
+
+    cloud.setNbThreads(0);
+    t = vpTime::measureTimeMs();
+    for (int iter = 0; iter < nbIter; iter++) {
+      cloud.buildFrom(depth, cam, 0.001f, 8.f);
+    }
+    double t_cloud_threads = vpTime::measureTimeMs() - t;
+
+    std::cout << "vector<vpColVector>: " << t_ref/nbIter << " ms ; vpPointCloud: " << t_cloud/nbIter
+              << " ms ; vpPointCloud with threads: " << t_cloud_threads/nbIter << " ms" << std::endl;
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
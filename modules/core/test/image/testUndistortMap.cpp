@@ -0,0 +1,211 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test vpUndistortMap.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testUndistortMap.cpp
+
+  \brief Compare the images remapped by vpUndistortMap with a floating point
+  bilinear interpolation and with vpImageTools::undistort().
+*/
+
+#include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpUndistortMap.h>
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+
+namespace {
+  void fillImage(vpImage<unsigned char> &I) {
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        I[i][j] = (unsigned char) (((i / 8 + j / 8) % 2) * 128 + (i * 7 + j * 3) % 127);
+  }
+
+  void fillImage(vpImage<vpRGBa> &I) {
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        I[i][j] = vpRGBa((unsigned char) ((i * 3 + j) % 256), (unsigned char) ((i + 5 * j) % 256),
+                         (unsigned char) (((i / 4 + j / 4) % 2) * 255), (unsigned char) ((i * j) % 256));
+  }
+
+  // Location of the source pixel of (u, v), as in vpImageTools::undistort()
+  bool sourcePixel(const vpCameraParameters &cam, double k, unsigned int width, unsigned int height,
+                   unsigned int u, unsigned int v, double &u_src, double &v_src) {
+    double du = u - cam.get_u0(), dv = v - cam.get_v0();
+    double fr = 1.0 + k * (du * du / (cam.get_px() * cam.get_px()) + dv * dv / (cam.get_py() * cam.get_py()));
+    u_src = du * fr + cam.get_u0();
+    v_src = dv * fr + cam.get_v0();
+    return u_src >= 0 && v_src >= 0 && std::floor(u_src) < width - 1 && std::floor(v_src) < height - 1;
+  }
+
+  double bilinear(const unsigned char *p00, const unsigned char *p10, unsigned int step, double du, double dv) {
+    return (1 - du) * (1 - dv) * p00[0] + du * (1 - dv) * p00[step] + (1 - du) * dv * p10[0] + du * dv * p10[step];
+  }
+
+  bool checkGrey(const vpCameraParameters &cam, double k, const vpImage<unsigned char> &I,
+                 const vpImage<unsigned char> &Iremap) {
+    for (unsigned int v = 0; v < I.getHeight(); v++) {
+      for (unsigned int u = 0; u < I.getWidth(); u++) {
+        double u_src, v_src, ref = 0;
+        if (sourcePixel(cam, k, I.getWidth(), I.getHeight(), u, v, u_src, v_src)) {
+          unsigned int ui = (unsigned int) u_src, vi = (unsigned int) v_src;
+          ref = bilinear(&I[vi][ui], &I[vi+1][ui], 1, u_src - ui, v_src - vi);
+        }
+        if (std::fabs(ref - Iremap[v][u]) > 1.0) {
+          std::cerr << "Bad grey value at (" << v << ", " << u << "): " << (int) Iremap[v][u]
+                    << " instead of " << ref << std::endl;
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  bool checkRGBa(const vpCameraParameters &cam, double k, const vpImage<vpRGBa> &I, const vpImage<vpRGBa> &Iremap) {
+    for (unsigned int v = 0; v < I.getHeight(); v++) {
+      for (unsigned int u = 0; u < I.getWidth(); u++) {
+        double u_src, v_src;
+        bool inside = sourcePixel(cam, k, I.getWidth(), I.getHeight(), u, v, u_src, v_src);
+        unsigned int ui = inside ? (unsigned int) u_src : 0, vi = inside ? (unsigned int) v_src : 0;
+        for (unsigned int c = 0; c < 4; c++) {
+          double ref = 0;
+          if (inside)
+            ref = bilinear((const unsigned char *) &I[vi][ui] + c, (const unsigned char *) &I[vi+1][ui] + c, 4,
+                           u_src - ui, v_src - vi);
+          double val = ((const unsigned char *) &Iremap[v][u])[c];
+          if (std::fabs(ref - val) > 1.0) {
+            std::cerr << "Bad color value at (" << v << ", " << u << ", " << c << "): " << val
+                      << " instead of " << ref << std::endl;
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    const unsigned int width = 1280, height = 1024;
+    vpCameraParameters cam;
+    cam.initPersProjWithDistortion(900, 920, 640.3, 511.7, -0.25, 0.3);
+
+    vpImage<unsigned char> I(height, width), Iremap, Iremap_mt, Iundist;
+    vpImage<vpRGBa> Ic(height, width), Icremap, Icremap_mt;
+    fillImage(I);
+    fillImage(Ic);
+
+    vpUndistortMap map(cam, width, height);
+    map.remap(I, Iremap);
+    map.remap(Ic, Icremap);
+    if (!checkGrey(cam, cam.get_kud(), I, Iremap) || !checkRGBa(cam, cam.get_kud(), Ic, Icremap)) {
+      std::cerr << "Problem with vpUndistortMap::UNDISTORT" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Splitting in bands must not change the result
+    map.setNbThreads(3);
+    map.remap(I, Iremap_mt);
+    map.remap(Ic, Icremap_mt);
+    if (Iremap_mt != Iremap || Icremap_mt != Icremap) {
+      std::cerr << "Problem with multi-threaded remap" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    vpUndistortMap map_distort(cam, width, height, vpUndistortMap::DISTORT);
+    map_distort.remap(I, Iremap);
+    map_distort.remap(Ic, Icremap);
+    if (!checkGrey(cam, cam.get_kdu(), I, Iremap) || !checkRGBa(cam, cam.get_kdu(), Ic, Icremap)) {
+      std::cerr << "Problem with vpUndistortMap::DISTORT" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Without distortion the image is copied
+    vpCameraParameters cam_nodist(900, 920, 640.3, 511.7);
+    vpUndistortMap map_nodist(cam_nodist, width, height);
+    map_nodist.remap(I, Iremap);
+    if (Iremap != I) {
+      std::cerr << "Problem with vpUndistortMap without distortion" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Size mismatch
+    bool exception_thrown = false;
+    try {
+      vpImage<unsigned char> I_small(10, 10);
+      map.remap(I_small, Iremap);
+    }
+    catch(const vpException &) {
+      exception_thrown = true;
+    }
+    if (!exception_thrown) {
+      std::cerr << "Remapping an image of the wrong size should throw" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Timings
+    const unsigned int nbIter = 20;
+    map.setNbThreads(1);
+    double t_undistort = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbIter; i++)
+      vpImageTools::undistort(I, cam, Iundist);
+    t_undistort = (vpTime::measureTimeMs() - t_undistort) / nbIter;
+
+    double t_map = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbIter; i++)
+      map.remap(I, Iremap);
+    t_map = (vpTime::measureTimeMs() - t_map) / nbIter;
+
+    map.setNbThreads(4);
+    double t_map_mt = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbIter; i++)
+      map.remap(I, Iremap);
+    t_map_mt = (vpTime::measureTimeMs() - t_map_mt) / nbIter;
+
+    std::cout << "Undistort " << width << "x" << height << " grey image: vpImageTools::undistort() "
+              << t_undistort << " ms ; vpUndistortMap::remap() " << t_map << " ms ; with 4 threads "
+              << t_map_mt << " ms" << std::endl;
+
+    std::cout << "testUndistortMap is ok." << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
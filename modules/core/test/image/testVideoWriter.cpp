@@ -0,0 +1,285 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the write-behind mode of vpVideoWriter.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testVideoWriter.cpp
+
+  \brief Write image sequences with the write-behind mode of vpVideoWriter
+  and the three queue policies, read them back and check the images, the
+  dropped images and the errors of the encoder threads.
+*/
+
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpImageIo.h>
+#include <visp3/io/vpParseArgv.h>
+#include <visp3/io/vpVideoWriter.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdo:h"
+
+namespace {
+  void usage(const char *name, const char *badparam, const std::string &opath, const std::string &user)
+  {
+    fprintf(stdout, "\n\
+Test the write-behind mode of vpVideoWriter.\n\
+\n\
+SYNOPSIS\n\
+  %s [-o <output image path>] [-h]\n", name);
+
+    fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -o <output image path>                               %s\n\
+     Set image output path.\n\
+     From this directory, creates the \"%s\"\n\
+     subdirectory depending on the username, where \n\
+     the image sequences are written and removed.\n\
+\n\
+  -h\n\
+     Print the help.\n\n",
+            opath.c_str(), user.c_str());
+
+    if (badparam)
+      fprintf(stdout, "\nERROR: Bad parameter [%s]\n", badparam);
+  }
+
+  bool getOptions(int argc, const char **argv, std::string &opath, const std::string &user)
+  {
+    const char *optarg_;
+    int	c;
+    while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+      switch (c) {
+      case 'o': opath = optarg_; break;
+      case 'h': usage(argv[0], NULL, opath, user); return false; break;
+
+      case 'c':
+      case 'd':
+        break;
+
+      default:
+        usage(argv[0], optarg_, opath, user); return false; break;
+      }
+    }
+
+    if ((c == 1) || (c == -1)) {
+      // standalone param or error
+      usage(argv[0], NULL, opath, user);
+      std::cerr << "ERROR: " << std::endl;
+      std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  // Image whose content depends on its number
+  void createImage(vpImage<unsigned char> &I, unsigned int n)
+  {
+    I.resize(240, 320);
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        I[i][j] = (unsigned char) ((i + j + 7 * n) % 256);
+  }
+
+  std::string imageName(const std::string &generic, unsigned int n)
+  {
+    char name[FILENAME_MAX];
+    sprintf(name, generic.c_str(), n);
+    return name;
+  }
+
+  // Write nbImages images, then check those on the disk. Return the number
+  // of images found, -1 if an image is wrong.
+  int writeSequence(const std::string &generic, unsigned int nbImages, unsigned int queueSize,
+                    unsigned int nbThreads, vpVideoWriter::vpQueuePolicy policy, unsigned int &nbDropped,
+                    double &t)
+  {
+    vpImage<unsigned char> I;
+    createImage(I, 0);
+
+    vpVideoWriter writer;
+    writer.setFileName(generic);
+    writer.setWriteBehind(queueSize, nbThreads, policy);
+    writer.open(I);
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nbImages; n++) {
+      createImage(I, n);
+      writer.saveFrame(I);
+    }
+    t = vpTime::measureTimeMs() - t;
+    writer.close();
+    nbDropped = writer.getNbDroppedFrames();
+
+    int nbFound = 0;
+    vpImage<unsigned char> R, E;
+    for (unsigned int n = 0; n < nbImages; n++) {
+      std::string name = imageName(generic, n);
+      if (!vpIoTools::checkFilename(name))
+        continue;
+      vpImageIo::read(R, name);
+      createImage(E, n);
+      if (R != E) {
+        std::cerr << "Wrong image " << name << std::endl;
+        return -1;
+      }
+      vpIoTools::remove(name);
+      nbFound++;
+    }
+    return nbFound;
+  }
+}
+
+int main(int argc, const char **argv)
+{
+  try {
+    std::string opt_opath;
+    std::string opath;
+    std::string username;
+
+    // Set the default output path
+#if defined(_WIN32)
+    opt_opath = "C:/temp";
+#else
+    opt_opath = "/tmp";
+#endif
+
+    // Get the user login name
+    vpIoTools::getUserName(username);
+
+    // Read the command line options
+    if (getOptions(argc, argv, opt_opath, username) == false) {
+      return EXIT_FAILURE;
+    }
+
+    // Append to the output path string, the login name of the user
+    opath = vpIoTools::createFilePath(opt_opath, username);
+    opath = vpIoTools::createFilePath(opath, "testVideoWriter");
+
+    // Test if the output path exist. If no try to create it
+    if (vpIoTools::checkDirectory(opath) == false) {
+      vpIoTools::makeDirectory(opath);
+    }
+
+#if defined(VISP_HAVE_PNG)
+    std::string generic = vpIoTools::createFilePath(opath, "image%04d.png");
+#else
+    std::string generic = vpIoTools::createFilePath(opath, "image%04d.pgm");
+#endif
+    const unsigned int nbImages = 40;
+    unsigned int nbDropped;
+    double t;
+
+    // Synchronous writing, as a reference
+    int nbFound = writeSequence(generic, nbImages, 0, 1, vpVideoWriter::QUEUE_BLOCK, nbDropped, t);
+    if (nbFound != (int) nbImages || nbDropped != 0) {
+      std::cerr << "Problem with the synchronous writing" << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << "saveFrame() without write-behind: " << t / nbImages << " ms" << std::endl;
+
+    // No image is dropped when the queue blocks
+    nbFound = writeSequence(generic, nbImages, 4, 3, vpVideoWriter::QUEUE_BLOCK, nbDropped, t);
+    if (nbFound != (int) nbImages || nbDropped != 0) {
+      std::cerr << "Problem with QUEUE_BLOCK: " << nbFound << " images written, " << nbDropped << " dropped"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << "saveFrame() with a blocking queue and 3 threads: " << t / nbImages << " ms" << std::endl;
+
+    // The images of a small queue filled faster than it is written are dropped
+    vpVideoWriter::vpQueuePolicy policies[2] = { vpVideoWriter::QUEUE_DROP_OLDEST, vpVideoWriter::QUEUE_DROP_NEWEST };
+    for (unsigned int k = 0; k < 2; k++) {
+      nbFound = writeSequence(generic, nbImages, 1, 1, policies[k], nbDropped, t);
+      if (nbFound < 0 || nbFound + nbDropped != nbImages) {
+        std::cerr << "Problem with the drop policy " << k << ": " << nbFound << " images written, " << nbDropped
+                  << " dropped" << std::endl;
+        return EXIT_FAILURE;
+      }
+      std::cout << "saveFrame() with drop policy " << k << ": " << t / nbImages << " ms, " << nbDropped
+                << " images dropped" << std::endl;
+    }
+
+    // An error of an encoder thread is thrown by close()
+    vpImage<unsigned char> I;
+    createImage(I, 0);
+    vpVideoWriter writer;
+    writer.setFileName(vpIoTools::createFilePath(opath, "directory-that-does-not-exist/image%04d.pgm"));
+    writer.setWriteBehind(2);
+    writer.open(I);
+    writer.saveFrame(I);
+    try {
+      writer.close();
+      std::cerr << "The error of the encoder thread is not thrown" << std::endl;
+      return EXIT_FAILURE;
+    }
+    catch(vpException &e) {
+      std::cout << "Catch the error of the encoder thread: " << e.getStringMessage() << std::endl;
+    }
+    writer.close();
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
+
+#else
+
+#include <iostream>
+
+int main()
+{
+#  if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+  std::cout << "You should enable pthread usage and rebuild ViSP..." << std::endl;
+#  else
+  std::cout << "Multi-threading seems not supported on this platform" << std::endl;
+#  endif
+  return 0;
+}
+
+#endif
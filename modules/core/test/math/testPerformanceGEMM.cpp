@@ -0,0 +1,299 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test performance of the blocked matrix multiplication kernel.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceGEMM.cpp
+
+  \brief Compare the blocked matrix products used by vpMatrix (mult2Matrices(),
+  AtA(), AAt(), multMatrixVector()) and vpGEMM() with naive triple loops on
+  matrices of size 6x6, 100x6 and 5000x6, and check vpGEMM() with all the
+  combinations of transposed operands.
+*/
+
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpGEMM.h>
+#include <visp3/core/vpTime.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+namespace {
+  double getRandomValues(const double min, const double max) {
+    return (max - min) * ( (double) rand() / (double) RAND_MAX ) + min;
+  }
+
+  void randomMatrix(vpMatrix &M, unsigned int rows, unsigned int cols) {
+    M.resize(rows, cols, false);
+    for (unsigned int i = 0; i < M.size(); i++)
+      M.data[i] = getRandomValues(-10.0, 10.0);
+  }
+
+  // Loops that were used by vpMatrix before the blocked kernel
+  void naiveMult(const vpMatrix &A, const vpMatrix &B, vpMatrix &C) {
+    C.resize(A.getRows(), B.getCols(), false);
+    for (unsigned int i = 0; i < A.getRows(); i++) {
+      for (unsigned int j = 0; j < B.getCols(); j++) {
+        double s = 0;
+        for (unsigned int k = 0; k < B.getRows(); k++)
+          s += A[i][k] * B[k][j];
+        C[i][j] = s;
+      }
+    }
+  }
+
+  void naiveAtA(const vpMatrix &A, vpMatrix &B) {
+    B.resize(A.getCols(), A.getCols(), false);
+    for (unsigned int i = 0; i < A.getCols(); i++) {
+      for (unsigned int j = 0; j <= i; j++) {
+        double s = 0;
+        for (unsigned int k = 0; k < A.getRows(); k++)
+          s += A[k][i] * A[k][j];
+        B[i][j] = B[j][i] = s;
+      }
+    }
+  }
+
+  void naiveAAt(const vpMatrix &A, vpMatrix &B) {
+    B.resize(A.getRows(), A.getRows(), false);
+    for (unsigned int i = 0; i < A.getRows(); i++) {
+      for (unsigned int j = i; j < A.getRows(); j++) {
+        double s = 0;
+        for (unsigned int k = 0; k < A.getCols(); k++)
+          s += A[i][k] * A[j][k];
+        B[i][j] = B[j][i] = s;
+      }
+    }
+  }
+
+  void naiveMultVector(const vpMatrix &A, const vpColVector &v, vpColVector &w) {
+    w.resize(A.getRows(), false);
+    w = 0.0;
+    for (unsigned int j = 0; j < A.getCols(); j++)
+      for (unsigned int i = 0; i < A.getRows(); i++)
+        w[i] += A[i][j] * v[j];
+  }
+
+  bool equalArray(const vpArray2D<double> &A, const vpArray2D<double> &B) {
+    if (A.getRows() != B.getRows() || A.getCols() != B.getCols())
+      return false;
+
+    for (unsigned int i = 0; i < A.size(); i++) {
+      if (std::fabs(A.data[i] - B.data[i]) > 1e-9 * (1.0 + std::fabs(B.data[i])))
+        return false;
+    }
+    return true;
+  }
+
+  // D = alpha * op(A) * op(B) + beta * op(C), op() being given by the VP_GEMM_* flags
+  void naiveGEMM(const vpMatrix &A, const vpMatrix &B, const double alpha, const vpMatrix *C, const double beta,
+                 vpMatrix &D, const unsigned int ops) {
+    const vpMatrix opA = (ops & VP_GEMM_A_T) ? A.t() : A;
+    const vpMatrix opB = (ops & VP_GEMM_B_T) ? B.t() : B;
+    naiveMult(opA, opB, D);
+    D *= alpha;
+    if (C != NULL) {
+      const vpMatrix opC = (ops & VP_GEMM_C_T) ? C->t() : *C;
+      for (unsigned int i = 0; i < D.getRows(); i++)
+        for (unsigned int j = 0; j < D.getCols(); j++)
+          D[i][j] += beta * opC[i][j];
+    }
+  }
+
+  // vpGEMM() with all the combinations of transposes, with and without C, compared with the naive product
+  bool checkGEMM(unsigned int M, unsigned int N, unsigned int K) {
+    const vpMatrix null;
+    for (unsigned int ops = 0; ops < 8; ops++) {
+      // The sizes of C are checked without the transpose, op(C) must be square
+      if ((ops & VP_GEMM_C_T) && M != N)
+        continue;
+      vpMatrix A, B, C, D, D_naive;
+      if (ops & VP_GEMM_A_T) randomMatrix(A, K, M); else randomMatrix(A, M, K);
+      if (ops & VP_GEMM_B_T) randomMatrix(B, N, K); else randomMatrix(B, K, N);
+      if (ops & VP_GEMM_C_T) randomMatrix(C, N, M); else randomMatrix(C, M, N);
+
+      naiveGEMM(A, B, 2.0, &C, -0.5, D_naive, ops);
+      vpGEMM(A, B, 2.0, C, -0.5, D, ops);
+      if (!equalArray(D_naive, D)) {
+        std::cerr << "Problem with vpGEMM() of " << M << "x" << K << " and " << K << "x" << N << " matrices, ops "
+                  << ops << std::endl;
+        return false;
+      }
+
+      if (ops & VP_GEMM_C_T)
+        continue;
+      naiveGEMM(A, B, 1.5, NULL, 0.0, D_naive, ops);
+      vpGEMM(A, B, 1.5, null, 0.0, D, ops);
+      if (!equalArray(D_naive, D)) {
+        std::cerr << "Problem with vpGEMM() of " << M << "x" << K << " and " << K << "x" << N
+                  << " matrices without C, ops " << ops << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void printTimes(const std::string &name, unsigned int rows, double t_naive, double t_blocked) {
+    std::cout << name << " (" << rows << "x6): naive " << t_naive << " ms ; blocked "
+              << t_blocked << " ms ; speed-up " << t_naive / t_blocked << std::endl;
+  }
+}
+
+int main()
+{
+  try {
+    const unsigned int sizes[] = {6, 100, 5000};
+
+    for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+      unsigned int rows = sizes[s];
+      // Keep a roughly constant number of operations for each size
+      unsigned int nbIter = std::max(1u, 300000u / rows);
+
+      vpMatrix A, B6, C_naive, C_blocked;
+      vpColVector v(6), w_naive, w_blocked;
+      randomMatrix(A, rows, 6);
+      randomMatrix(B6, 6, 6);
+      for (unsigned int i = 0; i < v.size(); i++)
+        v[i] = getRandomValues(-10.0, 10.0);
+
+      std::cout << "------------------------" << std::endl;
+      std::cout << "--- Size " << rows << "x6, " << nbIter << " iterations" << std::endl;
+      std::cout << "------------------------" << std::endl;
+
+      // A * B
+      double t_naive = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nbIter; i++)
+        naiveMult(A, B6, C_naive);
+      t_naive = vpTime::measureTimeMs() - t_naive;
+
+      double t_blocked = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nbIter; i++)
+        vpMatrix::mult2Matrices(A, B6, C_blocked);
+      t_blocked = vpTime::measureTimeMs() - t_blocked;
+      printTimes("mult2Matrices", rows, t_naive, t_blocked);
+      if (!equalArray(C_naive, C_blocked)) {
+        std::cerr << "Problem with mult2Matrices()" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // A^T * A
+      t_naive = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nbIter; i++)
+        naiveAtA(A, C_naive);
+      t_naive = vpTime::measureTimeMs() - t_naive;
+
+      t_blocked = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nbIter; i++)
+        A.AtA(C_blocked);
+      t_blocked = vpTime::measureTimeMs() - t_blocked;
+      printTimes("AtA", rows, t_naive, t_blocked);
+      if (!equalArray(C_naive, C_blocked)) {
+        std::cerr << "Problem with AtA()" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // A^T * A through vpGEMM()
+      t_blocked = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nbIter; i++)
+        vpGEMM(A, A, 1.0, null, 0.0, C_blocked, VP_GEMM_A_T);
+      t_blocked = vpTime::measureTimeMs() - t_blocked;
+      printTimes("vpGEMM A^T*A", rows, t_naive, t_blocked);
+      if (!equalArray(C_naive, C_blocked)) {
+        std::cerr << "Problem with vpGEMM()" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // A * A^T, the 5000x5000 result is too large to be meaningful here
+      if (rows <= 100) {
+        t_naive = vpTime::measureTimeMs();
+        for (unsigned int i = 0; i < nbIter / rows + 1; i++)
+          naiveAAt(A, C_naive);
+        t_naive = vpTime::measureTimeMs() - t_naive;
+
+        t_blocked = vpTime::measureTimeMs();
+        for (unsigned int i = 0; i < nbIter / rows + 1; i++)
+          A.AAt(C_blocked);
+        t_blocked = vpTime::measureTimeMs() - t_blocked;
+        printTimes("AAt", rows, t_naive, t_blocked);
+        if (!equalArray(C_naive, C_blocked)) {
+          std::cerr << "Problem with AAt()" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+
+      // A * v
+      t_naive = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nbIter; i++)
+        naiveMultVector(A, v, w_naive);
+      t_naive = vpTime::measureTimeMs() - t_naive;
+
+      t_blocked = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nbIter; i++)
+        vpMatrix::multMatrixVector(A, v, w_blocked);
+      t_blocked = vpTime::measureTimeMs() - t_blocked;
+      printTimes("multMatrixVector", rows, t_naive, t_blocked);
+      if (!equalArray(w_naive, w_blocked)) {
+        std::cerr << "Problem with multMatrixVector()" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Non multiple of the register tile and larger than the cache blocks
+    {
+      vpMatrix A, B, C_naive, C_blocked;
+      randomMatrix(A, 259, 301);
+      randomMatrix(B, 301, 1031);
+      naiveMult(A, B, C_naive);
+      vpMatrix::mult2Matrices(A, B, C_blocked);
+      if (!equalArray(C_naive, C_blocked)) {
+        std::cerr << "Problem with mult2Matrices() on large matrices" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // All the transposes of vpGEMM(), on sizes that are or are not multiple of the register tile
+    if (!checkGEMM(6, 6, 6) || !checkGEMM(37, 37, 53) || !checkGEMM(37, 53, 29) || !checkGEMM(100, 6, 259) || !checkGEMM(1, 17, 300))
+      return EXIT_FAILURE;
+
+    std::cout << "testPerformanceGEMM is ok." << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,212 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the fixed-size pose containers and their performances.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceHomogeneousMatrix.cpp
+
+  \brief Check that the fixed-size containers (vpHomogeneousMatrix,
+  vpRotationMatrix, vpTranslationVector, vpThetaUVector...) behave like
+  regular arrays and measure the time spent in a pose update chain such as
+  cMo = vpExponentialMap::direct(v).inverse() * cMo.
+*/
+
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpExponentialMap.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpPoseVector.h>
+#include <visp3/core/vpTime.h>
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+
+namespace {
+  double getRandomValues(const double min, const double max) {
+    return (max - min) * ( (double) rand() / (double) RAND_MAX ) + min;
+  }
+
+  bool equalArray(const vpArray2D<double> &A, const vpArray2D<double> &B, const double epsilon) {
+    if (A.getRows() != B.getRows() || A.getCols() != B.getCols())
+      return false;
+
+    for (unsigned int i = 0; i < A.getRows(); i++) {
+      for (unsigned int j = 0; j < A.getCols(); j++) {
+        if (std::fabs(A[i][j] - B[i][j]) > epsilon)
+          return false;
+      }
+    }
+    return true;
+  }
+
+  // Pose update implemented with generic heap allocated matrices
+  void updatePoseReference(const vpColVector &v, vpMatrix &cMo) {
+    vpHomogeneousMatrix dM = vpExponentialMap::direct(v);
+    vpMatrix dMi(4, 4);
+    for (unsigned int i = 0; i < 3; i++) {
+      for (unsigned int j = 0; j < 3; j++)
+        dMi[i][j] = dM[j][i];
+      dMi[i][3] = -(dM[0][i]*dM[0][3] + dM[1][i]*dM[1][3] + dM[2][i]*dM[2][3]);
+    }
+    dMi[3][3] = 1.;
+    cMo = dMi * cMo;
+  }
+}
+
+int main()
+{
+  try {
+    // Products and inverse against vpMatrix
+    for (unsigned int iter = 0; iter < 100; iter++) {
+      vpHomogeneousMatrix M1(getRandomValues(-1, 1), getRandomValues(-1, 1), getRandomValues(-1, 1),
+                             getRandomValues(-M_PI, M_PI), getRandomValues(-M_PI, M_PI), getRandomValues(-M_PI, M_PI));
+      vpHomogeneousMatrix M2(getRandomValues(-1, 1), getRandomValues(-1, 1), getRandomValues(-1, 1),
+                             getRandomValues(-M_PI, M_PI), getRandomValues(-M_PI, M_PI), getRandomValues(-M_PI, M_PI));
+
+      vpMatrix A(4, 4), B(4, 4);
+      for (unsigned int i = 0; i < 16; i++) {
+        A.data[i] = M1.data[i];
+        B.data[i] = M2.data[i];
+      }
+
+      if (!equalArray(M1 * M2, A * B, 1e-12)) {
+        std::cerr << "Problem with vpHomogeneousMatrix::operator*()" << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (!equalArray(M1.inverse(), A.inverseByLU(), 1e-12)) {
+        std::cerr << "Problem with vpHomogeneousMatrix::inverse()" << std::endl;
+        return EXIT_FAILURE;
+      }
+      vpHomogeneousMatrix M3 = M1;
+      M3 *= M2;
+      if (!equalArray(M3, M1 * M2, 0)) {
+        std::cerr << "Problem with vpHomogeneousMatrix::operator*=()" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Copies must not share their elements
+    {
+      vpHomogeneousMatrix M1(0.1, 0.2, 0.3, 0.4, 0.5, 0.6);
+      vpHomogeneousMatrix M2(M1), M3;
+      M3 = M1;
+      M1[0][3] = 10.;
+      if (M2[0][3] != 0.1 || M3[0][3] != 0.1 || M1.data[3] != 10.) {
+        std::cerr << "Problem with vpHomogeneousMatrix copy" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      vpPoseVector p1(M1), p2(p1), p3;
+      p3 = p1;
+      p1[0] = 0.;
+      if (p2[0] != 10. || p3[0] != 10.) {
+        std::cerr << "Problem with vpPoseVector copy" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      vpThetaUVector tu1(0.1, 0.2, 0.3), tu2(tu1);
+      tu1[0] = 0.;
+      if (tu2[0] != 0.1) {
+        std::cerr << "Problem with vpThetaUVector copy" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // A fixed-size container that is resized moves to the heap
+    {
+      vpTranslationVector t(1., 2., 3.);
+      vpArray2D<double> &a = t;
+      a.resize(5, 1, false);
+      if (t.size() != 5 || t[0] != 1. || t[1] != 2. || t[2] != 3.) {
+        std::cerr << "Problem with vpArray2D::resize() on a translation vector" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // A rotation vector larger than the in-object storage is allocated on the heap
+      vpRotationVector r(8);
+      if (r.size() != 8 || r[7] != 0.) {
+        std::cerr << "Problem with vpRotationVector of size 8" << std::endl;
+        return EXIT_FAILURE;
+      }
+      r[7] = 7.;
+      vpRotationVector r_copy(r);
+      if (r_copy.size() != 8 || r_copy[7] != 7. || r_copy.data == r.data) {
+        std::cerr << "Problem with the copy of a vpRotationVector of size 8" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      vpRotationVector r_empty(0);
+      r_empty.resize(2, 1);
+      if (r_empty.size() != 2 || r_empty[1] != 0.) {
+        std::cerr << "Problem with vpArray2D::resize() on an empty rotation vector" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Pose update chain
+    const unsigned int nbIter = 200000;
+    vpColVector v(6);
+    for (unsigned int i = 0; i < 6; i++)
+      v[i] = getRandomValues(-0.01, 0.01);
+
+    vpHomogeneousMatrix cMo(0.1, 0.2, 1.0, 0.1, 0.2, 0.3);
+    vpMatrix cMo_ref(4, 4);
+    for (unsigned int i = 0; i < 16; i++)
+      cMo_ref.data[i] = cMo.data[i];
+
+    double t_ref = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbIter; i++)
+      updatePoseReference(v, cMo_ref);
+    t_ref = vpTime::measureTimeMs() - t_ref;
+
+    double t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbIter; i++)
+      cMo = vpExponentialMap::direct(v).inverse() * cMo;
+    t = vpTime::measureTimeMs() - t;
+
+    std::cout << "cMo = vpExponentialMap::direct(v).inverse() * cMo (" << nbIter << " iterations): "
+              << t << " ms ; with vpMatrix: " << t_ref << " ms ; speed-up " << t_ref / t << std::endl;
+
+    if (!equalArray(cMo, cMo_ref, 1e-6)) {
+      std::cerr << "Problem with the pose update chain" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
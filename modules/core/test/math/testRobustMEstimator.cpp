@@ -0,0 +1,317 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the weights computed by the M-estimators of vpRobust.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testRobustMEstimator.cpp
+
+  \brief Check the weights computed by vpRobust::MEstimator() against a
+  straightforward implementation sorting the residues, and the weights of
+  several blocks of residues computed in one call.
+*/
+
+#include <visp3/core/vpRobust.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+
+#include <stdlib.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdh"
+
+namespace {
+  void usage(const char *name, const char *badparam)
+  {
+    fprintf(stdout, "\n\
+Compare the weights of the vpRobust M-estimators with a reference\n\
+implementation.\n\
+\n\
+SYNOPSIS\n\
+  %s [-c] [-d] [-h]\n", name);
+
+    fprintf(stdout, "\n\
+OPTIONS:\n\
+  -c\n\
+     Disable the mouse click. Useless in this test.\n\
+\n\
+  -d\n\
+     Disable the image display. Useless in this test.\n\
+\n\
+  -h\n\
+     Print the help.\n\n");
+
+    if (badparam)
+      fprintf(stdout, "\nERROR: Bad parameter [%s]\n", badparam);
+  }
+
+  bool getOptions(int argc, const char **argv)
+  {
+    const char *optarg_;
+    int c;
+    while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+      switch (c) {
+      case 'c': break;
+      case 'd': break;
+      case 'h': usage(argv[0], NULL); return false; break;
+
+      default:
+        usage(argv[0], optarg_);
+        return false; break;
+      }
+    }
+
+    if ((c == 1) || (c == -1)) {
+      // standalone param or error
+      usage(argv[0], NULL);
+      std::cerr << "ERROR: " << std::endl;
+      std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  double getRandomValues(const double min, const double max) {
+    return (max - min) * ( (double) rand() / (double) RAND_MAX ) + min;
+  }
+
+  // Residues with outliers, and some null weights for rejected residues
+  void getResidues(const unsigned int n, vpColVector &residues, vpColVector &weights) {
+    residues.resize(n, false);
+    weights.resize(n, false);
+    for (unsigned int i = 0; i < n; i++) {
+      residues[i] = (rand() % 10 == 0) ? getRandomValues(-50, 50) : getRandomValues(-1, 1);
+      weights[i] = (rand() % 20 == 0) ? 0 : 1;
+    }
+  }
+
+  double median(std::vector<double> v) {
+    if (v.empty())
+      return 0;
+    std::sort(v.begin(), v.end());
+    return v[(size_t)(ceil(v.size()/2.0))-1];
+  }
+
+  double weight(const vpRobust::vpRobustEstimatorType method, const double sigma, const double x, const double w) {
+    const double eps = std::numeric_limits<double>::epsilon();
+    switch (method) {
+    case vpRobust::TUKEY:
+      if (std::fabs(sigma) <= eps)
+        return std::fabs(w) > eps ? 1 : 0;
+      if (std::fabs(x/sigma) <= 4.6851 && std::fabs(w) > eps)
+        return vpMath::sqr(1 - vpMath::sqr(x/sigma/4.6851));
+      return 0;
+    case vpRobust::HUBER:
+      if (std::fabs(w) <= eps)
+        return w;
+      return std::fabs(x/sigma) <= 1.2107 ? 1 : 1.2107/std::fabs(x/sigma);
+    case vpRobust::CAUCHY:
+    default:
+      return 1/(1 + vpMath::sqr(x/(2.3849*sigma)));
+    }
+  }
+
+  // Reference weights, the scale being estimated on the residues with a non null weight if
+  // rejected is true
+  void referenceWeights(const vpRobust::vpRobustEstimatorType method, const vpColVector &residues,
+                        const double threshold, const bool rejected, vpColVector &weights) {
+    std::vector<double> r;
+    for (unsigned int i = 0; i < residues.getRows(); i++) {
+      if (! rejected || std::fabs(weights[i]) > std::numeric_limits<double>::epsilon())
+        r.push_back(residues[i]);
+    }
+    double med = median(r);
+    for (size_t i = 0; i < r.size(); i++)
+      r[i] = std::fabs(r[i] - med);
+    double sigma = std::max(1.4826*median(r), threshold);
+
+    for (unsigned int i = 0; i < residues.getRows(); i++)
+      weights[i] = weight(method, sigma, std::fabs(residues[i] - med), weights[i]);
+  }
+
+  bool sameWeights(const vpColVector &w1, const vpColVector &w2) {
+    for (unsigned int i = 0; i < w1.getRows(); i++) {
+      if (std::fabs(w1[i] - w2[i]) > 1e-12)
+        return false;
+    }
+    return true;
+  }
+}
+
+int main(int argc, const char **argv)
+{
+  try {
+    if (getOptions(argc, argv) == false) {
+      return EXIT_FAILURE;
+    }
+
+    srand(0);
+    const vpRobust::vpRobustEstimatorType methods[] = {vpRobust::TUKEY, vpRobust::CAUCHY, vpRobust::HUBER};
+    const char *names[] = {"Tukey", "Cauchy", "Huber"};
+    const unsigned int sizes[] = {1, 2, 3, 7, 100, 1001, 20000};
+
+    // The same vpRobust is used for all the sizes, to check that its containers are reused
+    vpRobust robust(0);
+    robust.setThreshold(0.01);
+    for (unsigned int m = 0; m < 3; m++) {
+      for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        vpColVector residues, weights;
+        getResidues(sizes[s], residues, weights);
+
+        vpColVector weights_ref = weights;
+        referenceWeights(methods[m], residues, 0.01, false, weights_ref);
+        robust.MEstimator(methods[m], residues, weights);
+        if (! sameWeights(weights, weights_ref)) {
+          std::cerr << names[m] << " weights of " << sizes[s] << " residues differ" << std::endl;
+          return EXIT_FAILURE;
+        }
+
+        // Scale estimated on a subset of the residues, the others being rejected
+        getResidues(sizes[s], residues, weights);
+        vpColVector all_residues(2*sizes[s]);
+        vpColVector all_weights(2*sizes[s], 1);
+        for (unsigned int i = 0; i < sizes[s]; i++) {
+          all_residues[i] = residues[i];
+          all_residues[sizes[s] + i] = getRandomValues(-3, 3);
+          all_weights[i] = weights[i];
+        }
+        vpColVector all_weights_ref = all_weights;
+        {
+          std::vector<double> r;
+          for (unsigned int i = 0; i < sizes[s]; i++) {
+            if (std::fabs(weights[i]) > std::numeric_limits<double>::epsilon())
+              r.push_back(residues[i]);
+          }
+          double med = median(r);
+          for (size_t i = 0; i < r.size(); i++)
+            r[i] = std::fabs(r[i] - med);
+          double sigma = std::max(1.4826*median(r), 0.01);
+          for (unsigned int i = 0; i < all_residues.getRows(); i++)
+            all_weights_ref[i] = weight(methods[m], sigma, std::fabs(all_residues[i] - med), all_weights_ref[i]);
+        }
+        robust.MEstimator(methods[m], residues, all_residues, all_weights);
+        if (! sameWeights(all_weights, all_weights_ref)) {
+          std::cerr << names[m] << " weights of " << 2*sizes[s] << " residues scaled on " << sizes[s]
+                    << " residues differ" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // Blocks of residues weighted in one call
+    std::vector<unsigned int> blockSizes;
+    std::vector<double> thresholds;
+    blockSizes.push_back(500); thresholds.push_back(0.01);
+    blockSizes.push_back(0);   thresholds.push_back(0.1);
+    blockSizes.push_back(37);  thresholds.push_back(2.);
+    blockSizes.push_back(2000); thresholds.push_back(0.001);
+    unsigned int n_data = 0;
+    for (size_t b = 0; b < blockSizes.size(); b++)
+      n_data += blockSizes[b];
+
+    for (unsigned int m = 0; m < 3; m++) {
+      vpColVector residues, weights;
+      getResidues(n_data, residues, weights);
+      vpColVector weights_batch = weights;
+      robust.MEstimator(methods[m], residues, blockSizes, thresholds, weights_batch);
+
+      unsigned int offset = 0;
+      for (size_t b = 0; b < blockSizes.size(); b++) {
+        vpColVector block_residues(blockSizes[b]), block_weights(blockSizes[b]);
+        for (unsigned int i = 0; i < blockSizes[b]; i++) {
+          block_residues[i] = residues[offset + i];
+          block_weights[i] = weights[offset + i];
+        }
+        vpRobust block_robust(blockSizes[b]);
+        block_robust.setThreshold(thresholds[b]);
+        block_robust.MEstimator(methods[m], block_residues, block_weights);
+        for (unsigned int i = 0; i < blockSizes[b]; i++) {
+          if (block_weights[i] != weights_batch[offset + i]) {
+            std::cerr << names[m] << " weights of block " << b << " differ" << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+        offset += blockSizes[b];
+      }
+    }
+
+    // Block sizes that do not match the residues
+    bool exception = false;
+    try {
+      vpColVector residues(10), weights(10, 1);
+      robust.MEstimator(vpRobust::TUKEY, residues, std::vector<unsigned int>(1, 9), std::vector<double>(), weights);
+    }
+    catch(const vpException &) {
+      exception = true;
+    }
+    if (! exception) {
+      std::cerr << "Bad block sizes are not detected" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Timings of the weights of the residues of a typical tracker
+    vpColVector residues, weights;
+    getResidues(20000, residues, weights);
+    vpColVector weights_ref = weights, weights_robust = weights;
+    const unsigned int nbIter = 100;
+    double t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbIter; i++) {
+      weights_ref = weights;
+      referenceWeights(vpRobust::TUKEY, residues, 0.01, false, weights_ref);
+    }
+    double t_ref = vpTime::measureTimeMs() - t;
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbIter; i++) {
+      weights_robust = weights;
+      robust.MEstimator(vpRobust::TUKEY, residues, weights_robust);
+    }
+    double t_robust = vpTime::measureTimeMs() - t;
+    std::cout << "Tukey weights of " << residues.getRows() << " residues: " << t_ref/nbIter
+              << " ms with sorting, " << t_robust/nbIter << " ms with vpRobust" << std::endl;
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
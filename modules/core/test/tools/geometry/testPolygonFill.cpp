@@ -0,0 +1,232 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the scanline filling of a polygon.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPolygonFill.cpp
+
+  \brief Check that vpPolygon::fill() sets the same pixels as a point in
+  polygon test made on each pixel, with and without erosion of the polygon,
+  and compare their computation times.
+*/
+
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpPolygon.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdh"
+
+namespace {
+  void usage(const char *name, const char *badparam)
+  {
+    fprintf(stdout, "\n\
+Compare vpPolygon::fill() with vpPolygon::isInside() called on each pixel.\n\
+\n\
+SYNOPSIS\n\
+  %s [-c] [-d] [-h]\n", name);
+
+    fprintf(stdout, "\n\
+OPTIONS:\n\
+  -c\n\
+     Disable the mouse click. Useless in this test.\n\
+\n\
+  -d\n\
+     Disable the image display. Useless in this test.\n\
+\n\
+  -h\n\
+     Print the help.\n\n");
+
+    if (badparam)
+      fprintf(stdout, "\nERROR: Bad parameter [%s]\n", badparam);
+  }
+
+  bool getOptions(int argc, const char **argv)
+  {
+    const char *optarg_;
+    int c;
+    while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+      switch (c) {
+      case 'c': break;
+      case 'd': break;
+      case 'h': usage(argv[0], NULL); return false; break;
+
+      default:
+        usage(argv[0], optarg_);
+        return false; break;
+      }
+    }
+
+    if ((c == 1) || (c == -1)) {
+      // standalone param or error
+      usage(argv[0], NULL);
+      std::cerr << "ERROR: " << std::endl;
+      std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  double getRandomValues(const double min, const double max) {
+    return (max - min) * ( (double) rand() / (double) RAND_MAX ) + min;
+  }
+
+  // Star shaped polygon, concave when the radius varies a lot
+  std::vector<vpImagePoint> getRandomPolygon(unsigned int nbCorners, const vpImagePoint &center,
+                                             double radius_min, double radius_max, bool integer) {
+    std::vector<vpImagePoint> corners;
+    for (unsigned int k = 0; k < nbCorners; k++) {
+      double theta = 2.*M_PI*k / nbCorners + getRandomValues(0, 0.5*M_PI / nbCorners);
+      double radius = getRandomValues(radius_min, radius_max);
+      double i = center.get_i() + radius*sin(theta);
+      double j = center.get_j() + radius*cos(theta);
+      if (integer) {
+        i = vpMath::round(i);
+        j = vpMath::round(j);
+      }
+      corners.push_back(vpImagePoint(i, j));
+    }
+    return corners;
+  }
+
+  // Same rule as the per-pixel loop of the model-based KLT tracker
+  void fillReference(const vpPolygon &polygon, vpImage<unsigned char> &I, unsigned char value, unsigned int border) {
+    double b = (double) border;
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        double i_d = (double) i, j_d = (double) j;
+        if (polygon.isInside(vpImagePoint(i_d, j_d))
+            && (border == 0 || (polygon.isInside(vpImagePoint(i_d+b, j_d+b))
+                                && polygon.isInside(vpImagePoint(i_d-b, j_d+b))
+                                && polygon.isInside(vpImagePoint(i_d+b, j_d-b))
+                                && polygon.isInside(vpImagePoint(i_d-b, j_d-b))))) {
+          I[i][j] = value;
+        }
+      }
+    }
+  }
+}
+
+int main(int argc, const char **argv)
+{
+  try {
+    if (getOptions(argc, argv) == false) {
+      return EXIT_FAILURE;
+    }
+
+    srand(0);
+    const unsigned int height = 240, width = 320;
+    const unsigned int borders[] = {0, 1, 3, 5};
+    double t_ref = 0, t_fill = 0;
+    unsigned int nbTests = 0;
+
+    for (unsigned int iter = 0; iter < 40; iter++) {
+      std::vector<vpImagePoint> corners;
+      switch (iter % 4) {
+      case 0: // Rectangle with integer corners, edges on pixel centers
+        corners.push_back(vpImagePoint(20 + iter, 30));
+        corners.push_back(vpImagePoint(20 + iter, 250));
+        corners.push_back(vpImagePoint(200, 250));
+        corners.push_back(vpImagePoint(200, 30));
+        break;
+      case 1: // Convex polygon with real coordinates
+        corners = getRandomPolygon(3 + iter % 7, vpImagePoint(getRandomValues(60, 180), getRandomValues(60, 260)), 50, 60, false);
+        break;
+      case 2: // Concave polygon with integer coordinates
+        corners = getRandomPolygon(5 + iter % 9, vpImagePoint(getRandomValues(60, 180), getRandomValues(60, 260)), 10, 90, true);
+        break;
+      default: // Polygon partially outside the image
+        corners = getRandomPolygon(4 + iter % 5, vpImagePoint(getRandomValues(-20, 260), getRandomValues(-20, 340)), 30, 150, false);
+        break;
+      }
+      vpPolygon polygon(corners);
+
+      for (unsigned int b = 0; b < sizeof(borders) / sizeof(borders[0]); b++) {
+        vpImage<unsigned char> I_ref(height, width, 0), I_fill(height, width, 0);
+
+        double t = vpTime::measureTimeMs();
+        fillReference(polygon, I_ref, 255, borders[b]);
+        t_ref += vpTime::measureTimeMs() - t;
+
+        t = vpTime::measureTimeMs();
+        polygon.fill(I_fill, 255, borders[b]);
+        t_fill += vpTime::measureTimeMs() - t;
+
+        if (!(I_fill == I_ref)) {
+          std::cerr << "Problem with vpPolygon::fill() for polygon " << iter << " and border " << borders[b] << std::endl;
+          return EXIT_FAILURE;
+        }
+        nbTests++;
+      }
+    }
+
+    // Only the pixels inside the polygon are modified
+    {
+      std::vector<vpImagePoint> corners;
+      corners.push_back(vpImagePoint(10, 10));
+      corners.push_back(vpImagePoint(10, 20));
+      corners.push_back(vpImagePoint(20, 20));
+      corners.push_back(vpImagePoint(20, 10));
+      vpPolygon polygon(corners);
+      vpImage<unsigned char> I(30, 30, 7);
+      polygon.fill(I, 255);
+      for (unsigned int i = 0; i < I.getHeight(); i++) {
+        for (unsigned int j = 0; j < I.getWidth(); j++) {
+          bool inside = (i > 10 && i <= 20 && j > 10 && j <= 20);
+          if (I[i][j] != (inside ? 255 : 7)) {
+            std::cerr << "Problem with vpPolygon::fill() at pixel " << i << " " << j << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+    std::cout << nbTests << " fillings: " << t_fill << " ms ; with isInside() on each pixel: "
+              << t_ref << " ms ; speed-up " << t_ref / t_fill << std::endl;
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
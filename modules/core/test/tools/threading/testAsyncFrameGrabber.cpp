@@ -0,0 +1,294 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the background acquisition of a frame grabber.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testAsyncFrameGrabber.cpp
+
+  \brief Check with a synthetic frame grabber that vpAsyncFrameGrabber
+  returns the images in capture order, drops them only in the modes that
+  allow it, stops at the end of the sequence and forwards the exceptions of
+  the grabber.
+*/
+
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+
+#include <visp3/core/vpAsyncFrameGrabber.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+
+#include <stdlib.h>
+#include <iostream>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdh"
+
+namespace {
+  void usage(const char *name, const char *badparam)
+  {
+    fprintf(stdout, "\n\
+Test vpAsyncFrameGrabber.\n\
+\n\
+SYNOPSIS\n\
+  %s [-c] [-d] [-h]\n", name);
+
+    fprintf(stdout, "\n\
+OPTIONS:\n\
+  -c\n\
+     Disable the mouse click. Useless in this test.\n\
+\n\
+  -d\n\
+     Disable the image display. Useless in this test.\n\
+\n\
+  -h\n\
+     Print the help.\n\n");
+
+    if (badparam)
+      fprintf(stdout, "\nERROR: Bad parameter [%s]\n", badparam);
+  }
+
+  bool getOptions(int argc, const char **argv)
+  {
+    const char *optarg_;
+    int c;
+    while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+      switch (c) {
+      case 'c': break;
+      case 'd': break;
+      case 'h': usage(argv[0], NULL); return false; break;
+
+      default:
+        usage(argv[0], optarg_);
+        return false; break;
+      }
+    }
+
+    if ((c == 1) || (c == -1)) {
+      // standalone param or error
+      usage(argv[0], NULL);
+      std::cerr << "ERROR: " << std::endl;
+      std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  // Sequence of images whose pixels are set to the image number, like a
+  // video file. acquire() throws at image m_throwAt.
+  class vpSyntheticGrabber : public vpFrameGrabber
+  {
+  public:
+    vpSyntheticGrabber(unsigned int nbFrames, double delay_ms=0, unsigned int throwAt=0)
+      : m_nbFrames(nbFrames), m_delay(delay_ms), m_throwAt(throwAt), m_frame(0)
+    {
+      width = 64;
+      height = 48;
+    }
+
+    void open(vpImage<unsigned char> &I) { I.resize(height, width, 0); m_frame = 0; init = true; }
+    void open(vpImage<vpRGBa> &I) { I.resize(height, width, vpRGBa(0)); m_frame = 0; init = true; }
+
+    void acquire(vpImage<unsigned char> &I) {
+      next();
+      I.resize(height, width, (unsigned char) m_frame++);
+    }
+    void acquire(vpImage<vpRGBa> &I) {
+      next();
+      I.resize(height, width, vpRGBa((unsigned char) m_frame++));
+    }
+
+    void close() { init = false; }
+    bool end() { return m_frame >= m_nbFrames; }
+
+  private:
+    void next() {
+      if (m_delay > 0)
+        vpTime::sleepMs(m_delay);
+      if (m_throwAt > 0 && m_frame == m_throwAt)
+        throw vpException(vpException::ioError, "Cannot read image %u", m_frame);
+    }
+
+    unsigned int m_nbFrames;
+    double m_delay;
+    unsigned int m_throwAt;
+    unsigned int m_frame;
+  };
+
+  bool check(bool condition, const std::string &message)
+  {
+    if (!condition)
+      std::cerr << "Problem: " << message << std::endl;
+    return condition;
+  }
+
+  // Every image is returned once, in order
+  bool testEveryFrame()
+  {
+    const unsigned int nbFrames = 50;
+    vpSyntheticGrabber grabber(nbFrames);
+    vpAsyncFrameGrabber g(grabber, 3, vpAsyncFrameGrabber::EVERY_FRAME);
+
+    vpImage<unsigned char> I;
+    g.open(I);
+    unsigned int n = 0;
+    while (!g.end()) {
+      if (!g.acquire(I, true))
+        break;
+      if (!check(I[0][0] == n && I[47][63] == n && g.getFrameIndex() == n, "EVERY_FRAME returns a wrong image"))
+        return false;
+      n++;
+      vpTime::sleepMs(1); // Let the capture fill the slots
+    }
+    bool ok = check(n == nbFrames, "EVERY_FRAME does not return all the images")
+        && check(g.getNbDroppedFrames() == 0, "EVERY_FRAME drops images")
+        && check(g.getNbCapturedFrames() == nbFrames, "EVERY_FRAME captures too many images")
+        && check(!g.acquire(I, false), "acquire() returns an image after the end");
+    g.close();
+    return ok;
+  }
+
+  // The newest image is returned, the older ones are dropped
+  bool testLatestFrame()
+  {
+    const unsigned int nbFrames = 40;
+    vpSyntheticGrabber grabber(nbFrames, 1);
+    vpAsyncFrameGrabber g(grabber, 3, vpAsyncFrameGrabber::LATEST_FRAME);
+
+    vpImage<unsigned char> I;
+    g.open(I);
+    unsigned int nbAcquired = 0;
+    int previous = -1;
+    while (!g.end()) {
+      if (!g.acquire(I, true))
+        break;
+      if (!check((int) g.getFrameIndex() > previous && I[0][0] == g.getFrameIndex(), "LATEST_FRAME returns an older image"))
+        return false;
+      previous = (int) g.getFrameIndex();
+      nbAcquired++;
+      if (!check(g.getNbReadyFrames() <= 1, "LATEST_FRAME keeps several images"))
+        return false;
+      vpTime::sleepMs(5); // Slower than the capture
+    }
+    return check(g.getNbCapturedFrames() == nbFrames, "LATEST_FRAME does not capture all the images")
+        && check(nbAcquired + g.getNbDroppedFrames() == nbFrames, "LATEST_FRAME loses images")
+        && check(g.getNbDroppedFrames() > 0, "LATEST_FRAME with a slow consumer drops no image");
+  }
+
+  // The images are returned in capture order, the oldest is dropped when the
+  // slots are full. The capture is in color, the acquisition in grey level.
+  bool testNextFrame()
+  {
+    const unsigned int nbFrames = 40;
+    vpSyntheticGrabber grabber(nbFrames, 1);
+    vpAsyncFrameGrabber g(grabber, 4, vpAsyncFrameGrabber::NEXT_FRAME);
+
+    vpImage<vpRGBa> Ic;
+    g.open(Ic);
+    vpImage<unsigned char> I;
+    unsigned int nbAcquired = 0;
+    int previous = -1;
+    while (g.acquire(I, true)) {
+      // The conversion to grey level may round the value down
+      int diff = (int) g.getFrameIndex() - (int) I[0][0];
+      if (!check((int) g.getFrameIndex() > previous && diff >= 0 && diff <= 1, "NEXT_FRAME returns a wrong image"))
+        return false;
+      previous = (int) g.getFrameIndex();
+      nbAcquired++;
+      vpTime::sleepMs(3);
+    }
+    return check(g.end(), "end() is false after the last image")
+        && check(nbAcquired + g.getNbDroppedFrames() == nbFrames, "NEXT_FRAME loses images");
+  }
+
+  // The exception of the grabber is thrown after the images captured before
+  bool testException()
+  {
+    vpSyntheticGrabber grabber(100, 0, 10);
+    vpAsyncFrameGrabber g(grabber, 3, vpAsyncFrameGrabber::EVERY_FRAME);
+
+    vpImage<unsigned char> I;
+    g.open(I);
+    unsigned int n = 0;
+    try {
+      for (;;) {
+        g.acquire(I);
+        n++;
+      }
+    }
+    catch(vpException &e) {
+      return check(e.getCode() == vpException::ioError, "Wrong exception forwarded")
+          && check(n == 10, "The images before the exception are not all returned")
+          && check(g.end(), "end() is false after an exception");
+    }
+    return false;
+  }
+}
+
+int main(int argc, const char **argv)
+{
+  try {
+    if (getOptions(argc, argv) == false) {
+      return EXIT_FAILURE;
+    }
+
+    if (!testEveryFrame() || !testLatestFrame() || !testNextFrame() || !testException())
+      return EXIT_FAILURE;
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
+
+#else
+
+#include <iostream>
+
+int main()
+{
+#  if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+  std::cout << "You should enable pthread usage and rebuild ViSP..." << std::endl;
+#  else
+  std::cout << "Multi-threading seems not supported on this platform" << std::endl;
+#  endif
+  return 0;
+}
+
+#endif
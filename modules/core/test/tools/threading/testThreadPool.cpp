@@ -0,0 +1,354 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the thread pool and its parallel loop.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testThreadPool.cpp
+
+  \brief Check that vpThreadPool::parallel_for() processes each index exactly
+  once, also with nested loops and loops started from several threads, that
+  the number of loop bodies running at once stays within the thread limit,
+  that an exception of the loop body is forwarded to the caller, and compare the
+  cost of a loop with the creation of threads at each call.
+*/
+
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+
+#include <visp3/core/vpMutex.h>
+#include <visp3/core/vpThread.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+
+#include <stdlib.h>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdh"
+
+namespace {
+  void usage(const char *name, const char *badparam)
+  {
+    fprintf(stdout, "\n\
+Test vpThreadPool::parallel_for().\n\
+\n\
+SYNOPSIS\n\
+  %s [-c] [-d] [-h]\n", name);
+
+    fprintf(stdout, "\n\
+OPTIONS:\n\
+  -c\n\
+     Disable the mouse click. Useless in this test.\n\
+\n\
+  -d\n\
+     Disable the image display. Useless in this test.\n\
+\n\
+  -h\n\
+     Print the help.\n\n");
+
+    if (badparam)
+      fprintf(stdout, "\nERROR: Bad parameter [%s]\n", badparam);
+  }
+
+  bool getOptions(int argc, const char **argv)
+  {
+    const char *optarg_;
+    int c;
+    while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+      switch (c) {
+      case 'c': break;
+      case 'd': break;
+      case 'h': usage(argv[0], NULL); return false; break;
+
+      default:
+        usage(argv[0], optarg_);
+        return false; break;
+      }
+    }
+
+    if ((c == 1) || (c == -1)) {
+      // standalone param or error
+      usage(argv[0], NULL);
+      std::cerr << "ERROR: " << std::endl;
+      std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  // Each index increments its own counter, the cost of an index grows with it
+  struct CountIndices {
+    std::vector<unsigned int> *counts;
+    void operator()(unsigned int begin, unsigned int end) const {
+      for (unsigned int i = begin; i < end; i++) {
+        volatile double x = 0;
+        for (unsigned int k = 0; k < i % 64; k++)
+          x += k;
+        (*counts)[i]++;
+      }
+    }
+  };
+
+  bool checkCounts(const std::vector<unsigned int> &counts, const unsigned int expected, const char *name)
+  {
+    for (size_t i = 0; i < counts.size(); i++) {
+      if (counts[i] != expected) {
+        std::cerr << "Problem with " << name << ": index " << i << " processed " << counts[i]
+                  << " times instead of " << expected << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Each row starts a parallel loop over the columns
+  struct NestedLoop {
+    std::vector<std::vector<unsigned int> > *counts;
+    void operator()(unsigned int begin, unsigned int end) const {
+      for (unsigned int i = begin; i < end; i++) {
+        CountIndices body;
+        body.counts = &(*counts)[i];
+        vpThreadPool::parallel_for(0, (unsigned int) (*counts)[i].size(), body);
+      }
+    }
+  };
+
+  // Record the largest number of loop bodies running at the same time
+  struct ConcurrencyProbe {
+    vpMutex *mutex;
+    unsigned int *running;
+    unsigned int *peak;
+    void operator()(unsigned int begin, unsigned int end) const {
+      {
+        vpMutex::vpScopedLock lock(*mutex);
+        (*running)++;
+        if (*running > *peak)
+          *peak = *running;
+      }
+      // Keep the body busy so that the threads overlap
+      double t = vpTime::measureTimeMs();
+      while (vpTime::measureTimeMs() - t < 0.05 * (end - begin)) {
+      }
+      {
+        vpMutex::vpScopedLock lock(*mutex);
+        (*running)--;
+      }
+    }
+  };
+
+  struct ThrowingLoop {
+    void operator()(unsigned int begin, unsigned int end) const {
+      for (unsigned int i = begin; i < end; i++) {
+        if (i == 777)
+          throw vpException(vpException::badValue, "Index %d", i);
+      }
+    }
+  };
+
+  void emptyRange(unsigned int, unsigned int, void *) {}
+
+  vpThread::Return emptyThread(vpThread::Args)
+  {
+    return 0;
+  }
+
+  // Several threads run loops at the same time on the shared pool
+  vpThread::Return concurrentLoops(vpThread::Args args)
+  {
+    std::vector<unsigned int> *counts = (std::vector<unsigned int> *) args;
+    CountIndices body;
+    body.counts = counts;
+    for (unsigned int n = 0; n < 20; n++)
+      vpThreadPool::parallel_for(0, (unsigned int) counts->size(), body);
+    return 0;
+  }
+}
+
+int main(int argc, const char **argv)
+{
+  try {
+    if (getOptions(argc, argv) == false) {
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "Hardware concurrency: " << vpThreadPool::getHardwareConcurrency() << std::endl;
+    // Use several threads even on a single core machine
+    vpThreadPool::setNbThreads(4);
+
+    // Each index is processed exactly once
+    const unsigned int sizes[] = {0, 1, 3, 4, 5, 100, 1001, 10000};
+    const unsigned int grains[] = {1, 7, 64, 5000};
+    for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+      for (unsigned int g = 0; g < sizeof(grains) / sizeof(grains[0]); g++) {
+        for (unsigned int nbThreads = 0; nbThreads <= 5; nbThreads++) {
+          std::vector<unsigned int> counts(sizes[s], 0);
+          CountIndices body;
+          body.counts = &counts;
+          vpThreadPool::parallel_for(0, sizes[s], body, nbThreads, grains[g]);
+          if (! checkCounts(counts, 1, "parallel_for()"))
+            return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // The number of bodies running at once never exceeds the limit
+    for (unsigned int poolSize = 1; poolSize <= 4; poolSize++) {
+      vpThreadPool::setNbThreads(poolSize);
+      for (unsigned int nbThreads = 0; nbThreads <= 5; nbThreads++) {
+        vpMutex mutex;
+        unsigned int running = 0, peak = 0;
+        ConcurrencyProbe body;
+        body.mutex = &mutex;
+        body.running = &running;
+        body.peak = &peak;
+        vpThreadPool::parallel_for(0, 400, body, nbThreads, 1);
+
+        const unsigned int limit = (nbThreads == 0) ? poolSize : std::min(poolSize, nbThreads);
+        if (peak == 0 || peak > limit) {
+          std::cerr << "Problem with the thread limit: " << peak << " bodies running at once with setNbThreads("
+                    << poolSize << ") and nbThreads = " << nbThreads << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+    vpThreadPool::setNbThreads(4);
+
+    // Range that does not start at 0
+    {
+      std::vector<unsigned int> counts(500, 0);
+      CountIndices body;
+      body.counts = &counts;
+      vpThreadPool::parallel_for(100, 400, body);
+      for (unsigned int i = 0; i < counts.size(); i++) {
+        if (counts[i] != ((i >= 100 && i < 400) ? 1u : 0u)) {
+          std::cerr << "Problem with parallel_for() over [100, 400) at index " << i << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // Loop started from a loop body
+    {
+      std::vector<std::vector<unsigned int> > counts(50, std::vector<unsigned int>(300, 0));
+      NestedLoop body;
+      body.counts = &counts;
+      vpThreadPool::parallel_for(0, (unsigned int) counts.size(), body);
+      for (size_t i = 0; i < counts.size(); i++) {
+        if (! checkCounts(counts[i], 1, "nested parallel_for()"))
+          return EXIT_FAILURE;
+      }
+    }
+
+    // Loops started from several threads at the same time
+    {
+      std::vector<std::vector<unsigned int> > counts(3, std::vector<unsigned int>(2000, 0));
+      std::vector<vpThread *> threads;
+      for (size_t i = 0; i < counts.size(); i++)
+        threads.push_back(new vpThread((vpThread::Fn) concurrentLoops, (vpThread::Args) &counts[i]));
+      for (size_t i = 0; i < threads.size(); i++) {
+        threads[i]->join();
+        delete threads[i];
+      }
+      for (size_t i = 0; i < counts.size(); i++) {
+        if (! checkCounts(counts[i], 20, "concurrent parallel_for()"))
+          return EXIT_FAILURE;
+      }
+    }
+
+    // Exception thrown by the loop body
+    for (unsigned int n = 0; n < 10; n++) {
+      bool caught = false;
+      try {
+        vpThreadPool::parallel_for(0, 1000, ThrowingLoop());
+      }
+      catch(vpException &e) {
+        caught = (e.getCode() == vpException::badValue);
+      }
+      if (! caught) {
+        std::cerr << "The exception of the loop body was not forwarded" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Cost of a loop compared to the creation of threads at each call
+    const unsigned int nbLoops = 200;
+    double t = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nbLoops; n++)
+      vpThreadPool::parallel_for(0, 4, emptyRange, NULL, 4);
+    double t_pool = (vpTime::measureTimeMs() - t) / nbLoops;
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nbLoops; n++) {
+      vpThread *threads[3];
+      for (unsigned int i = 0; i < 3; i++)
+        threads[i] = new vpThread((vpThread::Fn) emptyThread);
+      for (unsigned int i = 0; i < 3; i++) {
+        threads[i]->join();
+        delete threads[i];
+      }
+    }
+    double t_threads = (vpTime::measureTimeMs() - t) / nbLoops;
+
+    std::cout << "Empty loop over 4 threads: " << 1000*t_pool << " us with the pool ; "
+              << 1000*t_threads << " us creating the threads" << std::endl;
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
+
+#else
+
+#include <iostream>
+
+int main()
+{
+#  if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+  std::cout << "You should enable pthread usage and rebuild ViSP..." << std::endl;
+#  else
+  std::cout << "Multi-threading seems not supported on this platform" << std::endl;
+#  endif
+  return 0;
+}
+
+#endif
@@ -44,6 +44,7 @@
 #define vpDiskGrabber_hh
 
 #include <visp3/io/vpImageIo.h>
+#include <visp3/io/vpMappedImageReader.h>
 #include <visp3/core/vpFrameGrabber.h>
 #include <visp3/core/vpRGBa.h>
 #include <visp3/core/vpDebug.h>
@@ -58,7 +59,13 @@
   Defined a virtual video device. "Grab" the images from the disk.
   Derived from the vpFrameGrabber class.
 
-  \sa vpFrameGrabber
+  The binary PGM and PPM images are read with a vpMappedImageReader: the
+  files are mapped in memory, the header shared by the images of the
+  sequence is decoded once, and the next image is read ahead by the system
+  while the current one is processed. With setZeroCopy(), the grey images
+  read from PGM files even point directly on the mapped file.
+
+  \sa vpFrameGrabber, vpMappedImageReader
 
   Here an example of capture from the directory
   "/local/soft/ViSP/ViSP-images/cube". We want to acquire 10 images
@@ -118,6 +125,13 @@ private:
   bool useGenericName;
   char genericName[FILENAME_MAX];
 
+  vpMappedImageReader m_mappedReader; //!< reader of the PGM and PPM images
+  bool m_zeroCopy; //!< true if the grey images point on the mapped files
+
+  void prefetch(long number);
+  void readImage(vpImage<unsigned char> &I, const char *name);
+  void readImage(vpImage<vpRGBa> &I, const char *name);
+
 public:
   vpDiskGrabber();
   vpDiskGrabber(const char *genericName);
@@ -146,6 +160,7 @@ public:
   void setNumberOfZero(unsigned int noz);
   void setExtension(const char *ext);
   void setGenericName(const char *genericName);
+  void setZeroCopy(const bool zeroCopy);
 
   /*!
     Return the current image number.
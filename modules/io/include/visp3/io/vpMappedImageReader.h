@@ -0,0 +1,174 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Memory-mapped reader of PNM and raw images.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMappedImageReader.h
+  \brief Memory-mapped reader of PNM and raw images.
+*/
+
+#ifndef vpMappedImageReader_h
+#define vpMappedImageReader_h
+
+#include <string>
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpRGBa.h>
+
+/*!
+  \class vpMappedImageReader
+
+  \ingroup group_io_image
+
+  \brief Read binary PNM (PGM P5, PPM P6) or headerless raw images by
+  mapping the file in memory.
+
+  open() maps the whole file and decodes its header. The header of the
+  previous file is kept: when the next file starts with the same header, as
+  for the images of a sequence, it is not decoded again. The pages of the
+  file are read ahead sequentially by the system, and prefetch() asks the
+  system to start reading the next file of a sequence while the current one
+  is processed.
+
+  read() with \e copyData set to false does not copy the pixels of a PGM
+  file, or of a raw file with one or four channels: the image points
+  directly on the mapped file. Such an image is valid until the next call to
+  open() or close(), or until the reader is destroyed. The mapping is
+  private, so that modifying the image never modifies the file. Resizing or
+  copying the image allocates a new bitmap as usual.
+
+  \code
+#include <visp3/io/vpMappedImageReader.h>
+
+int main()
+{
+  vpImage<unsigned char> I;
+  vpMappedImageReader reader;
+  char filename[FILENAME_MAX];
+
+  for (int i = 1; i <= 100; i++) {
+    sprintf(filename, "./image/image%04d.pgm", i);
+    reader.open(filename);
+    sprintf(filename, "./image/image%04d.pgm", i+1);
+    reader.prefetch(filename); // Read ahead the next image
+    reader.read(I, false);     // I points on the mapped image, no copy
+    // Process I before the next open()
+  }
+}
+  \endcode
+
+  \note Without memory-mapped files support, open() reads the whole file in
+  a buffer owned by the reader, and the images are used the same way.
+
+  \sa vpImageIo, vpDiskGrabber
+*/
+class VISP_EXPORT vpMappedImageReader
+{
+public:
+  vpMappedImageReader();
+  virtual ~vpMappedImageReader();
+
+  void close();
+
+  /*!
+    Return the number of channels of the opened image: 1 for PGM, 3 for PPM,
+    the number given to setRawFormat() for a raw image.
+  */
+  inline unsigned int getChannels() const { return m_channels; }
+  /*!
+    Return the height of the opened image.
+  */
+  inline unsigned int getHeight() const { return m_height; }
+  /*!
+    Return the number of headers decoded since the construction of the
+    reader. The headers of the images of a sequence with the same size are
+    only decoded once.
+  */
+  inline unsigned int getNbDecodedHeaders() const { return m_nbDecodedHeaders; }
+  /*!
+    Return the address of the first pixel of the opened image, or NULL.
+  */
+  inline const unsigned char *getPayload() const { return m_payload; }
+  /*!
+    Return the width of the opened image.
+  */
+  inline unsigned int getWidth() const { return m_width; }
+  /*!
+    Return true if the opened file is mapped in memory, false if it was read
+    in a buffer.
+  */
+  inline bool isMapped() const { return m_mapped; }
+
+  void open(const std::string &filename);
+  void prefetch(const std::string &filename) const;
+
+  void read(vpImage<unsigned char> &I, const bool copyData=true);
+  void read(vpImage<vpRGBa> &I, const bool copyData=true);
+
+  void setPNMFormat();
+  void setRawFormat(const unsigned int height, const unsigned int width, const unsigned int channels=1,
+                    const unsigned int offset=0);
+
+private:
+  vpMappedImageReader(const vpMappedImageReader &);
+  vpMappedImageReader &operator=(const vpMappedImageReader &);
+
+  void decodeHeader(const std::string &filename);
+  void map(const std::string &filename);
+  void unmap();
+
+  //! Mapped file, or buffer when the file is not mapped
+  unsigned char *m_data;
+  size_t m_size;
+  bool m_mapped;
+  std::vector<unsigned char> m_buffer;
+#if defined(_WIN32)
+  void *m_mapping;
+#endif
+
+  //! True when the images are headerless raw images
+  bool m_raw;
+  unsigned int m_rawOffset;
+  //! Header of the last decoded PNM file
+  std::vector<unsigned char> m_header;
+  unsigned int m_nbDecodedHeaders;
+
+  unsigned char *m_payload;
+  unsigned int m_width;
+  unsigned int m_height;
+  unsigned int m_channels;
+};
+
+#endif
@@ -156,12 +156,49 @@ int main()
   writer.close();
 
   return 0;
+}
+  \endcode
+
+  By default saveFrame() encodes and writes the image in the calling thread.
+  setWriteBehind() enables a write-behind mode: saveFrame() only copies the
+  image in a bounded queue, and encoder threads write the queued images.
+  For an image sequence, several encoder threads compress PNG or JPEG
+  images in parallel, one image each; a video file is always encoded by a
+  single thread to keep the order of the frames. The queue policy tells
+  what saveFrame() does when the queue is full. getQueueDepth(),
+  getMaxQueueDepth() and getNbDroppedFrames() help to size the queue.
+
+  \code
+#include <visp3/io/vpVideoWriter.h>
+
+int main()
+{
+  vpImage<unsigned char> I(480, 640);
+  vpVideoWriter writer;
+  writer.setFileName("./image/image%04d.png");
+  // Queue of 10 images written by 2 threads, the oldest image is dropped when the queue is full
+  writer.setWriteBehind(10, 2, vpVideoWriter::QUEUE_DROP_OLDEST);
+  writer.open(I);
+  for (unsigned int i = 0; i < 100; i++) {
+    // Here the code to capture or create an image and store it in I.
+    writer.saveFrame(I); // Does not wait for the image to be written
+  }
+  writer.close(); // Write the images still in the queue
+  std::cout << writer.getNbDroppedFrames() << " images dropped" << std::endl;
 }
   \endcode
 */
 
 class VISP_EXPORT vpVideoWriter
 {    
+  public:
+    /*! Behavior of saveFrame() when the write-behind queue is full. */
+    typedef enum {
+      QUEUE_BLOCK,       /*!< Wait until an image of the queue is written. */
+      QUEUE_DROP_OLDEST, /*!< Drop the oldest image of the queue. */
+      QUEUE_DROP_NEWEST  /*!< Drop the image passed to saveFrame(). */
+    } vpQueuePolicy;
+
   private:   
 #ifdef VISP_HAVE_FFMPEG
     //!To read video files
@@ -216,11 +253,22 @@ class VISP_EXPORT vpVideoWriter
     unsigned int width;
     unsigned int height;
 
+    class vpWriteBehind;
+    //!Queue and encoder threads of the write-behind mode, NULL if disabled
+    vpWriteBehind *m_writeBehind;
+    unsigned int m_queueSize;
+    unsigned int m_nbEncoderThreads;
+    vpQueuePolicy m_queuePolicy;
+    //!Statistics of the last write-behind queue
+    unsigned int m_maxQueueDepth;
+    unsigned int m_nbDroppedFrames;
+
   public:
     vpVideoWriter();
     ~vpVideoWriter();
     
     void close();
+    void flush();
 
     /*!
       Gets the current frame index.
@@ -228,6 +276,9 @@ class VISP_EXPORT vpVideoWriter
       \return Returns the current frame index.
     */
     inline unsigned int getCurrentFrameIndex() const {return frameCount;}
+    unsigned int getMaxQueueDepth();
+    unsigned int getNbDroppedFrames();
+    unsigned int getQueueDepth();
 
     void open (vpImage< vpRGBa > &I);
     void open (vpImage< unsigned char > &I);
@@ -302,10 +353,17 @@ class VISP_EXPORT vpVideoWriter
       this->framerate = frame_rate;
     }
 #endif
+    void setWriteBehind(const unsigned int queueSize, const unsigned int nbThreads=1,
+                        const vpQueuePolicy policy=QUEUE_BLOCK);
 
     private:
       vpVideoFormatType getFormat(const char *filename);
       static std::string getExtension(const std::string &filename);
+      bool isImageSequence() const;
+      void startWriteBehind();
+      void stopWriteBehind(const bool flush);
+      void writeFrame(vpImage< vpRGBa > &I, const unsigned int index);
+      void writeFrame(vpImage< unsigned char > &I, const unsigned int index);
 };
 
 #endif
@@ -0,0 +1,390 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Memory-mapped reader of PNM and raw images.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMappedImageReader.cpp
+  \brief Memory-mapped reader of PNM and raw images.
+*/
+
+#include <cctype>
+#include <fstream>
+#include <string.h>
+
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpImageException.h>
+#include <visp3/io/vpMappedImageReader.h>
+
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__)))
+#  define VISP_HAVE_MMAP_UNIX 1
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#elif defined(_WIN32) && !defined(WINRT)
+#  define VISP_HAVE_MMAP_WIN32 1
+#  include <windows.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Skip the white spaces and the comments of a PNM header, then read an unsigned value.
+  bool readHeaderValue(const unsigned char *data, const size_t size, size_t &pos, unsigned int &value)
+  {
+    while (pos < size) {
+      if (data[pos] == '#') {
+        while (pos < size && data[pos] != '\n')
+          pos++;
+      }
+      else if (isspace(data[pos]))
+        pos++;
+      else
+        break;
+    }
+    if (pos == size || data[pos] < '0' || data[pos] > '9')
+      return false;
+
+    value = 0;
+    while (pos < size && data[pos] >= '0' && data[pos] <= '9') {
+      if (value > 100000) // larger than any accepted image size
+        return false;
+      value = 10 * value + (unsigned int)(data[pos] - '0');
+      pos++;
+    }
+    return true;
+  }
+}
+#endif
+
+/*!
+  Default constructor. The reader reads PNM files.
+*/
+vpMappedImageReader::vpMappedImageReader()
+  : m_data(NULL), m_size(0), m_mapped(false), m_buffer(),
+#if defined(_WIN32)
+    m_mapping(NULL),
+#endif
+    m_raw(false), m_rawOffset(0), m_header(), m_nbDecodedHeaders(0), m_payload(NULL), m_width(0), m_height(0),
+    m_channels(0)
+{
+}
+
+/*!
+  Destructor. The images read without copy become invalid.
+*/
+vpMappedImageReader::~vpMappedImageReader()
+{
+  unmap();
+}
+
+/*!
+  Release the opened file. The images read without copy become invalid.
+*/
+void vpMappedImageReader::close()
+{
+  unmap();
+}
+
+// Decode the header of the mapped PNM file and keep it for the next files
+void vpMappedImageReader::decodeHeader(const std::string &filename)
+{
+  unsigned int w = 0, h = 0, maxval = 0;
+  size_t pos = 2;
+
+  if (m_size < 2 || m_data[0] != 'P' || (m_data[1] != '5' && m_data[1] != '6')) {
+    throw(vpImageException(vpImageException::ioError,
+                           "\"%s\" is not a PNM file with magic number P5 or P6", filename.c_str()));
+  }
+  if (! readHeaderValue(m_data, m_size, pos, w) || ! readHeaderValue(m_data, m_size, pos, h)
+      || ! readHeaderValue(m_data, m_size, pos, maxval) || pos == m_size || ! isspace(m_data[pos])) {
+    throw(vpImageException(vpImageException::ioError, "Cannot read header of file \"%s\"", filename.c_str()));
+  }
+  if (w > 100000 || h > 100000) {
+    throw(vpException(vpException::badValue, "Bad image size in \"%s\"", filename.c_str()));
+  }
+  if (maxval > 255) {
+    throw(vpImageException(vpImageException::ioError, "Bad maxval in \"%s\"", filename.c_str()));
+  }
+  pos++; // single white space before the pixels
+
+  m_width = w;
+  m_height = h;
+  m_channels = (m_data[1] == '5') ? 1 : 3;
+  m_header.assign(m_data, m_data + pos);
+  m_nbDecodedHeaders++;
+}
+
+// Map the file in memory, or read it in a buffer when the file cannot be mapped
+void vpMappedImageReader::map(const std::string &filename)
+{
+#if defined(VISP_HAVE_MMAP_UNIX)
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw(vpImageException(vpImageException::ioError, "Cannot open file \"%s\"", filename.c_str()));
+  }
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    // Private mapping: the pages written through an image are copied, the file is never modified
+    void *addr = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED) {
+      m_data = (unsigned char *)addr;
+      m_size = (size_t)st.st_size;
+      m_mapped = true;
+      posix_madvise(addr, m_size, POSIX_MADV_SEQUENTIAL);
+      posix_madvise(addr, m_size, POSIX_MADV_WILLNEED);
+    }
+  }
+  ::close(fd);
+#elif defined(VISP_HAVE_MMAP_WIN32)
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw(vpImageException(vpImageException::ioError, "Cannot open file \"%s\"", filename.c_str()));
+  }
+  LARGE_INTEGER size;
+  if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (mapping != NULL) {
+      void *addr = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+      if (addr != NULL) {
+        m_data = (unsigned char *)addr;
+        m_size = (size_t)size.QuadPart;
+        m_mapped = true;
+        m_mapping = mapping;
+      }
+      else
+        CloseHandle(mapping);
+    }
+  }
+  CloseHandle(file);
+#endif
+
+  if (! m_mapped) {
+    std::ifstream fd(filename.c_str(), std::ios::binary);
+    if (! fd.is_open()) {
+      throw(vpImageException(vpImageException::ioError, "Cannot open file \"%s\"", filename.c_str()));
+    }
+    fd.seekg(0, std::ios::end);
+    std::streamoff size = fd.tellg();
+    fd.seekg(0, std::ios::beg);
+    m_buffer.resize(size > 0 ? (size_t)size : 1);
+    if (size > 0)
+      fd.read((char *)&m_buffer[0], size);
+    m_data = &m_buffer[0];
+    m_size = (size > 0 && fd) ? (size_t)size : 0;
+  }
+}
+
+/*!
+  Open an image file. The pixels are not copied: the file is mapped in
+  memory and read on demand by the system.
+
+  For a PNM file, the header is only decoded if it differs from the header
+  of the previous file.
+
+  \param filename : Name of a binary PGM (P5) or PPM (P6) file, or of a raw
+  file when setRawFormat() was called.
+
+  \exception vpImageException::ioError : If the file cannot be opened, if
+  its header cannot be decoded or if it is too small for the image size.
+*/
+void vpMappedImageReader::open(const std::string &filename)
+{
+  unmap();
+  map(filename);
+
+  size_t offset = m_rawOffset;
+  if (! m_raw) {
+    // Images of a sequence share the same header
+    if (m_header.empty() || m_size < m_header.size() || memcmp(m_data, &m_header[0], m_header.size()) != 0) {
+      try {
+        decodeHeader(filename);
+      }
+      catch(...) {
+        unmap();
+        m_header.clear();
+        throw;
+      }
+    }
+    offset = m_header.size();
+  }
+
+  size_t nbytes = (size_t)m_width * m_height * m_channels;
+  if (m_size < offset || m_size - offset < nbytes) {
+    size_t size = m_size;
+    unmap();
+    throw(vpImageException(vpImageException::ioError, "Read only %d of %d bytes in file \"%s\"",
+                           (int)(size > offset ? size - offset : 0), (int)nbytes, filename.c_str()));
+  }
+  m_payload = m_data + offset;
+}
+
+/*!
+  Ask the system to read ahead a file that will be opened later, typically
+  the next image of a sequence. Nothing is done if the file does not exist
+  or if the system has no such hint.
+
+  \param filename : Name of the file to read ahead.
+*/
+void vpMappedImageReader::prefetch(const std::string &filename) const
+{
+#if defined(VISP_HAVE_MMAP_UNIX) && defined(POSIX_FADV_WILLNEED)
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    ::close(fd);
+  }
+#else
+  (void) filename;
+#endif
+}
+
+/*!
+  Set the grey image with the opened image. A colour image is converted.
+
+  \param I : Image set with the opened image.
+  \param copyData : If false, a grey image is not copied: \e I points on the
+  file mapped in memory and is valid until the next call to open() or
+  close(). If true, the pixels are copied in the bitmap of \e I.
+
+  \exception vpException::notInitialized : If no image is opened.
+*/
+void vpMappedImageReader::read(vpImage<unsigned char> &I, const bool copyData)
+{
+  if (m_payload == NULL) {
+    throw(vpException(vpException::notInitialized, "No image is opened"));
+  }
+
+  if (m_channels == 1) {
+    if (copyData)
+      I.init(m_payload, m_height, m_width, true);
+    else
+      I.initNonOwning(m_payload, m_height, m_width);
+  }
+  else {
+    I.resize(m_height, m_width);
+    if (m_channels == 3)
+      vpImageConvert::RGBToGrey(m_payload, I.bitmap, m_width * m_height);
+    else
+      vpImageConvert::RGBaToGrey(m_payload, I.bitmap, m_width * m_height);
+  }
+}
+
+/*!
+  Set the colour image with the opened image. A grey or RGB image is
+  converted.
+
+  \param I : Image set with the opened image.
+  \param copyData : If false, a raw image with four channels is not copied:
+  \e I points on the file mapped in memory and is valid until the next call
+  to open() or close(). If true, the pixels are copied in the bitmap of \e I.
+
+  \exception vpException::notInitialized : If no image is opened.
+*/
+void vpMappedImageReader::read(vpImage<vpRGBa> &I, const bool copyData)
+{
+  if (m_payload == NULL) {
+    throw(vpException(vpException::notInitialized, "No image is opened"));
+  }
+
+  if (m_channels == 4) {
+    if (copyData)
+      I.init((vpRGBa *)m_payload, m_height, m_width, true);
+    else
+      I.initNonOwning((vpRGBa *)m_payload, m_height, m_width);
+  }
+  else {
+    I.resize(m_height, m_width);
+    if (m_channels == 3)
+      vpImageConvert::RGBToRGBa(m_payload, (unsigned char *)I.bitmap, m_width * m_height);
+    else
+      vpImageConvert::GreyToRGBa(m_payload, (unsigned char *)I.bitmap, m_width * m_height);
+  }
+}
+
+/*!
+  Read binary PGM (P5) and PPM (P6) files. This is the default.
+  \sa setRawFormat()
+*/
+void vpMappedImageReader::setPNMFormat()
+{
+  m_raw = false;
+  m_rawOffset = 0;
+  m_header.clear();
+}
+
+/*!
+  Read headerless raw files, where the pixels are stored row by row with
+  one byte per channel.
+
+  \param height : Image height.
+  \param width : Image width.
+  \param channels : 1 for grey images, 3 for RGB images, 4 for RGBa images.
+  \param offset : Number of bytes before the first pixel.
+
+  \exception vpException::badValue : If the number of channels is not 1, 3
+  or 4.
+
+  \sa setPNMFormat()
+*/
+void vpMappedImageReader::setRawFormat(const unsigned int height, const unsigned int width,
+                                       const unsigned int channels, const unsigned int offset)
+{
+  if (channels != 1 && channels != 3 && channels != 4) {
+    throw(vpException(vpException::badValue, "Bad number of channels %d for a raw image", channels));
+  }
+  m_raw = true;
+  m_rawOffset = offset;
+  m_width = width;
+  m_height = height;
+  m_channels = channels;
+  m_header.clear();
+}
+
+// Release the mapping or the buffer of the opened file
+void vpMappedImageReader::unmap()
+{
+  if (m_mapped) {
+#if defined(VISP_HAVE_MMAP_UNIX)
+    munmap(m_data, m_size);
+#elif defined(VISP_HAVE_MMAP_WIN32)
+    UnmapViewOfFile(m_data);
+    CloseHandle((HANDLE)m_mapping);
+    m_mapping = NULL;
+#endif
+  }
+  m_data = NULL;
+  m_size = 0;
+  m_mapped = false;
+  m_payload = NULL;
+}
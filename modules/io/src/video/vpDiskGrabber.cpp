@@ -36,14 +36,34 @@
  *****************************************************************************/
 
 
+#include <string.h>
+#include <cctype>
+
 #include <visp3/io/vpDiskGrabber.h>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // true if the file is a PGM or PPM image, read by the mapped reader
+  bool isMappedFormat(const char *name)
+  {
+    size_t length = strlen(name);
+    if (length < 4 || name[length-4] != '.')
+      return false;
+    std::string ext(name + length - 3);
+    for (size_t i = 0; i < ext.size(); i++)
+      ext[i] = (char)tolower(ext[i]);
+    return (ext == "pgm" || ext == "ppm");
+  }
+}
+#endif
+
 
 /*!
   Elementary constructor.
 */
 vpDiskGrabber::vpDiskGrabber()
-  : image_number(0), image_number_next(0), image_step(1), number_of_zero(0), useGenericName(false)
+  : image_number(0), image_number_next(0), image_step(1), number_of_zero(0), useGenericName(false),
+    m_mappedReader(), m_zeroCopy(false)
 {
   setDirectory("/tmp");
   setBaseName("I");
@@ -54,7 +74,8 @@ vpDiskGrabber::vpDiskGrabber()
 
 
 vpDiskGrabber::vpDiskGrabber(const char *generic_name)
-  : image_number(0), image_number_next(0), image_step(1), number_of_zero(0), useGenericName(false)
+  : image_number(0), image_number_next(0), image_step(1), number_of_zero(0), useGenericName(false),
+    m_mappedReader(), m_zeroCopy(false)
 {
   setDirectory("/tmp");
   setBaseName("I");
@@ -86,7 +107,8 @@ vpDiskGrabber::vpDiskGrabber(const char *dir, const char *basename,
                              long number,
                              int step, unsigned int noz,
                              const char *ext)
-  : image_number(number), image_number_next(number), image_step(step), number_of_zero(noz), useGenericName(false)
+  : image_number(number), image_number_next(number), image_step(step), number_of_zero(noz), useGenericName(false),
+    m_mappedReader(), m_zeroCopy(false)
 {
   setDirectory(dir);
   setBaseName(basename);
@@ -180,7 +202,8 @@ vpDiskGrabber::acquire(vpImage<unsigned char> &I)
 
   vpDEBUG_TRACE(2, "load: %s\n", name);
 
-  vpImageIo::read(I, name) ;
+  readImage(I, name) ;
+  prefetch(image_number_next);
 
   width = I.getWidth();
   height = I.getHeight();
@@ -208,7 +231,8 @@ vpDiskGrabber::acquire(vpImage<vpRGBa> &I)
 
   vpDEBUG_TRACE(2, "load: %s\n", name);
 
-  vpImageIo::read(I, name) ;
+  readImage(I, name) ;
+  prefetch(image_number_next);
 
   width = I.getWidth();
   height = I.getHeight();
@@ -267,7 +291,7 @@ vpDiskGrabber::acquire(vpImage<unsigned char> &I, long img_number)
 
   vpDEBUG_TRACE(2, "load: %s\n", name);
 
-  vpImageIo::read(I, name) ;
+  readImage(I, name) ;
 
   width = I.getWidth();
   height = I.getHeight();
@@ -296,7 +320,7 @@ vpDiskGrabber::acquire(vpImage<vpRGBa> &I, long img_number)
 
   vpDEBUG_TRACE(2, "load: %s\n", name);
 
-  vpImageIo::read(I, name) ;
+  readImage(I, name) ;
 
   width = I.getWidth();
   height = I.getHeight();
@@ -340,7 +364,8 @@ vpDiskGrabber::acquire(vpImage<float> &I, long img_number)
 void
 vpDiskGrabber::close()
 {
-  // Nothing do do here...
+  // The grey images read without copy become invalid
+  m_mappedReader.close();
 }
 
 
@@ -421,3 +446,61 @@ vpDiskGrabber::setGenericName(const char *generic_name)
   strcpy(this->genericName, generic_name) ;
   useGenericName = true;
 }
+
+/*!
+  Set if the grey images read from PGM files are copied, which is the
+  default, or if they point directly on the file mapped in memory.
+
+  \param zeroCopy : If true, acquire(vpImage<unsigned char> &) does not copy
+  the pixels of a PGM file. The image is then valid until the next
+  acquisition or close(), and until the grabber is destroyed.
+*/
+void
+vpDiskGrabber::setZeroCopy(const bool zeroCopy)
+{
+  m_zeroCopy = zeroCopy;
+}
+
+// ask the system to read ahead the image that the next acquire() reads
+void
+vpDiskGrabber::prefetch(long number)
+{
+  char name[FILENAME_MAX] ;
+  int length;
+
+  if(useGenericName)
+    length = snprintf(name,sizeof(name),genericName,number) ;
+  else
+    length = snprintf(name,sizeof(name),"%s/%s%0*ld.%s",directory,base_name,number_of_zero,number,extension) ;
+
+  // a truncated name is not the one of the next image
+  if (length < 0 || length >= (int)sizeof(name))
+    return;
+
+  if (isMappedFormat(name))
+    m_mappedReader.prefetch(name);
+}
+
+// read a grey image with the mapped reader if possible
+void
+vpDiskGrabber::readImage(vpImage<unsigned char> &I, const char *name)
+{
+  if (isMappedFormat(name)) {
+    m_mappedReader.open(name);
+    m_mappedReader.read(I, ! m_zeroCopy);
+  }
+  else
+    vpImageIo::read(I, name) ;
+}
+
+// read a colour image with the mapped reader if possible
+void
+vpDiskGrabber::readImage(vpImage<vpRGBa> &I, const char *name)
+{
+  if (isMappedFormat(name)) {
+    m_mappedReader.open(name);
+    m_mappedReader.read(I, true);
+  }
+  else
+    vpImageIo::read(I, name) ;
+}
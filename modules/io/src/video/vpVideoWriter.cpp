@@ -48,6 +48,259 @@
 #  include <opencv2/imgproc/imgproc.hpp>
 #endif
 
+#include <deque>
+#include <string.h>
+#include <vector>
+
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+#  define VISP_HAVE_WRITE_BEHIND 1
+#  include <visp3/core/vpCondition.h>
+#  include <visp3/core/vpThread.h>
+#endif
+
+#if defined(VISP_HAVE_WRITE_BEHIND)
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  template<class Type>
+  void copyFrame(const vpImage<Type> &src, vpImage<Type> &dst)
+  {
+    // resize() keeps the memory of dst when the size is the same
+    dst.resize(src.getHeight(), src.getWidth());
+    memcpy(static_cast<void *>(dst.bitmap), src.bitmap, src.getSize() * sizeof(Type));
+  }
+}
+
+class vpVideoWriter::vpWriteBehind
+{
+public:
+  // Image waiting in the queue or being written
+  struct vpFrame {
+    vpFrame() : m_grey(), m_color(), m_rgba(false), m_index(0) {}
+
+    vpImage<unsigned char> m_grey;
+    vpImage<vpRGBa> m_color;
+    bool m_rgba;
+    unsigned int m_index;
+  };
+
+  vpWriteBehind(vpVideoWriter &writer, unsigned int queueSize, unsigned int nbThreads, vpQueuePolicy policy)
+    : m_writer(writer), m_queueSize(queueSize), m_policy(policy), m_frames(), m_free(), m_queue(),
+      m_nbWriting(0), m_maxDepth(0), m_nbDropped(0), m_stop(false),
+      m_failed(false), m_errorCode(vpException::fatalError), m_errorMessage(),
+      m_mutex(), m_work(), m_space(), m_idle(), m_threads()
+  {
+    // Enough frames for a full queue and one image written by each thread,
+    // so that a free frame is always available to saveFrame()
+    m_frames.resize(queueSize + nbThreads);
+    for (size_t k = 0; k < m_frames.size(); k++) {
+      m_frames[k] = new vpFrame;
+      m_free.push_back(m_frames[k]);
+    }
+
+    for (unsigned int k = 0; k < nbThreads; k++) {
+      m_threads.push_back(new vpThread((vpThread::Fn) encoderThread, (vpThread::Args) this));
+    }
+  }
+
+  // Write the images still in the queue and stop the threads
+  ~vpWriteBehind()
+  {
+    m_mutex.lock();
+    m_stop = true;
+    m_work.notifyAll();
+    m_mutex.unlock();
+
+    for (size_t k = 0; k < m_threads.size(); k++) {
+      m_threads[k]->join();
+      delete m_threads[k];
+    }
+    for (size_t k = 0; k < m_frames.size(); k++) {
+      delete m_frames[k];
+    }
+  }
+
+  template<class Type>
+  void push(const vpImage<Type> &I, unsigned int index)
+  {
+    m_mutex.lock();
+    rethrow();
+
+    while (m_queue.size() >= m_queueSize) {
+      if (m_policy == QUEUE_BLOCK) {
+        m_space.wait(m_mutex);
+        continue;
+      }
+
+      m_nbDropped++;
+      if (m_policy == QUEUE_DROP_NEWEST) {
+        m_mutex.unlock();
+        return;
+      }
+      m_free.push_back(m_queue.front());
+      m_queue.pop_front();
+    }
+
+    vpFrame *frame = m_free.back();
+    m_free.pop_back();
+    m_mutex.unlock();
+
+    // The frame is neither free nor queued while it is copied
+    setFrame(*frame, I);
+    frame->m_index = index;
+
+    m_mutex.lock();
+    m_queue.push_back(frame);
+    if (m_queue.size() > m_maxDepth)
+      m_maxDepth = (unsigned int) m_queue.size();
+    m_work.notifyAll();
+    m_mutex.unlock();
+  }
+
+  // Wait until all the queued images are written
+  void flush()
+  {
+    m_mutex.lock();
+    while (!m_queue.empty() || m_nbWriting > 0)
+      m_idle.wait(m_mutex);
+    rethrow();
+    m_mutex.unlock();
+  }
+
+  unsigned int getMaxDepth()
+  {
+    m_mutex.lock();
+    unsigned int maxDepth = m_maxDepth;
+    m_mutex.unlock();
+    return maxDepth;
+  }
+
+  unsigned int getNbDropped()
+  {
+    m_mutex.lock();
+    unsigned int nbDropped = m_nbDropped;
+    m_mutex.unlock();
+    return nbDropped;
+  }
+
+  unsigned int getDepth()
+  {
+    m_mutex.lock();
+    unsigned int depth = (unsigned int) m_queue.size();
+    m_mutex.unlock();
+    return depth;
+  }
+
+private:
+  vpWriteBehind(const vpWriteBehind &);
+  vpWriteBehind &operator=(const vpWriteBehind &);
+
+  static void setFrame(vpFrame &frame, const vpImage<unsigned char> &I)
+  {
+    copyFrame(I, frame.m_grey);
+    frame.m_rgba = false;
+  }
+
+  static void setFrame(vpFrame &frame, const vpImage<vpRGBa> &I)
+  {
+    copyFrame(I, frame.m_color);
+    frame.m_rgba = true;
+  }
+
+  // Throw, once, the first error of the encoder threads. Called with the
+  // mutex locked, which is unlocked before throwing.
+  void rethrow()
+  {
+    if (m_failed) {
+      m_failed = false;
+      int code = m_errorCode;
+      std::string message = m_errorMessage;
+      m_mutex.unlock();
+      throw(vpException(code, message));
+    }
+  }
+
+  static vpThread::Return encoderThread(vpThread::Args args)
+  {
+    ((vpWriteBehind *) args)->run();
+    return 0;
+  }
+
+  // Loop of an encoder thread
+  void run()
+  {
+    m_mutex.lock();
+    for (;;) {
+      while (m_queue.empty() && !m_stop)
+        m_work.wait(m_mutex);
+      if (m_queue.empty())
+        break;
+
+      vpFrame *frame = m_queue.front();
+      m_queue.pop_front();
+      m_nbWriting++;
+      m_space.notifyAll();
+      m_mutex.unlock();
+
+      bool failed = false;
+      int errorCode = vpException::fatalError;
+      std::string errorMessage;
+      try {
+        if (frame->m_rgba)
+          m_writer.writeFrame(frame->m_color, frame->m_index);
+        else
+          m_writer.writeFrame(frame->m_grey, frame->m_index);
+      }
+      catch(vpException &e) {
+        failed = true;
+        errorCode = e.getCode();
+        errorMessage = e.getStringMessage();
+      }
+      catch(...) {
+        failed = true;
+        errorMessage = "Unknown exception in an encoder thread";
+      }
+
+      m_mutex.lock();
+      if (failed && !m_failed) {
+        m_failed = true;
+        m_errorCode = errorCode;
+        m_errorMessage = errorMessage;
+      }
+      m_free.push_back(frame);
+      m_nbWriting--;
+      m_idle.notifyAll();
+    }
+    m_mutex.unlock();
+  }
+
+  vpVideoWriter &m_writer;
+  unsigned int m_queueSize;
+  vpQueuePolicy m_policy;
+  std::vector<vpFrame *> m_frames;
+  std::vector<vpFrame *> m_free;
+  //! Images to write, oldest first
+  std::deque<vpFrame *> m_queue;
+  //! Number of images being written
+  unsigned int m_nbWriting;
+  unsigned int m_maxDepth;
+  unsigned int m_nbDropped;
+  bool m_stop;
+  bool m_failed;
+  int m_errorCode;
+  std::string m_errorMessage;
+
+  vpConditionMutex m_mutex;
+  //! Signaled when an image is queued or the threads have to stop
+  vpCondition m_work;
+  //! Signaled when an image leaves the queue
+  vpCondition m_space;
+  //! Signaled when an image is written
+  vpCondition m_idle;
+  std::vector<vpThread *> m_threads;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+#endif
+
 
 /*!
   Basic constructor.
@@ -66,7 +319,8 @@ vpVideoWriter::vpVideoWriter() :
     writer(), fourcc(0), framerate(0.),
 #endif
     formatType(FORMAT_UNKNOWN), initFileName(false), isOpen(false), frameCount(0),
-    firstFrame(0), width(0), height(0)
+    firstFrame(0), width(0), height(0), m_writeBehind(NULL), m_queueSize(0), m_nbEncoderThreads(1),
+    m_queuePolicy(QUEUE_BLOCK), m_maxQueueDepth(0), m_nbDroppedFrames(0)
 {
   initFileName = false;
   firstFrame = 0;
@@ -97,6 +351,8 @@ vpVideoWriter::vpVideoWriter() :
 */
 vpVideoWriter::~vpVideoWriter()
 {
+  // Write the images still in the queue before the encoder is deleted
+  stopWriteBehind(false);
   #ifdef VISP_HAVE_FFMPEG
   if (ffmpeg != NULL)
     delete ffmpeg;
@@ -159,6 +415,11 @@ void vpVideoWriter::open(vpImage< vpRGBa > &I)
     vpERROR_TRACE("The generic filename has to be set");
     throw (vpImageException(vpImageException::noFileNameError,"filename empty"));
   }
+
+  // Write the images queued before a new open
+  stopWriteBehind(false);
+  m_maxQueueDepth = 0;
+  m_nbDroppedFrames = 0;
   
   if (formatType == FORMAT_PGM ||
       formatType == FORMAT_PPM ||
@@ -195,6 +456,8 @@ void vpVideoWriter::open(vpImage< vpRGBa > &I)
   }
   
   frameCount = firstFrame;
+
+  startWriteBehind();
   
   isOpen = true;
 }
@@ -212,6 +475,11 @@ void vpVideoWriter::open(vpImage< unsigned char > &I)
     vpERROR_TRACE("The generic filename has to be set");
     throw (vpImageException(vpImageException::noFileNameError,"filename empty"));
   }
+
+  // Write the images queued before a new open
+  stopWriteBehind(false);
+  m_maxQueueDepth = 0;
+  m_nbDroppedFrames = 0;
   
   if (formatType == FORMAT_PGM ||
       formatType == FORMAT_PPM ||
@@ -248,6 +516,8 @@ void vpVideoWriter::open(vpImage< unsigned char > &I)
   }
   
   frameCount = firstFrame;
+
+  startWriteBehind();
   
   isOpen = true;
 }
@@ -257,8 +527,13 @@ void vpVideoWriter::open(vpImage< unsigned char > &I)
   Saves the image as a frame of the video or as an image belonging to the image sequence.
  
   Each time this method is used, the frame counter is incremented and thus the file name change for the case of an image sequence.
+
+  In write-behind mode (see setWriteBehind()), the image is only copied in the queue. The frame counter is also
+  incremented when the image is dropped, so that the missing file names of an image sequence show the dropped images.
  
   \param I : The image which has to be saved
+
+  \exception vpException : In write-behind mode, the first error met by an encoder thread since the previous call.
 */
 void vpVideoWriter::saveFrame (vpImage< vpRGBa > &I)
 {
@@ -268,28 +543,12 @@ void vpVideoWriter::saveFrame (vpImage< vpRGBa > &I)
     throw (vpException(vpException::notInitialized,"file not yet opened"));
   }
 
-  
-  if (formatType == FORMAT_PGM ||
-      formatType == FORMAT_PPM ||
-      formatType == FORMAT_JPEG ||
-      formatType == FORMAT_PNG)
-  {
-    char name[FILENAME_MAX];
-
-    sprintf(name,fileName,frameCount);
-
-    vpImageIo::write(I, name);
-  }
+#if defined(VISP_HAVE_WRITE_BEHIND)
+  if (m_writeBehind != NULL)
+    m_writeBehind->push(I, frameCount);
   else
-  {
-#ifdef VISP_HAVE_FFMPEG
-    ffmpeg->saveFrame(I);
-#elif VISP_HAVE_OPENCV_VERSION >= 0x020100
-	  cv::Mat matFrame;
-	  vpImageConvert::convert(I, matFrame);
-	  writer << matFrame;
 #endif
-  }
+    writeFrame(I, frameCount);
 
   frameCount++;
 }
@@ -299,8 +558,13 @@ void vpVideoWriter::saveFrame (vpImage< vpRGBa > &I)
   Saves the image as a frame of the video or as an image belonging to the image sequence.
  
   Each time this method is used, the frame counter is incremented and thus the file name change for the case of an image sequence.
+
+  In write-behind mode (see setWriteBehind()), the image is only copied in the queue. The frame counter is also
+  incremented when the image is dropped, so that the missing file names of an image sequence show the dropped images.
  
   \param I : The image which has to be saved
+
+  \exception vpException : In write-behind mode, the first error met by an encoder thread since the previous call.
 */
 void vpVideoWriter::saveFrame (vpImage< unsigned char > &I)
 {
@@ -310,14 +574,55 @@ void vpVideoWriter::saveFrame (vpImage< unsigned char > &I)
     throw (vpException(vpException::notInitialized,"file not yet opened"));
   }
 
-  if (formatType == FORMAT_PGM ||
-      formatType == FORMAT_PPM ||
-      formatType == FORMAT_JPEG ||
-      formatType == FORMAT_PNG)
+#if defined(VISP_HAVE_WRITE_BEHIND)
+  if (m_writeBehind != NULL)
+    m_writeBehind->push(I, frameCount);
+  else
+#endif
+    writeFrame(I, frameCount);
+
+  frameCount++;
+}
+
+
+/*!
+  Encodes and writes a color image, either as the file \e index of the image sequence or as the next frame of the
+  video. Called by the encoder threads in write-behind mode.
+*/
+void vpVideoWriter::writeFrame (vpImage< vpRGBa > &I, const unsigned int index)
+{
+  if (isImageSequence())
   {
     char name[FILENAME_MAX];
 
-    sprintf(name,fileName,frameCount);
+    sprintf(name,fileName,index);
+
+    vpImageIo::write(I, name);
+  }
+  else
+  {
+#ifdef VISP_HAVE_FFMPEG
+    ffmpeg->saveFrame(I);
+#elif VISP_HAVE_OPENCV_VERSION >= 0x020100
+	  cv::Mat matFrame;
+	  vpImageConvert::convert(I, matFrame);
+	  writer << matFrame;
+#endif
+  }
+}
+
+
+/*!
+  Encodes and writes a grey level image, either as the file \e index of the image sequence or as the next frame of
+  the video. Called by the encoder threads in write-behind mode.
+*/
+void vpVideoWriter::writeFrame (vpImage< unsigned char > &I, const unsigned int index)
+{
+  if (isImageSequence())
+  {
+    char name[FILENAME_MAX];
+
+    sprintf(name,fileName,index);
 
     vpImageIo::write(I, name);
   }
@@ -337,13 +642,16 @@ void vpVideoWriter::saveFrame (vpImage< unsigned char > &I)
     writer << rgbMatFrame;
 #endif
   }
-
-  frameCount++;
 }
 
 
 /*!
   Deallocates parameters use to write the video or the image sequence.
+
+  In write-behind mode, the images still in the queue are written first.
+
+  \exception vpException : In write-behind mode, the first error met by an encoder thread since the previous call.
+  In that case close() has to be called again.
 */
 void vpVideoWriter::close()
 {
@@ -352,6 +660,8 @@ void vpVideoWriter::close()
     vpERROR_TRACE("The video has to be open first with the open method");
     throw (vpException(vpException::notInitialized,"file not yet opened"));
   }
+  // Throws the last errors of the encoder threads, close() can then be called again
+  stopWriteBehind(true);
   #ifdef VISP_HAVE_FFMPEG
   if (ffmpeg != NULL)
   {
@@ -429,3 +739,116 @@ std::string vpVideoWriter::getExtension(const std::string &filename)
   std::string ext = filename.substr(dot, filename.size()-1);
   return ext;
 }
+
+/*!
+  Wait until the images queued in write-behind mode are written. Without write-behind, return immediately.
+
+  \exception vpException : The first error met by an encoder thread since the previous call.
+*/
+void vpVideoWriter::flush()
+{
+#if defined(VISP_HAVE_WRITE_BEHIND)
+  if (m_writeBehind != NULL)
+    m_writeBehind->flush();
+#endif
+}
+
+/*!
+  Return the largest number of images waiting in the write-behind queue since open(), or 0 without write-behind.
+*/
+unsigned int vpVideoWriter::getMaxQueueDepth()
+{
+#if defined(VISP_HAVE_WRITE_BEHIND)
+  if (m_writeBehind != NULL)
+    return m_writeBehind->getMaxDepth();
+#endif
+  return m_maxQueueDepth;
+}
+
+/*!
+  Return the number of images dropped since open() because the write-behind queue was full, or 0 without
+  write-behind.
+*/
+unsigned int vpVideoWriter::getNbDroppedFrames()
+{
+#if defined(VISP_HAVE_WRITE_BEHIND)
+  if (m_writeBehind != NULL)
+    return m_writeBehind->getNbDropped();
+#endif
+  return m_nbDroppedFrames;
+}
+
+/*!
+  Return the number of images waiting in the write-behind queue, or 0 without write-behind.
+*/
+unsigned int vpVideoWriter::getQueueDepth()
+{
+#if defined(VISP_HAVE_WRITE_BEHIND)
+  if (m_writeBehind != NULL)
+    return m_writeBehind->getDepth();
+#endif
+  return 0;
+}
+
+// return true if the images are written as an image sequence
+bool vpVideoWriter::isImageSequence() const
+{
+  return (formatType == FORMAT_PGM || formatType == FORMAT_PPM || formatType == FORMAT_JPEG ||
+          formatType == FORMAT_PNG);
+}
+
+/*!
+  Enable the write-behind mode, where saveFrame() copies the image in a queue and returns while encoder threads
+  write it. If the writer is already open, the images already queued are written first.
+
+  \param queueSize : Maximum number of images waiting to be written. 0 disables the write-behind mode, which is the
+  default.
+  \param nbThreads : Number of encoder threads. It is used for an image sequence, where the images are compressed in
+  parallel. A video file is always encoded by a single thread.
+  \param policy : What saveFrame() does when the queue is full.
+
+  \note Need thread support. Without it, the images are always written by saveFrame().
+*/
+void vpVideoWriter::setWriteBehind(const unsigned int queueSize, const unsigned int nbThreads,
+                                   const vpQueuePolicy policy)
+{
+  m_queueSize = queueSize;
+  m_nbEncoderThreads = (nbThreads > 0) ? nbThreads : 1;
+  m_queuePolicy = policy;
+
+  if (isOpen)
+  {
+    stopWriteBehind(true);
+    startWriteBehind();
+  }
+}
+
+// start the encoder threads if the write-behind mode is enabled
+void vpVideoWriter::startWriteBehind()
+{
+#if defined(VISP_HAVE_WRITE_BEHIND)
+  if (m_queueSize > 0)
+    m_writeBehind = new vpWriteBehind(*this, m_queueSize, isImageSequence() ? m_nbEncoderThreads : 1, m_queuePolicy);
+#endif
+}
+
+// write the queued images, keep the statistics and stop the encoder threads. When flush is true, the first error of
+// the encoder threads is thrown before the threads are stopped.
+void vpVideoWriter::stopWriteBehind(const bool flush)
+{
+#if defined(VISP_HAVE_WRITE_BEHIND)
+  if (m_writeBehind != NULL)
+  {
+    if (flush)
+      m_writeBehind->flush();
+    // no image is pushed anymore, the statistics are final
+    m_maxQueueDepth = m_writeBehind->getMaxDepth();
+    m_nbDroppedFrames = m_writeBehind->getNbDropped();
+    // the destructor writes the last queued images
+    delete m_writeBehind;
+    m_writeBehind = NULL;
+  }
+#else
+  (void) flush;
+#endif
+}
@@ -56,6 +56,8 @@
   You can use a colored or a gray scaled image.
   
   To avoid the aliasing especially when the camera is very near from the image plane, a bilinear interpolation can be done for every pixels which have to be filled in. By default this functionality is not used because it consumes lot of time.
+
+  The projection of the plane is computed once per call to getImage(): the texture coordinates and the depth of the point seen by a pixel are then updated incrementally along each row of the image, and the rows can be filled in parallel by vpThreadPool threads, see setNbThreads(). The bilinear interpolation of the texture uses fixed-point weights.
   
   The  following example explain how to use the class.
   
@@ -130,6 +132,31 @@
 #include <vector>
 #include <list>
 
+/*!
+  \struct vpImageSimulatorPlane
+  Projection of a textured plane in the image of the virtual camera, used by
+  vpImageSimulator::getImage(). For a pixel of normalized coordinates
+  \f$(x, y)\f$, \f$ w = w_0 x + w_1 y + w_2 \f$ is the distance of the plane
+  divided by the depth of the point of the plane seen by the pixel, and
+  \f$ u/w \f$, \f$ v/w \f$ are the coordinates of this point in the texture,
+  between 0 and 1 inside the plane. \f$ u \f$ and \f$ v \f$ are computed the
+  same way as \f$ w \f$.
+*/
+struct vpImageSimulatorPlane {
+  double u[3];        //!< Texture column coordinate, times w
+  double v[3];        //!< Texture row coordinate, times w
+  double w[3];        //!< Distance of the plane divided by the depth
+  double distance;    //!< Distance from the camera center to the plane
+  double wmax;        //!< Largest w of the points that are not removed by the near clipping
+  unsigned int top;   //!< First row of the region of the camera image to fill
+  unsigned int bottom;//!< Row after the last row of the region
+  unsigned int left;  //!< First column of the region
+  unsigned int right; //!< Column after the last column of the region
+  const vpImage<unsigned char> *Ig; //!< Grey level texture, or NULL
+  const vpImage<vpRGBa> *Ic;        //!< Color texture, or NULL
+  bool bilinear;      //!< Bilinear interpolation of the texture
+};
+
 class VISP_EXPORT vpImageSimulator
 {
   public:
@@ -177,9 +204,6 @@ class VISP_EXPORT vpImageSimulator
     double *vbase_u_optim;
     double *vbase_v_optim;
 
-    //allocation memoire du point 3D d'intersection entre le vecteur (centre_cam - point_plan_image) et le plan
-    double *Xinter_optim;
-
     //triangles de projection du plan
     std::vector<vpTriangle> listTriangle;
     
@@ -197,6 +221,9 @@ class VISP_EXPORT vpImageSimulator
 
     //boolean to tell if the points in the camera frame have to be clipped
     bool needClipping;
+
+    //number of threads used to fill the image, 0 for vpThreadPool::getNbThreads()
+    unsigned int nbThreads;
     
   public:
     vpImageSimulator(const vpColorPlan &col = COLORED);
@@ -245,6 +272,12 @@ class VISP_EXPORT vpImageSimulator
 
     std::vector<vpColVector> get3DcornersTextureRectangle();
 
+    /*!
+      Return the number of threads used to fill the image, 0 meaning
+      vpThreadPool::getNbThreads().
+    */
+    unsigned int getNbThreads() const {return nbThreads;}
+
     friend VISP_EXPORT std::ostream& operator<< (std::ostream &os, const vpImageSimulator& /*ip*/);
 
     /*!
@@ -270,6 +303,16 @@ class VISP_EXPORT vpImageSimulator
     	setBackgroundTexture = true;
     	Ig = Iback;
     }
+
+    /*!
+      Set the number of threads used by getImage() to fill the rows of the
+      image. The default is 1, 0 uses vpThreadPool::getNbThreads() threads.
+      The static getImage() methods that project a list of images use the
+      number of threads of the first image of the list.
+
+      \param nb_threads : Number of threads, including the calling thread.
+    */
+    void setNbThreads(const unsigned int nb_threads) {nbThreads = nb_threads;}
     
   private:
     void initPlan(vpColVector* X);
@@ -278,15 +321,9 @@ class VISP_EXPORT vpImageSimulator
     //ie: un plan est oriente dans si normal_plan.focal < 0 => plan est visible sinon invisible.
     bool isVisible() {return visible;}
     
-    //function that project a point x,y on the plane, return true if the projection is on the limited plane
-    // and in this case return the corresponding image pixel Ipixelplan
-    bool getPixel(const vpImagePoint &iP,unsigned char &Ipixelplan);
-    bool getPixel(const vpImagePoint &iP,vpRGBa &Ipixelplan);
-    bool getPixel(vpImage<unsigned char> &Isrc, const vpImagePoint &iP,
-		  unsigned char &Ipixelplan);
-    bool getPixel(vpImage<vpRGBa> &Isrc, const vpImagePoint &iP,
-		  vpRGBa &Ipixelplan);
-    bool getPixelDepth(const vpImagePoint &iP, double &Zpixelplan);
+    //projection of the plane in the image of size Iwidth x Iheight, used to fill the image row by row
+    void initPlane(vpImageSimulatorPlane &plane, const unsigned int &Iwidth, const unsigned int &Iheight,
+                   const vpCameraParameters &cam);
     bool getPixelVisibility(const vpImagePoint &iP, double &Zpixelplan);
     
         //operation 3D de base :
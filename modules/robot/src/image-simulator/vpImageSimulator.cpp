@@ -43,11 +43,207 @@
 #include <visp3/core/vpMeterPixelConversion.h>
 #include <visp3/core/vpMatrixException.h>
 #include <visp3/core/vpPolygon3D.h>
+#include <visp3/core/vpThreadPool.h>
+
+#include <algorithm>
+#include <limits>
 
 #ifdef VISP_HAVE_MODULE_IO
 #  include <visp3/io/vpImageIo.h>
 #endif
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+  // Bilinear interpolation of four pixel values with weights in 1/1024
+  inline unsigned char interpolate(const int p00, const int p01, const int p10, const int p11,
+                                   const int wi, const int wj)
+  {
+    int top = p00 * (1024 - wj) + p01 * wj;
+    int bottom = p10 * (1024 - wj) + p11 * wj;
+    return (unsigned char)((top * (1024 - wi) + bottom * wi + (1 << 19)) >> 20);
+  }
+
+  // Texture value at (i2, j2), either the value of the pixel that contains the
+  // point or the bilinear interpolation of its four neighbours with 10 bits
+  // fixed-point weights
+  inline void getTextureValue(const vpImage<unsigned char> &I, const double i2, const double j2,
+                              const bool bilinear, unsigned char &value)
+  {
+    if (!bilinear) {
+      value = I[(unsigned int)i2][(unsigned int)j2];
+      return;
+    }
+    int fi = (int)(i2 * 1024.);
+    int fj = (int)(j2 * 1024.);
+    unsigned int i0 = (unsigned int)(fi >> 10), j0 = (unsigned int)(fj >> 10);
+    unsigned int i1 = (i0 + 1 < I.getHeight()) ? i0 + 1 : i0;
+    unsigned int j1 = (j0 + 1 < I.getWidth()) ? j0 + 1 : j0;
+    int wi = fi & 1023, wj = fj & 1023;
+    const unsigned char *r0 = I[i0], *r1 = I[i1];
+    value = interpolate(r0[j0], r0[j1], r1[j0], r1[j1], wi, wj);
+  }
+
+  inline void getTextureValue(const vpImage<vpRGBa> &I, const double i2, const double j2,
+                              const bool bilinear, vpRGBa &value)
+  {
+    if (!bilinear) {
+      value = I[(unsigned int)i2][(unsigned int)j2];
+      return;
+    }
+    int fi = (int)(i2 * 1024.);
+    int fj = (int)(j2 * 1024.);
+    unsigned int i0 = (unsigned int)(fi >> 10), j0 = (unsigned int)(fj >> 10);
+    unsigned int i1 = (i0 + 1 < I.getHeight()) ? i0 + 1 : i0;
+    unsigned int j1 = (j0 + 1 < I.getWidth()) ? j0 + 1 : j0;
+    int wi = fi & 1023, wj = fj & 1023;
+    const vpRGBa &p00 = I[i0][j0], &p01 = I[i0][j1], &p10 = I[i1][j0], &p11 = I[i1][j1];
+    value = vpRGBa(interpolate(p00.R, p01.R, p10.R, p11.R, wi, wj),
+                   interpolate(p00.G, p01.G, p10.G, p11.G, wi, wj),
+                   interpolate(p00.B, p01.B, p10.B, p11.B, wi, wj));
+  }
+
+  inline void setPixel(const unsigned char &src, unsigned char &dst) { dst = src; }
+
+  inline void setPixel(const vpRGBa &src, unsigned char &dst)
+  {
+    dst = (unsigned char)(0.2126 * src.R + 0.7152 * src.G + 0.0722 * src.B);
+  }
+
+  inline void setPixel(const unsigned char &src, vpRGBa &dst)
+  {
+    vpRGBa color;
+    color.R = src;
+    color.G = src;
+    color.B = src;
+    dst = color;
+  }
+
+  inline void setPixel(const vpRGBa &src, vpRGBa &dst) { dst = src; }
+
+  // Fills the rows [begin, end) of the image with the nearest of the planes
+  // seen by each pixel. Without distortion, u, v and w are affine functions of
+  // the column and are only incremented from one pixel to the next.
+  template<class Type>
+  class vpImageSimulatorRenderer
+  {
+  public:
+    vpImageSimulatorRenderer(vpImage<Type> &I_, const vpImageSimulatorPlane *planes_, const unsigned int nbPlanes_,
+                             const vpCameraParameters &cam_, vpMatrix *zBuffer_,
+                             const unsigned int left_, const unsigned int right_)
+      : I(I_), planes(planes_), nbPlanes(nbPlanes_), cam(cam_), zBuffer(zBuffer_), left(left_), right(right_)
+    {}
+
+    void operator()(unsigned int begin, unsigned int end) const
+    {
+      bool distortion = (cam.get_projModel() == vpCameraParameters::perspectiveProjWithDistortion);
+      // u, v, w of each plane at the current pixel, and their increment along a row
+      std::vector<double> val(3*nbPlanes), step(3*nbPlanes);
+      for (unsigned int k = 0; k < nbPlanes; k++) {
+        step[3*k] = planes[k].u[0] * cam.get_px_inverse();
+        step[3*k+1] = planes[k].v[0] * cam.get_px_inverse();
+        step[3*k+2] = planes[k].w[0] * cam.get_px_inverse();
+      }
+
+      for (unsigned int i = begin; i < end; i++) {
+        Type *dst = I[i];
+        double *depth = (zBuffer != NULL) ? (*zBuffer)[i] : NULL;
+        double x = 0, y = 0;
+        if (!distortion) {
+          vpPixelMeterConversion::convertPoint(cam, (double)left, (double)i, x, y);
+          evaluate(x, y, val);
+        }
+
+        for (unsigned int j = left; j < right; j++) {
+          if (distortion) {
+            vpPixelMeterConversion::convertPoint(cam, (double)j, (double)i, x, y);
+            evaluate(x, y, val);
+          }
+
+          int nearest = -1;
+          double zmin = 0;
+          for (unsigned int k = 0; k < nbPlanes; k++) {
+            const double *uvw = &val[3*k];
+            if (uvw[2] > 0 && uvw[2] <= planes[k].wmax
+                && uvw[0] > 0 && uvw[0] < uvw[2] && uvw[1] > 0 && uvw[1] < uvw[2]) {
+              double z = planes[k].distance / uvw[2];
+              if (nearest < 0 || z < zmin) {
+                zmin = z;
+                nearest = (int)k;
+              }
+            }
+          }
+
+          if (nearest >= 0 && (depth == NULL || zmin < depth[j] || depth[j] < 0)) {
+            const vpImageSimulatorPlane &plane = planes[nearest];
+            const double *uvw = &val[3*nearest];
+            double inv_w = 1. / uvw[2];
+            if (plane.Ig != NULL) {
+              unsigned char value;
+              getTextureValue(*plane.Ig, uvw[1] * inv_w * (plane.Ig->getHeight()-1),
+                              uvw[0] * inv_w * (plane.Ig->getWidth()-1), plane.bilinear, value);
+              setPixel(value, dst[j]);
+            }
+            else {
+              vpRGBa value;
+              getTextureValue(*plane.Ic, uvw[1] * inv_w * (plane.Ic->getHeight()-1),
+                              uvw[0] * inv_w * (plane.Ic->getWidth()-1), plane.bilinear, value);
+              setPixel(value, dst[j]);
+            }
+            if (depth != NULL)
+              depth[j] = zmin;
+          }
+
+          if (!distortion) {
+            for (unsigned int k = 0; k < 3*nbPlanes; k++)
+              val[k] += step[k];
+          }
+        }
+      }
+    }
+
+  private:
+    void evaluate(const double x, const double y, std::vector<double> &val) const
+    {
+      for (unsigned int k = 0; k < nbPlanes; k++) {
+        const vpImageSimulatorPlane &plane = planes[k];
+        val[3*k] = plane.u[0] * x + plane.u[1] * y + plane.u[2];
+        val[3*k+1] = plane.v[0] * x + plane.v[1] * y + plane.v[2];
+        val[3*k+2] = plane.w[0] * x + plane.w[1] * y + plane.w[2];
+      }
+    }
+
+    vpImage<Type> &I;
+    const vpImageSimulatorPlane *planes;
+    unsigned int nbPlanes;
+    const vpCameraParameters &cam;
+    vpMatrix *zBuffer;
+    unsigned int left;
+    unsigned int right;
+  };
+
+  // Fills the union of the regions of the planes, row bands in parallel
+  template<class Type>
+  void fillImage(vpImage<Type> &I, const vpImageSimulatorPlane *planes, const unsigned int nbPlanes,
+                 const vpCameraParameters &cam, vpMatrix *zBuffer, const unsigned int nbThreads)
+  {
+    unsigned int top = planes[0].top, bottom = planes[0].bottom;
+    unsigned int left = planes[0].left, right = planes[0].right;
+    for (unsigned int k = 1; k < nbPlanes; k++) {
+      top = std::min(top, planes[k].top);
+      bottom = std::max(bottom, planes[k].bottom);
+      left = std::min(left, planes[k].left);
+      right = std::max(right, planes[k].right);
+    }
+    if (top >= bottom || left >= right)
+      return;
+
+    vpImageSimulatorRenderer<Type> renderer(I, planes, nbPlanes, cam, zBuffer, left, right);
+    vpThreadPool::parallel_for(top, bottom, renderer, nbThreads, 4);
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Basic constructor.
   
@@ -61,9 +257,9 @@ vpImageSimulator::vpImageSimulator(const vpColorPlan &col)
   : cMt(), pt(), ptClipped(), interp(SIMPLE), normal_obj(), normal_Cam(), normal_Cam_optim(),
     distance(1.), visible_result(1.), visible(false), X0_2_optim(NULL),
     euclideanNorm_u(0.), euclideanNorm_v(0.), vbase_u(), vbase_v(),
-    vbase_u_optim(NULL), vbase_v_optim(NULL), Xinter_optim(NULL), listTriangle(),
+    vbase_u_optim(NULL), vbase_v_optim(NULL), listTriangle(),
     colorI(col), Ig(), Ic(), rect(), cleanPrevImage(false),
-    setBackgroundTexture(false), bgColor(vpColor::white), focal(), needClipping(false)
+    setBackgroundTexture(false), bgColor(vpColor::white), focal(), needClipping(false), nbThreads(1)
 {
   for(int i=0;i<4;i++)
     X[i].resize(3);
@@ -88,7 +284,6 @@ vpImageSimulator::vpImageSimulator(const vpColorPlan &col)
   X0_2_optim = new double[3];
   vbase_u_optim = new double[3];
   vbase_v_optim = new double[3];
-  Xinter_optim = new double[3];
 
   pt.resize(4);
 }
@@ -101,9 +296,9 @@ vpImageSimulator::vpImageSimulator(const vpImageSimulator &text)
   : cMt(), pt(), ptClipped(), interp(SIMPLE), normal_obj(), normal_Cam(), normal_Cam_optim(),
     distance(1.), visible_result(1.), visible(false), X0_2_optim(NULL),
     euclideanNorm_u(0.), euclideanNorm_v(0.), vbase_u(), vbase_v(),
-    vbase_u_optim(NULL), vbase_v_optim(NULL), Xinter_optim(NULL), listTriangle(),
+    vbase_u_optim(NULL), vbase_v_optim(NULL), listTriangle(),
     colorI(GRAY_SCALED), Ig(), Ic(), rect(), cleanPrevImage(false),
-    setBackgroundTexture(false), bgColor(vpColor::white), focal(), needClipping(false)
+    setBackgroundTexture(false), bgColor(vpColor::white), focal(), needClipping(false), nbThreads(1)
 {
   pt.resize(4);
   for(unsigned int i=0;i<4;i++)
@@ -135,13 +330,13 @@ vpImageSimulator::vpImageSimulator(const vpImageSimulator &text)
   X0_2_optim = new double[3];
   vbase_u_optim = new double[3];
   vbase_v_optim = new double[3];
-  Xinter_optim = new double[3];
   
   colorI = text.colorI;
   interp = text.interp;
   bgColor = text.bgColor;
   cleanPrevImage = text.cleanPrevImage;
   setBackgroundTexture = false;
+  nbThreads = text.nbThreads;
   
   setCameraPosition(text.cMt);
 }
@@ -155,7 +350,6 @@ vpImageSimulator::~vpImageSimulator()
   delete[] X0_2_optim;
   delete[] vbase_u_optim;
   delete[] vbase_v_optim;
-  delete[] Xinter_optim;
 }
 
 
@@ -182,6 +376,7 @@ vpImageSimulator::operator=(const vpImageSimulator& sim)
   
   colorI = sim.colorI;
   interp = sim.interp;
+  nbThreads = sim.nbThreads;
   
   setCameraPosition(sim.cMt);
   
@@ -218,50 +413,9 @@ vpImageSimulator::getImage(vpImage<unsigned char> &I,
 
   if(visible)
   {
-    if(!needClipping)
-      getRoi(I.getWidth(),I.getHeight(),cam,pt,rect);
-    else
-      getRoi(I.getWidth(),I.getHeight(),cam,ptClipped,rect);
-    
-    double top = rect.getTop();
-    double bottom = rect.getBottom();
-    double left = rect.getLeft();
-    double right= rect.getRight();
-    
-    unsigned char *bitmap = I.bitmap;
-    unsigned int width = I.getWidth();
-    vpImagePoint ip;
-    int nb_point_dessine = 0;
-
-    for (unsigned int i = (unsigned int)top; i < (unsigned int)bottom; i++)
-    {
-      for (unsigned int j = (unsigned int)left; j < (unsigned int)right; j++)
-      {
-        double x=0,y=0;
-        ip.set_ij(i,j);
-        vpPixelMeterConversion::convertPoint(cam,ip, x,y);
-        ip.set_ij(y,x);
-        if (colorI == GRAY_SCALED)
-        {
-          unsigned char Ipixelplan = 0;
-          if(getPixel(ip,Ipixelplan))
-          {
-            *(bitmap+i*width+j)=Ipixelplan;
-            nb_point_dessine++;
-          }
-        }
-        else if (colorI == COLORED)
-        {
-          vpRGBa Ipixelplan;
-          if(getPixel(ip,Ipixelplan))
-          {
-            unsigned char pixelgrey = (unsigned char)(0.2126 * Ipixelplan.R + 0.7152 * Ipixelplan.G + 0.0722 * Ipixelplan.B);
-            *(bitmap+i*width+j)=pixelgrey;
-            nb_point_dessine++;
-          }
-        }
-      }
-    }
+    vpImageSimulatorPlane plane;
+    initPlane(plane, I.getWidth(), I.getHeight(), cam);
+    fillImage(I, &plane, 1, cam, NULL, nbThreads);
   }
 }
 
@@ -291,37 +445,11 @@ vpImageSimulator::getImage(vpImage<unsigned char> &I,
   }
   if(visible)
   {
-    if(!needClipping)
-      getRoi(I.getWidth(),I.getHeight(),cam,pt,rect);
-    else
-      getRoi(I.getWidth(),I.getHeight(),cam,ptClipped,rect);
-
-    double top = rect.getTop();
-    double bottom = rect.getBottom();
-    double left = rect.getLeft();
-    double right= rect.getRight();
-
-    unsigned char *bitmap = I.bitmap;
-    unsigned int width = I.getWidth();
-    vpImagePoint ip;
-    int nb_point_dessine = 0;
-
-    for (unsigned int i = (unsigned int)top; i < (unsigned int)bottom; i++)
-    {
-      for (unsigned int j = (unsigned int)left; j < (unsigned int)right; j++)
-      {
-        double x=0,y=0;
-        ip.set_ij(i,j);
-        vpPixelMeterConversion::convertPoint(cam,ip, x,y);
-        ip.set_ij(y,x);
-        unsigned char Ipixelplan = 0;
-        if(getPixel(Isrc,ip,Ipixelplan))
-        {
-          *(bitmap+i*width+j)=Ipixelplan;
-          nb_point_dessine++;
-        }
-      }
-    }
+    vpImageSimulatorPlane plane;
+    initPlane(plane, I.getWidth(), I.getHeight(), cam);
+    plane.Ig = &Isrc;
+    plane.Ic = NULL;
+    fillImage(I, &plane, 1, cam, NULL, nbThreads);
   }
 }
 
@@ -354,58 +482,9 @@ vpImageSimulator::getImage(vpImage<unsigned char> &I,
   }
   if(visible)
   {
-    if(!needClipping)
-      getRoi(I.getWidth(),I.getHeight(),cam,pt,rect);
-    else
-      getRoi(I.getWidth(),I.getHeight(),cam,ptClipped,rect);
-    
-    double top = rect.getTop();
-    double bottom = rect.getBottom();
-    double left = rect.getLeft();
-    double right= rect.getRight();
-    
-    unsigned char *bitmap = I.bitmap;
-    unsigned int width = I.getWidth();
-    vpImagePoint ip;
-    int nb_point_dessine = 0;
-
-    for (unsigned int i = (unsigned int)top; i < (unsigned int)bottom; i++)
-    {
-      for (unsigned int j = (unsigned int)left; j < (unsigned int)right; j++)
-      {
-        double x=0,y=0;
-        ip.set_ij(i,j);
-        vpPixelMeterConversion::convertPoint(cam,ip, x,y);
-        ip.set_ij(y,x);
-        if (colorI == GRAY_SCALED)
-        {
-          unsigned char Ipixelplan;
-          if(getPixel(ip,Ipixelplan))
-          {
-            if (Xinter_optim[2] < zBuffer[i][j] || zBuffer[i][j] < 0)
-            {
-              *(bitmap+i*width+j)=Ipixelplan;
-              nb_point_dessine++;
-              zBuffer[i][j] = Xinter_optim[2];
-            }
-          }
-        }
-        else if (colorI == COLORED)
-        {
-          vpRGBa Ipixelplan;
-          if(getPixel(ip,Ipixelplan))
-          {
-            if (Xinter_optim[2] < zBuffer[i][j] || zBuffer[i][j] < 0)
-            {
-              unsigned char pixelgrey = (unsigned char)(0.2126 * Ipixelplan.R + 0.7152 * Ipixelplan.G + 0.0722 * Ipixelplan.B);
-              *(bitmap+i*width+j)=pixelgrey;
-              nb_point_dessine++;
-              zBuffer[i][j] = Xinter_optim[2];
-            }
-          }
-        }
-      }
-    }
+    vpImageSimulatorPlane plane;
+    initPlane(plane, I.getWidth(), I.getHeight(), cam);
+    fillImage(I, &plane, 1, cam, &zBuffer, nbThreads);
   }
 }
 
@@ -431,53 +510,9 @@ vpImageSimulator::getImage(vpImage<vpRGBa> &I, const vpCameraParameters &cam)
   
   if(visible)
   {
-    if(!needClipping)
-      getRoi(I.getWidth(),I.getHeight(),cam,pt,rect);
-    else
-      getRoi(I.getWidth(),I.getHeight(),cam,ptClipped,rect);
-    
-    double top = rect.getTop();
-    double bottom = rect.getBottom();
-    double left = rect.getLeft();
-    double right= rect.getRight();
-    
-    vpRGBa *bitmap = I.bitmap;
-    unsigned int width = I.getWidth();
-    vpImagePoint ip;
-    int nb_point_dessine = 0;
-
-    for (unsigned int i = (unsigned int)top; i < (unsigned int)bottom; i++)
-    {
-      for (unsigned int j = (unsigned int)left; j < (unsigned int)right; j++)
-      {
-        double x=0,y=0;
-        ip.set_ij(i,j);
-        vpPixelMeterConversion::convertPoint(cam,ip, x,y);
-        ip.set_ij(y,x);
-        if (colorI == GRAY_SCALED)
-        {
-          unsigned char Ipixelplan;
-          if(getPixel(ip,Ipixelplan))
-          {
-            vpRGBa pixelcolor;
-            pixelcolor.R = Ipixelplan;
-            pixelcolor.G = Ipixelplan;
-            pixelcolor.B = Ipixelplan;
-            *(bitmap+i*width+j) = pixelcolor;
-            nb_point_dessine++;
-          }
-        }
-        else if (colorI == COLORED)
-        {
-          vpRGBa Ipixelplan;
-          if(getPixel(ip,Ipixelplan))
-          {
-            *(bitmap+i*width+j) = Ipixelplan;
-            nb_point_dessine++;
-          }
-        }
-      }
-    }
+    vpImageSimulatorPlane plane;
+    initPlane(plane, I.getWidth(), I.getHeight(), cam);
+    fillImage(I, &plane, 1, cam, NULL, nbThreads);
   }
 }
 
@@ -506,37 +541,11 @@ vpImageSimulator::getImage(vpImage<vpRGBa> &I, vpImage<vpRGBa> &Isrc,
   
   if(visible)
   {
-    if(!needClipping)
-      getRoi(I.getWidth(),I.getHeight(),cam,pt,rect);
-    else
-      getRoi(I.getWidth(),I.getHeight(),cam,ptClipped,rect);
-    
-    double top = rect.getTop();
-    double bottom = rect.getBottom();
-    double left = rect.getLeft();
-    double right= rect.getRight();
-    
-    vpRGBa *bitmap = I.bitmap;
-    unsigned int width = I.getWidth();
-    vpImagePoint ip;
-    int nb_point_dessine = 0;
-
-    for (unsigned int i = (unsigned int)top; i < (unsigned int)bottom; i++)
-    {
-      for (unsigned int j = (unsigned int)left; j < (unsigned int)right; j++)
-      {
-        double x=0,y=0;
-        ip.set_ij(i,j);
-        vpPixelMeterConversion::convertPoint(cam,ip, x,y);
-        ip.set_ij(y,x);
-        vpRGBa Ipixelplan;
-        if(getPixel(Isrc,ip,Ipixelplan))
-        {
-          *(bitmap+i*width+j) = Ipixelplan;
-          nb_point_dessine++;
-        }
-      }
-    }
+    vpImageSimulatorPlane plane;
+    initPlane(plane, I.getWidth(), I.getHeight(), cam);
+    plane.Ig = NULL;
+    plane.Ic = &Isrc;
+    fillImage(I, &plane, 1, cam, NULL, nbThreads);
   }
 }
 
@@ -568,61 +577,9 @@ vpImageSimulator::getImage(vpImage<vpRGBa> &I, const vpCameraParameters &cam,
   }
   if(visible)
   {
-    if(!needClipping)
-      getRoi(I.getWidth(),I.getHeight(),cam,pt,rect);
-    else
-      getRoi(I.getWidth(),I.getHeight(),cam,ptClipped,rect);
-    
-    double top = rect.getTop();
-    double bottom = rect.getBottom();
-    double left = rect.getLeft();
-    double right= rect.getRight();
-    
-    vpRGBa *bitmap = I.bitmap;
-    unsigned int width = I.getWidth();
-    vpImagePoint ip;
-    int nb_point_dessine = 0;
-
-    for (unsigned int i = (unsigned int)top; i < (unsigned int)bottom; i++)
-    {
-      for (unsigned int j = (unsigned int)left; j < (unsigned int)right; j++)
-      {
-        double x=0,y=0;
-        ip.set_ij(i,j);
-        vpPixelMeterConversion::convertPoint(cam,ip, x,y);
-        ip.set_ij(y,x);
-        if (colorI == GRAY_SCALED)
-        {
-          unsigned char Ipixelplan;
-          if(getPixel(ip,Ipixelplan))
-          {
-            if (Xinter_optim[2] < zBuffer[i][j] || zBuffer[i][j] < 0)
-            {
-              vpRGBa pixelcolor;
-              pixelcolor.R = Ipixelplan;
-              pixelcolor.G = Ipixelplan;
-              pixelcolor.B = Ipixelplan;
-              *(bitmap+i*width+j) = pixelcolor;
-              nb_point_dessine++;
-              zBuffer[i][j] = Xinter_optim[2];
-            }
-          }
-        }
-        else if (colorI == COLORED)
-        {
-          vpRGBa Ipixelplan;
-          if(getPixel(ip,Ipixelplan))
-          {
-            if (Xinter_optim[2] < zBuffer[i][j] || zBuffer[i][j] < 0)
-            {
-              *(bitmap+i*width+j) = Ipixelplan;
-              nb_point_dessine++;
-              zBuffer[i][j] = Xinter_optim[2];
-            }
-          }
-        }
-      }
-    }
+    vpImageSimulatorPlane plane;
+    initPlane(plane, I.getWidth(), I.getHeight(), cam);
+    fillImage(I, &plane, 1, cam, &zBuffer, nbThreads);
   }
 }
 
@@ -723,7 +680,8 @@ vpImageSimulator::getImage(vpImage<vpRGBa> &I, const vpCameraParameters &cam,
   \endcode
 
   \param I : The image used to store the result
-  \param list : List of vpImageSimulator to project
+  \param list : List of vpImageSimulator to project. The image is filled with
+  the number of threads of the first vpImageSimulator of the list, see setNbThreads().
   \param cam : The parameters of the virtual camera
 */
 void
@@ -731,99 +689,19 @@ vpImageSimulator::getImage(vpImage<unsigned char> &I,
                            std::list<vpImageSimulator> &list,
                            const vpCameraParameters &cam)
 {
-
-  unsigned int width = I.getWidth();
-  unsigned int height = I.getHeight();
-
-  unsigned int nbsimList = (unsigned int)list.size();
-
-  if (nbsimList < 1)
-    return;
-
-  vpImageSimulator** simList = new vpImageSimulator* [nbsimList];
-
-  double topFinal = height+1;;
-  double bottomFinal = -1;
-  double leftFinal = width+1;
-  double rightFinal = -1;
-
-  unsigned int unvisible = 0;
-  unsigned int indexSimu=0;
-  for(std::list<vpImageSimulator>::iterator it=list.begin(); it!=list.end(); ++it, ++indexSimu){
-    vpImageSimulator* sim = &(*it);
-    if (sim->visible)
-      simList[indexSimu] = sim;
-    else
-      unvisible++;
-  }
-  nbsimList = nbsimList - unvisible;
-
-   if (nbsimList < 1)
-   {
-     delete[] simList;
-     return;
-   }
-
-
-  for (unsigned int i = 0; i < nbsimList; i++)
-  {
-    if(!simList[i]->needClipping)
-        simList[i]->getRoi(width,height,cam,simList[i]->pt,simList[i]->rect);
-    else
-        simList[i]->getRoi(width,height,cam,simList[i]->ptClipped,simList[i]->rect);
-
-    if (topFinal > simList[i]->rect.getTop()) topFinal = simList[i]->rect.getTop();
-    if (bottomFinal < simList[i]->rect.getBottom()) bottomFinal = simList[i]->rect.getBottom();
-    if (leftFinal > simList[i]->rect.getLeft()) leftFinal = simList[i]->rect.getLeft();
-    if (rightFinal < simList[i]->rect.getRight()) rightFinal = simList[i]->rect.getRight();
-  }
-
-  double zmin = -1;
-  int indice = -1;
-  unsigned char *bitmap = I.bitmap;
-  vpImagePoint ip;
-
-  for (unsigned int i = (unsigned int)topFinal; i < (unsigned int)bottomFinal; i++)
-  {
-    for (unsigned int j = (unsigned int)leftFinal; j < (unsigned int)rightFinal; j++)
-    {
-      zmin = -1;
-      double x=0,y=0;
-      ip.set_ij(i,j);
-      vpPixelMeterConversion::convertPoint(cam,ip, x,y);
-      ip.set_ij(y,x);
-      for (int k = 0; k < (int)nbsimList; k++)
-      {
-  double z = 0;
-  if(simList[k]->getPixelDepth(ip,z))
-  {
-    if (z < zmin || zmin < 0)
+  std::vector<vpImageSimulatorPlane> planes;
+  for(std::list<vpImageSimulator>::iterator it=list.begin(); it!=list.end(); ++it){
+    if (it->visible)
     {
-      zmin = z;
-      indice = k;
-    }
-  }
-      }
-      if (indice >= 0)
-      {
-        if (simList[indice]->colorI == GRAY_SCALED)
-        {
-    unsigned char Ipixelplan = 255;
-          simList[indice]->getPixel(ip,Ipixelplan);
-    *(bitmap+i*width+j)=Ipixelplan;
-        }
-        else if (simList[indice]->colorI == COLORED)
-        {
-    vpRGBa Ipixelplan(255,255,255);
-    simList[indice]->getPixel(ip,Ipixelplan);
-    unsigned char pixelgrey = (unsigned char)(0.2126 * Ipixelplan.R + 0.7152 * Ipixelplan.G + 0.0722 * Ipixelplan.B);
-    *(bitmap+i*width+j)=pixelgrey;
-        }
-      }
+      planes.push_back(vpImageSimulatorPlane());
+      it->initPlane(planes.back(), I.getWidth(), I.getHeight(), cam);
     }
   }
 
-  delete[] simList;
+  if (planes.empty())
+    return;
+
+  fillImage(I, &planes[0], (unsigned int)planes.size(), cam, NULL, list.front().nbThreads);
 }
 
 
@@ -925,7 +803,8 @@ vpImageSimulator::getImage(vpImage<unsigned char> &I,
   \endcode
 
   \param I : The image used to store the result
-  \param list : List of vpImageSimulator to project
+  \param list : List of vpImageSimulator to project. The image is filled with
+  the number of threads of the first vpImageSimulator of the list, see setNbThreads().
   \param cam : The parameters of the virtual camera
 */
 void
@@ -933,103 +812,19 @@ vpImageSimulator::getImage(vpImage<vpRGBa> &I,
                            std::list<vpImageSimulator> &list,
                            const vpCameraParameters &cam)
 {
-
-  unsigned int width = I.getWidth();
-  unsigned int height = I.getHeight();
-
-  unsigned int nbsimList = (unsigned int)list.size();
-
-  if (nbsimList < 1)
-    return;
-
-  vpImageSimulator** simList = new vpImageSimulator* [nbsimList];
-
-  double topFinal = height+1;;
-  double bottomFinal = -1;
-  double leftFinal = width+1;
-  double rightFinal = -1;
-
-  unsigned int unvisible = 0;
-  unsigned int indexSimu = 0;
-  for(std::list<vpImageSimulator>::iterator it=list.begin(); it!=list.end(); ++it, ++indexSimu){
-    vpImageSimulator* sim = &(*it);
-    if (sim->visible)
-      simList[indexSimu] = sim;
-    else
-      unvisible++;
-  }
-
-  nbsimList = nbsimList - unvisible;
-
-   if (nbsimList < 1)
-   {
-     delete[] simList;
-     return;
-   }
-
-  for (unsigned int i = 0; i < nbsimList; i++)
-  {
-    if(!simList[i]->needClipping)
-        simList[i]->getRoi(width,height,cam,simList[i]->pt,simList[i]->rect);
-    else
-        simList[i]->getRoi(width,height,cam,simList[i]->ptClipped,simList[i]->rect);
-
-    if (topFinal > simList[i]->rect.getTop()) topFinal = simList[i]->rect.getTop();
-    if (bottomFinal < simList[i]->rect.getBottom()) bottomFinal = simList[i]->rect.getBottom();
-    if (leftFinal > simList[i]->rect.getLeft()) leftFinal = simList[i]->rect.getLeft();
-    if (rightFinal < simList[i]->rect.getRight()) rightFinal = simList[i]->rect.getRight();
-  }
-
-  double zmin = -1;
-  int indice = -1;
-  vpRGBa *bitmap = I.bitmap;
-  vpImagePoint ip;
-
-  for (unsigned int i = (unsigned int)topFinal; i < (unsigned int)bottomFinal; i++)
-  {
-    for (unsigned int j = (unsigned int)leftFinal; j < (unsigned int)rightFinal; j++)
+  std::vector<vpImageSimulatorPlane> planes;
+  for(std::list<vpImageSimulator>::iterator it=list.begin(); it!=list.end(); ++it){
+    if (it->visible)
     {
-      zmin = -1;
-      double x=0,y=0;
-      ip.set_ij(i,j);
-      vpPixelMeterConversion::convertPoint(cam,ip, x,y);
-      ip.set_ij(y,x);
-      for (int k = 0; k < (int)nbsimList; k++)
-      {
-  double z = 0;
-  if(simList[k]->getPixelDepth(ip,z))
-  {
-    if (z < zmin || zmin < 0)
-    {
-      zmin = z;
-      indice = k;
-    }
-  }
-      }
-      if (indice >= 0)
-      {
-        if (simList[indice]->colorI == GRAY_SCALED)
-        {
-    unsigned char Ipixelplan = 255;
-          simList[indice]->getPixel(ip,Ipixelplan);
-    vpRGBa pixelcolor;
-    pixelcolor.R = Ipixelplan;
-    pixelcolor.G = Ipixelplan;
-    pixelcolor.B = Ipixelplan;
-    *(bitmap+i*width+j) = pixelcolor;
-        }
-        else if (simList[indice]->colorI == COLORED)
-        {
-    vpRGBa Ipixelplan(255,255,255);
-    simList[indice]->getPixel(ip,Ipixelplan);
-    //unsigned char pixelgrey = 0.2126 * Ipixelplan.R + 0.7152 * Ipixelplan.G + 0.0722 * Ipixelplan.B;
-    *(bitmap+i*width+j)=Ipixelplan;
-        }
-      }
+      planes.push_back(vpImageSimulatorPlane());
+      it->initPlane(planes.back(), I.getWidth(), I.getHeight(), cam);
     }
   }
 
-  delete[] simList;
+  if (planes.empty())
+    return;
+
+  fillImage(I, &planes[0], (unsigned int)planes.size(), cam, NULL, list.front().nbThreads);
 }
 
 /*!
@@ -1310,245 +1105,47 @@ vpImageSimulator::init(const char* file_image, const std::vector<vpPoint>& X_)
 }
 #endif
 
-bool
-vpImageSimulator::getPixel(const vpImagePoint &iP, unsigned char &Ipixelplan)
-{
-//  std::cout << "In get Pixel" << std::endl;
-  //test si pixel dans zone projetee
-  bool inside = false;
-  for(unsigned int i = 0 ; i < listTriangle.size() ; i++)
-      if(listTriangle[i].inTriangle(iP)){
-          inside = true;
-          break;
-      }
-  if(!inside) return false;
-
-//  if(!T1.inTriangle(iP) && !T2.inTriangle(iP)){
-////      std::cout << "The pixel is inside the projected area" << std::endl;
-//    return false;}
-
-  //methoed algebrique
-  double z;
-
-  //calcul de la profondeur de l'intersection
-  z = distance/(normal_Cam_optim[0]*iP.get_u()+normal_Cam_optim[1]*iP.get_v()+normal_Cam_optim[2]);
-  //calcul coordonnees 3D intersection
-  Xinter_optim[0]=iP.get_u()*z;
-  Xinter_optim[1]=iP.get_v()*z;
-  Xinter_optim[2]=z;
-
-  //recuperation des coordonnes de l'intersection dans le plan objet
-  //repere plan object : 
-  //	centre = X0_2_optim[i] (premier point definissant le plan)
-  //	base =  u:(X[1]-X[0]) et v:(X[3]-X[0])
-  //ici j'ai considere que le plan est un rectangle => coordonnees sont simplement obtenu par un produit scalaire
-  double u = 0, v = 0;
-  for(unsigned int i = 0; i < 3; i++)
-  {
-    double diff = (Xinter_optim[i]-X0_2_optim[i]);
-    u += diff*vbase_u_optim[i];
-    v += diff*vbase_v_optim[i];
-  }
-  u = u/(euclideanNorm_u*euclideanNorm_u);
-  v = v/(euclideanNorm_v*euclideanNorm_v);
-
-  if( u > 0 && v > 0 && u < 1. && v < 1.)
-  {
-    double i2,j2;
-    i2=v*(Ig.getHeight()-1);
-    j2=u*(Ig.getWidth()-1);
-    if (interp == BILINEAR_INTERPOLATION)
-      Ipixelplan = Ig.getValue(i2,j2);
-    else if (interp == SIMPLE)
-      Ipixelplan = Ig[(unsigned int)i2][(unsigned int)j2];
-    return true;
-  }
-  else
-    return false;
-}
-
-bool
-vpImageSimulator::getPixel(vpImage<unsigned char> &Isrc, 
-			   const vpImagePoint &iP, unsigned char &Ipixelplan)
+void
+vpImageSimulator::initPlane(vpImageSimulatorPlane &plane, const unsigned int &Iwidth,
+                            const unsigned int &Iheight, const vpCameraParameters &cam)
 {
-  //test si pixel dans zone projetee
-  bool inside = false;
-  for(unsigned int i = 0 ; i < listTriangle.size() ; i++)
-      if(listTriangle[i].inTriangle(iP)){
-          inside = true;
-          break;
-      }
-  if(!inside) return false;
-
-//  if(!T1.inTriangle(iP) && !T2.inTriangle(iP))
-//    return false;
-
-  //methoed algebrique
-  double z;
-
-  //calcul de la profondeur de l'intersection
-  z = distance/(normal_Cam_optim[0]*iP.get_u()+normal_Cam_optim[1]*iP.get_v()+normal_Cam_optim[2]);
-  //calcul coordonnees 3D intersection
-  Xinter_optim[0]=iP.get_u()*z;
-  Xinter_optim[1]=iP.get_v()*z;
-  Xinter_optim[2]=z;
-
-  //recuperation des coordonnes de l'intersection dans le plan objet
-  //repere plan object : 
-  //	centre = X0_2_optim[i] (premier point definissant le plan)
-  //	base =  u:(X[1]-X[0]) et v:(X[3]-X[0])
-  //ici j'ai considere que le plan est un rectangle => coordonnees sont simplement obtenu par un produit scalaire
-  double u = 0, v = 0;
-  for(unsigned int i = 0; i < 3; i++)
-  {
-    double diff = (Xinter_optim[i]-X0_2_optim[i]);
-    u += diff*vbase_u_optim[i];
-    v += diff*vbase_v_optim[i];
-  }
-  u = u/(euclideanNorm_u*euclideanNorm_u);
-  v = v/(euclideanNorm_v*euclideanNorm_v);
-
-  if( u > 0 && v > 0 && u < 1. && v < 1.)
-  {
-    double i2,j2;
-    i2=v*(Isrc.getHeight()-1);
-    j2=u*(Isrc.getWidth()-1);
-    if (interp == BILINEAR_INTERPOLATION)
-      Ipixelplan = Isrc.getValue(i2,j2);
-    else if (interp == SIMPLE)
-      Ipixelplan = Isrc[(unsigned int)i2][(unsigned int)j2];
-    return true;
-  }
+  if(!needClipping)
+    getRoi(Iwidth,Iheight,cam,pt,rect);
   else
-    return false;
-}
+    getRoi(Iwidth,Iheight,cam,ptClipped,rect);
 
+  plane.top = (unsigned int)rect.getTop();
+  plane.bottom = (unsigned int)rect.getBottom();
+  plane.left = (unsigned int)rect.getLeft();
+  plane.right = (unsigned int)rect.getRight();
 
-bool
-vpImageSimulator::getPixel(const vpImagePoint &iP, vpRGBa &Ipixelplan)
-{
-  //test si pixel dans zone projetee
-  bool inside = false;
-  for(unsigned int i = 0 ; i < listTriangle.size() ; i++)
-      if(listTriangle[i].inTriangle(iP)){
-          inside = true;
-          break;
-      }
-  if(!inside) return false;
-//  if(!T1.inTriangle(iP) && !T2.inTriangle(iP))
-//    return false;
-
-  //methoed algebrique
-  double z;
-
-  //calcul de la profondeur de l'intersection
-  z = distance/(normal_Cam_optim[0]*iP.get_u()+normal_Cam_optim[1]*iP.get_v()+normal_Cam_optim[2]);
-  //calcul coordonnees 3D intersection
-  Xinter_optim[0]=iP.get_u()*z;
-  Xinter_optim[1]=iP.get_v()*z;
-  Xinter_optim[2]=z;
-
-  //recuperation des coordonnes de l'intersection dans le plan objet
-  //repere plan object : 
-  //	centre = X0_2_optim[i] (premier point definissant le plan)
-  //	base =  u:(X[1]-X[0]) et v:(X[3]-X[0])
-  //ici j'ai considere que le plan est un rectangle => coordonnees sont simplement obtenu par un produit scalaire
-  double u = 0, v = 0;
+  //The point of the plane seen in (x,y) is X = z*(x,y,1) with z = distance/w and w = normal.(x,y,1).
+  //Its coordinates in the plane, (X-X0).vbase_u/|vbase_u|^2 and (X-X0).vbase_v/|vbase_v|^2, are then
+  //u/w and v/w with u and v linear in (x,y,1)
+  double X0_u = 0, X0_v = 0;
   for(unsigned int i = 0; i < 3; i++)
   {
-    double diff = (Xinter_optim[i]-X0_2_optim[i]);
-    u += diff*vbase_u_optim[i];
-    v += diff*vbase_v_optim[i];
+    X0_u += X0_2_optim[i]*vbase_u_optim[i];
+    X0_v += X0_2_optim[i]*vbase_v_optim[i];
   }
-  u = u/(euclideanNorm_u*euclideanNorm_u);
-  v = v/(euclideanNorm_v*euclideanNorm_v);
-
-  if( u > 0 && v > 0 && u < 1. && v < 1.)
-  {
-    double i2,j2;
-    i2=v*(Ic.getHeight()-1);
-    j2=u*(Ic.getWidth()-1);
-    if (interp == BILINEAR_INTERPOLATION)
-      Ipixelplan = Ic.getValue(i2,j2);
-    else if (interp == SIMPLE)
-      Ipixelplan = Ic[(unsigned int)i2][(unsigned int)j2];
-    return true;
-  }
-  else
-    return false;
-}
-
-bool
-vpImageSimulator::getPixel(vpImage<vpRGBa> &Isrc, const vpImagePoint &iP,
-			   vpRGBa &Ipixelplan)
-{
-  //test si pixel dans zone projetee
-//  if(!T1.inTriangle(iP) && !T2.inTriangle(iP))
-//    return false;
-  bool inside = false;
-  for(unsigned int i = 0 ; i < listTriangle.size() ; i++)
-      if(listTriangle[i].inTriangle(iP)){
-          inside = true;
-          break;
-      }
-  if(!inside) return false;
-
-  //methoed algebrique
-  double z;
-
-  //calcul de la profondeur de l'intersection
-  z = distance/(normal_Cam_optim[0]*iP.get_u()+normal_Cam_optim[1]*iP.get_v()+normal_Cam_optim[2]);
-  //calcul coordonnees 3D intersection
-  Xinter_optim[0]=iP.get_u()*z;
-  Xinter_optim[1]=iP.get_v()*z;
-  Xinter_optim[2]=z;
-
-  //recuperation des coordonnes de l'intersection dans le plan objet
-  //repere plan object : 
-  //	centre = X0_2_optim[i] (premier point definissant le plan)
-  //	base =  u:(X[1]-X[0]) et v:(X[3]-X[0])
-  //ici j'ai considere que le plan est un rectangle => coordonnees sont simplement obtenu par un produit scalaire
-  double u = 0, v = 0;
+  double norm2_u = euclideanNorm_u*euclideanNorm_u;
+  double norm2_v = euclideanNorm_v*euclideanNorm_v;
   for(unsigned int i = 0; i < 3; i++)
   {
-    double diff = (Xinter_optim[i]-X0_2_optim[i]);
-    u += diff*vbase_u_optim[i];
-    v += diff*vbase_v_optim[i];
-  }
-  u = u/(euclideanNorm_u*euclideanNorm_u);
-  v = v/(euclideanNorm_v*euclideanNorm_v);
-
-  if( u > 0 && v > 0 && u < 1. && v < 1.)
-  {
-    double i2,j2;
-    i2=v*(Isrc.getHeight()-1);
-    j2=u*(Isrc.getWidth()-1);
-    if (interp == BILINEAR_INTERPOLATION)
-      Ipixelplan = Isrc.getValue(i2,j2);
-    else if (interp == SIMPLE)
-      Ipixelplan = Isrc[(unsigned int)i2][(unsigned int)j2];
-    return true;
+    plane.u[i] = (distance*vbase_u_optim[i] - X0_u*normal_Cam_optim[i]) / norm2_u;
+    plane.v[i] = (distance*vbase_v_optim[i] - X0_v*normal_Cam_optim[i]) / norm2_v;
+    plane.w[i] = normal_Cam_optim[i];
   }
+  plane.distance = distance;
+  //vpPolygon3D::getClippedPolygon() removes the part of the plane closer than 0.001 to the camera
+  if(needClipping)
+    plane.wmax = distance / 0.001;
   else
-    return false;
-}
-
-bool 
-vpImageSimulator::getPixelDepth(const vpImagePoint &iP, double &Zpixelplan)
-{
-  //test si pixel dans zone projetee
-    bool inside = false;
-    for(unsigned int i = 0 ; i < listTriangle.size() ; i++)
-        if(listTriangle[i].inTriangle(iP)){
-            inside = true;
-            break;
-        }
-    if(!inside) return false;
-//  if(!T1.inTriangle(iP) && !T2.inTriangle(iP))
-//    return false;
+    plane.wmax = std::numeric_limits<double>::max();
 
-  Zpixelplan = distance/(normal_Cam_optim[0]*iP.get_u()+normal_Cam_optim[1]*iP.get_v()+normal_Cam_optim[2]);
-  return true;
+  plane.Ig = (colorI == GRAY_SCALED) ? &Ig : NULL;
+  plane.Ic = (colorI == COLORED) ? &Ic : NULL;
+  plane.bilinear = (interp == BILINEAR_INTERPOLATION);
 }
 
 bool
@@ -0,0 +1,336 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the images rendered by vpImageSimulator.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageSimulator.cpp
+
+  \brief Render one plane and a list of planes with vpImageSimulator, with
+  and without distortion, with nearest and bilinear interpolation. Compare
+  each pixel of the bounding box of the projected corners with the
+  intersection of its ray with the planes, within 1 grey level, and check that
+  the images are the same with 1 and 4 threads.
+*/
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpMeterPixelConversion.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/robot/vpImageSimulator.h>
+
+#include <stdlib.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <string>
+#include <vector>
+
+namespace {
+  // Rectangle textured by an image, in the camera frame
+  struct Plane {
+    const vpImage<unsigned char> *texture;
+    vpColVector X0, eu, ev, normal;
+    double distance;
+    bool visible;
+    // Bounding box of the projection of the corners, outside of which vpImageSimulator does not render
+    double top, bottom, left, right;
+  };
+
+  // Corners of a rectangle of size 0.6 x 0.4 in the plane Z = 0 of the object frame
+  void getCorners(vpColVector *X)
+  {
+    const double corners[4][2] = { { -0.3, -0.2 }, { 0.3, -0.2 }, { 0.3, 0.2 }, { -0.3, 0.2 } };
+    for (unsigned int k = 0; k < 4; k++) {
+      X[k].resize(3);
+      X[k][0] = corners[k][0];
+      X[k][1] = corners[k][1];
+      X[k][2] = 0;
+    }
+  }
+
+  Plane createPlane(const vpImage<unsigned char> &texture, const vpHomogeneousMatrix &cMo,
+                    const vpCameraParameters &cam, const vpImage<unsigned char> &I)
+  {
+    vpColVector X[4], cX[4];
+    getCorners(X);
+    for (unsigned int k = 0; k < 4; k++) {
+      vpColVector oX(4, 1.);
+      oX[0] = X[k][0]; oX[1] = X[k][1]; oX[2] = X[k][2];
+      vpColVector c = cMo * oX;
+      cX[k].resize(3);
+      cX[k][0] = c[0]; cX[k][1] = c[1]; cX[k][2] = c[2];
+    }
+    Plane plane;
+    plane.texture = &texture;
+    plane.X0 = cX[0];
+    plane.eu = cX[1] - cX[0];
+    plane.ev = cX[3] - cX[0];
+    plane.normal = vpColVector::crossProd(plane.eu, plane.ev);
+    plane.normal = plane.normal / plane.normal.euclideanNorm();
+    plane.distance = vpColVector::dotProd(plane.normal, cX[0]);
+    // The face is seen from the side of the corners ordered clockwise
+    plane.visible = vpColVector::dotProd(cX[0], vpColVector::crossProd(cX[1] - cX[0], cX[2] - cX[1])) > 0
+                    && plane.distance > 0;
+
+    plane.top = plane.left = std::numeric_limits<double>::max();
+    plane.bottom = plane.right = -1;
+    for (unsigned int k = 0; k < 4; k++) {
+      double u, v;
+      vpMeterPixelConversion::convertPoint(cam, cX[k][0] / cX[k][2], cX[k][1] / cX[k][2], u, v);
+      plane.top = vpMath::minimum(plane.top, v);
+      plane.bottom = vpMath::maximum(plane.bottom, v);
+      plane.left = vpMath::minimum(plane.left, u);
+      plane.right = vpMath::maximum(plane.right, u);
+    }
+    plane.top = vpMath::maximum(0., vpMath::minimum(plane.top, I.getHeight() - 1.));
+    plane.bottom = vpMath::maximum(0., vpMath::minimum(plane.bottom, I.getHeight() - 1.));
+    plane.left = vpMath::maximum(0., vpMath::minimum(plane.left, I.getWidth() - 1.));
+    plane.right = vpMath::maximum(0., vpMath::minimum(plane.right, I.getWidth() - 1.));
+    return plane;
+  }
+
+  // Depth and texture coordinates of the intersection of the ray of (x, y) with the plane, false when the ray misses
+  // it. ambiguous is set when the point is close to a border of the texture or, with the nearest interpolation, of a
+  // texel, where rounding errors may change the result.
+  bool intersect(const Plane &plane, const double x, const double y, const bool bilinear, double &z, double &i2,
+                 double &j2, bool &ambiguous)
+  {
+    const double eps = 1e-6;
+    if (!plane.visible)
+      return false;
+    z = plane.distance / (plane.normal[0] * x + plane.normal[1] * y + plane.normal[2]);
+    if (z <= 0)
+      return false;
+    const double P[3] = { x * z - plane.X0[0], y * z - plane.X0[1], z - plane.X0[2] };
+    double u = 0, v = 0;
+    for (unsigned int k = 0; k < 3; k++) {
+      u += P[k] * plane.eu[k];
+      v += P[k] * plane.ev[k];
+    }
+    u /= vpColVector::dotProd(plane.eu, plane.eu);
+    v /= vpColVector::dotProd(plane.ev, plane.ev);
+    if (u < -eps || v < -eps || u > 1 + eps || v > 1 + eps)
+      return false;
+    ambiguous = (u < eps || v < eps || u > 1 - eps || v > 1 - eps);
+    i2 = v * (plane.texture->getHeight() - 1);
+    j2 = u * (plane.texture->getWidth() - 1);
+    if (!bilinear)
+      ambiguous = ambiguous || fabs(i2 - vpMath::round(i2)) < eps || fabs(j2 - vpMath::round(j2)) < eps;
+    return true;
+  }
+
+  // Compare I with the nearest of the planes seen by each pixel of the union of their bounding boxes, the other
+  // pixels keeping the value background
+  bool compare(const std::string &name, const vpImage<unsigned char> &I, const std::vector<Plane> &planes,
+               const vpCameraParameters &cam, const bool bilinear, const unsigned char background)
+  {
+    unsigned int top = I.getHeight(), bottom = 0, left = I.getWidth(), right = 0;
+    for (unsigned int k = 0; k < planes.size(); k++) {
+      if (planes[k].visible) {
+        top = std::min(top, (unsigned int)planes[k].top);
+        bottom = std::max(bottom, (unsigned int)planes[k].bottom);
+        left = std::min(left, (unsigned int)planes[k].left);
+        right = std::max(right, (unsigned int)planes[k].right);
+      }
+    }
+
+    unsigned int nbCovered = 0, nbAmbiguous = 0;
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        if (i < top || i >= bottom || j < left || j >= right) {
+          if (I[i][j] != background) {
+            std::cerr << name << ": the pixel (" << i << ", " << j << ") out of the planes is modified" << std::endl;
+            return false;
+          }
+          continue;
+        }
+        double x = 0, y = 0;
+        vpPixelMeterConversion::convertPoint(cam, (double)j, (double)i, x, y);
+        int nearest = -1;
+        double zmin = 0, i_nearest = 0, j_nearest = 0;
+        bool ambiguous = false;
+        for (unsigned int k = 0; k < planes.size(); k++) {
+          double z, i2, j2;
+          bool ambiguous_k = false;
+          if (intersect(planes[k], x, y, bilinear, z, i2, j2, ambiguous_k)) {
+            if (ambiguous_k || (nearest >= 0 && fabs(z - zmin) < 1e-6 * z))
+              ambiguous = true;
+            if (nearest < 0 || z < zmin) {
+              nearest = (int)k;
+              zmin = z;
+              i_nearest = i2;
+              j_nearest = j2;
+            }
+          }
+        }
+        if (ambiguous) {
+          nbAmbiguous++;
+          continue;
+        }
+
+        unsigned char expected = background;
+        if (nearest >= 0) {
+          const vpImage<unsigned char> &texture = *planes[(unsigned int)nearest].texture;
+          expected = bilinear ? texture.getValue(i_nearest, j_nearest)
+                              : texture[(unsigned int)i_nearest][(unsigned int)j_nearest];
+          nbCovered++;
+        }
+        if (abs((int)I[i][j] - (int)expected) > 1) {
+          std::cerr << name << ": the pixel (" << i << ", " << j << ") is " << (int)I[i][j] << " instead of "
+                    << (int)expected << std::endl;
+          return false;
+        }
+      }
+    }
+    std::cout << name << ": " << nbCovered << " pixels covered, " << nbAmbiguous << " ambiguous pixels skipped"
+              << std::endl;
+    if (nbCovered < I.getSize() / 10 || nbAmbiguous > I.getSize() / 1000) {
+      std::cerr << name << ": unexpected scene" << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool isEqual(const std::string &name, const vpImage<unsigned char> &I1, const vpImage<unsigned char> &I2)
+  {
+    for (unsigned int k = 0; k < I1.getSize(); k++) {
+      if (I1.bitmap[k] != I2.bitmap[k]) {
+        std::cerr << name << ": the images differ with 1 and 4 threads" << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // One plane rendered by vpImageSimulator::getImage()
+  bool checkPlane(const std::string &name, const vpImage<unsigned char> &texture, const vpHomogeneousMatrix &cMo,
+                  const vpCameraParameters &cam, const bool bilinear)
+  {
+    vpColVector X[4];
+    getCorners(X);
+    vpImageSimulator sim(vpImageSimulator::GRAY_SCALED);
+    sim.init(texture, X);
+    sim.setInterpolationType(bilinear ? vpImageSimulator::BILINEAR_INTERPOLATION : vpImageSimulator::SIMPLE);
+    sim.setCameraPosition(cMo);
+
+    vpImage<unsigned char> I(480, 640, 0), I_threads(480, 640, 0);
+    sim.setNbThreads(1);
+    sim.getImage(I, cam);
+    sim.setNbThreads(4);
+    sim.getImage(I_threads, cam);
+    if (!isEqual(name, I, I_threads))
+      return false;
+
+    std::vector<Plane> planes;
+    planes.push_back(createPlane(texture, cMo, cam, I));
+    return compare(name, I, planes, cam, bilinear, 0);
+  }
+
+  // Planes that hide each other rendered by the static vpImageSimulator::getImage()
+  bool checkPlanes(const std::string &name, const vpImage<unsigned char> &texture,
+                   const std::vector<vpHomogeneousMatrix> &cMo, const vpCameraParameters &cam, const bool bilinear)
+  {
+    vpColVector X[4];
+    getCorners(X);
+    std::list<vpImageSimulator> sims;
+    std::vector<Plane> planes;
+    for (unsigned int k = 0; k < cMo.size(); k++) {
+      vpImageSimulator sim(vpImageSimulator::GRAY_SCALED);
+      sim.init(texture, X);
+      sim.setInterpolationType(bilinear ? vpImageSimulator::BILINEAR_INTERPOLATION : vpImageSimulator::SIMPLE);
+      sim.setCameraPosition(cMo[k]);
+      sims.push_back(sim);
+    }
+
+    vpImage<unsigned char> I(480, 640, 0), I_threads(480, 640, 0);
+    for (unsigned int k = 0; k < cMo.size(); k++)
+      planes.push_back(createPlane(texture, cMo[k], cam, I));
+    // The number of threads is the one of the first image of the list
+    vpImageSimulator::getImage(I, sims, cam);
+    sims.front().setNbThreads(4);
+    vpImageSimulator::getImage(I_threads, sims, cam);
+    if (!isEqual(name, I, I_threads))
+      return false;
+
+    return compare(name, I, planes, cam, bilinear, 0);
+  }
+}
+
+int main()
+{
+  try {
+    vpImage<unsigned char> texture(120, 160);
+    for (unsigned int i = 0; i < texture.getHeight(); i++)
+      for (unsigned int j = 0; j < texture.getWidth(); j++)
+        texture[i][j] = (unsigned char)(128 + 60 * sin(j / 5.) * cos(i / 7.) + 40 * sin((i + j) / 11.));
+
+    vpCameraParameters cams[2];
+    cams[0].initPersProjWithoutDistortion(600, 610, 320, 240);
+    cams[1].initPersProjWithDistortion(600, 610, 320, 240, -0.1, 0.1);
+    const std::string camNames[2] = { "without distortion", "with distortion" };
+
+    vpHomogeneousMatrix poses[2];
+    poses[0].buildFrom(0.05, -0.02, 1.0, vpMath::rad(10), vpMath::rad(20), vpMath::rad(5));
+    poses[1].buildFrom(-0.1, 0.05, 0.6, vpMath::rad(-30), vpMath::rad(15), vpMath::rad(40));
+
+    // Three planes that intersect
+    std::vector<vpHomogeneousMatrix> scene;
+    scene.push_back(poses[0]);
+    scene.push_back(poses[0] * vpHomogeneousMatrix(0.1, 0.05, 0.05, 0, vpMath::rad(10), 0));
+    scene.push_back(poses[0] * vpHomogeneousMatrix(-0.15, 0, -0.02, vpMath::rad(5), 0, vpMath::rad(30)));
+
+    for (unsigned int c = 0; c < 2; c++) {
+      for (unsigned int interp = 0; interp < 2; interp++) {
+        const std::string suffix = camNames[c] + (interp ? ", bilinear" : ", nearest");
+        for (unsigned int p = 0; p < 2; p++) {
+          if (!checkPlane("one plane " + std::string(p ? "close" : "far") + ", " + suffix, texture, poses[p],
+                          cams[c], interp != 0))
+            return EXIT_FAILURE;
+        }
+        if (!checkPlanes("three planes, " + suffix, texture, scene, cams[c], interp != 0))
+          return EXIT_FAILURE;
+      }
+    }
+
+    std::cout << "testImageSimulator is ok." << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -49,6 +49,7 @@
 
 #include <visp3/core/vpMutex.h> // need pthread
 #include <visp3/core/vpImage.h>
+#include <visp3/core/vpPointCloud.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpCameraParameters.h>
 #include <visp3/core/vpPixelMeterConversion.h>
@@ -135,6 +136,7 @@ public:
 
   bool getDepthMap(vpImage<float>& map);
   bool getDepthMap(vpImage<float>& map, vpImage<unsigned char>& Imap);
+  bool getPointCloud(vpPointCloud& pointcloud);
   bool getRGB(vpImage<vpRGBa>& IRGB);
 
 
@@ -175,6 +177,7 @@ public:
   //Access protected by a mutex:
   vpImage<float> dmap;
   vpImage<vpRGBa> IRGB;
+  vpImage<float> m_dmap_pc;//depth map at the resolution of the point cloud, kept between the frames
   bool m_new_rgb_frame;
   bool m_new_depth_map;
   bool m_new_depth_image;
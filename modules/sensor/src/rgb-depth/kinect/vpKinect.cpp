@@ -42,6 +42,7 @@
 #if defined(VISP_HAVE_LIBFREENECT_AND_DEPENDENCIES)
 
 #include <limits>   // numeric_limits
+#include <string.h> // memcpy
 
 #include <visp3/sensor/vpKinect.h>
 #include <visp3/core/vpXmlParserCamera.h>
@@ -54,7 +55,7 @@ vpKinect::vpKinect(freenect_context *ctx, int index)
     m_rgb_mutex(), m_depth_mutex(), RGBcam(), IRcam(),
     rgbMir(), irMrgb(), DMres(DMAP_LOW_RES),
     hd(240), wd(320),
-    dmap(), IRGB(),
+    dmap(), IRGB(), m_dmap_pc(),
     m_new_rgb_frame(false),
     m_new_depth_map(false),
     m_new_depth_image(false),
@@ -234,6 +235,39 @@ bool vpKinect::getDepthMap(vpImage<float>& map,vpImage<unsigned char>& Imap)
 }
 
 
+/*!
+  Get the point cloud of the last metric depth map, at the resolution of the
+  depth map chosen in start(). The points are expressed in the IR camera
+  frame with the parameters given by getIRCamParameters(); the distortion is
+  not taken into account. The memory of \e pointcloud is reused from one
+  call to the other.
+
+  \return false if no new depth map is available.
+*/
+bool vpKinect::getPointCloud(vpPointCloud& pointcloud)
+{
+  m_depth_mutex.lock();
+  if (!m_new_depth_map) {
+    m_depth_mutex.unlock();
+    return false;
+  }
+  m_dmap_pc.resize(hd, wd);
+  if (DMres == DMAP_LOW_RES) {
+    for(unsigned int i = 0; i < hd; i++)
+      for(unsigned int j = 0; j < wd; j++)
+        m_dmap_pc[i][j] = dmap[i<<1][j<<1];
+  }
+  else {
+    memcpy(m_dmap_pc.bitmap, dmap.bitmap, hd*wd*sizeof(float));
+  }
+  m_new_depth_map = false;
+  m_depth_mutex.unlock();
+
+  // Invalid depths are set to -1 by DepthCallback()
+  pointcloud.buildFrom(m_dmap_pc, IRcam);
+  return true;
+}
+
 /*!
   Get RGB image
 */
@@ -41,6 +41,7 @@
 
 #include <librealsense/rs.hpp>
 #include <visp3/core/vpImage.h>
+#include <visp3/core/vpPointCloud.h>
 
 template <class Type>
 void vp_rs_get_frame_data_impl(const rs::device *m_device, const std::map <rs::stream, rs::intrinsics> &m_intrinsics, const rs::stream &stream, vpImage<Type> &data)
@@ -239,6 +240,71 @@ void vp_rs_get_pointcloud_impl(const rs::device *m_device, const std::map <rs::s
   }
 }
 
+// Retrieve point cloud in place, with the color aligned to the depth if the color stream is enabled
+void vp_rs_get_pointcloud_impl(const rs::device *m_device, const std::map <rs::stream, rs::intrinsics> &m_intrinsics, float max_Z, vpPointCloud &pointcloud,
+                               const float invalidDepthValue=0.0f, const rs::stream &stream_depth=rs::stream::depth)
+{
+  if (m_device->is_stream_enabled(rs::stream::depth)) {
+    std::map<rs::stream, rs::intrinsics>::const_iterator it_intrinsics = m_intrinsics.find(stream_depth);
+    if (it_intrinsics == m_intrinsics.end()) {
+      throw vpException(vpException::fatalError, "Cannot find intrinsics for depth stream!");
+    }
+
+    const rs::intrinsics &intrinsics = it_intrinsics->second;
+    const float depth_scale = m_device->get_depth_scale();
+    unsigned int width = (unsigned int) intrinsics.width;
+    unsigned int height = (unsigned int) intrinsics.height;
+    bool with_color = m_device->is_stream_enabled(rs::stream::color);
+    uint16_t * depth = (uint16_t *)m_device->get_frame_data(stream_depth);
+
+    pointcloud.setInvalidValue(invalidDepthValue);
+    pointcloud.resize(height, width, with_color);
+
+    if (intrinsics.model() == rs::distortion::none) {
+      // Deprojection with SSE2 and threads of the depth map, that is not copied
+      vpImage<uint16_t> depth_map;
+      depth_map.initNonOwning(depth, height, width);
+      vpCameraParameters cam(intrinsics.fx, intrinsics.fy, intrinsics.ppx, intrinsics.ppy);
+      pointcloud.buildFrom(depth_map, cam, depth_scale, max_Z);
+    }
+    else {
+      float *X = pointcloud.getX(), *Y = pointcloud.getY(), *Z = pointcloud.getZ();
+      unsigned char *valid = pointcloud.getValidity();
+      for (unsigned int i = 0, k = 0; i < height; i++) {
+        for (unsigned int j = 0; j < width; j++, k++) {
+          rs::float2 depth_pixel = { (float) j, (float) i};
+          rs::float3 depth_point = intrinsics.deproject(depth_pixel, depth[k] * depth_scale);
+
+          valid[k] = (depth_point.z > 0 && depth_point.z <= max_Z) ? 1 : 0;
+          if (! valid[k]) {
+            depth_point.x = depth_point.y = depth_point.z = invalidDepthValue;
+          }
+          X[k] = depth_point.x;
+          Y[k] = depth_point.y;
+          Z[k] = depth_point.z;
+        }
+      }
+    }
+
+    if (with_color) {
+      unsigned char *color = (unsigned char *) m_device->get_frame_data(rs::stream::color_aligned_to_depth);
+      unsigned char *rgba = (unsigned char *) pointcloud.getColor();
+      if (m_device->get_stream_format(rs::stream::color) == rs::format::rgb8) {
+        vpImageConvert::RGBToRGBa(color, rgba, width, height);
+      } else if (m_device->get_stream_format(rs::stream::color) == rs::format::rgba8) {
+        memcpy(rgba, color, width*height*sizeof(vpRGBa));
+      } else if (m_device->get_stream_format(rs::stream::color) == rs::format::bgr8) {
+        vpImageConvert::BGRToRGBa(color, rgba, width, height);
+      } else {
+        throw vpException(vpException::fatalError, "RealSense Camera - color stream not supported!");
+      }
+    }
+  }
+  else {
+    pointcloud.clear();
+  }
+}
+
 #ifdef VISP_HAVE_PCL
 // Retrieve point cloud
 void vp_rs_get_pointcloud_impl(const rs::device *m_device, const std::map<rs::stream, rs::intrinsics> &m_intrinsics, float max_Z, pcl::PointCloud<pcl::PointXYZ>::Ptr &pointcloud,
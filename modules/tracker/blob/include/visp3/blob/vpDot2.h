@@ -103,6 +103,13 @@
     is used when there was a problem performing basic tracking of the dot, but
     can also be used to find a certain type of dots in the full image.
 
+  When many dots are tracked in the same image, the static track(const
+  vpImage<unsigned char> &, std::vector<vpDot2> &, std::vector<bool> &, unsigned int)
+  method tracks them at once in vpThreadPool threads and reports the dots that
+  are lost instead of throwing an exception. The searchDotsInArea() method that
+  returns a std::vector grows the dots from the germs of the search grid in
+  parallel. Both give the same dots as the sequential methods.
+
   The following sample code available in tutorial-blob-tracker-live-firewire.cpp shows how to
   grab images from a firewire camera, track a blob and display the tracking
   results.
@@ -253,6 +260,10 @@ public:
                          unsigned int area_w, unsigned int area_h, std::list<vpDot2> &niceDots );
 
   void searchDotsInArea(const vpImage<unsigned char>& I, std::list<vpDot2> &niceDots );
+  void searchDotsInArea(const vpImage<unsigned char>& I,
+                        int area_u, int area_v,
+                        unsigned int area_w, unsigned int area_h, std::vector<vpDot2> &niceDots,
+                        const unsigned int nbThreads = 0);
 
   void setArea( const double & area );
   /*!
@@ -362,6 +373,8 @@ public:
 
   void track(const vpImage<unsigned char> &I);
   void track(const vpImage<unsigned char> &I, vpImagePoint &cog);
+  static unsigned int track(const vpImage<unsigned char> &I, std::vector<vpDot2> &dots,
+                            std::vector<bool> &tracked, const unsigned int nbThreads = 0);
 
   static void trackAndDisplay(vpDot2 dot[], const unsigned int &n, vpImage<unsigned char> &I,
                               std::vector<vpImagePoint> &cogs, vpImagePoint* cogStar = NULL);
@@ -443,6 +456,9 @@ private:
              const unsigned int &v) const;
 
   virtual vpDot2* getInstance();
+  vpDot2 *computeDotFromGerm(const vpImage<unsigned char> &I, const unsigned int &u,
+                             const unsigned int &v, bool &valid);
+  static void computeDotsFromGerms(unsigned int begin, unsigned int end, void *args);
 
   void init();
 
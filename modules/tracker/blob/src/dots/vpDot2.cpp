@@ -50,6 +50,7 @@
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpThreadPool.h>
 
 #include <visp3/blob/vpDot2.h>
 #include <math.h>
@@ -57,6 +58,54 @@
 #include <cmath>    // std::fabs
 #include <limits>   // numeric_limits
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+  // Dot grown from a germ of the search grid. The dot only depends on the
+  // first border found on the right of the germ, so that all the germs of a
+  // same run of pixels with a good level give the same dot.
+  struct vpDot2Germ {
+    unsigned int u;       // Germ
+    unsigned int v;
+    unsigned int border;  // Column of the first border on the right of the germ
+    vpDot2 *dot;          // NULL when no dot can be grown from the germ
+    bool valid;           // The dot is similar to the searched dot
+  };
+
+  struct vpDot2GermsArgs {
+    vpDot2 *wantedDot;
+    const vpImage<unsigned char> *I;
+    vpDot2Germ *germs;
+  };
+
+  class vpDot2BatchTracker
+  {
+  public:
+    vpDot2BatchTracker(const vpImage<unsigned char> &I_, std::vector<vpDot2> &dots_, std::vector<unsigned char> &status_)
+      : I(I_), dots(dots_), status(status_)
+    {}
+
+    void operator()(unsigned int begin, unsigned int end) const
+    {
+      for (unsigned int i = begin; i < end; i++) {
+        try {
+          dots[i].track(I);
+          status[i] = 1;
+        }
+        catch(const vpTrackingException &) {
+          status[i] = 0;
+        }
+      }
+    }
+
+  private:
+    const vpImage<unsigned char> &I;
+    std::vector<vpDot2> &dots;
+    std::vector<unsigned char> &status;
+  };
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /******************************************************************************
  *
  *      CONSTRUCTORS AND DESTRUCTORS
@@ -633,6 +682,65 @@ vpDot2::track(const vpImage<unsigned char> &I, vpImagePoint &ip)
   ip = this->cog;
 }
 
+/*!
+
+  Track a set of dots in the same image. Each dot is tracked as with track(),
+  the dots being shared between vpThreadPool threads. The dots found are the
+  same as when track() is called for each dot.
+
+  \param I : Image to process.
+
+  \param dots : Dots to track. They are updated as with track().
+
+  \param tracked [out] : \e tracked[i] is set to true when \e dots[i] is
+  tracked, and to false when it is lost, i.e. when track() would throw a
+  vpTrackingException for this dot.
+
+  \param nbThreads : Maximum number of threads, 0 for
+  vpThreadPool::getNbThreads(). When the graphics of a dot are enabled with
+  setGraphics(), the dots are tracked by the calling thread since the
+  display is not thread safe.
+
+  \return The number of dots that are tracked.
+
+  \code
+  std::vector<vpDot2> dots; // Dots initialized with initTracking()
+  std::vector<bool> tracked;
+  vpDot2::track(I, dots, tracked);
+  for (size_t i = 0; i < dots.size(); i++) {
+    if (tracked[i])
+      std::cout << "Dot " << i << ": " << dots[i].getCog() << std::endl;
+  }
+  \endcode
+
+  \sa track(const vpImage<unsigned char> &)
+*/
+unsigned int
+vpDot2::track(const vpImage<unsigned char> &I, std::vector<vpDot2> &dots, std::vector<bool> &tracked,
+              const unsigned int nbThreads)
+{
+  std::vector<unsigned char> status(dots.size(), 0);
+  unsigned int nb_threads = nbThreads;
+  for (size_t i = 0; i < dots.size(); i++) {
+    if (dots[i].graphics)
+      nb_threads = 1;
+  }
+
+  if (! dots.empty()) {
+    vpDot2BatchTracker tracker(I, dots, status);
+    vpThreadPool::parallel_for(0, (unsigned int)dots.size(), tracker, nb_threads);
+  }
+
+  unsigned int nbTracked = 0;
+  tracked.resize(dots.size());
+  for (size_t i = 0; i < dots.size(); i++) {
+    tracked[i] = (status[i] != 0);
+    if (tracked[i])
+      nbTracked++;
+  }
+  return nbTracked;
+}
+
 ///// GET METHODS /////////////////////////////////////////////////////////////
 
 /*!
@@ -1044,6 +1152,46 @@ void vpDot2::searchDotsInArea(const vpImage<unsigned char>& I,
                                unsigned int area_h,
                                std::list<vpDot2> &niceDots)
 
+{
+  std::vector<vpDot2> dots;
+  searchDotsInArea(I, area_u, area_v, area_w, area_h, dots, 1);
+  niceDots.assign(dots.begin(), dots.end());
+}
+
+/*!
+
+  Look for a list of dot matching this dot parameters within a region of
+  interest defined by a rectangle in the image, like
+  searchDotsInArea(const vpImage<unsigned char>&, int, int, unsigned int, unsigned int, std::list<vpDot2> &),
+  but return them in a std::vector.
+
+  The dots that can be grown from the germs of the search grid, one germ per
+  run of pixels with a good level, are first computed in vpThreadPool
+  threads. The germs are then processed in the same order as the sequential
+  search, so that the dots found and their order are the same.
+
+  \param I : Image to process.
+  \param area_u : Coordinate (column) of the upper-left area corner.
+  \param area_v : Coordinate (row) of the upper-left area corner.
+
+  \param area_w : Width or the area in which a dot is searched.
+  \param area_h : Height or the area in which a dot is searched.
+
+  \param niceDots: Dots that are found, sorted by distance to the center of
+  the area.
+
+  \param nbThreads : Maximum number of threads, 0 for
+  vpThreadPool::getNbThreads(). With one thread, or when the graphics are
+  enabled with setGraphics(), the dots are only computed by the calling
+  thread when the search needs them.
+*/
+void vpDot2::searchDotsInArea(const vpImage<unsigned char>& I,
+                              int area_u,
+                              int area_v,
+                              unsigned int area_w,
+                              unsigned int area_h,
+                              std::vector<vpDot2> &niceDots,
+                              const unsigned int nbThreads)
 {
   // clear the list of nice dots
   niceDots.clear();
@@ -1067,15 +1215,6 @@ void vpDot2::searchDotsInArea(const vpImage<unsigned char>& I,
   vpDisplay::displayRectangle(I, area, vpColor::blue);
   vpDisplay::flush(I);
 #endif
-  // start the search loop; for all points of the search grid,
-  // test if the pixel belongs to a valid dot.
-  // if it is so eventually add it to the vector of valid dots.
-  std::list<vpDot2> badDotsVector;
-  std::list<vpDot2>::iterator itnice;
-  std::list<vpDot2>::iterator itbad;
-
-  vpDot2* dotToTest = NULL;
-  vpDot2 tmpDot;
 
   unsigned int area_u_min = (unsigned int) area.getLeft();
   unsigned int area_u_max = (unsigned int) area.getRight();
@@ -1083,10 +1222,65 @@ void vpDot2::searchDotsInArea(const vpImage<unsigned char>& I,
   unsigned int area_v_max = (unsigned int) area.getBottom();
 
   unsigned int u, v;
+
+  // Grow in parallel the dots of the germs of the grid, keeping the first
+  // germ of each run of pixels with a good level. rowGerms gives the first
+  // germ of each row of the grid.
+  std::vector<vpDot2Germ> germs;
+  std::vector<size_t> rowGerms;
+  unsigned int nb_threads = (nbThreads > 0) ? nbThreads : vpThreadPool::getNbThreads();
+  if (nb_threads > 1 && ! graphics) {
+    for( v=area_v_min ; v<area_v_max ; v=v+gridHeight )
+    {
+      rowGerms.push_back(germs.size());
+      bool inRun = false;
+      unsigned int runEnd = 0;
+      for( u=area_u_min ; u<area_u_max ; u=u+gridWidth )
+      {
+        if( (inRun && u <= runEnd) || !hasGoodLevel(I, u, v) ) continue;
+
+        vpDot2Germ germ;
+        germ.u = u;
+        germ.v = v;
+        germ.border = u;
+        while( hasGoodLevel( I, germ.border+1, v ) && germ.border < area.getRight() )
+          germ.border++;
+        germ.dot = NULL;
+        germ.valid = false;
+        germs.push_back(germ);
+
+        inRun = true;
+        runEnd = germ.border;
+      }
+    }
+    rowGerms.push_back(germs.size());
+
+    if (! germs.empty()) {
+      vpDot2GermsArgs args;
+      args.wantedDot = this;
+      args.I = &I;
+      args.germs = &germs[0];
+      vpThreadPool::parallel_for(0, (unsigned int)germs.size(), &vpDot2::computeDotsFromGerms, &args, nb_threads);
+    }
+  }
+
+  // start the search loop; for all points of the search grid,
+  // test if the pixel belongs to a valid dot.
+  // if it is so eventually add it to the vector of valid dots.
+  std::vector<const vpDot2 *> nice; // Dots found, sorted by distance to the area center
+  std::vector<vpDot2 *> grown;      // Dots that were not grown in parallel
+  std::vector<int> badBbox;         // Bounding boxes of the bad dots
+
   vpImagePoint cogTmpDot;
 
   for( v=area_v_min ; v<area_v_max ; v=v+gridHeight )
   {
+    size_t germ = 0, germ_end = 0;
+    if (! rowGerms.empty()) {
+      germ = rowGerms[(v - area_v_min) / gridHeight];
+      germ_end = rowGerms[(v - area_v_min) / gridHeight + 1];
+    }
+
     for( u=area_u_min ; u<area_u_max ; u=u+gridWidth )
     {
       // if the pixel we're in doesn't have the right color (outside the
@@ -1098,22 +1292,18 @@ void vpDot2::searchDotsInArea(const vpImage<unsigned char>& I,
       // detected
       bool good_germ = true;
 
-      itnice = niceDots.begin();
-      while( itnice != niceDots.end() && good_germ == true) {
-        tmpDot = *itnice;
-
-        cogTmpDot = tmpDot.getCog();
+      for (size_t i = 0; i < nice.size() && good_germ == true; i++) {
+        cogTmpDot = nice[i]->getCog();
         double u0 = cogTmpDot.get_u();
         double v0 = cogTmpDot.get_v();
-        double half_w = tmpDot.getWidth()  / 2.;
-        double half_h = tmpDot.getHeight() / 2.;
+        double half_w = nice[i]->getWidth()  / 2.;
+        double half_h = nice[i]->getHeight() / 2.;
 
         if ( u >= (u0-half_w) && u <= (u0+half_w) &&
              v >= (v0-half_h) && v <= (v0+half_h) ) {
           // Germ is in a previously detected dot
           good_germ = false;
         }
-        ++ itnice;
       }
 
       if (! good_germ)
@@ -1130,15 +1320,11 @@ void vpDot2::searchDotsInArea(const vpImage<unsigned char>& I,
         continue;
       }
 
-      itbad = badDotsVector.begin();
-#define vpBAD_DOT_VALUE (*itbad)
       vpImagePoint cogBadDot;
 
-      while( itbad != badDotsVector.end() && good_germ == true) {
-        if( (double)u >= vpBAD_DOT_VALUE.bbox_u_min
-            && (double)u <= vpBAD_DOT_VALUE.bbox_u_max &&
-            (double)v >= vpBAD_DOT_VALUE.bbox_v_min
-            && (double)v <= vpBAD_DOT_VALUE.bbox_v_max){
+      for (size_t i = 0; i < badBbox.size() && good_germ == true; i += 4) {
+        if( (double)u >= badBbox[i] && (double)u <= badBbox[i+1] &&
+            (double)v >= badBbox[i+2] && (double)v <= badBbox[i+3]){
           std::list<vpImagePoint>::const_iterator it_edges = ip_edges_list.begin();
           while (it_edges != ip_edges_list.end() && good_germ == true){
             // Test if the germ belong to a previously detected dot:
@@ -1154,9 +1340,7 @@ void vpDot2::searchDotsInArea(const vpImage<unsigned char>& I,
             ++ it_edges;
           }
         }
-        ++itbad;
       }
-#undef vpBAD_DOT_VALUE
 
       if (! good_germ) {
         // Jump all the pixels between v,u and v, dotToTest->getFirstBorder_u()
@@ -1167,37 +1351,34 @@ void vpDot2::searchDotsInArea(const vpImage<unsigned char>& I,
 
       vpTRACE(4, "Try germ (%d, %d)", u, v);
 
-      vpImagePoint germ;
-      germ.set_u( u );
-      germ.set_v( v );
-
       // otherwise estimate the width, height and surface of the dot we
-      // created, and test it.
-      if( dotToTest != NULL ) delete dotToTest;
-      dotToTest = getInstance();
-      dotToTest->setCog( germ );
-      dotToTest->setGrayLevelMin ( getGrayLevelMin() );
-      dotToTest->setGrayLevelMax ( getGrayLevelMax() );
-      dotToTest->setGrayLevelPrecision( getGrayLevelPrecision() );
-      dotToTest->setSizePrecision( getSizePrecision() );
-      dotToTest->setGraphics( graphics );
-      dotToTest->setGraphicsThickness( thickness );
-      dotToTest->setComputeMoments( true );
-      dotToTest->setArea( area );
-      dotToTest->setEllipsoidShapePrecision( ellipsoidShapePrecision );
-      dotToTest->setEllipsoidBadPointsPercentage( allowedBadPointsPercentage_ );
-
-      // first compute the parameters of the dot.
-      // if for some reasons this caused an error tracking
+      // created, and test it. The dot only depends on the border, and was
+      // already grown if a germ of the same run was found above.
+      const vpDot2 *dotToTest = NULL;
+      bool valid = false;
+      while (germ < germ_end && germs[germ].border < border_u)
+        germ++;
+      if (germ < germ_end && germs[germ].border == border_u) {
+        dotToTest = germs[germ].dot;
+        valid = germs[germ].valid;
+      }
+      else {
+        vpDot2 *dot = computeDotFromGerm(I, u, v, valid);
+        if (dot != NULL)
+          grown.push_back(dot);
+        dotToTest = dot;
+      }
+
+      // if for some reasons the parameters of the dot cannot be computed
       // (dot partially out of the image...), check the next intersection
-      if( dotToTest->computeParameters( I ) == false ) {
+      if( dotToTest == NULL ) {
         // Jump all the pixels between v,u and v, dotToTest->getFirstBorder_u()
         u = border_u;
         v = border_v;
         continue;
       }
       // if the dot to test is valid,
-      if( dotToTest->isValid( I, *this ) )
+      if( valid )
       {
         vpImagePoint cogDotToTest = dotToTest->getCog();
         // Compute the distance to the center. The center used here is not the
@@ -1213,17 +1394,15 @@ void vpDot2::searchDotsInArea(const vpImage<unsigned char>& I,
         double thisDist = sqrt( thisDiff_u*thisDiff_u + thisDiff_v*thisDiff_v);
 
         bool stopLoop = false;
-        itnice = niceDots.begin();
+        size_t i = 0;
 
-        while( itnice != niceDots.end() &&  stopLoop == false )
+        while( i < nice.size() &&  stopLoop == false )
         {
-          tmpDot = *itnice;
-
           //double epsilon = 0.001; // detecte +sieurs points
           double epsilon = 3.0;
           // if the center of the dot is the same than the current
           // don't add it, test the next point of the grid
-          cogTmpDot = tmpDot.getCog();
+          cogTmpDot = nice[i]->getCog();
 
           if( fabs( cogTmpDot.get_u() - cogDotToTest.get_u() ) < epsilon &&
               fabs( cogTmpDot.get_v() - cogDotToTest.get_v() ) < epsilon )
@@ -1246,32 +1425,96 @@ void vpDot2::searchDotsInArea(const vpImage<unsigned char>& I,
           // then add this dot before the current vector element.
           if( otherDist > thisDist )
           {
-            niceDots.insert(itnice, *dotToTest );
-            ++ itnice;
+            nice.insert(nice.begin() + i, dotToTest);
             stopLoop = true;
             // Jump all the pixels between v,u and v, tmpDot->getFirstBorder_u()
             u = border_u;
             v = border_v;
             continue;
           }
-          ++itnice;
+          i++;
         }
         vpTRACE(4, "End while (%d, %d)", u, v);
 
         // if we reached the end of the vector without finding the dot
         // or inserting it, insert it now.
-        if( itnice == niceDots.end() && stopLoop == false )
+        if( stopLoop == false )
         {
-          niceDots.push_back( *dotToTest );
+          nice.push_back( dotToTest );
         }
       }
       else {
         // Store bad dots
-        badDotsVector.push_front( *dotToTest );
+        badBbox.push_back(dotToTest->bbox_u_min);
+        badBbox.push_back(dotToTest->bbox_u_max);
+        badBbox.push_back(dotToTest->bbox_v_min);
+        badBbox.push_back(dotToTest->bbox_v_max);
       }
     }
   }
-  if( dotToTest != NULL ) delete dotToTest;
+
+  niceDots.reserve(nice.size());
+  for (size_t i = 0; i < nice.size(); i++)
+    niceDots.push_back(*nice[i]);
+
+  for (size_t i = 0; i < germs.size(); i++)
+    delete germs[i].dot;
+  for (size_t i = 0; i < grown.size(); i++)
+    delete grown[i];
+}
+
+/*!
+
+  Grow a dot from the germ (\e u, \e v) with the gray levels and the
+  precisions of this dot, as done by searchDotsInArea().
+
+  \param I : Image to process.
+  \param u, v : Germ coordinates.
+  \param valid [out] : true if the dot is similar to this dot, see isValid().
+
+  \return The dot, to delete by the caller, or NULL if its parameters can
+  not be computed.
+*/
+vpDot2 *vpDot2::computeDotFromGerm(const vpImage<unsigned char> &I, const unsigned int &u,
+                                   const unsigned int &v, bool &valid)
+{
+  vpImagePoint germ;
+  germ.set_u( u );
+  germ.set_v( v );
+
+  vpDot2 *dotToTest = getInstance();
+  dotToTest->setCog( germ );
+  dotToTest->setGrayLevelMin ( getGrayLevelMin() );
+  dotToTest->setGrayLevelMax ( getGrayLevelMax() );
+  dotToTest->setGrayLevelPrecision( getGrayLevelPrecision() );
+  dotToTest->setSizePrecision( getSizePrecision() );
+  dotToTest->setGraphics( graphics );
+  dotToTest->setGraphicsThickness( thickness );
+  dotToTest->setComputeMoments( true );
+  dotToTest->setArea( area );
+  dotToTest->setEllipsoidShapePrecision( ellipsoidShapePrecision );
+  dotToTest->setEllipsoidBadPointsPercentage( allowedBadPointsPercentage_ );
+
+  valid = false;
+  if( dotToTest->computeParameters( I ) == false ) {
+    delete dotToTest;
+    return NULL;
+  }
+  valid = dotToTest->isValid( I, *this );
+  return dotToTest;
+}
+
+/*!
+  vpThreadPool loop body of searchDotsInArea(): grow the dots of the germs
+  [\e begin, \e end).
+*/
+void vpDot2::computeDotsFromGerms(unsigned int begin, unsigned int end, void *args)
+{
+  vpDot2GermsArgs *germsArgs = static_cast<vpDot2GermsArgs *>(args);
+  for (unsigned int i = begin; i < end; i++) {
+    vpDot2Germ &germ = germsArgs->germs[i];
+    germ.dot = germsArgs->wantedDot->computeDotFromGerm(*germsArgs->I, germ.u, germ.v, germ.valid);
+  }
 }
 
 /*!
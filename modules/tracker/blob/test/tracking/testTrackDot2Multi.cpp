@@ -0,0 +1,268 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the tracking of several dots at once and the parallel search of dots.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testTrackDot2Multi.cpp
+
+  \brief Check that vpDot2::track() applied to a vector of dots and the
+  parallel vpDot2::searchDotsInArea() give the same dots as the sequential
+  methods, on a synthetic image of ellipses.
+*/
+
+#include <visp3/blob/vpDot2.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpTrackingException.h>
+#include <visp3/io/vpParseArgv.h>
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+#include <list>
+#include <vector>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdh"
+
+namespace {
+  void usage(const char *name, const char *badparam)
+  {
+    fprintf(stdout, "\n\
+Compare the batch tracking and the parallel search of vpDot2 with the\n\
+sequential methods.\n\
+\n\
+SYNOPSIS\n\
+  %s [-c] [-d] [-h]\n", name);
+
+    fprintf(stdout, "\n\
+OPTIONS:\n\
+  -c\n\
+     Disable the mouse click. Useless in this test.\n\
+\n\
+  -d\n\
+     Disable the image display. Useless in this test.\n\
+\n\
+  -h\n\
+     Print the help.\n\n");
+
+    if (badparam)
+      fprintf(stdout, "\nERROR: Bad parameter [%s]\n", badparam);
+  }
+
+  bool getOptions(int argc, const char **argv)
+  {
+    const char *optarg_;
+    int c;
+    while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+      switch (c) {
+      case 'c': break;
+      case 'd': break;
+      case 'h': usage(argv[0], NULL); return false; break;
+
+      default:
+        usage(argv[0], optarg_);
+        return false; break;
+      }
+    }
+
+    if ((c == 1) || (c == -1)) {
+      // standalone param or error
+      usage(argv[0], NULL);
+      std::cerr << "ERROR: " << std::endl;
+      std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  double getRandomValues(const double min, const double max) {
+    return (max - min) * ( (double) rand() / (double) RAND_MAX ) + min;
+  }
+
+  struct Ellipse {
+    double u, v, a, b;
+  };
+
+  // Bright ellipses on a dark noisy background
+  void drawEllipses(const std::vector<Ellipse> &ellipses, double du, double dv, vpImage<unsigned char> &I) {
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        I[i][j] = (unsigned char) getRandomValues(20, 60);
+
+    for (size_t k = 0; k < ellipses.size(); k++) {
+      const Ellipse &e = ellipses[k];
+      for (int i = (int)(e.v + dv - e.b - 1); i <= (int)(e.v + dv + e.b + 1); i++) {
+        for (int j = (int)(e.u + du - e.a - 1); j <= (int)(e.u + du + e.a + 1); j++) {
+          double x = (j - e.u - du) / e.a, y = (i - e.v - dv) / e.b;
+          if (x*x + y*y <= 1. && i >= 0 && j >= 0 && i < (int)I.getHeight() && j < (int)I.getWidth())
+            I[(unsigned int)i][(unsigned int)j] = (unsigned char) getRandomValues(200, 240);
+        }
+      }
+    }
+  }
+
+  bool sameDot(const vpDot2 &d1, const vpDot2 &d2) {
+    return (d1.getCog() == d2.getCog() && d1.m00 == d2.m00 && d1.m10 == d2.m10 && d1.m01 == d2.m01
+            && d1.m11 == d2.m11 && d1.m20 == d2.m20 && d1.m02 == d2.m02
+            && d1.getWidth() == d2.getWidth() && d1.getHeight() == d2.getHeight()
+            && d1.getGrayLevelMin() == d2.getGrayLevelMin() && d1.getGrayLevelMax() == d2.getGrayLevelMax());
+  }
+}
+
+int main(int argc, const char **argv)
+{
+  try {
+    if (getOptions(argc, argv) == false) {
+      return EXIT_FAILURE;
+    }
+
+    srand(0);
+    std::vector<Ellipse> ellipses;
+    for (unsigned int r = 0; r < 6; r++) {
+      for (unsigned int c = 0; c < 8; c++) {
+        Ellipse e;
+        e.u = 40 + 75 * c + getRandomValues(-8, 8);
+        e.v = 40 + 75 * r + getRandomValues(-8, 8);
+        e.a = getRandomValues(8, 12);
+        e.b = getRandomValues(8, 12);
+        ellipses.push_back(e);
+      }
+    }
+    vpImage<unsigned char> I(480, 640);
+    drawEllipses(ellipses, 0, 0, I);
+
+    // Search the dots with the sequential and the parallel methods
+    vpDot2 blob;
+    blob.setWidth(20);
+    blob.setHeight(20);
+    blob.setArea(314);
+    blob.setGrayLevelMin(150);
+    blob.setGrayLevelMax(255);
+    blob.setGrayLevelPrecision(0.8);
+    blob.setSizePrecision(0.5);
+    blob.setEllipsoidShapePrecision(0.65);
+
+    std::list<vpDot2> blob_list;
+    double t = vpTime::measureTimeMs();
+    blob.searchDotsInArea(I, 0, 0, I.getWidth(), I.getHeight(), blob_list);
+    double t_search_list = vpTime::measureTimeMs() - t;
+
+    const unsigned int nbThreads[] = {1, 2, 4};
+    double t_search = 0;
+    for (unsigned int n = 0; n < sizeof(nbThreads) / sizeof(nbThreads[0]); n++) {
+      std::vector<vpDot2> blob_vector;
+      t = vpTime::measureTimeMs();
+      blob.searchDotsInArea(I, 0, 0, I.getWidth(), I.getHeight(), blob_vector, nbThreads[n]);
+      if (nbThreads[n] == 4)
+        t_search = vpTime::measureTimeMs() - t;
+
+      if (blob_vector.size() != blob_list.size()) {
+        std::cerr << "Found " << blob_vector.size() << " dots with " << nbThreads[n] << " threads instead of "
+                  << blob_list.size() << std::endl;
+        return EXIT_FAILURE;
+      }
+      size_t k = 0;
+      for (std::list<vpDot2>::const_iterator it = blob_list.begin(); it != blob_list.end(); ++it, ++k) {
+        if (! sameDot(*it, blob_vector[k])) {
+          std::cerr << "Dot " << k << " differs with " << nbThreads[n] << " threads" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+    if (blob_list.size() < ellipses.size() / 2) {
+      std::cerr << "Only " << blob_list.size() << " dots found" << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << blob_list.size() << " dots found in " << t_search_list << " ms, in parallel: "
+              << t_search << " ms" << std::endl;
+
+    // Track the dots in a new image where they moved, one of them being removed
+    std::vector<vpDot2> dots;
+    for (std::list<vpDot2>::iterator it = blob_list.begin(); it != blob_list.end(); ++it) {
+      vpDot2 dot;
+      dot.initTracking(I, it->getCog());
+      dots.push_back(dot);
+    }
+    ellipses.erase(ellipses.begin() + 10);
+    drawEllipses(ellipses, 2.5, -1.5, I);
+
+    std::vector<vpDot2> dots_ref = dots;
+    std::vector<bool> tracked_ref(dots.size(), true);
+    t = vpTime::measureTimeMs();
+    for (size_t i = 0; i < dots_ref.size(); i++) {
+      try {
+        dots_ref[i].track(I);
+      }
+      catch(const vpTrackingException &) {
+        tracked_ref[i] = false;
+      }
+    }
+    double t_track_ref = vpTime::measureTimeMs() - t;
+
+    double t_track = 0;
+    for (unsigned int n = 0; n < sizeof(nbThreads) / sizeof(nbThreads[0]); n++) {
+      std::vector<vpDot2> dots_batch = dots;
+      std::vector<bool> tracked;
+      t = vpTime::measureTimeMs();
+      unsigned int nbTracked = vpDot2::track(I, dots_batch, tracked, nbThreads[n]);
+      if (nbThreads[n] == 4)
+        t_track = vpTime::measureTimeMs() - t;
+
+      unsigned int nbTracked_ref = 0;
+      for (size_t i = 0; i < dots.size(); i++) {
+        if (tracked[i] != tracked_ref[i] || (tracked[i] && ! sameDot(dots_batch[i], dots_ref[i]))) {
+          std::cerr << "Tracking of dot " << i << " differs with " << nbThreads[n] << " threads" << std::endl;
+          return EXIT_FAILURE;
+        }
+        if (tracked_ref[i])
+          nbTracked_ref++;
+      }
+      if (nbTracked != nbTracked_ref) {
+        std::cerr << "Bad number of tracked dots" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    std::cout << dots.size() << " dots tracked in " << t_track_ref << " ms, in parallel: "
+              << t_track << " ms" << std::endl;
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -265,7 +265,6 @@ public:
 
   virtual void setGoodMovingEdgesRatioThreshold(const double threshold);
 
-#ifdef VISP_HAVE_OGRE
   /*!
     Set the ratio of visibility attempts that has to be successful to consider a polygon as visible.
 
@@ -284,7 +283,6 @@ public:
     \param attempts Number of rays to be sent.
   */
   void setNbRayCastingAttemptsForVisibility(const unsigned int &attempts);
-#endif
 
   virtual void setLod(const bool useLod, const std::string &name="");
   virtual void setLod(const bool useLod, const std::string &cameraName, const std::string &name);
@@ -332,6 +330,8 @@ public:
 
   virtual void setProjectionErrorComputation(const bool &flag);
 
+  virtual void setRayCastingVisibilityTest(const bool &v);
+
   virtual void setReferenceCameraName(const std::string &referenceCameraName);
 
   virtual void setScales(const std::vector<bool>& scales);
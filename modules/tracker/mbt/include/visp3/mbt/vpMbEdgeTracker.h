@@ -46,6 +46,7 @@
 #define vpMbEdgeTracker_HH
 
 #include <visp3/core/vpPoint.h>
+#include <visp3/core/vpImagePyramid.h>
 #include <visp3/mbt/vpMbTracker.h>
 #include <visp3/me/vpMe.h>
 #include <visp3/mbt/vpMbtMeLine.h>
@@ -295,6 +296,8 @@ class VISP_EXPORT vpMbEdgeTracker: public virtual vpMbTracker
     
     //! Pyramid of image associated to the current image. This pyramid is computed in the init() and in the track() methods.
     std::vector< const vpImage<unsigned char>* > Ipyramid;
+    //! Subsampled pyramid of the current image, kept from one call to track() to the next.
+    vpImagePyramid m_pyramid;
     
     //! Current scale level used. This attribute must not be modified outside of the downScale() and upScale() methods, as it used to specify to some methods which set of distanceLine use. 
     unsigned int scaleLevel;
@@ -323,6 +326,14 @@ class VISP_EXPORT vpMbEdgeTracker: public virtual vpMbTracker
     vpColVector m_weightedError_edge;
     //! Robust
     vpRobust m_robust_edge;
+    //! Number of threads used to track and update the moving edges of the model primitives
+    unsigned int m_nbMovingEdgeThreads;
+    //! Time spent in trackMovingEdge() during the last call to track() (in ms)
+    double m_trackMovingEdgeTime;
+    //! Time spent in computeVVS() during the last call to track() (in ms)
+    double m_computeVVSTime;
+    //! Time spent in updateMovingEdge() during the last call to track() (in ms)
+    double m_updateMovingEdgeTime;
 
 
 public:
@@ -354,6 +365,13 @@ public:
   */
   virtual inline vpMe getMovingEdge() const { return this->me;}
 
+  /*!
+    Return the number of threads used to track and update the moving edges.
+
+    \sa setNbMovingEdgeThreads()
+  */
+  inline unsigned int getNbMovingEdgeThreads() const { return m_nbMovingEdgeThreads; }
+
   virtual unsigned int getNbPoints(const unsigned int level=0) const;
   
   /*!
@@ -372,6 +390,8 @@ public:
    */
   inline double getGoodMovingEdgesRatioThreshold() const { return percentageGdPt;}
 
+  void getTrackingTimes(double &trackMovingEdgeTime, double &computeVVSTime, double &updateMovingEdgeTime) const;
+
   virtual inline vpColVector getError() const {
     return m_error_edge;
   }
@@ -466,6 +486,24 @@ public:
   
   void setMovingEdge(const vpMe &me);
 
+  /*!
+    Set the number of threads used to track and update the moving edges of the
+    visible lines, cylinders and circles. The primitives are dispatched to the
+    threads on demand, the most expensive ones first, so that a long line does
+    not keep a single thread busy while the others are idle.
+
+    Since each primitive owns its moving edges, the estimated pose does not
+    depend on the number of threads.
+
+    \param nb : Number of threads. 1 (the default value) means that the moving
+    edges are processed sequentially in the calling thread. 0 is considered as 1.
+    Parallel processing requires pthread or Windows threads; otherwise
+    this setting has no effect.
+
+    \sa getNbMovingEdgeThreads(), getTrackingTimes()
+  */
+  inline void setNbMovingEdgeThreads(const unsigned int nb) { m_nbMovingEdgeThreads = (nb > 0) ? nb : 1; }
+
   virtual void setPose(const vpImage<unsigned char> &I, const vpHomogeneousMatrix& cdMo);
   
   void setScales(const std::vector<bool>& _scales);
@@ -473,6 +511,7 @@ public:
   void setUseEdgeTracking(const std::string &name, const bool &useEdgeTracking);
 
   void track(const vpImage<unsigned char> &I);
+  void track(const vpImagePyramid &pyramid);
   //@}
 
 protected:
@@ -517,8 +556,12 @@ protected:
   void resetMovingEdge();
   void testTracking();
   void trackMovingEdge(const vpImage<unsigned char> &I);
+  void trackPyramid(const vpImage<unsigned char> &I);
   void updateMovingEdge(const vpImage<unsigned char> &I);
   void updateMovingEdgeWeights();
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+  void processMovingEdgesInParallel(const vpImage<unsigned char> &I, const bool update);
+#endif
   void upScale(const unsigned int _scale); 
   void visibleFace(const vpImage<unsigned char> &_I, const vpHomogeneousMatrix &_cMo, bool &newvisibleline) ; 
   //@}
@@ -39,6 +39,7 @@
 #ifndef __vpMbGenericTracker_h_
 #define __vpMbGenericTracker_h_
 
+#include <visp3/core/vpThreadPool.h>
 #include <visp3/mbt/vpMbEdgeTracker.h>
 #include <visp3/mbt/vpMbKltTracker.h>
 
@@ -156,6 +157,15 @@ public:
     return m_w;
   }
 
+  /*!
+    \return True if the per-camera stages of the tracking are run in parallel.
+
+    \sa setUseParallelTracking
+  */
+  inline bool getUseParallelTracking() const {
+    return m_useParallelTracking;
+  }
+
   virtual void init(const vpImage<unsigned char>& I);
 
 #ifdef VISP_HAVE_MODULE_GUI
@@ -230,10 +240,8 @@ public:
 
   virtual void setGoodMovingEdgesRatioThreshold(const double  threshold);
 
-#ifdef VISP_HAVE_OGRE
   virtual void setGoodNbRayCastingAttemptsRatio(const double &ratio);
   virtual void setNbRayCastingAttemptsForVisibility(const unsigned int &attempts);
-#endif
 
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   virtual void setKltMaskBorder(const unsigned int &e);
@@ -271,6 +279,8 @@ public:
 
   virtual void setProjectionErrorComputation(const bool &flag);
 
+  virtual void setRayCastingVisibilityTest(const bool &v);
+
   virtual void setReferenceCameraName(const std::string &referenceCameraName);
 
   virtual void setScanLineVisibilityTest(const bool &v);
@@ -278,6 +288,18 @@ public:
   virtual void setTrackerType(const int type);
 
   virtual void setUseEdgeTracking(const std::string &name, const bool &useEdgeTracking);
+  /*!
+    Set if the per-camera stages of the tracking (moving-edges and KLT
+    tracking, computation of the interaction matrices, residuals and robust
+    weights) should be run in parallel, with up to one thread of
+    vpThreadPool per camera. The pose estimated is the same than with the
+    sequential version.
+
+    \note Need Pthread. Without effect when there is only one camera.
+  */
+  inline void setUseParallelTracking(const bool use) {
+    m_useParallelTracking = use;
+  }
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   virtual void setUseKltTracking(const std::string &name, const bool &useKltTracking);
 #endif
@@ -406,6 +428,51 @@ private:
     virtual void postTracking(const vpImage<unsigned char> &I);
   };
 
+  //! Stages of the tracking that each camera runs independently of the others
+  enum vpTrackerWrapperStage {
+    PRE_TRACKING,
+    VVS_INIT,
+    VVS_INTERACTION_MATRIX_AND_RESIDU,
+    VVS_WEIGHTS,
+    POST_TRACKING
+  };
+
+  //For parallel tracking
+  class TrackerWrapperFunctor {
+  public:
+    TrackerWrapperFunctor(TrackerWrapper *tracker_, const vpImage<unsigned char> *I_, const vpTrackerWrapperStage stage_) :
+      m_errorCode(0), m_errorMessage(), m_exceptionType(NO_EXCEPTION), m_I(I_), m_stage(stage_), m_tracker(tracker_) {
+    }
+
+    TrackerWrapperFunctor() :
+      m_errorCode(0), m_errorMessage(), m_exceptionType(NO_EXCEPTION), m_I(NULL), m_stage(PRE_TRACKING), m_tracker(NULL) {
+    }
+
+    void operator()();
+
+    void rethrow() const;
+
+  private:
+    enum vpExceptionType {
+      NO_EXCEPTION,
+      VISP_EXCEPTION,
+      TRACKING_EXCEPTION,
+      UNKNOWN_EXCEPTION
+    };
+
+    int m_errorCode;
+    std::string m_errorMessage;
+    vpExceptionType m_exceptionType;
+    const vpImage<unsigned char> *m_I;
+    vpTrackerWrapperStage m_stage;
+    TrackerWrapper *m_tracker;
+  };
+
+  static void processTrackerWrapper(TrackerWrapper *tracker, const vpImage<unsigned char> *I, const vpTrackerWrapperStage stage);
+  void processTrackerWrappers(const vpTrackerWrapperStage stage, const std::map<std::string, const vpImage<unsigned char> *> &mapOfImages);
+
+  static void trackerWrapperRange(unsigned int begin, unsigned int end, void *arg);
+
 
 protected:
   //! (s - s*)
@@ -428,5 +495,7 @@ protected:
   vpColVector m_w;
   //! Weighted error
   vpColVector m_weightedError;
+  //! If true, the per-camera stages of the tracking are run in parallel
+  bool m_useParallelTracking;
 };
 #endif
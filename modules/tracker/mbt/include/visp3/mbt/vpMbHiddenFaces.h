@@ -46,13 +46,17 @@
 #include <visp3/core/vpPixelMeterConversion.h>
 #include <visp3/mbt/vpMbtPolygon.h>
 #include <visp3/mbt/vpMbScanLine.h>
+#include <visp3/mbt/vpMbRayCaster.h>
 
 #ifdef VISP_HAVE_OGRE
   #include <visp3/ar/vpAROgre.h>
 #endif
 
-#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <limits>
+#include <vector>
 
 /*!
   \class vpMbHiddenFaces
@@ -71,12 +75,24 @@ class vpMbHiddenFaces
   //! Number of visible polygon
   unsigned int nbVisiblePolygon;
   vpMbScanLine scanlineRender;
+  //! Number of rays sent toward each polygon (Ogre3D or CPU ray casting)
+  unsigned int nbRayAttempts;
+  //! Ratio of rays that have to reach a polygon for it to be visible
+  double ratioVisibleRay;
+  //! True if the CPU ray casting is used by setVisible()
+  bool useRayCasting;
+  //! Bounding volume hierarchy over the polygons, built at the first ray casting
+  vpMbRayCaster rayCaster;
+  //! Rays cast by setVisible(), kept from one call to the other
+  std::vector<vpMbRayCasterRay> rays;
+  //! Result of the ray casting of each polygon for the current pose
+  std::vector<unsigned char> rayVisibility;
+  //! True while rayVisibility is up to date for the pose given to setVisible()
+  bool rayVisibilityComputed;
 
 #ifdef VISP_HAVE_OGRE
   vpImage<unsigned char> ogreBackground;
   bool ogreInitialised;
-  unsigned int nbRayAttempts;
-  double ratioVisibleRay;
   vpAROgre *ogre;
   std::vector< Ogre::ManualObject* > lOgrePolygons;
   bool ogreShowConfigDialog;
@@ -88,6 +104,10 @@ class vpMbHiddenFaces
                            const vpImage<unsigned char> &I = vpImage<unsigned char>(),
                            const vpCameraParameters &cam = vpCameraParameters());
 
+  void addRays(const unsigned int &index, std::vector<vpMbRayCasterRay> &raysToCast);
+  void computeRayCastingVisibility(const vpTranslationVector &cameraPos);
+  bool isVisibleRays(const vpMbRayCasterRay *raysOfPolygon) const;
+
   public :
                     vpMbHiddenFaces();
                   ~vpMbHiddenFaces();
@@ -111,6 +131,13 @@ class vpMbHiddenFaces
 
     vpMbScanLine& getMbScanLineRenderer() { return scanlineRender; }
 
+    /*!
+      Get the bounding volume hierarchy used by the CPU ray casting.
+
+      \sa setRayCastingVisibilityTest()
+    */
+    vpMbRayCaster& getRayCaster() { return rayCaster; }
+
 #ifdef VISP_HAVE_OGRE
     void          displayOgre(const vpHomogeneousMatrix &cMo);
 #endif
@@ -133,7 +160,6 @@ class vpMbHiddenFaces
     */
     unsigned int getNbVisiblePolygon() const {return nbVisiblePolygon;}
 
-#ifdef VISP_HAVE_OGRE
     /*!
       Get the number of rays that will be sent toward each polygon for visibility test.
       Each ray will go from the optic center of the camera to a random point inside the considered polygon.
@@ -144,12 +170,14 @@ class vpMbHiddenFaces
     */
     unsigned int getNbRayCastingAttemptsForVisibility() { return nbRayAttempts; }
 
+#ifdef VISP_HAVE_OGRE
     /*!
       Get the Ogre3D Context.
 
       \return A pointer on a vpAROgre instance.
     */
     vpAROgre*     getOgreContext(){return ogre;}
+#endif
 
     /*!
       Get the ratio of visibility attempts that has to be successful to consider a polygon as visible.
@@ -159,7 +187,6 @@ class vpMbHiddenFaces
       \return Ratio of succesful attempts that has to be considered. Value will be between 0.0 (0%) and 1.0 (100%).
     */
     double  getGoodNbRayCastingAttemptsRatio(){ return ratioVisibleRay; }
-#endif
 
     bool          isAppearing(const unsigned int i){ return Lpol[i]->isAppearing(); }
 
@@ -186,6 +213,8 @@ class vpMbHiddenFaces
     bool          isVisibleOgre(const vpTranslationVector &cameraPos, const unsigned int &index);
 #endif
 
+    bool          isVisibleRayCasting(const vpTranslationVector &cameraPos, const unsigned int &index);
+
     //! operator[] as modifier.
     inline PolygonType*        operator[](const unsigned int i)   { return Lpol[i];}
     //! operator[] as reader.
@@ -204,6 +233,7 @@ class vpMbHiddenFaces
       \param w : Width of the background
     */
     void          setBackgroundSizeOgre(const unsigned int &h, const unsigned int &w) { ogreBackground = vpImage<unsigned char>(h, w, 0); }
+#endif
 
     /*!
       Set the number of rays that will be sent toward each polygon for visibility test.
@@ -223,6 +253,8 @@ class vpMbHiddenFaces
       \param ratio : Ratio of succesful attempts that has to be considered. Value has to be between 0.0 (0%) and 1.0 (100%).
     */
     void          setGoodNbRayCastingAttemptsRatio(const double &ratio) {ratioVisibleRay = ratio; if(ratioVisibleRay > 1.0) ratioVisibleRay = 1.0; if(ratioVisibleRay < 0.0) ratioVisibleRay = 0.0;}
+
+#ifdef VISP_HAVE_OGRE
     /*!
       Enable/Disable the appearance of Ogre config dialog on startup.
 
@@ -238,6 +270,18 @@ class vpMbHiddenFaces
     }
 #endif
 
+    /*!
+      Use a ray casting in a bounding volume hierarchy, computed on the CPU,
+      to test the occlusions in setVisible(). As with Ogre3D, the
+      polygons are visible from both sides, and a polygon is visible if
+      enough of the rays sent toward it are not cut by another polygon (see
+      setNbRayCastingAttemptsForVisibility() and
+      setGoodNbRayCastingAttemptsRatio()). setVisibleOgre() doesn't use it.
+
+      \param v : True to use it, False otherwise.
+    */
+    void          setRayCastingVisibilityTest(const bool &v) { useRayCasting = v; }
+
     unsigned int  setVisible(const vpImage<unsigned char>& I, const vpCameraParameters &cam, const vpHomogeneousMatrix &cMo, const double &angle, bool &changed);
     unsigned int  setVisible(const vpImage<unsigned char>& I, const vpCameraParameters &cam, const vpHomogeneousMatrix &cMo, const double &angleAppears, const double &angleDisappears, bool &changed);
     unsigned int  setVisible(const vpHomogeneousMatrix &cMo, const double &angleAppears, const double &angleDisappears, bool &changed);
@@ -259,12 +303,11 @@ class vpMbHiddenFaces
 */
 template<class PolygonType>
 vpMbHiddenFaces<PolygonType>::vpMbHiddenFaces()
-  : Lpol(), nbVisiblePolygon(0), scanlineRender()
+  : Lpol(), nbVisiblePolygon(0), scanlineRender(), nbRayAttempts(1), ratioVisibleRay(1.0), useRayCasting(false),
+    rayCaster(), rays(), rayVisibility(), rayVisibilityComputed(false)
 {
 #ifdef VISP_HAVE_OGRE
   ogreInitialised = false;
-  nbRayAttempts = 1;
-  ratioVisibleRay = 1.0;
   ogreShowConfigDialog = false;
   ogre = new vpAROgre();
   ogreBackground = vpImage<unsigned char>(480, 640, 0);
@@ -324,6 +367,10 @@ vpMbHiddenFaces<PolygonType>::addPolygon(PolygonType *p)
 
   for(unsigned int i = 0; i < p->nbpt; i++)
     p_new->p[i]= p->p[i];
+
+  std::vector<vpPoint> points(p->p, p->p + p->nbpt);
+  rayCaster.addPolygon(points, (unsigned int)Lpol.size());
+
   Lpol.push_back(p_new);
 }
 
@@ -343,6 +390,11 @@ vpMbHiddenFaces<PolygonType>::reset()
   }
   Lpol.resize(0);
 
+  nbRayAttempts = 1;
+  ratioVisibleRay = 1.0;
+  rayCaster.clear();
+  rayVisibilityComputed = false;
+
 #ifdef VISP_HAVE_OGRE
   if(ogre != NULL){
     delete ogre;
@@ -360,8 +412,6 @@ vpMbHiddenFaces<PolygonType>::reset()
   lOgrePolygons.resize(0);
 
   ogreInitialised = false;
-  nbRayAttempts = 1;
-  ratioVisibleRay = 1.0;
   ogre = new vpAROgre();
   ogreBackground = vpImage<unsigned char>(480, 640);
 #endif
@@ -474,12 +524,26 @@ vpMbHiddenFaces<PolygonType>::setVisiblePrivate(const vpHomogeneousMatrix &cMo,
     vpTRACE("ViSP doesn't have Ogre3D, simple visibility test used");
 #endif
   }
+  else if(useRayCasting){
+    // The rays of all the polygons are cast at once, by packets
+    cMo.inverse().extract(cameraPos);
+    computeRayCastingVisibility(cameraPos);
+  }
 
-  for (unsigned int i = 0; i < Lpol.size(); i++){
-    //std::cout << "Calling poly: " << i << std::endl;
-    if (computeVisibility(cMo, angleAppears, angleDisappears, changed, useOgre, not_used, I, cam, cameraPos, i))
-      nbVisiblePolygon ++;
+  // The visibility cast above is only valid for this pose: it must not be
+  // used by a later call to isVisibleRayCasting(), even if a face throws
+  try {
+    for (unsigned int i = 0; i < Lpol.size(); i++){
+      //std::cout << "Calling poly: " << i << std::endl;
+      if (computeVisibility(cMo, angleAppears, angleDisappears, changed, useOgre, not_used, I, cam, cameraPos, i))
+        nbVisiblePolygon ++;
+    }
+  }
+  catch(...) {
+    rayVisibilityComputed = false;
+    throw;
   }
+  rayVisibilityComputed = false;
   return nbVisiblePolygon;
 }
 
@@ -494,7 +558,7 @@ vpMbHiddenFaces<PolygonType>::setVisiblePrivate(const vpHomogeneousMatrix &cMo,
   \param not_used : Unused parameter.
   \param I : Image used to test if a face is entirely projected in the image.
   \param cam : Camera parameters.
-  \param cameraPos : Position of the camera. Used only when Ogre is used as 3rd party.
+  \param cameraPos : Position of the camera. Used only when Ogre or the CPU ray casting is used.
   \param index : Index of the face to consider.
 
   \return Return true if the face is visible.
@@ -537,6 +601,8 @@ vpMbHiddenFaces<PolygonType>::computeVisibility(const vpHomogeneousMatrix &cMo,
         testDisappear = (!Lpol[i]->isVisible(cMo, angleDisappears, false, cam, I));
       }
 #endif
+      else if(useRayCasting)
+        testDisappear = ((!Lpol[i]->isVisible(cMo, angleDisappears, true, cam, I)) || !isVisibleRayCasting(cameraPos,i));
       else
         testDisappear = (!Lpol[i]->isVisible(cMo, angleDisappears, false, cam, I));
     }
@@ -566,6 +632,8 @@ vpMbHiddenFaces<PolygonType>::computeVisibility(const vpHomogeneousMatrix &cMo,
 #else
         testAppear = (Lpol[i]->isVisible(cMo, angleAppears, false, cam, I));
 #endif
+      else if(useRayCasting)
+        testAppear = ((Lpol[i]->isVisible(cMo, angleAppears, true, cam, I)) && isVisibleRayCasting(cameraPos,i));
       else
         testAppear = (Lpol[i]->isVisible(cMo, angleAppears, false, cam, I));
     }
@@ -640,6 +708,127 @@ vpMbHiddenFaces<PolygonType>::setVisible(const vpHomogeneousMatrix &cMo, const d
   return setVisiblePrivate(cMo,angleAppears,angleDisappears,changed,false);
 }
 
+/*!
+  Append the rays sent toward a polygon. As with Ogre3D, each ray goes
+  toward a random weighted mean of the points of the polygon, or toward
+  their mean if only one ray is sent.
+
+  \param index : Index of the polygon.
+  \param raysToCast : Rays to which the rays of the polygon are appended.
+*/
+template<class PolygonType>
+void
+vpMbHiddenFaces<PolygonType>::addRays(const unsigned int &index, std::vector<vpMbRayCasterRay> &raysToCast)
+{
+  const unsigned int nbRays = (std::max)(nbRayAttempts, 1u);
+  for(unsigned int i = 0; i < nbRays; i++)
+  {
+    vpMbRayCasterRay ray;
+    ray.target[0] = ray.target[1] = ray.target[2] = 0.0;
+    ray.id = index;
+    ray.occluded = false;
+    double totalFactor = 0.0;
+
+    for(unsigned int j = 0 ; j < Lpol[index]->getNbPoint() ; j++)
+    {
+      double factor = 1.0;
+
+      if(nbRays > 1){
+        int r = rand() % 101;
+
+        if(r != 0)
+          factor = ((double)r)/100.0;
+      }
+
+      ray.target[0] += factor * Lpol[index]->getPoint(j).get_oX();
+      ray.target[1] += factor * Lpol[index]->getPoint(j).get_oY();
+      ray.target[2] += factor * Lpol[index]->getPoint(j).get_oZ();
+      totalFactor += factor;
+    }
+
+    if(totalFactor > 0.0){
+      ray.target[0] /= totalFactor;
+      ray.target[1] /= totalFactor;
+      ray.target[2] /= totalFactor;
+    }
+    raysToCast.push_back(ray);
+  }
+}
+
+/*!
+  Cast the rays of all the polygons for the pose given to setVisible(). The
+  hierarchy of the polygons is built at the first call after a change of the
+  model.
+
+  \param cameraPos : Position of the camera in the object frame.
+*/
+template<class PolygonType>
+void
+vpMbHiddenFaces<PolygonType>::computeRayCastingVisibility(const vpTranslationVector &cameraPos)
+{
+  if(!rayCaster.isBuilt())
+    rayCaster.build();
+
+  rays.clear();
+  for(unsigned int i = 0; i < Lpol.size(); i++)
+    addRays(i, rays);
+  rayCaster.castRays(cameraPos, rays);
+
+  const unsigned int nbRays = (std::max)(nbRayAttempts, 1u);
+  rayVisibility.resize(Lpol.size());
+  for(unsigned int i = 0; i < Lpol.size(); i++)
+    rayVisibility[i] = isVisibleRays(&rays[i*nbRays]) ? 1 : 0;
+  rayVisibilityComputed = true;
+}
+
+/*!
+  Apply the ratio of visible rays to the rays of a polygon.
+*/
+template<class PolygonType>
+bool
+vpMbHiddenFaces<PolygonType>::isVisibleRays(const vpMbRayCasterRay *raysOfPolygon) const
+{
+  const unsigned int nbRays = (std::max)(nbRayAttempts, 1u);
+  unsigned int nbVisible = 0;
+  for(unsigned int i = 0; i < nbRays; i++)
+    if(!raysOfPolygon[i].occluded)
+      nbVisible++;
+
+  return ((double)nbVisible)/((double)nbRays) > ratioVisibleRay ||
+         std::fabs(((double)nbVisible)/((double)nbRays) - ratioVisibleRay) < ratioVisibleRay * std::numeric_limits<double>::epsilon();
+}
+
+/*!
+  Test the visibility of a polygon via a ray casting computed on the CPU,
+  in a bounding volume hierarchy of the polygons. The rays go from the
+  optical center of the camera toward the polygon, and the polygon is
+  visible if enough of them are not cut by another polygon.
+
+  \sa setRayCastingVisibilityTest(), setNbRayCastingAttemptsForVisibility(), setGoodNbRayCastingAttemptsRatio()
+
+  \param cameraPos : Position of the camera in the object frame.
+  \param index : Index of the polygon.
+
+  \return Return true if the polygon is visible, False otherwise.
+*/
+template<class PolygonType>
+bool
+vpMbHiddenFaces<PolygonType>::isVisibleRayCasting(const vpTranslationVector &cameraPos, const unsigned int &index)
+{
+  // Already cast with the other polygons by setVisible()
+  if(rayVisibilityComputed && index < rayVisibility.size())
+    return rayVisibility[index] != 0;
+
+  if(!rayCaster.isBuilt())
+    rayCaster.build();
+
+  std::vector<vpMbRayCasterRay> raysOfPolygon;
+  addRays(index, raysOfPolygon);
+  rayCaster.castRays(cameraPos, raysOfPolygon);
+
+  return isVisibleRays(&raysOfPolygon[0]);
+}
+
 #ifdef VISP_HAVE_OGRE
 /*!
   Initialise the ogre context for face visibility tests.
@@ -263,11 +263,9 @@ public:
   virtual void setFarClippingDistance(const double &dist);
   virtual void setFarClippingDistance(const std::string &cameraName, const double &dist);
 
-#ifdef VISP_HAVE_OGRE
   void setGoodNbRayCastingAttemptsRatio(const double &ratio);
 
   void setNbRayCastingAttemptsForVisibility(const unsigned int &attempts);
-#endif
 
   virtual void setKltMaskBorder(const unsigned int &e);
 
@@ -305,6 +303,8 @@ public:
   virtual void setPose(const std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
       const std::map<std::string, vpHomogeneousMatrix> &mapOfCameraPoses);
 
+  virtual void setRayCastingVisibilityTest(const bool &v);
+
   virtual void setReferenceCameraName(const std::string &referenceCameraName);
 
   virtual void setScanLineVisibilityTest(const bool &v);
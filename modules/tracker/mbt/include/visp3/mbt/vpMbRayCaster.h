@@ -0,0 +1,140 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Occlusion test of the faces of a CAD model by ray casting in a bounding
+ * volume hierarchy.
+ *
+ *****************************************************************************/
+
+#ifndef vpMbRayCaster_HH
+#define vpMbRayCaster_HH
+
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpPoint.h>
+#include <visp3/core/vpTranslationVector.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  \struct vpMbRayCasterRay
+
+  \ingroup group_mbt_faces
+
+  Segment going from the optical center of the camera to a point of a face,
+  expressed in the object frame.
+*/
+struct vpMbRayCasterRay
+{
+  //! Point of the face reached by the ray
+  double target[3];
+  //! Index of the face, whose triangles are not tested against the ray
+  unsigned int id;
+  //! Result: true if a triangle of another face cuts the segment
+  bool occluded;
+};
+
+/*!
+  \class vpMbRayCaster
+
+  \ingroup group_mbt_faces
+
+  Occlusion test of the faces of a CAD model without Ogre3D. The faces are
+  cut into triangles (fans, the faces have to be convex) and stored in a
+  bounding volume hierarchy expressed in the object frame. The hierarchy is
+  thus built once for a model and doesn't depend on the pose: the rays start
+  from the position of the camera in the object frame.
+
+  The rays all start from the same point. They are cast by packets of four,
+  the intersections with the boxes of the hierarchy and with the triangles
+  (Moller-Trumbore) being computed for the four rays at once with SSE2 when
+  available. The packets are shared between the threads of vpThreadPool.
+ */
+class VISP_EXPORT vpMbRayCaster
+{
+public:
+  vpMbRayCaster();
+
+  void addPolygon(const std::vector<vpPoint> &points, unsigned int id);
+  void build();
+  void castRays(const vpTranslationVector &origin, std::vector<vpMbRayCasterRay> &rays) const;
+  void clear();
+
+  //! Return the number of threads used by castRays(), 0 meaning vpThreadPool::getNbThreads().
+  unsigned int getNbThreads() const { return nbThreads; }
+  //! Return the number of triangles of the scene.
+  unsigned int getNbTriangles() const { return (unsigned int) triangleIDs.size(); }
+  //! Return true if build() has been called since the last change of the scene.
+  bool isBuilt() const { return built; }
+
+  void setNbThreads(unsigned int nb);
+
+private:
+  //! Node of the hierarchy: a leaf if count > 0
+  struct vpMbRayCasterNode {
+    float bmin[3];
+    float bmax[3];
+    //! First triangle of a leaf, or index of the first child (the second one follows)
+    unsigned int first;
+    //! Number of triangles of a leaf, 0 for an internal node
+    unsigned int count;
+  };
+
+  struct vpMbRayCasterTask {
+    const vpMbRayCaster *caster;
+    float origin[3];
+    vpMbRayCasterRay *rays;
+    unsigned int nbRays;
+  };
+
+  void castPacket(const float origin[3], vpMbRayCasterRay *rays, unsigned int nb) const;
+  void split(unsigned int node, unsigned int first, unsigned int count);
+  static void castPackets(unsigned int begin, unsigned int end, void *args);
+
+  //! Number of threads used by castRays()
+  unsigned int nbThreads;
+  //! True if the hierarchy is up to date
+  bool built;
+  //! Nodes of the hierarchy, the root being the first one
+  std::vector<vpMbRayCasterNode> nodes;
+  //! First vertex and the two edges (v1 - v0, v2 - v0) of each triangle, 9 floats per triangle
+  std::vector<float> triangles;
+  //! Face of each triangle
+  std::vector<unsigned int> triangleIDs;
+  //! Centroids of the triangles, only used by build()
+  std::vector<float> centroids;
+  //! Order of the triangles, only used by build()
+  std::vector<unsigned int> order;
+};
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#endif
@@ -39,11 +39,8 @@
 #define vpMbScanLine_HH
 
 #include <vector>
-#include <list>
-#include <deque>
-#include <set>
-#include <map>
 #include <limits>   // numeric_limits
+#include <utility>
 
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpCameraParameters.h>
@@ -65,6 +62,10 @@
 
   \ingroup group_mbt_faces
 
+  Visibility of the edges of a scene of polygons computed with Y-axis and
+  X-axis scanlines. The buffers (scanline intersections, active polygons,
+  visibility samples, masks) are kept from one call of drawScene() to the
+  other, and the scanlines are processed in parallel with vpThreadPool.
  */
 class VISP_EXPORT vpMbScanLine
 {
@@ -78,14 +79,18 @@ public:
   } vpMbScanLineType;
 
   //! Structure to define a scanline edge (basically a pair of (X,Y,Z) vectors).
-  typedef std::pair<vpColVector, vpColVector> vpMbScanLineEdge;
+  struct vpMbScanLineEdge
+  {
+    double first[3];
+    double second[3];
+  };
 
   //! Structure to define a scanline intersection.
   struct vpMbScanLineSegment
   {
-    vpMbScanLineSegment() : type(START), edge(), p(0), P1(0), P2(0), Z1(0), Z2(0), ID(0), b_sample_Y(false) {}
+    vpMbScanLineSegment() : type(START), edge(0), p(0), P1(0), P2(0), Z1(0), Z2(0), ID(0), b_sample_Y(false) {}
     vpMbScanLineType type;
-    vpMbScanLineEdge edge;
+    unsigned int edge; // Index of the edge in the list of the edges of the scene.
     double p; // This value can be either x or y-coordinate value depending if the structure is used in X or Y-axis scanlines computation.
     double P1, P2; // Same comment as previous value.
     double Z1, Z2;
@@ -93,6 +98,15 @@ public:
     bool b_sample_Y;
   };
 
+  //! Structure to define the intersection of a polygon with a scanline, before it is paired with the next one.
+  struct vpMbScanLineIntersection
+  {
+    vpMbScanLineIntersection() : scanline(0), order(0), s() {}
+    unsigned int scanline; // Index of the scanline, the Y-axis scanlines being first.
+    unsigned int order; // Order of computation, used to sort the intersections as a stable sort would.
+    vpMbScanLineSegment s;
+  };
+
   //! vpMbScanLineEdge Comparator.
   struct vpMbScanLineEdgeComparator
   {
@@ -110,6 +124,12 @@ public:
           return false;
       return false;
     }
+
+    inline bool operator()(const std::pair<vpMbScanLineEdge, unsigned int> &l0,
+                           const std::pair<vpMbScanLineEdge, unsigned int> &l1) const
+    {
+      return (*this)(l0.first, l1.first);
+    }
   };
 
   //! vpMbScanLineSegment Comparators.
@@ -121,20 +141,49 @@ public:
       return (std::fabs(a.p - b.p) <= std::numeric_limits<double>::epsilon()) ? a.type < b.type : a.p < b.p;
     }
 
+    //! Order of the active polygons by depth, the polygons at the same depth being ordered by ID
     inline bool operator()(const std::pair<double,vpMbScanLineSegment> &a, const std::pair<double, vpMbScanLineSegment> &b) const
     {
-      return a.first < b.first;
+      return a.first < b.first || (a.first == b.first && a.second.ID < b.second.ID);
+    }
+
+    inline bool operator()(const vpMbScanLineIntersection &a, const vpMbScanLineIntersection &b) const
+    {
+      if (a.scanline != b.scanline)
+        return a.scanline < b.scanline;
+      if ((*this)(a.s, b.s))
+        return true;
+      if ((*this)(b.s, a.s))
+        return false;
+      return a.order < b.order;
     }
   };
 
 private:
+  //! Buffers of a scanline, kept from one frame to the other.
+  struct vpMbScanLineBuffer
+  {
+    std::vector<vpMbScanLineSegment> segments;
+    std::vector<std::pair<double, vpMbScanLineSegment> > stack;
+    std::vector<unsigned int> samples; // Edges visible on the scanline.
+  };
+
   unsigned int            w, h;
   vpCameraParameters      K;
   unsigned int            maskBorder;
   vpImage<unsigned char>  mask;
+  vpImage<unsigned char>  maskX, maskY;
   vpImage<int>            primitive_ids;
-  std::map<vpMbScanLineEdge, std::set<int>, vpMbScanLineEdgeComparator> visibility_samples;
   double                  depthTreshold;
+  unsigned int            nbThreads;
+  std::vector<vpMbScanLineBuffer> scanlines; // h Y-axis scanlines followed by w X-axis scanlines.
+  std::vector<vpMbScanLineIntersection> localScanlines; // Intersections of the polygon being drawn.
+  std::vector<double>     points; // Projections of the points of the polygon being drawn.
+  std::vector<vpMbScanLineEdge> edges; // Edges of the scene, several polygons can share an edge.
+  std::vector<unsigned int> edgeIDs; // Index in uniqueEdges of each edge.
+  std::vector<std::pair<vpMbScanLineEdge, unsigned int> > sortedEdges;
+  std::vector<vpMbScanLineEdge> uniqueEdges; // Sorted edges without duplicate.
+  std::vector<std::pair<unsigned int, int> > visibility_samples; // Sorted (unique edge, scanline) visible samples.
 
 public:
 #if defined(DEBUG_DISP)
@@ -147,7 +196,7 @@ public:
   ~vpMbScanLine();
 
   void drawScene(const std::vector<std::vector<std::pair<vpPoint, unsigned int> > * > &polygons,
-                 std::vector<int> listPolyIndices,
+                 const std::vector<int> &listPolyIndices,
                  const vpCameraParameters &K, unsigned int w, unsigned int h);
 
   /*!
@@ -158,6 +207,10 @@ public:
   */
   double                        getDepthTreshold() { return depthTreshold; }
   unsigned int                  getMaskBorder() { return maskBorder; }
+  /*!
+    Return the number of threads used by drawScene() to process the scanlines, 0 meaning vpThreadPool::getNbThreads().
+  */
+  unsigned int                  getNbThreads() const { return nbThreads; }
   const vpImage<unsigned char>& getMask() const  { return mask; }
   const vpImage<int>&           getPrimitiveIDs() const  { return primitive_ids; }
 
@@ -173,36 +226,42 @@ public:
   */
   void                          setDepthTreshold(const double &treshold) { depthTreshold = treshold; }
   void                          setMaskBorder(const unsigned int &mb){ maskBorder = mb; }
+  /*!
+    Set the number of threads used by drawScene() to process the scanlines.
+
+    \param nb_threads : Number of threads, including the calling thread. 0, the default, uses
+    vpThreadPool::getNbThreads() threads.
+  */
+  void                          setNbThreads(const unsigned int nb_threads) { nbThreads = nb_threads; }
 
 
 private:
-  void createScanLinesFromLocals(std::vector<std::vector<vpMbScanLineSegment> > &scanlines,
-                                 std::vector<std::vector<vpMbScanLineSegment> > &localScanlines,
-                                 const unsigned int &size);
-
-  void drawLineY(const vpColVector &a,
-                 const vpColVector &b,
-                 const vpMbScanLineEdge &line_ID,
-                 const int ID,
-                 std::vector<std::vector<vpMbScanLineSegment> > &scanlines);
-
-  void drawLineX(const vpColVector &a,
-                 const vpColVector &b,
-                 const vpMbScanLineEdge &line_ID,
-                 const int ID,
-                 std::vector<std::vector<vpMbScanLineSegment> > &scanlines);
-
-  void drawPolygonY(const std::vector<std::pair<vpPoint, unsigned int> > &polygon,
-                    const int ID,
-                    std::vector<std::vector<vpMbScanLineSegment> > &scanlines);
-
-  void drawPolygonX(const std::vector<std::pair<vpPoint, unsigned int> > &polygon,
-                    const int ID,
-                    std::vector<std::vector<vpMbScanLineSegment> > &scanlines);
+  void computeScanLine(const unsigned int index);
+
+  void createScanLinesFromLocals();
+
+  void drawLineY(const double *a,
+                 const double *b,
+                 const unsigned int edge,
+                 const int ID);
+
+  void drawLineX(const double *a,
+                 const double *b,
+                 const unsigned int edge,
+                 const int ID);
+
+  void drawPolygonY(const unsigned int nbPoints,
+                    const unsigned int firstEdge,
+                    const int ID);
+
+  void drawPolygonX(const unsigned int nbPoints,
+                    const unsigned int firstEdge,
+                    const int ID);
 
   // Static functions
+  static void             computeScanLines(unsigned int begin, unsigned int end, void *args);
   static vpMbScanLineEdge makeMbScanLineEdge(const vpPoint &a, const vpPoint &b);
-  static void             createVectorFromPoint(const vpPoint &p, vpColVector &v, const vpCameraParameters &K);
+  static void             createVectorFromPoint(const vpPoint &p, double *v, const vpCameraParameters &K);
   static double           getAlpha(double x, double X0, double Z0, double X1, double Z1);
   static double           mix(double a, double b, double alpha);
   static vpPoint          mix(const vpPoint &a, const vpPoint &b, double alpha);
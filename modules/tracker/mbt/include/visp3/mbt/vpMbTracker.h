@@ -504,13 +504,22 @@ public:
   */
   virtual void setProjectionErrorComputation(const bool &flag) { computeProjError = flag; }
 
+  /*!
+    Use a ray casting computed on the CPU, in a bounding volume hierarchy of the faces,
+    for visibility tests. It is an alternative to setOgreVisibilityTest() that doesn't need
+    Ogre3D and that uses the same setNbRayCastingAttemptsForVisibility() and
+    setGoodNbRayCastingAttemptsRatio() settings. Ogre3D is used when both are enabled.
+
+    \param v : True to use it, False otherwise
+  */
+  virtual void setRayCastingVisibilityTest(const bool &v) { faces.setRayCastingVisibilityTest(v); }
+
   virtual void setScanLineVisibilityTest(const bool &v){ useScanLine = v; }
 
   virtual void setOgreVisibilityTest(const bool &v);
 
   void savePose(const std::string &filename) const;
 
-#ifdef VISP_HAVE_OGRE
   /*!
     Set the ratio of visibility attempts that has to be successful to consider a polygon as visible.
 
@@ -532,7 +541,6 @@ public:
   void setNbRayCastingAttemptsForVisibility(const unsigned int &attempts) {
     faces.setNbRayCastingAttemptsForVisibility(attempts);
   }
-#endif
 
   /*!
     Enable/Disable the appearance of Ogre config dialog on startup.
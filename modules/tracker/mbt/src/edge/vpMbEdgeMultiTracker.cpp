@@ -2191,7 +2191,6 @@ void vpMbEdgeMultiTracker::setGoodMovingEdgesRatioThreshold(const double thresho
   percentageGdPt = threshold;
 }
 
-#ifdef VISP_HAVE_OGRE
 /*!
   Set the ratio of visibility attempts that has to be successful to consider a polygon as visible.
 
@@ -2220,7 +2219,6 @@ void vpMbEdgeMultiTracker::setGoodMovingEdgesRatioThreshold(const double thresho
       it->second->setNbRayCastingAttemptsForVisibility(attempts);
     }
   }
-#endif
 
   /*!
     Set the flag to consider if the level of detail (LOD) is used for all the cameras.
@@ -2660,6 +2658,22 @@ void vpMbEdgeMultiTracker::setScales(const std::vector<bool>& scale) {
   }
 }
 
+/*!
+  Use a ray casting computed on the CPU for visibility tests, as an alternative to Ogre3D.
+
+  \param v : True to use it, False otherwise
+
+  \sa vpMbTracker::setRayCastingVisibilityTest()
+*/
+void vpMbEdgeMultiTracker::setRayCastingVisibilityTest(const bool &v) {
+  vpMbTracker::setRayCastingVisibilityTest(v);
+
+  for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
+      it != m_mapOfEdgeTrackers.end(); ++it) {
+    it->second->setRayCastingVisibilityTest(v);
+  }
+}
+
 /*!
   Use Scanline algorithm for visibility tests
 
@@ -55,12 +55,170 @@
 #include <visp3/mbt/vpMbtXmlParser.h>
 #include <visp3/core/vpPolygon3D.h>
 #include <visp3/core/vpVelocityTwistMatrix.h>
+#include <visp3/core/vpTime.h>
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+#  include <visp3/core/vpThreadPool.h>
+#  include <visp3/core/vpMutex.h>
+#endif
 
 #include <limits>
 #include <string>
 #include <sstream>
 #include <float.h>
 #include <map>
+#include <algorithm>
+
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  /*
+    A model primitive whose moving edges have to be tracked or updated.
+    Exactly one of the pointers is set.
+  */
+  struct vpMovingEdgeTask
+  {
+    vpMovingEdgeTask()
+      : line(NULL), cylinder(NULL), circle(NULL), cost(0) {}
+
+    vpMbtDistanceLine *line;
+    vpMbtDistanceCylinder *cylinder;
+    vpMbtDistanceCircle *circle;
+    //! Estimated workload, i.e. the number of moving edges of the primitive
+    unsigned int cost;
+  };
+
+  bool isMoreCostly(const vpMovingEdgeTask &a, const vpMovingEdgeTask &b)
+  {
+    return a.cost > b.cost;
+  }
+
+  /*
+    Process the moving edges of one primitive. This is the body of the loops of
+    vpMbEdgeTracker::trackMovingEdge() and vpMbEdgeTracker::updateMovingEdge().
+  */
+  void processMovingEdgeTask(const vpMovingEdgeTask &task, const vpImage<unsigned char> &I,
+                             const vpHomogeneousMatrix &cMo, const bool update)
+  {
+    if (task.line != NULL) {
+      vpMbtDistanceLine *l = task.line;
+      if (update) {
+        l->updateMovingEdge(I, cMo);
+        if (l->nbFeatureTotal == 0 && l->isVisible()){
+          l->Reinit = true;
+        }
+      }
+      else {
+        if(l->meline.size() == 0){
+          l->initMovingEdge(I, cMo);
+        }
+        l->trackMovingEdge(I, cMo);
+      }
+    }
+    else if (task.cylinder != NULL) {
+      vpMbtDistanceCylinder *cy = task.cylinder;
+      if (update) {
+        cy->updateMovingEdge(I, cMo);
+        if((cy->nbFeaturel1 == 0 || cy->nbFeaturel2 == 0) && cy->isVisible()){
+          cy->Reinit = true;
+        }
+      }
+      else {
+        if(cy->meline1 == NULL || cy->meline2 == NULL){
+          cy->initMovingEdge(I, cMo);
+        }
+        cy->trackMovingEdge(I, cMo);
+      }
+    }
+    else if (task.circle != NULL) {
+      vpMbtDistanceCircle *ci = task.circle;
+      if (update) {
+        ci->updateMovingEdge(I, cMo);
+        if(ci->nbFeature == 0  && ci->isVisible()){
+          ci->Reinit = true;
+        }
+      }
+      else {
+        if(ci->meEllipse == NULL){
+          ci->initMovingEdge(I, cMo);
+        }
+        ci->trackMovingEdge(I, cMo);
+      }
+    }
+  }
+
+  /*
+    Loop body run by vpThreadPool::parallel_for() over the task indices. The
+    work stealing of the pool balances the load dynamically between the
+    threads.
+  */
+  class vpMovingEdgeWorker
+  {
+  public:
+    vpMovingEdgeWorker(const std::vector<vpMovingEdgeTask> &tasks, const vpImage<unsigned char> &I,
+                       const vpHomogeneousMatrix &cMo, const bool update)
+      : m_tasks(tasks), m_I(I), m_cMo(cMo), m_update(update), m_mutex(),
+        m_failed(false), m_failedTask(0), m_isTrackingException(false),
+        m_exception(vpException::fatalError, "")
+    {
+    }
+
+    void operator()(unsigned int begin, unsigned int end) const
+    {
+      for (unsigned int index = begin; index < end; index++) {
+        try {
+          processMovingEdgeTask(m_tasks[index], m_I, m_cMo, m_update);
+        }
+        catch(vpTrackingException &e) {
+          setException(index, e, true);
+        }
+        catch(vpException &e) {
+          setException(index, e, false);
+        }
+        catch(...) {
+          setException(index, vpException(vpException::fatalError, "Unknown exception in moving edge tracking"), false);
+        }
+      }
+    }
+
+    /*
+      Rethrow the exception raised by the first task (in the task order) that
+      failed, as the sequential implementation would have done.
+    */
+    void rethrow()
+    {
+      if (! m_failed)
+        return;
+
+      if (m_isTrackingException)
+        throw vpTrackingException(m_exception.getCode(), m_exception.getStringMessage());
+      throw m_exception;
+    }
+
+  private:
+    void setException(const size_t index, const vpException &e, const bool isTrackingException) const
+    {
+      vpMutex::vpScopedLock lock(m_mutex);
+      if (! m_failed || index < m_failedTask) {
+        m_failed = true;
+        m_failedTask = index;
+        m_isTrackingException = isTrackingException;
+        m_exception = e;
+      }
+    }
+
+    const std::vector<vpMovingEdgeTask> &m_tasks;
+    const vpImage<unsigned char> &m_I;
+    const vpHomogeneousMatrix &m_cMo;
+    const bool m_update;
+    mutable vpMutex m_mutex;
+    mutable bool m_failed;
+    mutable size_t m_failedTask;
+    mutable bool m_isTrackingException;
+    mutable vpException m_exception;
+  };
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+#endif
 
 
 /*!
@@ -69,10 +227,11 @@
 vpMbEdgeTracker::vpMbEdgeTracker()
   : me(), lines(1), circles(1), cylinders(1), nline(0), ncircle(0), ncylinder(0),
     nbvisiblepolygone(0), percentageGdPt(0.4), scales(1),
-    Ipyramid(0), scaleLevel(0), nbFeaturesForProjErrorComputation(0),
+    Ipyramid(0), m_pyramid(1, vpImagePyramid::SUBSAMPLING), scaleLevel(0), nbFeaturesForProjErrorComputation(0),
     m_factor(), m_robustLines(), m_robustCylinders(), m_robustCircles(),
     m_wLines(), m_wCylinders(), m_wCircles(), m_errorLines(), m_errorCylinders(), m_errorCircles(),
-    m_L_edge(), m_error_edge(), m_w_edge(), m_weightedError_edge(), m_robust_edge()
+    m_L_edge(), m_error_edge(), m_w_edge(), m_weightedError_edge(), m_robust_edge(),
+    m_nbMovingEdgeThreads(1), m_trackMovingEdgeTime(0), m_computeVVSTime(0), m_updateMovingEdgeTime(0)
 {
   angleAppears = vpMath::rad(89);
   angleDisappears = vpMath::rad(89);
@@ -1033,13 +1192,79 @@ vpMbEdgeTracker::testTracking()
   Compute each state of the tracking procedure for all the feature sets.
   
   If the tracking is considered as failed an exception is thrown.
+
+  The subsampled images of the scales used by the tracker are stored in a
+  pyramid kept from one call to the next, so that no image is allocated
+  while the image size does not change.
   
   \param I : The image.
+
+  \sa track(const vpImagePyramid &)
  */
 void
 vpMbEdgeTracker::track(const vpImage<unsigned char> &I)
-{ 
-  initPyramid(I, Ipyramid);
+{
+  m_pyramid.setNbLevels((unsigned int)scales.size());
+  m_pyramid.build(I);
+
+  track(m_pyramid);
+}
+
+/*!
+  Compute each state of the tracking procedure for all the feature sets,
+  using the images of a pyramid built by the caller. This allows to share
+  the same pyramid between several trackers working on the same frame.
+
+  The level \e i of the pyramid is used for the scale \e i of the tracker
+  (see setScales()). With a vpImagePyramid::SUBSAMPLING pyramid the result
+  is the same as with track(const vpImage<unsigned char> &); with a
+  vpImagePyramid::GAUSSIAN_FILTER pyramid the moving edges of the coarse
+  scales are tracked in smoothed images.
+
+  If the tracking is considered as failed an exception is thrown.
+
+  \param pyramid : Pyramid of the current image. It must be built and have
+  at least as many levels as the number of scales of the tracker.
+
+  \exception vpTrackingException::fatalError : If the pyramid has not enough
+  levels.
+ */
+void
+vpMbEdgeTracker::track(const vpImagePyramid &pyramid)
+{
+  if (pyramid.getNbLevels() < scales.size()) {
+    throw vpTrackingException(vpTrackingException::fatalError,
+                              "The image pyramid has less levels than the tracker scales");
+  }
+
+  // The images of the pyramid are not owned: Ipyramid is emptied instead of
+  // being cleaned by cleanPyramid()
+  Ipyramid.resize(scales.size());
+  for (unsigned int i = 0; i < Ipyramid.size(); i++) {
+    Ipyramid[i] = scales[i] ? &pyramid[i] : NULL;
+  }
+
+  try {
+    trackPyramid(pyramid[0]);
+  }
+  catch(...) {
+    Ipyramid.resize(0);
+    throw;
+  }
+  Ipyramid.resize(0);
+}
+
+/*!
+  Track the model in the images of the Ipyramid attribute.
+
+  \param I : The image of the first level of the pyramid.
+ */
+void
+vpMbEdgeTracker::trackPyramid(const vpImage<unsigned char> &I)
+{
+  m_trackMovingEdgeTime = 0;
+  m_computeVVSTime = 0;
+  m_updateMovingEdgeTime = 0;
   
 //  for (int lvl = ((int)scales.size()-1); lvl >= 0; lvl -= 1)
   unsigned int lvl = (unsigned int)scales.size();
@@ -1054,6 +1279,7 @@ vpMbEdgeTracker::track(const vpImage<unsigned char> &I)
       {
         downScale(lvl);
 
+        double t = vpTime::measureTimeMs();
         try
         {  
           trackMovingEdge(*Ipyramid[lvl]);
@@ -1063,6 +1289,7 @@ vpMbEdgeTracker::track(const vpImage<unsigned char> &I)
           vpTRACE("Error in moving edge tracking");
           throw;
         }
+        m_trackMovingEdgeTime += vpTime::measureTimeMs() - t;
 
         // initialize the vector that contains the error and the matrix that contains
         // the interaction matrix
@@ -1090,6 +1317,7 @@ vpMbEdgeTracker::track(const vpImage<unsigned char> &I)
         }
         */
 
+        t = vpTime::measureTimeMs();
         try
         {
           computeVVS(*Ipyramid[lvl], lvl);
@@ -1099,6 +1327,7 @@ vpMbEdgeTracker::track(const vpImage<unsigned char> &I)
           covarianceMatrix = -1;
           throw; // throw the original exception
         }
+        m_computeVVSTime += vpTime::measureTimeMs() - t;
 
         testTracking();
 
@@ -1117,7 +1346,9 @@ vpMbEdgeTracker::track(const vpImage<unsigned char> &I)
           faces.computeScanLineRender(cam, I.getWidth(), I.getHeight());
         }
 
+        t = vpTime::measureTimeMs();
         updateMovingEdge(I);
+        m_updateMovingEdgeTime += vpTime::measureTimeMs() - t;
 
         initMovingEdge(I,cMo);
         // Reinit the moving edge for the lines which need it.
@@ -1142,8 +1373,6 @@ vpMbEdgeTracker::track(const vpImage<unsigned char> &I)
       }
     }
   } while(lvl != 0);
-  
-  cleanPyramid(Ipyramid);
 }
 
 /*!
@@ -1570,6 +1799,13 @@ vpMbEdgeTracker::initMovingEdge(const vpImage<unsigned char> &I, const vpHomogen
 void
 vpMbEdgeTracker::trackMovingEdge(const vpImage<unsigned char> &I)
 {
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+  if (m_nbMovingEdgeThreads > 1) {
+    processMovingEdgesInParallel(I, false);
+    return;
+  }
+#endif
+
   for(std::list<vpMbtDistanceLine*>::const_iterator it=lines[scaleLevel].begin(); it!=lines[scaleLevel].end(); ++it){
     vpMbtDistanceLine *l = *it;
     if(l->isVisible() && l->isTracked()){
@@ -1610,6 +1846,13 @@ vpMbEdgeTracker::trackMovingEdge(const vpImage<unsigned char> &I)
 void
 vpMbEdgeTracker::updateMovingEdge(const vpImage<unsigned char> &I)
 {
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+  if (m_nbMovingEdgeThreads > 1) {
+    processMovingEdgesInParallel(I, true);
+    return;
+  }
+#endif
+
   vpMbtDistanceLine *l;
   for(std::list<vpMbtDistanceLine*>::const_iterator it=lines[scaleLevel].begin(); it!=lines[scaleLevel].end(); ++it){
     if((*it)->isTracked()){
@@ -1644,6 +1887,85 @@ vpMbEdgeTracker::updateMovingEdge(const vpImage<unsigned char> &I)
   }
 }
 
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+/*!
+  Track or update the moving edges of the primitives of the current scale
+  level using getNbMovingEdgeThreads() threads, the calling thread included.
+
+  The primitives are sorted by decreasing number of moving edges and handed out
+  one at a time to the first idle thread. Since each primitive owns its moving
+  edges, the result is the same as the sequential processing.
+
+  \param I : the image.
+  \param update : If true, call updateMovingEdge() on the tracked primitives,
+  otherwise call trackMovingEdge() on the visible and tracked primitives.
+*/
+void
+vpMbEdgeTracker::processMovingEdgesInParallel(const vpImage<unsigned char> &I, const bool update)
+{
+  std::vector<vpMovingEdgeTask> tasks;
+  tasks.reserve(lines[scaleLevel].size() + cylinders[scaleLevel].size() + circles[scaleLevel].size());
+
+  for(std::list<vpMbtDistanceLine*>::const_iterator it=lines[scaleLevel].begin(); it!=lines[scaleLevel].end(); ++it){
+    vpMbtDistanceLine *l = *it;
+    if(l->isTracked() && (update || l->isVisible())){
+      vpMovingEdgeTask task;
+      task.line = l;
+      task.cost = l->nbFeatureTotal;
+      tasks.push_back(task);
+    }
+  }
+
+  for(std::list<vpMbtDistanceCylinder*>::const_iterator it=cylinders[scaleLevel].begin(); it!=cylinders[scaleLevel].end(); ++it){
+    vpMbtDistanceCylinder *cy = *it;
+    if(cy->isTracked() && (update || cy->isVisible())){
+      vpMovingEdgeTask task;
+      task.cylinder = cy;
+      task.cost = cy->nbFeature;
+      tasks.push_back(task);
+    }
+  }
+
+  for(std::list<vpMbtDistanceCircle*>::const_iterator it=circles[scaleLevel].begin(); it!=circles[scaleLevel].end(); ++it){
+    vpMbtDistanceCircle *ci = *it;
+    if(ci->isTracked() && (update || ci->isVisible())){
+      vpMovingEdgeTask task;
+      task.circle = ci;
+      task.cost = ci->nbFeature;
+      tasks.push_back(task);
+    }
+  }
+
+  // Longest primitives first to limit the time the last thread runs alone
+  std::stable_sort(tasks.begin(), tasks.end(), isMoreCostly);
+
+  vpMovingEdgeWorker worker(tasks, I, cMo, update);
+
+  // The calling thread takes its share of the work
+  vpThreadPool::parallel_for(0, (unsigned int)tasks.size(), worker, m_nbMovingEdgeThreads);
+
+  worker.rethrow();
+}
+#endif
+
+/*!
+  Get the time spent in the main steps of the last call to track(), summed over
+  the pyramid levels.
+
+  \param trackMovingEdgeTime : Time in ms spent to track the moving edges.
+  \param computeVVSTime : Time in ms spent in the virtual visual servoing that estimates the pose.
+  \param updateMovingEdgeTime : Time in ms spent to update the moving edges once the pose is estimated.
+
+  \sa setNbMovingEdgeThreads()
+*/
+void
+vpMbEdgeTracker::getTrackingTimes(double &trackMovingEdgeTime, double &computeVVSTime, double &updateMovingEdgeTime) const
+{
+  trackMovingEdgeTime = m_trackMovingEdgeTime;
+  computeVVSTime = m_computeVVSTime;
+  updateMovingEdgeTime = m_updateMovingEdgeTime;
+}
+
 void
 vpMbEdgeTracker::updateMovingEdgeWeights() {
   unsigned int n = 0;
@@ -1596,7 +1596,6 @@ void vpMbEdgeKltMultiTracker::setFarClippingDistance(const std::string &cameraNa
   vpMbKltMultiTracker::setFarClippingDistance(cameraName, dist);
 }
 
-#ifdef VISP_HAVE_OGRE
 /*!
   Set the ratio of visibility attempts that has to be successful to consider a polygon as visible.
 
@@ -1621,7 +1620,6 @@ void vpMbEdgeKltMultiTracker::setFarClippingDistance(const std::string &cameraNa
     vpMbEdgeMultiTracker::setNbRayCastingAttemptsForVisibility(attempts);
     vpMbKltMultiTracker::setNbRayCastingAttemptsForVisibility(attempts);
   }
-#endif
 
 /*!
   Set the flag to consider if the level of detail (LOD) is used for all the cameras.
@@ -1888,6 +1886,18 @@ void vpMbEdgeKltMultiTracker::setReferenceCameraName(const std::string &referenc
   m_referenceCameraName = referenceCameraName;
 }
 
+/*!
+  Use a ray casting computed on the CPU for visibility tests, as an alternative to Ogre3D.
+
+  \param v : True to use it, False otherwise
+
+  \sa vpMbTracker::setRayCastingVisibilityTest()
+*/
+void vpMbEdgeKltMultiTracker::setRayCastingVisibilityTest(const bool &v) {
+  vpMbEdgeMultiTracker::setRayCastingVisibilityTest(v);
+  vpMbKltMultiTracker::setRayCastingVisibilityTest(v);
+}
+
 /*!
   Use Scanline algorithm for visibility tests
 
@@ -2069,7 +2069,6 @@ void vpMbKltMultiTracker::setFarClippingDistance(const std::string &cameraName,
   }
 }
 
-#ifdef VISP_HAVE_OGRE
 /*!
   Set the ratio of visibility attempts that has to be successful to consider a polygon as visible.
 
@@ -2098,7 +2097,6 @@ void vpMbKltMultiTracker::setFarClippingDistance(const std::string &cameraName,
       it->second->setNbRayCastingAttemptsForVisibility(attempts);
     }
   }
-#endif
 
   /*!
     Set the new value of the klt tracker.
@@ -2495,6 +2493,22 @@ void vpMbKltMultiTracker::setReferenceCameraName(const std::string &referenceCam
   }
 }
 
+/*!
+  Use a ray casting computed on the CPU for visibility tests, as an alternative to Ogre3D.
+
+  \param v : True to use it, False otherwise
+
+  \sa vpMbTracker::setRayCastingVisibilityTest()
+*/
+void vpMbKltMultiTracker::setRayCastingVisibilityTest(const bool &v) {
+  vpMbTracker::setRayCastingVisibilityTest(v);
+
+  for(std::map<std::string, vpMbKltTracker *>::const_iterator it = m_mapOfKltTrackers.begin();
+      it != m_mapOfKltTrackers.end(); ++it) {
+    it->second->setRayCastingVisibilityTest(v);
+  }
+}
+
 /*!
   Use Scanline algorithm for visibility tests
 
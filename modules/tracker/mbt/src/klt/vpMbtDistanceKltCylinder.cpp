@@ -121,6 +121,20 @@ vpMbtDistanceKltCylinder::init(const vpKltOpencv& _tracker, const vpHomogeneousM
   curPoints = std::map<int, vpImagePoint>();
   curPointsInd = std::map<int, int>();
 
+  // The image polygons of the faces do not change from one feature to the other
+  std::vector<vpPolygon> roiPolygons;
+  if(!useScanLine)
+  {
+    std::vector<vpImagePoint> roi;
+    roiPolygons.resize(listIndicesCylinderBBox.size());
+    for(unsigned int kc = 0 ; kc < listIndicesCylinderBBox.size() ; kc++)
+    {
+      hiddenface->getPolygon()[(size_t) listIndicesCylinderBBox[kc]]->getRoiClipped(cam, roi);
+      roiPolygons[kc].buildFrom(roi);
+      roi.clear();
+    }
+  }
+
   for (unsigned int i = 0; i < static_cast<unsigned int>(_tracker.getNbFeatures()); i ++){
     long id;
     float x_tmp, y_tmp;
@@ -143,16 +157,13 @@ vpMbtDistanceKltCylinder::init(const vpKltOpencv& _tracker, const vpHomogeneousM
     }
     else
     {
-      std::vector<vpImagePoint> roi;
-      for(unsigned int kc = 0 ; kc < listIndicesCylinderBBox.size() ; kc++)
+      for(unsigned int kc = 0 ; kc < roiPolygons.size() ; kc++)
       {
-        hiddenface->getPolygon()[(size_t) listIndicesCylinderBBox[kc]]->getRoiClipped(cam, roi);
-        if(vpPolygon::isInside(roi, y_tmp, x_tmp))
+        if(roiPolygons[kc].isInside(vpImagePoint(y_tmp, x_tmp)))
         {
           add = true;
           break;
         }
-        roi.clear();
       }
     }
 
@@ -376,6 +387,9 @@ vpMbtDistanceKltCylinder::isTrackedFeature(const int _id)
   \param mask : the mask to update (0, not in the object, _nb otherwise).
   \param nb : Optionnal value to set to the pixels included in the face.
   \param shiftBorder : Optionnal shift for the border in pixel (sort of built-in erosion) to avoid to consider pixels near the limits of the face.
+
+  The pixels of each visible face of the cylinder bounding box are set row by
+  row with vpPolygon::fill().
 */
 void
 vpMbtDistanceKltCylinder::updateMask(
@@ -386,25 +400,18 @@ vpMbtDistanceKltCylinder::updateMask(
 #endif
     unsigned char nb, unsigned int shiftBorder)
 {
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
-  int width  = mask.cols;
-  int height = mask.rows;
-#else
-  int width  = mask->width;
-  int height = mask->height;
-#endif
-
   for(unsigned int kc = 0 ; kc < listIndicesCylinderBBox.size() ; kc++)
   {
       if((*hiddenface)[(unsigned int) listIndicesCylinderBBox[kc]]->isVisible() &&
           (*hiddenface)[(unsigned int) listIndicesCylinderBBox[kc]]->getNbPoint() > 2)
       {
-          int i_min, i_max, j_min, j_max;
           std::vector<vpImagePoint> roi;
           (*hiddenface)[(unsigned int) listIndicesCylinderBBox[kc]]->getRoiClipped(cam, roi);
+          if (roi.size() < 3)
+            continue;
 
-          double shiftBorder_d = (double) shiftBorder;
         #if defined (VISP_HAVE_CLIPPER)
+          double shiftBorder_d = (double) shiftBorder;
           std::vector<vpImagePoint> roi_offset;
 
           ClipperLib::Path path;
@@ -447,89 +454,20 @@ vpMbtDistanceKltCylinder::updateMask(
             roi_offset = roi;
           }
 
-          vpPolygon polygon_test(roi_offset);
-          vpImagePoint imPt;
-        #endif
-
-        #if defined (VISP_HAVE_CLIPPER)
-          vpPolygon3D::getMinMaxRoi(roi_offset, i_min, i_max, j_min,j_max);
+          // The border is already removed by the offset
+          vpPolygon polygon_mask(roi_offset);
+          unsigned int border = 0;
         #else
-          vpPolygon3D::getMinMaxRoi(roi, i_min, i_max, j_min,j_max);
+          vpPolygon polygon_mask(roi);
+          unsigned int border = shiftBorder;
         #endif
 
-          /* check image boundaries */
-          if(i_min > height){ //underflow
-            i_min = 0;
-          }
-          if(i_max > height){
-            i_max = height;
-          }
-          if(j_min > width){ //underflow
-            j_min = 0;
-          }
-          if(j_max > width){
-            j_max = width;
-          }
-
         #if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
-          for (int i = i_min; i < i_max; i++) {
-            double i_d = (double) i;
-
-            for(int j = j_min; j < j_max; j++) {
-              double j_d = (double) j;
-
-            #if defined (VISP_HAVE_CLIPPER)
-              imPt.set_ij(i_d, j_d);
-              if (polygon_test.isInside(imPt)) {
-                mask.ptr<uchar>(i)[j] = nb;
-              }
-            #else
-              if (shiftBorder != 0) {
-                if( vpPolygon::isInside(roi, i_d, j_d)
-                    && vpPolygon::isInside(roi, i_d+shiftBorder_d, j_d+shiftBorder_d)
-                    && vpPolygon::isInside(roi, i_d-shiftBorder_d, j_d+shiftBorder_d)
-                    && vpPolygon::isInside(roi, i_d+shiftBorder_d, j_d-shiftBorder_d)
-                    && vpPolygon::isInside(roi, i_d-shiftBorder_d, j_d-shiftBorder_d) ){
-                  mask.at<unsigned char>(i,j) = nb;
-                }
-              }
-              else{
-                if(vpPolygon::isInside(roi, i, j)){
-                  mask.at<unsigned char>(i,j) = nb;
-                }
-              }
-            #endif
-            }
-          }
+          polygon_mask.fill(mask.ptr<unsigned char>(0), (unsigned int) mask.rows, (unsigned int) mask.cols,
+                            (unsigned int) mask.step[0], nb, border);
         #else
-          unsigned char* ptrData = (unsigned char*)mask->imageData + i_min*mask->widthStep+j_min;
-          for(int i=i_min; i< i_max; i++){
-            double i_d = (double) i;
-            for(int j=j_min; j< j_max; j++){
-              double j_d = (double) j;
-              if(shiftBorder != 0){
-                if( vpPolygon::isInside(roi, i_d, j_d)
-                    && vpPolygon::isInside(roi, i_d+shiftBorder_d, j_d+shiftBorder_d)
-                    && vpPolygon::isInside(roi, i_d-shiftBorder_d, j_d+shiftBorder_d)
-                    && vpPolygon::isInside(roi, i_d+shiftBorder_d, j_d-shiftBorder_d)
-                    && vpPolygon::isInside(roi, i_d-shiftBorder_d, j_d-shiftBorder_d) ){
-                  *(ptrData++) = nb;
-                }
-                else{
-                  ptrData++;
-                }
-              }
-              else{
-                if(vpPolygon::isInside(roi, i, j)){
-                  *(ptrData++) = nb;
-                }
-                else{
-                  ptrData++;
-                }
-              }
-            }
-            ptrData += mask->widthStep - j_max + j_min;
-          }
+          polygon_mask.fill((unsigned char *) mask->imageData, (unsigned int) mask->height, (unsigned int) mask->width,
+                            (unsigned int) mask->widthStep, nb, border);
         #endif
     }
   }
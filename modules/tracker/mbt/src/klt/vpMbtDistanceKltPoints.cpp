@@ -88,6 +88,9 @@ vpMbtDistanceKltPoints::init(const vpKltOpencv& _tracker)
   curPointsInd = std::map<int, int>();
   std::vector<vpImagePoint> roi;
   polygon->getRoiClipped(cam, roi);
+  vpPolygon roiPolygon;
+  if (!useScanLine)
+    roiPolygon.buildFrom(roi);
 
   for (unsigned int i = 0; i < static_cast<unsigned int>(_tracker.getNbFeatures()); i ++){
     long id;
@@ -103,7 +106,7 @@ vpMbtDistanceKltPoints::init(const vpKltOpencv& _tracker)
          hiddenface->getMbScanLineRenderer().getPrimitiveIDs()[(unsigned int)y_tmp][(unsigned int)x_tmp] == polygon->getIndex())
         add = true;
     }
-    else if(vpPolygon::isInside(roi, y_tmp, x_tmp))
+    else if(roiPolygon.isInside(vpImagePoint(y_tmp, x_tmp)))
     {
       add = true;
     }
@@ -343,6 +346,8 @@ vpMbtDistanceKltPoints::isTrackedFeature(const int _id)
   \param mask : the mask to update (0, not in the object, _nb otherwise).
   \param nb : Optionnal value to set to the pixels included in the face.
   \param shiftBorder : Optionnal shift for the border in pixel (sort of built-in erosion) to avoid to consider pixels near the limits of the face.
+
+  The pixels are set row by row with vpPolygon::fill().
 */
 void
 vpMbtDistanceKltPoints::updateMask(
@@ -353,21 +358,13 @@ vpMbtDistanceKltPoints::updateMask(
 #endif
     unsigned char nb, unsigned int shiftBorder)
 {
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
-  int width  = mask.cols;
-  int height = mask.rows;
-#else
-  int width  = mask->width;
-  int height = mask->height;
-#endif
-
-  int i_min, i_max, j_min, j_max;
   std::vector<vpImagePoint> roi;
   polygon->getRoiClipped(cam, roi);
-
-  double shiftBorder_d = (double) shiftBorder;
+  if (roi.size() < 3)
+    return;
 
 #if defined (VISP_HAVE_CLIPPER)
+  double shiftBorder_d = (double) shiftBorder;
   std::vector<vpImagePoint> roi_offset;
 
   ClipperLib::Path path;
@@ -410,89 +407,20 @@ vpMbtDistanceKltPoints::updateMask(
     roi_offset = roi;
   }
 
-  vpPolygon polygon_test(roi_offset);
-  vpImagePoint imPt;
-#endif
-
-#if defined (VISP_HAVE_CLIPPER)
-  vpPolygon3D::getMinMaxRoi(roi_offset, i_min, i_max, j_min, j_max);
+  // The border is already removed by the offset
+  vpPolygon polygon_mask(roi_offset);
+  unsigned int border = 0;
 #else
-  vpPolygon3D::getMinMaxRoi(roi, i_min, i_max, j_min, j_max);
+  vpPolygon polygon_mask(roi);
+  unsigned int border = shiftBorder;
 #endif
 
-  /* check image boundaries */
-  if(i_min > height){ //underflow
-    i_min = 0;
-  }
-  if(i_max > height){
-    i_max = height;
-  }
-  if(j_min > width){ //underflow
-    j_min = 0;
-  }
-  if(j_max > width){
-    j_max = width;
-  }
-
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
-  for (int i = i_min; i< i_max; i++) {
-    double i_d = (double) i;
-
-    for (int j = j_min; j< j_max; j++) {
-      double j_d = (double) j;
-
-#if defined (VISP_HAVE_CLIPPER)
-      imPt.set_ij(i_d, j_d);
-      if (polygon_test.isInside(imPt)) {
-        mask.ptr<uchar>(i)[j] = nb;
-      }
-#else
-      if (shiftBorder != 0) {
-        if( vpPolygon::isInside(roi, i_d, j_d)
-            && vpPolygon::isInside(roi, i_d+shiftBorder_d, j_d+shiftBorder_d)
-            && vpPolygon::isInside(roi, i_d-shiftBorder_d, j_d+shiftBorder_d)
-            && vpPolygon::isInside(roi, i_d+shiftBorder_d, j_d-shiftBorder_d)
-            && vpPolygon::isInside(roi, i_d-shiftBorder_d, j_d-shiftBorder_d) ){
-          mask.at<unsigned char>(i,j) = nb;
-        }
-      }
-      else{
-        if(vpPolygon::isInside(roi, i, j)){
-          mask.at<unsigned char>(i,j) = nb;
-        }
-      }
-#endif
-    }
-  }
+  polygon_mask.fill(mask.ptr<unsigned char>(0), (unsigned int) mask.rows, (unsigned int) mask.cols,
+                    (unsigned int) mask.step[0], nb, border);
 #else
-  unsigned char* ptrData = (unsigned char*)mask->imageData + i_min*mask->widthStep+j_min;
-  for(int i=i_min; i< i_max; i++){
-    double i_d = (double) i;
-    for(int j=j_min; j< j_max; j++){
-      double j_d = (double) j;
-      if(shiftBorder != 0){
-        if( vpPolygon::isInside(roi, i_d, j_d)
-            && vpPolygon::isInside(roi, i_d+shiftBorder_d, j_d+shiftBorder_d)
-            && vpPolygon::isInside(roi, i_d-shiftBorder_d, j_d+shiftBorder_d)
-            && vpPolygon::isInside(roi, i_d+shiftBorder_d, j_d-shiftBorder_d)
-            && vpPolygon::isInside(roi, i_d-shiftBorder_d, j_d-shiftBorder_d) ){
-          *(ptrData++) = nb;
-        }
-        else{
-          ptrData++;
-        }
-      }
-      else{
-        if(vpPolygon::isInside(roi, i, j)){
-          *(ptrData++) = nb;
-        }
-        else{
-          ptrData++;
-        }
-      }
-    }
-    ptrData += mask->widthStep - j_max + j_min;
-  }
+  polygon_mask.fill((unsigned char *) mask->imageData, (unsigned int) mask->height, (unsigned int) mask->width,
+                    (unsigned int) mask->widthStep, nb, border);
 #endif
 }
 
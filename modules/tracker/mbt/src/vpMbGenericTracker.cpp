@@ -42,7 +42,7 @@
 
 vpMbGenericTracker::vpMbGenericTracker() :
   m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(), m_percentageGdPt(0.4),
-  m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+  m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError(), m_useParallelTracking(false)
 {
   m_mapOfTrackers["Camera"] = new TrackerWrapper(EDGE_TRACKER);
 
@@ -59,7 +59,7 @@ vpMbGenericTracker::vpMbGenericTracker() :
 
 vpMbGenericTracker::vpMbGenericTracker(const unsigned int nbCameras, const int trackerType) :
   m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(), m_percentageGdPt(0.4),
-  m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+  m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError(), m_useParallelTracking(false)
 {
   if (nbCameras == 0) {
     throw vpException(vpTrackingException::fatalError, "Cannot use no camera!");
@@ -92,7 +92,7 @@ vpMbGenericTracker::vpMbGenericTracker(const unsigned int nbCameras, const int t
 
 vpMbGenericTracker::vpMbGenericTracker(const std::vector<int> &trackerTypes) :
   m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(), m_percentageGdPt(0.4),
-  m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+  m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError(), m_useParallelTracking(false)
 {
   if (trackerTypes.empty()) {
     throw vpException(vpException::badValue, "There is no camera!");
@@ -127,7 +127,7 @@ vpMbGenericTracker::vpMbGenericTracker(const std::vector<int> &trackerTypes) :
 
 vpMbGenericTracker::vpMbGenericTracker(const std::vector<std::string> &cameraNames, const std::vector<int> &trackerTypes) :
   m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(), m_percentageGdPt(0.4),
-  m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+  m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError(), m_useParallelTracking(false)
 {
   if (cameraNames.size() != trackerTypes.size() || cameraNames.empty()) {
     throw vpException(vpTrackingException::badValue, "cameraNames.size() != trackerTypes.size() || cameraNames.empty()");
@@ -368,12 +368,11 @@ void vpMbGenericTracker::computeVVSInit() {
 }
 
 void vpMbGenericTracker::computeVVSInit(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages) {
-  unsigned int nbFeatures = 0;
+  processTrackerWrappers(VVS_INIT, mapOfImages);
 
+  unsigned int nbFeatures = 0;
   for (std::map<std::string, TrackerWrapper*>::const_iterator it = m_mapOfTrackers.begin(); it != m_mapOfTrackers.end(); ++it) {
     TrackerWrapper *tracker = it->second;
-    tracker->computeVVSInit(*mapOfImages[it->first]);
-
     nbFeatures += tracker->m_error.getRows();
   }
 
@@ -391,8 +390,6 @@ void vpMbGenericTracker::computeVVSInteractionMatrixAndResidu() {
 
 void vpMbGenericTracker::computeVVSInteractionMatrixAndResidu(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
                                                              std::map<std::string, vpVelocityTwistMatrix> &mapOfVelocityTwist) {
-  unsigned int start_index = 0;
-
   for (std::map<std::string, TrackerWrapper*>::const_iterator it = m_mapOfTrackers.begin(); it != m_mapOfTrackers.end(); ++it) {
     TrackerWrapper *tracker = it->second;
 
@@ -401,7 +398,14 @@ void vpMbGenericTracker::computeVVSInteractionMatrixAndResidu(std::map<std::stri
     vpHomogeneousMatrix c_curr_tTc_curr0 = m_mapOfCameraTransformationMatrix[it->first] * cMo * tracker->c0Mo.inverse();
     tracker->ctTc0 = c_curr_tTc_curr0;
 #endif
-    tracker->computeVVSInteractionMatrixAndResidu(*mapOfImages[it->first]);
+  }
+
+  processTrackerWrappers(VVS_INTERACTION_MATRIX_AND_RESIDU, mapOfImages);
+
+  // Stack the interaction matrices and residuals of all the cameras
+  unsigned int start_index = 0;
+  for (std::map<std::string, TrackerWrapper*>::const_iterator it = m_mapOfTrackers.begin(); it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
 
     m_L.insert(tracker->m_L*mapOfVelocityTwist[it->first], start_index, 0);
     m_error.insert(start_index, tracker->m_error);
@@ -411,11 +415,12 @@ void vpMbGenericTracker::computeVVSInteractionMatrixAndResidu(std::map<std::stri
 }
 
 void vpMbGenericTracker::computeVVSWeights() {
-  unsigned int start_index = 0;
+  // The robust weights don't need the images
+  processTrackerWrappers(VVS_WEIGHTS, std::map<std::string, const vpImage<unsigned char> *>());
 
+  unsigned int start_index = 0;
   for (std::map<std::string, TrackerWrapper*>::const_iterator it = m_mapOfTrackers.begin(); it != m_mapOfTrackers.end(); ++it) {
     TrackerWrapper *tracker = it->second;
-    tracker->computeVVSWeights();
 
     m_w.insert(start_index, tracker->m_w);
     start_index += tracker->m_w.getRows();
@@ -1908,9 +1913,137 @@ void vpMbGenericTracker::loadModel(const std::map<std::string, std::string> &map
 }
 
 void vpMbGenericTracker::preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages) {
+  processTrackerWrappers(PRE_TRACKING, mapOfImages);
+}
+
+/*!
+  Run a stage of the tracking for one camera.
+
+  \param tracker : Tracker of the camera.
+  \param I : Image of the camera, can be NULL for the stages that don't need it.
+  \param stage : Stage to run.
+*/
+void vpMbGenericTracker::processTrackerWrapper(TrackerWrapper *tracker, const vpImage<unsigned char> *I,
+                                               const vpTrackerWrapperStage stage) {
+  switch (stage) {
+  case PRE_TRACKING:
+    tracker->preTracking(*I);
+    break;
+
+  case VVS_INIT:
+    tracker->computeVVSInit(*I);
+    break;
+
+  case VVS_INTERACTION_MATRIX_AND_RESIDU:
+    tracker->computeVVSInteractionMatrixAndResidu(*I);
+    break;
+
+  case VVS_WEIGHTS:
+    tracker->computeVVSWeights();
+    break;
+
+  case POST_TRACKING:
+    tracker->postTracking(*I);
+    break;
+
+  default:
+    break;
+  }
+}
+
+/*!
+  Run a stage of the tracking for all the cameras. When parallel tracking is
+  enabled, the cameras are shared between the threads of vpThreadPool and the
+  function returns when all the cameras are done. If a camera throws an exception, the first
+  one (in camera name order) is thrown again once all the threads are joined.
+
+  \param stage : Stage to run.
+  \param mapOfImages : Map of images.
+
+  \sa setUseParallelTracking()
+*/
+void vpMbGenericTracker::processTrackerWrappers(const vpTrackerWrapperStage stage,
+                                                const std::map<std::string, const vpImage<unsigned char> *> &mapOfImages) {
+  bool executeParallelVersion = m_useParallelTracking && m_mapOfTrackers.size() > 1;
+
+  std::vector<TrackerWrapper *> trackers;
+  std::vector<const vpImage<unsigned char> *> images;
   for (std::map<std::string, TrackerWrapper*>::const_iterator it = m_mapOfTrackers.begin(); it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-    tracker->preTracking(*mapOfImages[it->first]);
+    std::map<std::string, const vpImage<unsigned char> *>::const_iterator it_img = mapOfImages.find(it->first);
+    trackers.push_back(it->second);
+    images.push_back(it_img != mapOfImages.end() ? it_img->second : NULL);
+
+    // The displays are not thread safe
+    if (stage == POST_TRACKING && it->second->displayFeatures) {
+      executeParallelVersion = false;
+    }
+  }
+
+  if (executeParallelVersion) {
+    std::vector<TrackerWrapperFunctor> tracker_func(trackers.size());
+    for (size_t i = 0; i < trackers.size(); i++) {
+      tracker_func[i] = TrackerWrapperFunctor(trackers[i], images[i], stage);
+    }
+
+    // One camera per thread of vpThreadPool, the calling thread included
+    vpThreadPool::parallel_for(0, (unsigned int) tracker_func.size(), trackerWrapperRange, &tracker_func,
+                               (unsigned int) tracker_func.size());
+
+    for (size_t i = 0; i < tracker_func.size(); i++) {
+      tracker_func[i].rethrow();
+    }
+
+    return;
+  }
+
+  for (size_t i = 0; i < trackers.size(); i++) {
+    processTrackerWrapper(trackers[i], images[i], stage);
+  }
+}
+
+void vpMbGenericTracker::trackerWrapperRange(unsigned int begin, unsigned int end, void *arg) {
+  std::vector<vpMbGenericTracker::TrackerWrapperFunctor> &tracker_func =
+      *reinterpret_cast<std::vector<vpMbGenericTracker::TrackerWrapperFunctor>*>(arg);
+  for (unsigned int i = begin; i < end; i++) {
+    tracker_func[i]();
+  }
+}
+
+void vpMbGenericTracker::TrackerWrapperFunctor::operator()() {
+  // Exceptions cannot cross the thread boundary, they are kept to be thrown
+  // again by rethrow() in the calling thread
+  try {
+    processTrackerWrapper(m_tracker, m_I, m_stage);
+  } catch (vpTrackingException &e) {
+    m_exceptionType = TRACKING_EXCEPTION;
+    m_errorCode = e.getCode();
+    m_errorMessage = e.getStringMessage();
+  } catch (vpException &e) {
+    m_exceptionType = VISP_EXCEPTION;
+    m_errorCode = e.getCode();
+    m_errorMessage = e.getStringMessage();
+  } catch (const std::exception &e) {
+    m_exceptionType = UNKNOWN_EXCEPTION;
+    m_errorMessage = e.what();
+  } catch (...) {
+    m_exceptionType = UNKNOWN_EXCEPTION;
+    m_errorMessage = "Unknown exception";
+  }
+}
+
+void vpMbGenericTracker::TrackerWrapperFunctor::rethrow() const {
+  switch (m_exceptionType) {
+  case TRACKING_EXCEPTION:
+    throw vpTrackingException(m_errorCode, m_errorMessage);
+
+  case VISP_EXCEPTION:
+    throw vpException(m_errorCode, m_errorMessage);
+
+  case UNKNOWN_EXCEPTION:
+    throw vpException(vpException::fatalError, m_errorMessage);
+
+  default:
+    break;
   }
 }
 
@@ -2518,7 +2651,6 @@ void vpMbGenericTracker::setGoodMovingEdgesRatioThreshold(const double threshold
   }
 }
 
-#ifdef VISP_HAVE_OGRE
 /*!
   Set the ratio of visibility attempts that has to be successful to consider a polygon as visible.
 
@@ -2551,7 +2683,6 @@ void vpMbGenericTracker::setNbRayCastingAttemptsForVisibility(const unsigned int
     tracker->setNbRayCastingAttemptsForVisibility(attempts);
   }
 }
-#endif
 
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 /*!
@@ -3056,6 +3187,24 @@ void vpMbGenericTracker::setReferenceCameraName(const std::string &referenceCame
   }
 }
 
+/*!
+  Use a ray casting computed on the CPU for visibility tests, as an alternative to Ogre3D.
+
+  \param v : True to use it, False otherwise
+
+  \note This function will set the new parameter for all the cameras.
+
+  \sa vpMbTracker::setRayCastingVisibilityTest()
+*/
+void vpMbGenericTracker::setRayCastingVisibilityTest(const bool &v) {
+  vpMbTracker::setRayCastingVisibilityTest(v);
+
+  for (std::map<std::string, TrackerWrapper*>::const_iterator it = m_mapOfTrackers.begin(); it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setRayCastingVisibilityTest(v);
+  }
+}
+
 void vpMbGenericTracker::setScanLineVisibilityTest(const bool &v) {
   vpMbTracker::setScanLineVisibilityTest(v);
 
@@ -3197,11 +3346,7 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
 
   //TODO: testTracking somewhere/needed?
 
-  for (std::map<std::string, TrackerWrapper*>::const_iterator it = m_mapOfTrackers.begin(); it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-
-    tracker->postTracking(*mapOfImages[it->first]);
-  }
+  processTrackerWrappers(POST_TRACKING, mapOfImages);
 
   computeProjectionError();
 }
@@ -0,0 +1,443 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Occlusion test of the faces of a CAD model by ray casting in a bounding
+ * volume hierarchy.
+ *
+ *****************************************************************************/
+
+#include <visp3/core/vpConfig.h>
+
+#if defined _MSC_VER && _MSC_VER >= 1200
+#  define NOMINMAX
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <visp3/mbt/vpMbRayCaster.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpThreadPool.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+namespace {
+  //! Maximum number of triangles in a leaf
+  const unsigned int leafSize = 4;
+  //! Depth of the traversal stack, the hierarchy being balanced
+  const unsigned int stackSize = 64;
+  //! Parts of the ray ignored at both ends, in fraction of its length
+  const float tMin = 1e-6f;
+  const float tMax = 1.f - 1e-4f;
+
+  // Order the triangles along an axis by their centroid
+  struct vpMbRayCasterCompare {
+    const float *centroids;
+    unsigned int axis;
+
+    bool operator()(unsigned int a, unsigned int b) const {
+      return centroids[3*a + axis] < centroids[3*b + axis];
+    }
+  };
+
+  // Direction and inverse direction of a ray, the inverse staying finite
+  inline void setDirection(const float origin[3], const double target[3], float d[3], float inv[3])
+  {
+    for (unsigned int k = 0; k < 3; k++) {
+      d[k] = (float) target[k] - origin[k];
+      const float dk = (std::fabs(d[k]) < 1e-30f) ? 1e-30f : d[k];
+      inv[k] = 1.f / dk;
+    }
+  }
+}
+
+vpMbRayCaster::vpMbRayCaster()
+  : nbThreads(0), built(true), nodes(), triangles(), triangleIDs(), centroids(), order()
+{
+}
+
+/*!
+  Add a face to the scene. The face is cut into a fan of triangles. Faces
+  with less than three points, the lines of the model, don't occlude anything
+  but can be tested with castRays().
+
+  \param points : Points of the face; their coordinates in the object frame are used.
+  \param id : Index of the face, given back by the rays cast toward it.
+*/
+void
+vpMbRayCaster::addPolygon(const std::vector<vpPoint> &points, unsigned int id)
+{
+  if (points.size() < 3)
+    return;
+
+  const vpPoint &p0 = points[0];
+  for (size_t i = 1; i + 1 < points.size(); i++) {
+    const vpPoint &p1 = points[i];
+    const vpPoint &p2 = points[i+1];
+    triangles.push_back((float) p0.get_oX());
+    triangles.push_back((float) p0.get_oY());
+    triangles.push_back((float) p0.get_oZ());
+    triangles.push_back((float) (p1.get_oX() - p0.get_oX()));
+    triangles.push_back((float) (p1.get_oY() - p0.get_oY()));
+    triangles.push_back((float) (p1.get_oZ() - p0.get_oZ()));
+    triangles.push_back((float) (p2.get_oX() - p0.get_oX()));
+    triangles.push_back((float) (p2.get_oY() - p0.get_oY()));
+    triangles.push_back((float) (p2.get_oZ() - p0.get_oZ()));
+    triangleIDs.push_back(id);
+  }
+  built = false;
+}
+
+/*!
+  Build the hierarchy over the triangles added with addPolygon(). The nodes
+  are split at the median of the centroids along their largest axis.
+*/
+void
+vpMbRayCaster::build()
+{
+  const unsigned int nbTriangles = getNbTriangles();
+  nodes.clear();
+  built = true;
+  if (nbTriangles == 0)
+    return;
+
+  centroids.resize(3*nbTriangles);
+  order.resize(nbTriangles);
+  for (unsigned int i = 0; i < nbTriangles; i++) {
+    const float *tri = &triangles[9*i];
+    for (unsigned int k = 0; k < 3; k++)
+      centroids[3*i + k] = tri[k] + (tri[3 + k] + tri[6 + k]) / 3.f;
+    order[i] = i;
+  }
+
+  // A binary tree whose leaves hold at least one triangle has less than 2n nodes
+  nodes.reserve(2*nbTriangles);
+  nodes.push_back(vpMbRayCasterNode());
+  split(0, 0, nbTriangles);
+
+  // Store the triangles in the order of the leaves
+  std::vector<float> sortedTriangles(triangles.size());
+  std::vector<unsigned int> sortedIDs(nbTriangles);
+  for (unsigned int i = 0; i < nbTriangles; i++) {
+    std::copy(&triangles[9*order[i]], &triangles[9*order[i]] + 9, &sortedTriangles[9*i]);
+    sortedIDs[i] = triangleIDs[order[i]];
+  }
+  triangles.swap(sortedTriangles);
+  triangleIDs.swap(sortedIDs);
+}
+
+/*!
+  Test the occlusion of segments going from \e origin to the target of each
+  ray. A ray is occluded if it cuts a triangle of another face than its own
+  one; the ends of the segment are ignored, so that a face doesn't occlude
+  the lines of its border.
+
+  \param origin : Position of the camera in the object frame.
+  \param rays : Rays to cast, their occluded flag is set.
+
+  \exception vpException::fatalError : If the scene changed since the last call of build().
+*/
+void
+vpMbRayCaster::castRays(const vpTranslationVector &origin, std::vector<vpMbRayCasterRay> &rays) const
+{
+  if (!built)
+    throw vpException(vpException::fatalError, "The bounding volume hierarchy has to be built before casting rays");
+
+  if (rays.empty())
+    return;
+
+  vpMbRayCasterTask task;
+  task.caster = this;
+  for (unsigned int k = 0; k < 3; k++)
+    task.origin[k] = (float) origin[k];
+  task.rays = &rays[0];
+  task.nbRays = (unsigned int) rays.size();
+
+  const unsigned int nbPackets = (task.nbRays + 3) / 4;
+  vpThreadPool::parallel_for(0, nbPackets, &castPackets, &task, nbThreads, 16);
+}
+
+/*!
+  Remove all the faces.
+*/
+void
+vpMbRayCaster::clear()
+{
+  nodes.clear();
+  triangles.clear();
+  triangleIDs.clear();
+  built = true;
+}
+
+/*!
+  Set the number of threads used by castRays().
+
+  \param nb : Number of threads, 0 meaning vpThreadPool::getNbThreads(), 1
+  to cast the rays in the calling thread.
+*/
+void
+vpMbRayCaster::setNbThreads(unsigned int nb)
+{
+  nbThreads = nb;
+}
+
+/*!
+  Loop body of vpThreadPool::parallel_for() over the packets of four rays.
+*/
+void
+vpMbRayCaster::castPackets(unsigned int begin, unsigned int end, void *args)
+{
+  const vpMbRayCasterTask *task = static_cast<const vpMbRayCasterTask *>(args);
+  for (unsigned int i = begin; i < end; i++) {
+    const unsigned int first = 4*i;
+    task->caster->castPacket(task->origin, task->rays + first, std::min(4u, task->nbRays - first));
+  }
+}
+
+/*!
+  Traverse the hierarchy with up to four rays. A node is visited if one of
+  the rays still unoccluded cuts its box, and a ray is removed from the
+  packet as soon as it is occluded. As all the rays start from \e origin, the
+  vectors \f$ s = O - v_0 \f$ and \f$ q = s \times e_1 \f$ of the
+  Moller-Trumbore test only depend on the triangle.
+*/
+void
+vpMbRayCaster::castPacket(const float origin[3], vpMbRayCasterRay *rays, unsigned int nb) const
+{
+  for (unsigned int r = 0; r < nb; r++)
+    rays[r].occluded = false;
+  if (nodes.empty())
+    return;
+
+  unsigned int stack[stackSize];
+
+#if VISP_HAVE_SSE2
+  // Structure of arrays, the unused lanes duplicate the first ray and are inactive
+  float d[3][4], inv[3][4];
+  int ids[4], lanes[4];
+  for (unsigned int r = 0; r < 4; r++) {
+    const vpMbRayCasterRay &ray = rays[r < nb ? r : 0];
+    float dr[3], invr[3];
+    setDirection(origin, ray.target, dr, invr);
+    for (unsigned int k = 0; k < 3; k++) {
+      d[k][r] = dr[k];
+      inv[k][r] = invr[k];
+    }
+    ids[r] = (int) ray.id;
+    lanes[r] = (r < nb) ? -1 : 0;
+  }
+
+  const __m128 dx = _mm_loadu_ps(d[0]), dy = _mm_loadu_ps(d[1]), dz = _mm_loadu_ps(d[2]);
+  const __m128 ix = _mm_loadu_ps(inv[0]), iy = _mm_loadu_ps(inv[1]), iz = _mm_loadu_ps(inv[2]);
+  const __m128 ox = _mm_set1_ps(origin[0]), oy = _mm_set1_ps(origin[1]), oz = _mm_set1_ps(origin[2]);
+  const __m128 v_tMin = _mm_set1_ps(tMin), v_tMax = _mm_set1_ps(tMax);
+  const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.f);
+  const __m128i v_ids = _mm_loadu_si128((const __m128i *) ids);
+  __m128 active = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) lanes));
+
+  unsigned int sp = 0;
+  stack[sp++] = 0;
+  while (sp > 0) {
+    const vpMbRayCasterNode &node = nodes[stack[--sp]];
+
+    // Slab test of the box
+    const __m128 t0x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.bmin[0]), ox), ix);
+    const __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.bmax[0]), ox), ix);
+    const __m128 t0y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.bmin[1]), oy), iy);
+    const __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.bmax[1]), oy), iy);
+    const __m128 t0z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.bmin[2]), oz), iz);
+    const __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.bmax[2]), oz), iz);
+    const __m128 tNear = _mm_max_ps(_mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y)),
+                                    _mm_max_ps(_mm_min_ps(t0z, t1z), v_tMin));
+    const __m128 tFar = _mm_min_ps(_mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y)),
+                                   _mm_min_ps(_mm_max_ps(t0z, t1z), v_tMax));
+    if (_mm_movemask_ps(_mm_and_ps(_mm_cmple_ps(tNear, tFar), active)) == 0)
+      continue;
+
+    if (node.count == 0) {
+      stack[sp++] = node.first;
+      stack[sp++] = node.first + 1;
+      continue;
+    }
+
+    for (unsigned int i = node.first; i < node.first + node.count; i++) {
+      const float *tri = &triangles[9*i];
+      const float sx = origin[0] - tri[0], sy = origin[1] - tri[1], sz = origin[2] - tri[2];
+      const float qx = sy*tri[5] - sz*tri[4], qy = sz*tri[3] - sx*tri[5], qz = sx*tri[4] - sy*tri[3];
+
+      const __m128 e1x = _mm_set1_ps(tri[3]), e1y = _mm_set1_ps(tri[4]), e1z = _mm_set1_ps(tri[5]);
+      const __m128 e2x = _mm_set1_ps(tri[6]), e2y = _mm_set1_ps(tri[7]), e2z = _mm_set1_ps(tri[8]);
+
+      // p = d x e2
+      const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+      const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+      const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+      const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+      const __m128 invDet = _mm_div_ps(one, det);
+
+      const __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(sx), px), _mm_mul_ps(_mm_set1_ps(sy), py)),
+                                             _mm_mul_ps(_mm_set1_ps(sz), pz)), invDet);
+      const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, _mm_set1_ps(qx)), _mm_mul_ps(dy, _mm_set1_ps(qy))),
+                                             _mm_mul_ps(dz, _mm_set1_ps(qz))), invDet);
+      const __m128 t = _mm_mul_ps(_mm_set1_ps(tri[6]*qx + tri[7]*qy + tri[8]*qz), invDet);
+
+      __m128 hit = _mm_and_ps(_mm_cmpneq_ps(det, zero), active);
+      hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmpge_ps(v, zero)));
+      hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), one));
+      hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpgt_ps(t, v_tMin), _mm_cmplt_ps(t, v_tMax)));
+      hit = _mm_andnot_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v_ids, _mm_set1_epi32((int) triangleIDs[i]))), hit);
+
+      active = _mm_andnot_ps(hit, active);
+    }
+
+    if (_mm_movemask_ps(active) == 0)
+      break;
+  }
+
+  const int stillVisible = _mm_movemask_ps(active);
+  for (unsigned int r = 0; r < nb; r++)
+    rays[r].occluded = ((stillVisible >> r) & 1) == 0;
+#else
+  for (unsigned int r = 0; r < nb; r++) {
+    vpMbRayCasterRay &ray = rays[r];
+    float d[3], inv[3];
+    setDirection(origin, ray.target, d, inv);
+
+    unsigned int sp = 0;
+    stack[sp++] = 0;
+    while (sp > 0 && !ray.occluded) {
+      const vpMbRayCasterNode &node = nodes[stack[--sp]];
+
+      float tNear = tMin, tFar = tMax;
+      for (unsigned int k = 0; k < 3; k++) {
+        const float t0 = (node.bmin[k] - origin[k]) * inv[k];
+        const float t1 = (node.bmax[k] - origin[k]) * inv[k];
+        tNear = std::max(tNear, std::min(t0, t1));
+        tFar = std::min(tFar, std::max(t0, t1));
+      }
+      if (tNear > tFar)
+        continue;
+
+      if (node.count == 0) {
+        stack[sp++] = node.first;
+        stack[sp++] = node.first + 1;
+        continue;
+      }
+
+      for (unsigned int i = node.first; i < node.first + node.count && !ray.occluded; i++) {
+        if (triangleIDs[i] == ray.id)
+          continue;
+
+        const float *tri = &triangles[9*i];
+        const float sx = origin[0] - tri[0], sy = origin[1] - tri[1], sz = origin[2] - tri[2];
+        const float qx = sy*tri[5] - sz*tri[4], qy = sz*tri[3] - sx*tri[5], qz = sx*tri[4] - sy*tri[3];
+        const float px = d[1]*tri[8] - d[2]*tri[7], py = d[2]*tri[6] - d[0]*tri[8], pz = d[0]*tri[7] - d[1]*tri[6];
+        const float det = tri[3]*px + tri[4]*py + tri[5]*pz;
+        if (det == 0.f)
+          continue;
+
+        const float invDet = 1.f / det;
+        const float u = (sx*px + sy*py + sz*pz) * invDet;
+        const float v = (d[0]*qx + d[1]*qy + d[2]*qz) * invDet;
+        const float t = (tri[6]*qx + tri[7]*qy + tri[8]*qz) * invDet;
+        ray.occluded = u >= 0.f && v >= 0.f && u + v <= 1.f && t > tMin && t < tMax;
+      }
+    }
+  }
+#endif
+}
+
+/*!
+  Compute the box of a node and split it in two children, or make it a leaf.
+
+  \param node : Index of the node.
+  \param first, count : Range of the node in the order of the triangles.
+*/
+void
+vpMbRayCaster::split(unsigned int node, unsigned int first, unsigned int count)
+{
+  float bmin[3], bmax[3], cmin[3], cmax[3];
+  for (unsigned int k = 0; k < 3; k++) {
+    bmin[k] = cmin[k] = std::numeric_limits<float>::max();
+    bmax[k] = cmax[k] = -std::numeric_limits<float>::max();
+  }
+
+  for (unsigned int i = first; i < first + count; i++) {
+    const float *tri = &triangles[9*order[i]];
+    const float *c = &centroids[3*order[i]];
+    for (unsigned int k = 0; k < 3; k++) {
+      const float v1 = tri[k] + tri[3 + k], v2 = tri[k] + tri[6 + k];
+      bmin[k] = std::min(bmin[k], std::min(tri[k], std::min(v1, v2)));
+      bmax[k] = std::max(bmax[k], std::max(tri[k], std::max(v1, v2)));
+      cmin[k] = std::min(cmin[k], c[k]);
+      cmax[k] = std::max(cmax[k], c[k]);
+    }
+  }
+
+  for (unsigned int k = 0; k < 3; k++) {
+    nodes[node].bmin[k] = bmin[k];
+    nodes[node].bmax[k] = bmax[k];
+  }
+
+  unsigned int axis = 0;
+  for (unsigned int k = 1; k < 3; k++) {
+    if (cmax[k] - cmin[k] > cmax[axis] - cmin[axis])
+      axis = k;
+  }
+
+  // Small node, or triangles that cannot be separated
+  if (count <= leafSize || cmax[axis] <= cmin[axis]) {
+    nodes[node].first = first;
+    nodes[node].count = count;
+    return;
+  }
+
+  vpMbRayCasterCompare compare;
+  compare.centroids = &centroids[0];
+  compare.axis = axis;
+  const unsigned int half = count / 2;
+  std::nth_element(order.begin() + first, order.begin() + first + half, order.begin() + first + count, compare);
+
+  const unsigned int child = (unsigned int) nodes.size();
+  nodes[node].first = child;
+  nodes[node].count = 0;
+  nodes.push_back(vpMbRayCasterNode());
+  nodes.push_back(vpMbRayCasterNode());
+  split(child, first, half);
+  split(child + 1, first + half, count - half);
+}
+
+#endif
@@ -49,6 +49,7 @@
 
 #include <visp3/mbt/vpMbScanLine.h>
 #include <visp3/core/vpMeterPixelConversion.h>
+#include <visp3/core/vpThreadPool.h>
 
 #if defined(DEBUG_DISP)
 #include <visp3/gui/vpDisplayGDI.h>
@@ -59,8 +60,8 @@
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
 vpMbScanLine::vpMbScanLine()
-  : w(0), h(0), K(), maskBorder(0), mask(), primitive_ids(),
-    visibility_samples(), depthTreshold(1e-06)
+  : w(0), h(0), K(), maskBorder(0), mask(), maskX(), maskY(), primitive_ids(), depthTreshold(1e-06), nbThreads(0),
+    scanlines(), localScanlines(), points(), edges(), edgeIDs(), sortedEdges(), uniqueEdges(), visibility_samples()
 #if defined(DEBUG_DISP)
   ,dispMaskDebug(NULL), dispLineDebug(NULL), linedebugImg()
 #endif
@@ -83,18 +84,17 @@ vpMbScanLine::~vpMbScanLine()
 }
 /*!
   Compute the intersections between Y-axis scanlines and a given line (two points polygon).
+  The intersections are appended to the local scanlines.
 
-  \param a : First point of the line.
-  \param b : Second point of the line.
-  \param edge : Pair with the two points of the line.
+  \param a : First point of the line, projected with createVectorFromPoint().
+  \param b : Second point of the line, projected with createVectorFromPoint().
+  \param edge : Index of the line in the list of the edges of the scene.
   \param ID : Id of the given line (has to be know when using queries).
-  \param scanlines : Resulting intersections.
 */
-void vpMbScanLine::drawLineY(const vpColVector &a,
-               const vpColVector &b,
-               const vpMbScanLineEdge &edge,
-               const int ID,
-               std::vector<std::vector<vpMbScanLineSegment> > &scanlines)
+void vpMbScanLine::drawLineY(const double *a,
+               const double *b,
+               const unsigned int edge,
+               const int ID)
 {
   double x0 = a[0] / a[2];
   double y0 = a[1] / a[2];
@@ -122,7 +122,10 @@ void vpMbScanLine::drawLineY(const vpColVector &a,
   {
       const double x = x0 + (x1 - x0) * (y - y0) / (y1 - y0);
       const double alpha = getAlpha(y, y0 * z0, z0, y1 * z1, z1);
-      vpMbScanLineSegment s;
+      vpMbScanLineIntersection i;
+      i.scanline = y;
+      i.order = (unsigned int)localScanlines.size();
+      vpMbScanLineSegment &s = i.s;
       s.p = x;
       s.type = POINT;
       s.Z2 = s.Z1 = mix(z0, z1, alpha);
@@ -130,24 +133,23 @@ void vpMbScanLine::drawLineY(const vpColVector &a,
       s.ID = ID;
       s.edge = edge;
       s.b_sample_Y = b_sample_Y;
-      scanlines[y].push_back(s);
+      localScanlines.push_back(i);
   }
 }
 
 /*!
   Compute the intersections between X-axis scanlines and a given line (two points polygon).
+  The intersections are appended to the local scanlines.
 
-  \param a : First point of the line.
-  \param b : Second point of the line.
-  \param edge : Pair with the two points of the line.
+  \param a : First point of the line, projected with createVectorFromPoint().
+  \param b : Second point of the line, projected with createVectorFromPoint().
+  \param edge : Index of the line in the list of the edges of the scene.
   \param ID : Id of the given line (has to be know when using queries).
-  \param scanlines : Resulting intersections.
 */
-void vpMbScanLine::drawLineX(const vpColVector &a,
-               const vpColVector &b,
-               const vpMbScanLineEdge &edge,
-               const int ID,
-               std::vector<std::vector<vpMbScanLineSegment> > &scanlines)
+void vpMbScanLine::drawLineX(const double *a,
+               const double *b,
+               const unsigned int edge,
+               const int ID)
 {
   double x0 = a[0] / a[2];
   double y0 = a[1] / a[2];
@@ -175,7 +177,10 @@ void vpMbScanLine::drawLineX(const vpColVector &a,
   {
       const double y = y0 + (y1 - y0) * (x - x0) / (x1 - x0);
       const double alpha = getAlpha(x, x0 * z0, z0, x1 * z1, z1);
-      vpMbScanLineSegment s;
+      vpMbScanLineIntersection i;
+      i.scanline = h + x;
+      i.order = (unsigned int)localScanlines.size();
+      vpMbScanLineSegment &s = i.s;
       s.p = y;
       s.type = POINT;
       s.Z2 = s.Z1 = mix(z0, z1, alpha);
@@ -183,147 +188,119 @@ void vpMbScanLine::drawLineX(const vpColVector &a,
       s.ID = ID;
       s.edge = edge;
       s.b_sample_Y = b_sample_Y;
-      scanlines[x].push_back(s);
+      localScanlines.push_back(i);
   }
 }
 
 
 /*!
-  Compute the Y-axis scanlines intersections of a polygon.
+  Compute the Y-axis scanlines intersections of the polygon whose points have
+  been projected in the points buffer.
 
-  \param polygon : Polygon composed by an array of lines.
+  \param nbPoints : Number of points of the polygon.
+  \param firstEdge : Index of the first edge of the polygon in the list of the edges of the scene.
   \param ID : ID of the polygon (has to be know when using queries).
-  \param scanlines : Resulting intersections.
 */
 void
-vpMbScanLine::drawPolygonY(const std::vector<std::pair<vpPoint, unsigned int> > &polygon,
-                  const int ID,
-                  std::vector<std::vector<vpMbScanLineSegment> > &scanlines)
+vpMbScanLine::drawPolygonY(const unsigned int nbPoints,
+                  const unsigned int firstEdge,
+                  const int ID)
 {
-  if (polygon.size() < 2)
-    return;
+  localScanlines.clear();
 
-  if (polygon.size() == 2)
+  if (nbPoints == 2)
   {
-    vpColVector p1, p2;
-    createVectorFromPoint(polygon.front().first, p1, K);
-    createVectorFromPoint(polygon.back().first, p2, K);
-
-    drawLineY(p1,
-              p2,
-              makeMbScanLineEdge(polygon.front().first, polygon.back().first),
-              ID,
-              scanlines);
+    drawLineY(&points[0], &points[3], firstEdge, ID);
+
+    for(size_t i = 0 ; i < localScanlines.size() ; ++i)
+      scanlines[localScanlines[i].scanline].segments.push_back(localScanlines[i].s);
     return;
   }
 
-  std::vector<std::vector<vpMbScanLineSegment> > local_scanlines;
-  local_scanlines.resize(h);
-
-  for(size_t i = 0 ; i < polygon.size() ; ++i)
-  {
-    vpColVector p1, p2;
-    createVectorFromPoint(polygon[i].first, p1, K);
-    createVectorFromPoint(polygon[(i + 1) % polygon.size()].first, p2, K);
+  for(unsigned int i = 0 ; i < nbPoints ; ++i)
+    drawLineY(&points[3 * i], &points[3 * ((i + 1) % nbPoints)], firstEdge + i, ID);
 
-    drawLineY(p1, p2, makeMbScanLineEdge(polygon[i].first, polygon[(i + 1) % polygon.size()].first), ID, local_scanlines);
-  }
-
-  createScanLinesFromLocals(scanlines,local_scanlines,h);
+  createScanLinesFromLocals();
 }
 
 /*!
-  Compute the X-axis scanlines intersections of a polygon.
+  Compute the X-axis scanlines intersections of the polygon whose points have
+  been projected in the points buffer.
 
-  \param polygon : Polygon composed by an array of lines.
+  \param nbPoints : Number of points of the polygon.
+  \param firstEdge : Index of the first edge of the polygon in the list of the edges of the scene.
   \param ID : ID of the polygon (has to be know when using queries).
-  \param scanlines : Resulting intersections.
 */
 void
-vpMbScanLine::drawPolygonX(const std::vector<std::pair<vpPoint, unsigned int> > &polygon,
-                  const int ID,
-                  std::vector<std::vector<vpMbScanLineSegment> > &scanlines)
+vpMbScanLine::drawPolygonX(const unsigned int nbPoints,
+                  const unsigned int firstEdge,
+                  const int ID)
 {
-  if (polygon.size() < 2)
-      return;
+  localScanlines.clear();
 
-  if (polygon.size() == 2)
+  if (nbPoints == 2)
   {
-    vpColVector p1, p2;
-    createVectorFromPoint(polygon.front().first, p1, K);
-    createVectorFromPoint(polygon.back().first, p2, K);
-
-    drawLineX(p1,
-              p2,
-              makeMbScanLineEdge(polygon.front().first, polygon.back().first),
-              ID,
-              scanlines);
+    drawLineX(&points[0], &points[3], firstEdge, ID);
+
+    for(size_t i = 0 ; i < localScanlines.size() ; ++i)
+      scanlines[localScanlines[i].scanline].segments.push_back(localScanlines[i].s);
     return;
   }
 
-  std::vector<std::vector<vpMbScanLineSegment> > local_scanlines;
-  local_scanlines.resize(w);
-
-  for(size_t i = 0 ; i < polygon.size() ; ++i)
-  {
-    vpColVector p1, p2;
-    createVectorFromPoint(polygon[i].first, p1, K);
-    createVectorFromPoint(polygon[(i + 1) % polygon.size()].first, p2, K);
-
-    drawLineX(p1, p2, makeMbScanLineEdge(polygon[i].first, polygon[(i + 1) % polygon.size()].first), ID, local_scanlines);
-  }
+  for(unsigned int i = 0 ; i < nbPoints ; ++i)
+    drawLineX(&points[3 * i], &points[3 * ((i + 1) % nbPoints)], firstEdge + i, ID);
 
-  createScanLinesFromLocals(scanlines,local_scanlines,w);
+  createScanLinesFromLocals();
 }
 
 /*!
-  Organise local scanlines in a global scanline vector.
+  Organise the local scanlines, i.e. the intersections of a polygon with the
+  scanlines, in the global scanlines.
   It also marks the computed intersections as starting or ending points.
   This function will only be called by the drawPolygons functions.
-
-  \param scanlines : Global scanline vector.
-  \param localScanlines : Local scanline vector (X or Y-axis).
-  \param size : Corresponding size (typically the width or the height).
 */
 void
-vpMbScanLine::createScanLinesFromLocals(std::vector<std::vector<vpMbScanLineSegment> > &scanlines,
-                                        std::vector<std::vector<vpMbScanLineSegment> > &localScanlines,
-                                        const unsigned int &size)
+vpMbScanLine::createScanLinesFromLocals()
 {
-  for(unsigned int j = 0 ; j < size ; ++j)
+  sort(localScanlines.begin(), localScanlines.end(), vpMbScanLineSegmentComparator()); // Not sure its necessary
+
+  bool b_start = true;
+  for(size_t i = 0 ; i < localScanlines.size() ; ++i)
   {
-      std::vector<vpMbScanLineSegment> &scanline = localScanlines[j];
-      sort(scanline.begin(), scanline.end(), vpMbScanLineSegmentComparator()); // Not sure its necessary
+      if (i == 0 || localScanlines[i].scanline != localScanlines[i - 1].scanline)
+          b_start = true;
 
-      bool b_start = true;
-      for(size_t i = 0 ; i < scanline.size() ; ++i)
+      std::vector<vpMbScanLineSegment> &scanline = scanlines[localScanlines[i].scanline].segments;
+      vpMbScanLineSegment s = localScanlines[i].s;
+      if (b_start)
       {
-          vpMbScanLineSegment s = scanline[i];
-          if (b_start)
-          {
-              s.type = START;
-              s.P1 = s.p * s.Z1;
-              b_start = false;
-          }
-          else
-          {
-              vpMbScanLineSegment &prev = scanlines[j].back();
-              s.type = END;
-              s.P1 = prev.P1;
-              s.Z1 = prev.Z1;
-              s.P2 = s.p * s.Z2;
-              prev.P2 = s.P2;
-              prev.Z2 = s.Z2;
-              b_start = true;
-          }
-          scanlines[j].push_back(s);
+          s.type = START;
+          s.P1 = s.p * s.Z1;
+          b_start = false;
+      }
+      else
+      {
+          vpMbScanLineSegment &prev = scanline.back();
+          s.type = END;
+          s.P1 = prev.P1;
+          s.Z1 = prev.Z1;
+          s.P2 = s.p * s.Z2;
+          prev.P2 = s.P2;
+          prev.Z2 = s.Z2;
+          b_start = true;
       }
+      scanline.push_back(s);
   }
 }
 
 /*!
   Render a scene of polygons and compute scanlines intersections in order to use queries.
 
+  The intersections of the polygons with the scanlines are computed in the
+  calling thread, then the Y-axis and X-axis scanlines are processed in
+  parallel (see setNbThreads()). The buffers are kept from one call to the
+  other, so that rendering a scene of the same size doesn't allocate memory.
+
   \param polygons : List of polygons composed by arrays of lines.
   \param listPolyIndices : List of polygons IDs (has to be know when using queries).
   \param cam : Camera parameters.
@@ -332,199 +309,78 @@ vpMbScanLine::createScanLinesFromLocals(std::vector<std::vector<vpMbScanLineSegm
 */
 void
 vpMbScanLine::drawScene(const std::vector<std::vector<std::pair<vpPoint, unsigned int> > * > &polygons,
-                        std::vector<int> listPolyIndices,
+                        const std::vector<int> &listPolyIndices,
                         const vpCameraParameters &cam, unsigned int width, unsigned int height)
 {
   this->w = width;
   this->h = height;
   this->K = cam;
 
-  visibility_samples.clear();
-
-  std::vector<std::vector<vpMbScanLineSegment> > scanlinesY;
-  scanlinesY.resize(h);
-  std::vector<std::vector<vpMbScanLineSegment> > scanlinesX;
-  scanlinesX.resize(w);
+  const unsigned int nbScanlines = h + w;
+  if (scanlines.size() < nbScanlines)
+    scanlines.resize(nbScanlines);
+  for(unsigned int i = 0 ; i < nbScanlines ; ++i)
+    scanlines[i].segments.clear();
+  edges.clear();
 
   mask.resize(h,w,0);
-
-  vpImage<unsigned char> maskY(h,w,0);
-  vpImage<unsigned char> maskX(h,w,0);
+  if (maskBorder != 0)
+  {
+    maskY.resize(h,w,0);
+    maskX.resize(h,w,0);
+  }
 
   primitive_ids.resize(h, w, -1);
 
   for(unsigned int ID = 0 ; ID < polygons.size() ; ++ID)
   {
-      drawPolygonY(*(polygons[ID]), listPolyIndices[ID], scanlinesY);
-      drawPolygonX(*(polygons[ID]), listPolyIndices[ID], scanlinesX);
-  }
-
-  // Y
-  int last_ID = -1;
-  vpMbScanLineSegment last_visible;
-  for(unsigned int y = 0 ; y < scanlinesY.size() ; ++y)
-  {
-      std::vector<vpMbScanLineSegment> &scanline = scanlinesY[y];
-      sort(scanline.begin(), scanline.end(), vpMbScanLineSegmentComparator());
-
-      std::vector<std::pair<double, vpMbScanLineSegment> > stack;
-      for(size_t i = 0 ; i < scanline.size() ; ++i)
-      {
-          const vpMbScanLineSegment &s = scanline[i];
-
-          switch(s.type)
-          {
-          case START:
-              stack.push_back(std::make_pair(s.Z1, s));
-              break;
-          case END:
-              for(size_t j = 0 ; j < stack.size() ; ++j)
-                  if (stack[j].second.ID == s.ID)
-                  {
-                      if (j != stack.size()-1)
-                          stack[j] = stack.back();
-                      stack.pop_back();
-                      break;
-                  }
-              break;
-          case POINT:
-              break;
-          }
-
-          for(size_t j = 0 ; j < stack.size() ; ++j)
-          {
-              const vpMbScanLineSegment &s0 = stack[j].second;
-              stack[j].first = mix(s0.Z1, s0.Z2, getAlpha(s.type == POINT ? s.p : (s.p + 0.5), s0.P1, s0.Z1, s0.P2, s0.Z2));
-          }
-          sort(stack.begin(), stack.end(), vpMbScanLineSegmentComparator());
-
-          int new_ID = stack.empty() ? -1 : stack.front().second.ID;
-
-          if (new_ID != last_ID || s.type == POINT)
-          {
-              if (s.b_sample_Y)
-                  switch(s.type)
-                  {
-                  case POINT:
-                      if (new_ID == -1 || s.Z1 - depthTreshold <= stack.front().first)
-                          visibility_samples[s.edge].insert((int)y);
-                      break;
-                  case START:
-                      if (new_ID == s.ID)
-                          visibility_samples[s.edge].insert((int)y);
-                      break;
-                  case END:
-                      if (last_ID == s.ID)
-                          visibility_samples[s.edge].insert((int)y);
-                      break;
-                  }
-
-              // This part will only be used for MbKltTracking
-              if (last_ID != -1)
-              {
-                  const unsigned int x0 = (std::max)((unsigned int)0, (unsigned int)(std::ceil(last_visible.p)));
-                  const double x1 = (std::min)((double)w, (double)s.p);
-                  for(unsigned int x = x0 + maskBorder ; x < x1 - maskBorder; ++x)
-                  {
-                      primitive_ids[(unsigned int)y][(unsigned int)x] = last_visible.ID;
-
-                      if(maskBorder != 0)
-                        maskY[(unsigned int)y][(unsigned int)x] = 255;
-                      else
-                        mask[(unsigned int)y][(unsigned int)x] = 255;
-                  }
-              }
+      const std::vector<std::pair<vpPoint, unsigned int> > &polygon = *(polygons[ID]);
+      const unsigned int nbPoints = (unsigned int)polygon.size();
+      if (nbPoints < 2)
+        continue;
+
+      points.resize(3 * nbPoints);
+      for(unsigned int i = 0 ; i < nbPoints ; ++i)
+        createVectorFromPoint(polygon[i].first, &points[3 * i], K);
+
+      const unsigned int firstEdge = (unsigned int)edges.size();
+      if (nbPoints == 2)
+        edges.push_back(makeMbScanLineEdge(polygon.front().first, polygon.back().first));
+      else
+        for(unsigned int i = 0 ; i < nbPoints ; ++i)
+          edges.push_back(makeMbScanLineEdge(polygon[i].first, polygon[(i + 1) % nbPoints].first));
 
-              last_ID = new_ID;
-              if (!stack.empty())
-              {
-                  last_visible = stack.front().second;
-                  last_visible.p = s.p;
-              }
-          }
-      }
+      drawPolygonY(nbPoints, firstEdge, listPolyIndices[ID]);
+      drawPolygonX(nbPoints, firstEdge, listPolyIndices[ID]);
   }
 
-  // X
-  last_ID = -1;
-  for(unsigned int x = 0 ; x < scanlinesX.size() ; ++x)
-  {
-      std::vector<vpMbScanLineSegment> &scanline = scanlinesX[x];
-      sort(scanline.begin(), scanline.end(), vpMbScanLineSegmentComparator());
-
-      std::vector<std::pair<double, vpMbScanLineSegment> > stack;
-      for(size_t i = 0 ; i < scanline.size() ; ++i)
-      {
-          const vpMbScanLineSegment &s = scanline[i];
-
-          switch(s.type)
-          {
-          case START:
-              stack.push_back(std::make_pair(s.Z1, s));
-              break;
-          case END:
-              for(size_t j = 0 ; j < stack.size() ; ++j)
-                  if (stack[j].second.ID == s.ID)
-                  {
-                      if (j != stack.size()-1)
-                          stack[j] = stack.back();
-                      stack.pop_back();
-                      break;
-                  }
-              break;
-          case POINT:
-              break;
-          }
-
-          for(size_t j = 0 ; j < stack.size() ; ++j)
-          {
-              const vpMbScanLineSegment &s0 = stack[j].second;
-              stack[j].first = mix(s0.Z1, s0.Z2, getAlpha(s.type == POINT ? s.p : (s.p + 0.5), s0.P1, s0.Z1, s0.P2, s0.Z2));
-          }
-          sort(stack.begin(), stack.end(), vpMbScanLineSegmentComparator());
+  // The edges shared by several polygons get the same index
+  sortedEdges.resize(edges.size());
+  for(size_t i = 0 ; i < edges.size() ; ++i)
+    sortedEdges[i] = std::make_pair(edges[i], (unsigned int)i);
+  sort(sortedEdges.begin(), sortedEdges.end(), vpMbScanLineEdgeComparator());
 
-          int new_ID = stack.empty() ? -1 : stack.front().second.ID;
+  edgeIDs.resize(edges.size());
+  uniqueEdges.clear();
+  for(size_t i = 0 ; i < sortedEdges.size() ; ++i)
+  {
+    if (i == 0 || vpMbScanLineEdgeComparator()(sortedEdges[i - 1].first, sortedEdges[i].first))
+      uniqueEdges.push_back(sortedEdges[i].first);
+    edgeIDs[sortedEdges[i].second] = (unsigned int)uniqueEdges.size() - 1;
+  }
 
-          if (new_ID != last_ID || s.type == POINT)
-          {
-              if (!s.b_sample_Y)
-                  switch(s.type)
-                  {
-                  case POINT:
-                      if (new_ID == -1 || s.Z1 - depthTreshold <= stack.front().first)
-                          visibility_samples[s.edge].insert((int)x);
-                      break;
-                  case START:
-                      if (new_ID == s.ID)
-                          visibility_samples[s.edge].insert((int)x);
-                      break;
-                  case END:
-                      if (last_ID == s.ID)
-                          visibility_samples[s.edge].insert((int)x);
-                      break;
-                  }
-
-              // This part will only be used for MbKltTracking
-              if (maskBorder != 0 && last_ID != -1)
-              {
-                  const unsigned int y0 = (std::max)((unsigned int)0, (unsigned int)(std::ceil(last_visible.p)));
-                  const double y1 = (std::min)((double)h, (double)s.p);
-                  for(unsigned int y = y0 + maskBorder ; y < y1 - maskBorder; ++y)
-                  {
-                      //primitive_ids[(unsigned int)y][(unsigned int)x] = last_visible.ID;
-                      maskX[(unsigned int)y][(unsigned int)x] = 255;
-                  }
-              }
+  vpThreadPool::parallel_for(0, nbScanlines, &computeScanLines, this, nbThreads, 8);
 
-              last_ID = new_ID;
-              if (!stack.empty())
-              {
-                  last_visible = stack.front().second;
-                  last_visible.p = s.p;
-              }
-          }
-      }
+  visibility_samples.clear();
+  for(unsigned int i = 0 ; i < nbScanlines ; ++i)
+  {
+    const std::vector<unsigned int> &samples = scanlines[i].samples;
+    const int v = (int)(i < h ? i : i - h);
+    for(size_t j = 0 ; j < samples.size() ; ++j)
+      visibility_samples.push_back(std::make_pair(edgeIDs[samples[j]], v));
   }
+  sort(visibility_samples.begin(), visibility_samples.end());
+  visibility_samples.erase(std::unique(visibility_samples.begin(), visibility_samples.end()), visibility_samples.end());
 
   if(maskBorder != 0)
     for(unsigned int i = 0 ; i < h ; i++)
@@ -566,6 +422,143 @@ vpMbScanLine::drawScene(const std::vector<std::vector<std::pair<vpPoint, unsigne
 
 }
 
+/*!
+  Loop body of vpThreadPool::parallel_for() over the scanlines.
+
+  \param begin, end : Range of scanlines, the Y-axis scanlines being first.
+  \param args : Pointer to the vpMbScanLine.
+*/
+void
+vpMbScanLine::computeScanLines(unsigned int begin, unsigned int end, void *args)
+{
+  vpMbScanLine *renderer = static_cast<vpMbScanLine *>(args);
+  for(unsigned int i = begin ; i < end ; ++i)
+    renderer->computeScanLine(i);
+}
+
+/*!
+  Sweep a scanline to find the visible polygon between two intersections: it
+  fills the visibility samples of the scanline and the masks. Different
+  scanlines write different rows (Y-axis) or columns (X-axis) of the masks, so
+  that they can be processed in parallel.
+
+  \param index : Index of the scanline, the Y-axis scanlines being first.
+*/
+void
+vpMbScanLine::computeScanLine(const unsigned int index)
+{
+  vpMbScanLineBuffer &buffer = scanlines[index];
+  std::vector<vpMbScanLineSegment> &scanline = buffer.segments;
+  std::vector<std::pair<double, vpMbScanLineSegment> > &stack = buffer.stack;
+  const bool b_axis_Y = (index < h);
+  const unsigned int v = b_axis_Y ? index : index - h;
+
+  buffer.samples.clear();
+  stack.clear();
+  sort(scanline.begin(), scanline.end(), vpMbScanLineSegmentComparator());
+
+  int last_ID = -1;
+  vpMbScanLineSegment last_visible;
+  for(size_t i = 0 ; i < scanline.size() ; ++i)
+  {
+      const vpMbScanLineSegment &s = scanline[i];
+
+      switch(s.type)
+      {
+      case START:
+          stack.push_back(std::make_pair(s.Z1, s));
+          break;
+      case END:
+          for(size_t j = 0 ; j < stack.size() ; ++j)
+              if (stack[j].second.ID == s.ID)
+              {
+                  if (j != stack.size()-1)
+                      stack[j] = stack.back();
+                  stack.pop_back();
+                  break;
+              }
+          break;
+      case POINT:
+          break;
+      }
+
+      for(size_t j = 0 ; j < stack.size() ; ++j)
+      {
+          const vpMbScanLineSegment &s0 = stack[j].second;
+          stack[j].first = mix(s0.Z1, s0.Z2, getAlpha(s.type == POINT ? s.p : (s.p + 0.5), s0.P1, s0.Z1, s0.P2, s0.Z2));
+      }
+
+      // The stack is kept sorted by depth from one intersection to the next, so that an insertion sort is
+      // almost linear. The ID breaks the ties, so that the front does not depend on the sort algorithm.
+      vpMbScanLineSegmentComparator less;
+      for(size_t j = 1 ; j < stack.size() ; ++j)
+      {
+          if (less(stack[j], stack[j - 1]))
+          {
+              const std::pair<double, vpMbScanLineSegment> tmp = stack[j];
+              size_t k = j;
+              for( ; k > 0 && less(tmp, stack[k - 1]) ; --k)
+                  stack[k] = stack[k - 1];
+              stack[k] = tmp;
+          }
+      }
+
+      int new_ID = stack.empty() ? -1 : stack.front().second.ID;
+
+      if (new_ID != last_ID || s.type == POINT)
+      {
+          if (s.b_sample_Y == b_axis_Y)
+              switch(s.type)
+              {
+              case POINT:
+                  if (new_ID == -1 || s.Z1 - depthTreshold <= stack.front().first)
+                      buffer.samples.push_back(s.edge);
+                  break;
+              case START:
+                  if (new_ID == s.ID)
+                      buffer.samples.push_back(s.edge);
+                  break;
+              case END:
+                  if (last_ID == s.ID)
+                      buffer.samples.push_back(s.edge);
+                  break;
+              }
+
+          // This part will only be used for MbKltTracking
+          if (b_axis_Y && last_ID != -1)
+          {
+              const unsigned int x0 = (std::max)((unsigned int)0, (unsigned int)(std::ceil(last_visible.p)));
+              const double x1 = (std::min)((double)w, (double)s.p);
+              for(unsigned int x = x0 + maskBorder ; x < x1 - maskBorder; ++x)
+              {
+                  primitive_ids[v][x] = last_visible.ID;
+
+                  if(maskBorder != 0)
+                    maskY[v][x] = 255;
+                  else
+                    mask[v][x] = 255;
+              }
+          }
+          else if (!b_axis_Y && maskBorder != 0 && last_ID != -1)
+          {
+              const unsigned int y0 = (std::max)((unsigned int)0, (unsigned int)(std::ceil(last_visible.p)));
+              const double y1 = (std::min)((double)h, (double)s.p);
+              for(unsigned int y = y0 + maskBorder ; y < y1 - maskBorder; ++y)
+              {
+                  maskX[y][v] = 255;
+              }
+          }
+
+          last_ID = new_ID;
+          if (!stack.empty())
+          {
+              last_visible = stack.front().second;
+              last_visible.p = s.p;
+          }
+      }
+  }
+}
+
 /*!
   Test the visibility of a line. As a result, a subsampled line of the given one with all its visible parts.
 
@@ -579,7 +572,7 @@ vpMbScanLine::queryLineVisibility(const vpPoint &a, const vpPoint &b,
                                   std::vector<std::pair<vpPoint, vpPoint> > &lines,
                                   const bool &displayResults)
 {
-  vpColVector _a, _b;
+  double _a[3], _b[3];
   createVectorFromPoint(a, _a, K);
   createVectorFromPoint(b, _b, K);
 
@@ -606,7 +599,20 @@ vpMbScanLine::queryLineVisibility(const vpPoint &a, const vpPoint &b,
 #endif
   }
 
-  if (!visibility_samples.count(edge))
+  // The query is read-only, so that it may be issued concurrently when the moving edges are tracked in parallel
+  // threads
+  const std::vector<vpMbScanLineEdge>::const_iterator it_edge =
+      std::lower_bound(uniqueEdges.begin(), uniqueEdges.end(), edge, vpMbScanLineEdgeComparator());
+  if (it_edge == uniqueEdges.end() || vpMbScanLineEdgeComparator()(edge, *it_edge))
+      return;
+
+  const unsigned int edgeID = (unsigned int)(it_edge - uniqueEdges.begin());
+  const std::vector<std::pair<unsigned int, int> > &samples = visibility_samples;
+  const std::vector<std::pair<unsigned int, int> >::const_iterator samples_begin =
+      std::lower_bound(samples.begin(), samples.end(), std::make_pair(edgeID, (std::numeric_limits<int>::min)()));
+  const std::vector<std::pair<unsigned int, int> >::const_iterator samples_end =
+      std::lower_bound(samples_begin, samples.end(), std::make_pair(edgeID + 1, (std::numeric_limits<int>::min)()));
+  if (samples_begin == samples_end)
       return;
 
   // Initialized as the biggest difference between the two points is on the X-axis
@@ -648,14 +654,13 @@ vpMbScanLine::queryLineVisibility(const vpPoint &a, const vpPoint &b,
   const int _v0 = (std::max)(0, int(std::ceil(*v0)));
   const int _v1 = (std::min)((int)(size - 1), (int)(std::ceil(*v1) - 1));
 
-  const std::set<int> &visible_samples = visibility_samples[edge];
   int last = _v0;
   vpPoint line_start;
   vpPoint line_end;
   bool b_line_started = false;
-  for(std::set<int>::const_iterator it = visible_samples.begin() ; it != visible_samples.end() ; ++it)
+  for(std::vector<std::pair<unsigned int, int> >::const_iterator it = samples_begin ; it != samples_end ; ++it)
   {
-      const int v = *it;
+      const int v = it->second;
       const double alpha = getAlpha(v, (*v0) * (*w0), (*w0), (*v1) * (*w1), (*w1));
       //const vpPoint p = mix(a, b, alpha);
       const vpPoint p = mix(a_, b_, alpha);
@@ -719,8 +724,9 @@ vpMbScanLine::queryLineVisibility(const vpPoint &a, const vpPoint &b,
 vpMbScanLine::vpMbScanLineEdge
 vpMbScanLine::makeMbScanLineEdge(const vpPoint &a, const vpPoint &b)
 {
-  vpColVector _a(3);
-  vpColVector _b(3);
+  vpMbScanLineEdge edge;
+  double *_a = edge.first;
+  double *_b = edge.second;
 
   _a[0] = std::ceil((a.get_X() * 1e8) * 1e-6);
   _a[1] = std::ceil((a.get_Y() * 1e8) * 1e-6);
@@ -740,24 +746,23 @@ vpMbScanLine::makeMbScanLineEdge(const vpPoint &a, const vpPoint &b)
     else if(_a[i] > _b[i])
       break;
 
-  if (b_comp)
-    return std::make_pair(_a, _b);
+  if (!b_comp)
+    for(unsigned int i = 0 ; i < 3 ; ++i)
+      std::swap(_a[i], _b[i]);
 
-  return std::make_pair(_b, _a);
+  return edge;
 }
 
 /*!
   Create a vpColVector of a projected point.
 
   \param p : Point to project.
-  \param v : Resulting vector.
+  \param v : Resulting 3-dimension vector.
   \param K : Camera parameters.
 */
 void
-vpMbScanLine::createVectorFromPoint(const vpPoint &p, vpColVector &v, const vpCameraParameters &K)
+vpMbScanLine::createVectorFromPoint(const vpPoint &p, double *v, const vpCameraParameters &K)
 {
-    v = vpColVector(3);
-
     v[0] = p.get_X() * K.get_px() + K.get_u0() * p.get_Z();
     v[1] = p.get_Y() * K.get_py() + K.get_v0() * p.get_Z();
     v[2] = p.get_Z();
@@ -0,0 +1,257 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the parallel tracking of the moving edges of vpMbEdgeTracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbEdgeTrackerThreads.cpp
+
+  \brief Track a cube in a synthetic sequence rendered by vpImageSimulator
+  with two vpMbEdgeTracker, one that tracks the moving edges in the calling
+  thread and one that uses 4 threads, see setNbMovingEdgeThreads(). Check
+  that the poses and the moving edges of each line are the same, and that the
+  poses are close to the ground truth.
+*/
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/mbt/vpMbEdgeTracker.h>
+#include <visp3/robot/vpImageSimulator.h>
+
+#include <stdlib.h>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <string>
+
+namespace {
+  const double cubeSize = 0.2;
+  const unsigned int nbFrames = 20;
+
+  // Corners of the faces of the cube, the indexes being the ones of the model
+  const double cubeVertices[8][3] = { { 0, 0, 0 }, { -1, 0, 0 }, { -1, 1, 0 }, { 0, 1, 0 },
+                                      { 0, 0, 1 }, { -1, 0, 1 }, { -1, 1, 1 }, { 0, 1, 1 } };
+  const unsigned int cubeFaces[6][4] = { { 0, 4, 5, 1 }, { 1, 5, 6, 2 }, { 6, 7, 3, 2 },
+                                         { 3, 7, 4, 0 }, { 0, 1, 2, 3 }, { 7, 6, 5, 4 } };
+
+  void writeModel(const std::string &filename)
+  {
+    std::ofstream file(filename.c_str());
+    file << "V1\n8\n";
+    for (unsigned int k = 0; k < 8; k++)
+      file << cubeSize * cubeVertices[k][0] << " " << cubeSize * cubeVertices[k][1] << " "
+           << cubeSize * cubeVertices[k][2] << "\n";
+    file << "0\n0\n6\n";
+    for (unsigned int f = 0; f < 6; f++)
+      file << "4 " << cubeFaces[f][0] << " " << cubeFaces[f][1] << " " << cubeFaces[f][2] << " " << cubeFaces[f][3]
+           << "\n";
+    file << "0\n0\n";
+  }
+
+  // One uniform grey level per face, each face being added with both orientations since vpImageSimulator only
+  // renders the faces that are seen from one side
+  void createScene(std::list<vpImageSimulator> &scene)
+  {
+    const unsigned char colors[6] = { 80, 140, 200, 110, 170, 230 };
+    for (unsigned int f = 0; f < 6; f++) {
+      vpImage<unsigned char> texture(4, 4, colors[f]);
+      for (unsigned int side = 0; side < 2; side++) {
+        vpColVector X[4];
+        for (unsigned int k = 0; k < 4; k++) {
+          const unsigned int v = cubeFaces[f][side ? 3 - k : k];
+          X[k].resize(3);
+          for (unsigned int c = 0; c < 3; c++)
+            X[k][c] = cubeSize * cubeVertices[v][c];
+        }
+        vpImageSimulator sim(vpImageSimulator::GRAY_SCALED);
+        sim.init(texture, X);
+        scene.push_back(sim);
+      }
+    }
+  }
+
+  void render(std::list<vpImageSimulator> &scene, const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
+              vpImage<unsigned char> &I)
+  {
+    I = 20;
+    for (std::list<vpImageSimulator>::iterator it = scene.begin(); it != scene.end(); ++it)
+      it->setCameraPosition(cMo);
+    vpImageSimulator::getImage(I, scene, cam);
+  }
+
+  // Pose of the camera at frame k, the cube being seen from one of its corners
+  vpHomogeneousMatrix getPose(const unsigned int k)
+  {
+    vpHomogeneousMatrix cMcenter;
+    cMcenter.buildFrom(0.003 * k, -0.002 * k, 0.8 + 0.004 * k, vpMath::rad(30 + 0.5 * k), vpMath::rad(-35 + 0.5 * k),
+                       vpMath::rad(0.3 * k));
+    return cMcenter * vpHomogeneousMatrix(cubeSize / 2, -cubeSize / 2, -cubeSize / 2, 0, 0, 0);
+  }
+
+  vpMbEdgeTracker *createTracker(const vpCameraParameters &cam, const std::string &model, const unsigned int nbThreads)
+  {
+    vpMbEdgeTracker *tracker = new vpMbEdgeTracker;
+    vpMe me;
+    me.setMaskSize(5);
+    me.setMaskNumber(180);
+    me.setRange(10);
+    me.setThreshold(10000);
+    me.setMu1(0.5);
+    me.setMu2(0.5);
+    me.setSampleStep(4);
+    tracker->setMovingEdge(me);
+    tracker->setCameraParameters(cam);
+    tracker->setAngleAppear(vpMath::rad(70));
+    tracker->setAngleDisappear(vpMath::rad(80));
+    // The model uses rand() to place the moving edges of the lines
+    srand(0);
+    tracker->loadModel(model);
+    tracker->setNbMovingEdgeThreads(nbThreads);
+    return tracker;
+  }
+
+  // Compare the moving edges of the lines of both trackers
+  bool compareMovingEdges(const vpMbEdgeTracker &tracker, const vpMbEdgeTracker &tracker_threads,
+                          const unsigned int frame)
+  {
+    std::list<vpMbtDistanceLine *> lines, lines_threads;
+    tracker.getLline(lines);
+    tracker_threads.getLline(lines_threads);
+    if (lines.size() != lines_threads.size()) {
+      std::cerr << "The number of lines differ at frame " << frame << std::endl;
+      return false;
+    }
+
+    std::list<vpMbtDistanceLine *>::const_iterator it_threads = lines_threads.begin();
+    for (std::list<vpMbtDistanceLine *>::const_iterator it = lines.begin(); it != lines.end(); ++it, ++it_threads) {
+      const vpMbtDistanceLine *l = *it, *l_threads = *it_threads;
+      if (l->isTracked() != l_threads->isTracked() || l->isVisible() != l_threads->isVisible()
+          || l->meline.size() != l_threads->meline.size() || l->nbFeatureTotal != l_threads->nbFeatureTotal) {
+        std::cerr << "The line " << l->getName() << " differs at frame " << frame << std::endl;
+        return false;
+      }
+      for (size_t m = 0; m < l->meline.size(); m++) {
+        const vpMbtMeLine *me = l->meline[m], *me_threads = l_threads->meline[m];
+        if ((me == NULL) != (me_threads == NULL))
+          return false;
+        if (me == NULL)
+          continue;
+        const std::list<vpMeSite> sites = me->getMeList(), sites_threads = me_threads->getMeList();
+        bool equal = me->get_a() == me_threads->get_a() && me->get_b() == me_threads->get_b()
+                     && me->get_c() == me_threads->get_c() && sites.size() == sites_threads.size();
+        std::list<vpMeSite>::const_iterator s_threads = sites_threads.begin();
+        for (std::list<vpMeSite>::const_iterator s = sites.begin(); equal && s != sites.end(); ++s, ++s_threads) {
+          equal = s->ifloat == s_threads->ifloat && s->jfloat == s_threads->jfloat && s->alpha == s_threads->alpha
+                  && s->convlt == s_threads->convlt && s->weight == s_threads->weight
+                  && s->getState() == s_threads->getState();
+        }
+        if (!equal) {
+          std::cerr << "The moving edges of the line " << l->getName() << " differ at frame " << frame << std::endl;
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    const std::string model = "testMbEdgeTrackerThreads.cao";
+    writeModel(model);
+
+    vpCameraParameters cam(600, 600, 320, 240);
+    std::list<vpImageSimulator> scene;
+    createScene(scene);
+
+    vpMbEdgeTracker *tracker = createTracker(cam, model, 1);
+    vpMbEdgeTracker *tracker_threads = createTracker(cam, model, 4);
+
+    vpImage<unsigned char> I(480, 640);
+    double error_t = 0, error_r = 0;
+    unsigned int nbSites = 0;
+    for (unsigned int k = 0; k < nbFrames; k++) {
+      const vpHomogeneousMatrix cdMo = getPose(k);
+      render(scene, cdMo, cam, I);
+
+      if (k == 0) {
+        tracker->initFromPose(I, cdMo);
+        tracker_threads->initFromPose(I, cdMo);
+      }
+      else {
+        tracker->track(I);
+        tracker_threads->track(I);
+        nbSites = vpMath::maximum(nbSites, tracker->getNbPoints());
+      }
+
+      vpHomogeneousMatrix cMo, cMo_threads;
+      tracker->getPose(cMo);
+      tracker_threads->getPose(cMo_threads);
+      for (unsigned int i = 0; i < 4; i++) {
+        for (unsigned int j = 0; j < 4; j++) {
+          if (cMo[i][j] != cMo_threads[i][j]) {
+            std::cerr << "The poses differ at frame " << k << ":\n" << cMo << "\nand with 4 threads:\n"
+                      << cMo_threads << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+      }
+      if (!compareMovingEdges(*tracker, *tracker_threads, k))
+        return EXIT_FAILURE;
+
+      const vpHomogeneousMatrix cdMc = cdMo * cMo.inverse();
+      error_t = vpMath::maximum(error_t, cdMc.getTranslationVector().euclideanNorm());
+      error_r = vpMath::maximum(error_r, vpThetaUVector(cdMc.getRotationMatrix()).getTheta());
+    }
+
+    delete tracker;
+    delete tracker_threads;
+    vpIoTools::remove(model);
+
+    std::cout << "At most " << nbSites << " moving edges, maximal error: " << error_t * 1000 << " mm, "
+              << vpMath::deg(error_r) << " deg" << std::endl;
+    if (nbSites == 0 || error_t > 0.01 || error_r > vpMath::rad(1)) {
+      std::cerr << "The pose is not tracked" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "testMbEdgeTrackerThreads is ok." << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,235 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the parallel tracking of the cameras of vpMbGenericTracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbGenericTrackerParallel.cpp
+
+  \brief Track a cube seen by three cameras in a synthetic sequence rendered
+  by vpImageSimulator with two vpMbGenericTracker edge trackers, one with the
+  sequential tracking of the cameras and one with setUseParallelTracking().
+  Check that the poses are the same and close to the ground truth.
+*/
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/mbt/vpMbGenericTracker.h>
+#include <visp3/robot/vpImageSimulator.h>
+
+#include <stdlib.h>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+  const double cubeSize = 0.2;
+  const unsigned int nbFrames = 20;
+
+  // Corners of the faces of the cube, the indexes being the ones of the model
+  const double cubeVertices[8][3] = { { 0, 0, 0 }, { -1, 0, 0 }, { -1, 1, 0 }, { 0, 1, 0 },
+                                      { 0, 0, 1 }, { -1, 0, 1 }, { -1, 1, 1 }, { 0, 1, 1 } };
+  const unsigned int cubeFaces[6][4] = { { 0, 4, 5, 1 }, { 1, 5, 6, 2 }, { 6, 7, 3, 2 },
+                                         { 3, 7, 4, 0 }, { 0, 1, 2, 3 }, { 7, 6, 5, 4 } };
+
+  void writeModel(const std::string &filename)
+  {
+    std::ofstream file(filename.c_str());
+    file << "V1\n8\n";
+    for (unsigned int k = 0; k < 8; k++)
+      file << cubeSize * cubeVertices[k][0] << " " << cubeSize * cubeVertices[k][1] << " "
+           << cubeSize * cubeVertices[k][2] << "\n";
+    file << "0\n0\n6\n";
+    for (unsigned int f = 0; f < 6; f++)
+      file << "4 " << cubeFaces[f][0] << " " << cubeFaces[f][1] << " " << cubeFaces[f][2] << " " << cubeFaces[f][3]
+           << "\n";
+    file << "0\n0\n";
+  }
+
+  // One uniform grey level per face, each face being added with both orientations since vpImageSimulator only
+  // renders the faces that are seen from one side
+  void createScene(std::list<vpImageSimulator> &scene)
+  {
+    const unsigned char colors[6] = { 80, 140, 200, 110, 170, 230 };
+    for (unsigned int f = 0; f < 6; f++) {
+      vpImage<unsigned char> texture(4, 4, colors[f]);
+      for (unsigned int side = 0; side < 2; side++) {
+        vpColVector X[4];
+        for (unsigned int k = 0; k < 4; k++) {
+          const unsigned int v = cubeFaces[f][side ? 3 - k : k];
+          X[k].resize(3);
+          for (unsigned int c = 0; c < 3; c++)
+            X[k][c] = cubeSize * cubeVertices[v][c];
+        }
+        vpImageSimulator sim(vpImageSimulator::GRAY_SCALED);
+        sim.init(texture, X);
+        scene.push_back(sim);
+      }
+    }
+  }
+
+  void render(std::list<vpImageSimulator> &scene, const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
+              vpImage<unsigned char> &I)
+  {
+    I = 20;
+    for (std::list<vpImageSimulator>::iterator it = scene.begin(); it != scene.end(); ++it)
+      it->setCameraPosition(cMo);
+    vpImageSimulator::getImage(I, scene, cam);
+  }
+
+  // Pose of the first camera at frame k, the cube being seen from one of its corners
+  vpHomogeneousMatrix getPose(const unsigned int k)
+  {
+    vpHomogeneousMatrix cMcenter;
+    cMcenter.buildFrom(0.003 * k, -0.002 * k, 0.8 + 0.004 * k, vpMath::rad(30 + 0.5 * k), vpMath::rad(-35 + 0.5 * k),
+                       vpMath::rad(0.3 * k));
+    return cMcenter * vpHomogeneousMatrix(cubeSize / 2, -cubeSize / 2, -cubeSize / 2, 0, 0, 0);
+  }
+
+  vpMbGenericTracker *createTracker(const std::vector<std::string> &names, const vpCameraParameters &cam,
+                                    const std::map<std::string, vpHomogeneousMatrix> &mapOfCameraTransformations,
+                                    const std::string &model, const bool parallel)
+  {
+    vpMbGenericTracker *tracker = new vpMbGenericTracker((unsigned int)names.size(), vpMbGenericTracker::EDGE_TRACKER);
+    vpMe me;
+    me.setMaskSize(5);
+    me.setMaskNumber(180);
+    me.setRange(10);
+    me.setThreshold(10000);
+    me.setMu1(0.5);
+    me.setMu2(0.5);
+    me.setSampleStep(4);
+    tracker->setMovingEdge(me);
+    tracker->setCameraParameters(cam);
+    tracker->setAngleAppear(vpMath::rad(70));
+    tracker->setAngleDisappear(vpMath::rad(80));
+    tracker->setCameraTransformationMatrix(mapOfCameraTransformations);
+    // The model uses rand() to place the moving edges of the lines
+    srand(0);
+    tracker->loadModel(model);
+    tracker->setUseParallelTracking(parallel);
+    return tracker;
+  }
+}
+
+int main()
+{
+  try {
+    const std::string model = "testMbGenericTrackerParallel.cao";
+    writeModel(model);
+
+    const unsigned int nbThreads = vpThreadPool::getNbThreads();
+    vpThreadPool::setNbThreads(4);
+
+    vpCameraParameters cam(600, 600, 320, 240);
+    std::list<vpImageSimulator> scene;
+    createScene(scene);
+
+    // Three cameras around the first one
+    std::vector<vpHomogeneousMatrix> cMc1(3);
+    cMc1[1].buildFrom(-0.15, 0, 0.02, 0, vpMath::rad(10), 0);
+    cMc1[2].buildFrom(0.15, 0.05, 0, vpMath::rad(-3), vpMath::rad(-10), 0);
+
+    vpMbGenericTracker tracker_names(3, vpMbGenericTracker::EDGE_TRACKER);
+    const std::vector<std::string> names = tracker_names.getCameraNames();
+    std::map<std::string, vpHomogeneousMatrix> mapOfCameraTransformations;
+    for (size_t c = 0; c < names.size(); c++)
+      mapOfCameraTransformations[names[c]] = cMc1[c];
+
+    vpMbGenericTracker *tracker = createTracker(names, cam, mapOfCameraTransformations, model, false);
+    vpMbGenericTracker *tracker_parallel = createTracker(names, cam, mapOfCameraTransformations, model, true);
+
+    std::vector<vpImage<unsigned char> > I(names.size(), vpImage<unsigned char>(480, 640));
+    std::map<std::string, const vpImage<unsigned char> *> mapOfImages;
+    std::map<std::string, vpHomogeneousMatrix> mapOfPoses;
+    for (size_t c = 0; c < names.size(); c++)
+      mapOfImages[names[c]] = &I[c];
+
+    double error_t = 0, error_r = 0;
+    for (unsigned int k = 0; k < nbFrames; k++) {
+      const vpHomogeneousMatrix c1Mo = getPose(k);
+      for (size_t c = 0; c < names.size(); c++) {
+        render(scene, cMc1[c] * c1Mo, cam, I[c]);
+        mapOfPoses[names[c]] = cMc1[c] * c1Mo;
+      }
+
+      if (k == 0) {
+        tracker->initFromPose(mapOfImages, mapOfPoses);
+        tracker_parallel->initFromPose(mapOfImages, mapOfPoses);
+        continue;
+      }
+      tracker->track(mapOfImages);
+      tracker_parallel->track(mapOfImages);
+
+      vpHomogeneousMatrix cMo, cMo_parallel;
+      tracker->getPose(cMo);
+      tracker_parallel->getPose(cMo_parallel);
+      for (unsigned int i = 0; i < 4; i++) {
+        for (unsigned int j = 0; j < 4; j++) {
+          if (cMo[i][j] != cMo_parallel[i][j]) {
+            std::cerr << "The poses differ at frame " << k << ":\n" << cMo << "\nand with parallel tracking:\n"
+                      << cMo_parallel << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+      }
+
+      const vpHomogeneousMatrix cdMc = c1Mo * cMo.inverse();
+      error_t = vpMath::maximum(error_t, cdMc.getTranslationVector().euclideanNorm());
+      error_r = vpMath::maximum(error_r, vpThetaUVector(cdMc.getRotationMatrix()).getTheta());
+    }
+
+    delete tracker;
+    delete tracker_parallel;
+    vpThreadPool::setNbThreads(nbThreads);
+    vpIoTools::remove(model);
+
+    std::cout << "Maximal error: " << error_t * 1000 << " mm, " << vpMath::deg(error_r) << " deg" << std::endl;
+    if (error_t > 0.005 || error_r > vpMath::rad(1)) {
+      std::cerr << "The pose is not tracked" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "testMbGenericTrackerParallel is ok." << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
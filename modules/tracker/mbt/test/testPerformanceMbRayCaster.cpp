@@ -0,0 +1,264 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test performance of the CPU ray casting visibility of the model-based trackers.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceMbRayCaster.cpp
+
+  \brief Test the visibility of the faces of a sphere of 1000 faces partially
+  hidden by a square with the CPU ray casting of vpMbHiddenFaces, compare the
+  occlusions given by vpMbRayCaster with a brute force test of all the
+  triangles, and print the time of both.
+*/
+
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/mbt/vpMbHiddenFaces.h>
+#include <visp3/mbt/vpMbRayCaster.h>
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+  vpPoint createPoint(double X, double Y, double Z)
+  {
+    vpPoint P;
+    P.setWorldCoordinates(X, Y, Z);
+    return P;
+  }
+
+  // Sphere of nbLat x nbLon faces oriented toward the outside, the faces at the poles being triangles, and a square
+  // in front of the sphere
+  void createScene(unsigned int nbLat, unsigned int nbLon, std::vector<std::vector<vpPoint> > &polygons)
+  {
+    const double R = 0.3, Zc = 1.0;
+    for (unsigned int i = 0; i < nbLat; i++) {
+      for (unsigned int j = 0; j < nbLon; j++) {
+        const double t0 = M_PI * i / nbLat, t1 = M_PI * (i + 1) / nbLat;
+        const double p0 = 2 * M_PI * (j + 0.3) / nbLon, p1 = 2 * M_PI * (j + 1.3) / nbLon;
+        std::vector<vpPoint> polygon;
+        polygon.push_back(createPoint(R * sin(t0) * cos(p0), R * cos(t0), Zc + R * sin(t0) * sin(p0)));
+        if (i != 0)
+          polygon.push_back(createPoint(R * sin(t0) * cos(p1), R * cos(t0), Zc + R * sin(t0) * sin(p1)));
+        polygon.push_back(createPoint(R * sin(t1) * cos(p1), R * cos(t1), Zc + R * sin(t1) * sin(p1)));
+        if (i != nbLat - 1)
+          polygon.push_back(createPoint(R * sin(t1) * cos(p0), R * cos(t1), Zc + R * sin(t1) * sin(p0)));
+        polygons.push_back(polygon);
+      }
+    }
+
+    std::vector<vpPoint> square;
+    square.push_back(createPoint(-0.1, -0.05, 0.6));
+    square.push_back(createPoint(-0.1, 0.3, 0.65));
+    square.push_back(createPoint(0.2, 0.3, 0.65));
+    square.push_back(createPoint(0.2, -0.05, 0.6));
+    polygons.push_back(square);
+  }
+
+  // Occlusion of the segment [O, T] by the triangles of the other faces, tested one by one
+  bool isOccluded(const std::vector<std::vector<vpPoint> > &polygons, const vpTranslationVector &O,
+                  const vpMbRayCasterRay &ray)
+  {
+    const double d[3] = { ray.target[0] - O[0], ray.target[1] - O[1], ray.target[2] - O[2] };
+    for (unsigned int f = 0; f < polygons.size(); f++) {
+      if (f == ray.id)
+        continue;
+      const vpPoint &v0 = polygons[f][0];
+      for (size_t k = 1; k + 1 < polygons[f].size(); k++) {
+        const vpPoint &v1 = polygons[f][k], &v2 = polygons[f][k + 1];
+        const double e1[3] = { v1.get_oX() - v0.get_oX(), v1.get_oY() - v0.get_oY(), v1.get_oZ() - v0.get_oZ() };
+        const double e2[3] = { v2.get_oX() - v0.get_oX(), v2.get_oY() - v0.get_oY(), v2.get_oZ() - v0.get_oZ() };
+        const double s[3] = { O[0] - v0.get_oX(), O[1] - v0.get_oY(), O[2] - v0.get_oZ() };
+        const double p[3] = { d[1]*e2[2] - d[2]*e2[1], d[2]*e2[0] - d[0]*e2[2], d[0]*e2[1] - d[1]*e2[0] };
+        const double q[3] = { s[1]*e1[2] - s[2]*e1[1], s[2]*e1[0] - s[0]*e1[2], s[0]*e1[1] - s[1]*e1[0] };
+        const double det = e1[0]*p[0] + e1[1]*p[1] + e1[2]*p[2];
+        if (det == 0)
+          continue;
+        const double u = (s[0]*p[0] + s[1]*p[1] + s[2]*p[2]) / det;
+        const double v = (d[0]*q[0] + d[1]*q[1] + d[2]*q[2]) / det;
+        const double t = (e2[0]*q[0] + e2[1]*q[1] + e2[2]*q[2]) / det;
+        if (u >= 0 && v >= 0 && u + v <= 1 && t > 1e-6 && t < 1 - 1e-4)
+          return true;
+      }
+    }
+    return false;
+  }
+
+  // nbRays rays toward random points of each face
+  void createRays(const std::vector<std::vector<vpPoint> > &polygons, unsigned int nbRays,
+                  std::vector<vpMbRayCasterRay> &rays)
+  {
+    rays.clear();
+    for (unsigned int f = 0; f < polygons.size(); f++) {
+      for (unsigned int r = 0; r < nbRays; r++) {
+        vpMbRayCasterRay ray;
+        ray.target[0] = ray.target[1] = ray.target[2] = 0;
+        ray.id = f;
+        ray.occluded = false;
+        double total = 0;
+        for (size_t k = 0; k < polygons[f].size(); k++) {
+          const double w = (rand() % 100 + 1) / 100.0;
+          ray.target[0] += w * polygons[f][k].get_oX();
+          ray.target[1] += w * polygons[f][k].get_oY();
+          ray.target[2] += w * polygons[f][k].get_oZ();
+          total += w;
+        }
+        for (unsigned int k = 0; k < 3; k++)
+          ray.target[k] /= total;
+        rays.push_back(ray);
+      }
+    }
+  }
+}
+
+int main()
+{
+  try {
+    const unsigned int nbIter = 20, nbRays = 10;
+    srand(0);
+
+    std::vector<std::vector<vpPoint> > polygons;
+    createScene(25, 40, polygons);
+    std::cout << "Scene of " << polygons.size() << " faces" << std::endl;
+
+    vpMbRayCaster caster, caster_threads;
+    for (unsigned int f = 0; f < polygons.size(); f++) {
+      caster.addPolygon(polygons[f], f);
+      caster_threads.addPolygon(polygons[f], f);
+    }
+    caster.setNbThreads(1);
+    caster.build();
+    caster_threads.setNbThreads(4);
+    caster_threads.build();
+
+    // Occlusions of random rays compared with the brute force test, and with 4 threads
+    vpTranslationVector O(0.01, -0.02, 0);
+    std::vector<vpMbRayCasterRay> rays, rays_threads;
+    createRays(polygons, nbRays, rays);
+    rays_threads = rays;
+    caster.castRays(O, rays);
+    caster_threads.castRays(O, rays_threads);
+
+    unsigned int nbOccluded = 0, nbDifferent = 0;
+    for (size_t r = 0; r < rays.size(); r++) {
+      if (rays[r].occluded != rays_threads[r].occluded) {
+        std::cerr << "The occlusions with 4 threads differ" << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (rays[r].occluded != isOccluded(polygons, O, rays[r]))
+        nbDifferent++;
+      if (rays[r].occluded)
+        nbOccluded++;
+    }
+    std::cout << nbOccluded << " rays occluded out of " << rays.size() << ", " << nbDifferent
+              << " differ from the brute force test" << std::endl;
+    // Rays grazing an edge may be classified differently in float and double
+    if (nbDifferent > rays.size() / 1000) {
+      std::cerr << "The occlusions differ from the brute force test" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Visibility of the faces with vpMbHiddenFaces
+    vpMbHiddenFaces<vpMbtPolygon> faces;
+    for (unsigned int f = 0; f < polygons.size(); f++) {
+      vpMbtPolygon polygon;
+      polygon.setNbPoint((unsigned int)polygons[f].size());
+      for (unsigned int k = 0; k < polygons[f].size(); k++)
+        polygon.addPoint(k, polygons[f][k]);
+      polygon.setIndex((int)f);
+      faces.addPolygon(&polygon);
+    }
+    faces.setRayCastingVisibilityTest(true);
+
+    vpHomogeneousMatrix cMo;
+    bool changed = false;
+    const unsigned int nbVisible = faces.setVisible(cMo, vpMath::rad(89), vpMath::rad(89), changed);
+    if (!faces.isVisible((unsigned int)polygons.size() - 1)) {
+      std::cerr << "The square should be visible" << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (unsigned int f = 0; f + 1 < polygons.size(); f++) {
+      double Z = 0;
+      for (size_t k = 0; k < polygons[f].size(); k++)
+        Z += polygons[f][k].get_oZ() / polygons[f].size();
+      if (Z > 1.05 && faces.isVisible(f)) {
+        std::cerr << "A face of the back of the sphere is visible" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    std::cout << nbVisible << " visible faces" << std::endl;
+
+    // The faces hidden by the square with the simple visibility test are visible without the ray casting
+    faces.setRayCastingVisibilityTest(false);
+    const unsigned int nbVisibleNoOcclusion = faces.setVisible(cMo, vpMath::rad(89), vpMath::rad(89), changed);
+    if (nbVisibleNoOcclusion <= nbVisible) {
+      std::cerr << "The square should hide faces of the sphere" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (!faces.isVisible((unsigned int)polygons.size() - 1)) {
+      std::cerr << "The square should be visible without occlusion test" << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << nbVisibleNoOcclusion << " visible faces without occlusion test" << std::endl;
+
+    double t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      caster.castRays(O, rays);
+    const double t_single = (vpTime::measureTimeMs() - t) / nbIter;
+
+    caster.setNbThreads(0);
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      caster.castRays(O, rays);
+    const double t_threads = (vpTime::measureTimeMs() - t) / nbIter;
+
+    t = vpTime::measureTimeMs();
+    for (size_t r = 0; r < rays.size(); r++)
+      rays[r].occluded = isOccluded(polygons, O, rays[r]);
+    const double t_brute_force = vpTime::measureTimeMs() - t;
+
+    std::cout << "castRays() of " << rays.size() << " rays: " << t_single << " ms with 1 thread ; " << t_threads
+              << " ms with " << vpThreadPool::getNbThreads() << " threads ; brute force test: " << t_brute_force
+              << " ms" << std::endl;
+
+    std::cout << "testPerformanceMbRayCaster is ok." << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,235 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test performance of the scanline visibility of the model-based trackers.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceMbScanLine.cpp
+
+  \brief Render with vpMbScanLine a sphere of 1000 faces partially hidden by
+  a square, check that the visibility is the same with one and several
+  threads and from one frame to the other, and print the time of
+  vpMbScanLine::drawScene().
+*/
+
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/mbt/vpMbScanLine.h>
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+  typedef std::vector<std::pair<vpPoint, unsigned int> > vpPolygon;
+
+  vpPoint createPoint(double X, double Y, double Z)
+  {
+    vpPoint P;
+    P.set_X(X);
+    P.set_Y(Y);
+    P.set_Z(Z);
+    return P;
+  }
+
+  void addPoint(vpPolygon &polygon, double X, double Y, double Z)
+  {
+    polygon.push_back(std::make_pair(createPoint(X, Y, Z), (unsigned int)polygon.size()));
+  }
+
+  // Sphere of nbLat x nbLon faces in the camera frame, the faces at the poles being triangles, and a square in front
+  // of the sphere. The meridians are shifted so that none of them is seen as a vertical line on the column of the
+  // principal point, where the scanlines cannot tell the front from the back of the sphere.
+  void createScene(unsigned int nbLat, unsigned int nbLon, std::vector<vpPolygon> &polygons)
+  {
+    const double R = 0.3, Zc = 1.0;
+    for (unsigned int i = 0; i < nbLat; i++) {
+      for (unsigned int j = 0; j < nbLon; j++) {
+        const double t0 = M_PI * i / nbLat, t1 = M_PI * (i + 1) / nbLat;
+        const double p0 = 2 * M_PI * (j + 0.3) / nbLon, p1 = 2 * M_PI * (j + 1.3) / nbLon;
+        vpPolygon polygon;
+        addPoint(polygon, R * sin(t0) * cos(p0), R * cos(t0), Zc + R * sin(t0) * sin(p0));
+        if (i != 0)
+          addPoint(polygon, R * sin(t0) * cos(p1), R * cos(t0), Zc + R * sin(t0) * sin(p1));
+        addPoint(polygon, R * sin(t1) * cos(p1), R * cos(t1), Zc + R * sin(t1) * sin(p1));
+        if (i != nbLat - 1)
+          addPoint(polygon, R * sin(t1) * cos(p0), R * cos(t1), Zc + R * sin(t1) * sin(p0));
+        polygons.push_back(polygon);
+      }
+    }
+
+    vpPolygon square;
+    addPoint(square, -0.1, -0.05, 0.6);
+    addPoint(square, 0.2, -0.05, 0.6);
+    addPoint(square, 0.2, 0.3, 0.65);
+    addPoint(square, -0.1, 0.3, 0.65);
+    polygons.push_back(square);
+  }
+
+  // Visible parts of all the edges of the scene
+  void queryEdges(vpMbScanLine &renderer, const std::vector<vpPolygon> &polygons,
+                  std::vector<std::vector<std::pair<vpPoint, vpPoint> > > &lines)
+  {
+    lines.clear();
+    for (size_t i = 0; i < polygons.size(); i++) {
+      for (size_t j = 0; j < polygons[i].size(); j++) {
+        std::vector<std::pair<vpPoint, vpPoint> > edge_lines;
+        renderer.queryLineVisibility(polygons[i][j].first, polygons[i][(j + 1) % polygons[i].size()].first, edge_lines);
+        lines.push_back(edge_lines);
+      }
+    }
+  }
+
+  bool samePoint(const vpPoint &a, const vpPoint &b)
+  {
+    return std::fabs(a.get_X() - b.get_X()) < 1e-12 && std::fabs(a.get_Y() - b.get_Y()) < 1e-12
+        && std::fabs(a.get_Z() - b.get_Z()) < 1e-12;
+  }
+
+  template<class Type>
+  bool sameImage(const vpImage<Type> &I1, const vpImage<Type> &I2)
+  {
+    if (I1.getHeight() != I2.getHeight() || I1.getWidth() != I2.getWidth())
+      return false;
+    for (unsigned int i = 0; i < I1.getSize(); i++)
+      if (I1.bitmap[i] != I2.bitmap[i])
+        return false;
+    return true;
+  }
+
+  bool sameVisibility(const vpMbScanLine &r1, const std::vector<std::vector<std::pair<vpPoint, vpPoint> > > &lines1,
+                      const vpMbScanLine &r2, const std::vector<std::vector<std::pair<vpPoint, vpPoint> > > &lines2)
+  {
+    if (!sameImage(r1.getMask(), r2.getMask()) || !sameImage(r1.getPrimitiveIDs(), r2.getPrimitiveIDs())) {
+      std::cerr << "The masks differ" << std::endl;
+      return false;
+    }
+    if (lines1.size() != lines2.size())
+      return false;
+    for (size_t i = 0; i < lines1.size(); i++) {
+      if (lines1[i].size() != lines2[i].size()) {
+        std::cerr << "The visible parts of edge " << i << " differ" << std::endl;
+        return false;
+      }
+      for (size_t j = 0; j < lines1[i].size(); j++) {
+        if (!samePoint(lines1[i][j].first, lines2[i][j].first) || !samePoint(lines1[i][j].second, lines2[i][j].second)) {
+          std::cerr << "The visible parts of edge " << i << " differ" << std::endl;
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    const unsigned int width = 640, height = 480, nbIter = 20;
+    vpCameraParameters cam(600, 600, 320, 240);
+
+    std::vector<vpPolygon> polygons;
+    createScene(25, 40, polygons);
+    std::vector<vpPolygon *> listPolygons;
+    std::vector<int> listIndices;
+    for (size_t i = 0; i < polygons.size(); i++) {
+      listPolygons.push_back(&polygons[i]);
+      listIndices.push_back((int)i);
+    }
+    std::cout << "Scene of " << polygons.size() << " faces" << std::endl;
+
+    for (unsigned int maskBorder = 0; maskBorder <= 2; maskBorder += 2) {
+      vpMbScanLine renderer, renderer_threads;
+      renderer.setMaskBorder(maskBorder);
+      renderer.setNbThreads(1);
+      renderer_threads.setMaskBorder(maskBorder);
+      renderer_threads.setNbThreads(4);
+
+      std::vector<std::vector<std::pair<vpPoint, vpPoint> > > lines, lines_threads;
+      renderer.drawScene(listPolygons, listIndices, cam, width, height);
+      queryEdges(renderer, polygons, lines);
+      for (unsigned int frame = 0; frame < 2; frame++) {
+        renderer_threads.drawScene(listPolygons, listIndices, cam, width, height);
+        queryEdges(renderer_threads, polygons, lines_threads);
+        if (!sameVisibility(renderer, lines, renderer_threads, lines_threads)) {
+          std::cerr << "The visibility with 4 threads differs (frame " << frame << ")" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+
+      // The edges of the square are entirely visible, the back of the sphere is hidden
+      const size_t first_square_edge = lines.size() - 4;
+      for (size_t i = first_square_edge; i < lines.size(); i++) {
+        if (lines[i].size() != 1) {
+          std::cerr << "Edge " << i - first_square_edge << " of the square should be visible" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+      unsigned int nbVisible = 0, nbHidden = 0;
+      for (size_t i = 0, k = 0; i + 1 < polygons.size(); i++) {
+        for (size_t j = 0; j < polygons[i].size(); j++, k++) {
+          const vpPoint &a = polygons[i][j].first, &b = polygons[i][(j + 1) % polygons[i].size()].first;
+          if (a.get_Z() > 1.05 && b.get_Z() > 1.05 && !lines[k].empty()) {
+            std::cerr << "An edge of the back of the sphere is visible" << std::endl;
+            return EXIT_FAILURE;
+          }
+          lines[k].empty() ? nbHidden++ : nbVisible++;
+        }
+      }
+      std::cout << "Mask border " << maskBorder << ": " << nbVisible << " visible and " << nbHidden
+                << " hidden edges" << std::endl;
+
+      double t = vpTime::measureTimeMs();
+      for (unsigned int iter = 0; iter < nbIter; iter++)
+        renderer.drawScene(listPolygons, listIndices, cam, width, height);
+      const double t_single = (vpTime::measureTimeMs() - t) / nbIter;
+
+      renderer.setNbThreads(0);
+      t = vpTime::measureTimeMs();
+      for (unsigned int iter = 0; iter < nbIter; iter++)
+        renderer.drawScene(listPolygons, listIndices, cam, width, height);
+      const double t_threads = (vpTime::measureTimeMs() - t) / nbIter;
+
+      std::cout << "drawScene(): " << t_single << " ms with 1 thread ; " << t_threads << " ms with "
+                << vpThreadPool::getNbThreads() << " threads" << std::endl;
+    }
+
+    std::cout << "testPerformanceMbScanLine is ok." << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -302,6 +302,56 @@ vpMeSite::getSign(const vpImage<unsigned char> &I, const int range)
 }
 #endif
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Index of the convolution mask to use for a site whose normal has angle
+  alpha. The mask only depends on the site direction, so the index can be
+  shared by all the candidates tested along the normal.
+*/
+static
+unsigned int getMaskIndex(double alpha, const vpMe *me)
+{
+  // Calculate tangent angle from normal
+  double theta  = alpha+M_PI/2;
+  // Move tangent angle to within 0->M_PI for a positive
+  // mask index
+  while (theta<0) theta += M_PI;
+  while (theta>M_PI) theta -= M_PI;
+
+  // Convert radians to degrees
+  int thetadeg = vpMath::round(theta * 180 / M_PI) ;
+
+  if(abs(thetadeg) == 180 )
+  {
+    thetadeg= 0 ;
+  }
+
+  return (unsigned int)(thetadeg/(double)me->getAngleStep());
+}
+
+/*
+  Convolution of the msize x msize mask with the image block whose top-left
+  corner is (ihalf, jhalf). The products are accumulated in the same order
+  as in vpMeSite::convolution() so that both give the same result.
+*/
+static
+double convolveMask(const vpImage<unsigned char> &I, const vpMatrix &mask, unsigned int msize,
+                    unsigned int ihalf, unsigned int jhalf, int mask_sign)
+{
+  double conv = 0.0;
+  for(unsigned int a = 0 ; a < msize ; a++ )
+  {
+    const double *mask_row = mask[a];
+    const unsigned char *img_row = I[ihalf + a] + jhalf;
+    for(unsigned int b = 0 ; b < msize ; b++ )
+    {
+      conv += mask_sign * mask_row[b] * img_row[b];
+    }
+  }
+  return conv;
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 // Specific function for ME
 double
 vpMeSite::convolution(const vpImage<unsigned char>&I, const  vpMe *me)
@@ -321,41 +371,13 @@ vpMeSite::convolution(const vpImage<unsigned char>&I, const  vpMe *me)
   }
   else
   {
-    // Calculate tangent angle from normal
-    double theta  = alpha+M_PI/2;
-    // Move tangent angle to within 0->M_PI for a positive
-    // mask index
-    while (theta<0) theta += M_PI;
-    while (theta>M_PI) theta -= M_PI;
-
-    // Convert radians to degrees
-    int thetadeg = vpMath::round(theta * 180 / M_PI) ;
-
-    if(abs(thetadeg) == 180 )
-    {
-      thetadeg= 0 ;
-    }
-
-    unsigned int index_mask = (unsigned int)(thetadeg/(double)me->getAngleStep());
+    unsigned int index_mask = getMaskIndex(alpha, me);
 
     unsigned int i_ = static_cast<unsigned int>(i);
     unsigned int j_ = static_cast<unsigned int>(j);
     unsigned int half_ = static_cast<unsigned int>(half);
 
-    unsigned int ihalf = i_-half_ ;
-    unsigned int jhalf = j_-half_ ;
-
-    for(unsigned int a = 0 ; a < msize ; a++ )
-    {
-      unsigned int ihalfa = ihalf+a ;
-      for(unsigned int b = 0 ; b < msize ; b++ )
-      {
-        conv += mask_sign* me->getMask()[index_mask][a][b] *
-            //	  I(i-half+a,j-half+b) ;
-            I(ihalfa,jhalf+b) ;
-      }
-    }
-
+    conv = convolveMask(I, me->getMask()[index_mask], msize, i_-half_, j_-half_, mask_sign);
   }
 
   return(conv) ;
@@ -366,6 +388,14 @@ vpMeSite::convolution(const vpImage<unsigned char>&I, const  vpMe *me)
 
   Specific function for ME.
 
+  Search along the normal of the site, within +/- vpMe::getRange() pixels,
+  the pixel with the maximal likelihood and move the site on it.
+
+  The candidates are evaluated on the fly: no query list is allocated and the
+  convolution mask is selected once for all the candidates since they share
+  the same direction. The result is the same as evaluating the sites given by
+  getQueryList() with convolution().
+
   \warning To display the moving edges graphics a call to vpDisplay::flush()
   is needed.
 
@@ -375,232 +405,135 @@ vpMeSite::track(const vpImage<unsigned char>& I,
                 const vpMe *me,
                 const bool test_contraste)
 {
-  //   vpMeSite  *list_query_pixels ;
-  //   int  max_rank =0 ;
-  //   int max_rank1=0 ;
-  //   int max_rank2 = 0;
-  //   double  convolution = 0 ;
-  //   double  max_convolution = 0 ;
-  //   double max = 0 ;
-  //   double contraste = 0;
-  //   //  vpDisplay::display(I) ;
-  //   //  vpERROR_TRACE("getclcik %d",me->getRange()) ;
-  //   //  vpDisplay::getClick(I) ;
-  //
-  //   // range = +/- range of pixels within which the correspondent
-  //   // of the current pixel will be sought
-  //   int range  = me->getRange() ;
-  //
-  //   //  std::cout << i << "  " << j<<"  " << range << "  " << suppress  << std::endl ;
-  //   list_query_pixels = getQueryList(I, range) ;
-  //
-  //   double  contraste_max = 1 + me->getMu2();
-  //   double  contraste_min = 1 - me->getMu1();
-  //
-  //   // array in which likelihood ratios will be stored
-  //   double  *likelihood= new double[ 2 * range + 1 ] ;
-  //
-  //   int ii_1 = i ;
-  //   int jj_1 = j ;
-  //   i_1 = i ;
-  //   j_1 = j ;
-  //   double threshold;
-  //   threshold = me->getThreshold();
-  //
-  //   //    std::cout <<"---------------------"<<std::endl ;
-  //   for(int n = 0 ; n < 2 * range + 1 ; n++)
-  //     {
-  //
-  //       //   convolution results
-  //       convolution = list_query_pixels[n].convolution(I, me) ;
-  //
-  //       // luminance ratio of reference pixel to potential correspondent pixel
-  //       // the luminance must be similar, hence the ratio value should
-  //       // lay between, for instance, 0.5 and 1.5 (parameter tolerance)
-  //       if( test_contraste )
-  // 	{
-  // 	  // Include this to eliminate temporal calculation
-  // 	  if (convlt==0)
-  // 	    {
-  // 	      std::cout << "vpMeSite::track : Division by zero  convlt = 0" << std::endl ;
-  // 	      delete []list_query_pixels ;
-  // 	      delete []likelihood;
-  // 	      throw(vpTrackingException(vpTrackingException::initializationError,
-  // 					"Division by zero")) ;
-  // 	    }
-  //
-  // // 	  contraste = fabs(convolution / convlt) ;
-  // 	  contraste = convolution / convlt ;
-  // 	  // likelihood ratios
-  // 	  if((contraste > contraste_min) && (contraste < contraste_max))
-  // 	    likelihood[n] = fabs(convolution + convlt ) ;
-  // 	  else
-  // 	    likelihood[n] = 0 ;
-  // 	}
-  //       else
-  // 	likelihood[n] = fabs(2*convolution) ;
-  //
-  //
-  //       // establishment of the maximal likelihood ratios's  rank
-  //       // in the array, the value of the likelihood ratio can now be
-  //     // referenced by its rank in the array
-  //     if (likelihood[n] > max)
-  //     {
-  //       max_convolution= convolution;
-  //       max = likelihood[n] ;
-  //       max_rank = n ;
-  //       max_rank2 = max_rank1;
-  //       max_rank1 = max_rank;
-  //     }
-  //
-  //   }
-  //
-  //   // test on the likelihood threshold if threshold==-1 then
-  //   // the me->threshold is  selected
-  //
-  //   vpImagePoint ip;
-  //
-  //   //  if (test_contrast)
-  //   if(max > threshold)
-  //     {
-  //       if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
-  // 	{
-  // 	  ip.set_i( list_query_pixels[max_rank].i );
-  // 	  ip.set_j( list_query_pixels[max_rank].j );
-  // 	  vpDisplay::displayPoint(I, ip, vpColor::red);
-  // 	}
-  //
-  //       *this = list_query_pixels[max_rank] ;//The vpMeSite is replaced by the vpMeSite of max likelihood
-  //       normGradient =  vpMath::sqr(max_convolution);
-  //
-  //       convlt = max_convolution;
-  //       i_1 = ii_1; //list_query_pixels[max_rank].i ;
-  //       j_1 = jj_1; //list_query_pixels[max_rank].j ;
-  //       delete []list_query_pixels ;
-  //       delete []likelihood;
-  //     }
-  //   else //none of the query sites is better than the threshold
-  //     {
-  //       if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
-  // 	{
-  // 	  ip.set_i( list_query_pixels[max_rank].i );
-  // 	  ip.set_j( list_query_pixels[max_rank].j );
-  // 	  vpDisplay::displayPoint(I, ip, vpColor::green);
-  // 	}
-  //       normGradient = 0 ;
-  //       if(max == 0)
-  // 	suppress = 1; // contrast suppression
-  //       else
-  // 	suppress = 2; // threshold suppression
-  //
-  //       delete []list_query_pixels ;
-  //       delete []likelihood; // modif portage
-  //     }
-
-  vpMeSite  *list_query_pixels ;
   int  max_rank =-1 ;
-  //   int max_rank1=-1 ;
-  //   int max_rank2 = -1;
   double  max_convolution = 0 ;
   double max = 0 ;
   double contraste = 0;
-  //  vpDisplay::display(I) ;
-  //  vpERROR_TRACE("getclcik %d",me->range) ;
-  //  vpDisplay::getClick(I) ;
+  double max_ifloat = 0, max_jfloat = 0;
+  int max_i = 0, max_j = 0;
 
   // range = +/- range of pixels within which the correspondent
   // of the current pixel will be sought
-  unsigned int range  = me->getRange() ;
-
-  //  std::cout << i << "  " << j<<"  " << range << "  " << suppress  << std::endl ;
-  list_query_pixels = getQueryList(I, (int)range) ;
+  int range  = static_cast<int>(me->getRange()) ;
 
   double  contraste_max = 1 + me->getMu2();
   double  contraste_min = 1 - me->getMu1();
 
-  // array in which likelihood ratios will be stored
-  double  *likelihood= new double[ 2 * range + 1 ] ;
-
   int ii_1 = i ;
   int jj_1 = j ;
   i_1 = i ;
   j_1 = j ;
-  double threshold;
-  threshold = me->getThreshold() ;
+  double threshold = me->getThreshold() ;
   double diff = 1e6;
 
-  //    std::cout <<"---------------------"<<std::endl ;
-  for(unsigned int n = 0 ; n < 2 * range + 1 ; n++)
+  // Everything that depends only on the site direction is computed once
+  double salpha = sin(alpha);
+  double calpha = cos(alpha);
+  int height_ = static_cast<int>(I.getHeight());
+  int width_  = static_cast<int>(I.getWidth());
+  unsigned int msize = me->getMaskSize();
+  int half = (static_cast<int>(msize) - 1) >> 1 ;
+  int half_strip = half + me->getStrip();
+  const vpMatrix &mask = me->getMask()[getMaskIndex(alpha, me)];
+  bool displayRange = (selectDisplay==RANGE_RESULT)||(selectDisplay==RANGE);
+
+  for(int k = -range ; k <= range ; k++)
   {
+    double ii = ifloat+k*salpha;
+    double jj = jfloat+k*calpha;
+    int i_k = (int)ii;
+    int j_k = (int)jj;
+
+    if (displayRange) {
+      vpDisplay::displayCross(I, vpImagePoint(ii, jj), 1, vpColor::yellow) ;
+    }
+
     //   convolution results
-    double convolution_ = list_query_pixels[n].convolution(I, me) ;
+    double convolution_ = 0.0;
+    if(horsImage(i_k, j_k, half_strip, height_, width_))
+    {
+      // Same as convolution(): the candidate is moved to the origin
+      i_k = 0; j_k = 0;
+    }
+    else
+    {
+      convolution_ = convolveMask(I, mask, msize, static_cast<unsigned int>(i_k - half),
+                                  static_cast<unsigned int>(j_k - half), mask_sign);
+    }
 
     // luminance ratio of reference pixel to potential correspondent pixel
     // the luminance must be similar, hence the ratio value should
     // lay between, for instance, 0.5 and 1.5 (parameter tolerance)
+    bool better = false;
+    double likelihood;
     if( test_contraste )
     {
-      likelihood[n] = fabs(convolution_ + convlt );
-      if (likelihood[n]> threshold)
+      likelihood = fabs(convolution_ + convlt );
+      if (likelihood > threshold)
       {
         contraste = convolution_ / convlt;
         if((contraste > contraste_min) && (contraste < contraste_max) && fabs(1-contraste) < diff)
         {
           diff = fabs(1-contraste);
-          max_convolution= convolution_;
-          max = likelihood[n] ;
-          max_rank = (int)n ;
-          // 	    max_rank2 = max_rank1;
-          // 	    max_rank1 = max_rank;
+          better = true;
         }
       }
     }
-
     else
     {
-      likelihood[n] = fabs(2*convolution_) ;
-      if (likelihood[n] > max  && likelihood[n] > threshold)
-      {
-        max_convolution= convolution_;
-        max = likelihood[n] ;
-        max_rank = (int)n ;
-        //           max_rank2 = max_rank1;
-        //           max_rank1 = max_rank;
-      }
+      likelihood = fabs(2*convolution_) ;
+      better = (likelihood > max  && likelihood > threshold);
+    }
+
+    if (better)
+    {
+      max_convolution = convolution_;
+      max = likelihood;
+      max_rank = k + range;
+      max_ifloat = ii; max_jfloat = jj;
+      max_i = i_k; max_j = j_k;
     }
   }
-  
+
   // test on the likelihood threshold if threshold==-1 then
   // the me->threshold is  selected
 
-  vpImagePoint ip;
-
-  //  if (test_contrast)
   if(max_rank >= 0)
   {
     if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
     {
-      ip.set_i( list_query_pixels[max_rank].i );
-      ip.set_j( list_query_pixels[max_rank].j );
-      vpDisplay::displayPoint(I, ip, vpColor::red);
+      vpDisplay::displayPoint(I, vpImagePoint(max_i, max_j), vpColor::red);
     }
-		
-    *this = list_query_pixels[max_rank] ;//The vpMeSite2 is replaced by the vpMeSite2 of max likelihood
+
+    // The site is moved on the candidate of max likelihood, that is reset
+    // like a newly created site
+    ifloat = max_ifloat;
+    jfloat = max_jfloat;
+    i = max_i;
+    j = max_j;
+    v = 0;
+    weight = 1;
+    state = NO_SUPPRESSION;
+#ifdef VISP_BUILD_DEPRECATED_FUNCTIONS
+    suppress = 0;
+#endif
     normGradient =  vpMath::sqr(max_convolution);
 
     convlt = max_convolution;
-    i_1 = ii_1; //list_query_pixels[max_rank].i ;
-    j_1 = jj_1; //list_query_pixels[max_rank].j ;
-    delete []list_query_pixels ;
-    delete []likelihood;
+    i_1 = ii_1;
+    j_1 = jj_1;
   }
   else //none of the query sites is better than the threshold
   {
     if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
     {
-      ip.set_i( list_query_pixels[0].i );
-      ip.set_j( list_query_pixels[0].j );
-      vpDisplay::displayPoint(I, ip, vpColor::green);
+      double ii = ifloat-range*salpha;
+      double jj = jfloat-range*calpha;
+      int i_0 = (int)ii, j_0 = (int)jj;
+      if(horsImage(i_0, j_0, half_strip, height_, width_)) {
+        i_0 = 0; j_0 = 0;
+      }
+      vpDisplay::displayPoint(I, vpImagePoint(i_0, j_0), vpColor::green);
     }
     normGradient = 0 ;
     //if(contraste != 0)
@@ -608,9 +541,6 @@ vpMeSite::track(const vpImage<unsigned char>& I,
       state = CONSTRAST; // contrast suppression
     else
       state = THRESHOLD; // threshold suppression
-
-    delete []list_query_pixels ;
-    delete []likelihood; // modif portage
   }
 }
 
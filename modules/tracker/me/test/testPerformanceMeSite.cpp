@@ -0,0 +1,224 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test performance of the moving-edge search.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceMeSite.cpp
+
+  \brief Compare vpMeSite::track() with the former implementation that
+  allocated a query list of vpMeSite for each site. Both have to give the same
+  sites; the number of sites tracked per second is printed.
+*/
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/me/vpMe.h>
+#include <visp3/me/vpMeSite.h>
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+  // Former vpMeSite::track() implementation, based on getQueryList()
+  void trackQueryList(vpMeSite &site, const vpImage<unsigned char> &I, const vpMe *me, bool test_contraste)
+  {
+    int max_rank = -1;
+    double max_convolution = 0;
+    double max = 0;
+    double contraste = 0;
+    unsigned int range = me->getRange();
+    vpMeSite *list_query_pixels = site.getQueryList(I, (int)range);
+
+    double contraste_max = 1 + me->getMu2();
+    double contraste_min = 1 - me->getMu1();
+    double *likelihood = new double[2 * range + 1];
+
+    int ii_1 = site.i;
+    int jj_1 = site.j;
+    double threshold = me->getThreshold();
+    double diff = 1e6;
+
+    for (unsigned int n = 0; n < 2 * range + 1; n++) {
+      double convolution_ = list_query_pixels[n].convolution(I, me);
+      if (test_contraste) {
+        likelihood[n] = fabs(convolution_ + site.convlt);
+        if (likelihood[n] > threshold) {
+          contraste = convolution_ / site.convlt;
+          if ((contraste > contraste_min) && (contraste < contraste_max) && fabs(1 - contraste) < diff) {
+            diff = fabs(1 - contraste);
+            max_convolution = convolution_;
+            max = likelihood[n];
+            max_rank = (int)n;
+          }
+        }
+      }
+      else {
+        likelihood[n] = fabs(2 * convolution_);
+        if (likelihood[n] > max && likelihood[n] > threshold) {
+          max_convolution = convolution_;
+          max = likelihood[n];
+          max_rank = (int)n;
+        }
+      }
+    }
+
+    if (max_rank >= 0) {
+      site = list_query_pixels[max_rank];
+      site.normGradient = vpMath::sqr(max_convolution);
+      site.convlt = max_convolution;
+      site.i_1 = ii_1;
+      site.j_1 = jj_1;
+    }
+    else {
+      site.i_1 = ii_1;
+      site.j_1 = jj_1;
+      site.normGradient = 0;
+      if (std::fabs(contraste) > std::numeric_limits<double>::epsilon())
+        site.setState(vpMeSite::CONSTRAST);
+      else
+        site.setState(vpMeSite::THRESHOLD);
+    }
+    delete[] list_query_pixels;
+    delete[] likelihood;
+  }
+
+  // Dark disks with a smooth border on a textured background
+  void createImage(vpImage<unsigned char> &I, double shift) {
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        double di = i - 240.0 - shift, dj = j - 320.0 - 0.5 * shift;
+        double r = sqrt(di * di + dj * dj);
+        double value = 200.0 + 20.0 * sin(0.05 * i) * cos(0.07 * j);
+        if (r < 150.0)
+          value = 60.0;
+        else if (r < 153.0)
+          value = 60.0 + (value - 60.0) * (r - 150.0) / 3.0;
+        I[i][j] = (unsigned char) vpMath::round(value);
+      }
+    }
+  }
+
+  // Sites sampled on circles around the true border, with the normal direction
+  void createSites(std::vector<vpMeSite> &sites, unsigned int nbSites) {
+    sites.resize(nbSites);
+    for (unsigned int n = 0; n < nbSites; n++) {
+      double theta = 2 * M_PI * n / nbSites;
+      double radius = 151.5 + 4.0 * sin(7 * theta);
+      sites[n].init(240.0 + radius * sin(theta), 320.0 + radius * cos(theta), theta);
+      sites[n].setDisplay(vpMeSite::NONE);
+    }
+  }
+
+  bool sameSites(const std::vector<vpMeSite> &s1, const std::vector<vpMeSite> &s2) {
+    for (size_t n = 0; n < s1.size(); n++) {
+      if (s1[n].i != s2[n].i || s1[n].j != s2[n].j || s1[n].ifloat != s2[n].ifloat || s1[n].jfloat != s2[n].jfloat
+          || s1[n].convlt != s2[n].convlt || s1[n].normGradient != s2[n].normGradient
+          || s1[n].getState() != s2[n].getState() || s1[n].i_1 != s2[n].i_1 || s1[n].j_1 != s2[n].j_1) {
+        std::cerr << "Site " << n << " differs: (" << s1[n].ifloat << ", " << s1[n].jfloat << ") state "
+                  << s1[n].getState() << " vs (" << s2[n].ifloat << ", " << s2[n].jfloat << ") state "
+                  << s2[n].getState() << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    vpImage<unsigned char> I0(480, 640), I1(480, 640);
+    createImage(I0, 0.0);
+    createImage(I1, 2.5);
+
+    vpMe me;
+    me.setRange(10);
+    me.setMaskSize(5);
+    me.setMaskNumber(180);
+    me.setThreshold(2000);
+    me.setMu1(0.5);
+    me.setMu2(0.5);
+
+    const unsigned int nbSites = 2000, nbIter = 50;
+    std::vector<vpMeSite> sites_init;
+    createSites(sites_init, nbSites);
+
+    // Initial search without contrast test to get the reference convolution,
+    // then tracking in the next image with the contrast test
+    std::vector<vpMeSite> sites_ref = sites_init, sites = sites_init;
+    double t_ref = 0, t = 0;
+    for (unsigned int iter = 0; iter < nbIter; iter++) {
+      sites_ref = sites_init;
+      sites = sites_init;
+
+      double t0 = vpTime::measureTimeMs();
+      for (unsigned int n = 0; n < nbSites; n++)
+        trackQueryList(sites_ref[n], I0, &me, false);
+      for (unsigned int n = 0; n < nbSites; n++)
+        trackQueryList(sites_ref[n], I1, &me, true);
+      t_ref += vpTime::measureTimeMs() - t0;
+
+      t0 = vpTime::measureTimeMs();
+      for (unsigned int n = 0; n < nbSites; n++)
+        sites[n].track(I0, &me, false);
+      for (unsigned int n = 0; n < nbSites; n++)
+        sites[n].track(I1, &me, true);
+      t += vpTime::measureTimeMs() - t0;
+    }
+
+    if (!sameSites(sites_ref, sites)) {
+      std::cerr << "vpMeSite::track() differs from the query list implementation" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    unsigned int nbTracked = 0;
+    for (unsigned int n = 0; n < nbSites; n++)
+      if (sites[n].getState() == vpMeSite::NO_SUPPRESSION)
+        nbTracked++;
+
+    double nbSearches = 2.0 * nbSites * nbIter;
+    std::cout << nbTracked << "/" << nbSites << " sites tracked with range " << me.getRange() << std::endl;
+    std::cout << "Query list: " << nbSearches / t_ref * 1000.0 << " sites/s ; vpMeSite::track(): "
+              << nbSearches / t * 1000.0 << " sites/s ; speed-up " << t_ref / t << std::endl;
+
+    std::cout << "testPerformanceMeSite is ok." << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
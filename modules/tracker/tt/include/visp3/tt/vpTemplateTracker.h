@@ -50,6 +50,7 @@
 #include <visp3/tt/vpTemplateTrackerZone.h>
 #include <visp3/tt/vpTemplateTrackerWarp.h>
 #include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpImagePyramid.h>
 
 /*!
   \class vpTemplateTracker
@@ -135,6 +136,9 @@ class VISP_EXPORT vpTemplateTracker
     vpImage<double>             dIx ;
     vpImage<double>             dIy ;
     vpTemplateTrackerZone       zoneRef_; // Reference zone
+    vpImagePyramid              pyr_I; // Pyramid of the current image, kept across frames
+    //! Points used by the tracker for each pyramid level
+    std::vector<vpTemplateTrackerPointArray> ptTemplateArray;
     
 //private:
 //#ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -172,7 +176,8 @@ class VISP_EXPORT vpTemplateTracker
         blur(false), useBrent(false), nbIterBrent(0), taillef(0), fgG(NULL), fgdG(NULL),
         ratioPixelIn(0), mod_i(0), mod_j(0), nbParam(), lambdaDep(0), iterationMax(0),
         iterationGlobale(0), diverge(false), nbIteration(0), useCompositionnal(false),
-        useInverse(false), Warp(NULL), p(), dp(), X1(), X2(), dW(), BI(), dIx(), dIy(), zoneRef_()
+        useInverse(false), Warp(NULL), p(), dp(), X1(), X2(), dW(), BI(), dIx(), dIy(), zoneRef_(), pyr_I(),
+        ptTemplateArray()
     {}
     vpTemplateTracker(vpTemplateTrackerWarp *_warp);
     virtual        ~vpTemplateTracker();
@@ -253,6 +258,7 @@ class VISP_EXPORT vpTemplateTracker
     void    setUseBrent(bool b){useBrent = b;}
     
     void    track(const vpImage<unsigned char> &I);
+    void    track(const vpImagePyramid &pyramid);
     void    trackRobust(const vpImage<unsigned char> &I);
     
   protected:
@@ -260,6 +266,8 @@ class VISP_EXPORT vpTemplateTracker
     void            computeOptimalBrentGain(const vpImage<unsigned char> &I,vpColVector &tp,double tMI,vpColVector &direction,double &alpha);
     virtual double  getCost(const vpImage<unsigned char> &I, const vpColVector &tp) = 0;
     void            getGaussianBluredImage(const vpImage<unsigned char> &I){ vpImageFilter::filter(I, BI,fgG,taillef); }
+    vpTemplateTrackerPointArray &getPointArray();
+    vpTemplateTrackerPointArray &initPointArray();
     virtual void    initHessienDesired(const vpImage<unsigned char> &I)=0;
     virtual void    initHessienDesiredPyr(const vpImage<unsigned char> &I);
     virtual void    initPyramidal(unsigned int nbLvl,unsigned int l0);
@@ -267,6 +275,7 @@ class VISP_EXPORT vpTemplateTracker
     virtual void    initTrackingPyr(const vpImage<unsigned char>& I,vpTemplateTrackerZone &zone);
     virtual void    trackNoPyr(const vpImage<unsigned char> &I) = 0;
     virtual void    trackPyr(const vpImage<unsigned char> &I);
+    void            trackPyr(const vpImagePyramid &pyramid);
 };
 #endif
 
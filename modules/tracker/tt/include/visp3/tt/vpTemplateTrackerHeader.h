@@ -45,6 +45,7 @@
 #define vpTemplateTrackerHeader_hh
 
 #include <stdio.h>
+#include <vector>
 
 /*!
   \struct vpTemplateTrackerZPoint
@@ -85,6 +86,26 @@ struct vpTemplateTrackerPointCompo {
     double *dW;
     vpTemplateTrackerPointCompo() : dW(NULL) {}
 };
+/*!
+  \struct vpTemplateTrackerPointArray
+  \ingroup group_tt_tools
+  Template points stored as a structure of arrays: the coordinates, the
+  values and the per-point vectors of all the points are contiguous. The
+  SSD and ZNCC trackers warp all the points with a single call to
+  vpTemplateTrackerWarp::warp() and then go through the arrays in sequence.
+*/
+struct vpTemplateTrackerPointArray {
+    std::vector<double> x,y;     //!< Coordinates along the columns and the rows
+    std::vector<double> val;     //!< Template values
+    std::vector<double> dx,dy;   //!< Template gradient
+    std::vector<double> HiG;     //!< nbParam values for each point
+    std::vector<double> dW;      //!< 2*nbParam derivatives of the warp for each point
+    std::vector<double> x2,y2;   //!< Warped coordinates, updated at each iteration
+
+    vpTemplateTrackerPointArray() : x(), y(), val(), dx(), dy(), HiG(), dW(), x2(), y2() {}
+    //! Number of points
+    unsigned int size() const { return (unsigned int)x.size(); }
+};
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 struct vpTemplateTrackerPointSuppMIInv {
@@ -69,7 +69,7 @@ class VISP_EXPORT vpTemplateTrackerSSDForwardAdditional: public vpTemplateTracke
     vpMatrix           KQuasiNewton;
 
   protected:
-    void  initHessienDesired(const vpImage<unsigned char> &/*I*/){}
+    void  initHessienDesired(const vpImage<unsigned char> &I);
     void  trackNoPyr(const vpImage<unsigned char> &I);
 
   public:
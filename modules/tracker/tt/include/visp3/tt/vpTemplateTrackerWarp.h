@@ -182,6 +182,11 @@ class VISP_EXPORT vpTemplateTrackerWarp
     /*!
       Warp a list of points.
 
+      The default implementation calls computeDenom() and warpX() for each
+      point. Warps with a closed form override it with a loop without virtual
+      calls, so that the template trackers warp all the template points at
+      once for each iteration.
+
       \param ut0 : List of u coordinates of the points.
       \param vt0 : List of v coordinates of the points.
       \param nb_pt : Number of points to consider.
@@ -189,7 +194,7 @@ class VISP_EXPORT vpTemplateTrackerWarp
       \param u : Resulting u coordinates.
       \param v : resulting v coordinates.
     */
-    void warp(const double *ut0,const double *vt0,int nb_pt,const vpColVector& p,double *u,double *v);
+    virtual void warp(const double *ut0,const double *vt0,int nb_pt,const vpColVector& p,double *u,double *v);
 
     /*!
       Warp a point.
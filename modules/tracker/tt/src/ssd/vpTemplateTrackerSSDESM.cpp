@@ -65,22 +65,23 @@ void vpTemplateTrackerSSDESM::initHessienDesired(const vpImage<unsigned char> &I
 void vpTemplateTrackerSSDESM::initCompInverse(const vpImage<unsigned char> &/*I*/)
 {
   //std::cout<<"Initialise precomputed value of ESM with templateSize: "<< templateSize<<std::endl;
-  ptTemplateCompo=new vpTemplateTrackerPointCompo[templateSize];
+  vpTemplateTrackerPointArray &pts = initPointArray();
   int i,j;
   //direct
+  pts.dW.resize(templateSize*2*nbParam);
   for(unsigned int point=0;point<templateSize;point++)
   {
     i=ptTemplate[point].y;
     j=ptTemplate[point].x;
-    ptTemplateCompo[point].dW=new double[2*nbParam];
     X1[0]=j;X1[1]=i;
     Warp->computeDenom(X1,p);
-    Warp->getdWdp0(i,j,ptTemplateCompo[point].dW);
+    Warp->getdWdp0(i,j,&pts.dW[point*2*nbParam]);
 
   }
 
-  //inverse
+  //inverse, the steepest descent images of the template being kept in HiG
   HInv=0;
+  pts.HiG.resize(templateSize*nbParam);
   for(unsigned int point=0;point<templateSize;point++)
   {
     i=ptTemplate[point].y;
@@ -88,12 +89,12 @@ void vpTemplateTrackerSSDESM::initCompInverse(const vpImage<unsigned char> &/*I*
 
     X1[0]=j;X1[1]=i;
     Warp->computeDenom(X1,p);
-    ptTemplate[point].dW=new double[nbParam];
-    Warp->getdW0(i,j,ptTemplate[point].dy,ptTemplate[point].dx,ptTemplate[point].dW);
+    double *dWp=&pts.HiG[point*nbParam];
+    Warp->getdW0(i,j,ptTemplate[point].dy,ptTemplate[point].dx,dWp);
 
     for(unsigned int it=0;it<nbParam;it++)
       for(unsigned int jt=0;jt<nbParam;jt++)
-        HInv[it][jt]+=ptTemplate[point].dW[it]*ptTemplate[point].dW[jt];
+        HInv[it][jt]+=dWp[it]*dWp[jt];
   }
   vpMatrix::computeHLM(HInv,lambdaDep,HLMInv);
 
@@ -110,9 +111,13 @@ void vpTemplateTrackerSSDESM::trackNoPyr(const vpImage<unsigned char> &I)
   double IW,dIWx,dIWy;
   double Tij;
   unsigned int iteration=0;
-  int i,j;
   double i2,j2;
   double alpha=2.;
+  vpTemplateTrackerPointArray &pts = getPointArray();
+  const unsigned int nbPoints=pts.size();
+  const double height=I.getHeight()-1;
+  const double width=I.getWidth()-1;
+  vpColVector tempt(nbParam);
   do
   {
     unsigned int Nbpoint=0;
@@ -121,29 +126,25 @@ void vpTemplateTrackerSSDESM::trackNoPyr(const vpImage<unsigned char> &I)
     HDir=0;
     GDir=0;
     GInv=0;
-    Warp->computeCoeff(p);
-    for(unsigned int point=0;point<templateSize;point++)
+    // One warp call for all the points
+    if(nbPoints>0)
+      Warp->warp(&pts.x[0],&pts.y[0],(int)nbPoints,p,&pts.x2[0],&pts.y2[0]);
+    for(unsigned int point=0;point<nbPoints;point++)
     {
-      i=ptTemplate[point].y;
-      j=ptTemplate[point].x;
-      X1[0]=j;X1[1]=i;
-
-      Warp->computeDenom(X1,p);
-      Warp->warpX(X1,X2,p);
-
-      j2=X2[0];i2=X2[1];
-      if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+      j2=pts.x2[point];i2=pts.y2[point];
+      if((i2>=0)&&(j2>=0)&&(i2<height)&&(j2<width))
       {
         //INVERSE
-        Tij=ptTemplate[point].val;
+        Tij=pts.val[point];
         if(!blur)
           IW=I.getValue(i2,j2);
         else
           IW=BI.getValue(i2,j2);
         Nbpoint++;
         double er=(Tij-IW);
+        const double *dWInv=&pts.HiG[point*nbParam];
         for(unsigned int it=0;it<nbParam;it++)
-          GInv[it]+=er*ptTemplate[point].dW[it];
+          GInv[it]+=er*dWInv[it];
 
         erreur+=er*er;
 
@@ -151,14 +152,16 @@ void vpTemplateTrackerSSDESM::trackNoPyr(const vpImage<unsigned char> &I)
         //dIWx=dIx.getValue(i2,j2);
         //dIWy=dIy.getValue(i2,j2);
 
-        dIWx=dIx.getValue(i2,j2)+ptTemplate[point].dx;
-        dIWy=dIy.getValue(i2,j2)+ptTemplate[point].dy;
+        dIWx=dIx.getValue(i2,j2)+pts.dx[point];
+        dIWy=dIy.getValue(i2,j2)+pts.dy[point];
 
         //Calcul du Hessien
         //Warp->dWarp(X1,X2,p,dW);
-        Warp->dWarpCompo(X1,X2,p,ptTemplateCompo[point].dW,dW);
+        X1[0]=pts.x[point];X1[1]=pts.y[point];
+        X2[0]=j2;X2[1]=i2;
+        Warp->computeDenom(X1,p);
+        Warp->dWarpCompo(X1,X2,p,&pts.dW[point*2*nbParam],dW);
 
-        double *tempt=new double[nbParam];
         for(unsigned int it=0;it<nbParam;it++)
           tempt[it]=dW[0][it]*dIWx+dW[1][it]*dIWy;
 
@@ -168,7 +171,6 @@ void vpTemplateTrackerSSDESM::trackNoPyr(const vpImage<unsigned char> &I)
 
         for(unsigned int it=0;it<nbParam;it++)
           GDir[it]+=er*tempt[it];
-        delete[] tempt;
       }
 
 
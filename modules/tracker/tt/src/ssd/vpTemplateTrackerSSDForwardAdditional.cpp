@@ -48,6 +48,11 @@ vpTemplateTrackerSSDForwardAdditional::vpTemplateTrackerSSDForwardAdditional(vpT
   useCompositionnal=false;
 }
 
+void vpTemplateTrackerSSDForwardAdditional::initHessienDesired(const vpImage<unsigned char> &/*I*/)
+{
+  initPointArray();
+}
+
 void vpTemplateTrackerSSDForwardAdditional::trackNoPyr(const vpImage<unsigned char> &I)
 {
   if(blur)
@@ -61,29 +66,28 @@ void vpTemplateTrackerSSDForwardAdditional::trackNoPyr(const vpImage<unsigned ch
   double IW,dIWx,dIWy;
   double Tij;
   unsigned int iteration=0;
-  int i,j;
   double i2,j2;
   double alpha=2.;
+  vpTemplateTrackerPointArray &pts = getPointArray();
+  const unsigned int nbPoints=pts.size();
+  const double height=I.getHeight()-1;
+  const double width=I.getWidth()-1;
+  vpColVector tempt(nbParam);
   do
   {
     unsigned int Nbpoint=0;
     double erreur=0;
     G=0;
     H=0 ;
-    Warp->computeCoeff(p);
-    for(unsigned int point=0;point<templateSize;point++)
+    // One warp call for all the points
+    if(nbPoints>0)
+      Warp->warp(&pts.x[0],&pts.y[0],(int)nbPoints,p,&pts.x2[0],&pts.y2[0]);
+    for(unsigned int point=0;point<nbPoints;point++)
     {
-      i=ptTemplate[point].y;
-      j=ptTemplate[point].x;
-      X1[0]=j;X1[1]=i;
-
-      Warp->computeDenom(X1,p);
-      Warp->warpX(X1,X2,p);
-
-      j2=X2[0];i2=X2[1];
-      if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+      j2=pts.x2[point];i2=pts.y2[point];
+      if((i2>=0)&&(j2>=0)&&(i2<height)&&(j2<width))
       {
-        Tij=ptTemplate[point].val;
+        Tij=pts.val[point];
 
         if(!blur)
           IW=I.getValue(i2,j2);
@@ -94,8 +98,10 @@ void vpTemplateTrackerSSDForwardAdditional::trackNoPyr(const vpImage<unsigned ch
         dIWy=dIy.getValue(i2,j2);
         Nbpoint++;
         //Calcul du Hessien
+        X1[0]=pts.x[point];X1[1]=pts.y[point];
+        X2[0]=j2;X2[1]=i2;
+        Warp->computeDenom(X1,p);
         Warp->dWarp(X1,X2,p,dW);
-        double *tempt=new double[nbParam];
         for(unsigned int it=0;it<nbParam;it++)
           tempt[it]=dW[0][it]*dIWx+dW[1][it]*dIWy;
 
@@ -108,7 +114,6 @@ void vpTemplateTrackerSSDForwardAdditional::trackNoPyr(const vpImage<unsigned ch
           G[it]+=er*tempt[it];
 
         erreur+=(er*er);
-        delete[] tempt;
       }
 
 
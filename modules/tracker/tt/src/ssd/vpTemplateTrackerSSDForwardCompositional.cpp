@@ -47,14 +47,15 @@ vpTemplateTrackerSSDForwardCompositional::vpTemplateTrackerSSDForwardComposition
 void vpTemplateTrackerSSDForwardCompositional::initCompo(const vpImage<unsigned char> &/*I*/)
 {
  // std::cout<<"Initialise precomputed value of Compositionnal Direct"<<std::endl;
+  vpTemplateTrackerPointArray &pts = initPointArray();
+  pts.dW.resize(templateSize*2*nbParam);
   for(unsigned int point=0;point<templateSize;point++)
   {
     int i=ptTemplate[point].y;
     int j=ptTemplate[point].x;
-    ptTemplate[point].dW=new double[2*nbParam];
     X1[0]=j;X1[1]=i;
     Warp->computeDenom(X1,p);
-    Warp->getdWdp0(i,j,ptTemplate[point].dW);
+    Warp->getdWdp0(i,j,&pts.dW[point*2*nbParam]);
 
   }
   compoInitialised=true;
@@ -81,29 +82,28 @@ void vpTemplateTrackerSSDForwardCompositional::trackNoPyr(const vpImage<unsigned
   double IW,dIWx,dIWy;
   double Tij;
   unsigned int iteration=0;
-  int i,j;
   double i2,j2;
   double alpha=2.;
+  vpTemplateTrackerPointArray &pts = getPointArray();
+  const unsigned int nbPoints=pts.size();
+  const double height=I.getHeight()-1;
+  const double width=I.getWidth()-1;
+  vpColVector tempt(nbParam);
   do
   {
     unsigned int Nbpoint=0;
     double erreur=0;
     G=0;
     H=0 ;
-    Warp->computeCoeff(p);
-    for(unsigned int point=0;point<templateSize;point++)
+    // One warp call for all the points
+    if(nbPoints>0)
+      Warp->warp(&pts.x[0],&pts.y[0],(int)nbPoints,p,&pts.x2[0],&pts.y2[0]);
+    for(unsigned int point=0;point<nbPoints;point++)
     {
-      i=ptTemplate[point].y;
-      j=ptTemplate[point].x;
-      X1[0]=j;X1[1]=i;
-
-      Warp->computeDenom(X1,p);
-      Warp->warpX(X1,X2,p);
-
-      j2=X2[0];i2=X2[1];
-      if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+      j2=pts.x2[point];i2=pts.y2[point];
+      if((i2>=0)&&(j2>=0)&&(i2<height)&&(j2<width))
       {
-        Tij=ptTemplate[point].val;
+        Tij=pts.val[point];
         if(!blur)
           IW=I.getValue(i2,j2);
         else
@@ -112,14 +112,11 @@ void vpTemplateTrackerSSDForwardCompositional::trackNoPyr(const vpImage<unsigned
         dIWy=dIy.getValue(i2,j2);
         Nbpoint++;
         //Calcul du Hessien
-        /*Warp->dWarp(X1,X2,p,dW);
-        double *tempt=new double[nbParam];
-        for(int it=0;it<nbParam;it++)
-        tempt[it]=dW[0][it]*dIWx+dW[1][it]*dIWy;*/
-
-        Warp->dWarpCompo(X1,X2,p,ptTemplate[point].dW,dW);
+        X1[0]=pts.x[point];X1[1]=pts.y[point];
+        X2[0]=j2;X2[1]=i2;
+        Warp->computeDenom(X1,p);
+        Warp->dWarpCompo(X1,X2,p,&pts.dW[point*2*nbParam],dW);
 
-        double *tempt=new double[nbParam];
         for(unsigned int it=0;it<nbParam;it++)
           tempt[it] =dW[0][it]*dIWx+dW[1][it]*dIWy;
 
@@ -132,7 +129,6 @@ void vpTemplateTrackerSSDForwardCompositional::trackNoPyr(const vpImage<unsigned
           G[it]+=er*tempt[it];
 
         erreur+=(er*er);
-        delete[] tempt;
       }
 
 
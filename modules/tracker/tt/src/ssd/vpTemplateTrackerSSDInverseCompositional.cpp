@@ -54,6 +54,12 @@ void vpTemplateTrackerSSDInverseCompositional::initCompInverse(const vpImage<uns
   H=0;
   int i,j;
 
+  // The points used by the tracker are stored contiguously, as well as
+  // their derivatives
+  vpTemplateTrackerPointArray &pts = getPointArray();
+  pts = vpTemplateTrackerPointArray();
+  std::vector<double> dWs;
+
   for(unsigned int point=0;point<templateSize;point++)
   {
     if((!useTemplateSelect)||(ptTemplateSelect[point]))
@@ -62,13 +68,18 @@ void vpTemplateTrackerSSDInverseCompositional::initCompInverse(const vpImage<uns
       j=ptTemplate[point].x;
       X1[0]=j;X1[1]=i;
       Warp->computeDenom(X1,p);
-      ptTemplate[point].dW=new double[nbParam];
+      dWs.resize(dWs.size()+nbParam);
+      double *dWp=&dWs[dWs.size()-nbParam];
 
-      Warp->getdW0(i,j,ptTemplate[point].dy,ptTemplate[point].dx,ptTemplate[point].dW);
+      Warp->getdW0(i,j,ptTemplate[point].dy,ptTemplate[point].dx,dWp);
 
       for(unsigned int it=0;it<nbParam;it++)
         for(unsigned int jt=0;jt<nbParam;jt++)
-          H[it][jt]+=ptTemplate[point].dW[it]*ptTemplate[point].dW[jt];
+          H[it][jt]+=dWp[it]*dWp[jt];
+
+      pts.x.push_back(j);
+      pts.y.push_back(i);
+      pts.val.push_back(ptTemplate[point].val);
     }
 
   }
@@ -82,21 +93,19 @@ void vpTemplateTrackerSSDInverseCompositional::initCompInverse(const vpImage<uns
   vpColVector dWtemp(nbParam);
   vpColVector HiGtemp(nbParam);
 
-  for(unsigned int point=0;point<templateSize;point++)
+  const unsigned int nbPoints=pts.size();
+  pts.HiG.resize(nbPoints*nbParam);
+  pts.x2.resize(nbPoints);
+  pts.y2.resize(nbPoints);
+  for(unsigned int point=0;point<nbPoints;point++)
   {
-    if((!useTemplateSelect)||(ptTemplateSelect[point]))
-    {
-      //i=ptTemplate[point].y;
-      //j=ptTemplate[point].x;
-      for(unsigned int it=0;it<nbParam;it++)
-        dWtemp[it]=ptTemplate[point].dW[it];
-      
-      HiGtemp	= -1.*HCompInverse*dWtemp;
-      ptTemplate[point].HiG=new double[nbParam];
+    for(unsigned int it=0;it<nbParam;it++)
+      dWtemp[it]=dWs[point*nbParam+it];
 
-      for(unsigned int it=0;it<nbParam;it++)
-        ptTemplate[point].HiG[it]=HiGtemp[it];
-    }
+    HiGtemp	= -1.*HCompInverse*dWtemp;
+
+    for(unsigned int it=0;it<nbParam;it++)
+      pts.HiG[point*nbParam+it]=HiGtemp[it];
   }
   compoInitialised=true;
 }
@@ -106,56 +115,68 @@ void vpTemplateTrackerSSDInverseCompositional::initHessienDesired(const vpImage<
   initCompInverse(I);
 }
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  /*
+    Accumulate the error and the descent direction of the points already
+    warped in pts.x2 and pts.y2. Returns the number of points inside the
+    image.
+  */
+  template<class Type>
+  unsigned int accumulateError(const vpImage<Type> &I, const vpTemplateTrackerPointArray &pts, unsigned int nbParam,
+                               double height, double width, double *dp, double &erreur)
+  {
+    unsigned int Nbpoint=0;
+    const unsigned int nbPoints=pts.size();
+    for(unsigned int point=0;point<nbPoints;point++)
+    {
+      double j2=pts.x2[point];
+      double i2=pts.y2[point];
+
+      if((i2>=0)&&(j2>=0)&&(i2<height)&&(j2<width))
+      {
+        double er=(pts.val[point]-I.getValue(i2,j2));
+        const double *HiG=&pts.HiG[point*nbParam];
+        Nbpoint++;
+        for(unsigned int it=0;it<nbParam;it++)
+          dp[it]+=er*HiG[it];
+
+        erreur+=er*er;
+      }
+    }
+    return Nbpoint;
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 void vpTemplateTrackerSSDInverseCompositional::trackNoPyr(const vpImage<unsigned char> &I)
 {
   if(blur)
     vpImageFilter::filter(I, BI,fgG,taillef);
 
   vpColVector dpinv(nbParam);
-  double IW;
-  double Tij;
   unsigned int iteration=0;
-  int i,j;
-  double i2,j2;
   double alpha=2.;
   //vpTemplateTrackerPointtest *pt;
   initPosEvalRMS(p);
 
-  vpTemplateTrackerPoint *pt;
+  vpTemplateTrackerPointArray &pts = getPointArray();
+  const unsigned int nbPoints=pts.size();
+  const double height=I.getHeight()-1;
+  const double width=I.getWidth()-1;
   do
   {
     unsigned int Nbpoint=0;
     double erreur=0;
     dp=0;
-    Warp->computeCoeff(p);
-    for(unsigned int point=0;point<templateSize;point++)
+    if(nbPoints>0)
     {
-      if((!useTemplateSelect)||(ptTemplateSelect[point]))
-      {
-        //pt=&ptTemplatetest[point];
-        pt=&ptTemplate[point];
-        i=pt->y;
-        j=pt->x;
-        X1[0]=j;X1[1]=i;
-        Warp->computeDenom(X1,p);
-        Warp->warpX(X1,X2,p);
-        j2=X2[0];i2=X2[1];
-
-        if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
-        {
-          Tij=pt->val;
-          if(!blur)
-            IW=I.getValue(i2,j2);
-          else
-            IW=BI.getValue(i2,j2);
-          Nbpoint++;
-          double er=(Tij-IW);
-          for(unsigned int it=0;it<nbParam;it++)
-            dp[it]+=er*pt->HiG[it];
-
-          erreur+=er*er;
-        }
-      }
+      // One warp call for all the points
+      Warp->warp(&pts.x[0],&pts.y[0],(int)nbPoints,p,&pts.x2[0],&pts.y2[0]);
+      if(!blur)
+        Nbpoint=accumulateError(I,pts,nbParam,height,width,dp.data,erreur);
+      else
+        Nbpoint=accumulateError(BI,pts,nbParam,height,width,dp.data,erreur);
     }
     //std::cout << "npoint: " << Nbpoint << std::endl;
     if(Nbpoint==0) {
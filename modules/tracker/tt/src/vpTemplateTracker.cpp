@@ -52,7 +52,7 @@ vpTemplateTracker::vpTemplateTracker(vpTemplateTrackerWarp *_warp)
     taillef(7), fgG(NULL), fgdG(NULL), ratioPixelIn(0), mod_i(1), mod_j(1), nbParam(0),
     lambdaDep(0.001), iterationMax(30), iterationGlobale(0), diverge(false), nbIteration(0),
     useCompositionnal(true), useInverse(false), Warp(_warp), p(0), dp(), X1(), X2(),
-    dW(), BI(), dIx(), dIy(), zoneRef_()
+    dW(), BI(), dIx(), dIy(), zoneRef_(), pyr_I(), ptTemplateArray()
 {
   nbParam = Warp->getNbParam() ;
   p.resize(nbParam);
@@ -310,8 +310,52 @@ void vpTemplateTracker::resetTracker()
       }
     }
   }
+  ptTemplateArray.clear();
 }	
 
+/*!
+  Return the points of the current pyramid level, the one of ptTemplate.
+*/
+vpTemplateTrackerPointArray &vpTemplateTracker::getPointArray()
+{
+  unsigned int level=0;
+  if(ptTemplatePyr!=NULL)
+  {
+    for(unsigned int l=0;l<nbLvlPyr;l++)
+      if(ptTemplatePyr[l]==ptTemplate)
+        level=l;
+  }
+  if(ptTemplateArray.size()<=level)
+    ptTemplateArray.resize(level+1);
+  return ptTemplateArray[level];
+}
+
+/*!
+  Copy all the points of ptTemplate in the point array of the current pyramid
+  level and return it. The per-point vectors HiG and dW are left empty.
+*/
+vpTemplateTrackerPointArray &vpTemplateTracker::initPointArray()
+{
+  vpTemplateTrackerPointArray &pts = getPointArray();
+  pts = vpTemplateTrackerPointArray();
+  pts.x.resize(templateSize);
+  pts.y.resize(templateSize);
+  pts.val.resize(templateSize);
+  pts.dx.resize(templateSize);
+  pts.dy.resize(templateSize);
+  for(unsigned int point=0;point<templateSize;point++)
+  {
+    pts.x[point]=ptTemplate[point].x;
+    pts.y[point]=ptTemplate[point].y;
+    pts.val[point]=ptTemplate[point].val;
+    pts.dx[point]=ptTemplate[point].dx;
+    pts.dy[point]=ptTemplate[point].dy;
+  }
+  pts.x2.resize(templateSize);
+  pts.y2.resize(templateSize);
+  return pts;
+}
+
 /*!
   Display the warped reference template in an image.
 
@@ -643,10 +687,12 @@ void vpTemplateTracker::initTrackingPyr(const vpImage<unsigned char>& I,vpTempla
   //creationpyramide de zones et images desiree
   if(nbLvlPyr>1)
   {
+    pyr_I.setNbLevels(nbLvlPyr);
+    pyr_I.build(pyr_IDes[0]);
     for(unsigned int i=1;i<nbLvlPyr;i++)
     {
       zoneTrackedPyr[i]=zoneTrackedPyr[i-1].getPyramidDown();
-      vpImageFilter::getGaussPyramidal(pyr_IDes[i-1],pyr_IDes[i]);
+      pyr_IDes[i]=pyr_I[i];
 
       initTracking(pyr_IDes[i],zoneTrackedPyr[i]);
       ptTemplatePyr[i]=ptTemplate;
@@ -778,10 +824,11 @@ void vpTemplateTracker::initHessienDesiredPyr(const vpImage<unsigned char> &I)
 
   if(nbLvlPyr>1)
   {
-    vpImage<unsigned char> Itemp;Itemp=I;
+    pyr_I.setNbLevels(nbLvlPyr);
+    pyr_I.build(I);
     for(unsigned int i=1;i<nbLvlPyr;i++)
     {
-      vpImageFilter::getGaussPyramidal(Itemp,Itemp);
+      const vpImage<unsigned char> &Itemp = pyr_I[i];
 
       templateSize=templateSizePyr[i];
       ptTemplate=ptTemplatePyr[i];
@@ -821,13 +868,57 @@ void vpTemplateTracker::track(const vpImage<unsigned char> &I)
     trackNoPyr(I);
 }
 
+/*!
+   Track the template on an image pyramid built by the caller, for example
+   to share the same pyramid between several trackers working on the same
+   frame. The pyramid has to be built with vpImagePyramid::GAUSSIAN_FILTER,
+   like the pyramid of the reference template.
+   \param pyramid: Pyramid of the image to process, with at least as many
+   levels as the tracker (see setPyramidal()).
+
+   \exception vpTrackingException::badValue : If the pyramid has not enough
+   levels, or is not built with vpImagePyramid::GAUSSIAN_FILTER.
+ */
+void vpTemplateTracker::track(const vpImagePyramid &pyramid)
+{
+  if (pyramid.getNbLevels() < nbLvlPyr) {
+    throw(vpTrackingException(vpTrackingException::badValue,
+                              "The image pyramid has less levels than the template tracker"));
+  }
+  if (pyramid.getFilterType() != vpImagePyramid::GAUSSIAN_FILTER) {
+    throw(vpTrackingException(vpTrackingException::badValue,
+                              "The image pyramid has to be built with vpImagePyramid::GAUSSIAN_FILTER"));
+  }
+
+  if (nbLvlPyr > 1)
+    trackPyr(pyramid);
+  else
+    trackNoPyr(pyramid[0]);
+}
+
+/*!
+  Track the template on image \e I with the pyramidal approach. The pyramid
+  of \e I is stored in the tracker and its images are reused from one call
+  to the next.
+  \param I: Image to process.
+ */
 void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
 {
-  //vpTRACE("trackPyr");
-  vpImage<unsigned char> *pyr_I;
-//  pyr_I=new vpImage<unsigned char>[nbLvlPyr+1]; // Why +1 ?
-  pyr_I=new vpImage<unsigned char>[nbLvlPyr]; // Why +1 ?
-  pyr_I[0]=I;
+  pyr_I.setNbLevels(nbLvlPyr);
+  pyr_I.build(I);
+
+  trackPyr(pyr_I);
+}
+
+/*!
+  Track the template on the levels of an image pyramid, from the coarsest
+  level to level l0 (see setPyramidal()).
+  \param pyramid: Gaussian pyramid of the image to process, with at least
+  as many levels as the tracker.
+ */
+void vpTemplateTracker::trackPyr(const vpImagePyramid &pyramid)
+{
+  const vpImage<unsigned char> &I = pyramid[0];
 
   try
   {
@@ -840,7 +931,6 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
     //    p_sauv[0]=p;
         for(unsigned int i=1;i<nbLvlPyr;i++)
         {
-          vpImageFilter::getGaussPyramidal(pyr_I[i-1],pyr_I[i]);
           //test getParamPyramidDown
           /*vpColVector vX_test(2);vX_test[0]=15.;vX_test[1]=30.;
           vpColVector vX_test2(2);
@@ -878,7 +968,7 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
             HLM=HLMdesirePyr[i];
             HLMdesireInverse=HLMdesireInversePyr[i];
     //        zoneTracked=&zoneTrackedPyr[i];
-            trackRobust(pyr_I[i]);
+            trackRobust(pyramid[i]);
           }
           //std::cout<<"get p up"<<std::endl;
     //      ptemp=p_sauv[i-1];
@@ -900,7 +990,7 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
           HLM=HLMdesirePyr[0];
           HLMdesireInverse=HLMdesireInversePyr[0];
           zoneTracked=&zoneTrackedPyr[0];
-          trackRobust(pyr_I[0]);
+          trackRobust(pyramid[0]);
         }
 
         if (l0Pyr > 0) {
@@ -918,10 +1008,8 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
         //std::cout<<"reviens a tracker de base"<<std::endl;
         trackRobust(I);
       }
-      delete[] pyr_I;
   }
   catch(vpException &e){
-      delete[] pyr_I;
       throw(vpTrackingException(vpTrackingException::badValue, e.getMessage()));
   }
 }
@@ -102,6 +102,16 @@ void vpTemplateTrackerWarpAffine::warpX(const vpColVector &vX,vpColVector &vXres
   vXres[1]=ParamM[1]*vX[0]+(1.0+ParamM[3])*vX[1]+ParamM[5];
 }
 
+void vpTemplateTrackerWarpAffine::warp(const double *ut0,const double *vt0,int nb_pt,const vpColVector& p,double *u,double *v)
+{
+  const double a0=1.0+p[0], a1=p[1], a2=p[2], a3=1.0+p[3], a4=p[4], a5=p[5];
+  for(int i=0;i<nb_pt;i++)
+  {
+    u[i]=a0*ut0[i]+a2*vt0[i]+a4;
+    v[i]=a1*ut0[i]+a3*vt0[i]+a5;
+  }
+}
+
 void vpTemplateTrackerWarpAffine::dWarp(const vpColVector &X1,const vpColVector &/*X2*/,const vpColVector &/*ParamM*/,vpMatrix &dW_)
 {
   double j=X1[0];
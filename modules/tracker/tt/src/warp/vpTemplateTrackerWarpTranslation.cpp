@@ -89,6 +89,16 @@ void vpTemplateTrackerWarpTranslation::warpX(const vpColVector &vX,vpColVector &
   vXres[1]=vX[1]+ParamM[1];
 }
 
+void vpTemplateTrackerWarpTranslation::warp(const double *ut0,const double *vt0,int nb_pt,const vpColVector& p,double *u,double *v)
+{
+  const double tu=p[0], tv=p[1];
+  for(int i=0;i<nb_pt;i++)
+  {
+    u[i]=ut0[i]+tu;
+    v[i]=vt0[i]+tv;
+  }
+}
+
 void vpTemplateTrackerWarpTranslation::dWarp(const vpColVector &/*X1*/,const vpColVector &/*X2*/,const vpColVector &/*ParamM*/,
                                              vpMatrix &dW_)
 {
@@ -59,29 +59,31 @@ void vpTemplateTrackerZNCCForwardAdditional::initHessienDesired(const vpImage<un
   vpImageFilter::getGradY(dIy, dIyy, fgdG,taillef);
 
   Warp->computeCoeff(p);
-  double IW,dIWx,dIWy;
+  double IW;
   double Tij;
-  int i,j;
   double i2,j2;
   int Nbpoint=0;
 
+  vpTemplateTrackerPointArray &pts = initPointArray();
+  const unsigned int nbPoints=pts.size();
+  const double height=I.getHeight()-1;
+  const double width=I.getWidth()-1;
+
   double moyTij=0;
   double moyIW=0;
   double denom=0;
-  for(unsigned int point=0;point<templateSize;point++)
+  for(unsigned int point=0;point<nbPoints;point++)
   {
-    i=ptTemplate[point].y;
-    j=ptTemplate[point].x;
-    X1[0]=j;X1[1]=i;
-    X2[0]=j;X2[1]=i;
+    X1[0]=pts.x[point];X1[1]=pts.y[point];
+    X2[0]=pts.x[point];X2[1]=pts.y[point];
 
     Warp->computeDenom(X1,p);
 
     j2=X2[0];i2=X2[1];
 
-    if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+    if((i2>=0)&&(j2>=0)&&(i2<height)&&(j2<width))
     {
-      Tij=ptTemplate[point].val;
+      Tij=pts.val[point];
 
       if(!blur)
         IW=I.getValue(i2,j2);
@@ -96,34 +98,26 @@ void vpTemplateTrackerZNCCForwardAdditional::initHessienDesired(const vpImage<un
   moyTij=moyTij/Nbpoint;
   moyIW=moyIW/Nbpoint;
   Hdesire=0;
-  for(unsigned int point=0;point<templateSize;point++)
+  for(unsigned int point=0;point<nbPoints;point++)
   {
-    i=ptTemplate[point].y;
-    j=ptTemplate[point].x;
-    X1[0]=j;X1[1]=i;
-    X2[0]=j;X2[1]=i;
+    X1[0]=pts.x[point];X1[1]=pts.y[point];
+    X2[0]=pts.x[point];X2[1]=pts.y[point];
 
     Warp->computeDenom(X1,p);
 
     j2=X2[0];i2=X2[1];
 
-    if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+    if((i2>=0)&&(j2>=0)&&(i2<height)&&(j2<width))
     {
-      Tij=ptTemplate[point].val;
+      Tij=pts.val[point];
 
       if(!blur)
         IW=I.getValue(i2,j2);
       else
         IW=BI.getValue(i2,j2);
 
-      dIWx=dIx.getValue(i2,j2);
-      dIWy=dIy.getValue(i2,j2);
       //Calcul du Hessien
       Warp->dWarp(X1,X2,p,dW);
-      double *tempt=new double[nbParam];
-      for(unsigned int it=0;it<nbParam;it++)
-        tempt[it]=dW[0][it]*dIWx+dW[1][it]*dIWy;
-
 
       double prod=(Tij-moyTij);
 
@@ -141,7 +135,6 @@ void vpTemplateTrackerZNCCForwardAdditional::initHessienDesired(const vpImage<un
       Hdesire[1][1]+=prod*d_Iyy;*/
 
       denom+=(Tij-moyTij)*(Tij-moyTij)*(IW-moyIW)*(IW-moyIW);
-      delete[] tempt;
     }
 
 
@@ -174,32 +167,31 @@ void vpTemplateTrackerZNCCForwardAdditional::trackNoPyr(const vpImage<unsigned c
   double IW,dIWx,dIWy;
   double Tij;
   unsigned int iteration=0;
-  int i,j;
   double i2,j2;
   double alpha=2.;
+  vpTemplateTrackerPointArray &pts = getPointArray();
+  const unsigned int nbPoints=pts.size();
+  const double height=I.getHeight()-1;
+  const double width=I.getWidth()-1;
+  vpColVector tempt(nbParam);
   do
   {
     int Nbpoint=0;
     double erreur=0;
     G=0;
     H=0 ;
-    Warp->computeCoeff(p);
+    // One warp call for all the points, used by both passes
+    if(nbPoints>0)
+      Warp->warp(&pts.x[0],&pts.y[0],(int)nbPoints,p,&pts.x2[0],&pts.y2[0]);
     double moyTij=0;
     double moyIW=0;
     double denom=0;
-    for(unsigned int point=0;point<templateSize;point++)
+    for(unsigned int point=0;point<nbPoints;point++)
     {
-      i=ptTemplate[point].y;
-      j=ptTemplate[point].x;
-      X1[0]=j;X1[1]=i;
-
-      Warp->computeDenom(X1,p);
-      Warp->warpX(X1,X2,p);
-
-      j2=X2[0];i2=X2[1];
-      if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+      j2=pts.x2[point];i2=pts.y2[point];
+      if((i2>=0)&&(j2>=0)&&(i2<height)&&(j2<width))
       {
-        Tij=ptTemplate[point].val;
+        Tij=pts.val[point];
 
         if(!blur)
           IW=I.getValue(i2,j2);
@@ -221,19 +213,12 @@ void vpTemplateTrackerZNCCForwardAdditional::trackNoPyr(const vpImage<unsigned c
     moyIW=moyIW/Nbpoint;
     //vpMatrix d2Wx(nbParam,nbParam);
     //vpMatrix d2Wy(nbParam,nbParam);
-    for(unsigned int point=0;point<templateSize;point++)
+    for(unsigned int point=0;point<nbPoints;point++)
     {
-      i=ptTemplate[point].y;
-      j=ptTemplate[point].x;
-      X1[0]=j;X1[1]=i;
-
-      Warp->computeDenom(X1,p);
-      Warp->warpX(X1,X2,p);
-
-      j2=X2[0];i2=X2[1];
-      if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+      j2=pts.x2[point];i2=pts.y2[point];
+      if((i2>=0)&&(j2>=0)&&(i2<height)&&(j2<width))
       {
-        Tij=ptTemplate[point].val;
+        Tij=pts.val[point];
 
         if(!blur)
           IW=I.getValue(i2,j2);
@@ -243,8 +228,10 @@ void vpTemplateTrackerZNCCForwardAdditional::trackNoPyr(const vpImage<unsigned c
         dIWx=dIx.getValue(i2,j2);
         dIWy=dIy.getValue(i2,j2);
         //Calcul du Hessien
+        X1[0]=pts.x[point];X1[1]=pts.y[point];
+        X2[0]=j2;X2[1]=i2;
+        Warp->computeDenom(X1,p);
         Warp->dWarp(X1,X2,p,dW);
-        double *tempt=new double[nbParam];
         for(unsigned int it=0;it<nbParam;it++)
           tempt[it]=dW[0][it]*dIWx+dW[1][it]*dIWy;
 
@@ -273,7 +260,6 @@ void vpTemplateTrackerZNCCForwardAdditional::trackNoPyr(const vpImage<unsigned c
         double er=(Tij-IW);
         erreur+=(er*er);
         denom+=(Tij-moyTij)*(Tij-moyTij)*(IW-moyIW)*(IW-moyIW);
-        delete[] tempt;
       }
 
 
@@ -54,6 +54,9 @@ void vpTemplateTrackerZNCCInverseCompositional::initCompInverse(const vpImage<un
   vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef);
   vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef);
 
+  // The derivatives of the template, nbParam values per point, are kept in HiG
+  vpTemplateTrackerPointArray &pts = initPointArray();
+  pts.HiG.resize(templateSize*nbParam);
   for(unsigned int point=0;point<templateSize;point++)
   {
     int i=ptTemplate[point].y;
@@ -61,13 +64,12 @@ void vpTemplateTrackerZNCCInverseCompositional::initCompInverse(const vpImage<un
 
     X1[0]=j;X1[1]=i;
     Warp->computeDenom(X1,p);
-    ptTemplate[point].dW=new double[nbParam];
 
     double dx=ptTemplate[point].dx;
     double dy=ptTemplate[point].dy;
     //std::cout<<ptTemplate[point].dx<<","<<ptTemplate[point].dy<<std::endl;
 
-    Warp->getdW0(i,j,dy,dx,ptTemplate[point].dW);
+    Warp->getdW0(i,j,dy,dx,&pts.HiG[point*nbParam]);
 
   }
   //vpTRACE("fin Comp Inverse");
@@ -91,32 +93,34 @@ void vpTemplateTrackerZNCCInverseCompositional::initHessienDesired(const vpImage
   vpImageFilter::getGradY(dIy, dIyy, fgdG,taillef);
 
   Warp->computeCoeff(p);
-  double Ic,dIcx=0.,dIcy=0.;
+  double Ic;
   double Iref;
-  int i,j;
   double i2,j2;
   int Nbpoint=0;
 
+  vpTemplateTrackerPointArray &pts = getPointArray();
+  const unsigned int nbPoints=pts.size();
+  const double height=I.getHeight()-1;
+  const double width=I.getWidth()-1;
+
   double moyIref=0;
   double moyIc=0;
   double denom=0;
   moydIrefdp.resize(nbParam);	moydIrefdp=0;
   vpMatrix moyd2Iref(nbParam,nbParam);moyd2Iref=0;
 
-  for(unsigned int point=0;point<templateSize;point++)
+  for(unsigned int point=0;point<nbPoints;point++)
   {
-    i=ptTemplate[point].y;
-    j=ptTemplate[point].x;
-    X1[0]=j;X1[1]=i;
-    X2[0]=j;X2[1]=i;
+    X1[0]=pts.x[point];X1[1]=pts.y[point];
+    X2[0]=pts.x[point];X2[1]=pts.y[point];
 
     Warp->computeDenom(X1,p);
 
     j2=X2[0];i2=X2[1];
 
-    if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+    if((i2>=0)&&(j2>=0)&&(i2<height)&&(j2<width))
     {
-      Iref=ptTemplate[point].val;
+      Iref=pts.val[point];
 
       if(!blur)
         Ic=I.getValue(i2,j2);
@@ -127,14 +131,12 @@ void vpTemplateTrackerZNCCInverseCompositional::initHessienDesired(const vpImage
       moyIref+=Iref;
       moyIc+=Ic;
 
+      const double *dIrefdp=&pts.HiG[point*nbParam];
       for(unsigned int it=0;it<nbParam;it++)
-        moydIrefdp[it]+=ptTemplate[point].dW[it];
+        moydIrefdp[it]+=dIrefdp[it];
 
 
       Warp->dWarp(X1,X2,p,dW);
-      double *tempt=new double[nbParam];
-      for(unsigned int it=0;it<nbParam;it++)
-        tempt[it]=dW[0][it]*dIcx+dW[1][it]*dIcy;
       double d_Ixx=dIxx.getValue(i2,j2);
       double d_Iyy=dIyy.getValue(i2,j2);
       double d_Ixy=dIxy.getValue(i2,j2);
@@ -146,8 +148,6 @@ void vpTemplateTrackerZNCCInverseCompositional::initHessienDesired(const vpImage
               +dW[1][it]*(dW[0][jt]*d_Ixy+dW[1][jt]*d_Iyy));
         }
 
-      delete[] tempt;
-
 
     }
   }
@@ -162,54 +162,44 @@ void vpTemplateTrackerZNCCInverseCompositional::initHessienDesired(const vpImage
   vpColVector sIcdIref(nbParam);sIcdIref=0;
   vpMatrix sIcd2Iref(nbParam,nbParam);sIcd2Iref=0;
   vpMatrix sdIrefdIref(nbParam,nbParam);sdIrefdIref=0;
-  for(unsigned int point=0;point<templateSize;point++)
+  for(unsigned int point=0;point<nbPoints;point++)
   {
-    i=ptTemplate[point].y;
-    j=ptTemplate[point].x;
-    X1[0]=j;X1[1]=i;
-    X2[0]=j;X2[1]=i;
+    X1[0]=pts.x[point];X1[1]=pts.y[point];
+    X2[0]=pts.x[point];X2[1]=pts.y[point];
 
     Warp->computeDenom(X1,p);
 
     j2=X2[0];i2=X2[1];
 
-    if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+    if((i2>=0)&&(j2>=0)&&(i2<height)&&(j2<width))
     {
-      Iref=ptTemplate[point].val;
+      Iref=pts.val[point];
 
       if(!blur)
         Ic=I.getValue(i2,j2);
       else
         Ic=BI.getValue(i2,j2);
 
-      dIcx=dIx.getValue(i2,j2);
-      dIcy=dIy.getValue(i2,j2);
-
       Warp->dWarp(X1,X2,p,dW);
 
-      double *tempt=new double[nbParam];
-      for(unsigned int it=0;it<nbParam;it++)
-        tempt[it]=dW[0][it]*dIcx+dW[1][it]*dIcy;
-
       double prodIc=(Ic-moyIc);
 
       double d_Ixx=dIxx.getValue(i2,j2);
       double d_Iyy=dIyy.getValue(i2,j2);
       double d_Ixy=dIxy.getValue(i2,j2);
 
+      const double *dIrefdp=&pts.HiG[point*nbParam];
       for(unsigned int it=0;it<nbParam;it++)
         for(unsigned int jt=0;jt<nbParam;jt++)
         {
           sIcd2Iref[it][jt] +=prodIc*(dW[0][it]*(dW[0][jt]*d_Ixx+dW[1][jt]*d_Ixy)
               +dW[1][it]*(dW[0][jt]*d_Ixy+dW[1][jt]*d_Iyy)-moyd2Iref[it][jt]);
-          sdIrefdIref[it][jt] +=(ptTemplate[point].dW[it]-moydIrefdp[it])*(ptTemplate[point].dW[jt]-moydIrefdp[jt]);
+          sdIrefdIref[it][jt] +=(dIrefdp[it]-moydIrefdp[it])*(dIrefdp[jt]-moydIrefdp[jt]);
         }
 
 
-      delete[] tempt;
-
       for(unsigned int it=0;it<nbParam;it++)
-        sIcdIref[it]+=prodIc*(ptTemplate[point].dW[it]-moydIrefdp[it]);
+        sIcdIref[it]+=prodIc*(dIrefdp[it]-moydIrefdp[it]);
 
       covarIref+=(Iref-moyIref)*(Iref-moyIref);
       covarIc+=(Ic-moyIc)*(Ic-moyIc);
@@ -250,30 +240,28 @@ void vpTemplateTrackerZNCCInverseCompositional::trackNoPyr(const vpImage<unsigne
   double Ic;
   double Iref;
   unsigned int iteration=0;
-  int i,j;
   double i2,j2;
+  vpTemplateTrackerPointArray &pts = getPointArray();
+  const unsigned int nbPoints=pts.size();
+  const double height=I.getHeight()-1;
+  const double width=I.getWidth()-1;
   initPosEvalRMS(p);
   do
   {
     unsigned int Nbpoint=0;
     //erreur=0;
     G=0;
-    Warp->computeCoeff(p);
+    // One warp call for all the points, used by both passes
+    if(nbPoints>0)
+      Warp->warp(&pts.x[0],&pts.y[0],(int)nbPoints,p,&pts.x2[0],&pts.y2[0]);
     double moyIref=0;
     double moyIc=0;
-    for(unsigned int point=0;point<templateSize;point++)
+    for(unsigned int point=0;point<nbPoints;point++)
     {
-      i=ptTemplate[point].y;
-      j=ptTemplate[point].x;
-      X1[0]=j;X1[1]=i;
-
-      Warp->computeDenom(X1,p);
-      Warp->warpX(X1,X2,p);
-
-      j2=X2[0];i2=X2[1];
-      if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+      j2=pts.x2[point];i2=pts.y2[point];
+      if((i2>=0)&&(j2>=0)&&(i2<height)&&(j2<width))
       {
-        Iref=ptTemplate[point].val;
+        Iref=pts.val[point];
 
         if(!blur)
           Ic=I.getValue(i2,j2);
@@ -297,19 +285,12 @@ void vpTemplateTrackerZNCCInverseCompositional::trackNoPyr(const vpImage<unsigne
       vpColVector sIrefdIref(nbParam);sIrefdIref=0;
 
 
-      for(unsigned int point=0;point<templateSize;point++)
+      for(unsigned int point=0;point<nbPoints;point++)
       {
-        i=ptTemplate[point].y;
-        j=ptTemplate[point].x;
-        X1[0]=j;X1[1]=i;
-
-        Warp->computeDenom(X1,p);
-        Warp->warpX(X1,X2,p);
-
-        j2=X2[0];i2=X2[1];
-        if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+        j2=pts.x2[point];i2=pts.y2[point];
+        if((i2>=0)&&(j2>=0)&&(i2<height)&&(j2<width))
         {
-          Iref=ptTemplate[point].val;
+          Iref=pts.val[point];
 
           if(!blur)
             Ic=I.getValue(i2,j2);
@@ -317,11 +298,12 @@ void vpTemplateTrackerZNCCInverseCompositional::trackNoPyr(const vpImage<unsigne
             Ic=BI.getValue(i2,j2);
 
 
+          const double *dIrefdp=&pts.HiG[point*nbParam];
           double prod=(Ic-moyIc);
           for(unsigned int it=0;it<nbParam;it++)
-            sIcdIref[it]+=prod*(ptTemplate[point].dW[it]-moydIrefdp[it]);
+            sIcdIref[it]+=prod*(dIrefdp[it]-moydIrefdp[it]);
           for(unsigned int it=0;it<nbParam;it++)
-            sIrefdIref[it]+=(Iref-moyIref)*(ptTemplate[point].dW[it]-moydIrefdp[it]);
+            sIrefdIref[it]+=(Iref-moyIref)*(dIrefdp[it]-moydIrefdp[it]);
 
           //double er=(Iref-Ic);
           //erreur+=(er*er);
@@ -0,0 +1,262 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the warps of a list of points of the template trackers.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testTemplateTrackerWarp.cpp
+
+  \brief Compare the warp of a list of points specialized by the translation,
+  SRT, affine and homography warps with the generic warp that calls warpX()
+  for each point. Track a synthetic template in a warped image with the SSD
+  (inverse compositional, forward additional, forward compositional, ESM)
+  and ZNCC (inverse compositional, forward additional) trackers and both
+  implementations, and check that the parameters are bit-identical and that
+  the warp is recovered.
+*/
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpImagePoint.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/tt/vpTemplateTrackerSSDInverseCompositional.h>
+#include <visp3/tt/vpTemplateTrackerSSDForwardAdditional.h>
+#include <visp3/tt/vpTemplateTrackerSSDForwardCompositional.h>
+#include <visp3/tt/vpTemplateTrackerSSDESM.h>
+#include <visp3/tt/vpTemplateTrackerZNCCForwardAdditional.h>
+#include <visp3/tt/vpTemplateTrackerZNCCInverseCompositional.h>
+
+#include <visp3/tt/vpTemplateTrackerWarpAffine.h>
+#include <visp3/tt/vpTemplateTrackerWarpHomography.h>
+#include <visp3/tt/vpTemplateTrackerWarpSRT.h>
+#include <visp3/tt/vpTemplateTrackerWarpTranslation.h>
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+  // Warp that goes through the generic computeDenom() and warpX() calls for each point
+  template<class Warp>
+  class vpPerPointWarp : public Warp
+  {
+  public:
+    void warp(const double *ut0, const double *vt0, int nb_pt, const vpColVector &p, double *u, double *v) {
+      vpTemplateTrackerWarp::warp(ut0, vt0, nb_pt, p, u, v);
+    }
+  };
+
+  double getRandomValues(const double min, const double max) {
+    return (max - min) * ( (double) rand() / (double) RAND_MAX ) + min;
+  }
+
+  // Texture of the scene at the point (x, y)
+  double texture(const double x, const double y)
+  {
+    return 128 + 60 * sin(x / 7.) * cos(y / 9.) + 40 * sin((x + y) / 13.) + 20 * cos(x * y / 900.);
+  }
+
+  // Image of the texture seen through the affine transformation x' = A x + t
+  void createImage(vpImage<unsigned char> &I, const double A[2][2], const double t[2])
+  {
+    const double det = A[0][0] * A[1][1] - A[0][1] * A[1][0];
+    I.resize(240, 320);
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        const double u = j - t[0], v = i - t[1];
+        const double x = ( A[1][1] * u - A[0][1] * v) / det;
+        const double y = (-A[1][0] * u + A[0][0] * v) / det;
+        I[i][j] = (unsigned char)vpMath::maximum(0., vpMath::minimum(255., texture(x, y)));
+      }
+    }
+  }
+
+  // Warp of random points with random parameters close to 0
+  template<class Warp>
+  bool checkWarp(const std::string &name)
+  {
+    Warp warp;
+    vpPerPointWarp<Warp> warp_ref;
+    const unsigned int nbParam = warp.getNbParam();
+    const int nbPoints = 1000;
+    std::vector<double> x(nbPoints), y(nbPoints), u(nbPoints), v(nbPoints), u_ref(nbPoints), v_ref(nbPoints);
+    for (int k = 0; k < nbPoints; k++) {
+      x[k] = getRandomValues(0, 320);
+      y[k] = getRandomValues(0, 240);
+    }
+    for (unsigned int n = 0; n < 10; n++) {
+      vpColVector p(nbParam);
+      for (unsigned int k = 0; k < nbParam; k++)
+        p[k] = getRandomValues(-0.001, 0.001);
+      warp.warp(&x[0], &y[0], nbPoints, p, &u[0], &v[0]);
+      warp_ref.warp(&x[0], &y[0], nbPoints, p, &u_ref[0], &v_ref[0]);
+      for (int k = 0; k < nbPoints; k++) {
+        if (u[k] != u_ref[k] || v[k] != v_ref[k]) {
+          std::cerr << name << ": the warp of (" << x[k] << ", " << y[k] << ") is (" << u[k] << ", " << v[k]
+                    << ") instead of (" << u_ref[k] << ", " << v_ref[k] << ")" << std::endl;
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  template<class Tracker>
+  vpColVector track(vpTemplateTrackerWarp &warp, const vpImage<unsigned char> &I0, const vpImage<unsigned char> &I1,
+                    double &time)
+  {
+    Tracker tracker(&warp);
+    tracker.setSampling(1, 1);
+    tracker.setLambda(0.001);
+    tracker.setIterationMax(50);
+    tracker.setPyramidal(2, 1);
+
+    std::vector<vpImagePoint> v;
+    v.push_back(vpImagePoint(60, 80)); v.push_back(vpImagePoint(60, 240)); v.push_back(vpImagePoint(180, 240));
+    v.push_back(vpImagePoint(60, 80)); v.push_back(vpImagePoint(180, 240)); v.push_back(vpImagePoint(180, 80));
+    tracker.initFromPoints(I0, v);
+
+    time = vpTime::measureTimeMs();
+    for (unsigned int k = 0; k < 5; k++)
+      tracker.track(I1);
+    time = (vpTime::measureTimeMs() - time) / 5;
+    return tracker.getp();
+  }
+
+  // Track the template of I0 in I1 with both warp implementations
+  template<class Tracker, class Warp>
+  bool checkTracking(const std::string &name, const vpImage<unsigned char> &I0, const vpImage<unsigned char> &I1,
+                     const double A[2][2], const double t[2], const double maxError)
+  {
+    Warp warp;
+    vpPerPointWarp<Warp> warp_ref;
+    double time, time_ref;
+    vpColVector p = track<Tracker>(warp, I0, I1, time);
+    vpColVector p_ref = track<Tracker>(warp_ref, I0, I1, time_ref);
+    for (unsigned int k = 0; k < p.size(); k++) {
+      if (p[k] != p_ref[k]) {
+        std::cerr << name << ": the parameters " << p.t() << " differ from the ones of the per-point warp "
+                  << p_ref.t() << std::endl;
+        return false;
+      }
+    }
+
+    const double corners[4][2] = { { 80, 60 }, { 240, 60 }, { 240, 180 }, { 80, 180 } };
+    double error = 0;
+    for (unsigned int c = 0; c < 4; c++) {
+      const double x2 = A[0][0] * corners[c][0] + A[0][1] * corners[c][1] + t[0];
+      const double y2 = A[1][0] * corners[c][0] + A[1][1] * corners[c][1] + t[1];
+      double i2, j2;
+      warp.computeCoeff(p);
+      vpColVector X1(2);
+      X1[0] = corners[c][0]; X1[1] = corners[c][1];
+      warp.computeDenom(X1, p);
+      warp.warpX((int)corners[c][1], (int)corners[c][0], i2, j2, p);
+      error = vpMath::maximum(error, sqrt(vpMath::sqr(x2 - j2) + vpMath::sqr(y2 - i2)));
+    }
+    std::cout << name << ": error of " << error << " pixel, " << time << " ms per image ; " << time_ref
+              << " ms with the per-point warp" << std::endl;
+    if (error > maxError) {
+      std::cerr << name << ": the warp is not recovered, parameters " << p.t() << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  // Track the translated image It and the image Is transformed by a similarity with the four specialized warps
+  template<class Tracker>
+  bool checkTracker(const std::string &name, const vpImage<unsigned char> &I0, const vpImage<unsigned char> &It,
+                    const double translation[2], const vpImage<unsigned char> &Is, const double similarity[2][2],
+                    const double similarity_t[2], const double maxError)
+  {
+    const double identity[2][2] = { { 1, 0 }, { 0, 1 } };
+    return checkTracking<Tracker, vpTemplateTrackerWarpTranslation>(name + " translation", I0, It, identity,
+                                                                    translation, maxError)
+        && checkTracking<Tracker, vpTemplateTrackerWarpSRT>(name + " SRT", I0, Is, similarity, similarity_t,
+                                                            maxError)
+        && checkTracking<Tracker, vpTemplateTrackerWarpAffine>(name + " affine", I0, Is, similarity, similarity_t,
+                                                               maxError)
+        && checkTracking<Tracker, vpTemplateTrackerWarpHomography>(name + " homography", I0, Is, similarity,
+                                                                   similarity_t, maxError);
+  }
+}
+
+int main()
+{
+  try {
+    srand(0);
+    if (! checkWarp<vpTemplateTrackerWarpTranslation>("translation")
+        || ! checkWarp<vpTemplateTrackerWarpSRT>("SRT")
+        || ! checkWarp<vpTemplateTrackerWarpAffine>("affine")
+        || ! checkWarp<vpTemplateTrackerWarpHomography>("homography")) {
+      return EXIT_FAILURE;
+    }
+
+    // Image translated, and image transformed by a similarity around the center of the template
+    const double identity[2][2] = { { 1, 0 }, { 0, 1 } }, zero[2] = { 0, 0 };
+    const double translation[2] = { 1.5, -1.0 };
+    const double s = 1.01, theta = vpMath::rad(1.);
+    const double similarity[2][2] = { { s * cos(theta), -s * sin(theta) }, { s * sin(theta), s * cos(theta) } };
+    const double similarity_t[2] = { 160 - (similarity[0][0] * 160 + similarity[0][1] * 120) + 1.5,
+                                     120 - (similarity[1][0] * 160 + similarity[1][1] * 120) - 1.0 };
+    vpImage<unsigned char> I0, It, Is;
+    createImage(I0, identity, zero);
+    createImage(It, identity, translation);
+    createImage(Is, similarity, similarity_t);
+
+    // The forward additional ZNCC tracker uses the Hessian of the template and converges slowly
+    if (! checkTracker<vpTemplateTrackerSSDInverseCompositional>("SSD IC", I0, It, translation, Is, similarity,
+                                                                 similarity_t, 0.2)
+        || ! checkTracker<vpTemplateTrackerSSDForwardAdditional>("SSD FA", I0, It, translation, Is, similarity,
+                                                                 similarity_t, 0.2)
+        || ! checkTracker<vpTemplateTrackerSSDForwardCompositional>("SSD FC", I0, It, translation, Is, similarity,
+                                                                    similarity_t, 0.2)
+        || ! checkTracker<vpTemplateTrackerZNCCInverseCompositional>("ZNCC IC", I0, It, translation, Is, similarity,
+                                                                     similarity_t, 0.2)
+        || ! checkTracker<vpTemplateTrackerZNCCForwardAdditional>("ZNCC FA", I0, It, translation, Is, similarity,
+                                                                  similarity_t, 3)
+        // ESM needs a warp that is a group, among the specialized ones only the translation
+        || ! checkTracking<vpTemplateTrackerSSDESM, vpTemplateTrackerWarpTranslation>("SSD ESM translation", I0, It,
+                                                                                      identity, translation, 0.2)) {
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "testTemplateTrackerWarp is ok." << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -45,9 +45,42 @@
 #include <visp3/tt/vpTemplateTrackerHeader.h>
 #include <visp3/core/vpImageFilter.h>
 
+#include <vector>
+
+/*!
+  \struct vpTemplateTrackerMISample
+  Template point that lies in the current image, and that contributes to the
+  joint probability of the template and image intensities.
+*/
+struct vpTemplateTrackerMISample {
+    unsigned int point; //!< Index of the template point
+    int c;              //!< Bin of the image intensity
+    double e;           //!< Position of the image intensity in its bin
+    const double *val;  //!< nbParam derivatives of the warped intensity, or NULL
+    int order;          //!< Highest order of the derivatives of the probability to update: 0, 1 or 2
+};
+
+/*!
+  \struct vpTemplateTrackerMIBsplineTable
+  B-spline coefficients of the intensities of the template points, computed
+  once per pyramid level.
+*/
+struct vpTemplateTrackerMIBsplineTable {
+    std::vector<int> c;         //!< Bin of each template point
+    std::vector<double> coef;   //!< B-spline coefficients, then first and second derivatives of each point
+    vpTemplateTrackerMIBsplineTable() : c(), coef() {}
+};
+
 /*!
   \class vpTemplateTrackerMI
   \ingroup group_tt_mi_tracker
+
+  The joint probability of the template and image intensities and its
+  derivatives are accumulated in parallel: the template points are split in
+  consecutive blocks, each block updates its own histogram, and the
+  histograms are summed in the order of the blocks. The blocks only depend
+  on the number of template points, so the result doesn't depend on the
+  number of threads, set by setNbThreads(), nor on their scheduling.
 */
 class VISP_EXPORT vpTemplateTrackerMI: public vpTemplateTracker
 {
@@ -111,7 +144,21 @@ protected:
   vpMatrix    covarianceMatrix;
   bool        computeCovariance;
 
+  //! Number of threads used to accumulate the probabilities, 0 for vpThreadPool::getNbThreads()
+  unsigned int nbThreads;
+  //! Template points inside the image since the last zeroProbabilities()
+  std::vector<vpTemplateTrackerMISample> samples;
+  unsigned int nbSamples;
+  //! nbParam derivatives of the warped intensity of each template point
+  std::vector<double> sampleDerivatives;
+  //! Probabilities of the blocks of samples, but the first one that uses PrtTout
+  std::vector<double> PrtBlocks;
+  //! B-spline coefficients of the template intensities for each pyramid level
+  std::vector<vpTemplateTrackerMIBsplineTable> templateBspline;
+
 protected:
+  void    accumulateProba(const bool inverse);
+  void    addSample(const unsigned int point, const double IW, const double *val, const int order);
   void    computeGradient();
   void    computeHessien(vpMatrix &H);
   void    computeHessienNormalized(vpMatrix &H);
@@ -121,6 +168,8 @@ protected:
   double  getCost(const vpImage<unsigned char> &I){return getCost(I,p);}
   double  getNormalizedCost(const vpImage<unsigned char> &I, const vpColVector &tp);
   double  getNormalizedCost(const vpImage<unsigned char> &I){return getNormalizedCost(I,p);}
+  vpTemplateTrackerMIBsplineTable &getTemplateBspline();
+  void    initTemplateBspline();
   virtual void    initHessienDesired(const vpImage<unsigned char> &I)=0;
   virtual void    trackNoPyr(const vpImage<unsigned char> &I)=0;
   void    zeroProbabilities();
@@ -150,7 +199,8 @@ public:
       temp(NULL), Prt(NULL), dPrt(NULL), Pt(NULL), Pr(NULL), d2Prt(NULL), PrtTout(NULL),
       dprtemp(NULL), PrtD(NULL), dPrtD(NULL), influBspline(0), bspline(0), Nc(0), Ncb(0),
       d2Ix(), d2Iy(), d2Ixy(), MI_preEstimation(0), MI_postEstimation(0),
-      NMI_preEstimation(0), NMI_postEstimation(0), covarianceMatrix(), computeCovariance(false)
+      NMI_preEstimation(0), NMI_postEstimation(0), covarianceMatrix(), computeCovariance(false),
+      nbThreads(0), samples(), nbSamples(0), sampleDerivatives(), PrtBlocks(), templateBspline()
   {}
   vpTemplateTrackerMI(vpTemplateTrackerWarp *_warp);
   ~vpTemplateTrackerMI();
@@ -159,6 +209,11 @@ public:
   double getMI(const vpImage<unsigned char> &I,int &nc, const int &bspline,vpColVector &tp);
   double getMI256(const vpImage<unsigned char> &I, const vpColVector &tp);
   double getNMI() const {return NMI_postEstimation;}
+  /*!
+    Return the number of threads used to accumulate the probabilities, 0
+    meaning vpThreadPool::getNbThreads().
+  */
+  unsigned int getNbThreads() const {return nbThreads;}
   //initialisation du Hessien en position desiree
   void setApprocHessian(vpHessienApproximationType approx){ApproxHessian=approx;}
   void setCovarianceComputation(const bool & flag){ computeCovariance = flag; }
@@ -166,6 +221,12 @@ public:
   void setBspline(const vpBsplineType &newbs);
   void setLambda(double _l) {lambda = _l ; }
   void setNc(int newNc);
+  /*!
+    Set the number of threads used to accumulate the probabilities. 0, the
+    default, uses vpThreadPool::getNbThreads() threads. The tracking results
+    don't depend on the number of threads.
+  */
+  void setNbThreads(const unsigned int nb) {nbThreads = nb;}
 };
 
 #endif
@@ -97,6 +97,9 @@ public:
 
   static double d2Bspline3(double diff);
   static double d2Bspline4(double diff);
+
+  static void computeBsplineCoefficients(int &c, double &e, const int &degree, double *B, double *dB=NULL,
+                                         double *d2B=NULL);
 };
 
 #endif
@@ -77,6 +77,7 @@ private:
   vpMatrix    KQuasiNewton;
 
 protected:
+  void computeHessienDesired(const vpImage<unsigned char> &I);
   void initHessienDesired(const vpImage<unsigned char> &I);
   void trackNoPyr(const vpImage<unsigned char> &I);
   void deletePosEvalRMS();
@@ -37,9 +37,12 @@
  *
  *****************************************************************************/
 #include <visp3/core/vpException.h>
+#include <visp3/core/vpThreadPool.h>
 #include <visp3/tt_mi/vpTemplateTrackerMI.h>
 #include <visp3/tt_mi/vpTemplateTrackerMIBSpline.h>
 
+#include <string.h>
+
 void vpTemplateTrackerMI::setBspline(const vpBsplineType &newbs)
 {
   bspline=(int)newbs;
@@ -65,6 +68,7 @@ void vpTemplateTrackerMI::setBspline(const vpBsplineType &newbs)
   PrtD= new double[Nc*Nc*influBspline];
   dPrtD= new double[Nc*Nc*(int)(nbParam)*influBspline];
   PrtTout= new double[Nc*Nc*influBspline*(1+(int)(nbParam+nbParam*nbParam))];
+  templateBspline.clear();
 
   hessianComputation=USE_HESSIEN_DESIRE;
 }
@@ -75,7 +79,8 @@ vpTemplateTrackerMI::vpTemplateTrackerMI(vpTemplateTrackerWarp *_warp)
     temp(NULL), Prt(NULL), dPrt(NULL), Pt(NULL), Pr(NULL), d2Prt(NULL), PrtTout(NULL),
     dprtemp(NULL), PrtD(NULL), dPrtD(NULL), influBspline(0), bspline(3), Nc(8), Ncb(0),
     d2Ix(), d2Iy(), d2Ixy(), MI_preEstimation(0), MI_postEstimation(0),
-    NMI_preEstimation(0), NMI_postEstimation(0), covarianceMatrix(), computeCovariance(false)
+    NMI_preEstimation(0), NMI_postEstimation(0), covarianceMatrix(), computeCovariance(false),
+    nbThreads(0), samples(), nbSamples(0), sampleDerivatives(), PrtBlocks(), templateBspline()
 {
   Ncb=Nc+bspline;
   influBspline=bspline*bspline;
@@ -128,6 +133,7 @@ void vpTemplateTrackerMI::setNc(int nc)
   Pr= new double[Ncb];
   d2Prt= new double[Ncb*Ncb*(int)(nbParam*nbParam)];//(r,t)
   PrtTout= new double[Nc*Nc*influBspline*(1+(int)(nbParam+nbParam*nbParam))];
+  templateBspline.clear();
 }
 
 
@@ -652,12 +658,267 @@ void vpTemplateTrackerMI::zeroProbabilities()
   memset(d2Prt, 0, Ncb_*Ncb_*nbParam*nbParam*sizeof(double));
   memset(PrtTout, 0, Nc_*Nc_*influBspline_*(1+nbParam+nbParam*nbParam)*sizeof(double));
 
+  nbSamples=0;
+  if(samples.size()<templateSize)
+    samples.resize(templateSize);
+  if(sampleDerivatives.size()<templateSize*nbParam)
+    sampleDerivatives.resize(templateSize*nbParam);
+
   //    std::cout << Ncb*Ncb << std::endl;
   //    std::cout << Ncb*Ncb*nbParam << std::endl;
   //    std::cout << Ncb*Ncb*nbParam*nbParam << std::endl;
   //    std::cout << Ncb*Ncb*influBspline*(1+nbParam+nbParam*nbParam) << std::endl;
 }
 
+/*!
+  Add the template point \e point to the samples accumulated by
+  accumulateProba().
+
+  \param point : Index of the template point, that lies in the image.
+  \param IW : Intensity of the image at the warped point.
+  \param val : The nbParam derivatives of the warped intensity, that must
+  stay valid until accumulateProba(). Unused when \e order is 0.
+  \param order : Highest order of the derivatives of the joint probability
+  updated by the point: 0 for the probability only (PrtTout), 1 for the
+  first derivatives, 2 for the first and second derivatives.
+*/
+void vpTemplateTrackerMI::addSample(const unsigned int point, const double IW, const double *val, const int order)
+{
+  double v=(IW*(Nc-1))/255.;
+  vpTemplateTrackerMISample &sample=samples[nbSamples++];
+  sample.point=point;
+  sample.c=(int)v;
+  sample.e=v-sample.c;
+  sample.val=val;
+  sample.order=order;
+}
+
+/*!
+  Return the B-spline coefficients of the template points of the current
+  pyramid level, the one of ptTemplate. They are computed the first time
+  and after setNc() or setBspline().
+*/
+vpTemplateTrackerMIBsplineTable &vpTemplateTrackerMI::getTemplateBspline()
+{
+  unsigned int level=0;
+  if(ptTemplatePyr!=NULL)
+  {
+    for(unsigned int l=0;l<nbLvlPyr;l++)
+      if(ptTemplatePyr[l]==ptTemplate)
+        level=l;
+  }
+  if(templateBspline.size()<=level)
+    templateBspline.resize(level+1);
+  if(templateBspline[level].c.size()!=templateSize)
+    initTemplateBspline();
+  return templateBspline[level];
+}
+
+/*!
+  Compute the B-spline coefficients of the intensities of the template
+  points of the current pyramid level. They do not depend on the image and
+  are used by accumulateProba() at each iteration.
+*/
+void vpTemplateTrackerMI::initTemplateBspline()
+{
+  unsigned int level=0;
+  if(ptTemplatePyr!=NULL)
+  {
+    for(unsigned int l=0;l<nbLvlPyr;l++)
+      if(ptTemplatePyr[l]==ptTemplate)
+        level=l;
+  }
+  if(templateBspline.size()<=level)
+    templateBspline.resize(level+1);
+
+  vpTemplateTrackerMIBsplineTable &table=templateBspline[level];
+  table.c.resize(templateSize);
+  table.coef.resize(templateSize*3*(unsigned int)bspline);
+  for(unsigned int point=0;point<templateSize;point++)
+  {
+    double Tij=ptTemplate[point].val;
+    int c=(int)((Tij*(Nc-1))/255.);
+    double e=(Tij*(Nc-1))/255.-c;
+    double *coef=&table.coef[point*3*(unsigned int)bspline];
+    vpTemplateTrackerMIBSpline::computeBsplineCoefficients(c, e, bspline, coef, coef+bspline, coef+2*bspline);
+    table.c[point]=c;
+  }
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Accumulate blocks of samples in PrtTout for the first block, in private
+  // histograms for the others
+  struct vpProbaAccumulator {
+    const vpTemplateTrackerMISample *samples;
+    unsigned int nbSamples;
+    unsigned int nbBlocks;
+    const vpTemplateTrackerMIBsplineTable *table;
+    int degree;
+    int Nc;
+    unsigned int nbParam;
+    bool inverse;
+    double *PrtTout;
+    double *PrtBlocks;
+    unsigned int size;
+
+    void operator()(unsigned int begin, unsigned int end) const
+    {
+      for(unsigned int block=begin;block<end;block++)
+      {
+        double *Prt=PrtTout;
+        if(block>0)
+        {
+          Prt=PrtBlocks+(block-1)*size;
+          memset(Prt, 0, size*sizeof(double));
+        }
+        unsigned int first=(unsigned int)(((unsigned long long)nbSamples*block)/nbBlocks);
+        unsigned int last=(unsigned int)(((unsigned long long)nbSamples*(block+1))/nbBlocks);
+        for(unsigned int k=first;k<last;k++)
+          accumulate(Prt, samples[k]);
+      }
+    }
+
+    /*
+      Same computation as vpTemplateTrackerMIBSpline::PutTotPVBspline(), with
+      the coefficients of the template intensity taken from the table. The
+      reference intensity r is the one of the template and t the one of the
+      image, unless inverse is true: the derivatives are then the ones of
+      the template.
+    */
+    void accumulate(double *Prt, const vpTemplateTrackerMISample &sample) const
+    {
+      double B[4], dB[4], d2B[4];
+      int c=sample.c;
+      double e=sample.e;
+      const double *coef=&table->coef[sample.point*3*(unsigned int)degree];
+
+      const double *Br, *Bt, *dBt, *d2Bt;
+      int cr, ct;
+      if(inverse)
+      {
+        vpTemplateTrackerMIBSpline::computeBsplineCoefficients(c, e, degree, B);
+        cr=c;
+        Br=B;
+        ct=table->c[sample.point];
+        Bt=coef;
+        dBt=coef+degree;
+        d2Bt=coef+2*degree;
+      }
+      else
+      {
+        vpTemplateTrackerMIBSpline::computeBsplineCoefficients(c, e, degree, B, sample.order>0 ? dB : NULL,
+                                                               sample.order>1 ? d2B : NULL);
+        cr=table->c[sample.point];
+        Br=coef;
+        ct=c;
+        Bt=B;
+        dBt=dB;
+        d2Bt=d2B;
+      }
+
+      const double *val=sample.val;
+      unsigned int NbParam_val=nbParam+nbParam*nbParam;
+      double *pt=&Prt[(unsigned int)(cr*Nc+ct)*(unsigned int)(degree*degree)*(1+NbParam_val)];
+      for(int ir=0;ir<degree;ir++)
+      {
+        for(int it=0;it<degree;it++)
+        {
+          *pt++ += Br[ir]*Bt[it];
+          if(sample.order==0)
+          {
+            pt+=NbParam_val;
+            continue;
+          }
+          double v1=Br[ir]*dBt[it];
+          for(unsigned int ip=0;ip<nbParam;ip++)
+          {
+            *pt++ -= v1*val[ip];
+            if(sample.order==1)
+            {
+              pt+=nbParam;
+              continue;
+            }
+            double v2=Br[ir]*d2Bt[it]*val[ip];
+            for(unsigned int ip2=0;ip2<nbParam;ip2++)
+              *pt++ += v2*val[ip2];
+          }
+        }
+      }
+    }
+  };
+
+  // Sum the private histograms in PrtTout, in the order of the blocks
+  struct vpProbaReduction {
+    double *PrtTout;
+    const double *PrtBlocks;
+    unsigned int nbBlocks;
+    unsigned int size;
+
+    void operator()(unsigned int begin, unsigned int end) const
+    {
+      for(unsigned int block=1;block<nbBlocks;block++)
+      {
+        const double *src=PrtBlocks+(block-1)*size;
+        for(unsigned int i=begin;i<end;i++)
+          PrtTout[i]+=src[i];
+      }
+    }
+  };
+}
+#endif
+
+/*!
+  Accumulate in PrtTout the samples added by addSample() since the last
+  zeroProbabilities().
+
+  The samples are split in consecutive blocks accumulated in parallel,
+  which private histograms are then summed in the order of the blocks. A
+  block has at least 4*Nc*Nc samples, so that summing its histogram costs
+  less than accumulating it, and there are at most 8 blocks. The blocks
+  don't depend on the number of threads, so neither does the result.
+
+  \param inverse : If false, the derivatives are the ones of the image
+  intensity, as in the forward approaches. If true, they are the ones of the
+  template intensity, as in the inverse compositional approach.
+*/
+void vpTemplateTrackerMI::accumulateProba(const bool inverse)
+{
+  const unsigned int size=(unsigned int)(Nc*Nc*influBspline)*(1+nbParam+nbParam*nbParam);
+  unsigned int nbBlocks=8;
+  unsigned int maxBlocks=nbSamples/(4*(unsigned int)(Nc*Nc));
+  if(nbBlocks>maxBlocks)
+    nbBlocks=maxBlocks;
+  if(nbBlocks==0)
+    nbBlocks=1;
+  if(PrtBlocks.size()<(nbBlocks-1)*size)
+    PrtBlocks.resize((nbBlocks-1)*size);
+
+  vpProbaAccumulator accumulator;
+  accumulator.samples=nbSamples>0 ? &samples[0] : NULL;
+  accumulator.nbSamples=nbSamples;
+  accumulator.nbBlocks=nbBlocks;
+  accumulator.table=&getTemplateBspline();
+  accumulator.degree=bspline;
+  accumulator.Nc=Nc;
+  accumulator.nbParam=nbParam;
+  accumulator.inverse=inverse;
+  accumulator.PrtTout=PrtTout;
+  accumulator.PrtBlocks=nbBlocks>1 ? &PrtBlocks[0] : NULL;
+  accumulator.size=size;
+  vpThreadPool::parallel_for(0, nbBlocks, accumulator, nbThreads);
+
+  if(nbBlocks>1)
+  {
+    vpProbaReduction reduction;
+    reduction.PrtTout=PrtTout;
+    reduction.PrtBlocks=&PrtBlocks[0];
+    reduction.nbBlocks=nbBlocks;
+    reduction.size=size;
+    vpThreadPool::parallel_for(0, size, reduction, nbThreads, 4096);
+  }
+}
+
 double vpTemplateTrackerMI::getMI(const vpImage<unsigned char> &I,int &nc, const int &bspline_,vpColVector &tp)
 {
   unsigned int tNcb = (unsigned int)(nc+bspline_);
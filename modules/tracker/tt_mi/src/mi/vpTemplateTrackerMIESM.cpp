@@ -39,10 +39,6 @@
 
 #include <visp3/tt_mi/vpTemplateTrackerMIESM.h>
 
-#ifdef VISP_HAVE_OPENMP
-#include <omp.h>
-#endif
-
 vpTemplateTrackerMIESM::vpTemplateTrackerMIESM(vpTemplateTrackerWarp *_warp)
   : vpTemplateTrackerMI(_warp), minimizationMethod(USE_NEWTON), CompoInitialised(false),
     HDirect(), HInverse(), HdesireDirect(), HdesireInverse(), GDirect(), GInverse()
@@ -65,9 +61,7 @@ void vpTemplateTrackerMIESM::initHessienDesired(const vpImage<unsigned char> &I)
 
   double i2,j2;
   //double Tij;
-  double /*IW,*/dx,dy;
-  //int cr,ct;
-  //double er,et;
+  double IW,dx,dy;
   int i,j;
 
   Nbpoint=0;
@@ -93,25 +87,18 @@ void vpTemplateTrackerMIESM::initHessienDesired(const vpImage<unsigned char> &I)
     if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
     {
       Nbpoint++;
-//      if(blur)
-//        IW=BI.getValue(i2,j2);
-//      else
-//        IW=I.getValue(i2,j2);
-
-      //ct=ptTemplateSupp[point].ct;
-      //et=ptTemplateSupp[point].et;
-      //cr=(int)((IW*(Nc-1))/255.);
-      //er=((double)IW*(Nc-1))/255.-cr;
-
-      //            if(ApproxHessian==vpTemplateTrackerMI::HESSIAN_NONSECOND) // cas à tester AY
-      //                vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout,cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam, bspline);
-      //            else
-      //                vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout,cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam, bspline);
-
-      //            vpTemplateTrackerMIBSpline::computeProbabilities(PrtTout,cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam,bspline,ApproxHessian,false);
+      if(blur)
+        IW=BI.getValue(i2,j2);
+      else
+        IW=I.getValue(i2,j2);
+
+      if(ApproxHessian==vpTemplateTrackerMI::HESSIAN_NONSECOND)
+        addSample(point, IW, ptTemplate[point].dW, 1);
+      else
+        addSample(point, IW, ptTemplate[point].dW, 2);
     }
   }
-
+  accumulateProba(true);
 
   double MI;
   computeProba(Nbpoint);
@@ -147,45 +134,34 @@ void vpTemplateTrackerMIESM::initHessienDesired(const vpImage<unsigned char> &I)
 
     j2=X2[0];i2=X2[1];
 
-    if((i2>=0)&&(j2>=0)&&(i2<I.getHeight())&&(j2<I.getWidth()))
+    if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
     {
       Nbpoint++;
       //Tij=ptTemplate[point].val;
-      //if(!blur)
-      //  IW=I.getValue(i2,j2);
-      //else
-      //  IW=BI.getValue(i2,j2);
+      if(!blur)
+        IW=I.getValue(i2,j2);
+      else
+        IW=BI.getValue(i2,j2);
 
       dx=1.*dIx.getValue(i2,j2)*(Nc-1)/255.;
       dy=1.*dIy.getValue(i2,j2)*(Nc-1)/255.;
 
-      //cr=ptTemplateSupp[point].ct;
-      //er=ptTemplateSupp[point].et;
-      //ct=(int)((IW*(Nc-1))/255.);
-      //et=((double)IW*(Nc-1))/255.-ct;
-
       Warp->dWarpCompo(X1,X2,p,ptTemplateCompo[point].dW,dW);
 
-      double *tptemp=new double[nbParam];
+      double *tptemp=&sampleDerivatives[point*nbParam];
       for(unsigned int it=0;it<nbParam;it++)
         tptemp[it] =dW[0][it]*dx+dW[1][it]*dy;
 
-
-      //                vpTemplateTrackerMIBSpline::computeProbabilities(PrtTout,cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam,bspline,ApproxHessian,
-      //                                                         hessianComputation== vpTemplateTrackerMI::USE_HESSIEN_DESIRE);
       //calcul de l'erreur
       //erreur+=(Tij-IW)*(Tij-IW);
 
-      //          if(ApproxHessian==vpTemplateTrackerMI::HESSIAN_NONSECOND) // cas à tester AY
-      //              vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout,cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-      //          else
-      //              vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout,cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-
-      //      vpTemplateTrackerMIBSpline::computeProbabilities(PrtTout,cr, er, ct, et, Nc, tptemp, nbParam,bspline,ApproxHessian,false);
-
-      delete[] tptemp;
+      if(ApproxHessian==vpTemplateTrackerMI::HESSIAN_NONSECOND)
+        addSample(point, IW, tptemp, 1);
+      else
+        addSample(point, IW, tptemp, 2);
     }
   }
+  accumulateProba(false);
 
   computeProba(Nbpoint);
   computeMI(MI);
@@ -240,14 +216,9 @@ void vpTemplateTrackerMIESM::initCompInverse()
     double et=(Tij*(Nc-1))/255.-ct;
     ptTemplateSupp[point].et=et;
     ptTemplateSupp[point].ct=ct;
-    ptTemplateSupp[point].Bt=new double[4];
-    ptTemplateSupp[point].dBt=new double[4];
-    for(char it=-1;it<=2;it++)
-    {
-      ptTemplateSupp[point].Bt[it+1] =vpTemplateTrackerBSpline::Bspline4(-it+et);
-      ptTemplateSupp[point].dBt[it+1] =vpTemplateTrackerMIBSpline::dBspline4(-it+et);
-    }
   }
+  // B-spline coefficients of the template intensities used by accumulateProba()
+  initTemplateBspline();
   CompoInitialised=true;
 }
 
@@ -277,10 +248,7 @@ void vpTemplateTrackerMIESM::trackNoPyr(const vpImage<unsigned char> &I)
   //double MIprec=-1000;
 
   double i2,j2;
-  //double Tij;
-  //double IW;
-  //int cr,ct;
-  //double er,et;
+  double IW;
 
   vpColVector dpinv(nbParam);
 
@@ -314,23 +282,18 @@ void vpTemplateTrackerMIESM::trackNoPyr(const vpImage<unsigned char> &I)
       if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
       {
         Nbpoint++;
-        //Tij=ptTemplate[point].val;
-        //if(!blur)
-        //  IW=I.getValue(i2,j2);
-        //else
-        //  IW=BI.getValue(i2,j2);
-
-        //ct=ptTemplateSupp[point].ct;
-        //et=ptTemplateSupp[point].et;
-        //cr=(int)((IW*(Nc-1))/255.);
-        //er=((double)IW*(Nc-1))/255.-cr;
-
-        //                if(ApproxHessian==vpTemplateTrackerMI::HESSIAN_NONSECOND||hessianComputation==vpTemplateTrackerMI::USE_HESSIEN_DESIRE) // cas à tester AY
-        //                    vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout, cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam, bspline);
-        //                else
-        //                    vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam, bspline);
+        if(!blur)
+          IW=I.getValue(i2,j2);
+        else
+          IW=BI.getValue(i2,j2);
+
+        if(ApproxHessian==vpTemplateTrackerMI::HESSIAN_NONSECOND||hessianComputation==vpTemplateTrackerMI::USE_HESSIEN_DESIRE)
+          addSample(point, IW, ptTemplate[point].dW, 1);
+        else
+          addSample(point, IW, ptTemplate[point].dW, 2);
       }
     }
+    accumulateProba(true);
 
     if(Nbpoint==0)
     {
@@ -359,12 +322,6 @@ void vpTemplateTrackerMIESM::trackNoPyr(const vpImage<unsigned char> &I)
       zeroProbabilities();
 
       Warp->computeCoeff(p);
-#ifdef VISP_HAVE_OPENMP
-      int nthreads = omp_get_num_procs() ;
-      //std::cout << "file: " __FILE__ << " line: " << __LINE__ << " function: " << __FUNCTION__ << " nthread: " << nthreads << std::endl;
-      omp_set_num_threads(nthreads);
-#pragma omp parallel for private(point, i,j,i2,j2) default(shared)
-#endif
       for(point=0;point<(int)templateSize;point++)
       {
         i=ptTemplate[point].y;
@@ -380,39 +337,29 @@ void vpTemplateTrackerMIESM::trackNoPyr(const vpImage<unsigned char> &I)
           Nbpoint++;
           //Tij=ptTemplate[point].val;
           //Tij=Iterateurvecteur->val;
-          //if(!blur)
-          //  IW=I.getValue(i2,j2);
-          //else
-          //  IW=BI.getValue(i2,j2);
+          if(!blur)
+            IW=I.getValue(i2,j2);
+          else
+            IW=BI.getValue(i2,j2);
 
           double dx=1.*dIx.getValue(i2,j2)*(Nc-1)/255.;
           double dy=1.*dIy.getValue(i2,j2)*(Nc-1)/255.;
 
-          //ct=(int)((IW*(Nc-1))/255.);
-          //et=((double)IW*(Nc-1))/255.-ct;
-          //cr=ptTemplateSupp[point].ct;
-          //er=ptTemplateSupp[point].et;
-
           Warp->dWarpCompo(X1,X2,p,ptTemplateCompo[point].dW,dW);
 
-          double *tptemp=new double[nbParam];
+          double *tptemp=&sampleDerivatives[point*nbParam];
           for(unsigned int it=0;it<nbParam;it++)
             tptemp[it] =dW[0][it]*dx+dW[1][it]*dy;
 
-
           //calcul de l'erreur
           //erreur+=(Tij-IW)*(Tij-IW);
-          //                    if(bspline==3)
-          //                        vpTemplateTrackerMIBSpline::PutTotPVBspline3NoSecond(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam);
-          //                    else
-          //                        vpTemplateTrackerMIBSpline::PutTotPVBspline4NoSecond(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam);
-          //					vpTemplateTrackerMIBSpline::computeProbabilities(PrtTout,cr, er, ct, et, Nc, tptemp, nbParam,bspline,ApproxHessian,
-          //                               hessianComputation==vpHessienType::USE_HESSIEN_DESIRE);
-
-          delete[] tptemp;
-
+          if(ApproxHessian==vpTemplateTrackerMI::HESSIAN_NONSECOND||hessianComputation==vpTemplateTrackerMI::USE_HESSIEN_DESIRE)
+            addSample(point, IW, tptemp, 1);
+          else
+            addSample(point, IW, tptemp, 2);
         }
       }
+      accumulateProba(false);
 
       computeProba(Nbpoint);
       computeMI(MI);
@@ -39,10 +39,6 @@
 
 #include <visp3/tt_mi/vpTemplateTrackerMIForwardAdditional.h>
 
-#ifdef VISP_HAVE_OPENMP
-#include <omp.h>
-#endif
-
 vpTemplateTrackerMIForwardAdditional::vpTemplateTrackerMIForwardAdditional(vpTemplateTrackerWarp *_warp)
   : vpTemplateTrackerMI(_warp), minimizationMethod(USE_NEWTON), evolRMS(0), x_pos(NULL), y_pos(NULL),
     threshold_RMS(0), p_prec(), G_prec(), KQuasiNewton()
@@ -55,6 +51,12 @@ vpTemplateTrackerMIForwardAdditional::vpTemplateTrackerMIForwardAdditional(vpTem
 }
 
 void vpTemplateTrackerMIForwardAdditional::initHessienDesired(const vpImage<unsigned char> &I)
+{
+  initTemplateBspline();
+  computeHessienDesired(I);
+}
+
+void vpTemplateTrackerMIForwardAdditional::computeHessienDesired(const vpImage<unsigned char> &I)
 {
   //std::cout<<"Initialise Hessian at Desired position..."<<std::endl;
 
@@ -67,10 +69,7 @@ void vpTemplateTrackerMIForwardAdditional::initHessienDesired(const vpImage<unsi
   vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef);
   vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef);
 
-  double Tij;
   double IW,dx,dy;
-  int cr,ct;
-  double er,et;
 
   Nbpoint=0;
 
@@ -92,7 +91,6 @@ void vpTemplateTrackerMIForwardAdditional::initHessienDesired(const vpImage<unsi
     if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
     {
       Nbpoint++;
-      Tij=ptTemplate[point].val;
       if(!blur)
         IW=I.getValue(i2,j2);
       else
@@ -101,25 +99,20 @@ void vpTemplateTrackerMIForwardAdditional::initHessienDesired(const vpImage<unsi
       dx=1.*dIx.getValue(i2,j2)*(Nc-1)/255.;
       dy=1.*dIy.getValue(i2,j2)*(Nc-1)/255.;
 
-      ct=(int)((IW*(Nc-1))/255.);
-      cr=(int)((Tij*(Nc-1))/255.);
-      et=(IW*(Nc-1))/255.-ct;
-      er=((double)Tij*(Nc-1))/255.-cr;
       //std::cout<<"test"<<std::endl;
       Warp->dWarp(X1,X2,p,dW);
 
-      double *tptemp=new double[nbParam];
+      double *tptemp=&sampleDerivatives[point*nbParam];
       for(unsigned int it=0;it<nbParam;it++)
         tptemp[it] =dW[0][it]*dx+dW[1][it]*dy;
 
       if(ApproxHessian==HESSIAN_NONSECOND)
-        vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
+        addSample(point, IW, tptemp, 1);
       else if(ApproxHessian==HESSIAN_0 || ApproxHessian==HESSIAN_NEW)
-        vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-
-      delete[] tptemp;
+        addSample(point, IW, tptemp, 2);
     }
   }
+  accumulateProba(false);
 
   if(Nbpoint>0)
   {
@@ -170,7 +163,7 @@ void vpTemplateTrackerMIForwardAdditional::trackNoPyr(const vpImage<unsigned cha
   do
   {
     if(iteration%5==0)
-      initHessienDesired(I);
+      computeHessienDesired(I);
     Nbpoint=0;
     MIprec=MI;
     MI=0;
@@ -179,13 +172,7 @@ void vpTemplateTrackerMIForwardAdditional::trackNoPyr(const vpImage<unsigned cha
     zeroProbabilities();
 
     Warp->computeCoeff(p);
-#ifdef VISP_HAVE_OPENMP
-    int nthreads = omp_get_num_procs() ;
-    //std::cout << "file: " __FILE__ << " line: " << __LINE__ << " function: " << __FUNCTION__ << " nthread: " << nthreads << std::endl;
-    omp_set_num_threads(nthreads);
-#pragma omp parallel for default(shared)
-#endif
-    for(int point=0;point<(int)templateSize;point++)
+    for(unsigned int point=0;point<templateSize;point++)
     {
       int i=ptTemplate[point].y;
       int j=ptTemplate[point].x;
@@ -195,13 +182,12 @@ void vpTemplateTrackerMIForwardAdditional::trackNoPyr(const vpImage<unsigned cha
       Warp->warpX(X1,X2,p);
 
       double j2=X2[0];
-			double i2=X2[1];
+      double i2=X2[1];
 
       if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
       {
         Nbpoint++;
-        double Tij=ptTemplate[point].val;
-				double IW;
+        double IW;
         if(!blur)
           IW=I.getValue(i2,j2);
         else
@@ -210,31 +196,25 @@ void vpTemplateTrackerMIForwardAdditional::trackNoPyr(const vpImage<unsigned cha
         double dx=1.*dIx.getValue(i2,j2)*(Nc-1)/255.;
         double dy=1.*dIy.getValue(i2,j2)*(Nc-1)/255.;
 
-        int ct=(int)((IW*(Nc-1))/255.);
-        int cr=(int)((Tij*(Nc-1))/255.);
-        double et=(IW*(Nc-1))/255.-ct;
-        double er=((double)Tij*(Nc-1))/255.-cr;
-
         //calcul de l'erreur
         //erreur+=(Tij-IW)*(Tij-IW);
 
-        //Calcul de l'histogramme joint par interpolation bilinÃaire (Bspline ordre 1)
+        //Calcul de l'histogramme joint par interpolation bilinÃaire (Bspline ordre 1)
         Warp->dWarp(X1,X2,p,dW);
 
-        //double *tptemp=temp;
-        double *tptemp=new double[nbParam];;
+        double *tptemp=&sampleDerivatives[point*nbParam];
         for(unsigned int it=0;it<nbParam;it++)
           tptemp[it] =(dW[0][it]*dx+dW[1][it]*dy);
         //*tptemp++ =dW[0][it]*dIWx+dW[1][it]*dIWy;
         //std::cout<<cr<<"   "<<ct<<"  ; ";
         if(ApproxHessian==HESSIAN_NONSECOND||hessianComputation==vpTemplateTrackerMI::USE_HESSIEN_DESIRE)
-          vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
+          addSample(point, IW, tptemp, 1);
         else if(ApproxHessian==HESSIAN_0 || ApproxHessian==HESSIAN_NEW)
-          vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-
-        delete[] tptemp;
+          addSample(point, IW, tptemp, 2);
       }
     }
+    // The joint histogram is accumulated in parallel once the points are warped
+    accumulateProba(false);
 
     if(Nbpoint==0)
     {
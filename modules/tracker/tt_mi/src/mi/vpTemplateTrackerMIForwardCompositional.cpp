@@ -61,15 +61,9 @@ void vpTemplateTrackerMIForwardCompositional::initCompo()
     double et=(Tij*(Nc-1))/255.-ct;
     ptTemplateSupp[point].et=et;
     ptTemplateSupp[point].ct=ct;
-    ptTemplateSupp[point].Bt=new double[4];
-    ptTemplateSupp[point].dBt=new double[4];
-    for(char it=-1;it<=2;it++)
-    {
-      ptTemplateSupp[point].Bt[it+1] =vpTemplateTrackerBSpline::Bspline4(-it+et);
-      ptTemplateSupp[point].dBt[it+1] =vpTemplateTrackerMIBSpline::dBspline4(-it+et);
-    }
-
   }
+  // B-spline coefficients of the template intensities used by accumulateProba()
+  initTemplateBspline();
   CompoInitialised=true;
 }
 void vpTemplateTrackerMIForwardCompositional::initHessienDesired(const vpImage<unsigned char> &I)
@@ -90,8 +84,6 @@ void vpTemplateTrackerMIForwardCompositional::initHessienDesired(const vpImage<u
 
   //double Tij;
   double IW,dx,dy;
-  int cr,ct;
-  double er,et;
 
   Nbpoint=0;
   //erreur=0;
@@ -124,25 +116,20 @@ void vpTemplateTrackerMIForwardCompositional::initHessienDesired(const vpImage<u
       dx=1.*dIx.getValue(i2,j2)*(Nc-1)/255.;
       dy=1.*dIy.getValue(i2,j2)*(Nc-1)/255.;
 
-      cr=ptTemplateSupp[point].ct;
-      er=ptTemplateSupp[point].et;
-      ct=(int)((IW*(Nc-1))/255.);
-      et=((double)IW*(Nc-1))/255.-ct;
-
       Warp->dWarpCompo(X1,X2,p,ptTemplate[point].dW,dW);
 
-      double *tptemp=new double[nbParam];
+      double *tptemp=&sampleDerivatives[point*nbParam];
       for(unsigned int it=0;it<nbParam;it++)
         tptemp[it] =dW[0][it]*dx+dW[1][it]*dy;
 
       //calcul de l'erreur
       //erreur+=(Tij-IW)*(Tij-IW);
 
-      vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc,tptemp, nbParam, bspline);
-
-      delete[] tptemp;
+      addSample(point, IW, tptemp, 2);
     }
   }
+  accumulateProba(false);
+
   double MI;
   computeProba(Nbpoint);
   computeMI(MI);
@@ -178,9 +165,6 @@ void vpTemplateTrackerMIForwardCompositional::trackNoPyr(const vpImage<unsigned
   double i2,j2;
   //double Tij;
   double IW;
-  //unsigned
-  int cr,ct;
-  double er,et;
   double dx,dy;
 
   vpColVector dpinv(nbParam);
@@ -220,14 +204,9 @@ void vpTemplateTrackerMIForwardCompositional::trackNoPyr(const vpImage<unsigned
         dx=1.*dIx.getValue(i2,j2)*(Nc-1)/255.;
         dy=1.*dIy.getValue(i2,j2)*(Nc-1)/255.;
 
-        ct=(int)((IW*(Nc-1))/255.);
-        et=((double)IW*(Nc-1))/255.-ct;
-        cr=ptTemplateSupp[point].ct;
-        er=ptTemplateSupp[point].et;
-
         Warp->dWarpCompo(X1,X2,p,ptTemplate[point].dW,dW);
 
-        double *tptemp=new double[nbParam];
+        double *tptemp=&sampleDerivatives[point*nbParam];
         for(unsigned int it=0;it<nbParam;it++)
           tptemp[it] =dW[0][it]*dx+dW[1][it]*dy;
 
@@ -236,14 +215,12 @@ void vpTemplateTrackerMIForwardCompositional::trackNoPyr(const vpImage<unsigned
         //erreur+=(Tij-IW)*(Tij-IW);
 
         if(ApproxHessian==HESSIAN_NONSECOND||hessianComputation==vpTemplateTrackerMI::USE_HESSIEN_DESIRE)
-          vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
+          addSample(point, IW, tptemp, 1);
         else if(ApproxHessian==HESSIAN_0|| ApproxHessian==HESSIAN_NEW)
-          vpTemplateTrackerMIBSpline::PutTotPVBspline(PrtTout, cr, er, ct, et, Nc, tptemp, nbParam, bspline);
-
-        delete[] tptemp;
-
+          addSample(point, IW, tptemp, 2);
       }
     }
+    accumulateProba(false);
     if(Nbpoint==0)
     {
       //std::cout<<"plus de point dans template suivi"<<std::endl;
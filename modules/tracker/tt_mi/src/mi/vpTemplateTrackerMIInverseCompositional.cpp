@@ -128,6 +128,9 @@ void vpTemplateTrackerMIInverseCompositional::initCompInverse(const vpImage<unsi
     //                initTemplateRefBspline(point, et);
     // ###################
   }
+  // B-spline coefficients of the template intensities and their derivatives
+  // used by accumulateProba()
+  initTemplateBspline();
   CompoInitialised=true;
 
 }
@@ -140,8 +143,6 @@ void vpTemplateTrackerMIInverseCompositional::initHessienDesired(const vpImage<u
 
   //double Tij;
   double IW;
-  int cr,ct;
-  double er,et;
 
   Nbpoint=0;
   //erreur=0;
@@ -180,46 +181,18 @@ void vpTemplateTrackerMIInverseCompositional::initHessienDesired(const vpImage<u
       else
         IW=I.getValue(i2,j2);
 
-      ct=ptTemplateSupp[point].ct;
-      et=ptTemplateSupp[point].et;
-      cr=(int)((IW*(Nc-1))/255.);
-      er=((double)IW*(Nc-1))/255.-cr;
-
       //calcul de l'erreur
       //erreur+=(Tij-IW)*(Tij-IW);
 
       if( ApproxHessian==HESSIAN_NONSECOND && (ptTemplateSelect[point] || !useTemplateSelect) )
-      {
-        vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(PrtTout, cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam, bspline);
-      }
+        addSample(point, IW, ptTemplate[point].dW, 1);
       else if ((ApproxHessian==HESSIAN_0||ApproxHessian==HESSIAN_NEW) && (ptTemplateSelect[point] || !useTemplateSelect))
-      {
-        if(bspline==3){
-          vpTemplateTrackerMIBSpline::PutTotPVBspline3(PrtTout, cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam);
-          //                    {
-          //                        if(et>0.5){ct++;}
-          //                        if(er>0.5){cr++;}
-          //                        int index = (cr*Nc+ct)*totParam;
-          //                        double *ptb = &PrtTout[index];
-          //                        vpTemplateTrackerMIBSpline::PutTotPVBspline3(ptb, er, ptTemplateSupp[point].BtInit, size);
-          //                    }
-        }
-        else{
-          vpTemplateTrackerMIBSpline::PutTotPVBspline4(PrtTout, cr, er, ct, et, Nc, ptTemplate[point].dW, nbParam);
-
-          //                    {
-          //                        // ################### AY : Optim
-          //                        unsigned int index = (cr*Nc+ct)*totParam;
-          //                        ptb = &PrtTout[index];
-          //                        vpTemplateTrackerMIBSpline::PutTotPVBspline4(ptb, er, ptTemplateSupp[point].BtInit, size);
-          //                        // ###################
-          //                    }
-        }
-      }
+        addSample(point, IW, ptTemplate[point].dW, 2);
       else if (ptTemplateSelect[point] || !useTemplateSelect)
-        vpTemplateTrackerMIBSpline::PutTotPVBsplinePrt(PrtTout, cr, er, ct, et, Nc,nbParam, bspline);
+        addSample(point, IW, NULL, 0);
     }
   }
+  accumulateProba(true);
 
   double MI;
   computeProba(Nbpoint);
@@ -275,59 +248,36 @@ void vpTemplateTrackerMIInverseCompositional::trackNoPyr(const vpImage<unsigned
 
     Warp->computeCoeff(p);
 
+    for(unsigned int point=0;point<templateSize;point++)
     {
-      for(int point=0;point<(int)templateSize;point++)
-      {
-        vpColVector x1(2),x2(2);
-        double i2,j2;
-
-        x1[0]=(double)ptTemplate[point].x;
-        x1[1]=(double)ptTemplate[point].y;
+      X1[0]=(double)ptTemplate[point].x;
+      X1[1]=(double)ptTemplate[point].y;
 
-        Warp->computeDenom(x1,p); // A modif pour parallelisation mais ne pose pas de pb avec warp utilises dans DECSA
-        Warp->warpX(x1,x2,p);
-
-        j2=x2[0];
-        i2=x2[1];
+      Warp->computeDenom(X1,p);
+      Warp->warpX(X1,X2,p);
 
-        if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
-        {
-          //if(m_ptCurrentMask == NULL ||(m_ptCurrentMask->getWidth() == I.getWidth() && m_ptCurrentMask->getHeight() == I.getHeight() && (*m_ptCurrentMask)[(unsigned int)i2][(unsigned int)j2] > 128))
-          {
-            Nbpoint++;
-            double IW;
-            if(!blur)
-              IW=(double)I.getValue(i2,j2);
-            else
-              IW=BI.getValue(i2,j2);
-
-            int ct=ptTemplateSupp[point].ct;
-            double et=ptTemplateSupp[point].et;
-            double tmp = IW*(((double)Nc)-1.f)/255.f;
-            int cr=(int)tmp;
-            double er=tmp-(double)cr;
-
-            if( (ApproxHessian==HESSIAN_NONSECOND||hessianComputation==vpTemplateTrackerMI::USE_HESSIEN_DESIRE) && (ptTemplateSelect[point] || !useTemplateSelect) )
-            {
-              vpTemplateTrackerMIBSpline::PutTotPVBsplineNoSecond(Prt, dPrt, cr, er, ct, et, Ncb, ptTemplate[point].dW, nbParam, bspline);
-            }
-            else if (ptTemplateSelect[point] || !useTemplateSelect)
-            {
-              if(bspline==3){
-                vpTemplateTrackerMIBSpline::PutTotPVBspline3(Prt, dPrt, d2Prt, cr, er, ct, et, Ncb, ptTemplate[point].dW, nbParam);
-              }
-              else{
-                vpTemplateTrackerMIBSpline::PutTotPVBspline4(Prt, dPrt, d2Prt, cr, er, ct, et, Ncb, ptTemplate[point].dW, nbParam);
-              }
-            }
-            else{
-              vpTemplateTrackerMIBSpline::PutTotPVBsplinePrt(Prt, cr, er, ct, et, Ncb,nbParam, bspline);
-            }
-          }
+      double j2=X2[0];
+      double i2=X2[1];
 
-        }
+      if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+      {
+        Nbpoint++;
+        double IW;
+        if(!blur)
+          IW=(double)I.getValue(i2,j2);
+        else
+          IW=BI.getValue(i2,j2);
+
+        if( (ApproxHessian==HESSIAN_NONSECOND||hessianComputation==vpTemplateTrackerMI::USE_HESSIEN_DESIRE) && (ptTemplateSelect[point] || !useTemplateSelect) )
+          addSample(point, IW, ptTemplate[point].dW, 1);
+        else if (ptTemplateSelect[point] || !useTemplateSelect)
+          addSample(point, IW, ptTemplate[point].dW, 2);
+        else
+          addSample(point, IW, NULL, 0);
       }
     }
+    // The joint histogram is accumulated in parallel once the points are warped
+    accumulateProba(true);
 
     if(Nbpoint==0)
     {
@@ -339,23 +289,7 @@ void vpTemplateTrackerMIInverseCompositional::trackNoPyr(const vpImage<unsigned
     }
     else
     {
-      //            computeProba(Nbpoint);
-
-      unsigned int indd, indd2;
-      indd = indd2 = 0;
-      unsigned int Ncb_ = (unsigned int)Ncb;
-      for(unsigned int i=0;i<Ncb_*Ncb_;i++){
-        Prt[i]=Prt[i]/Nbpoint;
-        for(unsigned int j=0;j<nbParam;j++){
-          dPrt[indd]=dPrt[indd]/Nbpoint;
-          indd++;
-          for(unsigned int k=0;k<nbParam;k++){
-            d2Prt[indd2]=d2Prt[indd2]/Nbpoint;
-            indd2++;
-          }
-        }
-      }
-
+      computeProba(Nbpoint);
       computeMI(MI);
 
       if(hessianComputation!=vpTemplateTrackerMI::USE_HESSIEN_DESIRE){
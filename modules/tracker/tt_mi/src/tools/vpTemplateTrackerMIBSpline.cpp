@@ -184,6 +184,39 @@ double vpTemplateTrackerMIBSpline::d2Bspline4(double diff)
 
 }
 
+/*
+  Compute the degree B-spline coefficients of a bin c with the fractional
+  part e, in the order used by PutTotPVBspline(). As in PutTotPVBspline3(),
+  a third order B-spline is shifted to the next bin when e > 0.5: c and e are
+  updated accordingly. dB and d2B, the first and second derivatives, are
+  only computed when not NULL.
+*/
+void vpTemplateTrackerMIBSpline::computeBsplineCoefficients(int &c, double &e, const int &degree, double *B,
+                                                            double *dB, double *d2B)
+{
+  if(degree==4)
+  {
+    for(int k=0;k<4;k++)
+    {
+      double diff=(double)(1-k)+e;
+      B[k]=vpTemplateTrackerBSpline::Bspline4(diff);
+      if(dB) dB[k]=dBspline4(diff);
+      if(d2B) d2B[k]=d2Bspline4(diff);
+    }
+  }
+  else
+  {
+    if(e>0.5){c++;e=e-1;}
+    for(int k=0;k<3;k++)
+    {
+      double diff=(double)(1-k)+e;
+      B[k]=Bspline3(diff);
+      if(dB) dB[k]=dBspline3(diff);
+      if(d2B) d2B[k]=d2Bspline3(diff);
+    }
+  }
+}
+
 void vpTemplateTrackerMIBSpline::PutTotPVBspline(double *Prt, int cr, double &er, int ct, double &et,int Nc, double *val, unsigned int &NbParam, int &degree)
 {
   switch(degree)
@@ -0,0 +1,186 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the mutual information template trackers on a synthetic warped image.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testTemplateTrackerMI.cpp
+
+  \brief Track a synthetic template in an image warped by a known
+  transformation with the forward additional, forward compositional, inverse
+  compositional and ESM mutual information trackers. Check that the warp is
+  recovered, and that the parameters are the same with 1 and 4 threads.
+*/
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpImagePoint.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/tt/vpTemplateTrackerWarpSRT.h>
+#include <visp3/tt/vpTemplateTrackerWarpTranslation.h>
+#include <visp3/tt_mi/vpTemplateTrackerMIESM.h>
+#include <visp3/tt_mi/vpTemplateTrackerMIForwardAdditional.h>
+#include <visp3/tt_mi/vpTemplateTrackerMIForwardCompositional.h>
+#include <visp3/tt_mi/vpTemplateTrackerMIInverseCompositional.h>
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+  // Texture of the scene at the point (x, y)
+  double texture(const double x, const double y)
+  {
+    return 128 + 60 * sin(x / 7.) * cos(y / 9.) + 40 * sin((x + y) / 13.) + 20 * cos(x * y / 900.);
+  }
+
+  // Similarity x' = s R x + t applied to the template to get the image
+  struct Similarity {
+    double s, theta, tx, ty;
+    void apply(const double x, const double y, double &x2, double &y2) const {
+      x2 = s * (cos(theta) * x - sin(theta) * y) + tx;
+      y2 = s * (sin(theta) * x + cos(theta) * y) + ty;
+    }
+    void applyInverse(const double x2, const double y2, double &x, double &y) const {
+      const double u = (x2 - tx) / s, v = (y2 - ty) / s;
+      x = cos(theta) * u + sin(theta) * v;
+      y = -sin(theta) * u + cos(theta) * v;
+    }
+  };
+
+  void createImage(vpImage<unsigned char> &I, const Similarity &W)
+  {
+    I.resize(240, 320);
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        double x, y;
+        W.applyInverse(j, i, x, y);
+        I[i][j] = (unsigned char)vpMath::maximum(0., vpMath::minimum(255., texture(x, y)));
+      }
+    }
+  }
+
+  // Track the template of I0 in I1 and return the parameters of the warp
+  template<class Tracker>
+  vpColVector track(vpTemplateTrackerWarp &warp, const vpImage<unsigned char> &I0, const vpImage<unsigned char> &I1,
+                    const unsigned int nbThreads, double &time)
+  {
+    Tracker tracker(&warp);
+    tracker.setSampling(1, 1);
+    tracker.setLambda(0.001);
+    tracker.setIterationMax(50);
+    tracker.setPyramidal(2, 1);
+    tracker.setNbThreads(nbThreads);
+
+    std::vector<vpImagePoint> v;
+    v.push_back(vpImagePoint(80, 100)); v.push_back(vpImagePoint(80, 220)); v.push_back(vpImagePoint(170, 220));
+    v.push_back(vpImagePoint(80, 100)); v.push_back(vpImagePoint(170, 220)); v.push_back(vpImagePoint(170, 100));
+    tracker.initFromPoints(I0, v);
+
+    time = vpTime::measureTimeMs();
+    for (unsigned int k = 0; k < 5; k++)
+      tracker.track(I1);
+    time = vpTime::measureTimeMs() - time;
+    return tracker.getp();
+  }
+
+  // Check that the warp moves the corners of the template where the similarity does
+  template<class Tracker>
+  bool check(const std::string &name, vpTemplateTrackerWarp &warp, const Similarity &W, const double threshold)
+  {
+    const Similarity identity = { 1.0, 0.0, 0.0, 0.0 };
+    vpImage<unsigned char> I0, I1;
+    createImage(I0, identity);
+    createImage(I1, W);
+
+    double time, time_threads;
+    vpColVector p = track<Tracker>(warp, I0, I1, 1, time);
+    vpColVector p_threads = track<Tracker>(warp, I0, I1, 4, time_threads);
+    for (unsigned int k = 0; k < p.size(); k++) {
+      if (p[k] != p_threads[k]) {
+        std::cerr << name << ": the parameters differ with 4 threads: " << p.t() << " and " << p_threads.t()
+                  << std::endl;
+        return false;
+      }
+    }
+
+    const double corners[4][2] = { { 100, 80 }, { 220, 80 }, { 220, 170 }, { 100, 170 } };
+    double error = 0;
+    for (unsigned int c = 0; c < 4; c++) {
+      double x2, y2, i2, j2;
+      W.apply(corners[c][0], corners[c][1], x2, y2);
+      warp.warpX((int)corners[c][1], (int)corners[c][0], i2, j2, p);
+      error = vpMath::maximum(error, sqrt(vpMath::sqr(x2 - j2) + vpMath::sqr(y2 - i2)));
+    }
+    std::cout << name << ": error of " << error << " pixel, " << time / 5 << " ms per image with 1 thread, "
+              << time_threads / 5 << " ms with 4 threads" << std::endl;
+    if (error > threshold) {
+      std::cerr << name << ": the warp is not recovered, parameters " << p.t() << std::endl;
+      return false;
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    // Translation of the image, and similarity around the center of the template
+    const Similarity translation = { 1.0, 0.0, 1.5, -1.0 };
+    Similarity similarity = { 1.01, vpMath::rad(1.), 0.0, 0.0 };
+    double cx, cy;
+    similarity.apply(160, 125, cx, cy);
+    similarity.tx = 160 - cx + 1.5;
+    similarity.ty = 125 - cy - 1.0;
+
+    vpTemplateTrackerWarpTranslation wt[4];
+    vpTemplateTrackerWarpSRT wsrt[3];
+    if (! check<vpTemplateTrackerMIForwardAdditional>("forward additional, translation", wt[0], translation, 0.3)
+        || ! check<vpTemplateTrackerMIForwardCompositional>("forward compositional, translation", wt[1], translation, 0.3)
+        || ! check<vpTemplateTrackerMIInverseCompositional>("inverse compositional, translation", wt[2], translation, 0.3)
+        || ! check<vpTemplateTrackerMIESM>("ESM, translation", wt[3], translation, 0.3)
+        || ! check<vpTemplateTrackerMIForwardAdditional>("forward additional, SRT", wsrt[0], similarity, 0.5)
+        || ! check<vpTemplateTrackerMIForwardCompositional>("forward compositional, SRT", wsrt[1], similarity, 0.5)
+        || ! check<vpTemplateTrackerMIInverseCompositional>("inverse compositional, SRT", wsrt[2], similarity, 0.5)) {
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "testTemplateTrackerMI is ok." << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -212,6 +212,13 @@ int main()
 }
   \endcode
 
+  The learning data can be saved in a learning database with saveLearningDatabase() and loaded back with
+  loadLearningDatabase(). Unlike the files of saveLearningData(), the database stores the keypoints, the 3D points
+  and the descriptors in contiguous blocks in the byte order of the machine: the file is mapped in memory and the
+  train descriptors point directly on it, without copy. With a FlannBased matcher, the FLANN index built from the
+  descriptors is saved in a second file and loaded instead of being trained again, so that a large database is
+  ready to match right after it is loaded.
+
   This class is also described in \ref tutorial-matching.
 */
 class VISP_EXPORT vpKeyPoint : public vpBasicKeyPoint {
@@ -641,6 +648,7 @@ public:
 #endif
 
   void loadLearningData(const std::string &filename, const bool binaryMode=false, const bool append=false);
+  void loadLearningDatabase(const std::string &filename);
 
   void match(const cv::Mat &trainDescriptors, const cv::Mat &queryDescriptors,
              std::vector<cv::DMatch> &matches, double &elapsedTime);
@@ -668,6 +676,7 @@ public:
   void reset();
 
   void saveLearningData(const std::string &filename, const bool binaryMode=false, const bool saveTrainingImages=true);
+  void saveLearningDatabase(const std::string &filename, const bool saveTrainingImages=true);
 
   /*!
     Set if the covariance matrix has to be computed in the Virtual Visual Servoing approach.
@@ -1017,6 +1026,31 @@ public:
   }
 
 private:
+  /*
+   * Learning database file mapped in memory, or read in a buffer when the file cannot be mapped.
+   * It is shared by the vpKeyPoint copies, as the train descriptors point on it.
+   */
+  class vpMappedDatabase {
+  public:
+    vpMappedDatabase();
+    ~vpMappedDatabase();
+
+    void map(const std::string &filename);
+
+    //! Mapped file, or buffer when the file is not mapped
+    unsigned char *m_data;
+    size_t m_size;
+    bool m_mapped;
+    std::vector<unsigned char> m_buffer;
+#if defined(_WIN32)
+    void *m_mapping;
+#endif
+
+  private:
+    vpMappedDatabase(const vpMappedDatabase &);
+    vpMappedDatabase &operator=(const vpMappedDatabase &);
+  };
+
   //! If true, compute covariance matrix if the user select the pose estimation method using ViSP
   bool m_computeCovariance;
   //! Covariance matrix
@@ -1059,6 +1093,8 @@ private:
   std::map<int, int> m_mapOfImageId;
   //! Map of images to have access to the image buffer according to his image id.
   std::map<int, vpImage<unsigned char> > m_mapOfImages;
+  //! Learning database loaded by loadLearningDatabase(), on which the train descriptors point.
+  cv::Ptr<vpMappedDatabase> m_mappedDatabase;
   //! Smart reference-counting pointer (similar to shared_ptr in Boost) of descriptor matcher (e.g. BruteForce or FlannBased).
   cv::Ptr<cv::DescriptorMatcher> m_matcher;
   //! Name of the matcher.
@@ -1144,6 +1180,8 @@ private:
 
   void initFeatureNames();
 
+  void saveTrainImages(const std::string &parent, std::map<int, std::string> &mapOfImgPath);
+
   inline size_t myKeypointHash(const cv::KeyPoint &kp) {
     size_t _Val = 2166136261U, scale = 16777619U;
     Cv32suf u;
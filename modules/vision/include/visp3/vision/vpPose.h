@@ -55,7 +55,7 @@
 #ifdef VISP_BUILD_DEPRECATED_FUNCTIONS
 #  include <visp3/core/vpList.h>
 #endif
-#include <visp3/core/vpThread.h>
+#include <visp3/core/vpThreadPool.h>
 
 #include <math.h>
 #include <list>
@@ -195,7 +195,7 @@ private:
   };
 
 #if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
-  static vpThread::Return poseRansacImplThread(vpThread::Args arg);
+  static void poseRansacImplRange(unsigned int begin, unsigned int end, void *args);
 #endif
 
 
@@ -300,7 +300,8 @@ public:
     Set the number of threads for the parallel RANSAC implementation.
 
     \note You have to enable the parallel version with setUseParallelRansac().
-    If the number of threads is 0, the number of threads to use is automatically determined with OpenMP.
+    If the number of threads is 0, the number of threads is given by vpThreadPool::getNbThreads(), or by
+    OpenMP when ViSP is built without thread support.
     \sa setUseParallelRansac
   */
   inline void setNbParallelRansacThreads(const int nb) {
@@ -35,6 +35,7 @@
  *
  *****************************************************************************/
 
+#include <cstring>
 #include <limits>
 #include <iomanip>
 #include <stdint.h> //uint32_t ; works also with >= VS2010 / _MSC_VER >= 1600
@@ -86,6 +87,16 @@
 # error Cannot detect host machine endianness.
 #endif
 
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__)))
+#  define VISP_HAVE_MMAP_UNIX 1
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#elif defined(_WIN32) && !defined(WINRT)
+#  define VISP_HAVE_MMAP_WIN32 1
+#  include <windows.h>
+#endif
 
 namespace {
   //Specific Type transformation functions
@@ -289,6 +300,94 @@ namespace {
     file.write((char *)(&double_value), sizeof(double_value));
   #endif
   }
+
+  //Learning database written by saveLearningDatabase(): a header followed by the training images, the keypoints,
+  //the 3D points and the descriptors blocks, each block being aligned so that the descriptors can be used in place
+  const char learningDatabaseMagic[8] = { 'V', 'I', 'S', 'P', 'K', 'P', 'D', 'B' };
+  const uint32_t learningDatabaseVersion = 1;
+  //Written in the byte order of the machine to detect a database saved on a machine with another byte order
+  const uint32_t learningDatabaseByteOrder = 0x01020304;
+  const uint64_t learningDatabaseAlignment = 64;
+
+  struct vpLearningDatabaseHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    int32_t nbImages;
+    int32_t have3DInfo;
+    int32_t nbDescriptors;
+    int32_t descriptorSize;
+    int32_t descriptorType;
+    int32_t hasIndex;
+    uint64_t imagesOffset;
+    uint64_t keyPointsOffset;
+    uint64_t pointsOffset;
+    uint64_t descriptorsOffset;
+    uint64_t fileSize;
+    //Size of the FLANN index file, to detect an index file that does not belong to the database
+    uint64_t indexSize;
+  };
+
+  struct vpLearningDatabaseKeyPoint {
+    float u, v, size, angle, response;
+    int32_t octave, class_id, image_id;
+  };
+
+  uint64_t alignDatabaseOffset(const uint64_t offset) {
+    return (offset + learningDatabaseAlignment - 1) / learningDatabaseAlignment * learningDatabaseAlignment;
+  }
+
+  void writeDatabasePadding(std::ofstream &file, const uint64_t from, const uint64_t to) {
+    const char zeros[64] = { 0 };
+    file.write(zeros, (std::streamsize) (to - from));
+  }
+
+  //The FLANN index of a learning database is saved next to it
+  std::string getDatabaseIndexFilename(const std::string &filename) {
+    return filename + ".flann";
+  }
+
+  uint64_t getFileSize(const std::string &filename) {
+    std::ifstream file(filename.c_str(), std::ifstream::binary | std::ifstream::ate);
+    return file.is_open() ? (uint64_t) file.tellg() : 0;
+  }
+
+  //FLANN matcher whose index can be saved and loaded instead of being trained again
+  class vpFlannBasedMatcher : public cv::FlannBasedMatcher {
+  public:
+    vpFlannBasedMatcher(const cv::Ptr<cv::flann::IndexParams> &indexParams)
+      : cv::FlannBasedMatcher(indexParams) {
+    }
+
+    //Train the index on the descriptors added to the matcher if needed, and save it
+    void saveIndex(const std::string &filename) {
+      train();
+      flannIndex->save(filename);
+    }
+
+    //Use the descriptors as train descriptors and load their index saved by saveIndex()
+    bool loadIndex(const cv::Mat &descriptors, const std::string &filename) {
+      clear();
+      add(std::vector<cv::Mat>(1, descriptors));
+      mergedDescriptors.set(trainDescCollection);
+
+      try {
+#if (VISP_HAVE_OPENCV_VERSION >= 0x030000)
+        cv::Ptr<cv::flann::Index> index = cv::makePtr<cv::flann::Index>();
+#else
+        cv::Ptr<cv::flann::Index> index = new cv::flann::Index();
+#endif
+        if(index->load(mergedDescriptors.getDescriptors(), filename)) {
+          flannIndex = index;
+          return true;
+        }
+      } catch(const std::exception &) {
+        //Index of another set of descriptors, trained again
+      }
+
+      return false;
+    }
+  };
 }
 
 /*!
@@ -304,7 +403,7 @@ vpKeyPoint::vpKeyPoint(const vpFeatureDetectorType &detectorType, const vpFeatur
   : m_computeCovariance(false), m_covarianceMatrix(), m_currentImageId(0), m_detectionMethod(detectionScore),
     m_detectionScore(0.15), m_detectionThreshold(100.0), m_detectionTime(0.), m_detectorNames(),
     m_detectors(), m_extractionTime(0.), m_extractorNames(), m_extractors(), m_filteredMatches(), m_filterType(filterType),
-    m_imageFormat(jpgImageFormat), m_knnMatches(), m_mapOfImageId(), m_mapOfImages(),
+    m_imageFormat(jpgImageFormat), m_knnMatches(), m_mapOfImageId(), m_mapOfImages(), m_mappedDatabase(),
     m_matcher(), m_matcherName(matcherName),
     m_matches(), m_matchingFactorThreshold(2.0), m_matchingRatioThreshold(0.85), m_matchingTime(0.),
     m_matchRansacKeyPointsToPoints(), m_nbRansacIterations(200), m_nbRansacMinInlierCount(100), m_objectFilteredPoints(),
@@ -339,7 +438,7 @@ vpKeyPoint::vpKeyPoint(const std::string &detectorName, const std::string &extra
   : m_computeCovariance(false), m_covarianceMatrix(), m_currentImageId(0), m_detectionMethod(detectionScore),
     m_detectionScore(0.15), m_detectionThreshold(100.0), m_detectionTime(0.), m_detectorNames(),
     m_detectors(), m_extractionTime(0.), m_extractorNames(), m_extractors(), m_filteredMatches(), m_filterType(filterType),
-    m_imageFormat(jpgImageFormat), m_knnMatches(), m_mapOfImageId(), m_mapOfImages(),
+    m_imageFormat(jpgImageFormat), m_knnMatches(), m_mapOfImageId(), m_mapOfImages(), m_mappedDatabase(),
     m_matcher(), m_matcherName(matcherName),
     m_matches(), m_matchingFactorThreshold(2.0), m_matchingRatioThreshold(0.85), m_matchingTime(0.),
     m_matchRansacKeyPointsToPoints(), m_nbRansacIterations(200), m_nbRansacMinInlierCount(100), m_objectFilteredPoints(),
@@ -374,7 +473,7 @@ vpKeyPoint::vpKeyPoint(const std::vector<std::string> &detectorNames, const std:
   : m_computeCovariance(false), m_covarianceMatrix(), m_currentImageId(0), m_detectionMethod(detectionScore),
     m_detectionScore(0.15), m_detectionThreshold(100.0), m_detectionTime(0.), m_detectorNames(detectorNames),
     m_detectors(), m_extractionTime(0.), m_extractorNames(extractorNames), m_extractors(), m_filteredMatches(),
-    m_filterType(filterType), m_imageFormat(jpgImageFormat), m_knnMatches(), m_mapOfImageId(), m_mapOfImages(),
+    m_filterType(filterType), m_imageFormat(jpgImageFormat), m_knnMatches(), m_mapOfImageId(), m_mapOfImages(), m_mappedDatabase(),
     m_matcher(),
     m_matcherName(matcherName), m_matches(), m_matchingFactorThreshold(2.0), m_matchingRatioThreshold(0.85), m_matchingTime(0.),
     m_matchRansacKeyPointsToPoints(), m_nbRansacIterations(200), m_nbRansacMinInlierCount(100), m_objectFilteredPoints(),
@@ -2308,15 +2407,15 @@ void vpKeyPoint::initMatcher(const std::string &matcherName) {
 
     if(descriptorType == CV_8U) {
 #if (VISP_HAVE_OPENCV_VERSION >= 0x030000)
-      m_matcher = cv::makePtr<cv::FlannBasedMatcher>(cv::makePtr<cv::flann::LshIndexParams>(12, 20, 2));
+      m_matcher = cv::makePtr<vpFlannBasedMatcher>(cv::makePtr<cv::flann::LshIndexParams>(12, 20, 2));
 #else
-      m_matcher = new cv::FlannBasedMatcher(new cv::flann::LshIndexParams(12, 20, 2));
+      m_matcher = new vpFlannBasedMatcher(new cv::flann::LshIndexParams(12, 20, 2));
 #endif
     } else {
 #if (VISP_HAVE_OPENCV_VERSION >= 0x030000)
-      m_matcher = cv::makePtr<cv::FlannBasedMatcher>(cv::makePtr<cv::flann::KDTreeIndexParams>());
+      m_matcher = cv::makePtr<vpFlannBasedMatcher>(cv::makePtr<cv::flann::KDTreeIndexParams>());
 #else
-      m_matcher = new cv::FlannBasedMatcher(new cv::flann::KDTreeIndexParams());
+      m_matcher = new vpFlannBasedMatcher(new cv::flann::KDTreeIndexParams());
 #endif
     }
   } else {
@@ -2936,6 +3035,149 @@ void vpKeyPoint::loadLearningData(const std::string &filename, const bool binary
    m_currentImageId = (int) m_mapOfImages.size();
 }
 
+/*!
+   Load a learning database saved with saveLearningDatabase(). The learning data are replaced by the data of the
+   database.
+
+   The database is mapped in memory and the train descriptors point directly on it, without copy. The matrix
+   returned by getTrainDescriptors() is valid until the next call to loadLearningDatabase() or reset(), or until
+   the vpKeyPoint object is destroyed. With a FlannBased matcher, the FLANN index saved with the database is loaded
+   instead of being trained again; OpenCV still rebuilds the hash tables of the LSH index used with binary
+   descriptors, which is fast. If the index file is missing or belongs to another database, the index is trained
+   at the first matching, as after loadLearningData().
+
+   \param filename : Path of the learning database.
+ */
+void vpKeyPoint::loadLearningDatabase(const std::string &filename) {
+  cv::Ptr<vpMappedDatabase> database(new vpMappedDatabase());
+  database->map(filename);
+
+  vpLearningDatabaseHeader header;
+  if(database->m_size < sizeof(header)) {
+    throw vpException(vpException::ioError, "\"%s\" is not a learning database", filename.c_str());
+  }
+  memcpy(&header, database->m_data, sizeof(header));
+  if(memcmp(header.magic, learningDatabaseMagic, sizeof(header.magic)) != 0) {
+    throw vpException(vpException::ioError, "\"%s\" is not a learning database", filename.c_str());
+  }
+  if(header.version != learningDatabaseVersion) {
+    throw vpException(vpException::ioError, "Unsupported version %u of the learning database \"%s\"",
+                      header.version, filename.c_str());
+  }
+  if(header.byteOrder != learningDatabaseByteOrder) {
+    throw vpException(vpException::ioError, "The learning database \"%s\" was saved on a machine with another "
+                      "byte order, use saveLearningData() in binary mode instead", filename.c_str());
+  }
+
+  uint64_t nbDescriptors = header.nbDescriptors > 0 ? (uint64_t) header.nbDescriptors : 0;
+  uint64_t descriptorSize = header.descriptorSize > 0 ? (uint64_t) header.descriptorSize : 0;
+  if(header.nbImages < 0 || header.nbDescriptors < 0 || header.descriptorSize < 0 || header.fileSize != database->m_size
+     || header.imagesOffset > header.keyPointsOffset
+     || header.keyPointsOffset + nbDescriptors * sizeof(vpLearningDatabaseKeyPoint) > header.pointsOffset
+     || header.pointsOffset + (header.have3DInfo ? nbDescriptors * sizeof(cv::Point3f) : 0) > header.descriptorsOffset
+     || header.descriptorsOffset + nbDescriptors * descriptorSize * CV_ELEM_SIZE(header.descriptorType) > header.fileSize) {
+    throw vpException(vpException::ioError, "The learning database \"%s\" is corrupted", filename.c_str());
+  }
+
+  m_trainKeyPoints.clear();
+  m_trainPoints.clear();
+  m_mapOfImageId.clear();
+  m_mapOfImages.clear();
+
+  //Get parent directory
+  std::string parent = vpIoTools::getParent(filename);
+  if(!parent.empty()) {
+    parent += "/";
+  }
+
+  //Read info about training images
+  const unsigned char *data = database->m_data;
+  uint64_t offset = header.imagesOffset;
+  for(int i = 0; i < header.nbImages; i++) {
+    int32_t id = 0, length = 0;
+    if(offset + 2 * sizeof(int32_t) > header.keyPointsOffset) {
+      throw vpException(vpException::ioError, "The learning database \"%s\" is corrupted", filename.c_str());
+    }
+    memcpy(&id, data + offset, sizeof(id));
+    memcpy(&length, data + offset + sizeof(id), sizeof(length));
+    offset += 2 * sizeof(int32_t);
+    if(length < 0 || offset + (uint64_t) length > header.keyPointsOffset) {
+      throw vpException(vpException::ioError, "The learning database \"%s\" is corrupted", filename.c_str());
+    }
+    std::string path((const char *) data + offset, (size_t) length);
+    offset += (uint64_t) length;
+
+#ifdef VISP_HAVE_MODULE_IO
+    vpImage<unsigned char> I;
+    if(vpIoTools::isAbsolutePathname(path)) {
+      vpImageIo::read(I, path);
+    } else {
+      vpImageIo::read(I, parent + path);
+    }
+    m_mapOfImages[id] = I;
+#else
+    (void)id;
+#endif
+  }
+
+#if !defined(VISP_HAVE_MODULE_IO)
+  if(header.nbImages > 0) {
+    std::cout << "Warning: The learning file contains image data that will not be loaded as visp_io module "
+        "is not available !" << std::endl;
+  }
+#endif
+
+  const vpLearningDatabaseKeyPoint *keyPoints = (const vpLearningDatabaseKeyPoint *) (data + header.keyPointsOffset);
+  m_trainKeyPoints.reserve((size_t) nbDescriptors);
+  for(int i = 0; i < header.nbDescriptors; i++) {
+    const vpLearningDatabaseKeyPoint &kp = keyPoints[i];
+    m_trainKeyPoints.push_back(cv::KeyPoint(cv::Point2f(kp.u, kp.v), kp.size, kp.angle, kp.response, kp.octave,
+                                            kp.class_id));
+#ifdef VISP_HAVE_MODULE_IO
+    //No training images if image_id == -1
+    if(kp.image_id != -1) {
+      m_mapOfImageId[kp.class_id] = kp.image_id;
+    }
+#endif
+  }
+
+  if(header.have3DInfo) {
+    const cv::Point3f *points = (const cv::Point3f *) (data + header.pointsOffset);
+    m_trainPoints.assign(points, points + header.nbDescriptors);
+  }
+
+  //The descriptors point on the database
+  m_trainDescriptors = cv::Mat(header.nbDescriptors, header.descriptorSize, header.descriptorType,
+                               database->m_data + header.descriptorsOffset);
+
+  //Add train descriptors in matcher object, with their prebuilt index if any
+  bool indexLoaded = false;
+  vpFlannBasedMatcher *flannMatcher = m_matcher.empty() ? NULL : dynamic_cast<vpFlannBasedMatcher *>(&(*m_matcher));
+  if(flannMatcher != NULL && header.hasIndex) {
+    std::string indexFilename = getDatabaseIndexFilename(filename);
+    if(getFileSize(indexFilename) == header.indexSize) {
+      indexLoaded = flannMatcher->loadIndex(m_trainDescriptors, indexFilename);
+    }
+  }
+  if(!indexLoaded) {
+    m_matcher->clear();
+    m_matcher->add(std::vector<cv::Mat>(1, m_trainDescriptors));
+  }
+
+  //Release the previous database only now that nothing points on it
+  m_mappedDatabase = database;
+
+  //Convert OpenCV type to ViSP type for compatibility
+  vpConvert::convertFromOpenCV(m_trainKeyPoints, referenceImagePointsList);
+  vpConvert::convertFromOpenCV(this->m_trainPoints, m_trainVpPoints);
+
+  //Set _reference_computed to true as we load a learning file
+  _reference_computed = true;
+
+  //Set m_currentImageId
+  m_currentImageId = (int) m_mapOfImages.size();
+}
+
 /*!
    Match keypoints based on distance between their descriptors.
 
@@ -3648,6 +3890,7 @@ void vpKeyPoint::reset() {
   m_detectors.clear(); m_extractionTime = 0.0; m_extractorNames.clear(); m_extractors.clear(); m_filteredMatches.clear();
   m_filterType = ratioDistanceThreshold;
   m_imageFormat = jpgImageFormat; m_knnMatches.clear(); m_mapOfImageId.clear(); m_mapOfImages.clear();
+  m_mappedDatabase = cv::Ptr<vpMappedDatabase>();
   m_matcher = cv::Ptr<cv::DescriptorMatcher>(); m_matcherName = "BruteForce-Hamming";
   m_matches.clear(); m_matchingFactorThreshold = 2.0; m_matchingRatioThreshold = 0.85; m_matchingTime = 0.0;
   m_matchRansacKeyPointsToPoints.clear(); m_nbRansacIterations = 200; m_nbRansacMinInlierCount = 100;
@@ -3669,6 +3912,60 @@ void vpKeyPoint::reset() {
   init();
 }
 
+/*!
+   Save the training images in the directory of the learning file.
+
+   \param parent : Directory of the learning file.
+   \param mapOfImgPath : Map of the image id to the name of the saved image file.
+ */
+void vpKeyPoint::saveTrainImages(const std::string &parent, std::map<int, std::string> &mapOfImgPath) {
+#ifdef VISP_HAVE_MODULE_IO
+  //Save the training image files in the same directory
+  int cpt = 0;
+
+  for(std::map<int, vpImage<unsigned char> >::const_iterator it = m_mapOfImages.begin(); it != m_mapOfImages.end(); ++it, cpt++) {
+    if(cpt > 999) {
+      throw vpException(vpException::fatalError, "The number of training images to save is too big !");
+    }
+
+    char buffer[4];
+    sprintf(buffer, "%03d", cpt);
+    std::stringstream ss;
+    ss << "train_image_" << buffer;
+
+    switch(m_imageFormat) {
+    case jpgImageFormat:
+      ss << ".jpg";
+      break;
+
+    case pngImageFormat:
+      ss << ".png";
+      break;
+
+    case ppmImageFormat:
+      ss << ".ppm";
+      break;
+
+    case pgmImageFormat:
+      ss << ".pgm";
+      break;
+
+    default:
+      ss << ".png";
+      break;
+    }
+
+    std::string imgFilename = ss.str();
+    mapOfImgPath[it->first] = imgFilename;
+    vpImageIo::write(it->second, parent + (!parent.empty() ? "/" : "") + imgFilename);
+  }
+#else
+  (void)parent;
+  (void)mapOfImgPath;
+  std::cout << "Warning: training images are not saved because visp_io module is not available !" << std::endl;
+#endif
+}
+
 /*!
    Save the learning data in a file in XML or binary mode.
 
@@ -3684,50 +3981,7 @@ void vpKeyPoint::saveLearningData(const std::string &filename, bool binaryMode,
 
   std::map<int, std::string> mapOfImgPath;
   if(saveTrainingImages) {
-#ifdef VISP_HAVE_MODULE_IO
-    //Save the training image files in the same directory
-    int cpt = 0;
-
-    for(std::map<int, vpImage<unsigned char> >::const_iterator it = m_mapOfImages.begin(); it != m_mapOfImages.end(); ++it, cpt++) {
-      if(cpt > 999) {
-        throw vpException(vpException::fatalError, "The number of training images to save is too big !");
-      }
-
-      char buffer[4];
-      sprintf(buffer, "%03d", cpt);
-      std::stringstream ss;
-      ss << "train_image_" << buffer;
-
-      switch(m_imageFormat) {
-      case jpgImageFormat:
-        ss << ".jpg";
-        break;
-
-      case pngImageFormat:
-        ss << ".png";
-        break;
-
-      case ppmImageFormat:
-        ss << ".ppm";
-        break;
-
-      case pgmImageFormat:
-        ss << ".pgm";
-        break;
-
-      default:
-        ss << ".png";
-        break;
-      }
-
-      std::string imgFilename = ss.str();
-      mapOfImgPath[it->first] = imgFilename;
-      vpImageIo::write(it->second, parent + (!parent.empty() ? "/" : "") + imgFilename);
-    }
-#else
-    std::cout << "Warning: in vpKeyPoint::saveLearningData() training images are not saved because "
-        "visp_io module is not available !" << std::endl;
-#endif
+    saveTrainImages(parent, mapOfImgPath);
   }
 
   bool have3DInfo = m_trainPoints.size() > 0;
@@ -4107,6 +4361,204 @@ void vpKeyPoint::saveLearningData(const std::string &filename, bool binaryMode,
   }
 }
 
+/*!
+   Save the learning data in a learning database that can be loaded with loadLearningDatabase().
+
+   The keypoints, the 3D points and the descriptors are stored in contiguous blocks, in the byte order of the
+   machine: the database can only be loaded on a machine with the same byte order. With a FlannBased matcher, the
+   FLANN index of the descriptors is trained if needed and saved in the file \e filename.flann.
+
+   \param filename : Path of the learning database.
+   \param saveTrainingImages : If true, save also the training images on disk.
+ */
+void vpKeyPoint::saveLearningDatabase(const std::string &filename, const bool saveTrainingImages) {
+  std::string parent = vpIoTools::getParent(filename);
+  if(!parent.empty()) {
+    vpIoTools::makeDirectory(parent);
+  }
+
+  std::map<int, std::string> mapOfImgPath;
+  if(saveTrainingImages) {
+    saveTrainImages(parent, mapOfImgPath);
+  }
+
+  bool have3DInfo = m_trainPoints.size() > 0;
+  if(have3DInfo && m_trainPoints.size() != m_trainKeyPoints.size()) {
+    throw vpException(vpException::fatalError, "List of keypoints and list of 3D points have different size !");
+  }
+  if(m_trainKeyPoints.size() != (size_t) m_trainDescriptors.rows) {
+    throw vpException(vpException::fatalError, "List of keypoints and matrix of descriptors have different size !");
+  }
+
+  std::vector<vpLearningDatabaseKeyPoint> keyPoints(m_trainKeyPoints.size());
+  for(size_t i = 0; i < m_trainKeyPoints.size(); i++) {
+    const cv::KeyPoint &kp = m_trainKeyPoints[i];
+    keyPoints[i].u = kp.pt.x;
+    keyPoints[i].v = kp.pt.y;
+    keyPoints[i].size = kp.size;
+    keyPoints[i].angle = kp.angle;
+    keyPoints[i].response = kp.response;
+    keyPoints[i].octave = kp.octave;
+    keyPoints[i].class_id = kp.class_id;
+
+    //No training images if image_id == -1
+    std::map<int, int>::const_iterator it_findImgId = m_mapOfImageId.find(kp.class_id);
+    keyPoints[i].image_id = (!mapOfImgPath.empty() && it_findImgId != m_mapOfImageId.end()) ? it_findImgId->second : -1;
+  }
+
+  vpLearningDatabaseHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, learningDatabaseMagic, sizeof(header.magic));
+  header.version = learningDatabaseVersion;
+  header.byteOrder = learningDatabaseByteOrder;
+  header.nbImages = (int32_t) mapOfImgPath.size();
+  header.have3DInfo = have3DInfo ? 1 : 0;
+  header.nbDescriptors = m_trainDescriptors.rows;
+  header.descriptorSize = m_trainDescriptors.cols;
+  header.descriptorType = m_trainDescriptors.type();
+
+  //Each training image is saved as its image_id, the length of its path and its path
+  uint64_t imagesSize = 0;
+  for(std::map<int, std::string>::const_iterator it = mapOfImgPath.begin(); it != mapOfImgPath.end(); ++it) {
+    imagesSize += 2 * sizeof(int32_t) + it->second.length();
+  }
+  uint64_t keyPointsSize = keyPoints.size() * sizeof(vpLearningDatabaseKeyPoint);
+  uint64_t pointsSize = m_trainPoints.size() * sizeof(cv::Point3f);
+  size_t rowSize = (size_t) m_trainDescriptors.cols * m_trainDescriptors.elemSize();
+  uint64_t descriptorsSize = (uint64_t) m_trainDescriptors.rows * rowSize;
+
+  header.imagesOffset = sizeof(header);
+  header.keyPointsOffset = alignDatabaseOffset(header.imagesOffset + imagesSize);
+  header.pointsOffset = alignDatabaseOffset(header.keyPointsOffset + keyPointsSize);
+  header.descriptorsOffset = alignDatabaseOffset(header.pointsOffset + pointsSize);
+  header.fileSize = header.descriptorsOffset + descriptorsSize;
+
+  vpFlannBasedMatcher *flannMatcher = m_matcher.empty() ? NULL : dynamic_cast<vpFlannBasedMatcher *>(&(*m_matcher));
+  if(flannMatcher != NULL && m_trainDescriptors.rows > 0) {
+    std::string indexFilename = getDatabaseIndexFilename(filename);
+    flannMatcher->clear();
+    flannMatcher->add(std::vector<cv::Mat>(1, m_trainDescriptors));
+    flannMatcher->saveIndex(indexFilename);
+    header.hasIndex = 1;
+    header.indexSize = getFileSize(indexFilename);
+  }
+
+  std::ofstream file(filename.c_str(), std::ofstream::binary);
+  if(!file.is_open()) {
+    throw vpException(vpException::ioError, "Cannot create the file.");
+  }
+
+  file.write((const char *) &header, sizeof(header));
+
+  for(std::map<int, std::string>::const_iterator it = mapOfImgPath.begin(); it != mapOfImgPath.end(); ++it) {
+    int32_t id = it->first;
+    int32_t length = (int32_t) it->second.length();
+    file.write((const char *) &id, sizeof(id));
+    file.write((const char *) &length, sizeof(length));
+    file.write(it->second.c_str(), length);
+  }
+  writeDatabasePadding(file, header.imagesOffset + imagesSize, header.keyPointsOffset);
+
+  if(!keyPoints.empty()) {
+    file.write((const char *) &keyPoints[0], (std::streamsize) keyPointsSize);
+  }
+  writeDatabasePadding(file, header.keyPointsOffset + keyPointsSize, header.pointsOffset);
+
+  if(have3DInfo) {
+    file.write((const char *) &m_trainPoints[0], (std::streamsize) pointsSize);
+  }
+  writeDatabasePadding(file, header.pointsOffset + pointsSize, header.descriptorsOffset);
+
+  if(m_trainDescriptors.isContinuous()) {
+    file.write((const char *) m_trainDescriptors.data, (std::streamsize) descriptorsSize);
+  } else {
+    for(int i = 0; i < m_trainDescriptors.rows; i++) {
+      file.write((const char *) m_trainDescriptors.ptr(i), (std::streamsize) rowSize);
+    }
+  }
+
+  if(!file.good()) {
+    throw vpException(vpException::ioError, "Cannot write the learning database \"%s\"", filename.c_str());
+  }
+  file.close();
+}
+
+vpKeyPoint::vpMappedDatabase::vpMappedDatabase()
+  : m_data(NULL), m_size(0), m_mapped(false), m_buffer()
+#if defined(_WIN32)
+    , m_mapping(NULL)
+#endif
+{
+}
+
+vpKeyPoint::vpMappedDatabase::~vpMappedDatabase() {
+  if(m_mapped) {
+#if defined(VISP_HAVE_MMAP_UNIX)
+    munmap(m_data, m_size);
+#elif defined(VISP_HAVE_MMAP_WIN32)
+    UnmapViewOfFile(m_data);
+    CloseHandle((HANDLE) m_mapping);
+#endif
+  }
+}
+
+//Map the database in memory, or read it in a buffer when the file cannot be mapped
+void vpKeyPoint::vpMappedDatabase::map(const std::string &filename) {
+#if defined(VISP_HAVE_MMAP_UNIX)
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if(fd < 0) {
+    throw vpException(vpException::ioError, "Cannot open file \"%s\"", filename.c_str());
+  }
+  struct stat st;
+  if(fstat(fd, &st) == 0 && st.st_size > 0) {
+    //Private mapping: the descriptors can be modified without modifying the file
+    void *addr = mmap(NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if(addr != MAP_FAILED) {
+      m_data = (unsigned char *) addr;
+      m_size = (size_t) st.st_size;
+      m_mapped = true;
+      posix_madvise(addr, m_size, POSIX_MADV_WILLNEED);
+    }
+  }
+  ::close(fd);
+#elif defined(VISP_HAVE_MMAP_WIN32)
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+  if(file == INVALID_HANDLE_VALUE) {
+    throw vpException(vpException::ioError, "Cannot open file \"%s\"", filename.c_str());
+  }
+  LARGE_INTEGER size;
+  if(GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if(mapping != NULL) {
+      void *addr = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+      if(addr != NULL) {
+        m_data = (unsigned char *) addr;
+        m_size = (size_t) size.QuadPart;
+        m_mapped = true;
+        m_mapping = mapping;
+      } else {
+        CloseHandle(mapping);
+      }
+    }
+  }
+  CloseHandle(file);
+#endif
+
+  if(!m_mapped) {
+    std::ifstream file(filename.c_str(), std::ifstream::binary | std::ifstream::ate);
+    if(!file.is_open()) {
+      throw vpException(vpException::ioError, "Cannot open file \"%s\"", filename.c_str());
+    }
+    std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    m_buffer.resize(size > 0 ? (size_t) size : 1);
+    file.read((char *) &m_buffer[0], size);
+    m_data = &m_buffer[0];
+    m_size = size > 0 ? (size_t) size : 0;
+  }
+}
+
 #if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x030000)
 //From OpenCV 2.4.11 source code.
 struct KeypointResponseGreaterThanThreshold {
@@ -384,10 +384,11 @@ bool vpPose::RansacFunctor::poseRansacImpl() {
 }
 
 #if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
-vpThread::Return vpPose::poseRansacImplThread(vpThread::Args arg) {
-  vpPose::RansacFunctor* f = reinterpret_cast<vpPose::RansacFunctor*>(arg);
-  (*f)();
-  return 0;
+void vpPose::poseRansacImplRange(unsigned int begin, unsigned int end, void *args) {
+  std::vector<vpPose::RansacFunctor> &f = *reinterpret_cast<std::vector<vpPose::RansacFunctor> *>(args);
+  for (unsigned int i = begin; i < end; i++) {
+    f[i]();
+  }
 }
 #endif
 
@@ -518,25 +519,12 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
 #elif !defined (VP_THREAD_OK)
     //Use OpenMP
 #define PARALLEL_RANSAC_OPEN_MP
-#elif !defined (VISP_HAVE_OPENMP)
-    if(nbParallelRansacThreads <= 0) {
-      //Cannot get the number of CPU threads so use the sequential mode
+#else
+    //Use the core thread pool, the number of CPU threads is its concurrency limit
+    nbThreads = (nbParallelRansacThreads > 0) ? nbParallelRansacThreads : (int) vpThreadPool::getNbThreads();
+    if (nbThreads <= 1) {
+      nbThreads = 1;
       executeParallelVersion = false;
-      std::cerr << "OpenMP is needed to get the number of CPU threads so use the sequential mode instead." << std::endl;
-    } else {
-      nbThreads = nbParallelRansacThreads;
-      if (nbThreads == 1) {
-        executeParallelVersion = false;
-      }
-    }
-#elif defined (VP_THREAD_OK) && defined (VISP_HAVE_OPENMP)
-    if (nbParallelRansacThreads <= 0) {
-      //Use OpenMP to get the number of CPU threads
-      nbThreads = omp_get_max_threads();
-      if(nbThreads <= 1) {
-        nbThreads = 1;
-        executeParallelVersion = false;
-      }
     }
 #endif
   }
@@ -743,7 +731,6 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
       nbInliers = best_consensus.size();
     }
 #elif defined(VP_THREAD_OK)
-    std::vector<vpThread *> threads((size_t) nbThreads);
     std::vector<RansacFunctor> ransac_func((size_t) nbThreads);
 
     int splitTrials = ransacMaxTrials / nbThreads;
@@ -757,21 +744,16 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
         ransac_func[i] = RansacFunctor(cMo, ransacNbInlierConsensus, maxTrialsRemainder, ransacThreshold,
                                        initial_seed, checkDegeneratePoints, listOfUniquePoints, func);
       }
-
-      threads[(size_t) i] = new vpThread((vpThread::Fn) poseRansacImplThread, (vpThread::Args) &ransac_func[ i]);
     }
 
+    vpThreadPool::parallel_for(0, (unsigned int) nbThreads, poseRansacImplRange, (void *) &ransac_func, (unsigned int) nbThreads);
+
     //Get the best pose between the threads
     vpPose final_pose;
     for(std::vector<vpPoint>::const_iterator it = listOfPoints.begin(); it != listOfPoints.end(); ++it) {
       final_pose.addPoint(*it);
     }
 
-    for(size_t i = 0; i < (size_t) nbThreads; i++) {
-      threads[i]->join();
-      delete threads[i];
-    }
-
     bool successRansac = false;
     size_t best_consensus_size = 0;
     for(size_t i = 0; i < (size_t) nbThreads; i++) {
@@ -481,6 +481,36 @@ int main(int argc, const char ** argv) {
       }
 #endif
 
+
+      //Save in a learning database with training images
+      filename = vpIoTools::createFilePath(opath, "db_with_img");
+      vpIoTools::makeDirectory(filename);
+      filename = vpIoTools::createFilePath(filename, "test_save_in_db_with_img.db");
+      keyPoints.saveLearningDatabase(filename, true);
+
+      //Test if save is ok
+      if(!vpIoTools::checkFilename(filename)) {
+        std::stringstream ss;
+        ss << "Problem when saving file=" << filename;
+        throw vpException(vpException::ioError, ss.str().c_str());
+      }
+
+      //Test if read is ok
+      vpKeyPoint read_keypoint5;
+      read_keypoint5.loadLearningDatabase(filename);
+      read_keypoint5.getTrainKeyPoints(trainKeyPoints_read);
+      trainDescriptors_read = read_keypoint5.getTrainDescriptors();
+
+      if(!compareKeyPoints(trainKeyPoints, trainKeyPoints_read)) {
+        throw vpException(vpException::fatalError, "Problem with trainKeyPoints when reading learning database "
+            "saved with train images !");
+      }
+
+      if(!compareDescriptors(trainDescriptors, trainDescriptors_read)) {
+        throw vpException(vpException::fatalError, "Problem with trainDescriptors when reading learning database "
+            "saved with train images !");
+      }
+
       std::cout << "Saving / loading learning files with binary descriptor are ok !" << std::endl;
     }
 
@@ -626,6 +656,47 @@ int main(int argc, const char ** argv) {
       }
 #endif
 
+
+
+      //Save in a learning database with the FLANN index
+      vpKeyPoint flann_keypoint(keypointName, keypointName, "FlannBased");
+      flann_keypoint.buildReference(I);
+      filename = vpIoTools::createFilePath(opath, "db_with_index");
+      vpIoTools::makeDirectory(filename);
+      filename = vpIoTools::createFilePath(filename, "test_save_in_db_with_index.db");
+      flann_keypoint.saveLearningDatabase(filename, false);
+
+      //Test if save is ok
+      if(!vpIoTools::checkFilename(filename) || !vpIoTools::checkFilename(filename + ".flann")) {
+        std::stringstream ss;
+        ss << "Problem when saving file=" << filename;
+        throw vpException(vpException::ioError, ss.str().c_str());
+      }
+
+      //Test if read is ok
+      vpKeyPoint read_keypoint5(keypointName, keypointName, "FlannBased");
+      read_keypoint5.loadLearningDatabase(filename);
+      std::vector<cv::KeyPoint> flannKeyPoints;
+      flann_keypoint.getTrainKeyPoints(flannKeyPoints);
+      cv::Mat flannDescriptors = flann_keypoint.getTrainDescriptors();
+      read_keypoint5.getTrainKeyPoints(trainKeyPoints_read);
+      trainDescriptors_read = read_keypoint5.getTrainDescriptors();
+
+      if(!compareKeyPoints(flannKeyPoints, trainKeyPoints_read)) {
+        throw vpException(vpException::fatalError, "Problem with trainKeyPoints when reading learning database "
+            "saved with FLANN index !");
+      }
+
+      if(!compareDescriptors(flannDescriptors, trainDescriptors_read)) {
+        throw vpException(vpException::fatalError, "Problem with trainDescriptors when reading learning database "
+            "saved with FLANN index !");
+      }
+
+      //The loaded index must give the same matches as the saved one
+      if(flann_keypoint.matchPoint(I) != read_keypoint5.matchPoint(I)) {
+        throw vpException(vpException::fatalError, "Problem with the FLANN index loaded with the learning database !");
+      }
+
       std::cout << "Saving / loading learning files with floating point descriptor are ok !" << std::endl;
 
 
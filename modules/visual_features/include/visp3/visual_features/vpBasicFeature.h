@@ -75,6 +75,15 @@
   \class vpBasicFeature
   \ingroup group_core_features
   \brief class that defines what is a visual feature
+
+  Besides interaction() and error() that return a new matrix or vector,
+  interaction(const unsigned int, vpMatrix &, const unsigned int) and
+  error(const vpBasicFeature &, const unsigned int, vpColVector &, const unsigned int)
+  write the rows of the feature in a matrix or vector allocated by the
+  caller, as vpServo does to stack the features of a task without
+  allocating memory. Their default implementation copies the result of
+  the allocating methods. A feature that overrides interaction() or error()
+  should also override them.
 */
 class VISP_EXPORT vpBasicFeature
 {
@@ -129,15 +138,19 @@ public:
 
   virtual vpColVector error(const vpBasicFeature &s_star,
                             const unsigned int select= FEATURE_ALL);
+  virtual void error(const vpBasicFeature &s_star, const unsigned int select,
+                     vpColVector &e, const unsigned int offset);
 
   // Get the feature vector.
   vpColVector get_s(unsigned int select=FEATURE_ALL) const;
+  void get_s(const unsigned int select, vpColVector &s_, const unsigned int offset) const;
   vpBasicFeatureDeallocatorType getDeallocate() { return deallocate ; }
 
   // Get the feature vector dimension.
   unsigned int getDimension(const unsigned int select=FEATURE_ALL) const;
   //! Compute the interaction matrix from a subset of the possible features.
   virtual vpMatrix interaction(const unsigned int select = FEATURE_ALL) = 0;
+  virtual void interaction(const unsigned int select, vpMatrix &L, const unsigned int rowOffset);
   //! Return element \e i in the state vector  (usage : x = s[i] )
   virtual inline double operator[](const unsigned int i) const {  return s[i]; }
   vpBasicFeature &operator=(const vpBasicFeature &f) ;
@@ -155,6 +168,8 @@ public:
 
 protected:
   void resetFlags();
+  static void checkInteractionSize(const vpMatrix &L, const unsigned int rowOffset, const unsigned int nbRows);
+  static void checkErrorSize(const vpColVector &e, const unsigned int offset, const unsigned int nbRows);
 
 protected:
   vpBasicFeatureDeallocatorType deallocate ;
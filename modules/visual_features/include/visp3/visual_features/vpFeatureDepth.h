@@ -191,6 +191,8 @@ public:
                unsigned int thickness=1) const ;
   vpFeatureDepth *duplicate() const ;
   vpColVector error(const vpBasicFeature &s_star, const unsigned int select = FEATURE_ALL)  ;
+  void error(const vpBasicFeature &s_star, const unsigned int select,
+             vpColVector &e, const unsigned int offset);
 
   double get_x()  const ;
 
@@ -202,6 +204,7 @@ public:
 
   void init() ;
   vpMatrix  interaction(const unsigned int select = FEATURE_ALL);
+  void      interaction(const unsigned int select, vpMatrix &L, const unsigned int rowOffset);
 
   void print(const unsigned int select = FEATURE_ALL ) const ;
   void set_x(const double x) ;
@@ -230,6 +230,8 @@ public:
 
   vpColVector error(const vpBasicFeature &s_star,
                     const unsigned int select = FEATURE_ALL)  ;
+  void error(const vpBasicFeature &s_star, const unsigned int select,
+             vpColVector &e, const unsigned int offset);
   //vpColVector error(const int select = FEATURE_ALL)  ;
 
 
@@ -245,6 +247,7 @@ public:
 
   void init() ;
   vpMatrix  interaction(const unsigned int select = FEATURE_ALL);
+  void      interaction(const unsigned int select, vpMatrix &L, const unsigned int rowOffset);
 
   void print(const unsigned int select= FEATURE_ALL) const ;
 
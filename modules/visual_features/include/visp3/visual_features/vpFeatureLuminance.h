@@ -42,6 +42,7 @@
 #include <visp3/visual_features/vpBasicFeature.h>
 #include <visp3/core/vpImage.h>
 
+#include <vector>
 
 /*!
   \file vpFeatureLuminance.h
@@ -50,31 +51,33 @@
   For more details see \cite Collewet08c.
 */
 
-#ifndef DOXYGEN_SHOULD_SKIP_THIS
-
-/*!
-  \class vpLuminance
-  \brief Class that defines the luminance and gradient of a point
-
-  \sa vpFeatureLuminance
-*/
-class VISP_EXPORT vpLuminance
-{
- public:
-  double x, y;   // point coordinates (in meter)
-  double I ; // pixel intensity
-  double Ix,Iy ; // pixel gradient
-  double Z; // pixel depth
-
-};
-#endif
-
 /*!
   \class vpFeatureLuminance
   \ingroup group_visual_features
   \brief Class that defines the image luminance visual feature
 
   For more details see \cite Collewet08c.
+
+  The interaction matrix of this feature has one row per pixel. When only
+  \f$ {\bf L}^T {\bf L} \f$ and \f$ {\bf L}^T {\bf e} \f$ are needed, as in
+  a Gauss-Newton or Levenberg-Marquardt control law, normalEquations()
+  accumulates them while scanning the pixels, without building the
+  interaction matrix:
+
+  \code
+  vpMatrix LtL, diagLtL(6, 6);
+  vpColVector e, Lte;
+  sI.buildFrom(I);
+  sI.error(sId, e);
+  sI.normalEquations(e, LtL, Lte);
+  for (unsigned int i = 0; i < 6; i++)
+    diagLtL[i][i] = LtL[i][i];
+  vpColVector v = -lambda * ((mu * diagLtL) + LtL).inverseByLU() * Lte;
+  \endcode
+
+  When \f$ {\bf L}^T {\bf L} \f$ is computed once, e.g. at the desired
+  position, normalEquations(const vpColVector &, vpColVector &) only
+  accumulates \f$ {\bf L}^T {\bf e} \f$.
 */
 
 class VISP_EXPORT vpFeatureLuminance : public vpBasicFeature
@@ -91,10 +94,15 @@ class VISP_EXPORT vpFeatureLuminance : public vpBasicFeature
   //! Border size.
   unsigned int bord ;
   
-  //! Store the image (as a vector with intensity and gradient I, Ix, Iy) 
-  vpLuminance *pixInfo ;
+  //! Coordinates in meter of the pixels, one array per coordinate
+  std::vector<double> xInfo, yInfo ;
+  //! Image gradient of the pixels, multiplied by px and py
+  std::vector<double> IxInfo, IyInfo ;
   int  firstTimeIn  ;
 
+  //! Number of threads used by buildFrom() and normalEquations(), 0 for vpThreadPool::getNbThreads()
+  unsigned int nbThreads ;
+
  public:
   vpFeatureLuminance() ;
   vpFeatureLuminance(const vpFeatureLuminance& f) ;
@@ -114,6 +122,8 @@ class VISP_EXPORT vpFeatureLuminance : public vpBasicFeature
 
   vpColVector error(const vpBasicFeature &s_star,
                     const unsigned int select = FEATURE_ALL)  ;
+  void error(const vpBasicFeature &s_star, const unsigned int select,
+             vpColVector &e, const unsigned int offset);
   void error(const vpBasicFeature &s_star,
              vpColVector &e)  ;
   //! Compute the error between a visual features and zero
@@ -121,18 +131,34 @@ class VISP_EXPORT vpFeatureLuminance : public vpBasicFeature
 
 
   double get_Z() const  ;
+  /*!
+    Return the number of threads used by buildFrom() and normalEquations(),
+    0 meaning vpThreadPool::getNbThreads().
+  */
+  unsigned int getNbThreads() const {return nbThreads;}
 
   void init() ;
   void init(unsigned int _nbr, unsigned int _nbc, double _Z) ;
   vpMatrix  interaction(const unsigned int select = FEATURE_ALL);
+  void      interaction(const unsigned int select, vpMatrix &L, const unsigned int rowOffset);
   void      interaction(vpMatrix &L);
 
+  void normalEquations(const vpColVector &e, vpMatrix &LtL, vpColVector &Lte);
+  void normalEquations(const vpColVector &e, vpColVector &Lte);
+
   vpFeatureLuminance &operator=(const vpFeatureLuminance& f) ;
 
   void print(const unsigned int select = FEATURE_ALL ) const ;
 
   void setCameraParameters(vpCameraParameters &_cam)  ;
   void set_Z(const double Z) ;
+  /*!
+    Set the number of threads used by buildFrom() and normalEquations(). 0,
+    the default, uses vpThreadPool::getNbThreads() threads. For a given
+    number of threads, normalEquations() gives the same results from one run
+    to another.
+  */
+  void setNbThreads(const unsigned int nb) {nbThreads = nb;}
 
 
  public:
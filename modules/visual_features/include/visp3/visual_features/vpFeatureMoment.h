@@ -189,6 +189,9 @@ public:
   //@{
   virtual void 	compute_interaction (void);
   vpBasicFeature* duplicate ()  const;
+  using vpBasicFeature::error;
+  void 	error (const vpBasicFeature &s_star, const unsigned int select,
+               vpColVector &e, const unsigned int offset) ;
   void 	display (const vpCameraParameters &cam, const vpImage< unsigned char > &I,
                  const vpColor &color=vpColor::green, unsigned int thickness=1) const ;
   void 	display (const vpCameraParameters &cam, const vpImage< vpRGBa > &I,
@@ -197,6 +200,7 @@ public:
   int 	getDimension (unsigned int select=FEATURE_ALL) const;
   void 	init (void);
   vpMatrix 	interaction (const unsigned int select=FEATURE_ALL) ;
+  void 	interaction (const unsigned int select, vpMatrix &L, const unsigned int rowOffset) ;
   void linkTo(vpFeatureMomentDatabase& featureMoments);
 
   /*!
@@ -167,6 +167,8 @@ class VISP_EXPORT vpFeatureMomentAlpha : public vpFeatureMoment{
     const char* name() const { return "vpFeatureMomentAlpha";}
 
     vpColVector error (const vpBasicFeature &s_star, const unsigned int select=FEATURE_ALL);
+    void error (const vpBasicFeature &s_star, const unsigned int select,
+                vpColVector &e, const unsigned int offset);
 };
 #endif
 #endif
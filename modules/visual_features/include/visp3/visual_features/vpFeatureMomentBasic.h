@@ -78,6 +78,9 @@ protected:
         vpMatrix interaction(const unsigned int /* select = FEATURE_ALL */){
           throw vpException(vpException::functionNotImplementedError,"Not implemented!");
         }
+        void interaction(const unsigned int /* select */, vpMatrix & /* L */, const unsigned int /* rowOffset */){
+          throw vpException(vpException::functionNotImplementedError,"Not implemented!");
+        }
 #endif
 
         vpMatrix interaction (unsigned int select_one,unsigned int select_two) const;
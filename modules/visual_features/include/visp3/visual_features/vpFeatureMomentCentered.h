@@ -86,6 +86,9 @@ protected:
         vpMatrix interaction(const unsigned int /* select = FEATURE_ALL */){
           throw vpException(vpException::functionNotImplementedError,"Not implemented!");
         }
+        void interaction(const unsigned int /* select */, vpMatrix & /* L */, const unsigned int /* rowOffset */){
+          throw vpException(vpException::functionNotImplementedError,"Not implemented!");
+        }
 #endif
         /*!
         Interaction matrix corresponding to \f$ \mu_{ij} \f$ moment
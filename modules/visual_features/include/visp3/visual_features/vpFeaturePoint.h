@@ -207,6 +207,8 @@ public:
 
   vpColVector error(const vpBasicFeature &s_star,
                     const unsigned int select = FEATURE_ALL)  ;
+  void error(const vpBasicFeature &s_star, const unsigned int select,
+             vpColVector &e, const unsigned int offset);
   //! Compute the error between a visual features and zero
   vpColVector error(const unsigned int select = FEATURE_ALL)  ;
 
@@ -218,6 +220,7 @@ public:
 
   void init() ;
   vpMatrix  interaction(const unsigned int select = FEATURE_ALL);
+  void      interaction(const unsigned int select, vpMatrix &L, const unsigned int rowOffset);
 
   void print(const unsigned int select = FEATURE_ALL ) const ;
 
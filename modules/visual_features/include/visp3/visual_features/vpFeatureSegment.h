@@ -94,6 +94,8 @@ public:
   // a the possible features
   vpColVector error(const vpBasicFeature &s_star,
                     const unsigned int select = FEATURE_ALL)  ;
+  void error(const vpBasicFeature &s_star, const unsigned int select,
+             vpColVector &e, const unsigned int offset);
 
   /*!
       Get the x coordinate of the segment center in the image plane.
@@ -145,6 +147,7 @@ public:
 
   // compute the interaction matrix from a subset a the possible features
   vpMatrix  interaction(const unsigned int select = FEATURE_ALL);
+  void      interaction(const unsigned int select, vpMatrix &L, const unsigned int rowOffset);
 
   void print(const unsigned int select= FEATURE_ALL) const ;
 
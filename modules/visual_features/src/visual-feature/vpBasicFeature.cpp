@@ -39,6 +39,7 @@
 
 
 #include <visp3/visual_features/vpBasicFeature.h>
+#include <visp3/visual_features/vpFeatureException.h>
 
 const unsigned int vpBasicFeature::FEATURE_LINE [32] =
     {
@@ -145,6 +146,128 @@ vpBasicFeature::get_s(const unsigned int select) const
   return state ;
 }
 
+/*!
+  Copy the feature vector \f$\bf s\f$, or a subset of it, in a vector
+  allocated by the caller.
+
+  \param select : Subset of the features, as for get_s(unsigned int) const.
+  \param s_ : Vector in which the features are copied from index \e offset.
+  It must have at least \e offset + getDimension(select) elements.
+  \param offset : Index of the first copied feature in \e s_.
+*/
+void
+vpBasicFeature::get_s(const unsigned int select, vpColVector &s_, const unsigned int offset) const
+{
+  checkErrorSize(s_, offset, getDimension(select));
+
+  unsigned int k = offset;
+  for(unsigned int i=0;i<s.getRows();++i)
+  {
+    if(dim_s > 31 || (FEATURE_LINE[i] & select))
+      s_[k++] = s[i];
+  }
+}
+
+/*!
+  Compute the interaction matrix from a subset of the possible features in
+  the rows of a matrix allocated by the caller.
+
+  This default implementation copies the matrix returned by
+  interaction(const unsigned int).
+
+  \param select : Subset of the features.
+  \param L : Matrix with 6 columns in which the interaction matrix is written
+  from row \e rowOffset. It must have enough rows, usually \e rowOffset +
+  getDimension(select).
+  \param rowOffset : First row of \e L written.
+
+  \exception vpFeatureException::sizeMismatchError : If \e L is too small,
+  or if interaction(const unsigned int) doesn't return getDimension(select)
+  rows, the caller relying on it to place the next features.
+*/
+void
+vpBasicFeature::interaction(const unsigned int select, vpMatrix &L, const unsigned int rowOffset)
+{
+  vpMatrix Ls = interaction(select);
+  if (Ls.getRows() != getDimension(select)) {
+    throw(vpFeatureException(vpFeatureException::sizeMismatchError,
+                             "The interaction matrix has %d rows instead of the %d selected features",
+                             Ls.getRows(), getDimension(select)));
+  }
+  checkInteractionSize(L, rowOffset, Ls.getRows());
+  if (Ls.getCols() != L.getCols()) {
+    throw(vpFeatureException(vpFeatureException::sizeMismatchError,
+                             "Cannot copy a %d columns interaction matrix in a %d columns matrix",
+                             Ls.getCols(), L.getCols()));
+  }
+
+  for (unsigned int i = 0; i < Ls.getRows(); i++)
+    for (unsigned int j = 0; j < Ls.getCols(); j++)
+      L[rowOffset + i][j] = Ls[i][j];
+}
+
+/*!
+  Compute the error between two visual features from a subset of the
+  possible features in a vector allocated by the caller.
+
+  This default implementation copies the vector returned by
+  error(const vpBasicFeature &, const unsigned int).
+
+  \param s_star : Desired visual feature.
+  \param select : Subset of the features.
+  \param e : Vector in which the error is written from index \e offset. It
+  must be large enough, usually \e offset + getDimension(select).
+  \param offset : Index of the first element of \e e written.
+
+  \exception vpFeatureException::sizeMismatchError : If \e e is too small,
+  or if error(const vpBasicFeature &, const unsigned int) doesn't return
+  getDimension(select) elements.
+*/
+void
+vpBasicFeature::error(const vpBasicFeature &s_star, const unsigned int select,
+                      vpColVector &e, const unsigned int offset)
+{
+  vpColVector es = error(s_star, select);
+  if (es.getRows() != getDimension(select)) {
+    throw(vpFeatureException(vpFeatureException::sizeMismatchError,
+                             "The error vector has %d elements instead of the %d selected features",
+                             es.getRows(), getDimension(select)));
+  }
+  checkErrorSize(e, offset, es.getRows());
+
+  for (unsigned int i = 0; i < es.getRows(); i++)
+    e[offset + i] = es[i];
+}
+
+/*!
+  Check that \e nbRows rows from row \e rowOffset fit in the 6 columns
+  interaction matrix \e L.
+
+  \exception vpFeatureException::sizeMismatchError : If it is not the case.
+*/
+void vpBasicFeature::checkInteractionSize(const vpMatrix &L, const unsigned int rowOffset, const unsigned int nbRows)
+{
+  if (rowOffset + nbRows > L.getRows() || L.getCols() != 6) {
+    throw(vpFeatureException(vpFeatureException::sizeMismatchError,
+                             "Cannot write %d rows from row %d in a %dx%d interaction matrix",
+                             nbRows, rowOffset, L.getRows(), L.getCols()));
+  }
+}
+
+/*!
+  Check that \e nbRows elements from index \e offset fit in the vector \e e.
+
+  \exception vpFeatureException::sizeMismatchError : If it is not the case.
+*/
+void vpBasicFeature::checkErrorSize(const vpColVector &e, const unsigned int offset, const unsigned int nbRows)
+{
+  if (offset + nbRows > e.getRows()) {
+    throw(vpFeatureException(vpFeatureException::sizeMismatchError,
+                             "Cannot write %d elements from index %d in a %d dimension vector",
+                             nbRows, offset, e.getRows()));
+  }
+}
+
 void vpBasicFeature::resetFlags()
 {
   if (flags != NULL)
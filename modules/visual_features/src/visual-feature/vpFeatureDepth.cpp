@@ -245,7 +245,21 @@ vpFeatureDepth::set_xyZLogZoverZstar(const double x_,
 vpMatrix
 vpFeatureDepth::interaction(const unsigned int select)
 {
-  vpMatrix L ;
+  vpMatrix L(getDimension(select), 6) ;
+  interaction(select, L, 0) ;
+  return L ;
+}
+
+/*!
+  Compute the interaction matrix of a subset of the features in the rows of
+  \e L from row \e rowOffset, see interaction(const unsigned int). \e L must
+  have at least \e rowOffset + getDimension(select) rows and 6 columns.
+*/
+void
+vpFeatureDepth::interaction(const unsigned int select, vpMatrix &L, const unsigned int rowOffset)
+{
+  checkInteractionSize(L, rowOffset, getDimension(select)) ;
+  unsigned int row = rowOffset ;
 
   if (deallocate == vpBasicFeature::user)
   {
@@ -271,8 +285,6 @@ vpFeatureDepth::interaction(const unsigned int select)
     resetFlags();
   }
 
-  L.resize(1,6) ;
-
   double x_ = get_x();
   double y_ = get_y();
   double Z_ = get_Z();
@@ -295,18 +307,16 @@ vpFeatureDepth::interaction(const unsigned int select)
 			     "Point Z coordinates is null")) ;
   }
 
-  if (FEATURE_ALL & select)
+  if (FEATURE_LINE[0] & select)
   {
-    L = 0;
-    L[0][0] = 0;
-    L[0][1] = 0;
-    L[0][2] = -1/Z_;
-    L[0][3] = -y_;
-    L[0][4] = x_;
-    L[0][5] = 0;
+    double *Lz = L[row++];
+    Lz[0] = 0;
+    Lz[1] = 0;
+    Lz[2] = -1/Z_;
+    Lz[3] = -y_;
+    Lz[4] = x_;
+    Lz[5] = 0;
   }
-
-  return L ;
 }
 
 
@@ -349,21 +359,34 @@ vpColVector
 vpFeatureDepth::error(const vpBasicFeature &s_star,
 		       const unsigned int select)
 {
+  vpColVector e(getDimension(select)) ;
+  error(s_star, select, e, 0) ;
+  return e ;
+}
+
+/*!
+  Compute the error \f$ (s-s^*)\f$ of a subset of the features in \e e from
+  index \e offset, see error(const vpBasicFeature &, const unsigned int).
+  \e e must have at least \e offset + getDimension(select) elements.
+*/
+void
+vpFeatureDepth::error(const vpBasicFeature &s_star, const unsigned int select,
+                      vpColVector &e, const unsigned int offset)
+{
+  checkErrorSize(e, offset, getDimension(select)) ;
+  unsigned int k = offset ;
 
-  if (fabs(s_star.get_s().sumSquare()) > 1e-6)
+  if (fabs(s_star[0]*s_star[0]) > 1e-6)
     {
       vpERROR_TRACE("s* should be zero ! ") ;
       throw(vpFeatureException(vpFeatureException::badInitializationError,
 			       "s* should be zero !")) ;
     }
 
-  vpColVector e(1) ;
-  if(FEATURE_ALL & select)
+  if(FEATURE_LINE[0] & select)
   {
-    e[0] = s[0];
+    e[k++] = s[0];
   }
-
-  return e ;
 }
 
 
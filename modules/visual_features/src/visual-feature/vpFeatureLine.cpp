@@ -202,9 +202,21 @@ vpFeatureLine::setABCD(const double A_, const double B_,
 vpMatrix
 vpFeatureLine::interaction(const unsigned int select)
 {
-  vpMatrix L ;
+  vpMatrix L(getDimension(select), 6) ;
+  interaction(select, L, 0) ;
+  return L ;
+}
 
-  L.resize(0,6) ;
+/*!
+  Compute the interaction matrix of a subset of the features in the rows of
+  \e L from row \e rowOffset, see interaction(const unsigned int). \e L must
+  have at least \e rowOffset + getDimension(select) rows and 6 columns.
+*/
+void
+vpFeatureLine::interaction(const unsigned int select, vpMatrix &L, const unsigned int rowOffset)
+{
+  checkInteractionSize(L, rowOffset, getDimension(select)) ;
+  unsigned int row = rowOffset ;
 
   if (deallocate == vpBasicFeature::user)
   {
@@ -241,7 +253,6 @@ vpFeatureLine::interaction(const unsigned int select)
   double rho = s[0] ;
   double theta = s[1] ;
 
-
   double co = cos(theta);
   double si = sin(theta);
 
@@ -258,33 +269,27 @@ vpFeatureLine::interaction(const unsigned int select)
 
   if (vpFeatureLine::selectRho() & select )
   {
-    vpMatrix Lrho(1,6) ;
-
-
-    Lrho[0][0]= co*lambda_rho;
-    Lrho[0][1]= si*lambda_rho;
-    Lrho[0][2]= -rho*lambda_rho;
-    Lrho[0][3]= si*(1.0 + rho*rho);
-    Lrho[0][4]= -co*(1.0 + rho*rho);
-    Lrho[0][5]= 0.0;
-
-    L = vpMatrix::stack(L,Lrho) ;
+    double *Lrho = L[row++] ;
+
+    Lrho[0]= co*lambda_rho;
+    Lrho[1]= si*lambda_rho;
+    Lrho[2]= -rho*lambda_rho;
+    Lrho[3]= si*(1.0 + rho*rho);
+    Lrho[4]= -co*(1.0 + rho*rho);
+    Lrho[5]= 0.0;
   }
 
   if (vpFeatureLine::selectTheta() & select )
   {
-    vpMatrix Ltheta(1,6) ;
-
-    Ltheta[0][0] = co*lambda_theta;
-    Ltheta[0][1] = si*lambda_theta;
-    Ltheta[0][2] = -rho*lambda_theta;
-    Ltheta[0][3] = -rho*co;
-    Ltheta[0][4] = -rho*si;
-    Ltheta[0][5] = -1.0;
-
-    L = vpMatrix::stack(L,Ltheta) ;
+    double *Ltheta = L[row++] ;
+
+    Ltheta[0] = co*lambda_theta;
+    Ltheta[1] = si*lambda_theta;
+    Ltheta[2] = -rho*lambda_theta;
+    Ltheta[3] = -rho*co;
+    Ltheta[4] = -rho*si;
+    Ltheta[5] = -1.0;
   }
-  return L ;
 }
 
 
@@ -330,15 +335,27 @@ vpColVector
 vpFeatureLine::error(const vpBasicFeature &s_star,
 		      const unsigned int select)
 {
-  vpColVector e(0) ;
+  vpColVector e(getDimension(select)) ;
+  error(s_star, select, e, 0) ;
+  return e ;
+}
+
+/*!
+  Compute the error \f$ (s-s^*)\f$ of a subset of the features in \e e from
+  index \e offset, see error(const vpBasicFeature &, const unsigned int).
+  \e e must have at least \e offset + getDimension(select) elements.
+*/
+void
+vpFeatureLine::error(const vpBasicFeature &s_star, const unsigned int select,
+                     vpColVector &e, const unsigned int offset)
+{
+  checkErrorSize(e, offset, getDimension(select)) ;
+  unsigned int k = offset ;
 
   try{
     if (vpFeatureLine::selectRho() & select )
     {
-      vpColVector erho(1) ;
-      erho[0] = s[0] - s_star[0] ;
-
-      e = vpColVector::stack(e,erho) ;
+      e[k++] = s[0] - s_star[0] ;
     }
 
     if (vpFeatureLine::selectTheta() & select )
@@ -348,16 +365,12 @@ vpFeatureLine::error(const vpBasicFeature &s_star,
       while (err < -M_PI) err += 2*M_PI ;
       while (err > M_PI) err -= 2*M_PI ;
 
-      vpColVector etheta(1) ;
-      etheta[0] = err ;
-      e = vpColVector::stack(e,etheta) ;
+      e[k++] = err ;
     }
   }
   catch(...) {
     throw ;
   }
-
-  return e ;
 }
 
 
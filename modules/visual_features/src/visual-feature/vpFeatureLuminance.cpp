@@ -43,9 +43,15 @@
 #include <visp3/core/vpImageConvert.h>
 #include <visp3/core/vpImageFilter.h>
 #include <visp3/core/vpException.h>
+#include <visp3/core/vpThreadPool.h>
 
 #include <visp3/visual_features/vpFeatureLuminance.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
 
 /*!
   \file vpFeatureLuminance.cpp
@@ -54,7 +60,165 @@
   For more details see \cite Collewet08c.
 */
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Number of sums accumulated by normalEquations(): the upper triangle of L^T L if needed, then L^T e
+  template <bool withLtL> struct vpNormalSums { static const unsigned int size = 27; };
+  template <> struct vpNormalSums<false> { static const unsigned int size = 6; };
+
+  // Luminance and gradient of a band of image rows, computed as with
+  // vpImageFilter::derivativeFilterX() and vpImageFilter::derivativeFilterY()
+  struct vpLuminanceGradient {
+    const vpImage<unsigned char> *I;
+    unsigned int bord;
+    unsigned int nbc;
+    double px, py;
+    double *s, *Ix, *Iy;
+
+    void operator()(unsigned int begin, unsigned int end) const {
+      const unsigned int width = nbc - 2*bord;
+      for (unsigned int i = begin; i < end; i++) {
+        const unsigned char *r = (*I)[i];
+        const unsigned char *r_1 = (*I)[i-1], *r_2 = (*I)[i-2], *r_3 = (*I)[i-3];
+        const unsigned char *r1 = (*I)[i+1], *r2 = (*I)[i+2], *r3 = (*I)[i+3];
+        unsigned int l = (i - bord) * width;
+        for (unsigned int j = bord; j < nbc - bord; j++, l++) {
+          Ix[l] = px * ((2047.0 *(r[j+1] - r[j-1]) + 913.0 *(r[j+2] - r[j-2]) + 112.0 *(r[j+3] - r[j-3]))/8418.0);
+          Iy[l] = py * ((2047.0 *(r1[j] - r_1[j]) + 913.0 *(r2[j] - r_2[j]) + 112.0 *(r3[j] - r_3[j]))/8418.0);
+          s[l] = r[j];
+        }
+      }
+    }
+  };
+
+  // Add to sums the upper triangle of L^T L, if withLtL, and L^T e over the features of [begin, end)
+  template <bool withLtL>
+  void accumulateNormalEquations(const double *x, const double *y, const double *Ix, const double *Iy,
+                                 const double *e, const double Zinv, unsigned int begin, const unsigned int end,
+                                 double *sums)
+  {
+#if VISP_HAVE_SSE2
+    const unsigned int nbNormalSums = vpNormalSums<withLtL>::size;
+    __m128d acc[nbNormalSums];
+    for (unsigned int k = 0; k < nbNormalSums; k++)
+      acc[k] = _mm_setzero_pd();
+
+    const __m128d v_Zinv = _mm_set1_pd(Zinv);
+    const __m128d v_one = _mm_set1_pd(1.0);
+    const __m128d v_zero = _mm_setzero_pd();
+    for (; begin + 2 <= end; begin += 2) {
+      const __m128d v_x = _mm_loadu_pd(x + begin), v_y = _mm_loadu_pd(y + begin);
+      const __m128d v_Ix = _mm_loadu_pd(Ix + begin), v_Iy = _mm_loadu_pd(Iy + begin);
+      const __m128d v_xy = _mm_mul_pd(v_x, v_y);
+
+      __m128d L[6];
+      L[0] = _mm_mul_pd(v_Ix, v_Zinv);
+      L[1] = _mm_mul_pd(v_Iy, v_Zinv);
+      L[2] = _mm_mul_pd(_mm_sub_pd(v_zero, _mm_add_pd(_mm_mul_pd(v_x, v_Ix), _mm_mul_pd(v_y, v_Iy))), v_Zinv);
+      L[3] = _mm_sub_pd(_mm_sub_pd(v_zero, _mm_mul_pd(v_Ix, v_xy)),
+                        _mm_mul_pd(_mm_add_pd(v_one, _mm_mul_pd(v_y, v_y)), v_Iy));
+      L[4] = _mm_add_pd(_mm_mul_pd(_mm_add_pd(v_one, _mm_mul_pd(v_x, v_x)), v_Ix), _mm_mul_pd(v_Iy, v_xy));
+      L[5] = _mm_sub_pd(_mm_mul_pd(v_Iy, v_x), _mm_mul_pd(v_Ix, v_y));
+
+      unsigned int k = 0;
+      if (withLtL)
+        for (unsigned int a = 0; a < 6; a++)
+          for (unsigned int b = a; b < 6; b++, k++)
+            acc[k] = _mm_add_pd(acc[k], _mm_mul_pd(L[a], L[b]));
+
+      const __m128d v_e = _mm_loadu_pd(e + begin);
+      for (unsigned int a = 0; a < 6; a++, k++)
+        acc[k] = _mm_add_pd(acc[k], _mm_mul_pd(L[a], v_e));
+    }
+
+    for (unsigned int k = 0; k < nbNormalSums; k++) {
+      double v[2];
+      _mm_storeu_pd(v, acc[k]);
+      sums[k] += v[0] + v[1];
+    }
+#endif
+
+    for (unsigned int m = begin; m < end; m++) {
+      double L[6];
+      L[0] = Ix[m] * Zinv;
+      L[1] = Iy[m] * Zinv;
+      L[2] = -(x[m]*Ix[m]+y[m]*Iy[m])*Zinv;
+      L[3] = -Ix[m]*x[m]*y[m]-(1+y[m]*y[m])*Iy[m];
+      L[4] = (1+x[m]*x[m])*Ix[m] + Iy[m]*x[m]*y[m];
+      L[5] = Iy[m]*x[m]-Ix[m]*y[m];
+
+      unsigned int k = 0;
+      if (withLtL)
+        for (unsigned int a = 0; a < 6; a++)
+          for (unsigned int b = a; b < 6; b++, k++)
+            sums[k] += L[a] * L[b];
+      for (unsigned int a = 0; a < 6; a++, k++)
+        sums[k] += L[a] * e[m];
+    }
+  }
+
+  // Sums of the normal equations over bands of image rows, one set of sums per band
+  template <bool withLtL>
+  struct vpNormalEquationsAccumulator {
+    const double *x, *y, *Ix, *Iy, *e;
+    double Zinv;
+    unsigned int nbRows;
+    unsigned int width;
+    unsigned int nbBands;
+    double *sums;
+
+    void operator()(unsigned int begin, unsigned int end) const {
+      for (unsigned int band = begin; band < end; band++) {
+        unsigned int first = (unsigned int)((unsigned long long)nbRows * band / nbBands);
+        unsigned int last = (unsigned int)((unsigned long long)nbRows * (band + 1) / nbBands);
+        double *band_sums = sums + band * vpNormalSums<withLtL>::size;
+        for (unsigned int k = 0; k < vpNormalSums<withLtL>::size; k++)
+          band_sums[k] = 0;
+        accumulateNormalEquations<withLtL>(x, y, Ix, Iy, e, Zinv, first * width, last * width, band_sums);
+      }
+    }
+  };
 
+  // Sums of the normal equations over all the features, the bands of rows being added in their order
+  template <bool withLtL>
+  void computeNormalSums(const std::vector<double> &x, const std::vector<double> &y, const std::vector<double> &Ix,
+                         const std::vector<double> &Iy, const vpColVector &e, const double Z,
+                         const unsigned int width, const unsigned int nbThreads, std::vector<double> &sums)
+  {
+    const unsigned int nbNormalSums = vpNormalSums<withLtL>::size;
+    const unsigned int dim_s = e.getRows();
+    const unsigned int nbRows = dim_s / width;
+
+    // A band of rows has at least 4096 pixels, so that summing the bands costs nothing
+    unsigned int nbBands = (nbThreads == 0) ? vpThreadPool::getNbThreads() : nbThreads;
+    unsigned int maxBands = dim_s / 4096;
+    if (nbBands > maxBands)
+      nbBands = maxBands;
+    if (nbBands == 0)
+      nbBands = 1;
+
+    sums.assign(nbBands * nbNormalSums, 0.);
+    if (dim_s > 0) {
+      vpNormalEquationsAccumulator<withLtL> accumulator;
+      accumulator.x = &x[0];
+      accumulator.y = &y[0];
+      accumulator.Ix = &Ix[0];
+      accumulator.Iy = &Iy[0];
+      accumulator.e = e.data;
+      accumulator.Zinv = 1 / Z;
+      accumulator.nbRows = nbRows;
+      accumulator.width = width;
+      accumulator.nbBands = nbBands;
+      accumulator.sums = &sums[0];
+      vpThreadPool::parallel_for(0, nbBands, accumulator, nbBands);
+    }
+
+    for (unsigned int band = 1; band < nbBands; band++)
+      for (unsigned int k = 0; k < nbNormalSums; k++)
+        sums[k] += sums[band * nbNormalSums + k];
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
 /*!
   Initialize the memory space requested for vpFeatureLuminance visual feature.
@@ -91,12 +255,12 @@ vpFeatureLuminance::init(unsigned int _nbr, unsigned int _nbc, double _Z)
   dim_s = (nbr-2*bord)*(nbc-2*bord) ;
 
   s.resize(dim_s) ;
-  
-  if (pixInfo != NULL)
-    delete [] pixInfo;
 
-  pixInfo = new vpLuminance[dim_s] ;
-  
+  xInfo.resize(dim_s) ;
+  yInfo.resize(dim_s) ;
+  IxInfo.resize(dim_s) ;
+  IyInfo.resize(dim_s) ;
+
   Z = _Z ;
 }
 
@@ -104,7 +268,7 @@ vpFeatureLuminance::init(unsigned int _nbr, unsigned int _nbc, double _Z)
   Default constructor that build a visual feature.
 */
 vpFeatureLuminance::vpFeatureLuminance()
-  : Z(1), nbr(0), nbc(0), bord(10), pixInfo(NULL), firstTimeIn(0), cam()
+  : Z(1), nbr(0), nbc(0), bord(10), xInfo(), yInfo(), IxInfo(), IyInfo(), firstTimeIn(0), nbThreads(0), cam()
 {
     nbParameters = 1;
     dim_s = 0 ;
@@ -117,7 +281,8 @@ vpFeatureLuminance::vpFeatureLuminance()
  Copy constructor.
  */
 vpFeatureLuminance::vpFeatureLuminance(const vpFeatureLuminance& f)
-  : vpBasicFeature(f), Z(1), nbr(0), nbc(0), bord(10), pixInfo(NULL), firstTimeIn(0), cam()
+  : vpBasicFeature(f), Z(1), nbr(0), nbc(0), bord(10), xInfo(), yInfo(), IxInfo(), IyInfo(), firstTimeIn(0),
+    nbThreads(0), cam()
 {
   *this = f;
 }
@@ -132,12 +297,12 @@ vpFeatureLuminance &vpFeatureLuminance::operator=(const vpFeatureLuminance& f)
   nbc = f.nbc;
   bord = f.bord;
   firstTimeIn = f.firstTimeIn;
+  nbThreads = f.nbThreads;
   cam = f.cam;
-  if (pixInfo)
-    delete [] pixInfo;
-  pixInfo = new vpLuminance[dim_s] ;
-  for(unsigned int i=0; i< dim_s; i++)
-    pixInfo[i] = f.pixInfo[i];
+  xInfo = f.xInfo;
+  yInfo = f.yInfo;
+  IxInfo = f.IxInfo;
+  IyInfo = f.IyInfo;
   return (*this);
 }
 
@@ -146,7 +311,6 @@ vpFeatureLuminance &vpFeatureLuminance::operator=(const vpFeatureLuminance& f)
 */
 vpFeatureLuminance::~vpFeatureLuminance() 
 {
-  if (pixInfo != NULL) delete [] pixInfo ;
 }
 
 /*!
@@ -183,18 +347,14 @@ vpFeatureLuminance::setCameraParameters(vpCameraParameters &_cam)
 
 /*!
 
-  Build a luminance feature directly from the image
+  Build a luminance feature directly from the image. The image rows are
+  processed in parallel, see setNbThreads().
 */
 
 void
 vpFeatureLuminance::buildFrom(vpImage<unsigned char> &I)
 {
   unsigned int l = 0;
-  double Ix,Iy ;
-
-  double px = cam.get_px() ;
-  double py = cam.get_py() ;
-
 
   if (firstTimeIn==0)
     { 
@@ -209,37 +369,27 @@ vpFeatureLuminance::buildFrom(vpImage<unsigned char> &I)
 						   j,i,
 						   x,y)  ;
 	    
-	      pixInfo[l].x = x;
-	      pixInfo[l].y = y;
-
-	      pixInfo[l].Z   = Z ;
+	      xInfo[l] = x;
+	      yInfo[l] = y;
 
 	      l++;
 	    }
 	}
     }
 
-  l= 0 ;
-  for (unsigned int i=bord; i < nbr-bord ; i++)
-    {
-      //   cout << i << endl ;
-      for (unsigned int j = bord ; j < nbc-bord; j++)
-	{
-	  // cout << dim_s <<" " <<l <<"  " <<i << "  " << j <<endl ;
-          Ix =  px * vpImageFilter::derivativeFilterX(I,i,j) ;
-	  Iy =  py * vpImageFilter::derivativeFilterY(I,i,j) ;
-	  
-	  // Calcul de Z
-	  
-	  pixInfo[l].I  =  I[i][j] ;
-	  s[l]  =  I[i][j] ;
-	  pixInfo[l].Ix  = Ix;
-	  pixInfo[l].Iy  = Iy;
-	  
-	  l++;
-	}
-    }
-
+  if (dim_s == 0)
+    return;
+
+  vpLuminanceGradient gradient;
+  gradient.I = &I;
+  gradient.bord = bord;
+  gradient.nbc = nbc;
+  gradient.px = cam.get_px();
+  gradient.py = cam.get_py();
+  gradient.s = s.data;
+  gradient.Ix = &IxInfo[0];
+  gradient.Iy = &IyInfo[0];
+  vpThreadPool::parallel_for(bord, nbr-bord, gradient, nbThreads, 8);
 }
 
 
@@ -254,24 +404,41 @@ void
 vpFeatureLuminance::interaction(vpMatrix &L)
 {  
   L.resize(dim_s,6) ;
+  interaction(FEATURE_ALL, L, 0) ;
+}
 
-  for(unsigned int m = 0; m< L.getRows(); m++)
-  {
-    double Ix = pixInfo[m].Ix;
-    double Iy = pixInfo[m].Iy;
+/*!
+  Compute the interaction matrix \f$ L_I \f$ in the rows \e rowOffset to
+  \e rowOffset + getDimension() - 1 of \e L, e.g. a stacked interaction
+  matrix allocated once by vpServo.
 
-    double x = pixInfo[m].x ;
-    double y = pixInfo[m].y ;
-    double Zinv =  1 / pixInfo[m].Z;
+  \param L : Matrix with 6 columns and at least \e rowOffset +
+  getDimension() rows.
+  \param rowOffset : First row of \e L written.
 
-    {
-      L[m][0] = Ix * Zinv;
-      L[m][1] = Iy * Zinv;
-      L[m][2] = -(x*Ix+y*Iy)*Zinv;
-      L[m][3] = -Ix*x*y-(1+y*y)*Iy;
-      L[m][4] = (1+x*x)*Ix + Iy*x*y;
-      L[m][5]  = Iy*x-Ix*y;
-    }
+  \exception vpFeatureException::sizeMismatchError : If \e L is too small.
+*/
+void
+vpFeatureLuminance::interaction(const unsigned int /* select */, vpMatrix &L, const unsigned int rowOffset)
+{
+  checkInteractionSize(L, rowOffset, dim_s);
+
+  double Zinv =  1 / Z;
+  for(unsigned int m = 0; m< dim_s; m++)
+  {
+    double Ix = IxInfo[m];
+    double Iy = IyInfo[m];
+
+    double x = xInfo[m] ;
+    double y = yInfo[m] ;
+
+    double *Lm = L[rowOffset + m];
+    Lm[0] = Ix * Zinv;
+    Lm[1] = Iy * Zinv;
+    Lm[2] = -(x*Ix+y*Iy)*Zinv;
+    Lm[3] = -Ix*x*y-(1+y*y)*Iy;
+    Lm[4] = (1+x*x)*Ix + Iy*x*y;
+    Lm[5] = Iy*x-Ix*y;
   }
 }
 
@@ -287,6 +454,73 @@ vpMatrix  vpFeatureLuminance::interaction(const unsigned int /* select */)
 }
 
 
+/*!
+  Compute \f$ {\bf L}^T {\bf L} \f$ and \f$ {\bf L}^T {\bf e} \f$, where
+  \f$ \bf L \f$ is the interaction matrix of the feature, without building
+  \f$ \bf L \f$. The rows of \f$ \bf L \f$ are computed and accumulated
+  while scanning the pixels, by bands of image rows processed in parallel
+  (see setNbThreads()), the sums of the bands being added in their order.
+
+  \param e : Error vector of the same size as the feature, typically given by
+  error(). It can be the error of another feature, e.g. when the interaction
+  matrix of the desired feature is used.
+  \param LtL : 6 by 6 matrix \f$ {\bf L}^T {\bf L} \f$.
+  \param Lte : 6 dimension vector \f$ {\bf L}^T {\bf e} \f$.
+
+  The results are the ones of <tt>L.AtA()</tt> and <tt>L.t() * e</tt> with
+  the matrix given by interaction(), up to the rounding errors of the
+  summation order.
+*/
+void
+vpFeatureLuminance::normalEquations(const vpColVector &e, vpMatrix &LtL, vpColVector &Lte)
+{
+  if (e.getRows() != dim_s) {
+    throw vpException(vpException::dimensionError,
+                      "Cannot compute the normal equations of a %d luminance feature with a %d error vector",
+                      dim_s, e.getRows());
+  }
+
+  LtL.resize(6, 6, false);
+  Lte.resize(6, false);
+
+  std::vector<double> sums;
+  computeNormalSums<true>(xInfo, yInfo, IxInfo, IyInfo, e, Z, (dim_s == 0) ? 1 : nbc - 2*bord, nbThreads, sums);
+
+  unsigned int k = 0;
+  for (unsigned int a = 0; a < 6; a++)
+    for (unsigned int b = a; b < 6; b++, k++)
+      LtL[a][b] = LtL[b][a] = sums[k];
+  for (unsigned int a = 0; a < 6; a++, k++)
+    Lte[a] = sums[k];
+}
+
+/*!
+  Compute \f$ {\bf L}^T {\bf e} \f$ only, as normalEquations(const vpColVector &, vpMatrix &, vpColVector &)
+  does. This is enough when \f$ {\bf L}^T {\bf L} \f$ does not change from
+  one iteration to another, e.g. when the interaction matrix of the desired
+  feature is used in a control law.
+
+  \param e : Error vector of the same size as the feature.
+  \param Lte : 6 dimension vector \f$ {\bf L}^T {\bf e} \f$.
+*/
+void
+vpFeatureLuminance::normalEquations(const vpColVector &e, vpColVector &Lte)
+{
+  if (e.getRows() != dim_s) {
+    throw vpException(vpException::dimensionError,
+                      "Cannot compute the normal equations of a %d luminance feature with a %d error vector",
+                      dim_s, e.getRows());
+  }
+
+  Lte.resize(6, false);
+
+  std::vector<double> sums;
+  computeNormalSums<false>(xInfo, yInfo, IxInfo, IyInfo, e, Z, (dim_s == 0) ? 1 : nbc - 2*bord, nbThreads, sums);
+
+  for (unsigned int a = 0; a < 6; a++)
+    Lte[a] = sums[a];
+}
+
 /*!
   Compute the error \f$ (I-I^*)\f$ between the current and the desired
  
@@ -308,6 +542,27 @@ vpFeatureLuminance::error(const vpBasicFeature &s_star,
 
 
 
+/*!
+  Compute the error \f$ (I-I^*)\f$ between the current and the desired
+  features in the elements \e offset to \e offset + getDimension() - 1 of
+  \e e.
+
+  \param s_star : Desired visual feature.
+  \param e : Vector with at least \e offset + getDimension() elements.
+  \param offset : Index of the first element of \e e written.
+
+  \exception vpFeatureException::sizeMismatchError : If \e e is too small.
+*/
+void
+vpFeatureLuminance::error(const vpBasicFeature &s_star, const unsigned int /* select */,
+                          vpColVector &e, const unsigned int offset)
+{
+  checkErrorSize(e, offset, dim_s);
+
+  for (unsigned int i = 0 ; i < dim_s ; i++)
+    e[offset + i] = s[i] - s_star[i] ;
+}
+
 /*!
   Compute the error \f$ (I-I^*)\f$ between the current and the desired
  
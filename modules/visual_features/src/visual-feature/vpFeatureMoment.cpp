@@ -186,15 +186,69 @@ void vpFeatureMoment::update (double A_, double B_, double C_){
   + 1 << j + 1 << k + 1 << l.
 */
 vpMatrix vpFeatureMoment::interaction (unsigned int select){
-    vpMatrix L(0,0);
+    unsigned int nbRows = 0;
+    for(unsigned int i=0;i<dim_s;++i){
+        if(vpBasicFeature::FEATURE_LINE[i] & select)
+            nbRows += interaction_matrices[i].getRows();
+    }
+
+    vpMatrix L(nbRows,6);
+    interaction(select, L, 0);
+
+    return L;
+}
 
+/*!
+  Copies the interaction matrices of the selected features in the rows of
+  \e L from row \e rowOffset, as interaction(unsigned int) stacks them. No
+  computation is done.
+
+  \param select : Feature selector.
+  \param L : Matrix with 6 columns and enough rows to receive the selected
+  interaction matrices from row \e rowOffset.
+  \param rowOffset : First row of \e L written.
+
+  \exception vpFeatureException::sizeMismatchError : If \e L is too small.
+*/
+void vpFeatureMoment::interaction (const unsigned int select, vpMatrix &L, const unsigned int rowOffset){
+    unsigned int nbRows = 0;
+    for(unsigned int i=0;i<dim_s;++i){
+        if(vpBasicFeature::FEATURE_LINE[i] & select)
+            nbRows += interaction_matrices[i].getRows();
+    }
+    checkInteractionSize(L, rowOffset, nbRows);
+
+    unsigned int row = rowOffset;
     for(unsigned int i=0;i<dim_s;++i){
         if(vpBasicFeature::FEATURE_LINE[i] & select){
-            L.stack(interaction_matrices[i]);
+            const vpMatrix &Li = interaction_matrices[i];
+            for(unsigned int r=0;r<Li.getRows();++r, ++row)
+                for(unsigned int c=0;c<6;++c)
+                    L[row][c] = Li[r][c];
         }
     }
+}
 
-    return L;
+/*!
+  Computes the error \f$ s - s^* \f$ of the selected features in the
+  elements of \e e from index \e offset.
+
+  \param s_star : Desired visual feature.
+  \param select : Feature selector.
+  \param e : Vector with at least \e offset + getDimension(select) elements.
+  \param offset : Index of the first element of \e e written.
+
+  \exception vpFeatureException::sizeMismatchError : If \e e is too small.
+*/
+void vpFeatureMoment::error (const vpBasicFeature &s_star, const unsigned int select,
+                             vpColVector &e, const unsigned int offset){
+    checkErrorSize(e, offset, (unsigned int)getDimension(select));
+
+    unsigned int k = offset;
+    for(unsigned int i=0;i<dim_s;++i){
+        if(vpBasicFeature::FEATURE_LINE[i] & select)
+            e[k++] = s[i] - s_star[i];
+    }
 }
 
 /*!  Duplicates the feature into a vpGenericFeature harbouring the
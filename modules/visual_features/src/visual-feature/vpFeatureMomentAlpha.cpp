@@ -144,17 +144,29 @@ void vpFeatureMomentAlpha::compute_interaction(){
     interaction_matrices[0][0][WZ] = -1.;
 }
 
-vpColVector vpFeatureMomentAlpha::error (const vpBasicFeature &s_star, const unsigned int /* select */){
-  vpColVector e(0) ;
+vpColVector vpFeatureMomentAlpha::error (const vpBasicFeature &s_star, const unsigned int select){
+  vpColVector e((unsigned int)getDimension(select)) ;
+  error(s_star, select, e, 0) ;
+
+  return e;
+}
+
+/*!
+  Computes the error \f$ \alpha - \alpha^* \f$ brought back in
+  \f$ [-\pi, \pi] \f$ in the element \e offset of \e e, if the feature
+  is selected.
+*/
+void vpFeatureMomentAlpha::error (const vpBasicFeature &s_star, const unsigned int select,
+                                  vpColVector &e, const unsigned int offset){
+  checkErrorSize(e, offset, (unsigned int)getDimension(select)) ;
+  if (! (FEATURE_LINE[0] & select))
+    return ;
+
   double err = s[0] - s_star[0] ;
 
   if (err < -M_PI) err += 2*M_PI ;
   if (err > M_PI) err -= 2*M_PI ;
 
-  vpColVector ecv(1) ;
-  ecv[0] = err ;
-  e = vpColVector::stack(e,ecv) ;
-
-  return e;
+  e[offset] = err ;
 }
 #endif
@@ -241,9 +241,22 @@ vpFeaturePoint::set_xyZ(const double x_,
 vpMatrix
 vpFeaturePoint::interaction(const unsigned int select)
 {
-  vpMatrix L ;
+  vpMatrix L(getDimension(select), 6) ;
+  interaction(select, L, 0) ;
+  return L ;
+}
 
-  L.resize(0,6) ;
+/*!
+  Compute the interaction matrix of a subset of the point features in the
+  rows of \e L from row \e rowOffset, see interaction(const unsigned int).
+  \e L must have at least \e rowOffset + getDimension(select) rows and 6
+  columns.
+*/
+void
+vpFeaturePoint::interaction(const unsigned int select, vpMatrix &L, const unsigned int rowOffset)
+{
+  checkInteractionSize(L, rowOffset, getDimension(select)) ;
+  unsigned int row = rowOffset ;
 
   if (deallocate == vpBasicFeature::user)
   {
@@ -293,32 +306,27 @@ vpFeaturePoint::interaction(const unsigned int select)
 
   if (vpFeaturePoint::selectX() & select )
   {
-    vpMatrix Lx(1,6) ; Lx = 0;
-
-    Lx[0][0] = -1/Z_  ;
-    Lx[0][1] = 0 ;
-    Lx[0][2] = x_/Z_ ;
-    Lx[0][3] = x_*y_ ;
-    Lx[0][4] = -(1+x_*x_) ;
-    Lx[0][5] = y_ ;
-
-    L = vpMatrix::stack(L,Lx) ;
+    double *Lx = L[row++] ;
+
+    Lx[0] = -1/Z_  ;
+    Lx[1] = 0 ;
+    Lx[2] = x_/Z_ ;
+    Lx[3] = x_*y_ ;
+    Lx[4] = -(1+x_*x_) ;
+    Lx[5] = y_ ;
   }
 
   if (vpFeaturePoint::selectY() & select )
   {
-    vpMatrix Ly(1,6) ; Ly = 0;
-
-    Ly[0][0] = 0 ;
-    Ly[0][1]  = -1/Z_ ;
-    Ly[0][2] = y_/Z_ ;
-    Ly[0][3] = 1+y_*y_ ;
-    Ly[0][4] = -x_*y_ ;
-    Ly[0][5] = -x_ ;
-
-    L = vpMatrix::stack(L,Ly) ;
+    double *Ly = L[row++] ;
+
+    Ly[0] = 0 ;
+    Ly[1]  = -1/Z_ ;
+    Ly[2] = y_/Z_ ;
+    Ly[3] = 1+y_*y_ ;
+    Ly[4] = -x_*y_ ;
+    Ly[5] = -x_ ;
   }
-  return L ;
 }
 
 
@@ -356,31 +364,28 @@ vpColVector
 vpFeaturePoint::error(const vpBasicFeature &s_star,
 		      const unsigned int select)
 {
-  vpColVector e(0) ;
-
-  try{
-    if (vpFeaturePoint::selectX() & select )
-    {
-      vpColVector ex(1) ;
-      ex[0] = s[0] - s_star[0] ;
-
-      e = vpColVector::stack(e,ex) ;
-    }
-
-    if (vpFeaturePoint::selectY() & select )
-    {
-      vpColVector ey(1) ;
-      ey[0] = s[1] - s_star[1] ;
-      e = vpColVector::stack(e,ey) ;
-    }
-  }
-  catch(...) {
-    throw ;
-  }
+  vpColVector e(getDimension(select)) ;
+  error(s_star, select, e, 0) ;
+  return e ;
+}
 
+/*!
+  Compute the error \f$ (s-s^*)\f$ of a subset of the point features in \e e
+  from index \e offset, see error(const vpBasicFeature &, const unsigned int).
+  \e e must have at least \e offset + getDimension(select) elements.
+*/
+void
+vpFeaturePoint::error(const vpBasicFeature &s_star, const unsigned int select,
+                      vpColVector &e, const unsigned int offset)
+{
+  checkErrorSize(e, offset, getDimension(select)) ;
+  unsigned int k = offset ;
 
-  return e ;
+  if (vpFeaturePoint::selectX() & select )
+    e[k++] = s[0] - s_star[0] ;
 
+  if (vpFeaturePoint::selectY() & select )
+    e[k++] = s[1] - s_star[1] ;
 }
 
 
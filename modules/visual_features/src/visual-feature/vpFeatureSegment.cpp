@@ -186,11 +186,23 @@ int main()
   In that case, L is a 2 by 6 matrix.
 */
 vpMatrix
-vpFeatureSegment::interaction( const unsigned int select )
+vpFeatureSegment::interaction(const unsigned int select)
 {
+  vpMatrix L(getDimension(select), 6) ;
+  interaction(select, L, 0) ;
+  return L ;
+}
 
-  vpMatrix L ;
-  L.resize(0,6) ;
+/*!
+  Compute the interaction matrix of a subset of the features in the rows of
+  \e L from row \e rowOffset, see interaction(const unsigned int). \e L must
+  have at least \e rowOffset + getDimension(select) rows and 6 columns.
+*/
+void
+vpFeatureSegment::interaction(const unsigned int select, vpMatrix &L, const unsigned int rowOffset)
+{
+  checkInteractionSize(L, rowOffset, getDimension(select)) ;
+  unsigned int row = rowOffset ;
 
   if (deallocate == vpBasicFeature::user)  
   {
@@ -243,96 +255,86 @@ vpFeatureSegment::interaction( const unsigned int select )
     double lns = sin_a_ *  ln;
 
     if (vpFeatureSegment::selectXc() & select ){
-      vpMatrix Lxn(1,6);
-      Lxn[0][0] = -Zn_inv +  lambda * xn * cos_a_;
-      Lxn[0][1] = lambda * xn * sin_a_ ;
-      Lxn[0][2] = lambda1 * (xn*xnalpha - cos_a_ /4.);
-      Lxn[0][3] = sin_a_*cos_a_/4/ln - xn*xnalpha*sin_a_/ln;
-      Lxn[0][4] = -ln*(1.+lc*lc/4.) + xn*xnalpha*cos_a_/ln ;
-      Lxn[0][5] = yn ;
-      L = vpMatrix::stack(L, Lxn) ;
+      double *Lxn = L[row++] ;
+      Lxn[0] = -Zn_inv +  lambda * xn * cos_a_;
+      Lxn[1] = lambda * xn * sin_a_ ;
+      Lxn[2] = lambda1 * (xn*xnalpha - cos_a_ /4.);
+      Lxn[3] = sin_a_*cos_a_/4/ln - xn*xnalpha*sin_a_/ln;
+      Lxn[4] = -ln*(1.+lc*lc/4.) + xn*xnalpha*cos_a_/ln ;
+      Lxn[5] = yn ;
     }
 
     if (vpFeatureSegment::selectYc() & select ){
-      vpMatrix Lyn(1,6);
-      Lyn[0][0] = lambda*yn*cos_a_ ;
-      Lyn[0][1] = -Zn_inv + lambda*yn*sin_a_ ;
-      Lyn[0][2] = lambda1 * (yn*xnalpha - sin_a_/4.);
-      Lyn[0][3] = ln*(1+ls*ls/4.)-yn*xnalpha*sin_a_/ln ;
-      Lyn[0][4] = -sin_a_*cos_a_/4/ln + yn*xnalpha*cos_a_/ln;
-      Lyn[0][5] = -xn ;
-      L = vpMatrix::stack(L, Lyn) ;
+      double *Lyn = L[row++] ;
+      Lyn[0] = lambda*yn*cos_a_ ;
+      Lyn[1] = -Zn_inv + lambda*yn*sin_a_ ;
+      Lyn[2] = lambda1 * (yn*xnalpha - sin_a_/4.);
+      Lyn[3] = ln*(1+ls*ls/4.)-yn*xnalpha*sin_a_/ln ;
+      Lyn[4] = -sin_a_*cos_a_/4/ln + yn*xnalpha*cos_a_/ln;
+      Lyn[5] = -xn ;
     }
 
     if (vpFeatureSegment::selectL() & select ){
-      vpMatrix Lln(1,6);
-      Lln[0][0] = lambda * lnc ;
-      Lln[0][1] = lambda * lns ;
-      Lln[0][2] = -(Zn_inv + lambda*xnalpha);
-      Lln[0][3] = -yn-xnalpha*sin_a_ ;
-      Lln[0][4] = xn + xnalpha*cos_a_ ;
-      Lln[0][5] = 0 ;
-      L = vpMatrix::stack(L, Lln) ;
+      double *Lln = L[row++] ;
+      Lln[0] = lambda * lnc ;
+      Lln[1] = lambda * lns ;
+      Lln[2] = -(Zn_inv + lambda*xnalpha);
+      Lln[3] = -yn-xnalpha*sin_a_ ;
+      Lln[4] = xn + xnalpha*cos_a_ ;
+      Lln[5] = 0 ;
     }
     if (vpFeatureSegment::selectAlpha() & select ){
       // We recall that xc_ contains xc/l, yc_ contains yc/l and l_ contains 1/l
-      vpMatrix Lalpha(1,6);
-        Lalpha[0][0] = -lambda1*sin_a_*l_ ;
-        Lalpha[0][1] = lambda1*cos_a_*l_ ;
-        Lalpha[0][2] = lambda1*(xc_*sin_a_-yc_*cos_a_);
-        Lalpha[0][3] = (-xc_*sin_a_*sin_a_+yc_*cos_a_*sin_a_)/l_;
-        Lalpha[0][4] = (xc_*cos_a_*sin_a_ - yc_*cos_a_*cos_a_)/l_ ;
-        Lalpha[0][5] = -1 ;
-      L = vpMatrix::stack(L,Lalpha) ;
+      double *Lalpha = L[row++] ;
+        Lalpha[0] = -lambda1*sin_a_*l_ ;
+        Lalpha[1] = lambda1*cos_a_*l_ ;
+        Lalpha[2] = lambda1*(xc_*sin_a_-yc_*cos_a_);
+        Lalpha[3] = (-xc_*sin_a_*sin_a_+yc_*cos_a_*sin_a_)/l_;
+        Lalpha[4] = (xc_*cos_a_*sin_a_ - yc_*cos_a_*cos_a_)/l_ ;
+        Lalpha[5] = -1 ;
     }
   }
   else
   {
     if (vpFeatureSegment::selectXc() & select ){
-      vpMatrix Lxc(1,6);
-      Lxc[0][0] = -lambda2 ;
-      Lxc[0][1] = 0. ;
-      Lxc[0][2] = lambda2*xc_ - lambda1*l_*cos_a_/4.;
-      Lxc[0][3] = xc_*yc_ + l_*l_*cos_a_*sin_a_/4. ;
-      Lxc[0][4] = -(1+xc_*xc_+l_*l_*cos_a_*cos_a_/4.) ;
-      Lxc[0][5] = yc_ ;
-      L = vpMatrix::stack(L,Lxc) ;
+      double *Lxc = L[row++] ;
+      Lxc[0] = -lambda2 ;
+      Lxc[1] = 0. ;
+      Lxc[2] = lambda2*xc_ - lambda1*l_*cos_a_/4.;
+      Lxc[3] = xc_*yc_ + l_*l_*cos_a_*sin_a_/4. ;
+      Lxc[4] = -(1+xc_*xc_+l_*l_*cos_a_*cos_a_/4.) ;
+      Lxc[5] = yc_ ;
     }
 
     if (vpFeatureSegment::selectYc() & select ){
-      vpMatrix Lyc(1,6);
-      Lyc[0][0] = 0. ;
-      Lyc[0][1] = -lambda2 ;
-      Lyc[0][2] = lambda2*yc_ - lambda1*l_*sin_a_/4.;
-      Lyc[0][3] = 1+yc_*yc_+l_*l_*sin_a_*sin_a_/4. ;
-      Lyc[0][4] = -xc_*yc_-l_*l_*cos_a_*sin_a_/4. ;
-      Lyc[0][5] = -xc_ ;
-      L = vpMatrix::stack(L,Lyc) ;
+      double *Lyc = L[row++] ;
+      Lyc[0] = 0. ;
+      Lyc[1] = -lambda2 ;
+      Lyc[2] = lambda2*yc_ - lambda1*l_*sin_a_/4.;
+      Lyc[3] = 1+yc_*yc_+l_*l_*sin_a_*sin_a_/4. ;
+      Lyc[4] = -xc_*yc_-l_*l_*cos_a_*sin_a_/4. ;
+      Lyc[5] = -xc_ ;
     }
 
     if (vpFeatureSegment::selectL() & select ){
-      vpMatrix Ll(1,6);
-      Ll[0][0] = lambda1*cos_a_ ;
-      Ll[0][1] = lambda1*sin_a_ ;
-      Ll[0][2] = lambda2*l_-lambda1*(xc_*cos_a_+yc_*sin_a_);
-      Ll[0][3] = l_*(xc_*cos_a_*sin_a_ + yc_*(1+sin_a_*sin_a_)) ;
-      Ll[0][4] = -l_*(xc_*(1+cos_a_*cos_a_)+yc_*cos_a_*sin_a_) ;
-      Ll[0][5] = 0 ;
-      L = vpMatrix::stack(L,Ll) ;
+      double *Ll = L[row++] ;
+      Ll[0] = lambda1*cos_a_ ;
+      Ll[1] = lambda1*sin_a_ ;
+      Ll[2] = lambda2*l_-lambda1*(xc_*cos_a_+yc_*sin_a_);
+      Ll[3] = l_*(xc_*cos_a_*sin_a_ + yc_*(1+sin_a_*sin_a_)) ;
+      Ll[4] = -l_*(xc_*(1+cos_a_*cos_a_)+yc_*cos_a_*sin_a_) ;
+      Ll[5] = 0 ;
     }
     if (vpFeatureSegment::selectAlpha() & select ){
-      vpMatrix Lalpha(1,6);
-        Lalpha[0][0] = -lambda1*sin_a_/l_ ;
-        Lalpha[0][1] = lambda1*cos_a_/l_ ;
-        Lalpha[0][2] = lambda1*(xc_*sin_a_-yc_*cos_a_)/l_;
-        Lalpha[0][3] = -xc_*sin_a_*sin_a_+yc_*cos_a_*sin_a_;
-        Lalpha[0][4] = xc_*cos_a_*sin_a_ - yc_*cos_a_*cos_a_ ;
-        Lalpha[0][5] = -1 ;
-      L = vpMatrix::stack(L,Lalpha) ;
+      double *Lalpha = L[row++] ;
+        Lalpha[0] = -lambda1*sin_a_/l_ ;
+        Lalpha[1] = lambda1*cos_a_/l_ ;
+        Lalpha[2] = lambda1*(xc_*sin_a_-yc_*cos_a_)/l_;
+        Lalpha[3] = -xc_*sin_a_*sin_a_+yc_*cos_a_*sin_a_;
+        Lalpha[4] = xc_*cos_a_*sin_a_ - yc_*cos_a_*cos_a_ ;
+        Lalpha[5] = -1 ;
     }
   }
-
-  return L ;
 }
 
 /*!
@@ -361,35 +363,42 @@ vpFeatureSegment::interaction( const unsigned int select )
 */
 vpColVector
 vpFeatureSegment::error( const vpBasicFeature &s_star, const unsigned int select )
-{ 
-  vpColVector e(0) ;
+{
+  vpColVector e(getDimension(select)) ;
+  error(s_star, select, e, 0) ;
+  return e ;
+}
+
+/*!
+  Compute the error \f$ (s-s^*)\f$ of a subset of the features in \e e from
+  index \e offset, see error(const vpBasicFeature &, const unsigned int).
+  \e e must have at least \e offset + getDimension(select) elements.
+*/
+void
+vpFeatureSegment::error(const vpBasicFeature &s_star, const unsigned int select,
+                        vpColVector &e, const unsigned int offset)
+{
+  checkErrorSize(e, offset, getDimension(select)) ;
+  unsigned int k = offset ;
 
   if (vpFeatureSegment::selectXc() & select ){
-    vpColVector exc(1) ;
-    exc[0] = xc_-s_star[0];
-    e = vpColVector::stack(e,exc) ;
+    e[k++] = xc_-s_star[0];
   }
 
   if (vpFeatureSegment::selectYc() & select ){
-    vpColVector eyc(1) ;
-    eyc[0] = yc_ - s_star[1];
-    e = vpColVector::stack(e,eyc) ;
+    e[k++] = yc_ - s_star[1];
   }
 
   if (vpFeatureSegment::selectL() & select ){
-    vpColVector eL(1) ;
-    eL[0] = l_ - s_star[2];
-    e = vpColVector::stack(e,eL) ;
+    e[k++] = l_ - s_star[2];
   }
 
   if (vpFeatureSegment::selectAlpha() & select ){
-    vpColVector eAlpha(1) ;
-    eAlpha[0] = alpha_ - s_star[3];
-    while (eAlpha[0] < -M_PI) eAlpha[0] += 2*M_PI ;
-    while (eAlpha[0] > M_PI) eAlpha[0] -= 2*M_PI ;
-    e = vpColVector::stack(e,eAlpha) ;
+    double eAlpha = alpha_ - s_star[3];
+    while (eAlpha < -M_PI) eAlpha += 2*M_PI ;
+    while (eAlpha > M_PI) eAlpha -= 2*M_PI ;
+    e[k++] = eAlpha ;
   }
-  return e ;
 }
 
 /*!
@@ -436,9 +436,21 @@ vpFeatureThetaU::get_TUz() const
 vpMatrix
 vpFeatureThetaU::interaction(const unsigned int select)
 {
+  vpMatrix L(getDimension(select), 6) ;
+  interaction(select, L, 0) ;
+  return L ;
+}
 
-  vpMatrix L ;
-  L.resize(0,6) ;
+/*!
+  Compute the interaction matrix of a subset of the features in the rows of
+  \e L from row \e rowOffset, see interaction(const unsigned int). \e L must
+  have at least \e rowOffset + getDimension(select) rows and 6 columns.
+*/
+void
+vpFeatureThetaU::interaction(const unsigned int select, vpMatrix &L, const unsigned int rowOffset)
+{
+  checkInteractionSize(L, rowOffset, getDimension(select)) ;
+  unsigned int row = rowOffset ;
 
   if (deallocate == vpBasicFeature::user)
   {
@@ -464,68 +476,57 @@ vpFeatureThetaU::interaction(const unsigned int select)
     resetFlags();
   }
 
-  // Lw computed using Lw = [theta/2 u]_x +/- (I + alpha [u]_x [u]_x)
-  vpColVector u(3)  ;
-  for (unsigned int i=0 ; i < 3 ; i++) {
-    u[i] = s[i]/2.0 ; 
-  }
-  
-  vpMatrix Lw(3,3) ;
-  Lw = vpColVector::skew(u) ;  /* [theta/2  u]_x */
+  // Lw computed using Lw = [theta/2 u]_x +/- (I + alpha [u]_x [u]_x), with
+  // fixed size arrays to avoid any allocation
+  double Lw[3][3] ;
+  Lw[0][0] = 0 ;        Lw[0][1] = -s[2]/2 ;  Lw[0][2] = s[1]/2 ;
+  Lw[1][0] = s[2]/2 ;   Lw[1][1] = 0 ;        Lw[1][2] = -s[0]/2 ;
+  Lw[2][0] = -s[1]/2 ;  Lw[2][1] = s[0]/2 ;   Lw[2][2] = 0 ;
 
-  vpMatrix U2(3,3) ;
-  U2.eye() ;
-  
-  double  theta = sqrt(s.sumSquare()) ;
+  double U2[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}} ;
+
+  double  theta = sqrt(s[0]*s[0] + s[1]*s[1] + s[2]*s[2]) ;
   if (theta >= 1e-6) {
-    for (unsigned int i=0 ; i < 3 ; i++) 
+    double u[3] ;
+    for (unsigned int i=0 ; i < 3 ; i++)
       u[i] = s[i]/theta ;
 
-    vpMatrix skew_u ;
-    skew_u = vpColVector::skew(u) ; 
-    U2 += (1-vpMath::sinc(theta)/vpMath::sqr(vpMath::sinc(theta/2.0)))*skew_u*skew_u ;
-  }
- 
-  if (rotation == cdRc) {
-    Lw += U2; 
-  }
-  else { 
-    Lw -=  U2; 
+    // [u]_x [u]_x = u u^T - I since u is a unit vector
+    double alpha = 1-vpMath::sinc(theta)/vpMath::sqr(vpMath::sinc(theta/2.0)) ;
+    for (unsigned int i=0 ; i < 3 ; i++)
+      for (unsigned int j=0 ; j < 3 ; j++)
+        U2[i][j] += alpha * (u[i]*u[j] - (i == j ? 1 : 0)) ;
   }
 
+  double sign = (rotation == cdRc) ? 1 : -1 ;
+  for (unsigned int i=0 ; i < 3 ; i++)
+    for (unsigned int j=0 ; j < 3 ; j++)
+      Lw[i][j] += sign * U2[i][j] ;
+
   //This version is a simplification
   if (vpFeatureThetaU::selectTUx() & select )
     {
-      vpMatrix Lx(1,6) ;
-
-      Lx[0][0] = 0 ;    Lx[0][1] = 0 ;    Lx[0][2] = 0 ;
-      for (int i=0 ; i < 3 ; i++) Lx[0][i+3] = Lw[0][i] ;
-
+      double *Lx = L[row++] ;
 
-      L = vpMatrix::stack(L,Lx) ;
+      Lx[0] = 0 ;    Lx[1] = 0 ;    Lx[2] = 0 ;
+      for (int i=0 ; i < 3 ; i++) Lx[i+3] = Lw[0][i] ;
     }
 
   if (vpFeatureThetaU::selectTUy() & select )
     {
-      vpMatrix Ly(1,6) ;
+      double *Ly = L[row++] ;
 
-      Ly[0][0] = 0 ;    Ly[0][1] = 0 ;    Ly[0][2] = 0 ;
-      for (int i=0 ; i < 3 ; i++) Ly[0][i+3] = Lw[1][i] ;
-
-      L = vpMatrix::stack(L,Ly) ;
+      Ly[0] = 0 ;    Ly[1] = 0 ;    Ly[2] = 0 ;
+      for (int i=0 ; i < 3 ; i++) Ly[i+3] = Lw[1][i] ;
     }
 
   if (vpFeatureThetaU::selectTUz() & select )
     {
-      vpMatrix Lz(1,6) ;
-
-      Lz[0][0] = 0 ;    Lz[0][1] = 0 ;    Lz[0][2] = 0 ;
-      for (int i=0 ; i < 3 ; i++) Lz[0][i+3] = Lw[2][i] ;
+      double *Lz = L[row++] ;
 
-      L = vpMatrix::stack(L,Lz) ;
+      Lz[0] = 0 ;    Lz[1] = 0 ;    Lz[2] = 0 ;
+      for (int i=0 ; i < 3 ; i++) Lz[i+3] = Lw[2][i] ;
     }
-
-  return L ;
 }
 
 /*!
@@ -592,38 +593,44 @@ vpColVector
 vpFeatureThetaU::error(const vpBasicFeature &s_star,
 		       const unsigned int select)
 {
+  vpColVector e(getDimension(select)) ;
+  error(s_star, select, e, 0) ;
+  return e ;
+}
+
+/*!
+  Compute the error \f$ (s-s^*)\f$ of a subset of the features in \e e from
+  index \e offset, see error(const vpBasicFeature &, const unsigned int).
+  \e e must have at least \e offset + getDimension(select) elements.
+*/
+void
+vpFeatureThetaU::error(const vpBasicFeature &s_star, const unsigned int select,
+                       vpColVector &e, const unsigned int offset)
+{
+  checkErrorSize(e, offset, getDimension(select)) ;
+  unsigned int k = offset ;
 
-  if (fabs(s_star.get_s().sumSquare()) > 1e-6)
+  if (fabs(s_star[0]*s_star[0] + s_star[1]*s_star[1] + s_star[2]*s_star[2]) > 1e-6)
     {
       vpERROR_TRACE("s* should be zero ! ") ;
       throw(vpFeatureException(vpFeatureException::badInitializationError,
 			       "s* should be zero !")) ;
     }
 
-  vpColVector e(0) ;
-
-
   if (vpFeatureThetaU::selectTUx() & select )
     {
-      vpColVector ex(1) ;
-      ex[0] = s[0]  ;
-      e = vpColVector::stack(e,ex) ;
+      e[k++] = s[0]  ;
     }
 
   if (vpFeatureThetaU::selectTUy() & select )
     {
-      vpColVector ey(1) ;
-      ey[0] = s[1] ;
-      e = vpColVector::stack(e,ey) ;
+      e[k++] = s[1] ;
     }
 
   if (vpFeatureThetaU::selectTUz() & select )
     {
-      vpColVector ez(1) ;
-      ez[0] = s[2] ;
-      e = vpColVector::stack(e,ez) ;
+      e[k++] = s[2] ;
     }
-  return e ;
 }
 
 /*!
@@ -331,9 +331,21 @@ vpFeatureTranslation::get_Tz() const
 vpMatrix
 vpFeatureTranslation::interaction(const unsigned int select)
 {
+  vpMatrix L(getDimension(select), 6) ;
+  interaction(select, L, 0) ;
+  return L ;
+}
 
-  vpMatrix L ;
-  L.resize(0,6) ;
+/*!
+  Compute the interaction matrix of a subset of the features in the rows of
+  \e L from row \e rowOffset, see interaction(const unsigned int). \e L must
+  have at least \e rowOffset + getDimension(select) rows and 6 columns.
+*/
+void
+vpFeatureTranslation::interaction(const unsigned int select, vpMatrix &L, const unsigned int rowOffset)
+{
+  checkInteractionSize(L, rowOffset, getDimension(select)) ;
+  unsigned int row = rowOffset ;
 
   if (deallocate == vpBasicFeature::user) {
     for (unsigned int i = 0; i < nbParameters; i++) {
@@ -353,90 +365,70 @@ vpFeatureTranslation::interaction(const unsigned int select)
   if (translation == cdMc) {
     //This version is a simplification
     if (vpFeatureTranslation::selectTx() & select ) {
-      vpMatrix Lx(1,6) ;
+      double *Lx = L[row++] ;
 
       for (int i=0 ; i < 3 ; i++)
-	Lx[0][i] = f2Mf1[0][i] ;
-      Lx[0][3] = 0 ;    Lx[0][4] = 0 ;    Lx[0][5] = 0 ;
-
-      L = vpMatrix::stack(L,Lx) ;
+	Lx[i] = f2Mf1[0][i] ;
+      Lx[3] = 0 ;    Lx[4] = 0 ;    Lx[5] = 0 ;
     }
 
     if (vpFeatureTranslation::selectTy() & select ) {
-      vpMatrix Ly(1,6) ;
+      double *Ly = L[row++] ;
 
       for (int i=0 ; i < 3 ; i++)
-	Ly[0][i] = f2Mf1[1][i] ;
-      Ly[0][3] = 0 ;    Ly[0][4] = 0 ;    Ly[0][5] = 0 ;
-
-      L = vpMatrix::stack(L,Ly) ;
+	Ly[i] = f2Mf1[1][i] ;
+      Ly[3] = 0 ;    Ly[4] = 0 ;    Ly[5] = 0 ;
     }
 
     if (vpFeatureTranslation::selectTz() & select ) {
-      vpMatrix Lz(1,6) ;
+      double *Lz = L[row++] ;
 
       for (int i=0 ; i < 3 ; i++)
-	Lz[0][i] = f2Mf1[2][i] ;
-      Lz[0][3] = 0 ;    Lz[0][4] = 0 ;    Lz[0][5] = 0 ;
-
-      L = vpMatrix::stack(L,Lz) ;
+	Lz[i] = f2Mf1[2][i] ;
+      Lz[3] = 0 ;    Lz[4] = 0 ;    Lz[5] = 0 ;
     }
   }
   if (translation == cMcd) {
     //This version is a simplification
     if (vpFeatureTranslation::selectTx() & select ) {
-      vpMatrix Lx(1,6) ;
-      Lx[0][0] = -1 ;    Lx[0][1] = 0 ;    Lx[0][2] = 0 ;
-      Lx[0][3] = 0 ;    Lx[0][4] = -s[2] ;    Lx[0][5] = s[1] ;
-
-      L = vpMatrix::stack(L,Lx) ;
+      double *Lx = L[row++] ;
+      Lx[0] = -1 ;    Lx[1] = 0 ;    Lx[2] = 0 ;
+      Lx[3] = 0 ;    Lx[4] = -s[2] ;    Lx[5] = s[1] ;
     }
 
     if (vpFeatureTranslation::selectTy() & select ) {
-      vpMatrix Ly(1,6) ;
-      Ly[0][0] = 0 ;    Ly[0][1] = -1 ;    Ly[0][2] = 0 ;
-      Ly[0][3] = s[2] ;    Ly[0][4] = 0 ;    Ly[0][5] = -s[0] ;
-
-      L = vpMatrix::stack(L,Ly) ;
+      double *Ly = L[row++] ;
+      Ly[0] = 0 ;    Ly[1] = -1 ;    Ly[2] = 0 ;
+      Ly[3] = s[2] ;    Ly[4] = 0 ;    Ly[5] = -s[0] ;
     }
 
     if (vpFeatureTranslation::selectTz() & select ) {
-      vpMatrix Lz(1,6) ;
-      Lz[0][0] = 0 ;    Lz[0][1] = 0 ;    Lz[0][2] = -1 ;
-      Lz[0][3] = -s[1] ;    Lz[0][4] = s[0] ;    Lz[0][5] = 0 ;
-
-      L = vpMatrix::stack(L,Lz) ;
+      double *Lz = L[row++] ;
+      Lz[0] = 0 ;    Lz[1] = 0 ;    Lz[2] = -1 ;
+      Lz[3] = -s[1] ;    Lz[4] = s[0] ;    Lz[5] = 0 ;
     }
   }
 
   if (translation == cMo) {
     //This version is a simplification
     if (vpFeatureTranslation::selectTx() & select ) {
-      vpMatrix Lx(1,6) ;
-      Lx[0][0] = -1 ;    Lx[0][1] = 0 ;    Lx[0][2] = 0 ;
-      Lx[0][3] = 0 ;    Lx[0][4] = -s[2] ;    Lx[0][5] = s[1] ;
-
-      L = vpMatrix::stack(L,Lx) ;
+      double *Lx = L[row++] ;
+      Lx[0] = -1 ;    Lx[1] = 0 ;    Lx[2] = 0 ;
+      Lx[3] = 0 ;    Lx[4] = -s[2] ;    Lx[5] = s[1] ;
     }
 
     if (vpFeatureTranslation::selectTy() & select ) {
-      vpMatrix Ly(1,6) ;
-      Ly[0][0] = 0 ;    Ly[0][1] = -1 ;    Ly[0][2] = 0 ;
-      Ly[0][3] = s[2] ;    Ly[0][4] = 0 ;    Ly[0][5] = -s[0] ;
-
-      L = vpMatrix::stack(L,Ly) ;
+      double *Ly = L[row++] ;
+      Ly[0] = 0 ;    Ly[1] = -1 ;    Ly[2] = 0 ;
+      Ly[3] = s[2] ;    Ly[4] = 0 ;    Ly[5] = -s[0] ;
     }
 
     if (vpFeatureTranslation::selectTz() & select ) {
-      vpMatrix Lz(1,6) ;
-      Lz[0][0] = 0 ;    Lz[0][1] = 0 ;    Lz[0][2] = -1 ;
-      Lz[0][3] = -s[1] ;    Lz[0][4] = s[0] ;    Lz[0][5] = 0 ;
-
-      L = vpMatrix::stack(L,Lz) ;
+      double *Lz = L[row++] ;
+      Lz[0] = 0 ;    Lz[1] = 0 ;    Lz[2] = -1 ;
+      Lz[3] = -s[1] ;    Lz[4] = s[0] ;    Lz[5] = 0 ;
     }
   }
-
-  return L ;
 }
 
 /*!
@@ -504,11 +496,26 @@ vpColVector
 vpFeatureTranslation::error(const vpBasicFeature &s_star,
 			    const unsigned int select)
 {
-  vpColVector e(0) ;
+  vpColVector e(getDimension(select)) ;
+  error(s_star, select, e, 0) ;
+  return e ;
+}
+
+/*!
+  Compute the error \f$ (s-s^*)\f$ of a subset of the features in \e e from
+  index \e offset, see error(const vpBasicFeature &, const unsigned int).
+  \e e must have at least \e offset + getDimension(select) elements.
+*/
+void
+vpFeatureTranslation::error(const vpBasicFeature &s_star, const unsigned int select,
+                            vpColVector &e, const unsigned int offset)
+{
+  checkErrorSize(e, offset, getDimension(select)) ;
+  unsigned int k = offset ;
 
   if(translation == cdMc || translation == cMcd)
   {
-    if (s_star.get_s().sumSquare() > 1e-6)
+    if (s_star[0]*s_star[0] + s_star[1]*s_star[1] + s_star[2]*s_star[2] > 1e-6)
     {
       vpERROR_TRACE("s* should be zero ! ") ;
       throw(vpFeatureException(vpFeatureException::badInitializationError,
@@ -516,29 +523,20 @@ vpFeatureTranslation::error(const vpBasicFeature &s_star,
     }
   }
 
-
   if (vpFeatureTranslation::selectTx() & select )
     {
-      vpColVector ex(1) ;
-      ex[0] = s[0]-s_star[0]  ;
-      e = vpColVector::stack(e,ex) ;
+      e[k++] = s[0]-s_star[0]  ;
     }
 
   if (vpFeatureTranslation::selectTy() & select )
     {
-      vpColVector ey(1) ;
-      ey[0] = s[1]-s_star[1] ;
-      e = vpColVector::stack(e,ey) ;
+      e[k++] = s[1]-s_star[1] ;
     }
 
   if (vpFeatureTranslation::selectTz() & select )
     {
-      vpColVector ez(1) ;
-      ez[0] = s[2]-s_star[2] ;
-      e = vpColVector::stack(e,ez) ;
+      e[k++] = s[2]-s_star[2] ;
     }
-
-  return e ;
 }
 
 /*!
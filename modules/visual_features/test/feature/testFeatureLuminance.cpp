@@ -0,0 +1,185 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the luminance feature and its normal equations.
+ *
+ *****************************************************************************/
+
+/*!
+  \file testFeatureLuminance.cpp
+  \brief Check the luminance feature built from an image, and compare its
+  normal equations with the ones given by its interaction matrix.
+*/
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/visual_features/vpFeatureLuminance.h>
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+
+namespace {
+  // Smooth textured image
+  void getImage(const double phase, vpImage<unsigned char> &I) {
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        I[i][j] = (unsigned char)(127.5 + 60 * sin(0.11 * j + phase) * cos(0.07 * i) + 60 * sin(0.013 * i * j / 10.));
+  }
+
+  bool close(const double a, const double b) {
+    return std::fabs(a - b) <= 1e-9 * (1 + std::fabs(a) + std::fabs(b));
+  }
+}
+
+int main()
+{
+  try {
+    const unsigned int h = 240, w = 320, bord = 10;
+    vpCameraParameters cam(600, 610, 160, 120);
+    vpImage<unsigned char> I(h, w), Id(h, w);
+    getImage(0.3, I);
+    getImage(0., Id);
+
+    vpFeatureLuminance sI, sId;
+    sI.init(h, w, 0.8);
+    sI.setCameraParameters(cam);
+    sI.buildFrom(I);
+    sId.init(h, w, 0.8);
+    sId.setCameraParameters(cam);
+    sId.buildFrom(Id);
+
+    // Interaction matrix of the feature built from a reference computation of the gradient
+    vpMatrix L;
+    sI.interaction(L);
+    unsigned int l = 0;
+    for (unsigned int i = bord; i < h - bord; i++) {
+      for (unsigned int j = bord; j < w - bord; j++, l++) {
+        double x = 0, y = 0;
+        vpPixelMeterConversion::convertPoint(cam, j, i, x, y);
+        double Ix = cam.get_px() * vpImageFilter::derivativeFilterX(I, i, j);
+        double Iy = cam.get_py() * vpImageFilter::derivativeFilterY(I, i, j);
+        double Zinv = 1 / 0.8;
+        if (L[l][0] != Ix * Zinv || L[l][1] != Iy * Zinv || L[l][2] != -(x*Ix+y*Iy)*Zinv
+            || L[l][3] != -Ix*x*y-(1+y*y)*Iy || L[l][4] != (1+x*x)*Ix + Iy*x*y || L[l][5] != Iy*x-Ix*y) {
+          std::cerr << "Bad interaction matrix for pixel " << i << " " << j << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    vpColVector e;
+    sI.error(sId, e);
+    for (unsigned int i = 0; i < e.getRows(); i++) {
+      if (e[i] != (double)I[bord + i / (w - 2*bord)][bord + i % (w - 2*bord)]
+          - (double)Id[bord + i / (w - 2*bord)][bord + i % (w - 2*bord)]) {
+        std::cerr << "Bad error for feature " << i << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Normal equations compared with the interaction matrix
+    const unsigned int nbIter = 20;
+    double t = vpTime::measureTimeMs();
+    vpMatrix LtL_ref;
+    vpColVector Lte_ref;
+    for (unsigned int iter = 0; iter < nbIter; iter++) {
+      sI.interaction(L);
+      LtL_ref = L.AtA();
+      Lte_ref = L.t() * e;
+    }
+    double t_ref = (vpTime::measureTimeMs() - t) / nbIter;
+
+    const unsigned int nbThreads[] = {1, 2, 4};
+    for (unsigned int n = 0; n < sizeof(nbThreads) / sizeof(nbThreads[0]); n++) {
+      sI.setNbThreads(nbThreads[n]);
+      vpMatrix LtL;
+      vpColVector Lte;
+      t = vpTime::measureTimeMs();
+      for (unsigned int iter = 0; iter < nbIter; iter++) {
+        sI.buildFrom(I);
+        sI.normalEquations(e, LtL, Lte);
+      }
+      t = (vpTime::measureTimeMs() - t) / nbIter;
+
+      for (unsigned int i = 0; i < 6; i++) {
+        for (unsigned int j = 0; j < 6; j++) {
+          if (! close(LtL[i][j], LtL_ref[i][j])) {
+            std::cerr << "LtL[" << i << "][" << j << "] = " << LtL[i][j] << " instead of " << LtL_ref[i][j]
+                      << " with " << nbThreads[n] << " threads" << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+        if (! close(Lte[i], Lte_ref[i])) {
+          std::cerr << "Lte[" << i << "] = " << Lte[i] << " instead of " << Lte_ref[i]
+                    << " with " << nbThreads[n] << " threads" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+
+      // L^T e alone
+      vpColVector Lte_only;
+      sI.normalEquations(e, Lte_only);
+      for (unsigned int i = 0; i < 6; i++) {
+        if (! close(Lte_only[i], Lte_ref[i])) {
+          std::cerr << "Lte[" << i << "] = " << Lte_only[i] << " instead of " << Lte_ref[i]
+                    << " without LtL with " << nbThreads[n] << " threads" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+      std::cout << "Normal equations of " << e.getRows() << " pixels with " << nbThreads[n] << " threads: "
+                << t << " ms (interaction matrix: " << t_ref << " ms)" << std::endl;
+    }
+
+    // The error must have the size of the feature
+    bool exception = false;
+    try {
+      vpMatrix LtL;
+      vpColVector Lte;
+      sI.normalEquations(vpColVector(10), LtL, Lte);
+    }
+    catch(const vpException &) {
+      exception = true;
+    }
+    if (! exception) {
+      std::cerr << "Bad error size is not detected" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -601,60 +601,24 @@ static void computeInteractionMatrixFromList  (const std::list<vpBasicFeature *>
                            "feature list empty, cannot compute Ls")) ;
   }
 
-  /* The matrix dimension is not known before the affectation loop.
-   * It thus should be allocated on the flight, in the loop.
-   * The first assumption is that the size has not changed. A double
-   * reallocation (realloc(dim*2)) is done if necessary. In particular,
-   * [log_2(dim)+1] reallocations are done for the first matrix computation.
-   * If the allocated size is too large, a correction is done after the loop.
-   * The algorithmic cost is linear in affectation, logarithmic in allocation
-   * numbers and linear in allocation size.
-   */
-
-  /* First assumption: matrix dimensions have not changed. If 0, they are
-   * initialized to dim 1.*/
-  unsigned int rowL = L.getRows();
-  const unsigned int colL = 6;
-  if (0 == rowL) {
-    rowL = 1;
-    L .resize(rowL, colL);
-  }
-
-  /* vectTmp is used to store the return values of functions get_s() and
-   * error(). */
-  vpMatrix matrixTmp;
-
-  /* The cursor are the number of the next case of the vector array to
-   * be affected. A memory reallocation should be done when cursor
-   * is out of the vector-array range.*/
-  unsigned int cursorL = 0;
-
+  /* The dimension of the stacked matrix is given by the features, so that
+   * L is only reallocated when it changes. Each feature then writes its
+   * rows in place, without any temporary matrix. */
+  unsigned int rowL = 0;
   std::list<vpBasicFeature *>::const_iterator it;
   std::list<unsigned int>::const_iterator it_select;
 
   for (it = featureList.begin(), it_select = featureSelectionList.begin(); it != featureList.end(); ++it, ++it_select)
-  {
-    /* Get s. */
-    matrixTmp = (*it)->interaction( *it_select );
-    unsigned int rowMatrixTmp = matrixTmp .getRows();
-    unsigned int colMatrixTmp = matrixTmp .getCols();
-
-    /* Check the matrix L size, and realloc if needed. */
-    while (rowMatrixTmp + cursorL > rowL) {
-      rowL *= 2;
-      L.resize (rowL,colL,false);
-      vpDEBUG_TRACE(15,"Realloc!");
-    }
+    rowL += (*it)->getDimension(*it_select);
 
-    /* Copy the temporarily matrix into L. */
-    for (unsigned int k = 0; k < rowMatrixTmp; ++k, ++cursorL) {
-      for (unsigned int j = 0; j <  colMatrixTmp; ++j) {
-        L[cursorL][j] = matrixTmp[k][j];
-      }
-    }
-  }
+  L.resize(rowL, 6, false);
 
-  L.resize (cursorL,colL,false);
+  unsigned int cursorL = 0;
+  for (it = featureList.begin(), it_select = featureSelectionList.begin(); it != featureList.end(); ++it, ++it_select)
+  {
+    (*it)->interaction(*it_select, L, cursorL);
+    cursorL += (*it)->getDimension(*it_select);
+  }
 
   return ;
 }
@@ -711,7 +675,7 @@ vpMatrix vpServo::computeInteractionMatrix()
       break ;
     case MEAN:
     {
-      vpMatrix Lstar (L.getRows(), L.getCols());
+      vpMatrix Lstar;
       try
       {
         computeInteractionMatrixFromList(this ->featureList,
@@ -723,7 +687,16 @@ vpMatrix vpServo::computeInteractionMatrix()
       {
         throw ;
       }
-      L = (L+Lstar)/2;
+      if (Lstar.getRows() != L.getRows() || Lstar.getCols() != L.getCols())
+      {
+        vpERROR_TRACE("the current and desired interaction matrices have different sizes") ;
+        throw(vpServoException(vpServoException::servoError,
+                               "Cannot compute the mean of a (%dx%d) and a (%dx%d) interaction matrix",
+                               L.getRows(), L.getCols(), Lstar.getRows(), Lstar.getCols())) ;
+      }
+      for (unsigned int i = 0; i < L.getRows(); i++)
+        for (unsigned int j = 0; j < L.getCols(); j++)
+          L[i][j] = (L[i][j] + Lstar[i][j]) / 2;
 
       dim_task = L.getRows() ;
       interactionMatrixComputed = true ;
@@ -770,43 +743,23 @@ vpColVector vpServo::computeError()
     vpBasicFeature *current_s ;
     vpBasicFeature *desired_s ;
 
-    /* The vector dimensions are not known before the affectation loop.
-     * They thus should be allocated on the flight, in the loop.
-     * The first assumption is that the size has not changed. A double
-     * reallocation (realloc(dim*2)) is done if necessary. In particular,
-     * [log_2(dim)+1] reallocations are done for the first error computation.
-     * If the allocated size is too large, a correction is done after the loop.
-     * The algorithmic cost is linear in affectation, logarithmic in allocation
-     * numbers and linear in allocation size.
-     * No assumptions are made concerning size of each vector: they are
-     * not said equal, and could be different.
-     */
-
-    /* First assumption: vector dimensions have not changed. If 0, they are
-     * initialized to dim 1.*/
-    unsigned int dimError = error .getRows();
-    unsigned int dimS = s .getRows();
-    unsigned int dimSStar = sStar .getRows();
-    if (0 == dimError) { dimError = 1; error .resize(dimError);}
-    if (0 == dimS) { dimS = 1; s .resize(dimS);}
-    if (0 == dimSStar) { dimSStar = 1; sStar .resize(dimSStar);}
-
-    /* vectTmp is used to store the return values of functions get_s() and
-     * error(). */
-    vpColVector vectTmp;
-
-    /* The cursor are the number of the next case of the vector array to
-     * be affected. A memory reallocation should be done when cursor
-     * is out of the vector-array range.*/
-    unsigned int cursorS = 0;
-    unsigned int cursorSStar = 0;
-    unsigned int cursorError = 0;
-
-    /* For each cell of the list, copy value of s, s_star and error. */
+    /* The vector dimensions are given by the features, so that the vectors
+     * are only reallocated when they change. The features then write s,
+     * s_star and the error in place, without any temporary vector. */
     std::list<vpBasicFeature *>::const_iterator it_s;
     std::list<vpBasicFeature *>::const_iterator it_s_star;
     std::list<unsigned int>::const_iterator it_select;
 
+    unsigned int dim = 0;
+    for (it_s = featureList.begin(), it_select = featureSelectionList.begin(); it_s != featureList.end();
+         ++it_s, ++it_select)
+      dim += (*it_s)->getDimension(*it_select);
+
+    s.resize(dim, false);
+    sStar.resize(dim, false);
+    error.resize(dim, false);
+
+    unsigned int cursor = 0;
     for (it_s = featureList.begin(), it_s_star = desiredFeatureList.begin(), it_select = featureSelectionList.begin();
          it_s != featureList.end();
          ++it_s, ++it_s_star, ++it_select)
@@ -815,41 +768,12 @@ vpColVector vpServo::computeError()
       desired_s  = (*it_s_star);
       unsigned int select = (*it_select);
 
-      /* Get s, and store it in the s vector. */
-      vectTmp = current_s->get_s(select);
-      unsigned int dimVectTmp = vectTmp .getRows();
-      while (dimVectTmp + cursorS > dimS)
-      { dimS *= 2; s .resize (dimS,false); vpDEBUG_TRACE(15,"Realloc!"); }
-      for (unsigned int k = 0; k <  dimVectTmp; ++k) { s[cursorS++] = vectTmp[k]; }
-
-      /* Get s_star, and store it in the s vector. */
-      vectTmp = desired_s->get_s(select);
-      dimVectTmp = vectTmp .getRows();
-      while (dimVectTmp + cursorSStar > dimSStar) {
-        dimSStar *= 2;
-        sStar.resize (dimSStar,false);
-      }
-      for (unsigned int k = 0; k <  dimVectTmp; ++k) {
-        sStar[cursorSStar++] = vectTmp[k];
-      }
-
-      /* Get error, and store it in the s vector. */
-      vectTmp = current_s->error(*desired_s, select) ;
-      dimVectTmp = vectTmp .getRows();
-      while (dimVectTmp + cursorError > dimError) {
-        dimError *= 2;
-        error.resize (dimError,false);
-      }
-      for (unsigned int k = 0; k <  dimVectTmp; ++k) {
-        error[cursorError++] = vectTmp[k];
-      }
+      current_s->get_s(select, s, cursor);
+      desired_s->get_s(select, sStar, cursor);
+      current_s->error(*desired_s, select, error, cursor);
+      cursor += current_s->getDimension(select);
     }
 
-    /* If too much memory has been allocated, realloc. */
-    s .resize(cursorS,false);
-    sStar .resize(cursorSStar,false);
-    error .resize(cursorError,false);
-
     /* Final modifications. */
     dim_task = error.getRows() ;
     errorComputed = true ;
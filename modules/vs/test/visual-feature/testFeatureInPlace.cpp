@@ -0,0 +1,571 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the interaction matrices and errors written in place by the features.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testFeatureInPlace.cpp
+
+  \brief Check that the interaction matrices and errors written in place by
+  the visual features, and stacked by vpServo, are the ones returned by the
+  allocating methods. The default in-place methods of vpBasicFeature must
+  reject an interaction matrix or an error whose size doesn't match the
+  selected features.
+*/
+
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpMomentCommon.h>
+#include <visp3/core/vpMomentObject.h>
+#include <visp3/core/vpPlane.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpParseArgv.h>
+#include <visp3/visual_features/vpFeatureDepth.h>
+#include <visp3/visual_features/vpFeatureException.h>
+#include <visp3/visual_features/vpFeatureLine.h>
+#include <visp3/visual_features/vpFeatureLuminance.h>
+#include <visp3/visual_features/vpFeatureMomentCommon.h>
+#include <visp3/visual_features/vpFeaturePoint.h>
+#include <visp3/visual_features/vpFeatureSegment.h>
+#include <visp3/visual_features/vpFeatureThetaU.h>
+#include <visp3/visual_features/vpFeatureTranslation.h>
+#include <visp3/vs/vpServo.h>
+#include <visp3/vs/vpServoException.h>
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// List of allowed command line options
+#define GETOPTARGS	"cdh"
+
+namespace {
+  void usage(const char *name, const char *badparam)
+  {
+    fprintf(stdout, "\n\
+Compare the interaction matrices and errors written in place by the visual\n\
+features with the ones returned by the allocating methods.\n\
+\n\
+SYNOPSIS\n\
+  %s [-c] [-d] [-h]\n", name);
+
+    fprintf(stdout, "\n\
+OPTIONS:\n\
+  -c\n\
+     Disable the mouse click. Useless in this test.\n\
+\n\
+  -d\n\
+     Disable the image display. Useless in this test.\n\
+\n\
+  -h\n\
+     Print the help.\n\n");
+
+    if (badparam)
+      fprintf(stdout, "\nERROR: Bad parameter [%s]\n", badparam);
+  }
+
+  bool getOptions(int argc, const char **argv)
+  {
+    const char *optarg_;
+    int c;
+    while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+      switch (c) {
+      case 'c': break;
+      case 'd': break;
+      case 'h': usage(argv[0], NULL); return false; break;
+
+      default:
+        usage(argv[0], optarg_);
+        return false; break;
+      }
+    }
+
+    if ((c == 1) || (c == -1)) {
+      // standalone param or error
+      usage(argv[0], NULL);
+      std::cerr << "ERROR: " << std::endl;
+      std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+  double getRandomValues(const double min, const double max) {
+    return (max - min) * ( (double) rand() / (double) RAND_MAX ) + min;
+  }
+
+  bool close(const double a, const double b) {
+    return std::fabs(a - b) <= 1e-12 * (1 + std::fabs(a) + std::fabs(b));
+  }
+
+  // Write the selected rows of s in the middle of a larger matrix and vector,
+  // and compare them with the allocating methods. The rows around must not
+  // be modified.
+  bool checkFeature(const std::string &name, vpBasicFeature &s, vpBasicFeature &s_star, const unsigned int select) {
+    const unsigned int offset = 3, dim = s.getDimension(select);
+    const double unset = -1234.5;
+
+    vpMatrix L_ref = s.interaction(select);
+    vpColVector e_ref = s.error(s_star, select);
+    vpColVector s_ref = s.get_s(select);
+    if (L_ref.getRows() != dim || e_ref.getRows() != dim || s_ref.getRows() != dim) {
+      std::cerr << name << ": dimension " << dim << " for select " << select << " while the interaction matrix has "
+                << L_ref.getRows() << " rows" << std::endl;
+      return false;
+    }
+
+    vpMatrix L(offset + dim + 2, 6);
+    vpColVector e(offset + dim + 2), s_(offset + dim + 2);
+    for (unsigned int i = 0; i < L.getRows(); i++) {
+      e[i] = s_[i] = unset;
+      for (unsigned int j = 0; j < 6; j++)
+        L[i][j] = unset;
+    }
+    s.interaction(select, L, offset);
+    s.error(s_star, select, e, offset);
+    s.get_s(select, s_, offset);
+
+    for (unsigned int i = 0; i < L.getRows(); i++) {
+      bool inside = (i >= offset && i < offset + dim);
+      for (unsigned int j = 0; j < 6; j++) {
+        if (inside ? (L[i][j] != L_ref[i - offset][j]) : (L[i][j] != unset)) {
+          std::cerr << name << ": bad interaction matrix row " << i << " for select " << select << std::endl;
+          return false;
+        }
+      }
+      if (inside ? (e[i] != e_ref[i - offset] || s_[i] != s_ref[i - offset]) : (e[i] != unset || s_[i] != unset)) {
+        std::cerr << name << ": bad error or feature " << i << " for select " << select << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Feature of dimension 2 whose allocating methods return one row too many,
+  // to check the default in-place methods of vpBasicFeature
+  class vpFeatureWrongSize : public vpBasicFeature
+  {
+  public:
+    vpFeatureWrongSize() { init(); }
+    using vpBasicFeature::error;
+    using vpBasicFeature::interaction;
+    void init() {
+      dim_s = 2;
+      nbParameters = 0;
+      s.resize(dim_s);
+      if (flags == NULL)
+        flags = new bool[nbParameters];
+    }
+    vpMatrix interaction(const unsigned int select = FEATURE_ALL) {
+      return vpMatrix(getDimension(select) + 1, 6);
+    }
+    vpColVector error(const vpBasicFeature & /* s_star */, const unsigned int select = FEATURE_ALL) {
+      return vpColVector(getDimension(select) + 1);
+    }
+    void print(const unsigned int /* select */ = FEATURE_ALL) const {}
+    vpBasicFeature *duplicate() const { return new vpFeatureWrongSize; }
+    void display(const vpCameraParameters & /* cam */, const vpImage<unsigned char> & /* I */,
+                 const vpColor & /* color */ = vpColor::green, unsigned int /* thickness */ = 1) const {}
+    void display(const vpCameraParameters & /* cam */, const vpImage<vpRGBa> & /* I */,
+                 const vpColor & /* color */ = vpColor::green, unsigned int /* thickness */ = 1) const {}
+  };
+
+  // Polygon seen from the pose cMo, and parameters 1/Z = Ax + By + C of its plane
+  void buildPolygon(const vpHomogeneousMatrix &cMo, vpMomentObject &obj, double &A, double &B, double &C) {
+    const double x[5] = { 0.2, 0.25, -0.1, -0.2, 0.05 };
+    const double y[5] = { -0.1, 0.15, 0.2, -0.05, -0.2 };
+    std::vector<vpPoint> points;
+    for (unsigned int i = 0; i < 5; i++) {
+      vpPoint P(x[i], y[i], 0.0);
+      P.track(cMo);
+      points.push_back(P);
+    }
+    obj.setType(vpMomentObject::DENSE_POLYGON);
+    obj.fromVector(points);
+
+    vpPlane pl;
+    pl.setABCD(0, 0, 1.0, 0);
+    pl.changeFrame(cMo);
+    A = -pl.getA() / pl.getD();
+    B = -pl.getB() / pl.getD();
+    C = -pl.getC() / pl.getD();
+  }
+
+  // Interaction matrix of a theta u feature as computed with vpMatrix before
+  bool checkThetaU(vpFeatureThetaU &tu, const bool cdRc) {
+    vpColVector s = tu.get_s();
+    vpColVector u(3);
+    for (unsigned int i = 0; i < 3; i++)
+      u[i] = s[i] / 2.0;
+    vpMatrix Lw = vpColVector::skew(u);
+    vpMatrix U2(3, 3);
+    U2.eye();
+    double theta = sqrt(s.sumSquare());
+    if (theta >= 1e-6) {
+      for (unsigned int i = 0; i < 3; i++)
+        u[i] = s[i] / theta;
+      vpMatrix skew_u = vpColVector::skew(u);
+      U2 += (1 - vpMath::sinc(theta) / vpMath::sqr(vpMath::sinc(theta / 2.0))) * skew_u * skew_u;
+    }
+    if (cdRc)
+      Lw += U2;
+    else
+      Lw -= U2;
+
+    vpMatrix L = tu.interaction();
+    for (unsigned int i = 0; i < 3; i++) {
+      for (unsigned int j = 0; j < 3; j++) {
+        if (L[i][j] != 0 || ! close(L[i][j + 3], Lw[i][j])) {
+          std::cerr << "Bad theta u interaction matrix" << std::endl << L << std::endl;
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+}
+
+int main(int argc, const char **argv)
+{
+  try {
+    if (getOptions(argc, argv) == false) {
+      return EXIT_FAILURE;
+    }
+
+    srand(0);
+    std::vector<unsigned int> selects;
+    for (unsigned int select = 1; select < 16; select++)
+      selects.push_back(select);
+    selects.push_back(vpBasicFeature::FEATURE_ALL);
+
+    vpHomogeneousMatrix cdMc(0.1, -0.2, 0.3, vpMath::rad(10), vpMath::rad(-20), vpMath::rad(35));
+    vpHomogeneousMatrix cMo(-0.1, 0.05, 1.2, vpMath::rad(-5), vpMath::rad(15), vpMath::rad(50));
+
+    vpFeaturePoint p, pd;
+    p.buildFrom(0.1, -0.2, 1.5);
+    pd.buildFrom(-0.05, 0.1, 1.);
+    vpFeatureLine l, ld;
+    l.buildFrom(0.3, vpMath::rad(170), 0.1, -0.2, 1.1, -0.8);
+    ld.buildFrom(-0.2, vpMath::rad(-175), 0.1, -0.2, 1.1, -0.8);
+    vpFeatureSegment seg, segd, segn(true), segnd(true);
+    seg.buildFrom(-0.1, 0.2, 1.2, 0.3, -0.1, 1.4);
+    segd.buildFrom(0.1, 0.1, 1., 0.2, 0.3, 1.);
+    segn.buildFrom(-0.1, 0.2, 1.2, 0.3, -0.1, 1.4);
+    segnd.buildFrom(0.1, 0.1, 1., 0.2, 0.3, 1.);
+    vpFeatureDepth z, zd;
+    z.buildFrom(0.1, -0.2, 1.5, log(1.5));
+    zd.buildFrom(0.1, -0.2, 1., 0);
+
+    std::vector<std::string> names;
+    std::vector<vpBasicFeature *> features, desired;
+    names.push_back("point"); features.push_back(&p); desired.push_back(&pd);
+    names.push_back("line"); features.push_back(&l); desired.push_back(&ld);
+    names.push_back("segment"); features.push_back(&seg); desired.push_back(&segd);
+    names.push_back("normalized segment"); features.push_back(&segn); desired.push_back(&segnd);
+    names.push_back("depth"); features.push_back(&z); desired.push_back(&zd);
+
+    vpFeatureThetaU::vpFeatureThetaURotationRepresentationType tuTypes[] = {vpFeatureThetaU::cdRc, vpFeatureThetaU::cRcd};
+    std::vector<vpFeatureThetaU> tu(2), tud(2);
+    for (unsigned int t = 0; t < 2; t++) {
+      tu[t].setFeatureThetaURotationType(tuTypes[t]);
+      tud[t].setFeatureThetaURotationType(tuTypes[t]);
+      tu[t].buildFrom(tuTypes[t] == vpFeatureThetaU::cdRc ? cdMc : cdMc.inverse());
+      tud[t].set_TUx(0); tud[t].set_TUy(0); tud[t].set_TUz(0);
+      names.push_back("theta u"); features.push_back(&tu[t]); desired.push_back(&tud[t]);
+      if (! checkThetaU(tu[t], tuTypes[t] == vpFeatureThetaU::cdRc))
+        return EXIT_FAILURE;
+    }
+    vpFeatureThetaU tu0(vpFeatureThetaU::cdRc);
+    tu0.set_TUx(0); tu0.set_TUy(0); tu0.set_TUz(0);
+    if (! checkThetaU(tu0, true))
+      return EXIT_FAILURE;
+
+    vpFeatureTranslation::vpFeatureTranslationRepresentationType tTypes[] = {vpFeatureTranslation::cdMc, vpFeatureTranslation::cMcd, vpFeatureTranslation::cMo};
+    std::vector<vpFeatureTranslation> t(3), td(3);
+    for (unsigned int k = 0; k < 3; k++) {
+      t[k].setFeatureTranslationType(tTypes[k]);
+      td[k].setFeatureTranslationType(tTypes[k]);
+      t[k].buildFrom(tTypes[k] == vpFeatureTranslation::cMo ? cMo : cdMc);
+      td[k].buildFrom(tTypes[k] == vpFeatureTranslation::cMo ? cdMc * cMo : vpHomogeneousMatrix());
+      names.push_back("translation"); features.push_back(&t[k]); desired.push_back(&td[k]);
+    }
+
+    for (size_t f = 0; f < features.size(); f++)
+      for (size_t k = 0; k < selects.size(); k++)
+        if (! checkFeature(names[f], *features[f], *desired[f], selects[k]))
+          return EXIT_FAILURE;
+
+    // Moment features of a polygon
+    vpHomogeneousMatrix cdMo(0.0, 0.0, 1.0, 0, 0, 0);
+    vpMomentObject obj(6), objd(6);
+    double A, B, C, Ad, Bd, Cd;
+    buildPolygon(cMo, obj, A, B, C);
+    buildPolygon(cdMo, objd, Ad, Bd, Cd);
+    vpMomentCommon moments(vpMomentCommon::getSurface(objd), vpMomentCommon::getMu3(objd),
+                           vpMomentCommon::getAlpha(objd), 1.0);
+    vpMomentCommon momentsd(vpMomentCommon::getSurface(objd), vpMomentCommon::getMu3(objd),
+                            vpMomentCommon::getAlpha(objd), 1.0);
+    vpFeatureMomentCommon fm(moments), fmd(momentsd);
+    moments.updateAll(obj);
+    momentsd.updateAll(objd);
+    fm.updateAll(A, B, C);
+    fmd.updateAll(Ad, Bd, Cd);
+
+    std::vector<std::string> moment_names;
+    std::vector<vpBasicFeature *> moment_features, moment_desired;
+    moment_names.push_back("moment gravity center"); moment_features.push_back(&fm.getFeatureGravityCenter()); moment_desired.push_back(&fmd.getFeatureGravityCenter());
+    moment_names.push_back("moment gravity center normalized"); moment_features.push_back(&fm.getFeatureGravityNormalized()); moment_desired.push_back(&fmd.getFeatureGravityNormalized());
+    moment_names.push_back("moment area"); moment_features.push_back(&fm.getFeatureArea()); moment_desired.push_back(&fmd.getFeatureArea());
+    moment_names.push_back("moment area normalized"); moment_features.push_back(&fm.getFeatureAn()); moment_desired.push_back(&fmd.getFeatureAn());
+    moment_names.push_back("moment c invariant"); moment_features.push_back(&fm.getFeatureCInvariant()); moment_desired.push_back(&fmd.getFeatureCInvariant());
+    moment_names.push_back("moment alpha"); moment_features.push_back(&fm.getFeatureAlpha()); moment_desired.push_back(&fmd.getFeatureAlpha());
+
+    std::vector<unsigned int> moment_selects(selects);
+    moment_selects.push_back((1 << 10) | (1 << 11));
+    for (size_t f = 0; f < moment_features.size(); f++)
+      for (size_t k = 0; k < moment_selects.size(); k++)
+        if (! checkFeature(moment_names[f], *moment_features[f], *moment_desired[f], moment_selects[k]))
+          return EXIT_FAILURE;
+
+    // The error of alpha only has a row if the feature is selected
+    vpFeatureMomentAlpha &alpha = fm.getFeatureAlpha(), &alphad = fmd.getFeatureAlpha();
+    if (alpha.error(alphad, vpBasicFeature::FEATURE_ALL).getRows() != 1 || alpha.error(alphad, 2).getRows() != 0) {
+      std::cerr << "The error of alpha doesn't follow the selection" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // The basic and centered moments have no interaction matrix for a selection
+    vpFeatureMomentBasic &basic = fm.getFeatureMomentBasic();
+    vpFeatureMomentCentered &centered = fm.getFeatureCentered();
+    vpBasicFeature *not_implemented[2] = { &basic, &centered };
+    for (unsigned int f = 0; f < 2; f++) {
+      unsigned int nbThrown = 0;
+      vpMatrix L(10, 6);
+      try {
+        not_implemented[f]->interaction(vpBasicFeature::FEATURE_ALL);
+      }
+      catch(vpException &ex) {
+        if (ex.getCode() == vpException::functionNotImplementedError)
+          nbThrown++;
+      }
+      try {
+        not_implemented[f]->interaction(vpBasicFeature::FEATURE_ALL, L, 0);
+      }
+      catch(vpException &ex) {
+        if (ex.getCode() == vpException::functionNotImplementedError)
+          nbThrown++;
+      }
+      if (nbThrown != 2) {
+        std::cerr << "The interaction matrix of the basic or centered moments should not be implemented" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Luminance feature of a small image
+    vpImage<unsigned char> I(40, 50), Id(40, 50);
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        I[i][j] = (unsigned char)(127.5 + 100 * sin(0.2 * j + 0.3) * cos(0.15 * i));
+        Id[i][j] = (unsigned char)(127.5 + 100 * sin(0.2 * j) * cos(0.15 * i));
+      }
+    }
+    vpCameraParameters cam(300, 300, 25, 20);
+    vpFeatureLuminance sI, sId;
+    sI.init(I.getHeight(), I.getWidth(), 1.);
+    sI.setCameraParameters(cam);
+    sI.buildFrom(I);
+    sId.init(Id.getHeight(), Id.getWidth(), 1.);
+    sId.setCameraParameters(cam);
+    sId.buildFrom(Id);
+    if (! checkFeature("luminance", sI, sId, vpBasicFeature::FEATURE_ALL))
+      return EXIT_FAILURE;
+
+    // Too small matrix or vector
+    unsigned int nbExceptions = 0;
+    for (size_t f = 0; f < features.size(); f++) {
+      vpMatrix L(features[f]->getDimension() - 1, 6);
+      vpColVector e(features[f]->getDimension());
+      try {
+        features[f]->interaction(vpBasicFeature::FEATURE_ALL, L, 0);
+      }
+      catch(const vpFeatureException &) {
+        nbExceptions++;
+      }
+      try {
+        features[f]->error(*desired[f], vpBasicFeature::FEATURE_ALL, e, 1);
+      }
+      catch(const vpFeatureException &) {
+        nbExceptions++;
+      }
+    }
+    if (nbExceptions != 2 * features.size()) {
+      std::cerr << "Only " << nbExceptions << " of the " << 2 * features.size() << " size mismatches are detected" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // The default in-place methods reject allocating methods of the wrong size
+    vpFeatureWrongSize wrong, wrongd;
+    unsigned int nbWrongSizes = 0;
+    for (unsigned int select = 1; select <= 3; select++) {
+      vpMatrix L(10, 6);
+      vpColVector e(10);
+      try {
+        wrong.interaction(select, L, 0);
+      }
+      catch(vpFeatureException &ex) {
+        if (ex.getCode() == vpFeatureException::sizeMismatchError)
+          nbWrongSizes++;
+      }
+      try {
+        wrong.error(wrongd, select, e, 0);
+      }
+      catch(vpFeatureException &ex) {
+        if (ex.getCode() == vpFeatureException::sizeMismatchError)
+          nbWrongSizes++;
+      }
+    }
+    if (nbWrongSizes != 6) {
+      std::cerr << "Only " << nbWrongSizes << " of the 6 wrong dimensions are detected" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Task of many points with a theta u feature, compared with the stacking of the allocating methods
+    const unsigned int nbPoints = 200;
+    std::vector<vpFeaturePoint> points(nbPoints), points_d(nbPoints);
+    vpServo task;
+    task.setServo(vpServo::EYEINHAND_CAMERA);
+    task.setInteractionMatrixType(vpServo::CURRENT);
+    for (unsigned int i = 0; i < nbPoints; i++) {
+      points[i].buildFrom(getRandomValues(-0.5, 0.5), getRandomValues(-0.5, 0.5), getRandomValues(0.5, 2.));
+      points_d[i].buildFrom(getRandomValues(-0.5, 0.5), getRandomValues(-0.5, 0.5), getRandomValues(0.5, 2.));
+      task.addFeature(points[i], points_d[i], i % 3 == 0 ? vpFeaturePoint::selectX() : (unsigned int)vpBasicFeature::FEATURE_ALL);
+    }
+    task.addFeature(tu[0], tud[0], vpFeatureThetaU::selectTUx() | vpFeatureThetaU::selectTUz());
+
+    vpMatrix L_ref;
+    vpColVector e_ref;
+    for (unsigned int i = 0; i < nbPoints; i++) {
+      unsigned int select = (i % 3 == 0 ? vpFeaturePoint::selectX() : (unsigned int)vpBasicFeature::FEATURE_ALL);
+      L_ref.stack(points[i].interaction(select));
+      e_ref.stack(points[i].error(points_d[i], select));
+    }
+    L_ref.stack(tu[0].interaction(vpFeatureThetaU::selectTUx() | vpFeatureThetaU::selectTUz()));
+    e_ref.stack(tu[0].error(tud[0], vpFeatureThetaU::selectTUx() | vpFeatureThetaU::selectTUz()));
+
+    const unsigned int nbIter = 1000;
+    double t_ref = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++) {
+      vpMatrix L_alloc;
+      vpColVector e_alloc;
+      for (unsigned int i = 0; i < nbPoints; i++) {
+        unsigned int select = (i % 3 == 0 ? vpFeaturePoint::selectX() : (unsigned int)vpBasicFeature::FEATURE_ALL);
+        L_alloc.stack(points[i].interaction(select));
+        e_alloc.stack(points[i].error(points_d[i], select));
+      }
+    }
+    t_ref = (vpTime::measureTimeMs() - t_ref) / nbIter;
+
+    vpColVector v;
+    double t_task = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIter; iter++)
+      v = task.computeControlLaw();
+    t_task = (vpTime::measureTimeMs() - t_task) / nbIter;
+
+    vpMatrix L = task.getInteractionMatrix();
+    vpColVector e = task.getError();
+    if (L.getRows() != L_ref.getRows() || e.getRows() != e_ref.getRows() || task.getDimension() != e_ref.getRows()) {
+      std::cerr << "Bad task dimension " << L.getRows() << " instead of " << L_ref.getRows() << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (unsigned int i = 0; i < L.getRows(); i++) {
+      for (unsigned int j = 0; j < 6; j++) {
+        if (L[i][j] != L_ref[i][j]) {
+          std::cerr << "Bad task interaction matrix row " << i << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+      if (e[i] != e_ref[i]) {
+        std::cerr << "Bad task error " << i << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    std::cout << "Task of " << L.getRows() << " rows: " << t_ref << " ms to stack the interaction matrices and errors, "
+              << t_task << " ms for the whole control law" << std::endl;
+
+    // The dimension of the task follows its features
+    vpServo task2;
+    task2.setServo(vpServo::EYEINHAND_CAMERA);
+    task2.setInteractionMatrixType(vpServo::CURRENT);
+    for (unsigned int n = 10; n <= 20; n += 10) {
+      for (unsigned int i = n - 10; i < n; i++)
+        task2.addFeature(points[i], points_d[i]);
+      task2.computeControlLaw();
+      if (task2.getInteractionMatrix().getRows() != 2*n || task2.getError().getRows() != 2*n) {
+        std::cerr << "Bad task dimension after features were added" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    task2.kill();
+
+    // The mean of the current and desired interaction matrices requires that they have the same size
+    vpFeatureThetaU tu_d(vpFeatureThetaU::cdRc);
+    tu_d.buildFrom(vpRotationMatrix());
+    vpServo task3;
+    task3.setServo(vpServo::EYEINHAND_CAMERA);
+    task3.setInteractionMatrixType(vpServo::MEAN);
+    task3.addFeature(points[0], tu_d);
+    bool thrown = false;
+    try {
+      task3.computeInteractionMatrix();
+    }
+    catch(vpServoException &ex) {
+      thrown = (ex.getCode() == vpServoException::servoError);
+    }
+    task3.kill();
+    if (!thrown) {
+      std::cerr << "The mean of interaction matrices of different sizes should throw" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "Test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}